@@ -0,0 +1,1453 @@
+/*
+ * Copyright (c) 2016, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX OR PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ################################################################################
+ * #
+ * # PATENT NOTICE
+ * #
+ * # This software is distributed under the BSD 2-clause License (see LICENSE
+ * # file).  This BSD License does not make any patent claims and as such, does
+ * # not act as a patent grant.  The purpose of this section is for each contributor
+ * # to define their intentions with respect to intellectual property.
+ * #
+ * # Each contributor to this source code is encouraged to state their patent
+ * # claims and licensing mechanisms for any contributions made. At the end of
+ * # this section contributors may each make their own statements.  Contributor's
+ * # claims and grants only apply to the pieces (source code, programs, text,
+ * # media, etc) that they have contributed directly to this software.
+ * #
+ * # There is no guarantee that this section is complete, up to date or accurate. It
+ * # is up to the contributors to maintain their portion of this section and up to
+ * # the user of the software to verify any claims herein.
+ * #
+ * # Do not remove this header notification.  The contents of this section must be
+ * # present in all distributions of the software.  You may only modify your own
+ * # intellectual property statements.  Please provide contact information.
+ *
+ * - Palo Alto Research Center, Inc
+ * This software distribution does not grant any rights to patents owned by Palo
+ * Alto Research Center, Inc (PARC). Rights to these patents are available via
+ * various mechanisms. As of January 2016 PARC has committed to FRAND licensing any
+ * intellectual property used by its contributions to this software. You may
+ * contact PARC at cipo@parc.com for more information or visit http://www.ccnx.org
+ */
+/**
+ * Microbenchmarks for the Portal API hot paths.
+ *
+ * Each benchmark times one operation: sending and receiving a message over the API loopback stack,
+ * with messages built for each send or taken from a message pool,
+ * with a multi-megabyte payload either copied into a buffer or sent from the application's memory,
+ * with a payload of 3, 8 or 32 slices either flattened and then encoded or gathered directly into the encoding,
+ * composing and serializing an anchor, a Listen and Ignore round trip, a Flush, creating and releasing a Portal,
+ * and creating and releasing a Portal Factory.
+ * The Interest encoding benchmarks compare creating and encoding an Interest for each chunk, as the RTA stack does,
+ * with making it from a pre-encoded Interest template.
+ * The server dispatch benchmark finds and calls the handler for an Interest among 10,000 registered name prefixes.
+ * The mixed server benchmarks serve batches of Interests where one in eight handlers takes 100 microseconds,
+ * calling every handler on the dispatching thread, or running them on a work-stealing executor and sending the replies in a batch.
+ * The shard scaling benchmark serves Interests from 1, 2, 4 and so on up to one pinned shard per online CPU,
+ * each shard answering its own Interest in a closed loop, and reports the combined Interests served per second.
+ * The batch receive benchmarks replay a recorded trace, so that each message is decoded on the receiving thread,
+ * and compare receiving each batch into an arena with allocating every message from the heap.
+ * No forwarder is involved, so the results measure the Portal library itself.
+ *
+ * Every benchmark is first calibrated to a batch of operations that takes at least the minimum batch time,
+ * then warmed up, then timed over a number of repetitions of that batch.
+ * The reported cost per operation is the median of the repetitions, with the median absolute deviation as its spread,
+ * so that an occasional descheduled repetition does not move the result.
+ *
+ * Allocations are counted by interposing on the PARC memory interface beneath any arena:
+ * the allocator calls each operation makes, and, from parcMemory_Outstanding, the allocations it leaves behind.
+ *
+ * The results are printed as JSON, so that runs against different releases can be compared with a diff.
+ *
+ * @copyright (c) 2016, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC).  All rights reserved.
+ */
+#include <config.h>
+
+// The anchor message composition is private to the Portal, so the benchmark is built with it, as the tests are.
+#include "../ccnx_Portal.c"
+
+#include <errno.h>
+#include <getopt.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <ccnx/api/ccnx_Portal/ccnx_PortalAPI.h>
+#include <ccnx/api/ccnx_Portal/ccnx_PortalAnchor.h>
+#include <ccnx/api/ccnx_Portal/ccnx_PortalFactory.h>
+#include <ccnx/api/ccnx_Portal/ccnx_PortalMessagePool.h>
+#include <ccnx/api/ccnx_Portal/ccnx_PortalArena.h>
+#include <ccnx/api/ccnx_Portal/ccnx_PortalInterestTemplate.h>
+#include <ccnx/api/ccnx_Portal/ccnx_PortalPayloadVector.h>
+#include <ccnx/api/ccnx_Portal/ccnx_PortalServer.h>
+#include <ccnx/api/ccnx_Portal/ccnx_PortalExecutor.h>
+#include <ccnx/api/ccnx_Portal/ccnx_PortalShards.h>
+#include <ccnx/api/ccnx_Portal/ccnx_PortalReplay.h>
+#include <ccnx/api/ccnx_Portal/ccnx_PortalTrace.h>
+
+#include <parc/algol/parc_Buffer.h>
+#include <parc/algol/parc_BufferComposer.h>
+#include <parc/algol/parc_JSON.h>
+#include <parc/algol/parc_Memory.h>
+#include <parc/security/parc_Security.h>
+#include <parc/security/parc_IdentityFile.h>
+#include <parc/security/parc_Pkcs12KeyStore.h>
+
+#include <ccnx/common/ccnx_Name.h>
+#include <ccnx/common/ccnx_Interest.h>
+#include <ccnx/common/ccnx_ContentObject.h>
+#include <ccnx/common/ccnx_NameSegmentNumber.h>
+
+// The most repetitions a benchmark may be asked for.
+#define MAX_REPETITIONS 1000
+
+// The number of operations over which allocations are counted.
+#define ALLOCATION_SAMPLE 1000
+
+// The payload size of the Content Objects sent by the send and receive benchmarks.
+#define PAYLOAD_SIZE 1024
+
+// The payload size of the Content Objects sent by the large payload benchmarks.
+#define LARGE_PAYLOAD_SIZE (4 * 1024 * 1024)
+
+// The payload size of the Content Objects encoded by the payload vector benchmarks.
+#define VECTOR_PAYLOAD_SIZE (32 * 1024)
+
+// The number of payload vectors, of 3, 8 and 32 slices, encoded by the payload vector benchmarks.
+#define VECTOR_COUNT 3
+
+// The number of name prefixes registered with the server dispatch benchmark's server, in a tree 100 wide and 100 deep.
+#define SERVER_PREFIX_COUNT 10000
+
+// The number of distinct Interests the server dispatch benchmark dispatches in turn.
+#define SERVER_REQUEST_COUNT 1024
+
+// The number of Interests each mixed server benchmark operation serves.
+#define MIXED_BATCH_SIZE 64
+
+// One in this many of the mixed server benchmark's Interests goes to the slow handler.
+#define MIXED_SLOW_RATIO 8
+
+// How long the mixed server benchmark's slow handler works, in nanoseconds.
+#define MIXED_SLOW_NANOS 100000
+
+// The number of worker threads running the mixed server benchmark's handlers, and the capacity of each one's queue.
+#define MIXED_WORKER_COUNT 4
+#define MIXED_QUEUE_CAPACITY MIXED_BATCH_SIZE
+
+// How long the shard scaling benchmark serves with each number of shards, in milliseconds.
+#define SHARD_SCALING_MILLISECONDS 500
+
+// The name of the shard scaling benchmark, for filtering.
+#define SHARD_SCALING_NAME "ccnxPortalShards_Scaling"
+
+// The number of messages each batch receive benchmark operation receives.
+#define RECEIVE_BATCH_SIZE 64
+
+// The number of messages in the trace replayed by the batch receive benchmarks. A multiple of RECEIVE_BATCH_SIZE.
+#define RECEIVE_TRACE_LENGTH 4096
+
+/**
+ * The configuration of a benchmark run.
+ */
+typedef struct {
+    unsigned int repetitions;      // The number of timed batches.
+    unsigned int warmupBatches;    // The number of untimed batches run before the timed ones.
+    uint64_t minimumBatchNanos;    // Calibration grows each batch until it takes at least this long.
+    uint64_t iterations;           // If non-zero, the operations in each batch, bypassing calibration.
+    const char *filter;            // If non-NULL, run only the benchmarks whose names contain this string.
+    const char *outputFile;        // If non-NULL, write the JSON here rather than to standard output.
+} BenchmarkOptions;
+
+extern int ccnxPortalBenchmarks(const PARCIdentity *identity, const BenchmarkOptions *options);
+extern void usage(void);
+
+/**
+ * The state shared by the benchmarks.
+ */
+typedef struct {
+    const PARCIdentity *identity;
+    CCNxPortalFactory *factory;
+    CCNxPortal *portal;
+    CCNxName *name;
+    CCNxMetaMessage *message;
+    CCNxPortalAnchor *anchor;
+    PARCBuffer *serializedAnchor;
+    const CCNxName *anchorName;
+    CCNxPortalMessagePool *pool;
+    uint8_t payload[PAYLOAD_SIZE];
+    char traceFile[64];
+    CCNxPortal *replay;
+    CCNxPortalArena *arena;
+    CCNxMetaMessage *batch[RECEIVE_BATCH_SIZE];
+    size_t receivedBytes;
+    CCNxPortalInterestTemplate *interestTemplate;
+    uint64_t chunk;
+    uint8_t *largePayload;
+    CCNxPortalPayloadVector *vectors[VECTOR_COUNT];
+    CCNxPortal *serverPortal;
+    CCNxPortalServer *server;
+    CCNxMetaMessage *requests[SERVER_REQUEST_COUNT];
+    uint64_t request;
+    uint64_t served;
+    CCNxPortal *inlinePortal;
+    CCNxPortalServer *inlineServer;
+    CCNxPortal *executorPortal;
+    CCNxPortalServer *executorServer;
+    CCNxPortalExecutor *executor;
+    CCNxMetaMessage *mixedRequests[MIXED_BATCH_SIZE];
+} _BenchmarkState;
+
+/**
+ * A benchmark.
+ *
+ * `operation` performs the operation once and returns whatever it produced, or NULL.
+ * `release` releases that result, and is not called for NULL.
+ * Keeping the two apart lets a benchmark hand back what it produced without counting its own release as the operation.
+ * `messagesPerOp` is the number of messages each operation receives, if message rates are to be reported, or 0.
+ */
+typedef struct {
+    const char *name;
+    void *(*operation)(_BenchmarkState *state);
+    void (*release)(void **resultPtr);
+    size_t messagesPerOp;
+} _Benchmark;
+
+typedef struct {
+    double minimum;
+    double median;
+    double mean;
+    double maximum;
+    double medianAbsoluteDeviation;
+} _BenchmarkStatistics;
+
+static uint64_t
+_nanoTime(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t) now.tv_sec * 1000000000ULL + (uint64_t) now.tv_nsec;
+}
+
+/*
+ * A memory interface that counts allocations and passes every call on to the interface it was installed over.
+ * Executor workers allocate too, so the count is atomic.
+ */
+static const PARCMemoryInterface *_benchmark_Memory;
+static uint64_t _benchmark_Allocations;
+
+static void *
+_benchmark_Allocate(size_t size)
+{
+    __atomic_fetch_add(&_benchmark_Allocations, 1, __ATOMIC_RELAXED);
+    return ((void *(*)(size_t)) _benchmark_Memory->Allocate)(size);
+}
+
+static void *
+_benchmark_AllocateAndClear(size_t size)
+{
+    __atomic_fetch_add(&_benchmark_Allocations, 1, __ATOMIC_RELAXED);
+    return ((void *(*)(size_t)) _benchmark_Memory->AllocateAndClear)(size);
+}
+
+static int
+_benchmark_MemAlign(void **pointer, size_t alignment, size_t size)
+{
+    __atomic_fetch_add(&_benchmark_Allocations, 1, __ATOMIC_RELAXED);
+    return ((int (*)(void **, size_t, size_t)) _benchmark_Memory->MemAlign)(pointer, alignment, size);
+}
+
+static void
+_benchmark_Deallocate(void **pointer)
+{
+    ((void (*)(void **)) _benchmark_Memory->Deallocate)(pointer);
+}
+
+static void *
+_benchmark_Reallocate(void *pointer, size_t newSize)
+{
+    __atomic_fetch_add(&_benchmark_Allocations, 1, __ATOMIC_RELAXED);
+    return ((void *(*)(void *, size_t)) _benchmark_Memory->Reallocate)(pointer, newSize);
+}
+
+static char *
+_benchmark_StringDuplicate(const char *string, size_t length)
+{
+    __atomic_fetch_add(&_benchmark_Allocations, 1, __ATOMIC_RELAXED);
+    return ((char *(*)(const char *, size_t)) _benchmark_Memory->StringDuplicate)(string, length);
+}
+
+static uint32_t
+_benchmark_Outstanding(void)
+{
+    return ((uint32_t (*)(void)) _benchmark_Memory->Outstanding)();
+}
+
+static PARCMemoryInterface _benchmark_CountingMemory = {
+    .Allocate         = (uintptr_t) _benchmark_Allocate,
+    .AllocateAndClear = (uintptr_t) _benchmark_AllocateAndClear,
+    .MemAlign         = (uintptr_t) _benchmark_MemAlign,
+    .Deallocate       = (uintptr_t) _benchmark_Deallocate,
+    .Reallocate       = (uintptr_t) _benchmark_Reallocate,
+    .StringDuplicate  = (uintptr_t) _benchmark_StringDuplicate,
+    .Outstanding      = (uintptr_t) _benchmark_Outstanding
+};
+
+static void
+_benchmark_ReleaseMetaMessage(void **resultPtr)
+{
+    ccnxMetaMessage_Release((CCNxMetaMessage **) resultPtr);
+}
+
+static void
+_benchmark_ReleaseBuffer(void **resultPtr)
+{
+    parcBuffer_Release((PARCBuffer **) resultPtr);
+}
+
+static void
+_benchmark_ReleaseAnchor(void **resultPtr)
+{
+    ccnxPortalAnchor_Release((CCNxPortalAnchor **) resultPtr);
+}
+
+static void
+_benchmark_ReleasePortal(void **resultPtr)
+{
+    ccnxPortal_Release((CCNxPortal **) resultPtr);
+}
+
+static void
+_benchmark_ReleaseFactory(void **resultPtr)
+{
+    ccnxPortalFactory_Release((CCNxPortalFactory **) resultPtr);
+}
+
+/*
+ * Send a pre-built Interest over the API loopback stack and receive it back.
+ */
+static void *
+_benchmark_SendReceive(_BenchmarkState *state)
+{
+    ccnxPortal_Send(state->portal, state->message, CCNxStackTimeout_Never);
+    return ccnxPortal_Receive(state->portal, CCNxStackTimeout_Never);
+}
+
+/*
+ * Build a Content Object for each send, as a producer without a pool does, and receive it back.
+ */
+static void *
+_benchmark_SendReceiveBuilt(_BenchmarkState *state)
+{
+    PARCBuffer *payload = parcBuffer_Allocate(PAYLOAD_SIZE);
+    parcBuffer_PutArray(payload, PAYLOAD_SIZE, state->payload);
+    parcBuffer_Flip(payload);
+
+    CCNxContentObject *contentObject = ccnxContentObject_CreateWithNameAndPayload(state->name, payload);
+    CCNxMetaMessage *message = ccnxMetaMessage_CreateFromContentObject(contentObject);
+
+    ccnxPortal_Send(state->portal, message, CCNxStackTimeout_Never);
+
+    ccnxMetaMessage_Release(&message);
+    ccnxContentObject_Release(&contentObject);
+    parcBuffer_Release(&payload);
+
+    return ccnxPortal_Receive(state->portal, CCNxStackTimeout_Never);
+}
+
+/*
+ * Take each Content Object from a message pool, and receive it back.
+ */
+static void *
+_benchmark_SendReceivePooled(_BenchmarkState *state)
+{
+    CCNxMetaMessage *message = ccnxPortalMessagePool_GetContentObject(state->pool, state->name);
+
+    PARCBuffer *payload = ccnxContentObject_GetPayload(ccnxMetaMessage_GetContentObject(message));
+    parcBuffer_PutArray(payload, PAYLOAD_SIZE, state->payload);
+    parcBuffer_Flip(payload);
+
+    ccnxPortal_Send(state->portal, message, CCNxStackTimeout_Never);
+    ccnxMetaMessage_Release(&message);
+
+    return ccnxPortal_Receive(state->portal, CCNxStackTimeout_Never);
+}
+
+/*
+ * Copy a large payload into a buffer, as a producer publishing from its own memory otherwise must, and receive it back.
+ */
+static void *
+_benchmark_SendLargeCopied(_BenchmarkState *state)
+{
+    PARCBuffer *payload = parcBuffer_Allocate(LARGE_PAYLOAD_SIZE);
+    parcBuffer_PutArray(payload, LARGE_PAYLOAD_SIZE, state->largePayload);
+    parcBuffer_Flip(payload);
+
+    CCNxContentObject *contentObject = ccnxContentObject_CreateWithNameAndPayload(state->name, payload);
+    CCNxMetaMessage *message = ccnxMetaMessage_CreateFromContentObject(contentObject);
+
+    ccnxPortal_Send(state->portal, message, CCNxStackTimeout_Never);
+
+    ccnxMetaMessage_Release(&message);
+    ccnxContentObject_Release(&contentObject);
+    parcBuffer_Release(&payload);
+
+    return ccnxPortal_Receive(state->portal, CCNxStackTimeout_Never);
+}
+
+/*
+ * Send a large payload from the application's memory without copying it, and receive it back.
+ */
+static void *
+_benchmark_SendLargeWrapped(_BenchmarkState *state)
+{
+    ccnxPortal_SendPayload(state->portal, state->name, state->largePayload, LARGE_PAYLOAD_SIZE, NULL, NULL, CCNxStackTimeout_Never);
+
+    return ccnxPortal_Receive(state->portal, CCNxStackTimeout_Never);
+}
+
+/*
+ * Flatten a payload of slices into one buffer, as a producer otherwise must, and encode the Content Object, as the RTA stack does.
+ */
+static void *
+_benchmark_PayloadFlatten(_BenchmarkState *state, const CCNxPortalPayloadVector *vector)
+{
+    PARCBuffer *payload = ccnxPortalPayloadVector_Flatten(vector);
+
+    CCNxContentObject *contentObject = ccnxContentObject_CreateWithNameAndPayload(state->name, payload);
+    CCNxMetaMessage *message = ccnxMetaMessage_CreateFromContentObject(contentObject);
+    PARCBuffer *result = ccnxMetaMessage_CreateWireFormatBuffer(message, NULL);
+
+    ccnxMetaMessage_Release(&message);
+    ccnxContentObject_Release(&contentObject);
+    parcBuffer_Release(&payload);
+
+    return result;
+}
+
+static void *
+_benchmark_PayloadFlatten3(_BenchmarkState *state)
+{
+    return _benchmark_PayloadFlatten(state, state->vectors[0]);
+}
+
+static void *
+_benchmark_PayloadFlatten8(_BenchmarkState *state)
+{
+    return _benchmark_PayloadFlatten(state, state->vectors[1]);
+}
+
+static void *
+_benchmark_PayloadFlatten32(_BenchmarkState *state)
+{
+    return _benchmark_PayloadFlatten(state, state->vectors[2]);
+}
+
+/*
+ * Gather a payload of slices directly into the encoded Content Object.
+ */
+static void *
+_benchmark_PayloadGather3(_BenchmarkState *state)
+{
+    return ccnxPortalPayloadVector_CreateMessage(state->vectors[0], state->name);
+}
+
+static void *
+_benchmark_PayloadGather8(_BenchmarkState *state)
+{
+    return ccnxPortalPayloadVector_CreateMessage(state->vectors[1], state->name);
+}
+
+static void *
+_benchmark_PayloadGather32(_BenchmarkState *state)
+{
+    return ccnxPortalPayloadVector_CreateMessage(state->vectors[2], state->name);
+}
+
+/*
+ * Create the Interest for the next chunk and encode it.
+ */
+static void *
+_benchmark_InterestEncode(_BenchmarkState *state)
+{
+    CCNxName *name = ccnxName_Copy(state->name);
+    CCNxNameSegment *segment = ccnxNameSegmentNumber_Create(CCNxNameLabelType_CHUNK, state->chunk++);
+    ccnxName_Append(name, segment);
+    ccnxNameSegment_Release(&segment);
+
+    CCNxInterest *interest = ccnxInterest_CreateSimple(name);
+    CCNxMetaMessage *message = ccnxMetaMessage_CreateFromInterest(interest);
+    PARCBuffer *result = ccnxMetaMessage_CreateWireFormatBuffer(message, NULL);
+
+    ccnxMetaMessage_Release(&message);
+    ccnxInterest_Release(&interest);
+    ccnxName_Release(&name);
+
+    return result;
+}
+
+/*
+ * Make the encoded Interest for the next chunk from a template.
+ */
+static void *
+_benchmark_InterestTemplate(_BenchmarkState *state)
+{
+    return ccnxPortalInterestTemplate_CreateMessageWithNumber(state->interestTemplate, state->chunk++);
+}
+
+static CCNxMetaMessage *
+_benchmark_ServerHandler(CCNxPortalServer *server, const CCNxName *prefix, const CCNxInterest *interest, void *context)
+{
+    _BenchmarkState *state = context;
+    state->served++;
+    return NULL;
+}
+
+/*
+ * Dispatch the next Interest to its handler. The handler sends nothing, so this measures the lookup and the call.
+ */
+static void *
+_benchmark_ServerDispatch(_BenchmarkState *state)
+{
+    ccnxPortalServer_Dispatch(state->server, state->requests[state->request++ % SERVER_REQUEST_COUNT]);
+    return NULL;
+}
+
+/*
+ * Register a handler for each of the server dispatch benchmark's prefixes, and create the Interests it dispatches.
+ */
+static bool
+_benchmark_CreateServer(_BenchmarkState *state)
+{
+    state->serverPortal = ccnxPortalFactory_CreatePortal(state->factory, ccnxPortalAPI_LoopBack);
+    if (state->serverPortal == NULL) {
+        return false;
+    }
+    state->server = ccnxPortalServer_Create(state->serverPortal);
+
+    char uri[128];
+    for (unsigned int i = 0; i < SERVER_PREFIX_COUNT; i++) {
+        snprintf(uri, sizeof(uri), "lci:/ccnx/benchmark/server/p%u/q%u", i / 100, i % 100);
+        CCNxName *prefix = ccnxName_CreateFromCString(uri);
+        bool registered = ccnxPortalServer_Register(state->server, prefix, _benchmark_ServerHandler, state);
+        ccnxName_Release(&prefix);
+        if (!registered) {
+            return false;
+        }
+    }
+
+    // Spread the Interests over the prefixes, each a few segments longer than the prefix it matches.
+    for (unsigned int i = 0; i < SERVER_REQUEST_COUNT; i++) {
+        unsigned int target = (i * 7919) % SERVER_PREFIX_COUNT;
+        snprintf(uri, sizeof(uri), "lci:/ccnx/benchmark/server/p%u/q%u/file/chunk%u", target / 100, target % 100, i);
+        CCNxName *name = ccnxName_CreateFromCString(uri);
+        CCNxInterest *interest = ccnxInterest_CreateSimple(name);
+        state->requests[i] = ccnxMetaMessage_CreateFromInterest(interest);
+        ccnxInterest_Release(&interest);
+        ccnxName_Release(&name);
+    }
+
+    return true;
+}
+
+/*
+ * Respond to an Interest with a Content Object carrying the benchmark payload.
+ * The handlers run on executor workers, so they only read the shared state.
+ */
+static CCNxMetaMessage *
+_benchmark_MixedRespond(const CCNxInterest *interest, const _BenchmarkState *state)
+{
+    PARCBuffer *payload = parcBuffer_Wrap((uint8_t *) state->payload, PAYLOAD_SIZE, 0, PAYLOAD_SIZE);
+    CCNxContentObject *contentObject = ccnxContentObject_CreateWithNameAndPayload(ccnxInterest_GetName(interest), payload);
+    CCNxMetaMessage *result = ccnxMetaMessage_CreateFromContentObject(contentObject);
+    ccnxContentObject_Release(&contentObject);
+    parcBuffer_Release(&payload);
+    return result;
+}
+
+static CCNxMetaMessage *
+_benchmark_MixedFastHandler(CCNxPortalServer *server, const CCNxName *prefix, const CCNxInterest *interest, void *context)
+{
+    return _benchmark_MixedRespond(interest, context);
+}
+
+static CCNxMetaMessage *
+_benchmark_MixedSlowHandler(CCNxPortalServer *server, const CCNxName *prefix, const CCNxInterest *interest, void *context)
+{
+    // Stands in for a handler that computes or looks up its response.
+    uint64_t until = _nanoTime() + MIXED_SLOW_NANOS;
+    while (_nanoTime() < until) {
+    }
+    return _benchmark_MixedRespond(interest, context);
+}
+
+static void
+_benchmark_MixedDrain(CCNxPortal *portal)
+{
+    CCNxMetaMessage *message;
+    while ((message = ccnxPortal_Receive(portal, CCNxStackTimeout_Immediate)) != NULL) {
+        ccnxMetaMessage_Release(&message);
+    }
+}
+
+/*
+ * Serve a batch of Interests, calling each handler in turn on this thread, and receive the responses.
+ */
+static void *
+_benchmark_MixedInline(_BenchmarkState *state)
+{
+    for (size_t i = 0; i < MIXED_BATCH_SIZE; i++) {
+        ccnxPortalServer_Dispatch(state->inlineServer, state->mixedRequests[i]);
+    }
+    _benchmark_MixedDrain(state->inlinePortal);
+    return NULL;
+}
+
+/*
+ * Serve a batch of Interests on the executor's workers, send their responses in one batch, and receive them.
+ */
+static void *
+_benchmark_MixedExecutor(_BenchmarkState *state)
+{
+    for (size_t i = 0; i < MIXED_BATCH_SIZE; i++) {
+        ccnxPortalServer_Dispatch(state->executorServer, state->mixedRequests[i]);
+    }
+    ccnxPortalExecutor_Wait(state->executor);
+    ccnxPortalServer_SendReplies(state->executorServer);
+    _benchmark_MixedDrain(state->executorPortal);
+    return NULL;
+}
+
+static CCNxPortalServer *
+_benchmark_CreateMixedServer(_BenchmarkState *state, CCNxPortal *portal)
+{
+    CCNxPortalServer *result = ccnxPortalServer_Create(portal);
+    if (result != NULL) {
+        CCNxName *fast = ccnxName_CreateFromCString("lci:/ccnx/benchmark/mixed/fast");
+        CCNxName *slow = ccnxName_CreateFromCString("lci:/ccnx/benchmark/mixed/slow");
+        bool registered = ccnxPortalServer_Register(result, fast, _benchmark_MixedFastHandler, state)
+                          && ccnxPortalServer_Register(result, slow, _benchmark_MixedSlowHandler, state);
+        ccnxName_Release(&slow);
+        ccnxName_Release(&fast);
+        if (!registered) {
+            ccnxPortalServer_Release(&result);
+        }
+    }
+    return result;
+}
+
+/*
+ * Create the mixed server benchmarks' servers, each on its own Portal, and the Interests they serve.
+ */
+static bool
+_benchmark_CreateMixedServers(_BenchmarkState *state)
+{
+    state->inlinePortal = ccnxPortalFactory_CreatePortal(state->factory, ccnxPortalAPI_LoopBack);
+    state->executorPortal = ccnxPortalFactory_CreatePortal(state->factory, ccnxPortalAPI_LoopBack);
+    state->executor = ccnxPortalExecutor_Create(MIXED_WORKER_COUNT, MIXED_QUEUE_CAPACITY);
+    if (state->inlinePortal == NULL || state->executorPortal == NULL || state->executor == NULL) {
+        return false;
+    }
+
+    state->inlineServer = _benchmark_CreateMixedServer(state, state->inlinePortal);
+    state->executorServer = _benchmark_CreateMixedServer(state, state->executorPortal);
+    if (state->inlineServer == NULL || state->executorServer == NULL) {
+        return false;
+    }
+    ccnxPortalServer_SetExecutor(state->executorServer, state->executor);
+
+    char uri[128];
+    for (unsigned int i = 0; i < MIXED_BATCH_SIZE; i++) {
+        snprintf(uri, sizeof(uri), "lci:/ccnx/benchmark/mixed/%s/chunk%u", (i % MIXED_SLOW_RATIO == 0) ? "slow" : "fast", i);
+        CCNxName *name = ccnxName_CreateFromCString(uri);
+        CCNxInterest *interest = ccnxInterest_CreateSimple(name);
+        state->mixedRequests[i] = ccnxMetaMessage_CreateFromInterest(interest);
+        ccnxInterest_Release(&interest);
+        ccnxName_Release(&name);
+    }
+
+    return true;
+}
+
+static CCNxPortal *
+_benchmark_CreateReplayPortal(_BenchmarkState *state)
+{
+    CCNxPortal *result = ccnxPortalFactory_CreatePortal(state->factory, ccnxPortalReplay_AsFastAsPossible);
+    if (result != NULL) {
+        CCNxPortalAttributes *attributes = ccnxPortalAttributes_Copy(ccnxPortal_GetAttributes(result));
+        ccnxPortalAttributes_SetMaxBatchSize(attributes, RECEIVE_BATCH_SIZE);
+        ccnxPortal_SetAttributes(result, attributes);
+        ccnxPortalAttributes_Release(&attributes);
+    }
+    return result;
+}
+
+/*
+ * Receive a batch of messages from the replayed trace, starting the trace again when it is exhausted,
+ * then process and release them as an application would.
+ */
+static void
+_benchmark_ReceiveBatch(_BenchmarkState *state, CCNxPortalArena *arena)
+{
+    size_t count = ccnxPortal_ReceiveBatch(state->replay, state->batch, RECEIVE_BATCH_SIZE, arena, CCNxStackTimeout_Never);
+    if (count == 0) {
+        ccnxPortal_Release(&state->replay);
+        state->replay = _benchmark_CreateReplayPortal(state);
+        count = ccnxPortal_ReceiveBatch(state->replay, state->batch, RECEIVE_BATCH_SIZE, arena, CCNxStackTimeout_Never);
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        state->receivedBytes += parcBuffer_Remaining(ccnxContentObject_GetPayload(ccnxMetaMessage_GetContentObject(state->batch[i])));
+        ccnxMetaMessage_Release(&state->batch[i]);
+    }
+}
+
+static void *
+_benchmark_ReceiveBatchHeap(_BenchmarkState *state)
+{
+    _benchmark_ReceiveBatch(state, NULL);
+
+    return NULL;
+}
+
+static void *
+_benchmark_ReceiveBatchArena(_BenchmarkState *state)
+{
+    _benchmark_ReceiveBatch(state, state->arena);
+    ccnxPortalArena_Reset(state->arena);
+
+    return NULL;
+}
+
+static void *
+_benchmark_AnchorSerialize(_BenchmarkState *state)
+{
+    PARCBufferComposer *composer = parcBufferComposer_Create();
+    ccnxPortalAnchor_Serialize(state->anchor, composer);
+    PARCBuffer *result = parcBufferComposer_ProduceBuffer(composer);
+    parcBufferComposer_Release(&composer);
+
+    return result;
+}
+
+static void *
+_benchmark_AnchorDeserialize(_BenchmarkState *state)
+{
+    parcBuffer_Rewind(state->serializedAnchor);
+    return ccnxPortalAnchor_Deserialize(state->serializedAnchor);
+}
+
+/*
+ * Compose the message a Portal sends to its local router when it starts listening, anchor creation included.
+ */
+static void *
+_benchmark_AnchorCompose(_BenchmarkState *state)
+{
+    CCNxPortalAnchor *anchor = ccnxPortalAnchor_Create(state->name, time(0) + 60);
+    CCNxMetaMessage *result = _ccnxPortal_ComposeAnchorMessage(state->anchorName, anchor);
+    ccnxPortalAnchor_Release(&anchor);
+
+    return result;
+}
+
+static void *
+_benchmark_ListenIgnore(_BenchmarkState *state)
+{
+    ccnxPortal_Listen(state->portal, state->name, 60, CCNxStackTimeout_Never);
+    ccnxPortal_Ignore(state->portal, state->name, CCNxStackTimeout_Never);
+
+    return NULL;
+}
+
+/*
+ * The API loopback stack returns the flush request itself rather than an acknowledgement,
+ * so this measures the Portal's side of a Flush: composing, sending and receiving the control message.
+ */
+static void *
+_benchmark_Flush(_BenchmarkState *state)
+{
+    ccnxPortal_Flush(state->portal, CCNxStackTimeout_Never);
+
+    return NULL;
+}
+
+static void *
+_benchmark_PortalCreate(_BenchmarkState *state)
+{
+    return ccnxPortalFactory_CreatePortal(state->factory, ccnxPortalAPI_LoopBack);
+}
+
+static void *
+_benchmark_FactoryCreate(_BenchmarkState *state)
+{
+    return ccnxPortalFactory_Create(state->identity);
+}
+
+static const _Benchmark _benchmarks[] = {
+    { "ccnxPortal_SendReceive",            _benchmark_SendReceive,       _benchmark_ReleaseMetaMessage, 1                  },
+    { "ccnxPortal_SendReceiveBuilt",       _benchmark_SendReceiveBuilt,  _benchmark_ReleaseMetaMessage, 1                  },
+    { "ccnxPortal_SendReceivePooled",      _benchmark_SendReceivePooled, _benchmark_ReleaseMetaMessage, 1                  },
+    { "ccnxPortal_SendLargeCopied",        _benchmark_SendLargeCopied,   _benchmark_ReleaseMetaMessage, 1                  },
+    { "ccnxPortal_SendLargeWrapped",       _benchmark_SendLargeWrapped,  _benchmark_ReleaseMetaMessage, 1                  },
+    { "ccnxPortalPayloadVector_Flatten3",  _benchmark_PayloadFlatten3,   _benchmark_ReleaseBuffer,      0                  },
+    { "ccnxPortalPayloadVector_Flatten8",  _benchmark_PayloadFlatten8,   _benchmark_ReleaseBuffer,      0                  },
+    { "ccnxPortalPayloadVector_Flatten32", _benchmark_PayloadFlatten32,  _benchmark_ReleaseBuffer,      0                  },
+    { "ccnxPortalPayloadVector_Gather3",   _benchmark_PayloadGather3,    _benchmark_ReleaseMetaMessage, 0                  },
+    { "ccnxPortalPayloadVector_Gather8",   _benchmark_PayloadGather8,    _benchmark_ReleaseMetaMessage, 0                  },
+    { "ccnxPortalPayloadVector_Gather32",  _benchmark_PayloadGather32,   _benchmark_ReleaseMetaMessage, 0                  },
+    { "ccnxPortalServer_Dispatch",         _benchmark_ServerDispatch,    NULL,                          0                  },
+    { "ccnxPortalServer_MixedInline",      _benchmark_MixedInline,       NULL,                          MIXED_BATCH_SIZE   },
+    { "ccnxPortalServer_MixedExecutor",    _benchmark_MixedExecutor,     NULL,                          MIXED_BATCH_SIZE   },
+    { "ccnxInterest_Encode",               _benchmark_InterestEncode,    _benchmark_ReleaseBuffer,      0                  },
+    { "ccnxPortalInterestTemplate",        _benchmark_InterestTemplate,  _benchmark_ReleaseMetaMessage, 0                  },
+    { "ccnxPortal_ReceiveBatchHeap",       _benchmark_ReceiveBatchHeap,  NULL,                          RECEIVE_BATCH_SIZE },
+    { "ccnxPortal_ReceiveBatchArena",      _benchmark_ReceiveBatchArena, NULL,                          RECEIVE_BATCH_SIZE },
+    { "ccnxPortalAnchor_Serialize",        _benchmark_AnchorSerialize,   _benchmark_ReleaseBuffer,      0                  },
+    { "ccnxPortalAnchor_Deserialize",      _benchmark_AnchorDeserialize, _benchmark_ReleaseAnchor,      0                  },
+    { "ccnxPortal_ComposeAnchor",          _benchmark_AnchorCompose,     _benchmark_ReleaseMetaMessage, 0                  },
+    { "ccnxPortal_ListenIgnore",           _benchmark_ListenIgnore,      NULL,                          0                  },
+    { "ccnxPortal_Flush",                  _benchmark_Flush,             NULL,                          0                  },
+    { "ccnxPortalFactory_CreatePortal",    _benchmark_PortalCreate,      _benchmark_ReleasePortal,      0                  },
+    { "ccnxPortalFactory_Create",          _benchmark_FactoryCreate,     _benchmark_ReleaseFactory,     0                  },
+};
+
+/*
+ * Record the trace the batch receive benchmarks replay: Content Objects received by a Portal.
+ */
+static bool
+_benchmark_RecordTrace(_BenchmarkState *state)
+{
+    sprintf(state->traceFile, "/tmp/ccnx_portal_benchmarks-%d.trace", (int) getpid());
+
+    CCNxPortalTrace *trace = ccnxPortalTrace_CreateWriter(state->traceFile);
+    if (trace == NULL) {
+        return false;
+    }
+
+    PARCBuffer *payload = parcBuffer_Wrap(state->payload, PAYLOAD_SIZE, 0, PAYLOAD_SIZE);
+    CCNxContentObject *contentObject = ccnxContentObject_CreateWithNameAndPayload(state->name, payload);
+    CCNxMetaMessage *message = ccnxMetaMessage_CreateFromContentObject(contentObject);
+
+    bool result = true;
+    for (size_t i = 0; i < RECEIVE_TRACE_LENGTH && result; i++) {
+        result = ccnxPortalTrace_Append(trace, CCNxPortalTraceDirection_Receive, ccnxPortalTrace_Now(), message);
+    }
+
+    ccnxMetaMessage_Release(&message);
+    ccnxContentObject_Release(&contentObject);
+    parcBuffer_Release(&payload);
+    ccnxPortalTrace_Release(&trace);
+
+    if (result) {
+        ccnxPortalFactory_SetProperty(state->factory, CCNxPortalReplay_File, state->traceFile);
+    }
+    return result;
+}
+
+static void
+_benchmarkState_Fini(_BenchmarkState *state)
+{
+    if (state->replay != NULL) {
+        ccnxPortal_Release(&state->replay);
+    }
+    if (state->traceFile[0] != '\0') {
+        unlink(state->traceFile);
+    }
+    ccnxPortalArena_Release(&state->arena);
+    ccnxPortalInterestTemplate_Release(&state->interestTemplate);
+    for (size_t i = 0; i < SERVER_REQUEST_COUNT; i++) {
+        if (state->requests[i] != NULL) {
+            ccnxMetaMessage_Release(&state->requests[i]);
+        }
+    }
+    if (state->server != NULL) {
+        ccnxPortalServer_Release(&state->server);
+    }
+    if (state->serverPortal != NULL) {
+        ccnxPortal_Release(&state->serverPortal);
+    }
+    for (size_t i = 0; i < MIXED_BATCH_SIZE; i++) {
+        if (state->mixedRequests[i] != NULL) {
+            ccnxMetaMessage_Release(&state->mixedRequests[i]);
+        }
+    }
+    if (state->inlineServer != NULL) {
+        ccnxPortalServer_Release(&state->inlineServer);
+    }
+    if (state->executorServer != NULL) {
+        ccnxPortalServer_Release(&state->executorServer);
+    }
+    if (state->executor != NULL) {
+        ccnxPortalExecutor_Release(&state->executor);
+    }
+    if (state->inlinePortal != NULL) {
+        ccnxPortal_Release(&state->inlinePortal);
+    }
+    if (state->executorPortal != NULL) {
+        ccnxPortal_Release(&state->executorPortal);
+    }
+    for (size_t i = 0; i < VECTOR_COUNT; i++) {
+        ccnxPortalPayloadVector_Release(&state->vectors[i]);
+    }
+    parcMemory_Deallocate(&state->largePayload);
+    ccnxPortalMessagePool_Release(&state->pool);
+    parcBuffer_Release(&state->serializedAnchor);
+    ccnxPortalAnchor_Release(&state->anchor);
+    ccnxMetaMessage_Release(&state->message);
+    ccnxName_Release(&state->name);
+    ccnxPortal_Release(&state->portal);
+    ccnxPortalFactory_Release(&state->factory);
+}
+
+static bool
+_benchmarkState_Init(_BenchmarkState *state, const PARCIdentity *identity)
+{
+    memset(state, 0, sizeof(*state));
+    state->identity = identity;
+
+    state->factory = ccnxPortalFactory_Create(identity);
+    state->portal = ccnxPortalFactory_CreatePortal(state->factory, ccnxPortalAPI_LoopBack);
+    if (state->portal == NULL) {
+        ccnxPortalFactory_Release(&state->factory);
+        return false;
+    }
+
+    state->name = ccnxName_CreateFromCString("lci:/ccnx/benchmark/portal/hot/path");
+
+    CCNxInterest *interest = ccnxInterest_CreateSimple(state->name);
+    state->message = ccnxMetaMessage_CreateFromInterest(interest);
+    ccnxInterest_Release(&interest);
+
+    state->anchor = ccnxPortalAnchor_Create(state->name, time(0) + 60);
+    PARCBufferComposer *composer = parcBufferComposer_Create();
+    ccnxPortalAnchor_Serialize(state->anchor, composer);
+    state->serializedAnchor = parcBufferComposer_ProduceBuffer(composer);
+    parcBufferComposer_Release(&composer);
+
+    state->anchorName = ccnxPortalConfiguration_GetAnchorName(ccnxPortalFactory_GetConfiguration(state->factory));
+
+    state->pool = ccnxPortalMessagePool_Create(64, PAYLOAD_SIZE);
+    for (size_t i = 0; i < PAYLOAD_SIZE; i++) {
+        state->payload[i] = (uint8_t) i;
+    }
+
+    CCNxName *chunkName = ccnxName_Copy(state->name);
+    CCNxNameSegment *segment = ccnxNameSegmentNumber_Create(CCNxNameLabelType_CHUNK, 0);
+    ccnxName_Append(chunkName, segment);
+    ccnxNameSegment_Release(&segment);
+    CCNxInterest *chunkInterest = ccnxInterest_CreateSimple(chunkName);
+    state->interestTemplate = ccnxPortalInterestTemplate_Create(chunkInterest);
+    ccnxInterest_Release(&chunkInterest);
+    ccnxName_Release(&chunkName);
+
+    state->largePayload = parcMemory_Allocate(LARGE_PAYLOAD_SIZE);
+    memset(state->largePayload, 0x5A, LARGE_PAYLOAD_SIZE);
+
+    // Each payload vector slices the same bytes of the large payload into equal parts.
+    const size_t sliceCounts[VECTOR_COUNT] = { 3, 8, 32 };
+    for (size_t i = 0; i < VECTOR_COUNT; i++) {
+        state->vectors[i] = ccnxPortalPayloadVector_Create();
+        size_t offset = 0;
+        for (size_t slice = 0; slice < sliceCounts[i]; slice++) {
+            size_t end = VECTOR_PAYLOAD_SIZE * (slice + 1) / sliceCounts[i];
+            PARCBuffer *buffer = parcBuffer_Wrap(state->largePayload, VECTOR_PAYLOAD_SIZE, offset, end);
+            ccnxPortalPayloadVector_Append(state->vectors[i], buffer);
+            parcBuffer_Release(&buffer);
+            offset = end;
+        }
+    }
+
+    state->arena = ccnxPortalArena_Create();
+    if (_benchmark_RecordTrace(state)) {
+        state->replay = _benchmark_CreateReplayPortal(state);
+    }
+    if (state->replay == NULL || _benchmark_CreateServer(state) == false || _benchmark_CreateMixedServers(state) == false) {
+        _benchmarkState_Fini(state);
+        return false;
+    }
+
+    return true;
+}
+
+static uint64_t
+_benchmark_RunBatch(const _Benchmark *benchmark, _BenchmarkState *state, uint64_t iterations)
+{
+    uint64_t start = _nanoTime();
+    for (uint64_t i = 0; i < iterations; i++) {
+        void *result = benchmark->operation(state);
+        if (result != NULL && benchmark->release != NULL) {
+            benchmark->release(&result);
+        }
+    }
+    return _nanoTime() - start;
+}
+
+/*
+ * Double the batch size until a batch takes at least the minimum batch time.
+ */
+static uint64_t
+_benchmark_Calibrate(const _Benchmark *benchmark, _BenchmarkState *state, const BenchmarkOptions *options)
+{
+    if (options->iterations > 0) {
+        return options->iterations;
+    }
+
+    uint64_t iterations = 1;
+    while (_benchmark_RunBatch(benchmark, state, iterations) < options->minimumBatchNanos && iterations < (1ULL << 30)) {
+        iterations *= 2;
+    }
+    return iterations;
+}
+
+/*
+ * Count, per operation, the allocator calls made and the allocations left behind once each result is released.
+ * Run after the warmup, so a benchmark's pools, queues and arena have already grown to their working size.
+ * The counting memory interface is installed for the whole run, beneath the arena,
+ * so memory an arena hands out from its blocks is not counted.
+ */
+static void
+_benchmark_CountAllocations(const _Benchmark *benchmark, _BenchmarkState *state, double *allocationsPerOp, double *retainedPerOp)
+{
+    int64_t before = parcMemory_Outstanding();
+
+    _benchmark_Allocations = 0;
+    _benchmark_RunBatch(benchmark, state, ALLOCATION_SAMPLE);
+
+    int64_t after = parcMemory_Outstanding();
+
+    *allocationsPerOp = (double) _benchmark_Allocations / ALLOCATION_SAMPLE;
+    *retainedPerOp = (double) (after - before) / ALLOCATION_SAMPLE;
+}
+
+static int
+_benchmark_CompareDouble(const void *a, const void *b)
+{
+    double x = *(const double *) a;
+    double y = *(const double *) b;
+    return (x > y) - (x < y);
+}
+
+static double
+_benchmark_Median(double *sorted, size_t count)
+{
+    return (count % 2 == 1) ? sorted[count / 2] : (sorted[count / 2 - 1] + sorted[count / 2]) / 2.0;
+}
+
+static _BenchmarkStatistics
+_benchmark_Statistics(double *samples, size_t count)
+{
+    _BenchmarkStatistics result;
+
+    qsort(samples, count, sizeof(double), _benchmark_CompareDouble);
+
+    double sum = 0;
+    for (size_t i = 0; i < count; i++) {
+        sum += samples[i];
+    }
+    result.minimum = samples[0];
+    result.maximum = samples[count - 1];
+    result.mean = sum / count;
+    result.median = _benchmark_Median(samples, count);
+
+    double deviations[MAX_REPETITIONS];
+    for (size_t i = 0; i < count; i++) {
+        deviations[i] = fabs(samples[i] - result.median);
+    }
+    qsort(deviations, count, sizeof(double), _benchmark_CompareDouble);
+    result.medianAbsoluteDeviation = _benchmark_Median(deviations, count);
+
+    return result;
+}
+
+static void
+_benchmark_AddFloat(PARCJSON *json, const char *name, double number)
+{
+    PARCJSONValue *value = parcJSONValue_CreateFromFloat(number);
+    parcJSON_AddValue(json, name, value);
+    parcJSONValue_Release(&value);
+}
+
+static PARCJSON *
+_benchmark_Run(const _Benchmark *benchmark, _BenchmarkState *state, const BenchmarkOptions *options)
+{
+    uint64_t iterations = _benchmark_Calibrate(benchmark, state, options);
+
+    for (unsigned int i = 0; i < options->warmupBatches; i++) {
+        _benchmark_RunBatch(benchmark, state, iterations);
+    }
+
+    double nanosPerOp[MAX_REPETITIONS];
+    for (unsigned int i = 0; i < options->repetitions; i++) {
+        nanosPerOp[i] = (double) _benchmark_RunBatch(benchmark, state, iterations) / iterations;
+    }
+    _BenchmarkStatistics statistics = _benchmark_Statistics(nanosPerOp, options->repetitions);
+
+    double allocationsPerOp;
+    double retainedPerOp;
+    _benchmark_CountAllocations(benchmark, state, &allocationsPerOp, &retainedPerOp);
+
+    fprintf(stderr, "%-32s %12.1f ns/op  +/- %8.1f  %6.2f allocations/op  %6.2f retained/op",
+            benchmark->name, statistics.median, statistics.medianAbsoluteDeviation, allocationsPerOp, retainedPerOp);
+    if (benchmark->messagesPerOp > 0) {
+        fprintf(stderr, "  %12.0f messages/s  %12.0f allocator calls/s",
+                benchmark->messagesPerOp * 1e9 / statistics.median, allocationsPerOp * 1e9 / statistics.median);
+    }
+    fprintf(stderr, "\n");
+
+    PARCJSON *result = parcJSON_Create();
+    parcJSON_AddString(result, "name", benchmark->name);
+    parcJSON_AddInteger(result, "iterations", (int64_t) iterations);
+    parcJSON_AddInteger(result, "repetitions", options->repetitions);
+
+    PARCJSON *nanos = parcJSON_Create();
+    _benchmark_AddFloat(nanos, "min", statistics.minimum);
+    _benchmark_AddFloat(nanos, "median", statistics.median);
+    _benchmark_AddFloat(nanos, "mean", statistics.mean);
+    _benchmark_AddFloat(nanos, "max", statistics.maximum);
+    _benchmark_AddFloat(nanos, "mad", statistics.medianAbsoluteDeviation);
+    parcJSON_AddObject(result, "nsPerOp", nanos);
+    parcJSON_Release(&nanos);
+
+    _benchmark_AddFloat(result, "allocationsPerOp", allocationsPerOp);
+    _benchmark_AddFloat(result, "retainedAllocationsPerOp", retainedPerOp);
+
+    if (benchmark->messagesPerOp > 0) {
+        parcJSON_AddInteger(result, "messagesPerOp", (int64_t) benchmark->messagesPerOp);
+        _benchmark_AddFloat(result, "messagesPerSecond", benchmark->messagesPerOp * 1e9 / statistics.median);
+        _benchmark_AddFloat(result, "allocatorCallsPerMessage", allocationsPerOp / benchmark->messagesPerOp);
+        _benchmark_AddFloat(result, "allocatorCallsPerSecond", allocationsPerOp * 1e9 / statistics.median);
+    }
+
+    return result;
+}
+
+/*
+ * The shard scaling benchmark's handler answers each Interest with the Interest itself,
+ * which the shard's loopback Portal hands straight back to the shard, so each shard serves a closed loop of its own.
+ */
+static CCNxMetaMessage *
+_benchmark_ShardHandler(CCNxPortalServer *server, const CCNxName *prefix, const CCNxInterest *interest, void *context)
+{
+    return ccnxMetaMessage_CreateFromInterest(interest);
+}
+
+/*
+ * Serve with the given number of shards for the scaling time, and return the Interests served per second, or -1.
+ */
+static double
+_benchmark_ShardThroughput(_BenchmarkState *state, size_t shardCount)
+{
+    CCNxPortalShards *shards = ccnxPortalShards_Create(state->factory, ccnxPortalAPI_LoopBack, shardCount);
+    if (shards == NULL) {
+        return -1;
+    }
+    if (ccnxPortalShards_Register(shards, state->name, _benchmark_ShardHandler, NULL) == false) {
+        ccnxPortalShards_Release(&shards);
+        return -1;
+    }
+
+    // Each shard gets its own Interest, so that no message is shared between threads.
+    for (size_t i = 0; i < shardCount; i++) {
+        CCNxInterest *interest = ccnxInterest_CreateSimple(state->name);
+        CCNxMetaMessage *message = ccnxMetaMessage_CreateFromInterest(interest);
+        ccnxPortal_Send(ccnxPortalShards_GetPortal(shards, i), message, CCNxStackTimeout_Never);
+        ccnxMetaMessage_Release(&message);
+        ccnxInterest_Release(&interest);
+    }
+
+    double result = -1;
+    uint64_t start = _nanoTime();
+    if (ccnxPortalShards_Start(shards)) {
+        usleep(SHARD_SCALING_MILLISECONDS * 1000);
+        CCNxPortalStatistics *statistics = ccnxPortalShards_CreateStatistics(shards);
+        uint64_t elapsed = _nanoTime() - start;
+        ccnxPortalShards_Stop(shards);
+
+        if (statistics != NULL) {
+            uint64_t served = ccnxPortalStatistics_GetCounter(statistics, CCNxPortalStatisticsCounter_InterestsReceived);
+            result = served * 1e9 / elapsed;
+            ccnxPortalStatistics_Release(&statistics);
+        }
+    }
+
+    ccnxPortalShards_Release(&shards);
+    return result;
+}
+
+/*
+ * Measure the throughput of 1, 2, 4 and so on shards, up to one per online CPU, and the speedup of each over one shard.
+ */
+static PARCJSONArray *
+_benchmark_ShardScaling(_BenchmarkState *state)
+{
+    long online = sysconf(_SC_NPROCESSORS_ONLN);
+    size_t cpus = (online > 0) ? (size_t) online : 1;
+    PARCJSONArray *result = parcJSONArray_Create();
+
+    double baseline = 0;
+    size_t shardCount = 1;
+    while (true) {
+        double throughput = _benchmark_ShardThroughput(state, shardCount);
+        if (throughput < 0) {
+            fprintf(stderr, "%-32s cannot run %zu shards: %s\n", SHARD_SCALING_NAME, shardCount, strerror(errno));
+            break;
+        }
+        if (shardCount == 1) {
+            baseline = throughput;
+        }
+        double speedup = (baseline > 0) ? throughput / baseline : 0;
+
+        fprintf(stderr, "%-32s %4zu shards  %12.0f Interests/s  %6.2fx\n", SHARD_SCALING_NAME, shardCount, throughput, speedup);
+
+        PARCJSON *json = parcJSON_Create();
+        parcJSON_AddInteger(json, "shards", (int64_t) shardCount);
+        _benchmark_AddFloat(json, "interestsPerSecond", throughput);
+        _benchmark_AddFloat(json, "speedup", speedup);
+        PARCJSONValue *value = parcJSONValue_CreateFromJSON(json);
+        parcJSONArray_AddValue(result, value);
+        parcJSONValue_Release(&value);
+        parcJSON_Release(&json);
+
+        if (shardCount == cpus) {
+            break;
+        }
+        shardCount = (shardCount * 2 < cpus) ? shardCount * 2 : cpus;
+    }
+
+    return result;
+}
+
+static PARCJSON *
+_benchmark_CreateConfigurationJSON(const BenchmarkOptions *options)
+{
+    PARCJSON *result = parcJSON_Create();
+    parcJSON_AddInteger(result, "repetitions", options->repetitions);
+    parcJSON_AddInteger(result, "warmupBatches", options->warmupBatches);
+    parcJSON_AddInteger(result, "minimumBatchNanoseconds", (int64_t) options->minimumBatchNanos);
+    parcJSON_AddInteger(result, "iterations", (int64_t) options->iterations);
+    if (options->filter != NULL) {
+        parcJSON_AddString(result, "filter", options->filter);
+    }
+
+    return result;
+}
+
+int
+ccnxPortalBenchmarks(const PARCIdentity *identity, const BenchmarkOptions *options)
+{
+    // Installed beneath the arena memory interface, so that the arena allocates its blocks through it.
+    _benchmark_Allocations = 0;
+    _benchmark_Memory = parcMemory_SetInterface(&_benchmark_CountingMemory);
+    ccnxPortalArena_Install();
+
+    _BenchmarkState state;
+    if (_benchmarkState_Init(&state, identity) == false) {
+        fprintf(stderr, "Cannot create the API loopback and replay Portals: %s\n", strerror(errno));
+        ccnxPortalArena_Uninstall();
+        parcMemory_SetInterface(_benchmark_Memory);
+        return 1;
+    }
+
+    PARCJSON *json = parcJSON_Create();
+
+    PARCJSON *configuration = _benchmark_CreateConfigurationJSON(options);
+    parcJSON_AddObject(json, "configuration", configuration);
+    parcJSON_Release(&configuration);
+
+    PARCJSONArray *results = parcJSONArray_Create();
+    for (size_t i = 0; i < sizeof(_benchmarks) / sizeof(_benchmarks[0]); i++) {
+        if (options->filter == NULL || strstr(_benchmarks[i].name, options->filter) != NULL) {
+            PARCJSON *result = _benchmark_Run(&_benchmarks[i], &state, options);
+            PARCJSONValue *value = parcJSONValue_CreateFromJSON(result);
+            parcJSONArray_AddValue(results, value);
+            parcJSONValue_Release(&value);
+            parcJSON_Release(&result);
+        }
+    }
+    parcJSON_AddArray(json, "benchmarks", results);
+    parcJSONArray_Release(&results);
+
+    if (options->filter == NULL || strstr(SHARD_SCALING_NAME, options->filter) != NULL) {
+        PARCJSONArray *scaling = _benchmark_ShardScaling(&state);
+        parcJSON_AddArray(json, "shardScaling", scaling);
+        parcJSONArray_Release(&scaling);
+    }
+
+    _benchmarkState_Fini(&state);
+    ccnxPortalArena_Uninstall();
+    parcMemory_SetInterface(_benchmark_Memory);
+
+    int status = 0;
+    FILE *output = stdout;
+    if (options->outputFile != NULL) {
+        output = fopen(options->outputFile, "w");
+        if (output == NULL) {
+            fprintf(stderr, "Cannot open '%s': %s\n", options->outputFile, strerror(errno));
+            status = 1;
+        }
+    }
+    if (output != NULL) {
+        char *string = parcJSON_ToString(json);
+        fprintf(output, "%s\n", string);
+        parcMemory_Deallocate(&string);
+        if (output != stdout) {
+            fclose(output);
+        }
+    }
+    parcJSON_Release(&json);
+
+    return status;
+}
+
+void
+usage(void)
+{
+    printf("ccnx_portal_benchmarks [--identity <file> --password <password>] [options]\n");
+    printf("ccnx_portal_benchmarks [-h | --help]\n");
+    printf("\n");
+    printf("    --identity     The file name containing a PKCS12 keystore (default a temporary keystore)\n");
+    printf("    --password     The password to unlock the keystore\n");
+    printf("    --repetitions  The number of timed batches of each benchmark (default 15, at most %d)\n", MAX_REPETITIONS);
+    printf("    --warmup       The number of untimed batches run first (default 3)\n");
+    printf("    --batch-time   The minimum milliseconds a calibrated batch takes (default 20)\n");
+    printf("    --iterations   The operations in each batch, instead of calibrating\n");
+    printf("    --filter       Run only the benchmarks whose names contain this string\n");
+    printf("    --output       Write the JSON results to this file (default standard output)\n");
+}
+
+int
+main(int argc, char *argv[argc])
+{
+    char *keystoreFile = NULL;
+    char *keystorePassword = NULL;
+    BenchmarkOptions options = {
+        .repetitions       = 15,
+        .warmupBatches     = 3,
+        .minimumBatchNanos = 20000000ULL,
+        .iterations        = 0,
+        .filter            = NULL,
+        .outputFile        = NULL
+    };
+
+    static struct option longopts[] = {
+        { "identity",    required_argument, NULL, 'f' },
+        { "password",    required_argument, NULL, 'p' },
+        { "repetitions", required_argument, NULL, 'r' },
+        { "warmup",      required_argument, NULL, 'w' },
+        { "batch-time",  required_argument, NULL, 'b' },
+        { "iterations",  required_argument, NULL, 'i' },
+        { "filter",      required_argument, NULL, 'F' },
+        { "output",      required_argument, NULL, 'o' },
+        { "help",        no_argument,       NULL, 'h' },
+        { NULL,          0,                 NULL, 0   }
+    };
+
+    int ch;
+    while ((ch = getopt_long(argc, argv, "f:p:o:h", longopts, NULL)) != -1) {
+        switch (ch) {
+            case 'f':
+                keystoreFile = optarg;
+                break;
+
+            case 'p':
+                keystorePassword = optarg;
+                break;
+
+            case 'r':
+                options.repetitions = (unsigned int) strtoul(optarg, NULL, 10);
+                break;
+
+            case 'w':
+                options.warmupBatches = (unsigned int) strtoul(optarg, NULL, 10);
+                break;
+
+            case 'b':
+                options.minimumBatchNanos = strtoull(optarg, NULL, 10) * 1000000ULL;
+                break;
+
+            case 'i':
+                options.iterations = strtoull(optarg, NULL, 10);
+                break;
+
+            case 'F':
+                options.filter = optarg;
+                break;
+
+            case 'o':
+                options.outputFile = optarg;
+                break;
+
+            case 'h':
+                usage();
+                return 0;
+
+            default:
+                usage();
+                return -1;
+        }
+    }
+
+    if (options.repetitions == 0 || options.repetitions > MAX_REPETITIONS) {
+        usage();
+        return -1;
+    }
+
+    parcSecurity_Init();
+
+    char temporaryKeystore[64] = "";
+    if (keystoreFile == NULL) {
+        sprintf(temporaryKeystore, "/tmp/ccnx_portal_benchmarks-%d.p12", (int) getpid());
+        keystoreFile = temporaryKeystore;
+        keystorePassword = "ccnx_portal_benchmarks";
+        if (parcPkcs12KeyStore_CreateFile(keystoreFile, keystorePassword, "ccnx_portal_benchmarks", 1024, 1) == false) {
+            printf("Cannot create a temporary keystore '%s'.\n", keystoreFile);
+            parcSecurity_Fini();
+            return 1;
+        }
+    }
+
+    PARCIdentityFile *identityFile = parcIdentityFile_Create(keystoreFile, keystorePassword);
+    if (parcIdentityFile_Exists(identityFile) == false) {
+        printf("Inaccessible keystore file '%s'.\n", keystoreFile);
+        exit(1);
+    }
+    PARCIdentity *identity = parcIdentity_Create(identityFile, PARCIdentityFileAsPARCIdentity);
+    parcIdentityFile_Release(&identityFile);
+
+    int result = ccnxPortalBenchmarks(identity, &options);
+
+    parcIdentity_Release(&identity);
+    if (temporaryKeystore[0] != '\0') {
+        unlink(temporaryKeystore);
+    }
+
+    parcSecurity_Fini();
+
+    return result;
+}
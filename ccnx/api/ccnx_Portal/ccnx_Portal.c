@@ -58,12 +58,17 @@
  */
 #include <config.h>
 
+#include <errno.h>
 #include <pthread.h>
 
 #include <LongBow/runtime.h>
 
 #include <ccnx/api/ccnx_Portal/ccnx_Portal.h>
 #include <ccnx/api/ccnx_Portal/ccnx_PortalAnchor.h>
+#include <ccnx/api/ccnx_Portal/ccnx_PortalAnchorRegistry.h>
+#include <ccnx/api/ccnx_Portal/ccnx_PortalTrace.h>
+#include <ccnx/api/ccnx_Portal/ccnx_PortalStatistics.h>
+#include <ccnx/api/ccnx_Portal/ccnx_PortalRetransmitter.h>
 
 #include <parc/algol/parc_Object.h>
 #include <parc/algol/parc_DisplayIndented.h>
@@ -80,16 +85,29 @@ struct ccnx_portal {
     CCNxPortalStatus status;
 
     const CCNxPortalStack *stack;
+
+    CCNxPortalStatistics *statistics;
+
+    CCNxPortalAnchorRegistry *anchors;
+
+    CCNxPortalPayloadRegistry *payloads;
+
+    // NULL unless retransmission is enabled.
+    CCNxPortalRetransmitter *retransmitter;
 };
 
+// The number of expired Interests collected from the retransmitter at a time.
+#define _ccnxPortal_RetransmitBatch 16
+
 static CCNxMetaMessage *
-_ccnxPortal_ComposeAnchorMessage(const CCNxName *routerName, const CCNxName *name, int secondsToLive)
+_ccnxPortal_ComposeAnchorMessage(const CCNxName *routerName, const CCNxPortalAnchor *namePrefix)
 {
-    time_t expireTime = time(0) + secondsToLive;
-    CCNxPortalAnchor *namePrefix = ccnxPortalAnchor_Create(name, expireTime);
-
     PARCBufferComposer *composer = parcBufferComposer_Create();
-    ccnxPortalAnchor_Serialize(namePrefix, composer);
+    if (ccnxPortalAnchor_Serialize(namePrefix, composer) == NULL) {
+        parcBufferComposer_Release(&composer);
+        errno = ENAMETOOLONG;
+        return NULL;
+    }
     PARCBuffer *payload = parcBufferComposer_ProduceBuffer(composer);
 
     CCNxInterest *interest = ccnxInterest_CreateSimple(routerName);
@@ -100,20 +118,29 @@ _ccnxPortal_ComposeAnchorMessage(const CCNxName *routerName, const CCNxName *nam
     parcBuffer_Release(&payload);
     ccnxInterest_Release(&interest);
     parcBufferComposer_Release(&composer);
-    ccnxPortalAnchor_Release(&namePrefix);
 
     return message;
 }
 
-static int
+/*
+ * Announce and record the anchor for a name the Portal listens to.
+ * Returns false, with errno set, if the anchor cannot be encoded.
+ */
+static bool
 _ccnxPortal_SetAnchor(CCNxPortal *portal, const CCNxName *name, time_t secondsToLive)
 {
-    int64_t timeOutMicroSeconds = parcProperties_GetAsInteger(ccnxPortalStack_GetProperties(portal->stack), CCNxPortalFactory_LocalRouterTimeout, 1000000);
+    const CCNxPortalConfiguration *configuration = ccnxPortalStack_GetConfiguration(portal->stack);
+    uint64_t timeOutMicroSeconds = ccnxPortalConfiguration_GetLocalRouterTimeout(configuration);
+    const CCNxName *fullName = ccnxPortalConfiguration_GetAnchorName(configuration);
 
-    CCNxName *routerName = ccnxName_CreateFromCString(ccnxPortalStack_GetProperty(portal->stack, CCNxPortalFactory_LocalRouterName, "lci:/local/dcr"));
-    CCNxName *fullName = ccnxName_ComposeNAME(routerName, "anchor");
+    time_t now = time(0);
+    CCNxPortalAnchor *anchor = ccnxPortalAnchor_Create(name, now + secondsToLive);
 
-    CCNxMetaMessage *message = _ccnxPortal_ComposeAnchorMessage(fullName, name, secondsToLive);
+    CCNxMetaMessage *message = _ccnxPortal_ComposeAnchorMessage(fullName, anchor);
+    if (message == NULL) {
+        ccnxPortalAnchor_Release(&anchor);
+        return false;
+    }
 
     ccnxPortal_Send(portal, message, CCNxStackTimeout_MicroSeconds(timeOutMicroSeconds));
     ccnxMetaMessage_Release(&message);
@@ -123,15 +150,19 @@ _ccnxPortal_SetAnchor(CCNxPortal *portal, const CCNxName *name, time_t secondsTo
         ccnxMetaMessage_Release(&response);
     }
 
-    ccnxName_Release(&fullName);
-    ccnxName_Release(&routerName);
+    ccnxPortalAnchorRegistry_RemoveExpired(portal->anchors, now);
+    ccnxPortalAnchorRegistry_Put(portal->anchors, anchor);
 
-    return 0;
+    ccnxPortalAnchor_Release(&anchor);
+
+    return true;
 }
 
 bool
 ccnxPortal_Flush(CCNxPortal *portal, const CCNxStackTimeout *timeout)
 {
+    uint64_t startTime = ccnxPortalStatistics_Now();
+
     CCNxControl *control = ccnxControl_CreateFlushRequest();
 
     // this needs to be better wrapped in ccnxControl
@@ -168,6 +199,10 @@ ccnxPortal_Flush(CCNxPortal *portal, const CCNxStackTimeout *timeout)
         }
     }
 
+    if (result == true) {
+        ccnxPortalStatistics_RecordLatency(portal->statistics, CCNxPortalStatisticsHistogram_Flush, startTime);
+    }
+
     return result;
 }
 
@@ -176,10 +211,19 @@ _ccnxPortal_Destroy(CCNxPortal **portalPtr)
 {
     CCNxPortal *portal = *portalPtr;
 
+    // Waiting for the flush must not re-express Interests.
+    ccnxPortal_DisableRetransmission(portal);
+
     ccnxPortal_Flush(portal, CCNxStackTimeout_Never);
 
     ccnxPortalStack_Stop(portal->stack);
     ccnxPortalStack_Release((CCNxPortalStack **) &portal->stack);
+
+    ccnxPortalStatistics_Release(&portal->statistics);
+    ccnxPortalAnchorRegistry_Release(&portal->anchors);
+
+    // The stack is gone, so it no longer refers to any payload.
+    ccnxPortalPayloadRegistry_Release(&portal->payloads);
 }
 
 parcObject_ExtendPARCObject(CCNxPortal, _ccnxPortal_Destroy, NULL, NULL, NULL, NULL, NULL, NULL);
@@ -188,6 +232,24 @@ parcObject_ImplementAcquire(ccnxPortal, CCNxPortal);
 
 parcObject_ImplementRelease(ccnxPortal, CCNxPortal);
 
+/*
+ * If the factory names a record file, add an interceptor that records all traffic to that file.
+ */
+static void
+_ccnxPortal_AddRecorder(CCNxPortal *portal)
+{
+    const char *recordFile = ccnxPortalStack_GetProperty(portal->stack, CCNxPortalTrace_RecordFile, NULL);
+    if (recordFile != NULL) {
+        CCNxPortalTrace *trace = ccnxPortalTrace_CreateWriter(recordFile);
+        if (trace != NULL) {
+            CCNxPortalInterceptor *recorder = ccnxPortalTrace_CreateInterceptor(trace);
+            ccnxPortal_AddInterceptor(portal, recorder);
+            ccnxPortalInterceptor_Release(&recorder);
+            ccnxPortalTrace_Release(&trace);
+        }
+    }
+}
+
 CCNxPortal *
 ccnxPortal_Create(const CCNxPortalAttributes *attributes, const CCNxPortalStack *portalStack)
 {
@@ -197,6 +259,11 @@ ccnxPortal_Create(const CCNxPortalAttributes *attributes, const CCNxPortalStack
         result->stack = portalStack;
         result->status.eof = false;
         result->status.error = 0;
+        result->statistics = ccnxPortalStatistics_Create();
+        result->anchors = ccnxPortalAnchorRegistry_Create();
+        result->payloads = ccnxPortalPayloadRegistry_Create();
+        result->retransmitter = NULL;
+        _ccnxPortal_AddRecorder(result);
     }
 
     if (ccnxPortalStack_Start(portalStack) == false) {
@@ -212,12 +279,66 @@ ccnxPortal_GetStatus(const CCNxPortal *portal)
     return &portal->status;
 }
 
+const CCNxPortalStatistics *
+ccnxPortal_GetStatistics(const CCNxPortal *portal)
+{
+    return portal->statistics;
+}
+
+const CCNxPortalAnchorRegistry *
+ccnxPortal_GetAnchors(const CCNxPortal *portal)
+{
+    return portal->anchors;
+}
+
+bool
+ccnxPortal_EnableRetransmission(CCNxPortal *portal, unsigned int maxRetransmissions)
+{
+    CCNxPortalRttEstimator *estimator = ccnxPortalRttEstimator_Create(0);
+    if (estimator == NULL) {
+        portal->status.error = ENOMEM;
+        return false;
+    }
+
+    size_t capacity = ccnxPortalAttributes_GetMaxBatchSize(ccnxPortal_GetAttributes(portal));
+    CCNxPortalRetransmitter *retransmitter = ccnxPortalRetransmitter_Create(estimator, maxRetransmissions, (capacity > 1024) ? capacity : 1024);
+    ccnxPortalRttEstimator_Release(&estimator);
+    if (retransmitter == NULL) {
+        portal->status.error = ENOMEM;
+        return false;
+    }
+
+    ccnxPortal_DisableRetransmission(portal);
+    portal->retransmitter = retransmitter;
+    return true;
+}
+
+void
+ccnxPortal_DisableRetransmission(CCNxPortal *portal)
+{
+    if (portal->retransmitter != NULL) {
+        ccnxPortalRetransmitter_Release(&portal->retransmitter);
+    }
+}
+
+const CCNxPortalRetransmitter *
+ccnxPortal_GetRetransmitter(const CCNxPortal *portal)
+{
+    return portal->retransmitter;
+}
+
 bool
 ccnxPortal_SetAttributes(CCNxPortal *portal, const CCNxPortalAttributes *attributes)
 {
     return ccnxPortalStack_SetAttributes(portal->stack, attributes);
 }
 
+const CCNxPortalAttributes *
+ccnxPortal_GetAttributes(const CCNxPortal *portal)
+{
+    return ccnxPortalStack_GetAttributes(portal->stack);
+}
+
 int
 ccnxPortal_GetFileId(const CCNxPortal *portal)
 {
@@ -227,13 +348,23 @@ ccnxPortal_GetFileId(const CCNxPortal *portal)
 bool
 ccnxPortal_Listen(CCNxPortal *restrict portal, const CCNxName *restrict name, const time_t secondsToLive, const CCNxStackTimeout *microSeconds)
 {
+    uint64_t startTime = ccnxPortalStatistics_Now();
+
     bool result = ccnxPortalStack_Listen(portal->stack, name, microSeconds);
+    int error = (result == true) ? 0 : ccnxPortalStack_GetErrorCode(portal->stack);
 
     if (result == true) {
-        _ccnxPortal_SetAnchor(portal, name, secondsToLive);
+        if (_ccnxPortal_SetAnchor(portal, name, secondsToLive)) {
+            ccnxPortalStatistics_RecordLatency(portal->statistics, CCNxPortalStatisticsHistogram_Listen, startTime);
+        } else {
+            // Without an anchor the name cannot be served, so withdraw the route the stack just added.
+            error = errno;
+            ccnxPortalStack_Ignore(portal->stack, name, microSeconds);
+            result = false;
+        }
     }
 
-    portal->status.error = (result == true) ? 0 : ccnxPortalStack_GetErrorCode(portal->stack);
+    portal->status.error = error;
 
     return result;
 }
@@ -243,24 +374,201 @@ ccnxPortal_Ignore(CCNxPortal *portal, const CCNxName *name, const CCNxStackTimeo
 {
     bool result = ccnxPortalStack_Ignore(portal->stack, name, microSeconds);
 
+    if (result == true) {
+        ccnxPortalAnchorRegistry_Remove(portal->anchors, name);
+    }
+
     portal->status.error = (result == true) ? 0 : ccnxPortalStack_GetErrorCode(portal->stack);
 
     return result;
 }
 
+bool
+ccnxPortal_AddInterceptor(CCNxPortal *portal, CCNxPortalInterceptor *interceptor)
+{
+    return ccnxPortalStack_AddInterceptor((CCNxPortalStack *) portal->stack, interceptor);
+}
+
 bool
 ccnxPortal_Send(CCNxPortal *restrict portal, const CCNxMetaMessage *restrict message, const CCNxStackTimeout *timeout)
 {
+    uint64_t startTime = ccnxPortalStatistics_Now();
+
     bool result = ccnxPortalStack_Send(portal->stack, message, timeout);
 
     portal->status.error = result ? 0 : ccnxPortalStack_GetErrorCode(portal->stack);
+
+    ccnxPortalStatistics_RecordSend(portal->statistics, message, result, portal->status.error, startTime);
+
+    if (result && portal->retransmitter != NULL && ccnxMetaMessage_IsInterest(message)) {
+        ccnxPortalRetransmitter_Track(portal->retransmitter, message, ccnxPortalStatistics_Now() / 1000);
+    }
     return result;
 }
 
-CCNxMetaMessage *
-ccnxPortal_Receive(CCNxPortal *portal, const CCNxStackTimeout *timeout)
+bool
+ccnxPortal_SendInterestTemplate(CCNxPortal *portal, const CCNxPortalInterestTemplate *template, uint64_t number,
+                                const CCNxStackTimeout *timeout)
+{
+    CCNxMetaMessage *message = ccnxPortalInterestTemplate_CreateMessageWithNumber(template, number);
+    if (message == NULL) {
+        portal->status.error = errno;
+        return false;
+    }
+
+    bool result = ccnxPortal_Send(portal, message, timeout);
+    ccnxMetaMessage_Release(&message);
+
+    return result;
+}
+
+PARCBuffer *
+ccnxPortal_WrapPayload(CCNxPortal *portal, void *memory, size_t length, CCNxPortalPayloadRelease *release, void *context)
 {
-    CCNxMetaMessage *result = ccnxPortalStack_Receive(portal->stack, timeout);
+    ccnxPortalPayloadRegistry_Reclaim(portal->payloads);
+
+    return ccnxPortalPayloadRegistry_Wrap(portal->payloads, memory, length, release, context);
+}
+
+bool
+ccnxPortal_SendPayload(CCNxPortal *portal, const CCNxName *name, void *memory, size_t length,
+                       CCNxPortalPayloadRelease *release, void *context, const CCNxStackTimeout *timeout)
+{
+    PARCBuffer *payload = ccnxPortal_WrapPayload(portal, memory, length, release, context);
+    if (payload == NULL) {
+        portal->status.error = ENOMEM;
+        return false;
+    }
+
+    CCNxContentObject *contentObject = ccnxContentObject_CreateWithNameAndPayload(name, payload);
+    CCNxMetaMessage *message = ccnxMetaMessage_CreateFromContentObject(contentObject);
+
+    bool result = ccnxPortal_Send(portal, message, timeout);
+
+    ccnxMetaMessage_Release(&message);
+    ccnxContentObject_Release(&contentObject);
+    parcBuffer_Release(&payload);
+
+    return result;
+}
+
+size_t
+ccnxPortal_ReclaimPayloads(CCNxPortal *portal)
+{
+    return ccnxPortalPayloadRegistry_Reclaim(portal->payloads);
+}
+
+bool
+ccnxPortal_SendPayloadVector(CCNxPortal *portal, const CCNxName *name, const CCNxPortalPayloadVector *payload,
+                             const CCNxStackTimeout *timeout)
+{
+    CCNxMetaMessage *message = ccnxPortalPayloadVector_CreateMessage(payload, name);
+    if (message == NULL) {
+        portal->status.error = errno;
+        return false;
+    }
+
+    bool result = ccnxPortal_Send(portal, message, timeout);
+    ccnxMetaMessage_Release(&message);
+
+    return result;
+}
+
+/*
+ * Send the Interests whose retransmission timeouts have passed.
+ * They were tracked when first sent, so they go straight to the stack rather than through ccnxPortal_Send.
+ */
+static void
+_ccnxPortal_Retransmit(CCNxPortal *portal, uint64_t now)
+{
+    CCNxMetaMessage *messages[_ccnxPortal_RetransmitBatch];
+
+    size_t count;
+    do {
+        count = ccnxPortalRetransmitter_Expire(portal->retransmitter, now, messages, _ccnxPortal_RetransmitBatch);
+        for (size_t i = 0; i < count; i++) {
+            uint64_t startTime = ccnxPortalStatistics_Now();
+            bool result = ccnxPortalStack_Send(portal->stack, messages[i], CCNxStackTimeout_Never);
+            int error = result ? 0 : ccnxPortalStack_GetErrorCode(portal->stack);
+            ccnxPortalStatistics_RecordSend(portal->statistics, messages[i], result, error, startTime);
+            ccnxMetaMessage_Release(&messages[i]);
+        }
+    } while (count == _ccnxPortal_RetransmitBatch);
+}
+
+static void
+_ccnxPortal_MatchRetransmission(CCNxPortal *portal, const CCNxMetaMessage *message, uint64_t now)
+{
+    if (ccnxMetaMessage_IsContentObject(message)) {
+        const CCNxName *name = ccnxContentObject_GetName(ccnxMetaMessage_GetContentObject(message));
+        if (name != NULL) {
+            ccnxPortalRetransmitter_Match(portal->retransmitter, name, now);
+        }
+    } else if (ccnxMetaMessage_IsInterestReturn(message)) {
+        const CCNxName *name = ccnxInterest_GetName(ccnxMetaMessage_GetInterestReturn(message));
+        ccnxPortalRetransmitter_Cancel(portal->retransmitter, name);
+    }
+}
+
+/*
+ * Receive from the stack in slices that end at the next retransmission deadline, retransmitting in between,
+ * until a message arrives or the caller's timeout passes. Times are in microseconds.
+ *
+ * Only the stack's reads allocate from @p arena, if not NULL, so retransmitting and updating the estimates do not.
+ */
+static CCNxMetaMessage *
+_ccnxPortal_ReceiveRetransmitting(CCNxPortal *portal, const CCNxStackTimeout *timeout, CCNxPortalArena *arena)
+{
+    uint64_t now = ccnxPortalStatistics_Now() / 1000;
+    uint64_t end = (timeout == CCNxStackTimeout_Never) ? UINT64_MAX : now + *timeout;
+
+    while (true) {
+        _ccnxPortal_Retransmit(portal, now);
+
+        uint64_t wake = ccnxPortalRetransmitter_GetNextDeadline(portal->retransmitter);
+        if (end < wake) {
+            wake = end;
+        }
+
+        CCNxMetaMessage *result;
+        if (wake == UINT64_MAX) {
+            result = ccnxPortalStack_ReceiveIntoArena(portal->stack, CCNxStackTimeout_Never, arena);
+        } else {
+            result = ccnxPortalStack_ReceiveIntoArena(portal->stack, CCNxStackTimeout_MicroSeconds((wake > now) ? wake - now : 0), arena);
+        }
+
+        now = ccnxPortalStatistics_Now() / 1000;
+        if (result != NULL) {
+            _ccnxPortal_MatchRetransmission(portal, result, now);
+            return result;
+        }
+
+        if (now >= end || ccnxPortalStack_IsTimeoutError(ccnxPortalStack_GetErrorCode(portal->stack)) == false) {
+            return NULL;
+        }
+    }
+}
+
+/*
+ * Receive a message, allocating it from @p arena if not NULL.
+ * The arena is active only while the stack reads the message, so reclaiming payloads, the interceptors,
+ * retransmission and the statistics, all of which keep what they allocate, never allocate from it.
+ */
+static CCNxMetaMessage *
+_ccnxPortal_Receive(CCNxPortal *portal, const CCNxStackTimeout *timeout, CCNxPortalArena *arena)
+{
+    uint64_t startTime = ccnxPortalStatistics_Now();
+
+    if (ccnxPortalPayloadRegistry_GetCount(portal->payloads) > 0) {
+        ccnxPortalPayloadRegistry_Reclaim(portal->payloads);
+    }
+
+    CCNxMetaMessage *result;
+    if (portal->retransmitter != NULL) {
+        result = _ccnxPortal_ReceiveRetransmitting(portal, timeout, arena);
+    } else {
+        result = ccnxPortalStack_ReceiveIntoArena(portal->stack, timeout, arena);
+    }
 
     // This modal operation of Portal is awkward.
     // Messages are interest = content-object, while Chunked is interest = {content-object_1, content-object_2, ...}
@@ -270,9 +578,41 @@ ccnxPortal_Receive(CCNxPortal *portal, const CCNxStackTimeout *timeout)
     //          Set EOF
 
     portal->status.error = (result != NULL) ? 0 : ccnxPortalStack_GetErrorCode(portal->stack);
+
+    ccnxPortalStatistics_RecordReceive(portal->statistics, result, portal->status.error, startTime);
     return result;
 }
 
+CCNxMetaMessage *
+ccnxPortal_Receive(CCNxPortal *portal, const CCNxStackTimeout *timeout)
+{
+    return _ccnxPortal_Receive(portal, timeout, NULL);
+}
+
+size_t
+ccnxPortal_ReceiveBatch(CCNxPortal *portal, CCNxMetaMessage **messages, size_t capacity, CCNxPortalArena *arena, const CCNxStackTimeout *timeout)
+{
+    size_t limit = ccnxPortalAttributes_GetMaxBatchSize(ccnxPortal_GetAttributes(portal));
+    if (capacity < limit) {
+        limit = capacity;
+    }
+
+    size_t count = 0;
+    while (count < limit) {
+        CCNxMetaMessage *message = _ccnxPortal_Receive(portal, (count == 0) ? timeout : CCNxStackTimeout_Immediate, arena);
+        if (message == NULL) {
+            break;
+        }
+        messages[count++] = message;
+    }
+
+    // Running out of immediately available messages ends a batch, it is not an error.
+    if (count > 0) {
+        portal->status.error = 0;
+    }
+    return count;
+}
+
 const PARCKeyId *
 ccnxPortal_GetKeyId(const CCNxPortal *portal)
 {
@@ -296,3 +636,9 @@ ccnxPortal_GetError(const CCNxPortal *portal)
 {
     return portal->status.error;
 }
+
+bool
+ccnxPortal_IsTimeout(const CCNxPortal *portal)
+{
+    return ccnxPortalStack_IsTimeoutError(portal->status.error);
+}
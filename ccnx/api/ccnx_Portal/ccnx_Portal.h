@@ -113,6 +113,14 @@ typedef struct ccnx_portal CCNxPortal;
 #include <ccnx/api/ccnx_Portal/ccnx_PortalAttributes.h>
 #include <ccnx/api/ccnx_Portal/ccnx_PortalFactory.h>
 #include <ccnx/api/ccnx_Portal/ccnx_PortalStack.h>
+#include <ccnx/api/ccnx_Portal/ccnx_PortalInterceptor.h>
+#include <ccnx/api/ccnx_Portal/ccnx_PortalStatistics.h>
+#include <ccnx/api/ccnx_Portal/ccnx_PortalAnchorRegistry.h>
+#include <ccnx/api/ccnx_Portal/ccnx_PortalArena.h>
+#include <ccnx/api/ccnx_Portal/ccnx_PortalInterestTemplate.h>
+#include <ccnx/api/ccnx_Portal/ccnx_PortalPayloadRegistry.h>
+#include <ccnx/api/ccnx_Portal/ccnx_PortalPayloadVector.h>
+#include <ccnx/api/ccnx_Portal/ccnx_PortalRetransmitter.h>
 
 #include <ccnx/common/ccnx_Interest.h>
 #include <ccnx/common/ccnx_ContentObject.h>
@@ -206,6 +214,111 @@ void ccnxPortal_Release(CCNxPortal **portalPtr);
  */
 const CCNxPortalStatus *ccnxPortal_GetStatus(const CCNxPortal *portal);
 
+/**
+ * Return a pointer to the given `CCNxPortal`'s {@link CCNxPortalStatistics} instance.
+ *
+ * The statistics count the messages sent and received through the portal and record the latency of
+ * each Send, Receive, Listen and Flush, and the round-trip time of each Interest.
+ * They may be read at any time, from any thread, without locking.
+ *
+ * @param [in] portal A pointer to a `CCNxPortal` instance.
+ *
+ * @return A non-null pointer to a `CCNxPortalStatistics` instance, valid for the lifetime of @p portal.
+ *
+ * Example:
+ * @code
+ * {
+ *     CCNxPortal *portal = ccnxPortalFactory_CreatePortal(factory, ccnxPortalRTA_LoopBack);
+ *
+ *     const CCNxPortalStatistics *statistics = ccnxPortal_GetStatistics(portal);
+ *     uint64_t interests = ccnxPortalStatistics_GetCounter(statistics, CCNxPortalStatisticsCounter_InterestsSent);
+ *
+ *     ccnxPortal_Release(&portal);
+ * }
+ * @endcode
+ */
+const CCNxPortalStatistics *ccnxPortal_GetStatistics(const CCNxPortal *portal);
+
+/**
+ * Get the anchors the given `CCNxPortal` has set with `ccnxPortal_Listen`.
+ *
+ * An anchor is added or renewed by each successful `ccnxPortal_Listen` and removed by `ccnxPortal_Ignore`.
+ * Expired anchors are swept away whenever a new anchor is set.
+ *
+ * @param [in] portal A pointer to a `CCNxPortal` instance.
+ *
+ * @return A non-null pointer to a `CCNxPortalAnchorRegistry` instance, valid for the lifetime of @p portal.
+ *
+ * Example:
+ * @code
+ * {
+ *     ccnxPortal_Listen(portal, name, 60, CCNxStackTimeout_Never);
+ *
+ *     const CCNxPortalAnchorRegistry *anchors = ccnxPortal_GetAnchors(portal);
+ *     CCNxPortalAnchor *anchor = ccnxPortalAnchorRegistry_LongestPrefixMatch(anchors, interestName);
+ * }
+ * @endcode
+ */
+const CCNxPortalAnchorRegistry *ccnxPortal_GetAnchors(const CCNxPortal *portal);
+
+/**
+ * Re-express the Interests sent through the given `CCNxPortal` that go unanswered within their retransmission timeout.
+ *
+ * Each Interest sent is tracked until a Content Object or Interest Return with its name is received.
+ * While the portal waits in `ccnxPortal_Receive`, an Interest whose timeout passes is sent again,
+ * up to @p maxRetransmissions times, after which it is given up as lost and the application's own timeout applies.
+ * Timeouts are estimated per name prefix from measured round-trip times, as TCP does,
+ * and are doubled for each retransmission. See {@link CCNxPortalRetransmitter} and {@link CCNxPortalRttEstimator}.
+ *
+ * Enabling retransmission again discards the Interests being tracked and the estimates.
+ *
+ * @param [in] portal A pointer to a `CCNxPortal` instance.
+ * @param [in] maxRetransmissions The number of times an Interest is retransmitted before it is given up.
+ *
+ * @return true Retransmission is enabled.
+ * @return false Memory could not be allocated, and the portal error is set to ENOMEM.
+ *
+ * Example:
+ * @code
+ * {
+ *     ccnxPortal_EnableRetransmission(portal, 3);
+ *
+ *     ccnxPortal_Send(portal, interest, CCNxStackTimeout_Never);
+ *     CCNxMetaMessage *response = ccnxPortal_Receive(portal, CCNxStackTimeout_MicroSeconds(10000000));
+ * }
+ * @endcode
+ */
+bool ccnxPortal_EnableRetransmission(CCNxPortal *portal, unsigned int maxRetransmissions);
+
+/**
+ * Stop re-expressing the Interests sent through the given `CCNxPortal`, discarding the Interests being tracked.
+ *
+ * @param [in] portal A pointer to a `CCNxPortal` instance.
+ */
+void ccnxPortal_DisableRetransmission(CCNxPortal *portal);
+
+/**
+ * Get the retransmitter of the given `CCNxPortal`, to monitor its retransmissions and round-trip time estimates.
+ *
+ * @param [in] portal A pointer to a `CCNxPortal` instance.
+ *
+ * @return non-NULL The retransmitter, valid until retransmission is next enabled or disabled.
+ * @return NULL Retransmission is not enabled.
+ *
+ * Example:
+ * @code
+ * {
+ *     const CCNxPortalRetransmitter *retransmitter = ccnxPortal_GetRetransmitter(portal);
+ *     if (retransmitter != NULL) {
+ *         PARCJSON *json = ccnxPortalRttEstimator_ToJSON(ccnxPortalRetransmitter_GetRttEstimator(retransmitter));
+ *
+ *         parcJSON_Release(&json);
+ *     }
+ * }
+ * @endcode
+ */
+const CCNxPortalRetransmitter *ccnxPortal_GetRetransmitter(const CCNxPortal *portal);
+
 /**
  * Get the underlying file descriptor for the given `CCNxPortal`.
  *
@@ -236,10 +349,10 @@ int ccnxPortal_GetFileId(const CCNxPortal *portal);
 /**
  * Set the attributes for the specified `CCNxPortal` instance.
  *
- * A {@link CCNxPortalAttributes} instance encapsulates information about the logging and blocked
- * state of the `CCNxPortal` instance. These are immutable instances which are not
- * meant to be changed. Rather, they are intended to configure the attributes
- * of other `CCNxPortal` instances.
+ * A {@link CCNxPortalAttributes} instance encapsulates the blocking mode, queue limits, batch size,
+ * busy-poll interval and socket buffer sizes of the `CCNxPortal` instance.
+ * The attributes are applied immediately and the Portal keeps its own copy,
+ * so the caller may release or modify @p attributes afterwards.
  *
  * @param [in,out] portal A pointer to a `CCNxPortal` instance.
  * @param [in] attributes A pointer to a `CCNxPortalAttributes` instance that will be used.
@@ -249,6 +362,12 @@ int ccnxPortal_GetFileId(const CCNxPortal *portal);
  * Example:
  * @code
  * {
+ *     CCNxPortalAttributes *attributes = ccnxPortalAttributes_Copy(ccnxPortal_GetAttributes(portal));
+ *     ccnxPortalAttributes_SetSocketReceiveBufferSize(attributes, 1024 * 1024);
+ *
+ *     ccnxPortal_SetAttributes(portal, attributes);
+ *
+ *     ccnxPortalAttributes_Release(&attributes);
  * }
  * @endcode
  *
@@ -256,6 +375,25 @@ int ccnxPortal_GetFileId(const CCNxPortal *portal);
  */
 bool ccnxPortal_SetAttributes(CCNxPortal *portal, const CCNxPortalAttributes *attributes);
 
+/**
+ * Get the attributes in effect for the specified `CCNxPortal` instance.
+ *
+ * @param [in] portal A pointer to a `CCNxPortal` instance.
+ *
+ * @return A pointer to a `CCNxPortalAttributes` instance, valid until the attributes are next set.
+ *
+ * Example:
+ * @code
+ * {
+ *     const CCNxPortalAttributes *attributes = ccnxPortal_GetAttributes(portal);
+ *     bool blocking = ccnxPortalAttributes_IsBlocking(attributes);
+ * }
+ * @endcode
+ *
+ * @see {@link ccnxPortal_SetAttributes}
+ */
+const CCNxPortalAttributes *ccnxPortal_GetAttributes(const CCNxPortal *portal);
+
 /**
  * Listen for CCN Interests in the given {@link CCNxName}, i.e., with the given name prefix.
  *
@@ -272,6 +410,7 @@ bool ccnxPortal_SetAttributes(CCNxPortal *portal, const CCNxPortalAttributes *at
  *
  * @return `true` The operation succeeded.
  * @return `false` The operation failed. See {@link ccnxPortal_GetStatus}.
+ *         If @p name is too long to encode as an anchor the error is `ENAMETOOLONG` and the Portal does not listen to it.
  *
  * Example:
  * @code
@@ -325,6 +464,33 @@ bool ccnxPortal_Listen(CCNxPortal *restrict portal, const CCNxName *restrict nam
  */
 bool ccnxPortal_Ignore(CCNxPortal *portal, const CCNxName *name, const CCNxStackTimeout *timeout);
 
+/**
+ * Add a {@link CCNxPortalInterceptor} as the outermost layer of the protocol stack of the given `CCNxPortal`.
+ *
+ * Subsequent sends, receives, listens and ignores pass through @p interceptor before any previously added interceptor.
+ * Interceptors should be added before the Portal is shared between threads.
+ *
+ * @param [in,out] portal A pointer to a `CCNxPortal` instance.
+ * @param [in] interceptor A pointer to a valid `CCNxPortalInterceptor` not already added to a Portal.
+ *
+ * @return `true` The interceptor was added.
+ * @return `false` The interceptor already belongs to a Portal, or memory could not be allocated.
+ *
+ * Example:
+ * @code
+ * {
+ *     CCNxPortal *portal = ccnxPortalFactory_CreatePortal(factory, ccnxPortalRTA_Message);
+ *
+ *     CCNxPortalInterceptor *interceptor = ccnxPortalInterceptor_Create(_countingSend, NULL, NULL, NULL, &count, NULL);
+ *     ccnxPortal_AddInterceptor(portal, interceptor);
+ *     ccnxPortalInterceptor_Release(&interceptor);
+ * }
+ * @endcode
+ *
+ * @see {@link ccnxPortalStack_AddInterceptor}
+ */
+bool ccnxPortal_AddInterceptor(CCNxPortal *portal, CCNxPortalInterceptor *interceptor);
+
 /**
  * Send a {@link CCNxMetaMessage} to the protocol stack.
  *
@@ -369,6 +535,163 @@ bool ccnxPortal_Ignore(CCNxPortal *portal, const CCNxName *name, const CCNxStack
  */
 bool ccnxPortal_Send(CCNxPortal *restrict portal, const CCNxMetaMessage *restrict message, const CCNxStackTimeout *timeout);
 
+/**
+ * Send an Interest made from a template, with @p number as the value of its final name segment.
+ *
+ * The Interest is sent as the template's encoding with the final segment replaced,
+ * so neither a `CCNxInterest` nor its encoding is created for the send.
+ *
+ * @param [in,out] portal A pointer to a `CCNxPortal` instance.
+ * @param [in] template A pointer to a valid `CCNxPortalInterestTemplate` instance.
+ * @param [in] number The value of the final name segment, such as a chunk number.
+ * @param [in] timeout A pointer to a `CCNxStackTimeout` value, or `CCNxStackTimeout_Never`.
+ *
+ * @return `true` if the Interest was sent.
+ * @return `false` An error occurred (see `ccnxPortal_GetError`).
+ *
+ * Example:
+ * @code
+ * {
+ *     CCNxName *name = ccnxName_CreateFromCString("lci:/ccnx/example/Chunk=0");
+ *     CCNxInterest *interest = ccnxInterest_CreateSimple(name);
+ *     CCNxPortalInterestTemplate *template = ccnxPortalInterestTemplate_Create(interest);
+ *
+ *     for (uint64_t chunk = 0; chunk < chunks; chunk++) {
+ *         ccnxPortal_SendInterestTemplate(portal, template, chunk, CCNxStackTimeout_Never);
+ *     }
+ *
+ *     ccnxPortalInterestTemplate_Release(&template);
+ *     ccnxInterest_Release(&interest);
+ *     ccnxName_Release(&name);
+ * }
+ * @endcode
+ *
+ * @see {@link ccnxPortal_Send}
+ */
+bool ccnxPortal_SendInterestTemplate(CCNxPortal *portal, const CCNxPortalInterestTemplate *template, uint64_t number,
+                                     const CCNxStackTimeout *timeout);
+
+/**
+ * Wrap application memory in a `PARCBuffer` to be sent as a payload without copying it.
+ *
+ * The Portal calls @p release once neither the stack nor anything else refers to the buffer any longer.
+ * It checks for such payloads on each call to `ccnxPortal_Receive`, `ccnxPortal_SendPayload`
+ * and `ccnxPortal_ReclaimPayloads`, and when the Portal is released.
+ * The memory must not be modified or freed until then.
+ *
+ * @param [in,out] portal A pointer to a `CCNxPortal` instance.
+ * @param [in] memory A pointer to the payload.
+ * @param [in] length The length of the payload in bytes.
+ * @param [in] release The function called once the stack has finished with the memory, or NULL.
+ * @param [in] context A value passed to @p release.
+ *
+ * @return non-NULL A pointer to a `PARCBuffer` instance that must be released by the caller.
+ * @return NULL Memory could not be allocated. @p release is not called.
+ *
+ * Example:
+ * @code
+ * {
+ *     PARCBuffer *payload = ccnxPortal_WrapPayload(portal, data, length, free_data, NULL);
+ *     CCNxContentObject *contentObject = ccnxContentObject_CreateWithNameAndPayload(name, payload);
+ *     ccnxContentObject_SetFinalChunkNumber(contentObject, chunk);
+ *     parcBuffer_Release(&payload);
+ *
+ *     CCNxMetaMessage *message = ccnxMetaMessage_CreateFromContentObject(contentObject);
+ *     ccnxPortal_Send(portal, message, CCNxStackTimeout_Never);
+ *
+ *     ccnxMetaMessage_Release(&message);
+ *     ccnxContentObject_Release(&contentObject);
+ * }
+ * @endcode
+ *
+ * @see {@link ccnxPortal_SendPayload}
+ */
+PARCBuffer *ccnxPortal_WrapPayload(CCNxPortal *portal, void *memory, size_t length, CCNxPortalPayloadRelease *release, void *context);
+
+/**
+ * Send a Content Object named @p name whose payload is application memory, without copying it.
+ *
+ * @p release is called exactly once, when the stack has finished with the memory, as for `ccnxPortal_WrapPayload`.
+ * That is the case whether or not the send succeeds.
+ *
+ * @param [in,out] portal A pointer to a `CCNxPortal` instance.
+ * @param [in] name A pointer to a valid `CCNxName` instance.
+ * @param [in] memory A pointer to the payload.
+ * @param [in] length The length of the payload in bytes.
+ * @param [in] release The function called once the stack has finished with the memory, or NULL.
+ * @param [in] context A value passed to @p release.
+ * @param [in] timeout A pointer to a `CCNxStackTimeout` value, or `CCNxStackTimeout_Never`.
+ *
+ * @return `true` if the Content Object was sent.
+ * @return `false` An error occurred (see `ccnxPortal_GetError`).
+ *
+ * Example:
+ * @code
+ * {
+ *     void *data = mmap(NULL, length, PROT_READ, MAP_PRIVATE, fd, 0);
+ *
+ *     ccnxPortal_SendPayload(portal, name, data, length, unmap_data, NULL, CCNxStackTimeout_Never);
+ * }
+ * @endcode
+ *
+ * @see {@link ccnxPortal_WrapPayload}
+ */
+bool ccnxPortal_SendPayload(CCNxPortal *portal, const CCNxName *name, void *memory, size_t length,
+                            CCNxPortalPayloadRelease *release, void *context, const CCNxStackTimeout *timeout);
+
+/**
+ * Call the release function of every payload wrapped by the Portal that the stack has finished with.
+ *
+ * @param [in,out] portal A pointer to a `CCNxPortal` instance.
+ *
+ * @return The number of wrapped payloads the stack, or anything else, still refers to.
+ *
+ * Example:
+ * @code
+ * {
+ *     while (ccnxPortal_ReclaimPayloads(portal) > 0) {
+ *         CCNxMetaMessage *message = ccnxPortal_Receive(portal, CCNxStackTimeout_MicroSeconds(1000));
+ *         ...
+ *     }
+ * }
+ * @endcode
+ */
+size_t ccnxPortal_ReclaimPayloads(CCNxPortal *portal);
+
+/**
+ * Send a Content Object named @p name whose payload is the concatenation of the slices of @p payload.
+ *
+ * The slices are gathered once, directly into the encoded Content Object,
+ * instead of being flattened into one payload buffer that the stack then copies again as it encodes the message.
+ * The Content Object is not signed.
+ *
+ * @param [in,out] portal A pointer to a `CCNxPortal` instance.
+ * @param [in] name A pointer to a valid `CCNxName` instance.
+ * @param [in] payload A pointer to a valid `CCNxPortalPayloadVector` instance.
+ * @param [in] timeout A pointer to a `CCNxStackTimeout` value, or `CCNxStackTimeout_Never`.
+ *
+ * @return `true` if the Content Object was sent.
+ * @return `false` An error occurred (see `ccnxPortal_GetError`), EINVAL if the Content Object would exceed the largest CCNx packet.
+ *
+ * Example:
+ * @code
+ * {
+ *     CCNxPortalPayloadVector *payload = ccnxPortalPayloadVector_Create();
+ *     ccnxPortalPayloadVector_Append(payload, header);
+ *     ccnxPortalPayloadVector_Append(payload, region);
+ *     ccnxPortalPayloadVector_Append(payload, trailer);
+ *
+ *     ccnxPortal_SendPayloadVector(portal, name, payload, CCNxStackTimeout_Never);
+ *
+ *     ccnxPortalPayloadVector_Release(&payload);
+ * }
+ * @endcode
+ *
+ * @see {@link ccnxPortalPayloadVector_CreateMessage}
+ */
+bool ccnxPortal_SendPayloadVector(CCNxPortal *portal, const CCNxName *name, const CCNxPortalPayloadVector *payload,
+                                  const CCNxStackTimeout *timeout);
+
 /**
  * Read data from the protocol stack and construct a {@link CCNxMetaMessage}.
  *
@@ -423,6 +746,57 @@ bool ccnxPortal_Send(CCNxPortal *restrict portal, const CCNxMetaMessage *restric
  */
 CCNxMetaMessage *ccnxPortal_Receive(CCNxPortal *portal, const CCNxStackTimeout *timeout);
 
+/**
+ * Read a batch of messages from the protocol stack, optionally allocating them from an arena.
+ *
+ * The first message is awaited for the time specified by @p timeout.
+ * Further messages are read only while they are immediately available,
+ * up to @p capacity or the maximum batch size in the portal's attributes, whichever is smaller.
+ *
+ * If @p arena is not NULL, it is active on the calling thread while the Stack reads each message,
+ * so memory the Stack allocates on this thread to construct the messages comes from the arena.
+ * Nothing else the receive does, such as running interceptors or reclaiming payloads, allocates from it.
+ * The caller releases each message as usual and then resets the arena once the whole batch is processed.
+ * Stacks that construct messages on their own thread are unaffected by the arena.
+ * Interceptors that retain the messages they receive must not be used with an arena.
+ * The arena memory interface must have been installed with `ccnxPortalArena_Install`.
+ *
+ * If 0 is returned, the caller may test the value of `errno` to discriminate the conditions.
+ *
+ * @param [in,out] portal A pointer to a `CCNxPortal` instance.
+ * @param [out] messages An array of at least @p capacity elements that receives the messages.
+ * @param [in] capacity The number of elements in @p messages.
+ * @param [in] arena A pointer to a `CCNxPortalArena` instance, or NULL.
+ * @param [in] timeout A pointer to a `CCNxStackTimeout` value, or `CCNxStackTimeout_Never`.
+ *
+ * @return The number of messages stored in @p messages, each of which must be released via {@link ccnxMetaMessage_Release}.
+ * @return 0 An error occurred while reading from the protocol stack (see `ccnxPortal_GetError`).
+ *
+ * Example:
+ * @code
+ * {
+ *     ccnxPortalArena_Install();
+ *     CCNxPortalArena *arena = ccnxPortalArena_Create();
+ *     CCNxMetaMessage *messages[64];
+ *
+ *     size_t count;
+ *     while ((count = ccnxPortal_ReceiveBatch(portal, messages, 64, arena, CCNxStackTimeout_Never)) > 0) {
+ *         for (size_t i = 0; i < count; i++) {
+ *             ...
+ *             ccnxMetaMessage_Release(&messages[i]);
+ *         }
+ *         ccnxPortalArena_Reset(arena);
+ *     }
+ *
+ *     ccnxPortalArena_Release(&arena);
+ * }
+ * @endcode
+ *
+ * @see {@link ccnxPortal_Receive}
+ * @see `ccnxPortalAttributes_SetMaxBatchSize`
+ */
+size_t ccnxPortal_ReceiveBatch(CCNxPortal *portal, CCNxMetaMessage **messages, size_t capacity, CCNxPortalArena *arena, const CCNxStackTimeout *timeout);
+
 /**
  * Get the {@link PARCKeyId} of the identity bound to the given `CCNxPortal` instance.
  *
@@ -550,6 +924,32 @@ bool ccnxPortal_IsError(const CCNxPortal *portal);
  */
 int ccnxPortal_GetError(const CCNxPortal *portal);
 
+/**
+ * Determine if the most recent operation on the given `CCNxPortal` timed out, rather than failed.
+ *
+ * A `ccnxPortal_Receive` with a finite timeout that returns NULL because no message arrived sets an error,
+ * whose value depends on the stack: ENOMSG for the RTA stack, EWOULDBLOCK or ETIMEDOUT for others.
+ * Applications that poll should use this rather than test for particular values.
+ *
+ * @param [in] portal A pointer to a `CCNxPortal` instance.
+ *
+ * @return true The most recent operation timed out.
+ * @return false The most recent operation succeeded or failed.
+ *
+ * Example:
+ * @code
+ * {
+ *     CCNxMetaMessage *message = ccnxPortal_Receive(portal, CCNxStackTimeout_MicroSeconds(100000));
+ *     if (message == NULL && !ccnxPortal_IsTimeout(portal)) {
+ *         printf("ccnxPortal_Receive failed: %d\n", ccnxPortal_GetError(portal));
+ *     }
+ * }
+ * @endcode
+ *
+ * @see {@link ccnxPortal_GetError}
+ */
+bool ccnxPortal_IsTimeout(const CCNxPortal *portal);
+
 /**
  * Flush the input and output paths and pause the protocol stack.
  *
@@ -60,13 +60,23 @@
 
 #include <LongBow/runtime.h>
 
+#include <errno.h>
+
 #include <ccnx/api/ccnx_Portal/ccnx_PortalAPI.h>
 
 #include <parc/algol/parc_Object.h>
-#include <parc/algol/parc_Deque.h>
+#include <parc/algol/parc_Memory.h>
+
+// The initial capacity of the loopback queue. It doubles whenever it fills.
+#define _ccnxPortalAPI_InitialQueueCapacity 16
 
 typedef struct {
-    PARCDeque *messageAddressBuffer;
+    // A ring of queued message addresses. It only ever grows, so that a steady-state send does not allocate.
+    CCNxMetaMessage **queue;
+    size_t queueCapacity;
+    size_t queueHead;
+    size_t queueCount;
+    CCNxPortalAttributes *attributes;
 } _CCNxPortalAPIContext;
 
 static void
@@ -74,7 +84,11 @@ _ccnxPortalAPIContext_Destroy(_CCNxPortalAPIContext **instancePtr)
 {
     _CCNxPortalAPIContext *instance = *instancePtr;
 
-    parcDeque_Release(&instance->messageAddressBuffer);
+    for (size_t i = 0; i < instance->queueCount; i++) {
+        ccnxMetaMessage_Release(&instance->queue[(instance->queueHead + i) % instance->queueCapacity]);
+    }
+    parcMemory_Deallocate(&instance->queue);
+    ccnxPortalAttributes_Release(&instance->attributes);
 }
 
 parcObject_ExtendPARCObject(_CCNxPortalAPIContext, _ccnxPortalAPIContext_Destroy, NULL, NULL, NULL, NULL, NULL, NULL);
@@ -84,13 +98,35 @@ parcObject_ExtendPARCObject(_CCNxPortalAPIContext, _ccnxPortalAPIContext_Destroy
 static parcObject_ImplementRelease(_ccnxPortalAPIContext, _CCNxPortalAPIContext);
 
 static _CCNxPortalAPIContext *
-_ccnxPortalAPIContext_Create(void)
+_ccnxPortalAPIContext_Create(const CCNxPortalAttributes *attributes)
 {
     _CCNxPortalAPIContext *result = parcObject_CreateInstance(_CCNxPortalAPIContext);
-    result->messageAddressBuffer = parcDeque_Create();
+    result->queue = parcMemory_Allocate(_ccnxPortalAPI_InitialQueueCapacity * sizeof(CCNxMetaMessage *));
+    result->queueCapacity = _ccnxPortalAPI_InitialQueueCapacity;
+    result->queueHead = 0;
+    result->queueCount = 0;
+    result->attributes = ccnxPortalAttributes_Copy((attributes != NULL) ? attributes : &ccnxPortalAttributes_NonBlocking);
     return result;
 }
 
+static bool
+_ccnxPortalAPIContext_Grow(_CCNxPortalAPIContext *context)
+{
+    size_t capacity = context->queueCapacity * 2;
+    CCNxMetaMessage **queue = parcMemory_Allocate(capacity * sizeof(CCNxMetaMessage *));
+    if (queue == NULL) {
+        return false;
+    }
+    for (size_t i = 0; i < context->queueCount; i++) {
+        queue[i] = context->queue[(context->queueHead + i) % context->queueCapacity];
+    }
+    parcMemory_Deallocate(&context->queue);
+    context->queue = queue;
+    context->queueCapacity = capacity;
+    context->queueHead = 0;
+    return true;
+}
+
 static void
 _ccnxPortalAPI_Start(void *privateData)
 {
@@ -104,10 +140,26 @@ _ccnxPortalAPI_Stop(void *privateData)
 static bool
 _ccnxPortalAPI_Send(void *privateData, const CCNxMetaMessage *portalMessage, const CCNxStackTimeout *microSeconds)
 {
-    const _CCNxPortalAPIContext *transportContext = (_CCNxPortalAPIContext *) privateData;
+    _CCNxPortalAPIContext *transportContext = (_CCNxPortalAPIContext *) privateData;
+
+    // The loopback queue is both the send and the receive queue, so either limit bounds it.
+    size_t sendLimit = ccnxPortalAttributes_GetSendQueueLimit(transportContext->attributes);
+    size_t receiveLimit = ccnxPortalAttributes_GetReceiveQueueLimit(transportContext->attributes);
+    size_t queued = transportContext->queueCount;
+    if ((sendLimit > 0 && queued >= sendLimit) || (receiveLimit > 0 && queued >= receiveLimit)) {
+        errno = ENOBUFS;
+        return false;
+    }
+
+    if (queued == transportContext->queueCapacity && _ccnxPortalAPIContext_Grow(transportContext) == false) {
+        errno = ENOMEM;
+        return false;
+    }
 
     // Save the address of the portal message on our queue. We don't need to copy the whole message.
-    parcDeque_Append(transportContext->messageAddressBuffer, (void *) ccnxMetaMessage_Acquire(portalMessage));
+    size_t tail = (transportContext->queueHead + queued) % transportContext->queueCapacity;
+    transportContext->queue[tail] = ccnxMetaMessage_Acquire(portalMessage);
+    transportContext->queueCount++;
 
     return true;
 }
@@ -115,13 +167,17 @@ _ccnxPortalAPI_Send(void *privateData, const CCNxMetaMessage *portalMessage, con
 static CCNxMetaMessage *
 _ccnxPortalAPI_Receive(void *privateData, const CCNxStackTimeout *microSeconds)
 {
-    const _CCNxPortalAPIContext *transportContext = (_CCNxPortalAPIContext *) privateData;
+    _CCNxPortalAPIContext *transportContext = (_CCNxPortalAPIContext *) privateData;
 
-    if (parcDeque_IsEmpty(transportContext->messageAddressBuffer)) {
+    // The queue is only filled by sending from the receiving Portal, so waiting cannot help.
+    if (transportContext->queueCount == 0) {
+        errno = EWOULDBLOCK;
         return NULL;
     }
 
-    CCNxMetaMessage *result = (CCNxMetaMessage *) parcDeque_RemoveFirst(transportContext->messageAddressBuffer);
+    CCNxMetaMessage *result = transportContext->queue[transportContext->queueHead];
+    transportContext->queueHead = (transportContext->queueHead + 1) % transportContext->queueCapacity;
+    transportContext->queueCount--;
 
     return result;
 }
@@ -135,13 +191,23 @@ _ccnxPortalAPI_GetFileId(void *privateData)
 static CCNxPortalAttributes *
 _ccnxPortalAPI_GetAttributes(void *privateData)
 {
-    return NULL;
+    const _CCNxPortalAPIContext *transportContext = (_CCNxPortalAPIContext *) privateData;
+
+    return transportContext->attributes;
 }
 
 static bool
 _ccnxPortalAPI_SetAttributes(void *privateData, const CCNxPortalAttributes *attributes)
 {
-    return false;
+    _CCNxPortalAPIContext *transportContext = (_CCNxPortalAPIContext *) privateData;
+
+    CCNxPortalAttributes *copy = ccnxPortalAttributes_Copy(attributes);
+    if (copy == NULL) {
+        return false;
+    }
+    ccnxPortalAttributes_Release(&transportContext->attributes);
+    transportContext->attributes = copy;
+    return true;
 }
 
 static bool
@@ -159,7 +225,7 @@ _ccnxPortalAPI_Ignore(void *privateData, const CCNxName *name, const CCNxStackTi
 CCNxPortal *
 ccnxPortalAPI_LoopBack(const CCNxPortalFactory *factory, const CCNxPortalAttributes *attributes)
 {
-    _CCNxPortalAPIContext *apiContext = _ccnxPortalAPIContext_Create();
+    _CCNxPortalAPIContext *apiContext = _ccnxPortalAPIContext_Create(attributes);
 
     CCNxPortalStack *stack =
         ccnxPortalStack_Create(factory,
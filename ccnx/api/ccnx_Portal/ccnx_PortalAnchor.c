@@ -138,7 +138,20 @@ ccnxPortalAnchor_CreateFromJSON(const PARCJSON *json)
 int
 ccnxPortalAnchor_Compare(const CCNxPortalAnchor *instance, const CCNxPortalAnchor *other)
 {
-    int result = 0;
+    if (instance == other) {
+        return 0;
+    }
+    if (instance == NULL) {
+        return -1;
+    }
+    if (other == NULL) {
+        return 1;
+    }
+
+    int result = ccnxName_Compare(instance->prefix, other->prefix);
+    if (result == 0) {
+        result = (instance->expireTime > other->expireTime) - (instance->expireTime < other->expireTime);
+    }
 
     return result;
 }
@@ -190,7 +203,10 @@ ccnxPortalAnchor_Equals(const CCNxPortalAnchor *x, const CCNxPortalAnchor *y)
 PARCHashCode
 ccnxPortalAnchor_HashCode(const CCNxPortalAnchor *instance)
 {
-    PARCHashCode result = 0;
+    int64_t expireTime = (int64_t) instance->expireTime;
+
+    PARCHashCode result = parcHashCode_HashHashCode(ccnxName_HashCode(instance->prefix),
+                                                    parcHashCode_Hash((const uint8_t *) &expireTime, sizeof(expireTime)));
 
     return result;
 }
@@ -256,18 +272,63 @@ ccnxPortalAnchor_ToString(const CCNxPortalAnchor *anchor)
     return result;
 }
 
-CCNxPortalAnchor *
-ccnxPortalAnchor_Deserialize(PARCBuffer *buffer)
+/*
+ * The binary form of an anchor is a sequence of type-length-value fields,
+ * each with a 16-bit type and a 16-bit length in network byte order:
+ * the name prefix, encoded as its name segment TLVs, and the expiry time as a signed 64-bit integer.
+ * Unknown fields are skipped.
+ */
+#define _ccnxPortalAnchor_Type_Name 0x0000
+#define _ccnxPortalAnchor_Type_ExpireTime 0x0001
+#define _ccnxPortalAnchor_TLHeaderLength 4
+
+static CCNxName *
+_ccnxPortalAnchor_DecodeName(PARCBuffer *buffer, size_t length)
+{
+    CCNxName *result = ccnxName_Create();
+    size_t end = parcBuffer_Position(buffer) + length;
+
+    while (result != NULL && parcBuffer_Position(buffer) < end) {
+        if (end - parcBuffer_Position(buffer) < _ccnxPortalAnchor_TLHeaderLength) {
+            ccnxName_Release(&result);
+            break;
+        }
+        CCNxNameLabelType type = parcBuffer_GetUint16(buffer);
+        size_t valueLength = parcBuffer_GetUint16(buffer);
+        size_t position = parcBuffer_Position(buffer);
+        if (valueLength > end - position) {
+            ccnxName_Release(&result);
+            break;
+        }
+
+        PARCBuffer *value = parcBuffer_Slice(buffer);
+        parcBuffer_SetLimit(value, valueLength);
+        CCNxNameSegment *segment = ccnxNameSegment_CreateTypeValue(type, value);
+        ccnxName_Append(result, segment);
+        ccnxNameSegment_Release(&segment);
+        parcBuffer_Release(&value);
+
+        parcBuffer_SetPosition(buffer, position + valueLength);
+    }
+
+    return result;
+}
+
+static CCNxPortalAnchor *
+_ccnxPortalAnchor_DeserializeJSON(PARCBuffer *buffer)
 {
     PARCJSON *json = parcJSON_ParseBuffer(buffer);
+    if (json == NULL) {
+        return NULL;
+    }
 
     CCNxPortalAnchor *result = ccnxPortalAnchor_CreateFromJSON(json);
     parcJSON_Release(&json);
     return result;
 }
 
-PARCBufferComposer *
-ccnxPortalAnchor_Serialize(const CCNxPortalAnchor *namePrefix, PARCBufferComposer *composer)
+static PARCBufferComposer *
+_ccnxPortalAnchor_SerializeJSON(const CCNxPortalAnchor *namePrefix, PARCBufferComposer *composer)
 {
     PARCJSON *json = ccnxPortalAnchor_ToJSON(namePrefix);
 
@@ -278,6 +339,99 @@ ccnxPortalAnchor_Serialize(const CCNxPortalAnchor *namePrefix, PARCBufferCompose
     return composer;
 }
 
+CCNxPortalAnchor *
+ccnxPortalAnchor_Deserialize(PARCBuffer *buffer)
+{
+    // Accept the JSON form produced by earlier releases.
+    if (parcBuffer_Remaining(buffer) > 0 && parcBuffer_GetAtIndex(buffer, parcBuffer_Position(buffer)) == '{') {
+        return _ccnxPortalAnchor_DeserializeJSON(buffer);
+    }
+
+    CCNxName *prefix = NULL;
+    bool hasExpireTime = false;
+    int64_t expireTime = 0;
+    bool malformed = false;
+
+    while (malformed == false && parcBuffer_Remaining(buffer) > 0) {
+        if (parcBuffer_Remaining(buffer) < _ccnxPortalAnchor_TLHeaderLength) {
+            malformed = true;
+            break;
+        }
+        uint16_t type = parcBuffer_GetUint16(buffer);
+        size_t length = parcBuffer_GetUint16(buffer);
+        if (length > parcBuffer_Remaining(buffer)) {
+            malformed = true;
+            break;
+        }
+
+        switch (type) {
+            case _ccnxPortalAnchor_Type_Name:
+                if (prefix != NULL) {
+                    ccnxName_Release(&prefix);
+                }
+                prefix = _ccnxPortalAnchor_DecodeName(buffer, length);
+                malformed = (prefix == NULL);
+                break;
+
+            case _ccnxPortalAnchor_Type_ExpireTime:
+                if (length != sizeof(uint64_t)) {
+                    malformed = true;
+                } else {
+                    expireTime = (int64_t) parcBuffer_GetUint64(buffer);
+                    hasExpireTime = true;
+                }
+                break;
+
+            default:
+                parcBuffer_SetPosition(buffer, parcBuffer_Position(buffer) + length);
+                break;
+        }
+    }
+
+    CCNxPortalAnchor *result = NULL;
+    if (malformed == false && prefix != NULL && hasExpireTime) {
+        result = ccnxPortalAnchor_Create(prefix, (time_t) expireTime);
+    }
+    if (prefix != NULL) {
+        ccnxName_Release(&prefix);
+    }
+
+    return result;
+}
+
+PARCBufferComposer *
+ccnxPortalAnchor_Serialize(const CCNxPortalAnchor *anchor, PARCBufferComposer *composer)
+{
+    size_t segmentCount = ccnxName_GetSegmentCount(anchor->prefix);
+
+    size_t nameLength = 0;
+    for (size_t i = 0; i < segmentCount; i++) {
+        size_t segmentLength = ccnxNameSegment_Length(ccnxName_GetSegment(anchor->prefix, i));
+        if (segmentLength > UINT16_MAX) {
+            return NULL;
+        }
+        nameLength += _ccnxPortalAnchor_TLHeaderLength + segmentLength;
+    }
+    if (nameLength > UINT16_MAX) {
+        return NULL;
+    }
+
+    parcBufferComposer_PutUint16(composer, _ccnxPortalAnchor_Type_Name);
+    parcBufferComposer_PutUint16(composer, (uint16_t) nameLength);
+    for (size_t i = 0; i < segmentCount; i++) {
+        CCNxNameSegment *segment = ccnxName_GetSegment(anchor->prefix, i);
+        parcBufferComposer_PutUint16(composer, (uint16_t) ccnxNameSegment_GetType(segment));
+        parcBufferComposer_PutUint16(composer, (uint16_t) ccnxNameSegment_Length(segment));
+        parcBufferComposer_PutBuffer(composer, ccnxNameSegment_GetValue(segment));
+    }
+
+    parcBufferComposer_PutUint16(composer, _ccnxPortalAnchor_Type_ExpireTime);
+    parcBufferComposer_PutUint16(composer, sizeof(uint64_t));
+    parcBufferComposer_PutUint64(composer, (uint64_t) (int64_t) anchor->expireTime);
+
+    return composer;
+}
+
 CCNxName *
 ccnxPortalAnchor_GetNamePrefix(const CCNxPortalAnchor *anchor)
 {
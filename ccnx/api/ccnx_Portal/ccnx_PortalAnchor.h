@@ -425,8 +425,53 @@ char *ccnxPortalAnchor_ToString(const CCNxPortalAnchor *instance);
  */
 PARCBufferComposer *ccnxPortalAnchor_BuildString(const CCNxPortalAnchor *anchor, PARCBufferComposer *composer);
 
+/**
+ * Create a `CCNxPortalAnchor` from its serialized form in the given `PARCBuffer`.
+ *
+ * The buffer is read from its position to its limit.
+ * Both the binary form produced by {@link ccnxPortalAnchor_Serialize} and the JSON form produced by earlier releases are accepted.
+ *
+ * @param [in] buffer A pointer to a valid `PARCBuffer` instance.
+ *
+ * @return non-NULL A pointer to a valid CCNxPortalAnchor instance.
+ * @return NULL The buffer does not contain a well-formed anchor, or memory could not be allocated.
+ *
+ * Example:
+ * @code
+ * {
+ *     CCNxPortalAnchor *anchor = ccnxPortalAnchor_Deserialize(ccnxInterest_GetPayload(interest));
+ *
+ *     ccnxPortalAnchor_Release(&anchor);
+ * }
+ * @endcode
+ */
 CCNxPortalAnchor *ccnxPortalAnchor_Deserialize(PARCBuffer *buffer);
 
+/**
+ * Append the binary serialized form of the given `CCNxPortalAnchor` to the given `PARCBufferComposer`.
+ *
+ * The form is a sequence of TLV fields, each with a 16-bit type and 16-bit length in network byte order:
+ * type 0 holds the name prefix as its name segment TLVs and type 1 holds the expiry time as a signed 64-bit integer.
+ * Use {@link ccnxPortalAnchor_ToJSON} for a human readable form.
+ *
+ * @param [in] anchor A pointer to a valid CCNxPortalAnchor instance.
+ * @param [in,out] composer A pointer to a `PARCBufferComposer` instance to be modified.
+ *
+ * @return non-NULL The @p composer.
+ * @return NULL The name prefix is too long to encode.
+ *
+ * Example:
+ * @code
+ * {
+ *     PARCBufferComposer *composer = parcBufferComposer_Create();
+ *     ccnxPortalAnchor_Serialize(anchor, composer);
+ *     PARCBuffer *payload = parcBufferComposer_ProduceBuffer(composer);
+ *
+ *     parcBuffer_Release(&payload);
+ *     parcBufferComposer_Release(&composer);
+ * }
+ * @endcode
+ */
 PARCBufferComposer *ccnxPortalAnchor_Serialize(const CCNxPortalAnchor *anchor, PARCBufferComposer *composer);
 
 CCNxName *ccnxPortalAnchor_GetNamePrefix(const CCNxPortalAnchor *anchor);
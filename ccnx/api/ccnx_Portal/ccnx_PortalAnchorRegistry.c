@@ -0,0 +1,437 @@
+/*
+ * Copyright (c) 2016, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX OR PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ################################################################################
+ * #
+ * # PATENT NOTICE
+ * #
+ * # This software is distributed under the BSD 2-clause License (see LICENSE
+ * # file).  This BSD License does not make any patent claims and as such, does
+ * # not act as a patent grant.  The purpose of this section is for each contributor
+ * # to define their intentions with respect to intellectual property.
+ * #
+ * # Each contributor to this source code is encouraged to state their patent
+ * # claims and licensing mechanisms for any contributions made. At the end of
+ * # this section contributors may each make their own statements.  Contributor's
+ * # claims and grants only apply to the pieces (source code, programs, text,
+ * # media, etc) that they have contributed directly to this software.
+ * #
+ * # There is no guarantee that this section is complete, up to date or accurate. It
+ * # is up to the contributors to maintain their portion of this section and up to
+ * # the user of the software to verify any claims herein.
+ * #
+ * # Do not remove this header notification.  The contents of this section must be
+ * # present in all distributions of the software.  You may only modify your own
+ * # intellectual property statements.  Please provide contact information.
+ *
+ * - Palo Alto Research Center, Inc
+ * This software distribution does not grant any rights to patents owned by Palo
+ * Alto Research Center, Inc (PARC). Rights to these patents are available via
+ * various mechanisms. As of January 2016 PARC has committed to FRAND licensing any
+ * intellectual property used by its contributions to this software. You may
+ * contact PARC at cipo@parc.com for more information or visit http://www.ccnx.org
+ */
+/**
+ * @copyright (c) 2016, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC).  All rights reserved.
+ */
+#include <config.h>
+
+#include <stdint.h>
+
+#include <LongBow/runtime.h>
+
+#include <parc/algol/parc_Object.h>
+#include <parc/algol/parc_Memory.h>
+#include <parc/algol/parc_HashMap.h>
+#include <parc/algol/parc_Iterator.h>
+
+#include <ccnx/api/ccnx_Portal/ccnx_PortalAnchorRegistry.h>
+
+/*
+ * A node of the name tree. The path of segments from the root to a node is a name prefix,
+ * and the node holds the anchor for that prefix, if there is one.
+ * Nodes without an anchor exist only as long as they have children.
+ */
+typedef struct _CCNxPortalAnchorNode {
+    CCNxNameSegment *segment;
+    struct _CCNxPortalAnchorNode *parent;
+    PARCHashMap *children;
+    CCNxPortalAnchor *anchor;
+    size_t heapIndex;
+} _CCNxPortalAnchorNode;
+
+struct CCNxPortalAnchorRegistry {
+    _CCNxPortalAnchorNode *root;
+
+    // The nodes holding an anchor, as a binary min-heap on the expiry time.
+    _CCNxPortalAnchorNode **heap;
+    size_t heapSize;
+    size_t heapCapacity;
+};
+
+static void
+_ccnxPortalAnchorNode_Destroy(_CCNxPortalAnchorNode **nodePtr)
+{
+    _CCNxPortalAnchorNode *node = *nodePtr;
+
+    if (node->segment != NULL) {
+        ccnxNameSegment_Release(&node->segment);
+    }
+    if (node->children != NULL) {
+        parcHashMap_Release(&node->children);
+    }
+    if (node->anchor != NULL) {
+        ccnxPortalAnchor_Release(&node->anchor);
+    }
+}
+
+parcObject_ExtendPARCObject(_CCNxPortalAnchorNode, _ccnxPortalAnchorNode_Destroy, NULL, NULL, NULL, NULL, NULL, NULL);
+
+static parcObject_ImplementRelease(_ccnxPortalAnchorNode, _CCNxPortalAnchorNode);
+
+static _CCNxPortalAnchorNode *
+_ccnxPortalAnchorNode_Create(const CCNxNameSegment *segment, _CCNxPortalAnchorNode *parent)
+{
+    _CCNxPortalAnchorNode *result = parcObject_CreateInstance(_CCNxPortalAnchorNode);
+    if (result != NULL) {
+        result->segment = (segment == NULL) ? NULL : ccnxNameSegment_Acquire(segment);
+        result->parent = parent;
+        result->children = NULL;
+        result->anchor = NULL;
+        result->heapIndex = 0;
+    }
+    return result;
+}
+
+static void
+_ccnxPortalAnchorRegistry_Destroy(CCNxPortalAnchorRegistry **registryPtr)
+{
+    CCNxPortalAnchorRegistry *registry = *registryPtr;
+
+    _ccnxPortalAnchorNode_Release(&registry->root);
+    if (registry->heap != NULL) {
+        parcMemory_Deallocate(&registry->heap);
+    }
+}
+
+parcObject_ExtendPARCObject(CCNxPortalAnchorRegistry, _ccnxPortalAnchorRegistry_Destroy, NULL, NULL, NULL, NULL, NULL, NULL);
+
+parcObject_ImplementAcquire(ccnxPortalAnchorRegistry, CCNxPortalAnchorRegistry);
+
+parcObject_ImplementRelease(ccnxPortalAnchorRegistry, CCNxPortalAnchorRegistry);
+
+CCNxPortalAnchorRegistry *
+ccnxPortalAnchorRegistry_Create(void)
+{
+    CCNxPortalAnchorRegistry *result = parcObject_CreateInstance(CCNxPortalAnchorRegistry);
+    if (result != NULL) {
+        result->root = _ccnxPortalAnchorNode_Create(NULL, NULL);
+        result->heap = NULL;
+        result->heapSize = 0;
+        result->heapCapacity = 0;
+
+        if (result->root == NULL) {
+            ccnxPortalAnchorRegistry_Release(&result);
+        }
+    }
+    return result;
+}
+
+/*
+ * The heap key of a node: its anchor's expiry time, with anchors that never expire ordered last.
+ */
+static int64_t
+_ccnxPortalAnchorRegistry_HeapKey(const _CCNxPortalAnchorNode *node)
+{
+    time_t expireTime = ccnxPortalAnchor_GetExpireTime(node->anchor);
+    return (expireTime == -1) ? INT64_MAX : (int64_t) expireTime;
+}
+
+static void
+_ccnxPortalAnchorRegistry_HeapSet(CCNxPortalAnchorRegistry *registry, size_t index, _CCNxPortalAnchorNode *node)
+{
+    registry->heap[index] = node;
+    node->heapIndex = index;
+}
+
+static void
+_ccnxPortalAnchorRegistry_SiftUp(CCNxPortalAnchorRegistry *registry, size_t index)
+{
+    _CCNxPortalAnchorNode *node = registry->heap[index];
+    int64_t key = _ccnxPortalAnchorRegistry_HeapKey(node);
+
+    while (index > 0) {
+        size_t parent = (index - 1) / 2;
+        if (_ccnxPortalAnchorRegistry_HeapKey(registry->heap[parent]) <= key) {
+            break;
+        }
+        _ccnxPortalAnchorRegistry_HeapSet(registry, index, registry->heap[parent]);
+        index = parent;
+    }
+    _ccnxPortalAnchorRegistry_HeapSet(registry, index, node);
+}
+
+static void
+_ccnxPortalAnchorRegistry_SiftDown(CCNxPortalAnchorRegistry *registry, size_t index)
+{
+    _CCNxPortalAnchorNode *node = registry->heap[index];
+    int64_t key = _ccnxPortalAnchorRegistry_HeapKey(node);
+
+    while (true) {
+        size_t child = 2 * index + 1;
+        if (child >= registry->heapSize) {
+            break;
+        }
+        if (child + 1 < registry->heapSize &&
+            _ccnxPortalAnchorRegistry_HeapKey(registry->heap[child + 1]) < _ccnxPortalAnchorRegistry_HeapKey(registry->heap[child])) {
+            child++;
+        }
+        if (key <= _ccnxPortalAnchorRegistry_HeapKey(registry->heap[child])) {
+            break;
+        }
+        _ccnxPortalAnchorRegistry_HeapSet(registry, index, registry->heap[child]);
+        index = child;
+    }
+    _ccnxPortalAnchorRegistry_HeapSet(registry, index, node);
+}
+
+static bool
+_ccnxPortalAnchorRegistry_HeapInsert(CCNxPortalAnchorRegistry *registry, _CCNxPortalAnchorNode *node)
+{
+    if (registry->heapSize == registry->heapCapacity) {
+        size_t capacity = (registry->heapCapacity == 0) ? 64 : registry->heapCapacity * 2;
+        _CCNxPortalAnchorNode **heap = parcMemory_Reallocate(registry->heap, capacity * sizeof(_CCNxPortalAnchorNode *));
+        if (heap == NULL) {
+            return false;
+        }
+        registry->heap = heap;
+        registry->heapCapacity = capacity;
+    }
+
+    _ccnxPortalAnchorRegistry_HeapSet(registry, registry->heapSize++, node);
+    _ccnxPortalAnchorRegistry_SiftUp(registry, node->heapIndex);
+    return true;
+}
+
+static void
+_ccnxPortalAnchorRegistry_HeapRemove(CCNxPortalAnchorRegistry *registry, _CCNxPortalAnchorNode *node)
+{
+    size_t index = node->heapIndex;
+    _CCNxPortalAnchorNode *last = registry->heap[--registry->heapSize];
+
+    if (index < registry->heapSize) {
+        _ccnxPortalAnchorRegistry_HeapSet(registry, index, last);
+        _ccnxPortalAnchorRegistry_SiftDown(registry, index);
+        _ccnxPortalAnchorRegistry_SiftUp(registry, last->heapIndex);
+    }
+}
+
+/*
+ * Find the node for the given name, optionally creating it and any missing nodes on the path to it.
+ */
+static _CCNxPortalAnchorNode *
+_ccnxPortalAnchorRegistry_FindNode(const CCNxPortalAnchorRegistry *registry, const CCNxName *name, bool create)
+{
+    _CCNxPortalAnchorNode *node = registry->root;
+    size_t segmentCount = ccnxName_GetSegmentCount(name);
+
+    for (size_t i = 0; i < segmentCount && node != NULL; i++) {
+        CCNxNameSegment *segment = ccnxName_GetSegment(name, i);
+
+        _CCNxPortalAnchorNode *child = NULL;
+        if (node->children != NULL) {
+            child = (_CCNxPortalAnchorNode *) parcHashMap_Get(node->children, segment);
+        }
+
+        if (child == NULL && create) {
+            if (node->children == NULL) {
+                node->children = parcHashMap_Create();
+            }
+            child = _ccnxPortalAnchorNode_Create(segment, node);
+            if (node->children == NULL || child == NULL) {
+                if (child != NULL) {
+                    _ccnxPortalAnchorNode_Release(&child);
+                }
+                return NULL;
+            }
+            parcHashMap_Put(node->children, segment, child);
+
+            // The parent's map now holds the node.
+            _CCNxPortalAnchorNode *reference = child;
+            _ccnxPortalAnchorNode_Release(&reference);
+        }
+
+        node = child;
+    }
+
+    return node;
+}
+
+/*
+ * Remove the given node, and then its ancestors, for as long as they hold neither an anchor nor children.
+ */
+static void
+_ccnxPortalAnchorRegistry_Prune(CCNxPortalAnchorRegistry *registry, _CCNxPortalAnchorNode *node)
+{
+    while (node != registry->root && node->anchor == NULL &&
+           (node->children == NULL || parcHashMap_Size(node->children) == 0)) {
+        _CCNxPortalAnchorNode *parent = node->parent;
+
+        // Removing the node from its parent releases it, and with it the segment used as the key.
+        CCNxNameSegment *segment = ccnxNameSegment_Acquire(node->segment);
+        parcHashMap_Remove(parent->children, segment);
+        ccnxNameSegment_Release(&segment);
+
+        node = parent;
+    }
+}
+
+static void
+_ccnxPortalAnchorRegistry_RemoveNodeAnchor(CCNxPortalAnchorRegistry *registry, _CCNxPortalAnchorNode *node)
+{
+    _ccnxPortalAnchorRegistry_HeapRemove(registry, node);
+    ccnxPortalAnchor_Release(&node->anchor);
+    _ccnxPortalAnchorRegistry_Prune(registry, node);
+}
+
+bool
+ccnxPortalAnchorRegistry_Put(CCNxPortalAnchorRegistry *registry, const CCNxPortalAnchor *anchor)
+{
+    _CCNxPortalAnchorNode *node = _ccnxPortalAnchorRegistry_FindNode(registry, ccnxPortalAnchor_GetNamePrefix(anchor), true);
+    if (node == NULL) {
+        return false;
+    }
+
+    if (node->anchor != NULL) {
+        ccnxPortalAnchor_Release(&node->anchor);
+        node->anchor = ccnxPortalAnchor_Acquire(anchor);
+        _ccnxPortalAnchorRegistry_SiftDown(registry, node->heapIndex);
+        _ccnxPortalAnchorRegistry_SiftUp(registry, node->heapIndex);
+        return true;
+    }
+
+    node->anchor = ccnxPortalAnchor_Acquire(anchor);
+    if (_ccnxPortalAnchorRegistry_HeapInsert(registry, node) == false) {
+        ccnxPortalAnchor_Release(&node->anchor);
+        _ccnxPortalAnchorRegistry_Prune(registry, node);
+        return false;
+    }
+    return true;
+}
+
+CCNxPortalAnchor *
+ccnxPortalAnchorRegistry_Get(const CCNxPortalAnchorRegistry *registry, const CCNxName *prefix)
+{
+    _CCNxPortalAnchorNode *node = _ccnxPortalAnchorRegistry_FindNode(registry, prefix, false);
+
+    return (node == NULL) ? NULL : node->anchor;
+}
+
+CCNxPortalAnchor *
+ccnxPortalAnchorRegistry_LongestPrefixMatch(const CCNxPortalAnchorRegistry *registry, const CCNxName *name)
+{
+    _CCNxPortalAnchorNode *node = registry->root;
+    CCNxPortalAnchor *result = node->anchor;
+    size_t segmentCount = ccnxName_GetSegmentCount(name);
+
+    for (size_t i = 0; i < segmentCount && node->children != NULL; i++) {
+        node = (_CCNxPortalAnchorNode *) parcHashMap_Get(node->children, ccnxName_GetSegment(name, i));
+        if (node == NULL) {
+            break;
+        }
+        if (node->anchor != NULL) {
+            result = node->anchor;
+        }
+    }
+
+    return result;
+}
+
+static void
+_ccnxPortalAnchorRegistry_CollectUnder(_CCNxPortalAnchorNode *node, PARCArrayList *list)
+{
+    if (node->anchor != NULL) {
+        parcArrayList_Add(list, ccnxPortalAnchor_Acquire(node->anchor));
+    }
+
+    if (node->children != NULL) {
+        PARCIterator *iterator = parcHashMap_CreateValueIterator(node->children);
+        while (parcIterator_HasNext(iterator)) {
+            _ccnxPortalAnchorRegistry_CollectUnder(parcIterator_Next(iterator), list);
+        }
+        parcIterator_Release(&iterator);
+    }
+}
+
+PARCArrayList *
+ccnxPortalAnchorRegistry_CreateListUnder(const CCNxPortalAnchorRegistry *registry, const CCNxName *prefix)
+{
+    PARCArrayList *result = parcArrayList_Create((void (*)(void **))ccnxPortalAnchor_Release);
+
+    if (result != NULL) {
+        _CCNxPortalAnchorNode *node = _ccnxPortalAnchorRegistry_FindNode(registry, prefix, false);
+        if (node != NULL) {
+            _ccnxPortalAnchorRegistry_CollectUnder(node, result);
+        }
+    }
+
+    return result;
+}
+
+bool
+ccnxPortalAnchorRegistry_Remove(CCNxPortalAnchorRegistry *registry, const CCNxName *prefix)
+{
+    _CCNxPortalAnchorNode *node = _ccnxPortalAnchorRegistry_FindNode(registry, prefix, false);
+    if (node == NULL || node->anchor == NULL) {
+        return false;
+    }
+
+    _ccnxPortalAnchorRegistry_RemoveNodeAnchor(registry, node);
+    return true;
+}
+
+CCNxPortalAnchor *
+ccnxPortalAnchorRegistry_PeekNextExpiring(const CCNxPortalAnchorRegistry *registry)
+{
+    return (registry->heapSize == 0) ? NULL : registry->heap[0]->anchor;
+}
+
+size_t
+ccnxPortalAnchorRegistry_RemoveExpired(CCNxPortalAnchorRegistry *registry, time_t now)
+{
+    size_t result = 0;
+
+    while (registry->heapSize > 0 && _ccnxPortalAnchorRegistry_HeapKey(registry->heap[0]) <= (int64_t) now) {
+        _ccnxPortalAnchorRegistry_RemoveNodeAnchor(registry, registry->heap[0]);
+        result++;
+    }
+
+    return result;
+}
+
+size_t
+ccnxPortalAnchorRegistry_Size(const CCNxPortalAnchorRegistry *registry)
+{
+    return registry->heapSize;
+}
@@ -0,0 +1,309 @@
+/*
+ * Copyright (c) 2016, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX OR PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ################################################################################
+ * #
+ * # PATENT NOTICE
+ * #
+ * # This software is distributed under the BSD 2-clause License (see LICENSE
+ * # file).  This BSD License does not make any patent claims and as such, does
+ * # not act as a patent grant.  The purpose of this section is for each contributor
+ * # to define their intentions with respect to intellectual property.
+ * #
+ * # Each contributor to this source code is encouraged to state their patent
+ * # claims and licensing mechanisms for any contributions made. At the end of
+ * # this section contributors may each make their own statements.  Contributor's
+ * # claims and grants only apply to the pieces (source code, programs, text,
+ * # media, etc) that they have contributed directly to this software.
+ * #
+ * # There is no guarantee that this section is complete, up to date or accurate. It
+ * # is up to the contributors to maintain their portion of this section and up to
+ * # the user of the software to verify any claims herein.
+ * #
+ * # Do not remove this header notification.  The contents of this section must be
+ * # present in all distributions of the software.  You may only modify your own
+ * # intellectual property statements.  Please provide contact information.
+ *
+ * - Palo Alto Research Center, Inc
+ * This software distribution does not grant any rights to patents owned by Palo
+ * Alto Research Center, Inc (PARC). Rights to these patents are available via
+ * various mechanisms. As of January 2016 PARC has committed to FRAND licensing any
+ * intellectual property used by its contributions to this software. You may
+ * contact PARC at cipo@parc.com for more information or visit http://www.ccnx.org
+ */
+/**
+ * @file ccnx_PortalAnchorRegistry.h
+ * @brief An index of `CCNxPortalAnchor` instances by name prefix and by expiry time.
+ *
+ * A registry holds at most one anchor per name prefix.
+ * Anchors are indexed by a tree of name segments, so exact lookups, longest-prefix matches and
+ * the enumeration of the anchors under a prefix cost time proportional to the number of segments in the name,
+ * independent of the number of anchors.
+ * Anchors are also held in a binary heap ordered by expiry time, so finding the next anchor to expire is constant time
+ * and sweeping away expired anchors costs O(log n) per anchor removed.
+ *
+ * An anchor with an expiry time of -1 never expires.
+ *
+ * A registry is not thread-safe.
+ *
+ * @copyright (c) 2016, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC).  All rights reserved.
+ */
+#ifndef CCNx_Portal_API_ccnx_PortalAnchorRegistry_h
+#define CCNx_Portal_API_ccnx_PortalAnchorRegistry_h
+
+#include <stdbool.h>
+#include <time.h>
+
+#include <parc/algol/parc_ArrayList.h>
+
+#include <ccnx/api/ccnx_Portal/ccnx_PortalAnchor.h>
+
+#include <ccnx/common/ccnx_Name.h>
+
+struct CCNxPortalAnchorRegistry;
+/**
+ * @typedef CCNxPortalAnchorRegistry
+ * @brief An index of `CCNxPortalAnchor` instances by name prefix and by expiry time.
+ */
+typedef struct CCNxPortalAnchorRegistry CCNxPortalAnchorRegistry;
+
+/**
+ * Create a new, empty `CCNxPortalAnchorRegistry`.
+ *
+ * @return non-NULL A pointer to a valid `CCNxPortalAnchorRegistry` instance.
+ * @return NULL Memory could not be allocated.
+ *
+ * Example:
+ * @code
+ * {
+ *     CCNxPortalAnchorRegistry *registry = ccnxPortalAnchorRegistry_Create();
+ *
+ *     ccnxPortalAnchorRegistry_Release(&registry);
+ * }
+ * @endcode
+ */
+CCNxPortalAnchorRegistry *ccnxPortalAnchorRegistry_Create(void);
+
+/**
+ * Increase the number of references to a `CCNxPortalAnchorRegistry` instance.
+ *
+ * @param [in] registry A pointer to a valid `CCNxPortalAnchorRegistry` instance.
+ *
+ * @return The same value as @p registry.
+ *
+ * Example:
+ * @code
+ * {
+ *     CCNxPortalAnchorRegistry *registry = ccnxPortalAnchorRegistry_Create();
+ *     CCNxPortalAnchorRegistry *reference = ccnxPortalAnchorRegistry_Acquire(registry);
+ *
+ *     ccnxPortalAnchorRegistry_Release(&registry);
+ *     ccnxPortalAnchorRegistry_Release(&reference);
+ * }
+ * @endcode
+ */
+CCNxPortalAnchorRegistry *ccnxPortalAnchorRegistry_Acquire(const CCNxPortalAnchorRegistry *registry);
+
+/**
+ * Release a previously acquired reference to the given `CCNxPortalAnchorRegistry` instance,
+ * decrementing the reference count for the instance.
+ *
+ * The pointer to the instance is set to NULL as a side-effect of this function.
+ * Releasing the last reference releases every anchor held in the registry.
+ *
+ * @param [in,out] registryPtr A pointer to a pointer to the instance to release.
+ *
+ * Example:
+ * @code
+ * {
+ *     CCNxPortalAnchorRegistry *registry = ccnxPortalAnchorRegistry_Create();
+ *
+ *     ccnxPortalAnchorRegistry_Release(&registry);
+ * }
+ * @endcode
+ */
+void ccnxPortalAnchorRegistry_Release(CCNxPortalAnchorRegistry **registryPtr);
+
+/**
+ * Add the given anchor to the registry, replacing any anchor with the same name prefix.
+ *
+ * Replacing an anchor is how a renewal with a new expiry time is recorded.
+ * The registry acquires a reference to @p anchor.
+ *
+ * @param [in] registry A pointer to a valid `CCNxPortalAnchorRegistry` instance.
+ * @param [in] anchor A pointer to a valid `CCNxPortalAnchor` instance.
+ *
+ * @return true The anchor was added.
+ * @return false Memory could not be allocated.
+ *
+ * Example:
+ * @code
+ * {
+ *     CCNxPortalAnchor *anchor = ccnxPortalAnchor_Create(name, time(0) + 60);
+ *
+ *     ccnxPortalAnchorRegistry_Put(registry, anchor);
+ *
+ *     ccnxPortalAnchor_Release(&anchor);
+ * }
+ * @endcode
+ */
+bool ccnxPortalAnchorRegistry_Put(CCNxPortalAnchorRegistry *registry, const CCNxPortalAnchor *anchor);
+
+/**
+ * Get the anchor whose name prefix is equal to the given name.
+ *
+ * @param [in] registry A pointer to a valid `CCNxPortalAnchorRegistry` instance.
+ * @param [in] prefix A pointer to a valid `CCNxName` instance.
+ *
+ * @return non-NULL The anchor, valid until it is removed from the registry. Acquire it to keep it longer.
+ * @return NULL There is no anchor for @p prefix.
+ *
+ * Example:
+ * @code
+ * {
+ *     CCNxPortalAnchor *anchor = ccnxPortalAnchorRegistry_Get(registry, name);
+ * }
+ * @endcode
+ */
+CCNxPortalAnchor *ccnxPortalAnchorRegistry_Get(const CCNxPortalAnchorRegistry *registry, const CCNxName *prefix);
+
+/**
+ * Get the anchor with the longest name prefix that is a prefix of the given name.
+ *
+ * @param [in] registry A pointer to a valid `CCNxPortalAnchorRegistry` instance.
+ * @param [in] name A pointer to a valid `CCNxName` instance.
+ *
+ * @return non-NULL The anchor, valid until it is removed from the registry. Acquire it to keep it longer.
+ * @return NULL No anchor's name prefix is a prefix of @p name.
+ *
+ * Example:
+ * @code
+ * {
+ *     CCNxName *name = ccnxName_CreateFromCString("lci:/example/videos/1/chunk=3");
+ *
+ *     CCNxPortalAnchor *anchor = ccnxPortalAnchorRegistry_LongestPrefixMatch(registry, name);
+ *
+ *     ccnxName_Release(&name);
+ * }
+ * @endcode
+ */
+CCNxPortalAnchor *ccnxPortalAnchorRegistry_LongestPrefixMatch(const CCNxPortalAnchorRegistry *registry, const CCNxName *name);
+
+/**
+ * Create a list of the anchors whose name prefix starts with the given name, including an anchor for the name itself.
+ *
+ * @param [in] registry A pointer to a valid `CCNxPortalAnchorRegistry` instance.
+ * @param [in] prefix A pointer to a valid `CCNxName` instance.
+ *
+ * @return non-NULL A `PARCArrayList` of acquired `CCNxPortalAnchor` instances, released when the list is destroyed.
+ * @return NULL Memory could not be allocated.
+ *
+ * Example:
+ * @code
+ * {
+ *     PARCArrayList *anchors = ccnxPortalAnchorRegistry_CreateListUnder(registry, prefix);
+ *
+ *     for (size_t i = 0; i < parcArrayList_Size(anchors); i++) {
+ *         ccnxPortalAnchor_Display(parcArrayList_Get(anchors, i), 0);
+ *     }
+ *
+ *     parcArrayList_Destroy(&anchors);
+ * }
+ * @endcode
+ */
+PARCArrayList *ccnxPortalAnchorRegistry_CreateListUnder(const CCNxPortalAnchorRegistry *registry, const CCNxName *prefix);
+
+/**
+ * Remove the anchor whose name prefix is equal to the given name.
+ *
+ * @param [in] registry A pointer to a valid `CCNxPortalAnchorRegistry` instance.
+ * @param [in] prefix A pointer to a valid `CCNxName` instance.
+ *
+ * @return true An anchor was removed.
+ * @return false There is no anchor for @p prefix.
+ *
+ * Example:
+ * @code
+ * {
+ *     ccnxPortalAnchorRegistry_Remove(registry, name);
+ * }
+ * @endcode
+ */
+bool ccnxPortalAnchorRegistry_Remove(CCNxPortalAnchorRegistry *registry, const CCNxName *prefix);
+
+/**
+ * Get the anchor that will expire first.
+ *
+ * Anchors that never expire are returned only when there are no others.
+ *
+ * @param [in] registry A pointer to a valid `CCNxPortalAnchorRegistry` instance.
+ *
+ * @return non-NULL The anchor, valid until it is removed from the registry.
+ * @return NULL The registry is empty.
+ *
+ * Example:
+ * @code
+ * {
+ *     CCNxPortalAnchor *next = ccnxPortalAnchorRegistry_PeekNextExpiring(registry);
+ *     if (next != NULL) {
+ *         printf("Next renewal due at %ld\n", ccnxPortalAnchor_GetExpireTime(next));
+ *     }
+ * }
+ * @endcode
+ */
+CCNxPortalAnchor *ccnxPortalAnchorRegistry_PeekNextExpiring(const CCNxPortalAnchorRegistry *registry);
+
+/**
+ * Remove every anchor whose expiry time is at or before the given time.
+ *
+ * @param [in] registry A pointer to a valid `CCNxPortalAnchorRegistry` instance.
+ * @param [in] now The current time, in seconds since the epoch.
+ *
+ * @return The number of anchors removed.
+ *
+ * Example:
+ * @code
+ * {
+ *     size_t expired = ccnxPortalAnchorRegistry_RemoveExpired(registry, time(0));
+ * }
+ * @endcode
+ */
+size_t ccnxPortalAnchorRegistry_RemoveExpired(CCNxPortalAnchorRegistry *registry, time_t now);
+
+/**
+ * Get the number of anchors in the registry.
+ *
+ * @param [in] registry A pointer to a valid `CCNxPortalAnchorRegistry` instance.
+ *
+ * @return The number of anchors in the registry.
+ *
+ * Example:
+ * @code
+ * {
+ *     printf("%zu anchors\n", ccnxPortalAnchorRegistry_Size(registry));
+ * }
+ * @endcode
+ */
+size_t ccnxPortalAnchorRegistry_Size(const CCNxPortalAnchorRegistry *registry);
+#endif // CCNx_Portal_API_ccnx_PortalAnchorRegistry_h
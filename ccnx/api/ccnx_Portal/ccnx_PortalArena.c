@@ -0,0 +1,574 @@
+/*
+ * Copyright (c) 2016, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX OR PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ################################################################################
+ * #
+ * # PATENT NOTICE
+ * #
+ * # This software is distributed under the BSD 2-clause License (see LICENSE
+ * # file).  This BSD License does not make any patent claims and as such, does
+ * # not act as a patent grant.  The purpose of this section is for each contributor
+ * # to define their intentions with respect to intellectual property.
+ * #
+ * # Each contributor to this source code is encouraged to state their patent
+ * # claims and licensing mechanisms for any contributions made. At the end of
+ * # this section contributors may each make their own statements.  Contributor's
+ * # claims and grants only apply to the pieces (source code, programs, text,
+ * # media, etc) that they have contributed directly to this software.
+ * #
+ * # There is no guarantee that this section is complete, up to date or accurate. It
+ * # is up to the contributors to maintain their portion of this section and up to
+ * # the user of the software to verify any claims herein.
+ * #
+ * # Do not remove this header notification.  The contents of this section must be
+ * # present in all distributions of the software.  You may only modify your own
+ * # intellectual property statements.  Please provide contact information.
+ *
+ * - Palo Alto Research Center, Inc
+ * This software distribution does not grant any rights to patents owned by Palo
+ * Alto Research Center, Inc (PARC). Rights to these patents are available via
+ * various mechanisms. As of January 2016 PARC has committed to FRAND licensing any
+ * intellectual property used by its contributions to this software. You may
+ * contact PARC at cipo@parc.com for more information or visit http://www.ccnx.org
+ */
+/**
+ * @copyright (c) 2016, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC).  All rights reserved.
+ */
+#include <config.h>
+
+#include <errno.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <LongBow/runtime.h>
+
+#include <parc/algol/parc_Object.h>
+#include <parc/algol/parc_Memory.h>
+
+#include <ccnx/api/ccnx_Portal/ccnx_PortalArena.h>
+
+// Blocks are aligned to their size, so the block holding any arena allocation is found by masking its address.
+#define _ccnxPortalArena_BlockShift 18
+#define _ccnxPortalArena_BlockSize ((size_t) 1 << _ccnxPortalArena_BlockShift)
+
+// Larger allocations, such as big payloads, are not worth a block and come from the memory interface beneath.
+#define _ccnxPortalArena_LargeAllocation (_ccnxPortalArena_BlockSize / 4)
+
+// Every allocation is aligned to, and preceded by a header of, this many bytes. The header holds the allocation's size.
+#define _ccnxPortalArena_Alignment 16
+
+// The most blocks all arenas together may hold. Must be a power of two.
+#define _ccnxPortalArena_TableBits 12
+#define _ccnxPortalArena_TableSize ((size_t) 1 << _ccnxPortalArena_TableBits)
+#define _ccnxPortalArena_Tombstone ((uintptr_t) 1)
+
+/*
+ * The start of every block: the next block of the same arena.
+ */
+typedef struct _ccnxPortalArenaBlock {
+    struct _ccnxPortalArenaBlock *next;
+} _CCNxPortalArenaBlock;
+
+struct CCNxPortalArena {
+    _CCNxPortalArenaBlock *first;
+    _CCNxPortalArenaBlock *current;   // The block being carved, or NULL before the first allocation since the last reset.
+    size_t offset;                    // The offset of the next allocation in the current block.
+    size_t blockCount;
+
+    size_t allocationCount;
+    size_t allocatedBytes;
+    size_t live;                      // Allocations not yet freed since the last reset. Updated atomically.
+
+    CCNxPortalArena *previous;        // The arena that was active on the thread before ccnxPortalArena_Begin.
+};
+
+// Guards installing and uninstalling the arena memory interface, and creating arenas while it is installed.
+static pthread_mutex_t _ccnxPortalArena_InstallLock = PTHREAD_MUTEX_INITIALIZER;
+static bool _ccnxPortalArena_Installed;
+static const PARCMemoryInterface *_ccnxPortalArena_Underlying;
+
+// The arenas not yet destroyed. The arena memory interface cannot be uninstalled while any exist.
+static size_t _ccnxPortalArena_ArenaCount;
+
+static __thread CCNxPortalArena *_ccnxPortalArena_Current;
+
+// The blocks of all arenas, by address, so that freeing memory can tell whether it belongs to an arena.
+static uintptr_t _ccnxPortalArena_Blocks[_ccnxPortalArena_TableSize];
+static CCNxPortalArena *_ccnxPortalArena_Owners[_ccnxPortalArena_TableSize];
+static size_t _ccnxPortalArena_BlockTotal;
+
+// Allocations from all arenas not yet freed, reported as outstanding memory.
+static size_t _ccnxPortalArena_Live;
+
+static void *
+_ccnxPortalArena_UnderlyingAllocate(size_t size)
+{
+    return ((void *(*)(size_t)) _ccnxPortalArena_Underlying->Allocate)(size);
+}
+
+static void *
+_ccnxPortalArena_UnderlyingAllocateAndClear(size_t size)
+{
+    return ((void *(*)(size_t)) _ccnxPortalArena_Underlying->AllocateAndClear)(size);
+}
+
+static int
+_ccnxPortalArena_UnderlyingMemAlign(void **pointer, size_t alignment, size_t size)
+{
+    return ((int (*)(void **, size_t, size_t)) _ccnxPortalArena_Underlying->MemAlign)(pointer, alignment, size);
+}
+
+static void
+_ccnxPortalArena_UnderlyingDeallocate(void **pointer)
+{
+    ((void (*)(void **)) _ccnxPortalArena_Underlying->Deallocate)(pointer);
+}
+
+static void *
+_ccnxPortalArena_UnderlyingReallocate(void *pointer, size_t newSize)
+{
+    return ((void *(*)(void *, size_t)) _ccnxPortalArena_Underlying->Reallocate)(pointer, newSize);
+}
+
+static char *
+_ccnxPortalArena_UnderlyingStringDuplicate(const char *string, size_t length)
+{
+    return ((char *(*)(const char *, size_t)) _ccnxPortalArena_Underlying->StringDuplicate)(string, length);
+}
+
+static uint32_t
+_ccnxPortalArena_UnderlyingOutstanding(void)
+{
+    return ((uint32_t (*)(void)) _ccnxPortalArena_Underlying->Outstanding)();
+}
+
+static size_t
+_ccnxPortalArena_Hash(uintptr_t base)
+{
+    return (size_t) (((uint64_t) (base >> _ccnxPortalArena_BlockShift) * 0x9E3779B97F4A7C15ULL) >> (64 - _ccnxPortalArena_TableBits));
+}
+
+static bool
+_ccnxPortalArena_Register(void *block, CCNxPortalArena *arena)
+{
+    uintptr_t base = (uintptr_t) block;
+    size_t index = _ccnxPortalArena_Hash(base);
+
+    for (size_t probe = 0; probe < _ccnxPortalArena_TableSize; probe++) {
+        uintptr_t key = __atomic_load_n(&_ccnxPortalArena_Blocks[index], __ATOMIC_ACQUIRE);
+        if (key == 0 || key == _ccnxPortalArena_Tombstone) {
+            _ccnxPortalArena_Owners[index] = arena;
+            if (__atomic_compare_exchange_n(&_ccnxPortalArena_Blocks[index], &key, base, false, __ATOMIC_RELEASE, __ATOMIC_RELAXED)) {
+                __atomic_add_fetch(&_ccnxPortalArena_BlockTotal, 1, __ATOMIC_RELEASE);
+                return true;
+            }
+        }
+        index = (index + 1) & (_ccnxPortalArena_TableSize - 1);
+    }
+    return false;
+}
+
+static void
+_ccnxPortalArena_Unregister(void *block)
+{
+    uintptr_t base = (uintptr_t) block;
+    size_t index = _ccnxPortalArena_Hash(base);
+
+    for (size_t probe = 0; probe < _ccnxPortalArena_TableSize; probe++) {
+        uintptr_t key = __atomic_load_n(&_ccnxPortalArena_Blocks[index], __ATOMIC_ACQUIRE);
+        if (key == base) {
+            __atomic_store_n(&_ccnxPortalArena_Blocks[index], _ccnxPortalArena_Tombstone, __ATOMIC_RELEASE);
+            __atomic_sub_fetch(&_ccnxPortalArena_BlockTotal, 1, __ATOMIC_RELEASE);
+            return;
+        }
+        if (key == 0) {
+            return;
+        }
+        index = (index + 1) & (_ccnxPortalArena_TableSize - 1);
+    }
+}
+
+/*
+ * The arena the given memory was allocated from, or NULL if it was not allocated from an arena.
+ */
+static CCNxPortalArena *
+_ccnxPortalArena_Owner(const void *pointer)
+{
+    if (__atomic_load_n(&_ccnxPortalArena_BlockTotal, __ATOMIC_ACQUIRE) == 0) {
+        return NULL;
+    }
+
+    uintptr_t base = (uintptr_t) pointer & ~((uintptr_t) _ccnxPortalArena_BlockSize - 1);
+    size_t index = _ccnxPortalArena_Hash(base);
+
+    for (size_t probe = 0; probe < _ccnxPortalArena_TableSize; probe++) {
+        uintptr_t key = __atomic_load_n(&_ccnxPortalArena_Blocks[index], __ATOMIC_ACQUIRE);
+        if (key == base) {
+            return _ccnxPortalArena_Owners[index];
+        }
+        if (key == 0) {
+            return NULL;
+        }
+        index = (index + 1) & (_ccnxPortalArena_TableSize - 1);
+    }
+    return NULL;
+}
+
+static _CCNxPortalArenaBlock *
+_ccnxPortalArena_CreateBlock(CCNxPortalArena *arena)
+{
+    void *block = NULL;
+    if (_ccnxPortalArena_UnderlyingMemAlign(&block, _ccnxPortalArena_BlockSize, _ccnxPortalArena_BlockSize) != 0 || block == NULL) {
+        return NULL;
+    }
+    if (_ccnxPortalArena_Register(block, arena) == false) {
+        _ccnxPortalArena_UnderlyingDeallocate(&block);
+        return NULL;
+    }
+
+    _CCNxPortalArenaBlock *result = block;
+    result->next = NULL;
+    arena->blockCount++;
+
+    return result;
+}
+
+/*
+ * Carve an allocation from the arena, or return NULL if it is too large or no block could be added.
+ */
+static void *
+_ccnxPortalArena_Carve(CCNxPortalArena *arena, size_t size)
+{
+    if (size > _ccnxPortalArena_LargeAllocation) {
+        return NULL;
+    }
+
+    size_t needed = _ccnxPortalArena_Alignment + ((size + _ccnxPortalArena_Alignment - 1) & ~((size_t) _ccnxPortalArena_Alignment - 1));
+
+    if (arena->current == NULL || arena->offset + needed > _ccnxPortalArena_BlockSize) {
+        _CCNxPortalArenaBlock *next = (arena->current == NULL) ? arena->first : arena->current->next;
+        if (next == NULL) {
+            next = _ccnxPortalArena_CreateBlock(arena);
+            if (next == NULL) {
+                return NULL;
+            }
+            if (arena->current == NULL) {
+                arena->first = next;
+            } else {
+                arena->current->next = next;
+            }
+        }
+        arena->current = next;
+        arena->offset = _ccnxPortalArena_Alignment;
+    }
+
+    uint8_t *header = (uint8_t *) arena->current + arena->offset;
+    *(size_t *) header = size;
+    arena->offset += needed;
+
+    arena->allocationCount++;
+    arena->allocatedBytes += needed;
+    __atomic_add_fetch(&arena->live, 1, __ATOMIC_RELAXED);
+    __atomic_add_fetch(&_ccnxPortalArena_Live, 1, __ATOMIC_RELAXED);
+
+    return header + _ccnxPortalArena_Alignment;
+}
+
+static void
+_ccnxPortalArena_Free(CCNxPortalArena *owner)
+{
+    __atomic_sub_fetch(&owner->live, 1, __ATOMIC_RELEASE);
+    __atomic_sub_fetch(&_ccnxPortalArena_Live, 1, __ATOMIC_RELAXED);
+}
+
+static void *
+_ccnxPortalArena_Allocate(size_t size)
+{
+    CCNxPortalArena *arena = _ccnxPortalArena_Current;
+    void *result = (arena == NULL) ? NULL : _ccnxPortalArena_Carve(arena, size);
+
+    return (result != NULL) ? result : _ccnxPortalArena_UnderlyingAllocate(size);
+}
+
+static void *
+_ccnxPortalArena_AllocateAndClear(size_t size)
+{
+    CCNxPortalArena *arena = _ccnxPortalArena_Current;
+    void *result = (arena == NULL) ? NULL : _ccnxPortalArena_Carve(arena, size);
+
+    if (result != NULL) {
+        memset(result, 0, size);
+        return result;
+    }
+    return _ccnxPortalArena_UnderlyingAllocateAndClear(size);
+}
+
+static int
+_ccnxPortalArena_MemAlign(void **pointer, size_t alignment, size_t size)
+{
+    CCNxPortalArena *arena = _ccnxPortalArena_Current;
+    if (arena != NULL && alignment <= _ccnxPortalArena_Alignment) {
+        void *result = _ccnxPortalArena_Carve(arena, size);
+        if (result != NULL) {
+            *pointer = result;
+            return 0;
+        }
+    }
+    return _ccnxPortalArena_UnderlyingMemAlign(pointer, alignment, size);
+}
+
+static void
+_ccnxPortalArena_Deallocate(void **pointer)
+{
+    CCNxPortalArena *owner = _ccnxPortalArena_Owner(*pointer);
+    if (owner != NULL) {
+        _ccnxPortalArena_Free(owner);
+        *pointer = NULL;
+    } else {
+        _ccnxPortalArena_UnderlyingDeallocate(pointer);
+    }
+}
+
+static void *
+_ccnxPortalArena_Reallocate(void *pointer, size_t newSize)
+{
+    if (pointer == NULL) {
+        return _ccnxPortalArena_Allocate(newSize);
+    }
+
+    CCNxPortalArena *owner = _ccnxPortalArena_Owner(pointer);
+    if (owner == NULL) {
+        return _ccnxPortalArena_UnderlyingReallocate(pointer, newSize);
+    }
+
+    size_t oldSize = *(size_t *) ((uint8_t *) pointer - _ccnxPortalArena_Alignment);
+    void *result = _ccnxPortalArena_Allocate(newSize);
+    if (result != NULL) {
+        memcpy(result, pointer, (oldSize < newSize) ? oldSize : newSize);
+        _ccnxPortalArena_Free(owner);
+    }
+    return result;
+}
+
+static char *
+_ccnxPortalArena_StringDuplicate(const char *string, size_t length)
+{
+    CCNxPortalArena *arena = _ccnxPortalArena_Current;
+    if (arena != NULL) {
+        size_t actualLength = strnlen(string, length);
+        char *result = _ccnxPortalArena_Carve(arena, actualLength + 1);
+        if (result != NULL) {
+            memcpy(result, string, actualLength);
+            result[actualLength] = '\0';
+            return result;
+        }
+    }
+    return _ccnxPortalArena_UnderlyingStringDuplicate(string, length);
+}
+
+static uint32_t
+_ccnxPortalArena_Outstanding(void)
+{
+    return _ccnxPortalArena_UnderlyingOutstanding() + (uint32_t) __atomic_load_n(&_ccnxPortalArena_Live, __ATOMIC_RELAXED);
+}
+
+static PARCMemoryInterface _ccnxPortalArena_Memory = {
+    .Allocate         = (uintptr_t) _ccnxPortalArena_Allocate,
+    .AllocateAndClear = (uintptr_t) _ccnxPortalArena_AllocateAndClear,
+    .MemAlign         = (uintptr_t) _ccnxPortalArena_MemAlign,
+    .Deallocate       = (uintptr_t) _ccnxPortalArena_Deallocate,
+    .Reallocate       = (uintptr_t) _ccnxPortalArena_Reallocate,
+    .StringDuplicate  = (uintptr_t) _ccnxPortalArena_StringDuplicate,
+    .Outstanding      = (uintptr_t) _ccnxPortalArena_Outstanding
+};
+
+static void
+_ccnxPortalArena_Destroy(CCNxPortalArena **arenaPtr)
+{
+    CCNxPortalArena *arena = *arenaPtr;
+
+    ccnxPortalArena_Reset(arena);
+
+    _CCNxPortalArenaBlock *block = arena->first;
+    while (block != NULL) {
+        _CCNxPortalArenaBlock *next = block->next;
+        _ccnxPortalArena_Unregister(block);
+        _ccnxPortalArena_UnderlyingDeallocate((void **) &block);
+        block = next;
+    }
+
+    __atomic_sub_fetch(&_ccnxPortalArena_ArenaCount, 1, __ATOMIC_RELEASE);
+}
+
+parcObject_ExtendPARCObject(CCNxPortalArena, _ccnxPortalArena_Destroy, NULL, NULL, NULL, NULL, NULL, NULL);
+
+parcObject_ImplementAcquire(ccnxPortalArena, CCNxPortalArena);
+
+parcObject_ImplementRelease(ccnxPortalArena, CCNxPortalArena);
+
+bool
+ccnxPortalArena_Install(void)
+{
+    bool result = false;
+
+    pthread_mutex_lock(&_ccnxPortalArena_InstallLock);
+    if (_ccnxPortalArena_Installed) {
+        errno = EALREADY;
+    } else {
+        _ccnxPortalArena_Underlying = parcMemory_SetInterface(&_ccnxPortalArena_Memory);
+        _ccnxPortalArena_Installed = true;
+        result = true;
+    }
+    pthread_mutex_unlock(&_ccnxPortalArena_InstallLock);
+
+    return result;
+}
+
+bool
+ccnxPortalArena_Uninstall(void)
+{
+    bool result = false;
+
+    pthread_mutex_lock(&_ccnxPortalArena_InstallLock);
+    if (_ccnxPortalArena_Installed == false) {
+        errno = EINVAL;
+    } else if (__atomic_load_n(&_ccnxPortalArena_ArenaCount, __ATOMIC_ACQUIRE) > 0) {
+        errno = EBUSY;
+    } else {
+        parcMemory_SetInterface(_ccnxPortalArena_Underlying);
+        _ccnxPortalArena_Underlying = NULL;
+        _ccnxPortalArena_Installed = false;
+        result = true;
+    }
+    pthread_mutex_unlock(&_ccnxPortalArena_InstallLock);
+
+    return result;
+}
+
+bool
+ccnxPortalArena_IsInstalled(void)
+{
+    pthread_mutex_lock(&_ccnxPortalArena_InstallLock);
+    bool result = _ccnxPortalArena_Installed;
+    pthread_mutex_unlock(&_ccnxPortalArena_InstallLock);
+
+    return result;
+}
+
+CCNxPortalArena *
+ccnxPortalArena_Create(void)
+{
+    pthread_mutex_lock(&_ccnxPortalArena_InstallLock);
+    if (_ccnxPortalArena_Installed == false) {
+        pthread_mutex_unlock(&_ccnxPortalArena_InstallLock);
+        errno = EPERM;
+        return NULL;
+    }
+
+    // The arena itself must not be allocated from whichever arena is active.
+    CCNxPortalArena *active = _ccnxPortalArena_Current;
+    _ccnxPortalArena_Current = NULL;
+    CCNxPortalArena *result = parcObject_CreateInstance(CCNxPortalArena);
+    _ccnxPortalArena_Current = active;
+
+    if (result != NULL) {
+        __atomic_add_fetch(&_ccnxPortalArena_ArenaCount, 1, __ATOMIC_RELEASE);
+    }
+    pthread_mutex_unlock(&_ccnxPortalArena_InstallLock);
+
+    if (result == NULL) {
+        errno = ENOMEM;
+        return NULL;
+    }
+
+    result->first = NULL;
+    result->current = NULL;
+    result->offset = 0;
+    result->blockCount = 0;
+    result->allocationCount = 0;
+    result->allocatedBytes = 0;
+    result->live = 0;
+    result->previous = NULL;
+
+    return result;
+}
+
+void
+ccnxPortalArena_Begin(CCNxPortalArena *arena)
+{
+    arena->previous = _ccnxPortalArena_Current;
+    _ccnxPortalArena_Current = arena;
+}
+
+void
+ccnxPortalArena_End(CCNxPortalArena *arena)
+{
+    _ccnxPortalArena_Current = arena->previous;
+    arena->previous = NULL;
+}
+
+CCNxPortalArena *
+ccnxPortalArena_Suspend(void)
+{
+    CCNxPortalArena *result = _ccnxPortalArena_Current;
+    _ccnxPortalArena_Current = NULL;
+    return result;
+}
+
+void
+ccnxPortalArena_Resume(CCNxPortalArena *arena)
+{
+    _ccnxPortalArena_Current = arena;
+}
+
+void
+ccnxPortalArena_Reset(CCNxPortalArena *arena)
+{
+    size_t live = __atomic_load_n(&arena->live, __ATOMIC_ACQUIRE);
+    assertTrue(live == 0, "Resetting an arena with %zu allocations not yet freed", live);
+
+    arena->current = NULL;
+    arena->offset = 0;
+    arena->allocationCount = 0;
+    arena->allocatedBytes = 0;
+}
+
+size_t
+ccnxPortalArena_GetAllocationCount(const CCNxPortalArena *arena)
+{
+    return arena->allocationCount;
+}
+
+size_t
+ccnxPortalArena_GetAllocatedBytes(const CCNxPortalArena *arena)
+{
+    return arena->allocatedBytes;
+}
+
+size_t
+ccnxPortalArena_GetBlockCount(const CCNxPortalArena *arena)
+{
+    return arena->blockCount;
+}
@@ -0,0 +1,343 @@
+/*
+ * Copyright (c) 2016, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX OR PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ################################################################################
+ * #
+ * # PATENT NOTICE
+ * #
+ * # This software is distributed under the BSD 2-clause License (see LICENSE
+ * # file).  This BSD License does not make any patent claims and as such, does
+ * # not act as a patent grant.  The purpose of this section is for each contributor
+ * # to define their intentions with respect to intellectual property.
+ * #
+ * # Each contributor to this source code is encouraged to state their patent
+ * # claims and licensing mechanisms for any contributions made. At the end of
+ * # this section contributors may each make their own statements.  Contributor's
+ * # claims and grants only apply to the pieces (source code, programs, text,
+ * # media, etc) that they have contributed directly to this software.
+ * #
+ * # There is no guarantee that this section is complete, up to date or accurate. It
+ * # is up to the contributors to maintain their portion of this section and up to
+ * # the user of the software to verify any claims herein.
+ * #
+ * # Do not remove this header notification.  The contents of this section must be
+ * # present in all distributions of the software.  You may only modify your own
+ * # intellectual property statements.  Please provide contact information.
+ *
+ * - Palo Alto Research Center, Inc
+ * This software distribution does not grant any rights to patents owned by Palo
+ * Alto Research Center, Inc (PARC). Rights to these patents are available via
+ * various mechanisms. As of January 2016 PARC has committed to FRAND licensing any
+ * intellectual property used by its contributions to this software. You may
+ * contact PARC at cipo@parc.com for more information or visit http://www.ccnx.org
+ */
+/**
+ * @file ccnx_PortalArena.h
+ * @brief Allocate a batch of received messages together and free them all at once.
+ *
+ * Receiving and decoding a message allocates the message, its name, each of its name segments and its buffers
+ * one at a time, and releasing it frees each of them again.
+ * While an arena is active on a thread, every allocation the thread makes through the PARC memory interface
+ * is instead carved from the arena's blocks, and freeing such an allocation does nothing.
+ * Resetting the arena discards everything allocated from it at once and keeps its blocks for the next batch,
+ * so once the arena has grown to the size of a batch, a batch costs no calls to the allocator.
+ *
+ * Arenas work by interposing a memory interface over the one in use, for the whole process.
+ * This is an explicit opt-in: an application that uses arenas calls {@link ccnxPortalArena_Install} once,
+ * after choosing its memory interface with `parcMemory_SetInterface`, and must not call `parcMemory_SetInterface` again
+ * until it has released every arena and called {@link ccnxPortalArena_Uninstall}.
+ * While installed, allocations made outside an arena go straight to the memory interface beneath.
+ * Allocations larger than a quarter of an arena block are not taken from the arena.
+ *
+ * Only allocations made on the thread where the arena is active come from it.
+ * A stack that decodes messages on the receiving thread, like the replay stacks, decodes into the arena;
+ * a stack that decodes on its own thread, like the RTA stacks, delivers messages that do not.
+ *
+ * Everything allocated from an arena is invalid once the arena is reset.
+ * Before resetting, release every message of the batch,
+ * and make sure none of them, nor anything obtained from them, has been retained, sent, or passed to another thread.
+ * Copy whatever must outlive the batch while no arena is active.
+ *
+ * @copyright (c) 2016, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC).  All rights reserved.
+ */
+#ifndef CCNx_Portal_API_ccnx_PortalArena_h
+#define CCNx_Portal_API_ccnx_PortalArena_h
+
+#include <stdbool.h>
+#include <stddef.h>
+
+struct CCNxPortalArena;
+/**
+ * @typedef CCNxPortalArena
+ * @brief Allocate a batch of received messages together and free them all at once.
+ */
+typedef struct CCNxPortalArena CCNxPortalArena;
+
+/**
+ * Install the arena memory interface over the PARC memory interface currently in use, for the whole process.
+ *
+ * Call this once, after any call to `parcMemory_SetInterface` and before creating the first arena.
+ * Memory allocated before installing remains valid and is freed through the interface beneath.
+ *
+ * @return true The arena memory interface is installed.
+ * @return false It was already installed. `errno` is set to `EALREADY`.
+ *
+ * Example:
+ * @code
+ * {
+ *     parcMemory_SetInterface(&PARCSafeMemoryAsPARCMemory);
+ *     ccnxPortalArena_Install();
+ *     CCNxPortalArena *arena = ccnxPortalArena_Create();
+ *     ...
+ *     ccnxPortalArena_Release(&arena);
+ *     ccnxPortalArena_Uninstall();
+ * }
+ * @endcode
+ */
+bool ccnxPortalArena_Install(void);
+
+/**
+ * Restore the PARC memory interface that was in use when {@link ccnxPortalArena_Install} was called.
+ *
+ * Every arena must have been released first.
+ * Memory allocated outside an arena while installed came from the interface beneath and remains valid.
+ *
+ * @return true The previous memory interface is restored.
+ * @return false The arena memory interface was not installed (`EINVAL`), or an arena still exists (`EBUSY`).
+ *
+ * Example:
+ * @code
+ * {
+ *     ccnxPortalArena_Release(&arena);
+ *     ccnxPortalArena_Uninstall();
+ * }
+ * @endcode
+ */
+bool ccnxPortalArena_Uninstall(void);
+
+/**
+ * Determine if the arena memory interface is installed.
+ *
+ * @return true {@link ccnxPortalArena_Install} has been called, and not undone by {@link ccnxPortalArena_Uninstall}.
+ *
+ * Example:
+ * @code
+ * {
+ *     if (ccnxPortalArena_IsInstalled()) {
+ *         arena = ccnxPortalArena_Create();
+ *     }
+ * }
+ * @endcode
+ */
+bool ccnxPortalArena_IsInstalled(void);
+
+/**
+ * Create a new, empty `CCNxPortalArena`.
+ *
+ * The arena memory interface must have been installed with {@link ccnxPortalArena_Install}.
+ *
+ * @return non-NULL A pointer to a valid `CCNxPortalArena` instance.
+ * @return NULL The arena memory interface is not installed (`EPERM`), or memory could not be allocated (`ENOMEM`).
+ *
+ * Example:
+ * @code
+ * {
+ *     CCNxPortalArena *arena = ccnxPortalArena_Create();
+ *
+ *     ccnxPortalArena_Release(&arena);
+ * }
+ * @endcode
+ */
+CCNxPortalArena *ccnxPortalArena_Create(void);
+
+/**
+ * Increase the number of references to a `CCNxPortalArena` instance.
+ *
+ * @param [in] arena A pointer to a valid `CCNxPortalArena` instance.
+ *
+ * @return The same value as @p arena.
+ *
+ * Example:
+ * @code
+ * {
+ *     CCNxPortalArena *arena = ccnxPortalArena_Create();
+ *     CCNxPortalArena *reference = ccnxPortalArena_Acquire(arena);
+ *
+ *     ccnxPortalArena_Release(&arena);
+ *     ccnxPortalArena_Release(&reference);
+ * }
+ * @endcode
+ */
+CCNxPortalArena *ccnxPortalArena_Acquire(const CCNxPortalArena *arena);
+
+/**
+ * Release a previously acquired reference to the given `CCNxPortalArena` instance,
+ * decrementing the reference count for the instance.
+ *
+ * The pointer to the instance is set to NULL as a side-effect of this function.
+ * Releasing the last reference resets the arena and frees its blocks, so everything allocated from it must have been freed.
+ * The arena must not be active on any thread.
+ *
+ * @param [in,out] arenaPtr A pointer to a pointer to the instance to release.
+ *
+ * Example:
+ * @code
+ * {
+ *     CCNxPortalArena *arena = ccnxPortalArena_Create();
+ *
+ *     ccnxPortalArena_Release(&arena);
+ * }
+ * @endcode
+ */
+void ccnxPortalArena_Release(CCNxPortalArena **arenaPtr);
+
+/**
+ * Make @p arena the source of the calling thread's allocations until the matching {@link ccnxPortalArena_End}.
+ *
+ * Calls may be nested, with different arenas; each `ccnxPortalArena_End` restores the arena that was active before.
+ *
+ * @param [in] arena A pointer to a valid `CCNxPortalArena` instance.
+ *
+ * Example:
+ * @code
+ * {
+ *     ccnxPortalArena_Begin(arena);
+ *     CCNxMetaMessage *message = ccnxMetaMessage_CreateFromWireFormatBuffer(wireFormat);
+ *     ccnxPortalArena_End(arena);
+ * }
+ * @endcode
+ */
+void ccnxPortalArena_Begin(CCNxPortalArena *arena);
+
+/**
+ * Stop allocating from @p arena on the calling thread.
+ *
+ * @param [in] arena A pointer to the `CCNxPortalArena` instance given to the matching {@link ccnxPortalArena_Begin}.
+ *
+ * Example:
+ * @code
+ * {
+ *     ccnxPortalArena_Begin(arena);
+ *     CCNxMetaMessage *message = ccnxMetaMessage_CreateFromWireFormatBuffer(wireFormat);
+ *     ccnxPortalArena_End(arena);
+ * }
+ * @endcode
+ */
+void ccnxPortalArena_End(CCNxPortalArena *arena);
+
+/**
+ * Stop allocating from the calling thread's active arena, if any, until {@link ccnxPortalArena_Resume}.
+ *
+ * Code that may run while an arena is active, but keeps what it allocates beyond the batch,
+ * such as a stack reading ahead of the message it returns, suspends the arena around that work.
+ *
+ * @return The arena that was active, or NULL if none was, to be given to `ccnxPortalArena_Resume`.
+ *
+ * Example:
+ * @code
+ * {
+ *     CCNxPortalArena *arena = ccnxPortalArena_Suspend();
+ *     CCNxName *copy = ccnxName_Copy(name);
+ *     ccnxPortalArena_Resume(arena);
+ * }
+ * @endcode
+ */
+CCNxPortalArena *ccnxPortalArena_Suspend(void);
+
+/**
+ * Resume allocating from the arena suspended by {@link ccnxPortalArena_Suspend}.
+ *
+ * @param [in] arena The value returned by the matching `ccnxPortalArena_Suspend`, which may be NULL.
+ */
+void ccnxPortalArena_Resume(CCNxPortalArena *arena);
+
+/**
+ * Discard everything allocated from @p arena, keeping its blocks for reuse.
+ *
+ * Everything allocated from @p arena must have been freed, which for a batch of messages means each has been released.
+ * Resetting an arena with allocations outstanding is a programming error and traps.
+ *
+ * @param [in] arena A pointer to a valid `CCNxPortalArena` instance.
+ *
+ * Example:
+ * @code
+ * {
+ *     size_t count = ccnxPortal_ReceiveBatch(portal, messages, 1000, arena, CCNxStackTimeout_Never);
+ *     for (size_t i = 0; i < count; i++) {
+ *         ...
+ *     }
+ *     ccnxPortalArena_Reset(arena);
+ * }
+ * @endcode
+ */
+void ccnxPortalArena_Reset(CCNxPortalArena *arena);
+
+/**
+ * Get the number of allocations made from @p arena since it was created or last reset.
+ *
+ * @param [in] arena A pointer to a valid `CCNxPortalArena` instance.
+ *
+ * @return The number of allocations made from @p arena since it was created or last reset.
+ *
+ * Example:
+ * @code
+ * {
+ *     printf("%zu allocations in %zu bytes\n", ccnxPortalArena_GetAllocationCount(arena), ccnxPortalArena_GetAllocatedBytes(arena));
+ * }
+ * @endcode
+ */
+size_t ccnxPortalArena_GetAllocationCount(const CCNxPortalArena *arena);
+
+/**
+ * Get the number of bytes allocated from @p arena since it was created or last reset, including per-allocation overhead.
+ *
+ * @param [in] arena A pointer to a valid `CCNxPortalArena` instance.
+ *
+ * @return The number of bytes allocated from @p arena since it was created or last reset.
+ *
+ * Example:
+ * @code
+ * {
+ *     printf("%zu allocations in %zu bytes\n", ccnxPortalArena_GetAllocationCount(arena), ccnxPortalArena_GetAllocatedBytes(arena));
+ * }
+ * @endcode
+ */
+size_t ccnxPortalArena_GetAllocatedBytes(const CCNxPortalArena *arena);
+
+/**
+ * Get the number of blocks @p arena holds.
+ *
+ * @param [in] arena A pointer to a valid `CCNxPortalArena` instance.
+ *
+ * @return The number of blocks @p arena has allocated, whether or not they are in use.
+ *
+ * Example:
+ * @code
+ * {
+ *     printf("%zu blocks\n", ccnxPortalArena_GetBlockCount(arena));
+ * }
+ * @endcode
+ */
+size_t ccnxPortalArena_GetBlockCount(const CCNxPortalArena *arena);
+#endif // CCNx_Portal_API_ccnx_PortalArena_h
@@ -62,19 +62,212 @@
 
 #include <ccnx/api/ccnx_Portal/ccnx_PortalAttributes.h>
 
+#include <parc/algol/parc_Object.h>
+
 struct ccnx_portal_attributes {
     bool logging;
+    bool blocking;
+    size_t sendQueueLimit;
+    size_t receiveQueueLimit;
+    size_t maxBatchSize;
+    uint32_t busyPollMicroSeconds;
+    int busyPollCpu;
+    size_t socketSendBufferSize;
+    size_t socketReceiveBufferSize;
 };
 
 /**
  * Non-blocking (reads)
  */
 const CCNxPortalAttributes ccnxPortalAttributes_NonBlocking = {
-    .logging  = false
+    .logging  = false,
+    .blocking = false,
+    .maxBatchSize = 1,
+    .busyPollCpu = -1
+};
+
+/**
+ * Blocking (reads)
+ */
+const CCNxPortalAttributes ccnxPortalAttributes_Blocking = {
+    .logging  = false,
+    .blocking = true,
+    .maxBatchSize = 1,
+    .busyPollCpu = -1
 };
 
+parcObject_ExtendPARCObject(CCNxPortalAttributes, NULL, NULL, NULL, NULL, NULL, NULL, NULL);
+
+parcObject_ImplementAcquire(ccnxPortalAttributes, CCNxPortalAttributes);
+
+parcObject_ImplementRelease(ccnxPortalAttributes, CCNxPortalAttributes);
+
+CCNxPortalAttributes *
+ccnxPortalAttributes_Copy(const CCNxPortalAttributes *original)
+{
+    CCNxPortalAttributes *result = parcObject_CreateInstance(CCNxPortalAttributes);
+    if (result != NULL) {
+        result->logging = original->logging;
+        result->blocking = original->blocking;
+        result->sendQueueLimit = original->sendQueueLimit;
+        result->receiveQueueLimit = original->receiveQueueLimit;
+        result->maxBatchSize = original->maxBatchSize;
+        result->busyPollMicroSeconds = original->busyPollMicroSeconds;
+        result->busyPollCpu = original->busyPollCpu;
+        result->socketSendBufferSize = original->socketSendBufferSize;
+        result->socketReceiveBufferSize = original->socketReceiveBufferSize;
+    }
+    return result;
+}
+
+CCNxPortalAttributes *
+ccnxPortalAttributes_Create(void)
+{
+    return ccnxPortalAttributes_Copy(&ccnxPortalAttributes_NonBlocking);
+}
+
+bool
+ccnxPortalAttributes_Equals(const CCNxPortalAttributes *a, const CCNxPortalAttributes *b)
+{
+    if (a == b) {
+        return true;
+    }
+    if (a == NULL || b == NULL) {
+        return false;
+    }
+    return a->logging == b->logging
+           && a->blocking == b->blocking
+           && a->sendQueueLimit == b->sendQueueLimit
+           && a->receiveQueueLimit == b->receiveQueueLimit
+           && a->maxBatchSize == b->maxBatchSize
+           && a->busyPollMicroSeconds == b->busyPollMicroSeconds
+           && a->busyPollCpu == b->busyPollCpu
+           && a->socketSendBufferSize == b->socketSendBufferSize
+           && a->socketReceiveBufferSize == b->socketReceiveBufferSize;
+}
+
+PARCJSON *
+ccnxPortalAttributes_ToJSON(const CCNxPortalAttributes *attributes)
+{
+    PARCJSON *result = parcJSON_Create();
+
+    parcJSON_AddBoolean(result, "logging", attributes->logging);
+    parcJSON_AddBoolean(result, "blocking", attributes->blocking);
+    parcJSON_AddInteger(result, "sendQueueLimit", (int64_t) attributes->sendQueueLimit);
+    parcJSON_AddInteger(result, "receiveQueueLimit", (int64_t) attributes->receiveQueueLimit);
+    parcJSON_AddInteger(result, "maxBatchSize", (int64_t) attributes->maxBatchSize);
+    parcJSON_AddInteger(result, "busyPollMicroSeconds", (int64_t) attributes->busyPollMicroSeconds);
+    parcJSON_AddInteger(result, "busyPollCpu", attributes->busyPollCpu);
+    parcJSON_AddInteger(result, "socketSendBufferSize", (int64_t) attributes->socketSendBufferSize);
+    parcJSON_AddInteger(result, "socketReceiveBufferSize", (int64_t) attributes->socketReceiveBufferSize);
+
+    return result;
+}
+
 bool
 ccnxPortalAttributes_IsLogging(const CCNxPortalAttributes *attributes)
 {
     return attributes->logging;
 }
+
+void
+ccnxPortalAttributes_SetLogging(CCNxPortalAttributes *attributes, bool logging)
+{
+    attributes->logging = logging;
+}
+
+bool
+ccnxPortalAttributes_IsBlocking(const CCNxPortalAttributes *attributes)
+{
+    return attributes->blocking;
+}
+
+void
+ccnxPortalAttributes_SetBlocking(CCNxPortalAttributes *attributes, bool blocking)
+{
+    attributes->blocking = blocking;
+}
+
+size_t
+ccnxPortalAttributes_GetSendQueueLimit(const CCNxPortalAttributes *attributes)
+{
+    return attributes->sendQueueLimit;
+}
+
+void
+ccnxPortalAttributes_SetSendQueueLimit(CCNxPortalAttributes *attributes, size_t limit)
+{
+    attributes->sendQueueLimit = limit;
+}
+
+size_t
+ccnxPortalAttributes_GetReceiveQueueLimit(const CCNxPortalAttributes *attributes)
+{
+    return attributes->receiveQueueLimit;
+}
+
+void
+ccnxPortalAttributes_SetReceiveQueueLimit(CCNxPortalAttributes *attributes, size_t limit)
+{
+    attributes->receiveQueueLimit = limit;
+}
+
+size_t
+ccnxPortalAttributes_GetMaxBatchSize(const CCNxPortalAttributes *attributes)
+{
+    return attributes->maxBatchSize;
+}
+
+void
+ccnxPortalAttributes_SetMaxBatchSize(CCNxPortalAttributes *attributes, size_t maxBatchSize)
+{
+    attributes->maxBatchSize = (maxBatchSize == 0) ? 1 : maxBatchSize;
+}
+
+uint32_t
+ccnxPortalAttributes_GetBusyPollMicroSeconds(const CCNxPortalAttributes *attributes)
+{
+    return attributes->busyPollMicroSeconds;
+}
+
+void
+ccnxPortalAttributes_SetBusyPollMicroSeconds(CCNxPortalAttributes *attributes, uint32_t microSeconds)
+{
+    attributes->busyPollMicroSeconds = microSeconds;
+}
+
+int
+ccnxPortalAttributes_GetBusyPollCpu(const CCNxPortalAttributes *attributes)
+{
+    return attributes->busyPollCpu;
+}
+
+void
+ccnxPortalAttributes_SetBusyPollCpu(CCNxPortalAttributes *attributes, int cpu)
+{
+    attributes->busyPollCpu = (cpu < 0) ? -1 : cpu;
+}
+
+size_t
+ccnxPortalAttributes_GetSocketSendBufferSize(const CCNxPortalAttributes *attributes)
+{
+    return attributes->socketSendBufferSize;
+}
+
+void
+ccnxPortalAttributes_SetSocketSendBufferSize(CCNxPortalAttributes *attributes, size_t size)
+{
+    attributes->socketSendBufferSize = size;
+}
+
+size_t
+ccnxPortalAttributes_GetSocketReceiveBufferSize(const CCNxPortalAttributes *attributes)
+{
+    return attributes->socketReceiveBufferSize;
+}
+
+void
+ccnxPortalAttributes_SetSocketReceiveBufferSize(CCNxPortalAttributes *attributes, size_t size)
+{
+    attributes->socketReceiveBufferSize = size;
+}
@@ -56,6 +56,17 @@
  * @file ccnx_PortalAttributes.h
  * @brief Attributes related to the `CCNxPortal` instance.
  *
+ * Attributes are the tunable performance surface of a `CCNxPortal`:
+ * blocking or non-blocking operation, limits on the number of queued messages,
+ * the maximum number of messages processed in one batch,
+ * how long a receive may busy-poll before sleeping, and the sizes of the underlying socket buffers.
+ *
+ * Attributes are given to a Portal Stack when the Portal is created and may be changed at runtime with `ccnxPortal_SetAttributes`.
+ * A value of zero for a limit or a size means "use the Stack's default".
+ *
+ * The constant instances `ccnxPortalAttributes_NonBlocking` and `ccnxPortalAttributes_Blocking` are templates:
+ * they may be read and copied, but must not be acquired or released.
+ *
  * @author Glenn Scott, Palo Alto Research Center (Xerox PARC)
  * @copyright (c) 2013-2015, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC).  All rights reserved.
  */
@@ -63,6 +74,10 @@
 #define __CCNx_Portal_API__ccnx_PortalAttributes__
 
 #include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+
+#include <parc/algol/parc_JSON.h>
 
 struct ccnx_portal_attributes;
 /**
@@ -75,6 +90,89 @@ typedef struct ccnx_portal_attributes CCNxPortalAttributes;
  */
 extern const CCNxPortalAttributes ccnxPortalAttributes_NonBlocking;
 
+/**
+ * Blocking (reads)
+ */
+extern const CCNxPortalAttributes ccnxPortalAttributes_Blocking;
+
+/**
+ * Create a new `CCNxPortalAttributes` instance with the same values as `ccnxPortalAttributes_NonBlocking`.
+ *
+ * @return non-NULL A pointer to a valid `CCNxPortalAttributes` instance that must be released via `ccnxPortalAttributes_Release`.
+ * @return NULL Memory could not be allocated.
+ *
+ * Example:
+ * @code
+ * {
+ *     CCNxPortalAttributes *attributes = ccnxPortalAttributes_Create();
+ *     ccnxPortalAttributes_SetBusyPollMicroSeconds(attributes, 50);
+ *
+ *     ccnxPortal_SetAttributes(portal, attributes);
+ *
+ *     ccnxPortalAttributes_Release(&attributes);
+ * }
+ * @endcode
+ */
+CCNxPortalAttributes *ccnxPortalAttributes_Create(void);
+
+/**
+ * Create a new `CCNxPortalAttributes` instance with the same values as @p original.
+ *
+ * @p original may be one of the constant instances.
+ *
+ * @param [in] original A pointer to a valid `CCNxPortalAttributes` instance.
+ *
+ * @return non-NULL A pointer to a valid `CCNxPortalAttributes` instance that must be released via `ccnxPortalAttributes_Release`.
+ * @return NULL Memory could not be allocated.
+ *
+ * Example:
+ * @code
+ * {
+ *     CCNxPortalAttributes *attributes = ccnxPortalAttributes_Copy(&ccnxPortalAttributes_Blocking);
+ *
+ *     ccnxPortalAttributes_Release(&attributes);
+ * }
+ * @endcode
+ */
+CCNxPortalAttributes *ccnxPortalAttributes_Copy(const CCNxPortalAttributes *original);
+
+/**
+ * Increase the number of references to a `CCNxPortalAttributes` instance created by `ccnxPortalAttributes_Create` or `ccnxPortalAttributes_Copy`.
+ *
+ * @param [in] attributes A pointer to a valid `CCNxPortalAttributes` instance.
+ *
+ * @return The value of @p attributes.
+ */
+CCNxPortalAttributes *ccnxPortalAttributes_Acquire(const CCNxPortalAttributes *attributes);
+
+/**
+ * Release a previously acquired reference to the specified instance,
+ * decrementing the reference count for the instance.
+ *
+ * @param [in,out] attributesPtr A pointer to a pointer to the instance to release.
+ */
+void ccnxPortalAttributes_Release(CCNxPortalAttributes **attributesPtr);
+
+/**
+ * Determine if two `CCNxPortalAttributes` instances are equal.
+ *
+ * @param [in] a A pointer to a `CCNxPortalAttributes` instance, or NULL.
+ * @param [in] b A pointer to a `CCNxPortalAttributes` instance, or NULL.
+ *
+ * @return true The instances have the same values, or are both NULL.
+ * @return false The instances differ.
+ */
+bool ccnxPortalAttributes_Equals(const CCNxPortalAttributes *a, const CCNxPortalAttributes *b);
+
+/**
+ * Create a `PARCJSON` representation of the given attributes.
+ *
+ * @param [in] attributes A pointer to a valid `CCNxPortalAttributes` instance.
+ *
+ * @return A `PARCJSON` instance that must be released via `parcJSON_Release`.
+ */
+PARCJSON *ccnxPortalAttributes_ToJSON(const CCNxPortalAttributes *attributes);
+
 /**
  * Return `true` if the given attributes indicate Portal Logging is enabled.
  *
@@ -90,4 +188,177 @@ extern const CCNxPortalAttributes ccnxPortalAttributes_NonBlocking;
  */
 bool ccnxPortalAttributes_IsLogging(const CCNxPortalAttributes *attributes);
 
+/**
+ * Enable or disable Portal Logging.
+ *
+ * @param [in] attributes A pointer to a valid `CCNxPortalAttributes` instance.
+ * @param [in] logging `true` to enable logging.
+ */
+void ccnxPortalAttributes_SetLogging(CCNxPortalAttributes *attributes, bool logging);
+
+/**
+ * Return `true` if the given attributes indicate blocking operation.
+ *
+ * In blocking mode the Portal's file descriptor is left blocking, so that a receive waits in the kernel.
+ * In non-blocking mode the file descriptor is set non-blocking and the Portal relies on timeouts and polling.
+ *
+ * @param [in] attributes A pointer to a valid `CCNxPortalAttributes` instance.
+ *
+ * @return `true` The attributes indicate blocking operation.
+ */
+bool ccnxPortalAttributes_IsBlocking(const CCNxPortalAttributes *attributes);
+
+/**
+ * Select blocking or non-blocking operation.
+ *
+ * @param [in] attributes A pointer to a valid `CCNxPortalAttributes` instance.
+ * @param [in] blocking `true` for blocking operation.
+ */
+void ccnxPortalAttributes_SetBlocking(CCNxPortalAttributes *attributes, bool blocking);
+
+/**
+ * Get the maximum number of messages that may be queued for sending, or 0 for the Stack's default.
+ *
+ * @param [in] attributes A pointer to a valid `CCNxPortalAttributes` instance.
+ *
+ * @return The send queue limit.
+ */
+size_t ccnxPortalAttributes_GetSendQueueLimit(const CCNxPortalAttributes *attributes);
+
+/**
+ * Set the maximum number of messages that may be queued for sending, or 0 for the Stack's default.
+ *
+ * A send that would exceed the limit fails with `errno` set to `ENOBUFS`.
+ *
+ * @param [in] attributes A pointer to a valid `CCNxPortalAttributes` instance.
+ * @param [in] limit The send queue limit.
+ */
+void ccnxPortalAttributes_SetSendQueueLimit(CCNxPortalAttributes *attributes, size_t limit);
+
+/**
+ * Get the maximum number of received messages that may be queued, or 0 for the Stack's default.
+ *
+ * @param [in] attributes A pointer to a valid `CCNxPortalAttributes` instance.
+ *
+ * @return The receive queue limit.
+ */
+size_t ccnxPortalAttributes_GetReceiveQueueLimit(const CCNxPortalAttributes *attributes);
+
+/**
+ * Set the maximum number of received messages that may be queued, or 0 for the Stack's default.
+ *
+ * @param [in] attributes A pointer to a valid `CCNxPortalAttributes` instance.
+ * @param [in] limit The receive queue limit.
+ */
+void ccnxPortalAttributes_SetReceiveQueueLimit(CCNxPortalAttributes *attributes, size_t limit);
+
+/**
+ * Get the maximum number of messages processed in one batch operation.
+ *
+ * @param [in] attributes A pointer to a valid `CCNxPortalAttributes` instance.
+ *
+ * @return The maximum batch size, which is at least 1.
+ */
+size_t ccnxPortalAttributes_GetMaxBatchSize(const CCNxPortalAttributes *attributes);
+
+/**
+ * Set the maximum number of messages processed in one batch operation.
+ *
+ * @param [in] attributes A pointer to a valid `CCNxPortalAttributes` instance.
+ * @param [in] maxBatchSize The maximum batch size. A value of 0 is treated as 1.
+ */
+void ccnxPortalAttributes_SetMaxBatchSize(CCNxPortalAttributes *attributes, size_t maxBatchSize);
+
+/**
+ * Get the number of microseconds a receive spins polling for a message before it sleeps.
+ *
+ * @param [in] attributes A pointer to a valid `CCNxPortalAttributes` instance.
+ *
+ * @return The busy-poll interval in microseconds; 0 disables busy-polling.
+ */
+uint32_t ccnxPortalAttributes_GetBusyPollMicroSeconds(const CCNxPortalAttributes *attributes);
+
+/**
+ * Set the number of microseconds a receive spins polling for a message before it sleeps.
+ *
+ * Busy-polling trades CPU for latency: a message that arrives during the interval is seen without a wakeup.
+ * The spin never exceeds the receive's own timeout, and an immediate receive never spins.
+ * A spinning thread occupies its CPU, so busy-polling only helps when each polling thread has a core to itself;
+ * on an oversubscribed machine it delays the very peers it is waiting for.
+ *
+ * @param [in] attributes A pointer to a valid `CCNxPortalAttributes` instance.
+ * @param [in] microSeconds The busy-poll interval in microseconds; 0 disables busy-polling.
+ */
+void ccnxPortalAttributes_SetBusyPollMicroSeconds(CCNxPortalAttributes *attributes, uint32_t microSeconds);
+
+/**
+ * Get the CPU to which a thread busy-polling for messages is pinned.
+ *
+ * @param [in] attributes A pointer to a valid `CCNxPortalAttributes` instance.
+ *
+ * @return The CPU number, or -1 if busy-polling threads are not pinned.
+ */
+int ccnxPortalAttributes_GetBusyPollCpu(const CCNxPortalAttributes *attributes);
+
+/**
+ * Set the CPU to which a thread busy-polling for messages is pinned.
+ *
+ * Pinning changes the affinity of the receiving thread, not just of the Portal:
+ * the first busy-polling receive on a thread pins that thread to the CPU and the pinning outlasts the receive,
+ * so the thread's other work also runs on that CPU.
+ * The thread's previous affinity is restored by its next receive after the CPU is set back to -1 or busy-polling is disabled,
+ * by setting such attributes from that thread, or by releasing the Portal from that thread.
+ * A pinned thread that does none of these stays pinned.
+ * Pinning is only supported on Linux and is ignored elsewhere.
+ *
+ * @param [in] attributes A pointer to a valid `CCNxPortalAttributes` instance.
+ * @param [in] cpu The CPU number, or -1 to leave threads unpinned.
+ *
+ * Example:
+ * @code
+ * {
+ *     CCNxPortalAttributes *attributes = ccnxPortalAttributes_Copy(ccnxPortal_GetAttributes(portal));
+ *     ccnxPortalAttributes_SetBusyPollMicroSeconds(attributes, 100);
+ *     ccnxPortalAttributes_SetBusyPollCpu(attributes, 3);
+ *     ccnxPortal_SetAttributes(portal, attributes);
+ *     ccnxPortalAttributes_Release(&attributes);
+ * }
+ * @endcode
+ */
+void ccnxPortalAttributes_SetBusyPollCpu(CCNxPortalAttributes *attributes, int cpu);
+
+/**
+ * Get the requested size in bytes of the socket send buffer, or 0 for the system default.
+ *
+ * @param [in] attributes A pointer to a valid `CCNxPortalAttributes` instance.
+ *
+ * @return The socket send buffer size.
+ */
+size_t ccnxPortalAttributes_GetSocketSendBufferSize(const CCNxPortalAttributes *attributes);
+
+/**
+ * Set the requested size in bytes of the socket send buffer, or 0 for the system default.
+ *
+ * @param [in] attributes A pointer to a valid `CCNxPortalAttributes` instance.
+ * @param [in] size The socket send buffer size.
+ */
+void ccnxPortalAttributes_SetSocketSendBufferSize(CCNxPortalAttributes *attributes, size_t size);
+
+/**
+ * Get the requested size in bytes of the socket receive buffer, or 0 for the system default.
+ *
+ * @param [in] attributes A pointer to a valid `CCNxPortalAttributes` instance.
+ *
+ * @return The socket receive buffer size.
+ */
+size_t ccnxPortalAttributes_GetSocketReceiveBufferSize(const CCNxPortalAttributes *attributes);
+
+/**
+ * Set the requested size in bytes of the socket receive buffer, or 0 for the system default.
+ *
+ * @param [in] attributes A pointer to a valid `CCNxPortalAttributes` instance.
+ * @param [in] size The socket receive buffer size.
+ */
+void ccnxPortalAttributes_SetSocketReceiveBufferSize(CCNxPortalAttributes *attributes, size_t size);
+
 #endif /* defined(__CCNx_Portal_API__ccnx_PortalAttributes__) */
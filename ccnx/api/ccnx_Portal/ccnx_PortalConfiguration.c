@@ -0,0 +1,195 @@
+/*
+ * Copyright (c) 2016, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX OR PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ################################################################################
+ * #
+ * # PATENT NOTICE
+ * #
+ * # This software is distributed under the BSD 2-clause License (see LICENSE
+ * # file).  This BSD License does not make any patent claims and as such, does
+ * # not act as a patent grant.  The purpose of this section is for each contributor
+ * # to define their intentions with respect to intellectual property.
+ * #
+ * # Each contributor to this source code is encouraged to state their patent
+ * # claims and licensing mechanisms for any contributions made. At the end of
+ * # this section contributors may each make their own statements.  Contributor's
+ * # claims and grants only apply to the pieces (source code, programs, text,
+ * # media, etc) that they have contributed directly to this software.
+ * #
+ * # There is no guarantee that this section is complete, up to date or accurate. It
+ * # is up to the contributors to maintain their portion of this section and up to
+ * # the user of the software to verify any claims herein.
+ * #
+ * # Do not remove this header notification.  The contents of this section must be
+ * # present in all distributions of the software.  You may only modify your own
+ * # intellectual property statements.  Please provide contact information.
+ *
+ * - Palo Alto Research Center, Inc
+ * This software distribution does not grant any rights to patents owned by Palo
+ * Alto Research Center, Inc (PARC). Rights to these patents are available via
+ * various mechanisms. As of January 2016 PARC has committed to FRAND licensing any
+ * intellectual property used by its contributions to this software. You may
+ * contact PARC at cipo@parc.com for more information or visit http://www.ccnx.org
+ */
+/**
+ * @copyright (c) 2016, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC).  All rights reserved.
+ */
+#include <config.h>
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <LongBow/runtime.h>
+
+#include <parc/algol/parc_Object.h>
+#include <parc/algol/parc_Memory.h>
+
+#include <ccnx/api/ccnx_Portal/ccnx_PortalConfiguration.h>
+#include <ccnx/api/ccnx_Portal/ccnx_PortalFactory.h>
+
+static const char *_defaultLocalRouterName = "lci:/local/dcr";
+static const char *_defaultLocalRouterTimeout = "1000000";
+
+struct CCNxPortalConfiguration {
+    CCNxName *localRouterName;
+    CCNxName *anchorName;
+    uint64_t localRouterTimeout;
+};
+
+static void
+_ccnxPortalConfiguration_Destroy(CCNxPortalConfiguration **configurationPtr)
+{
+    CCNxPortalConfiguration *configuration = *configurationPtr;
+
+    if (configuration->localRouterName != NULL) {
+        ccnxName_Release(&configuration->localRouterName);
+    }
+    if (configuration->anchorName != NULL) {
+        ccnxName_Release(&configuration->anchorName);
+    }
+}
+
+parcObject_ExtendPARCObject(CCNxPortalConfiguration, _ccnxPortalConfiguration_Destroy, NULL, NULL, NULL, NULL, NULL, NULL);
+
+parcObject_ImplementAcquire(ccnxPortalConfiguration, CCNxPortalConfiguration);
+
+parcObject_ImplementRelease(ccnxPortalConfiguration, CCNxPortalConfiguration);
+
+/*
+ * Parse a timeout: a decimal number of microseconds, with nothing after it.
+ */
+static bool
+_ccnxPortalConfiguration_ParseTimeout(const char *value, uint64_t *timeout)
+{
+    if (*value < '0' || *value > '9') {
+        return false;
+    }
+
+    char *end;
+    errno = 0;
+    unsigned long long result = strtoull(value, &end, 10);
+    if (*end != 0 || errno == ERANGE) {
+        return false;
+    }
+
+    *timeout = (uint64_t) result;
+    return true;
+}
+
+CCNxPortalConfiguration *
+ccnxPortalConfiguration_Create(const PARCProperties *properties)
+{
+    CCNxPortalConfiguration *result = parcObject_CreateInstance(CCNxPortalConfiguration);
+    if (result == NULL) {
+        errno = ENOMEM;
+        return NULL;
+    }
+
+    result->localRouterName = NULL;
+    result->anchorName = NULL;
+    result->localRouterTimeout = 0;
+
+    const char *routerName = parcProperties_GetPropertyDefault(properties, CCNxPortalFactory_LocalRouterName, _defaultLocalRouterName);
+    const char *timeout = parcProperties_GetPropertyDefault(properties, CCNxPortalFactory_LocalRouterTimeout, _defaultLocalRouterTimeout);
+
+    result->localRouterName = ccnxName_CreateFromCString(routerName);
+    if (result->localRouterName == NULL || !_ccnxPortalConfiguration_ParseTimeout(timeout, &result->localRouterTimeout)) {
+        ccnxPortalConfiguration_Release(&result);
+        errno = EINVAL;
+        return NULL;
+    }
+
+    result->anchorName = ccnxName_ComposeNAME(result->localRouterName, "anchor");
+    if (result->anchorName == NULL) {
+        ccnxPortalConfiguration_Release(&result);
+        errno = ENOMEM;
+    }
+
+    return result;
+}
+
+bool
+ccnxPortalConfiguration_IsConfigurationProperty(const char *name)
+{
+    return strcmp(name, CCNxPortalFactory_LocalRouterName) == 0
+           || strcmp(name, CCNxPortalFactory_LocalRouterTimeout) == 0;
+}
+
+bool
+ccnxPortalConfiguration_IsValidProperty(const char *name, const char *value)
+{
+    bool result = true;
+
+    if (strcmp(name, CCNxPortalFactory_LocalRouterName) == 0) {
+        CCNxName *routerName = ccnxName_CreateFromCString(value);
+        result = (routerName != NULL);
+        if (routerName != NULL) {
+            ccnxName_Release(&routerName);
+        }
+    } else if (strcmp(name, CCNxPortalFactory_LocalRouterTimeout) == 0) {
+        uint64_t timeout;
+        result = _ccnxPortalConfiguration_ParseTimeout(value, &timeout);
+    }
+
+    return result;
+}
+
+const CCNxName *
+ccnxPortalConfiguration_GetLocalRouterName(const CCNxPortalConfiguration *configuration)
+{
+    return configuration->localRouterName;
+}
+
+const CCNxName *
+ccnxPortalConfiguration_GetAnchorName(const CCNxPortalConfiguration *configuration)
+{
+    return configuration->anchorName;
+}
+
+uint64_t
+ccnxPortalConfiguration_GetLocalRouterTimeout(const CCNxPortalConfiguration *configuration)
+{
+    return configuration->localRouterTimeout;
+}
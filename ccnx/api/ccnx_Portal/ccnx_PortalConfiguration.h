@@ -0,0 +1,236 @@
+/*
+ * Copyright (c) 2016, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX OR PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ################################################################################
+ * #
+ * # PATENT NOTICE
+ * #
+ * # This software is distributed under the BSD 2-clause License (see LICENSE
+ * # file).  This BSD License does not make any patent claims and as such, does
+ * # not act as a patent grant.  The purpose of this section is for each contributor
+ * # to define their intentions with respect to intellectual property.
+ * #
+ * # Each contributor to this source code is encouraged to state their patent
+ * # claims and licensing mechanisms for any contributions made. At the end of
+ * # this section contributors may each make their own statements.  Contributor's
+ * # claims and grants only apply to the pieces (source code, programs, text,
+ * # media, etc) that they have contributed directly to this software.
+ * #
+ * # There is no guarantee that this section is complete, up to date or accurate. It
+ * # is up to the contributors to maintain their portion of this section and up to
+ * # the user of the software to verify any claims herein.
+ * #
+ * # Do not remove this header notification.  The contents of this section must be
+ * # present in all distributions of the software.  You may only modify your own
+ * # intellectual property statements.  Please provide contact information.
+ *
+ * - Palo Alto Research Center, Inc
+ * This software distribution does not grant any rights to patents owned by Palo
+ * Alto Research Center, Inc (PARC). Rights to these patents are available via
+ * various mechanisms. As of January 2016 PARC has committed to FRAND licensing any
+ * intellectual property used by its contributions to this software. You may
+ * contact PARC at cipo@parc.com for more information or visit http://www.ccnx.org
+ */
+/**
+ * @file ccnx_PortalConfiguration.h
+ * @brief A typed, pre-parsed snapshot of the `CCNxPortalFactory` properties used on hot paths.
+ *
+ * Factory properties are strings, looked up by name.
+ * A `CCNxPortalConfiguration` holds the values of the well-known properties already converted to the types
+ * the Portal uses: the local router name as a `CCNxName`, together with the anchor name composed from it,
+ * and the local router timeout as an integer.
+ *
+ * The factory rebuilds its configuration when `ccnxPortalFactory_SetProperty` changes one of these properties.
+ * A configuration is immutable once created.
+ *
+ * @copyright (c) 2016, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC).  All rights reserved.
+ */
+#ifndef CCNx_Portal_API_ccnx_PortalConfiguration_h
+#define CCNx_Portal_API_ccnx_PortalConfiguration_h
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include <parc/algol/parc_Properties.h>
+
+#include <ccnx/common/ccnx_Name.h>
+
+struct CCNxPortalConfiguration;
+/**
+ * @typedef CCNxPortalConfiguration
+ * @brief A typed snapshot of the well-known `CCNxPortalFactory` properties.
+ */
+typedef struct CCNxPortalConfiguration CCNxPortalConfiguration;
+
+/**
+ * Create a `CCNxPortalConfiguration` from the given properties.
+ *
+ * Missing values are replaced by their defaults:
+ * `lci:/local/dcr` for the local router name and 1000000 microseconds for the local router timeout.
+ *
+ * @param [in] properties A pointer to a valid `PARCProperties` instance.
+ *
+ * @return non-NULL A pointer to a valid `CCNxPortalConfiguration` instance.
+ * @return NULL An error occurred, and errno is set: EINVAL if a value is malformed
+ *              (see `ccnxPortalConfiguration_IsValidProperty`), or ENOMEM if memory could not be allocated.
+ *
+ * Example:
+ * @code
+ * {
+ *     CCNxPortalConfiguration *configuration = ccnxPortalConfiguration_Create(ccnxPortalFactory_GetProperties(factory));
+ *
+ *     ccnxPortalConfiguration_Release(&configuration);
+ * }
+ * @endcode
+ */
+CCNxPortalConfiguration *ccnxPortalConfiguration_Create(const PARCProperties *properties);
+
+/**
+ * Increase the number of references to a `CCNxPortalConfiguration` instance.
+ *
+ * @param [in] configuration A pointer to a valid `CCNxPortalConfiguration` instance.
+ *
+ * @return The same value as @p configuration.
+ *
+ * Example:
+ * @code
+ * {
+ *     CCNxPortalConfiguration *reference = ccnxPortalConfiguration_Acquire(ccnxPortalFactory_GetConfiguration(factory));
+ *
+ *     ccnxPortalConfiguration_Release(&reference);
+ * }
+ * @endcode
+ */
+CCNxPortalConfiguration *ccnxPortalConfiguration_Acquire(const CCNxPortalConfiguration *configuration);
+
+/**
+ * Release a previously acquired reference to the given `CCNxPortalConfiguration` instance,
+ * decrementing the reference count for the instance.
+ *
+ * The pointer to the instance is set to NULL as a side-effect of this function.
+ *
+ * @param [in,out] configurationPtr A pointer to a pointer to the instance to release.
+ *
+ * Example:
+ * @code
+ * {
+ *     CCNxPortalConfiguration *configuration = ccnxPortalConfiguration_Create(properties);
+ *
+ *     ccnxPortalConfiguration_Release(&configuration);
+ * }
+ * @endcode
+ */
+void ccnxPortalConfiguration_Release(CCNxPortalConfiguration **configurationPtr);
+
+/**
+ * Determine if the named property is one held, converted, in a `CCNxPortalConfiguration`.
+ *
+ * @param [in] name The name of a property.
+ *
+ * @return true A configuration must be rebuilt when the property changes.
+ * @return false The property is not part of a configuration.
+ *
+ * Example:
+ * @code
+ * {
+ *     if (ccnxPortalConfiguration_IsConfigurationProperty(CCNxPortalFactory_LocalRouterName)) {
+ *         printf("The local router name is pre-parsed.\n");
+ *     }
+ * }
+ * @endcode
+ */
+bool ccnxPortalConfiguration_IsConfigurationProperty(const char *name);
+
+/**
+ * Determine if the given value is valid for the named property.
+ *
+ * The local router name must be an LCI name, and the local router timeout a decimal number of microseconds.
+ * Any value is valid for a property that is not part of a configuration.
+ *
+ * @param [in] name The name of a property.
+ * @param [in] value The value of the property.
+ *
+ * @return true The value may be used.
+ * @return false The value is malformed.
+ *
+ * Example:
+ * @code
+ * {
+ *     if (!ccnxPortalConfiguration_IsValidProperty(CCNxPortalFactory_LocalRouterTimeout, "1 second")) {
+ *         printf("The timeout must be a number of microseconds.\n");
+ *     }
+ * }
+ * @endcode
+ */
+bool ccnxPortalConfiguration_IsValidProperty(const char *name, const char *value);
+
+/**
+ * Get the name of the local router.
+ *
+ * @param [in] configuration A pointer to a valid `CCNxPortalConfiguration` instance.
+ *
+ * @return A pointer to a `CCNxName`, valid for the lifetime of @p configuration.
+ *
+ * Example:
+ * @code
+ * {
+ *     const CCNxName *router = ccnxPortalConfiguration_GetLocalRouterName(configuration);
+ * }
+ * @endcode
+ */
+const CCNxName *ccnxPortalConfiguration_GetLocalRouterName(const CCNxPortalConfiguration *configuration);
+
+/**
+ * Get the name to which anchor requests are sent: the local router name followed by the segment `anchor`.
+ *
+ * @param [in] configuration A pointer to a valid `CCNxPortalConfiguration` instance.
+ *
+ * @return A pointer to a `CCNxName`, valid for the lifetime of @p configuration.
+ *
+ * Example:
+ * @code
+ * {
+ *     CCNxInterest *interest = ccnxInterest_CreateSimple(ccnxPortalConfiguration_GetAnchorName(configuration));
+ * }
+ * @endcode
+ */
+const CCNxName *ccnxPortalConfiguration_GetAnchorName(const CCNxPortalConfiguration *configuration);
+
+/**
+ * Get the time to wait for a response from the local router, in microseconds.
+ *
+ * @param [in] configuration A pointer to a valid `CCNxPortalConfiguration` instance.
+ *
+ * @return The local router timeout in microseconds.
+ *
+ * Example:
+ * @code
+ * {
+ *     uint64_t timeout = ccnxPortalConfiguration_GetLocalRouterTimeout(configuration);
+ *     ccnxPortal_Send(portal, message, CCNxStackTimeout_MicroSeconds(timeout));
+ * }
+ * @endcode
+ */
+uint64_t ccnxPortalConfiguration_GetLocalRouterTimeout(const CCNxPortalConfiguration *configuration);
+#endif // CCNx_Portal_API_ccnx_PortalConfiguration_h
@@ -0,0 +1,422 @@
+/*
+ * Copyright (c) 2016, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX OR PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ################################################################################
+ * #
+ * # PATENT NOTICE
+ * #
+ * # This software is distributed under the BSD 2-clause License (see LICENSE
+ * # file).  This BSD License does not make any patent claims and as such, does
+ * # not act as a patent grant.  The purpose of this section is for each contributor
+ * # to define their intentions with respect to intellectual property.
+ * #
+ * # Each contributor to this source code is encouraged to state their patent
+ * # claims and licensing mechanisms for any contributions made. At the end of
+ * # this section contributors may each make their own statements.  Contributor's
+ * # claims and grants only apply to the pieces (source code, programs, text,
+ * # media, etc) that they have contributed directly to this software.
+ * #
+ * # There is no guarantee that this section is complete, up to date or accurate. It
+ * # is up to the contributors to maintain their portion of this section and up to
+ * # the user of the software to verify any claims herein.
+ * #
+ * # Do not remove this header notification.  The contents of this section must be
+ * # present in all distributions of the software.  You may only modify your own
+ * # intellectual property statements.  Please provide contact information.
+ *
+ * - Palo Alto Research Center, Inc
+ * This software distribution does not grant any rights to patents owned by Palo
+ * Alto Research Center, Inc (PARC). Rights to these patents are available via
+ * various mechanisms. As of January 2016 PARC has committed to FRAND licensing any
+ * intellectual property used by its contributions to this software. You may
+ * contact PARC at cipo@parc.com for more information or visit http://www.ccnx.org
+ */
+/**
+ * @copyright (c) 2016, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC).  All rights reserved.
+ */
+#include <config.h>
+
+#include <errno.h>
+#include <pthread.h>
+
+#include <LongBow/runtime.h>
+
+#include <parc/algol/parc_Object.h>
+#include <parc/algol/parc_Memory.h>
+
+#include <ccnx/api/ccnx_Portal/ccnx_PortalExecutor.h>
+
+typedef struct {
+    CCNxPortalExecutorTask *task;
+    void *argument;
+} _CCNxPortalExecutorEntry;
+
+/*
+ * A bounded double-ended queue of tasks, as a ring. The count is also read without the lock, to skip empty queues.
+ */
+typedef struct {
+    pthread_mutex_t lock;
+    _CCNxPortalExecutorEntry *entries;
+    size_t capacity;
+    size_t head;
+    size_t count;
+} _CCNxPortalExecutorQueue;
+
+typedef struct {
+    CCNxPortalExecutor *executor;
+    size_t index;
+    bool started;
+    pthread_t thread;
+    _CCNxPortalExecutorQueue queue;
+} _CCNxPortalExecutorWorker;
+
+struct CCNxPortalExecutor {
+    _CCNxPortalExecutorWorker *workers;
+    size_t workerCount;
+    size_t nextWorker;
+
+    // Idle workers wait for work, and Wait waits for the pending count to reach 0, under the lock.
+    pthread_mutex_t lock;
+    pthread_cond_t workAvailable;
+    pthread_cond_t allDone;
+    bool stopping;
+
+    size_t idleWorkers;
+    size_t queued;       // Never less than the number of tasks in the queues.
+    size_t pending;      // The tasks submitted and not yet finished.
+
+    uint64_t completed;
+    uint64_t stolen;
+    uint64_t shed;
+};
+
+// The worker running on the current thread, if it is one.
+static __thread _CCNxPortalExecutorWorker *_ccnxPortalExecutor_CurrentWorker;
+
+static bool
+_ccnxPortalExecutorQueue_Init(_CCNxPortalExecutorQueue *queue, size_t capacity)
+{
+    queue->entries = parcMemory_Allocate(capacity * sizeof(_CCNxPortalExecutorEntry));
+    if (queue->entries == NULL) {
+        return false;
+    }
+    queue->capacity = capacity;
+    queue->head = 0;
+    queue->count = 0;
+    pthread_mutex_init(&queue->lock, NULL);
+    return true;
+}
+
+static void
+_ccnxPortalExecutorQueue_Fini(_CCNxPortalExecutorQueue *queue)
+{
+    if (queue->entries != NULL) {
+        pthread_mutex_destroy(&queue->lock);
+        parcMemory_Deallocate(&queue->entries);
+    }
+}
+
+static bool
+_ccnxPortalExecutorQueue_PushBack(_CCNxPortalExecutorQueue *queue, const _CCNxPortalExecutorEntry *entry)
+{
+    bool result = false;
+
+    pthread_mutex_lock(&queue->lock);
+    if (queue->count < queue->capacity) {
+        queue->entries[(queue->head + queue->count) % queue->capacity] = *entry;
+        __atomic_store_n(&queue->count, queue->count + 1, __ATOMIC_RELAXED);
+        result = true;
+    }
+    pthread_mutex_unlock(&queue->lock);
+
+    return result;
+}
+
+static bool
+_ccnxPortalExecutorQueue_PopFront(_CCNxPortalExecutorQueue *queue, _CCNxPortalExecutorEntry *entry)
+{
+    bool result = false;
+
+    pthread_mutex_lock(&queue->lock);
+    if (queue->count > 0) {
+        *entry = queue->entries[queue->head];
+        queue->head = (queue->head + 1) % queue->capacity;
+        __atomic_store_n(&queue->count, queue->count - 1, __ATOMIC_RELAXED);
+        result = true;
+    }
+    pthread_mutex_unlock(&queue->lock);
+
+    return result;
+}
+
+static bool
+_ccnxPortalExecutorQueue_PopBack(_CCNxPortalExecutorQueue *queue, _CCNxPortalExecutorEntry *entry)
+{
+    if (__atomic_load_n(&queue->count, __ATOMIC_RELAXED) == 0) {
+        return false;
+    }
+
+    bool result = false;
+
+    pthread_mutex_lock(&queue->lock);
+    if (queue->count > 0) {
+        *entry = queue->entries[(queue->head + queue->count - 1) % queue->capacity];
+        __atomic_store_n(&queue->count, queue->count - 1, __ATOMIC_RELAXED);
+        result = true;
+    }
+    pthread_mutex_unlock(&queue->lock);
+
+    return result;
+}
+
+/*
+ * Take the newest task from the first other worker, in order after the given one, that has any.
+ */
+static bool
+_ccnxPortalExecutor_Steal(CCNxPortalExecutor *executor, const _CCNxPortalExecutorWorker *thief, _CCNxPortalExecutorEntry *entry)
+{
+    for (size_t i = 1; i < executor->workerCount; i++) {
+        _CCNxPortalExecutorWorker *victim = &executor->workers[(thief->index + i) % executor->workerCount];
+        if (_ccnxPortalExecutorQueue_PopBack(&victim->queue, entry)) {
+            __atomic_fetch_add(&executor->stolen, 1, __ATOMIC_RELAXED);
+            return true;
+        }
+    }
+    return false;
+}
+
+static void
+_ccnxPortalExecutor_Finish(CCNxPortalExecutor *executor)
+{
+    if (__atomic_sub_fetch(&executor->pending, 1, __ATOMIC_SEQ_CST) == 0) {
+        pthread_mutex_lock(&executor->lock);
+        pthread_cond_broadcast(&executor->allDone);
+        pthread_mutex_unlock(&executor->lock);
+    }
+}
+
+static void *
+_ccnxPortalExecutor_Run(void *argument)
+{
+    _CCNxPortalExecutorWorker *worker = argument;
+    CCNxPortalExecutor *executor = worker->executor;
+    _ccnxPortalExecutor_CurrentWorker = worker;
+
+    while (true) {
+        _CCNxPortalExecutorEntry entry;
+        if (_ccnxPortalExecutorQueue_PopFront(&worker->queue, &entry) || _ccnxPortalExecutor_Steal(executor, worker, &entry)) {
+            __atomic_sub_fetch(&executor->queued, 1, __ATOMIC_SEQ_CST);
+            entry.task(entry.argument);
+            __atomic_fetch_add(&executor->completed, 1, __ATOMIC_RELAXED);
+            _ccnxPortalExecutor_Finish(executor);
+            continue;
+        }
+
+        // A submitter increments the queued count before it reads the idle count, and this is the reverse,
+        // so either this worker sees the task or the submitter sees this worker is idle and signals it.
+        pthread_mutex_lock(&executor->lock);
+        __atomic_add_fetch(&executor->idleWorkers, 1, __ATOMIC_SEQ_CST);
+        while (__atomic_load_n(&executor->queued, __ATOMIC_SEQ_CST) == 0 && !executor->stopping) {
+            pthread_cond_wait(&executor->workAvailable, &executor->lock);
+        }
+        __atomic_sub_fetch(&executor->idleWorkers, 1, __ATOMIC_SEQ_CST);
+        bool finished = executor->stopping && __atomic_load_n(&executor->queued, __ATOMIC_SEQ_CST) == 0;
+        pthread_mutex_unlock(&executor->lock);
+
+        if (finished) {
+            break;
+        }
+    }
+
+    return NULL;
+}
+
+static void
+_ccnxPortalExecutor_Destroy(CCNxPortalExecutor **executorPtr)
+{
+    CCNxPortalExecutor *executor = *executorPtr;
+
+    pthread_mutex_lock(&executor->lock);
+    executor->stopping = true;
+    pthread_cond_broadcast(&executor->workAvailable);
+    pthread_mutex_unlock(&executor->lock);
+
+    if (executor->workers != NULL) {
+        for (size_t i = 0; i < executor->workerCount; i++) {
+            if (executor->workers[i].started) {
+                pthread_join(executor->workers[i].thread, NULL);
+            }
+        }
+        for (size_t i = 0; i < executor->workerCount; i++) {
+            _ccnxPortalExecutorQueue_Fini(&executor->workers[i].queue);
+        }
+        parcMemory_Deallocate(&executor->workers);
+    }
+
+    pthread_cond_destroy(&executor->allDone);
+    pthread_cond_destroy(&executor->workAvailable);
+    pthread_mutex_destroy(&executor->lock);
+}
+
+parcObject_ExtendPARCObject(CCNxPortalExecutor, _ccnxPortalExecutor_Destroy, NULL, NULL, NULL, NULL, NULL, NULL);
+
+parcObject_ImplementAcquire(ccnxPortalExecutor, CCNxPortalExecutor);
+
+parcObject_ImplementRelease(ccnxPortalExecutor, CCNxPortalExecutor);
+
+CCNxPortalExecutor *
+ccnxPortalExecutor_Create(size_t workerCount, size_t queueCapacity)
+{
+    if (workerCount == 0 || queueCapacity == 0) {
+        errno = EINVAL;
+        return NULL;
+    }
+
+    CCNxPortalExecutor *result = parcObject_CreateInstance(CCNxPortalExecutor);
+    if (result == NULL) {
+        errno = ENOMEM;
+        return NULL;
+    }
+
+    pthread_mutex_init(&result->lock, NULL);
+    pthread_cond_init(&result->workAvailable, NULL);
+    pthread_cond_init(&result->allDone, NULL);
+    result->stopping = false;
+    result->nextWorker = 0;
+    result->idleWorkers = 0;
+    result->queued = 0;
+    result->pending = 0;
+    result->completed = 0;
+    result->stolen = 0;
+    result->shed = 0;
+
+    result->workerCount = workerCount;
+    result->workers = parcMemory_AllocateAndClear(workerCount * sizeof(_CCNxPortalExecutorWorker));
+    if (result->workers == NULL) {
+        ccnxPortalExecutor_Release(&result);
+        errno = ENOMEM;
+        return NULL;
+    }
+
+    for (size_t i = 0; i < workerCount; i++) {
+        _CCNxPortalExecutorWorker *worker = &result->workers[i];
+        worker->executor = result;
+        worker->index = i;
+        if (_ccnxPortalExecutorQueue_Init(&worker->queue, queueCapacity) == false) {
+            ccnxPortalExecutor_Release(&result);
+            errno = ENOMEM;
+            return NULL;
+        }
+    }
+
+    for (size_t i = 0; i < workerCount; i++) {
+        _CCNxPortalExecutorWorker *worker = &result->workers[i];
+        int error = pthread_create(&worker->thread, NULL, _ccnxPortalExecutor_Run, worker);
+        if (error != 0) {
+            ccnxPortalExecutor_Release(&result);
+            errno = error;
+            return NULL;
+        }
+        worker->started = true;
+    }
+
+    return result;
+}
+
+bool
+ccnxPortalExecutor_Submit(CCNxPortalExecutor *executor, CCNxPortalExecutorTask *task, void *argument)
+{
+    _CCNxPortalExecutorEntry entry = { .task = task, .argument = argument };
+
+    // A task submitting another keeps it on its own worker; other submitters spread tasks over the workers.
+    size_t start;
+    _CCNxPortalExecutorWorker *current = _ccnxPortalExecutor_CurrentWorker;
+    if (current != NULL && current->executor == executor) {
+        start = current->index;
+    } else {
+        start = __atomic_fetch_add(&executor->nextWorker, 1, __ATOMIC_RELAXED) % executor->workerCount;
+    }
+
+    __atomic_add_fetch(&executor->pending, 1, __ATOMIC_SEQ_CST);
+    __atomic_add_fetch(&executor->queued, 1, __ATOMIC_SEQ_CST);
+
+    for (size_t i = 0; i < executor->workerCount; i++) {
+        _CCNxPortalExecutorWorker *worker = &executor->workers[(start + i) % executor->workerCount];
+        if (_ccnxPortalExecutorQueue_PushBack(&worker->queue, &entry)) {
+            if (__atomic_load_n(&executor->idleWorkers, __ATOMIC_SEQ_CST) > 0) {
+                pthread_mutex_lock(&executor->lock);
+                pthread_cond_signal(&executor->workAvailable);
+                pthread_mutex_unlock(&executor->lock);
+            }
+            return true;
+        }
+    }
+
+    __atomic_sub_fetch(&executor->queued, 1, __ATOMIC_SEQ_CST);
+    __atomic_fetch_add(&executor->shed, 1, __ATOMIC_RELAXED);
+    _ccnxPortalExecutor_Finish(executor);
+
+    errno = EBUSY;
+    return false;
+}
+
+void
+ccnxPortalExecutor_Wait(CCNxPortalExecutor *executor)
+{
+    pthread_mutex_lock(&executor->lock);
+    while (__atomic_load_n(&executor->pending, __ATOMIC_SEQ_CST) > 0) {
+        pthread_cond_wait(&executor->allDone, &executor->lock);
+    }
+    pthread_mutex_unlock(&executor->lock);
+}
+
+size_t
+ccnxPortalExecutor_GetPendingCount(const CCNxPortalExecutor *executor)
+{
+    return __atomic_load_n(&executor->pending, __ATOMIC_SEQ_CST);
+}
+
+size_t
+ccnxPortalExecutor_GetWorkerCount(const CCNxPortalExecutor *executor)
+{
+    return executor->workerCount;
+}
+
+uint64_t
+ccnxPortalExecutor_GetCompletedCount(const CCNxPortalExecutor *executor)
+{
+    return __atomic_load_n(&executor->completed, __ATOMIC_RELAXED);
+}
+
+uint64_t
+ccnxPortalExecutor_GetStolenCount(const CCNxPortalExecutor *executor)
+{
+    return __atomic_load_n(&executor->stolen, __ATOMIC_RELAXED);
+}
+
+uint64_t
+ccnxPortalExecutor_GetShedCount(const CCNxPortalExecutor *executor)
+{
+    return __atomic_load_n(&executor->shed, __ATOMIC_RELAXED);
+}
@@ -0,0 +1,230 @@
+/*
+ * Copyright (c) 2016, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX OR PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ################################################################################
+ * #
+ * # PATENT NOTICE
+ * #
+ * # This software is distributed under the BSD 2-clause License (see LICENSE
+ * # file).  This BSD License does not make any patent claims and as such, does
+ * # not act as a patent grant.  The purpose of this section is for each contributor
+ * # to define their intentions with respect to intellectual property.
+ * #
+ * # Each contributor to this source code is encouraged to state their patent
+ * # claims and licensing mechanisms for any contributions made. At the end of
+ * # this section contributors may each make their own statements.  Contributor's
+ * # claims and grants only apply to the pieces (source code, programs, text,
+ * # media, etc) that they have contributed directly to this software.
+ * #
+ * # There is no guarantee that this section is complete, up to date or accurate. It
+ * # is up to the contributors to maintain their portion of this section and up to
+ * # the user of the software to verify any claims herein.
+ * #
+ * # Do not remove this header notification.  The contents of this section must be
+ * # present in all distributions of the software.  You may only modify your own
+ * # intellectual property statements.  Please provide contact information.
+ *
+ * - Palo Alto Research Center, Inc
+ * This software distribution does not grant any rights to patents owned by Palo
+ * Alto Research Center, Inc (PARC). Rights to these patents are available via
+ * various mechanisms. As of January 2016 PARC has committed to FRAND licensing any
+ * intellectual property used by its contributions to this software. You may
+ * contact PARC at cipo@parc.com for more information or visit http://www.ccnx.org
+ */
+/**
+ * @file ccnx_PortalExecutor.h
+ * @brief A pool of worker threads that run tasks from per-worker queues, stealing from each other when idle.
+ *
+ * Each worker has its own bounded double-ended queue.
+ * Tasks submitted from outside the executor are spread over the workers' queues in turn,
+ * and tasks submitted by a task go to its own worker's queue.
+ * A worker takes tasks from the front of its own queue, oldest first,
+ * and once its queue is empty steals the newest task from the back of another worker's queue,
+ * so one slow task holds up only its own worker, and submitters and workers rarely contend for the same lock.
+ *
+ * When every queue is full, a submitted task is refused rather than queued, and counted as shed:
+ * a saturated server drops new work, which its clients retransmit, instead of building an ever longer backlog.
+ *
+ * An executor is thread-safe.
+ *
+ * @copyright (c) 2016, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC).  All rights reserved.
+ */
+#ifndef CCNx_Portal_API_ccnx_PortalExecutor_h
+#define CCNx_Portal_API_ccnx_PortalExecutor_h
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+struct CCNxPortalExecutor;
+/**
+ * @typedef CCNxPortalExecutor
+ * @brief A pool of worker threads with work-stealing task queues.
+ */
+typedef struct CCNxPortalExecutor CCNxPortalExecutor;
+
+/**
+ * A task run by a worker thread.
+ *
+ * @param [in] argument The argument given when the task was submitted.
+ */
+typedef void (CCNxPortalExecutorTask)(void *argument);
+
+/**
+ * Create a new `CCNxPortalExecutor` and start its worker threads.
+ *
+ * @param [in] workerCount The number of worker threads.
+ * @param [in] queueCapacity The number of tasks each worker's queue holds.
+ *
+ * @return non-NULL A pointer to a valid `CCNxPortalExecutor` instance.
+ * @return NULL An error occurred, and errno is set: EINVAL if either count is 0,
+ *              ENOMEM if memory could not be allocated, or the error starting a thread.
+ *
+ * Example:
+ * @code
+ * {
+ *     CCNxPortalExecutor *executor = ccnxPortalExecutor_Create(4, 256);
+ *
+ *     ccnxPortalExecutor_Release(&executor);
+ * }
+ * @endcode
+ */
+CCNxPortalExecutor *ccnxPortalExecutor_Create(size_t workerCount, size_t queueCapacity);
+
+/**
+ * Increase the number of references to a `CCNxPortalExecutor` instance.
+ *
+ * @param [in] executor A pointer to a valid `CCNxPortalExecutor` instance.
+ *
+ * @return The same value as @p executor.
+ *
+ * Example:
+ * @code
+ * {
+ *     CCNxPortalExecutor *executor = ccnxPortalExecutor_Create(4, 256);
+ *     CCNxPortalExecutor *reference = ccnxPortalExecutor_Acquire(executor);
+ *
+ *     ccnxPortalExecutor_Release(&executor);
+ *     ccnxPortalExecutor_Release(&reference);
+ * }
+ * @endcode
+ */
+CCNxPortalExecutor *ccnxPortalExecutor_Acquire(const CCNxPortalExecutor *executor);
+
+/**
+ * Release a previously acquired reference to the given `CCNxPortalExecutor` instance,
+ * decrementing the reference count for the instance.
+ *
+ * The pointer to the instance is set to NULL as a side-effect of this function.
+ * When the last reference is released, the tasks already queued are run, and the worker threads then stopped.
+ * The last reference must not be released by a task.
+ *
+ * @param [in,out] executorPtr A pointer to a pointer to the instance to release.
+ *
+ * Example:
+ * @code
+ * {
+ *     CCNxPortalExecutor *executor = ccnxPortalExecutor_Create(4, 256);
+ *
+ *     ccnxPortalExecutor_Release(&executor);
+ * }
+ * @endcode
+ */
+void ccnxPortalExecutor_Release(CCNxPortalExecutor **executorPtr);
+
+/**
+ * Queue a task to be run by one of the executor's worker threads.
+ *
+ * @param [in] executor A pointer to a valid `CCNxPortalExecutor` instance.
+ * @param [in] task The function to run.
+ * @param [in] argument The argument passed to @p task.
+ *
+ * @return true The task was queued.
+ * @return false Every worker's queue was full, and errno is set to EBUSY. The task is counted as shed.
+ *
+ * Example:
+ * @code
+ * {
+ *     if (ccnxPortalExecutor_Submit(executor, runRequest, request) == false) {
+ *         releaseRequest(request);
+ *     }
+ * }
+ * @endcode
+ */
+bool ccnxPortalExecutor_Submit(CCNxPortalExecutor *executor, CCNxPortalExecutorTask *task, void *argument);
+
+/**
+ * Wait until every task submitted so far, and every task they submit, has been run.
+ *
+ * This must not be called by a task.
+ *
+ * @param [in] executor A pointer to a valid `CCNxPortalExecutor` instance.
+ */
+void ccnxPortalExecutor_Wait(CCNxPortalExecutor *executor);
+
+/**
+ * Get the number of tasks queued or running.
+ *
+ * @param [in] executor A pointer to a valid `CCNxPortalExecutor` instance.
+ *
+ * @return The number of tasks submitted and not yet finished.
+ */
+size_t ccnxPortalExecutor_GetPendingCount(const CCNxPortalExecutor *executor);
+
+/**
+ * Get the number of worker threads.
+ *
+ * @param [in] executor A pointer to a valid `CCNxPortalExecutor` instance.
+ *
+ * @return The number of worker threads.
+ */
+size_t ccnxPortalExecutor_GetWorkerCount(const CCNxPortalExecutor *executor);
+
+/**
+ * Get the number of tasks the executor has run.
+ *
+ * @param [in] executor A pointer to a valid `CCNxPortalExecutor` instance.
+ *
+ * @return The number of tasks run.
+ */
+uint64_t ccnxPortalExecutor_GetCompletedCount(const CCNxPortalExecutor *executor);
+
+/**
+ * Get the number of tasks a worker took from another worker's queue.
+ *
+ * @param [in] executor A pointer to a valid `CCNxPortalExecutor` instance.
+ *
+ * @return The number of tasks stolen.
+ */
+uint64_t ccnxPortalExecutor_GetStolenCount(const CCNxPortalExecutor *executor);
+
+/**
+ * Get the number of tasks refused because every worker's queue was full.
+ *
+ * @param [in] executor A pointer to a valid `CCNxPortalExecutor` instance.
+ *
+ * @return The number of tasks shed.
+ */
+uint64_t ccnxPortalExecutor_GetShedCount(const CCNxPortalExecutor *executor);
+#endif // CCNx_Portal_API_ccnx_PortalExecutor_h
@@ -64,10 +64,12 @@
 #include <fcntl.h>
 #include <unistd.h>
 #include <pthread.h>
+#include <string.h>
 
 #include <ccnx/api/ccnx_Portal/ccnx_PortalFactory.h>
 
 #include <parc/algol/parc_Object.h>
+#include <parc/algol/parc_Memory.h>
 #include <parc/algol/parc_List.h>
 #include <parc/algol/parc_ArrayList.h>
 #include <parc/algol/parc_DisplayIndented.h>
@@ -83,8 +85,9 @@ struct CCNxPortalFactory {
     const PARCIdentity *identity;
     const PARCSigner *signer;
     const PARCKeyId *keyId;
-    const CCNxPortalAttributes *attributeTemplate;
+    CCNxPortalAttributes *attributeTemplate;
     PARCProperties *properties;
+    CCNxPortalConfiguration *configuration;
 };
 
 static void
@@ -100,6 +103,14 @@ _ccnxPortalFactory_Destroy(CCNxPortalFactory **factoryPtr)
 
     parcProperties_Release(&factory->properties);
 
+    if (factory->configuration != NULL) {
+        ccnxPortalConfiguration_Release(&factory->configuration);
+    }
+
+    if (factory->attributeTemplate != NULL) {
+        ccnxPortalAttributes_Release(&factory->attributeTemplate);
+    }
+
     parcSecurity_Fini();
 }
 
@@ -121,10 +132,18 @@ ccnxPortalFactory_Create(const PARCIdentity *identity)
         result->signer = parcIdentity_CreateSigner(identity);
         result->keyId = parcSigner_CreateKeyId(result->signer);
         result->properties = parcProperties_Create();
+        result->attributeTemplate = ccnxPortalAttributes_Create();
 
-        ccnxPortalFactory_SetProperty(result, CCNxPortalFactory_LocalRouterName, "lci:/local/dcr");
-        ccnxPortalFactory_SetProperty(result, CCNxPortalFactory_LocalForwarder, "tcp://127.0.0.1:9695");
-        ccnxPortalFactory_SetProperty(result, CCNxPortalFactory_LocalRouterTimeout, "1000000");
+        parcProperties_SetProperty(result->properties, CCNxPortalFactory_LocalRouterName, "lci:/local/dcr");
+        parcProperties_SetProperty(result->properties, CCNxPortalFactory_LocalForwarder, "tcp://127.0.0.1:9695");
+        parcProperties_SetProperty(result->properties, CCNxPortalFactory_LocalRouterTimeout, "1000000");
+        result->configuration = ccnxPortalConfiguration_Create(result->properties);
+
+        if (result->configuration == NULL || result->attributeTemplate == NULL) {
+            int error = (errno != 0) ? errno : ENOMEM;
+            ccnxPortalFactory_Release(&result);
+            errno = error;
+        }
     }
     return result;
 }
@@ -152,10 +171,28 @@ ccnxPortalFactory_Display(const CCNxPortalFactory *factory, int indentation)
     parcDisplayIndented_PrintLine(indentation, "}");
 }
 
+void
+ccnxPortalFactory_SetAttributes(CCNxPortalFactory *factory, const CCNxPortalAttributes *attributes)
+{
+    CCNxPortalAttributes *copy = ccnxPortalAttributes_Copy(attributes);
+    if (copy != NULL) {
+        if (factory->attributeTemplate != NULL) {
+            ccnxPortalAttributes_Release(&factory->attributeTemplate);
+        }
+        factory->attributeTemplate = copy;
+    }
+}
+
+const CCNxPortalAttributes *
+ccnxPortalFactory_GetAttributes(const CCNxPortalFactory *factory)
+{
+    return factory->attributeTemplate;
+}
+
 CCNxPortal *
 ccnxPortalFactory_CreatePortal(const CCNxPortalFactory *factory, CCNxStackImpl *stackImplementation)
 {
-    return stackImplementation(factory, &ccnxPortalAttributes_NonBlocking);
+    return stackImplementation(factory, ccnxPortalFactory_GetAttributes(factory));
 }
 
 PARCProperties *
@@ -170,8 +207,50 @@ ccnxPortalFactory_GetProperty(const CCNxPortalFactory *factory, const char *rest
     return parcProperties_GetPropertyDefault(factory->properties, name, defaultValue);
 }
 
-void
+bool
 ccnxPortalFactory_SetProperty(const CCNxPortalFactory *factory, const char *restrict name, const char *restrict value)
 {
+    if (!ccnxPortalConfiguration_IsValidProperty(name, value)) {
+        errno = EINVAL;
+        return false;
+    }
+
+    // The configuration properties always have a value, set when the factory is created.
+    const char *current = parcProperties_GetProperty(factory->properties, name);
+    if (!ccnxPortalConfiguration_IsConfigurationProperty(name) || strcmp(current, value) == 0) {
+        parcProperties_SetProperty(factory->properties, name, value);
+        return true;
+    }
+
+    // Keep the current value, to restore it if the configuration cannot be rebuilt.
+    char *previous = parcMemory_StringDuplicate(current, strlen(current));
+    if (previous == NULL) {
+        errno = ENOMEM;
+        return false;
+    }
+
     parcProperties_SetProperty(factory->properties, name, value);
+
+    // Stacks hold their own reference to the configuration they were created with, so releasing this one is safe.
+    CCNxPortalConfiguration *configuration = ccnxPortalConfiguration_Create(factory->properties);
+    if (configuration == NULL) {
+        int error = errno;
+        parcProperties_SetProperty(factory->properties, name, previous);
+        parcMemory_Deallocate(&previous);
+        errno = error;
+        return false;
+    }
+    parcMemory_Deallocate(&previous);
+
+    CCNxPortalFactory *mutableFactory = (CCNxPortalFactory *) factory;
+    ccnxPortalConfiguration_Release(&mutableFactory->configuration);
+    mutableFactory->configuration = configuration;
+
+    return true;
+}
+
+const CCNxPortalConfiguration *
+ccnxPortalFactory_GetConfiguration(const CCNxPortalFactory *factory)
+{
+    return factory->configuration;
 }
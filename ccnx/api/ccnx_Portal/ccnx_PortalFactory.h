@@ -76,6 +76,7 @@ typedef struct CCNxPortalFactory CCNxPortalFactory;
 #include <ccnx/transport/common/transport.h>
 #include <ccnx/transport/common/transport_MetaMessage.h>
 #include <ccnx/api/ccnx_Portal/ccnx_Portal.h>
+#include <ccnx/api/ccnx_Portal/ccnx_PortalConfiguration.h>
 
 extern const char *CCNxPortalFactory_LocalRouterName;
 extern const char *CCNxPortalFactory_LocalForwarder;
@@ -97,7 +98,7 @@ extern const char *CCNxPortalFactory_LocalRouterTimeout;
  * @param [in] identity A pointer to a `PARCIdentity` instance.
  *
  * @return non-NULL A pointer to a `CCNxPortalFactory` instance.
- * @return NULL Memory could not be allocated.
+ * @return NULL Memory could not be allocated, or the default configuration could not be created. `errno` is set.
  *
  * Example:
  * @code
@@ -245,9 +246,49 @@ const PARCKeyId *ccnxPortalFactory_GetKeyId(const CCNxPortalFactory *factory);
  */
 typedef CCNxPortal *(CCNxStackImpl)(const CCNxPortalFactory *factory, const CCNxPortalAttributes *attributes);
 
+/**
+ * Set the attributes given to every {@link CCNxPortal} subsequently created by this factory.
+ *
+ * The factory keeps its own copy of @p attributes, and keeps its previous attributes if the copy cannot be allocated.
+ * Until this is called the factory uses a copy of `ccnxPortalAttributes_NonBlocking`.
+ *
+ * @param [in] factory A pointer to a valid `CCNxPortalFactory` instance.
+ * @param [in] attributes A pointer to a valid `CCNxPortalAttributes` instance.
+ *
+ * Example:
+ * @code
+ * {
+ *     CCNxPortalAttributes *attributes = ccnxPortalAttributes_Copy(&ccnxPortalAttributes_Blocking);
+ *     ccnxPortalAttributes_SetSocketReceiveBufferSize(attributes, 4 * 1024 * 1024);
+ *
+ *     ccnxPortalFactory_SetAttributes(factory, attributes);
+ *     ccnxPortalAttributes_Release(&attributes);
+ *
+ *     CCNxPortal *portal = ccnxPortalFactory_CreatePortal(factory, ccnxPortalRTA_Message);
+ * }
+ * @endcode
+ *
+ * @see {@link ccnxPortalFactory_GetAttributes}
+ */
+void ccnxPortalFactory_SetAttributes(CCNxPortalFactory *factory, const CCNxPortalAttributes *attributes);
+
+/**
+ * Get the attributes given to every {@link CCNxPortal} created by this factory.
+ *
+ * @param [in] factory A pointer to a valid `CCNxPortalFactory` instance.
+ *
+ * @return A pointer to a valid `CCNxPortalAttributes` instance, valid until the factory's attributes are next set,
+ *         or for as long as a reference acquired with `ccnxPortalAttributes_Acquire` is held.
+ *
+ * @see {@link ccnxPortalFactory_SetAttributes}
+ */
+const CCNxPortalAttributes *ccnxPortalFactory_GetAttributes(const CCNxPortalFactory *factory);
+
 /**
  * Create an {@link CCNxPortal} instance of the specified communication type, protocol and attributes.
  *
+ * The Portal is created with the factory's attributes, see {@link ccnxPortalFactory_SetAttributes}.
+ *
  * @param [in] factory A pointer to a CCNxPortal factory to use to create the instance.
  * @param [in,out] stackImplementation A pointer to a function initializing the protocol implementation.
  *
@@ -271,7 +312,54 @@ PARCProperties *ccnxPortalFactory_GetProperties(const CCNxPortalFactory *factory
 
 const char *ccnxPortalFactory_GetProperty(const CCNxPortalFactory *factory, const char *restrict name, const char *restrict defaultValue);
 
-void ccnxPortalFactory_SetProperty(const CCNxPortalFactory *factory, const char *restrict name, const char *restrict value);
+/**
+ * Set the value of a property of the given `CCNxPortalFactory`.
+ *
+ * A malformed value for `CCNxPortalFactory_LocalRouterName` or `CCNxPortalFactory_LocalRouterTimeout`
+ * is rejected, leaving the property unchanged (see `ccnxPortalConfiguration_IsValidProperty`).
+ *
+ * @param [in] factory A pointer to a valid `CCNxPortalFactory` instance.
+ * @param [in] name The name of the property.
+ * @param [in] value The new value of the property.
+ *
+ * @return true The property was set.
+ * @return false The value was rejected, and errno is set to EINVAL,
+ *               or the configuration snapshot could not be rebuilt, leaving the property unchanged.
+ *
+ * Example:
+ * @code
+ * {
+ *     if (!ccnxPortalFactory_SetProperty(factory, CCNxPortalFactory_LocalRouterTimeout, timeout)) {
+ *         fprintf(stderr, "Invalid local router timeout '%s'\n", timeout);
+ *     }
+ * }
+ * @endcode
+ */
+bool ccnxPortalFactory_SetProperty(const CCNxPortalFactory *factory, const char *restrict name, const char *restrict value);
+
+/**
+ * Get the typed snapshot of the well-known properties of the given `CCNxPortalFactory`.
+ *
+ * The snapshot is rebuilt by `ccnxPortalFactory_SetProperty` whenever it changes
+ * `CCNxPortalFactory_LocalRouterName` or `CCNxPortalFactory_LocalRouterTimeout`.
+ * Properties set directly on the `PARCProperties` from `ccnxPortalFactory_GetProperties` are not reflected.
+ * The result is only valid until the next such change; acquire it to keep it longer.
+ * Each `CCNxPortalStack` acquires the snapshot current when it is created, and keeps using it.
+ *
+ * @param [in] factory A pointer to a valid `CCNxPortalFactory` instance.
+ *
+ * @return A pointer to a valid `CCNxPortalConfiguration` instance.
+ *
+ * Example:
+ * @code
+ * {
+ *     const CCNxPortalConfiguration *configuration = ccnxPortalFactory_GetConfiguration(factory);
+ *
+ *     uint64_t timeout = ccnxPortalConfiguration_GetLocalRouterTimeout(configuration);
+ * }
+ * @endcode
+ */
+const CCNxPortalConfiguration *ccnxPortalFactory_GetConfiguration(const CCNxPortalFactory *factory);
 
 #endif  // CCNx_Portal_API_ccnx_Portal_h
 
@@ -0,0 +1,396 @@
+/*
+ * Copyright (c) 2016, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX OR PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ################################################################################
+ * #
+ * # PATENT NOTICE
+ * #
+ * # This software is distributed under the BSD 2-clause License (see LICENSE
+ * # file).  This BSD License does not make any patent claims and as such, does
+ * # not act as a patent grant.  The purpose of this section is for each contributor
+ * # to define their intentions with respect to intellectual property.
+ * #
+ * # Each contributor to this source code is encouraged to state their patent
+ * # claims and licensing mechanisms for any contributions made. At the end of
+ * # this section contributors may each make their own statements.  Contributor's
+ * # claims and grants only apply to the pieces (source code, programs, text,
+ * # media, etc) that they have contributed directly to this software.
+ * #
+ * # There is no guarantee that this section is complete, up to date or accurate. It
+ * # is up to the contributors to maintain their portion of this section and up to
+ * # the user of the software to verify any claims herein.
+ * #
+ * # Do not remove this header notification.  The contents of this section must be
+ * # present in all distributions of the software.  You may only modify your own
+ * # intellectual property statements.  Please provide contact information.
+ *
+ * - Palo Alto Research Center, Inc
+ * This software distribution does not grant any rights to patents owned by Palo
+ * Alto Research Center, Inc (PARC). Rights to these patents are available via
+ * various mechanisms. As of January 2016 PARC has committed to FRAND licensing any
+ * intellectual property used by its contributions to this software. You may
+ * contact PARC at cipo@parc.com for more information or visit http://www.ccnx.org
+ */
+/**
+ * @copyright (c) 2016, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC).  All rights reserved.
+ */
+#include <config.h>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include <LongBow/runtime.h>
+
+#include <parc/algol/parc_Object.h>
+#include <parc/algol/parc_Memory.h>
+#include <parc/algol/parc_HashMap.h>
+
+#include <ccnx/api/ccnx_Portal/ccnx_PortalFileStore.h>
+
+/*
+ * A file mapped into memory. An empty file has no mapping.
+ */
+typedef struct {
+    void *base;
+    size_t length;
+} _CCNxPortalMappedFile;
+
+struct CCNxPortalFileStore {
+    char *directory;
+    CCNxName *prefix;
+    size_t segmentSize;
+
+    pthread_mutex_t lock;
+
+    // Mapped files, keyed by the name of the file (the segment name without its chunk number).
+    PARCHashMap *files;
+
+    // Cached Content Objects keyed by name, and their names in the order they were cached.
+    PARCHashMap *segments;
+    CCNxName **cacheOrder;
+    size_t cacheCapacity;
+    size_t cacheHead;
+    size_t cacheCount;
+};
+
+static void
+_ccnxPortalMappedFile_Destroy(_CCNxPortalMappedFile **filePtr)
+{
+    _CCNxPortalMappedFile *file = *filePtr;
+
+    if (file->base != NULL) {
+        munmap(file->base, file->length);
+    }
+}
+
+parcObject_ExtendPARCObject(_CCNxPortalMappedFile, _ccnxPortalMappedFile_Destroy, NULL, NULL, NULL, NULL, NULL, NULL);
+
+static parcObject_ImplementRelease(_ccnxPortalMappedFile, _CCNxPortalMappedFile);
+
+static _CCNxPortalMappedFile *
+_ccnxPortalMappedFile_Create(const char *path)
+{
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return NULL;
+    }
+
+    _CCNxPortalMappedFile *result = NULL;
+
+    struct stat status;
+    if (fstat(fd, &status) == 0 && S_ISREG(status.st_mode)) {
+        void *base = NULL;
+        size_t length = (size_t) status.st_size;
+        if (length > 0) {
+            base = mmap(NULL, length, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (base == MAP_FAILED) {
+                base = NULL;
+            } else {
+                madvise(base, length, MADV_SEQUENTIAL);
+            }
+        }
+
+        if (length == 0 || base != NULL) {
+            result = parcObject_CreateInstance(_CCNxPortalMappedFile);
+            if (result != NULL) {
+                result->base = base;
+                result->length = length;
+            } else if (base != NULL) {
+                munmap(base, length);
+            }
+        }
+    }
+    close(fd);
+
+    return result;
+}
+
+static void
+_ccnxPortalFileStore_Destroy(CCNxPortalFileStore **storePtr)
+{
+    CCNxPortalFileStore *store = *storePtr;
+
+    // The cached Content Objects refer to the mapped files, so they go first.
+    if (store->segments != NULL) {
+        parcHashMap_Release(&store->segments);
+    }
+    if (store->cacheOrder != NULL) {
+        for (size_t i = 0; i < store->cacheCount; i++) {
+            ccnxName_Release(&store->cacheOrder[(store->cacheHead + i) % store->cacheCapacity]);
+        }
+        parcMemory_Deallocate(&store->cacheOrder);
+    }
+    if (store->files != NULL) {
+        parcHashMap_Release(&store->files);
+    }
+    if (store->prefix != NULL) {
+        ccnxName_Release(&store->prefix);
+    }
+    if (store->directory != NULL) {
+        parcMemory_Deallocate(&store->directory);
+    }
+    pthread_mutex_destroy(&store->lock);
+}
+
+parcObject_ExtendPARCObject(CCNxPortalFileStore, _ccnxPortalFileStore_Destroy, NULL, NULL, NULL, NULL, NULL, NULL);
+
+parcObject_ImplementAcquire(ccnxPortalFileStore, CCNxPortalFileStore);
+
+parcObject_ImplementRelease(ccnxPortalFileStore, CCNxPortalFileStore);
+
+CCNxPortalFileStore *
+ccnxPortalFileStore_Create(const char *directory, const CCNxName *prefix, size_t segmentSize, size_t cacheCapacity)
+{
+    if (segmentSize == 0) {
+        errno = EINVAL;
+        return NULL;
+    }
+
+    struct stat status;
+    if (stat(directory, &status) != 0) {
+        return NULL;
+    }
+    if (!S_ISDIR(status.st_mode)) {
+        errno = ENOTDIR;
+        return NULL;
+    }
+
+    CCNxPortalFileStore *result = parcObject_CreateInstance(CCNxPortalFileStore);
+    if (result == NULL) {
+        errno = ENOMEM;
+        return NULL;
+    }
+
+    pthread_mutex_init(&result->lock, NULL);
+    result->directory = parcMemory_StringDuplicate(directory, strlen(directory));
+    result->prefix = ccnxName_Acquire(prefix);
+    result->segmentSize = segmentSize;
+    result->files = parcHashMap_Create();
+    result->segments = parcHashMap_Create();
+    result->cacheOrder = (cacheCapacity == 0) ? NULL : parcMemory_AllocateAndClear(cacheCapacity * sizeof(CCNxName *));
+    result->cacheCapacity = cacheCapacity;
+    result->cacheHead = 0;
+    result->cacheCount = 0;
+
+    if (result->directory == NULL || result->files == NULL || result->segments == NULL
+        || (cacheCapacity > 0 && result->cacheOrder == NULL)) {
+        ccnxPortalFileStore_Release(&result);
+        errno = ENOMEM;
+    }
+
+    return result;
+}
+
+/*
+ * Build the path of the file named by the segments between the prefix and the chunk number.
+ * Every segment must be a plain name segment that is a single, ordinary path component.
+ */
+static char *
+_ccnxPortalFileStore_CreatePath(const CCNxPortalFileStore *store, const CCNxName *name, size_t first, size_t end)
+{
+    size_t length = strlen(store->directory);
+
+    for (size_t i = first; i < end; i++) {
+        CCNxNameSegment *segment = ccnxName_GetSegment(name, i);
+        if (ccnxNameSegment_GetType(segment) != CCNxNameLabelType_NAME) {
+            return NULL;
+        }
+        PARCBuffer *value = ccnxNameSegment_GetValue(segment);
+        size_t valueLength = parcBuffer_Remaining(value);
+        const char *component = parcBuffer_Overlay(value, 0);
+
+        if (valueLength == 0 || memchr(component, '/', valueLength) != NULL || memchr(component, '\0', valueLength) != NULL) {
+            return NULL;
+        }
+        if ((valueLength == 1 && component[0] == '.') || (valueLength == 2 && component[0] == '.' && component[1] == '.')) {
+            return NULL;
+        }
+        length += 1 + valueLength;
+    }
+
+    char *result = parcMemory_Allocate(length + 1);
+    if (result != NULL) {
+        char *cursor = result;
+        size_t directoryLength = strlen(store->directory);
+        memcpy(cursor, store->directory, directoryLength);
+        cursor += directoryLength;
+
+        for (size_t i = first; i < end; i++) {
+            PARCBuffer *value = ccnxNameSegment_GetValue(ccnxName_GetSegment(name, i));
+            size_t valueLength = parcBuffer_Remaining(value);
+            *cursor++ = '/';
+            memcpy(cursor, parcBuffer_Overlay(value, 0), valueLength);
+            cursor += valueLength;
+        }
+        *cursor = '\0';
+    }
+
+    return result;
+}
+
+/*
+ * Get the mapped file for the name, mapping it if this is the first request for it. The lock must be held.
+ */
+static _CCNxPortalMappedFile *
+_ccnxPortalFileStore_GetFile(CCNxPortalFileStore *store, const CCNxName *name)
+{
+    size_t segmentCount = ccnxName_GetSegmentCount(name);
+
+    CCNxName *fileName = ccnxName_Trim(ccnxName_Copy(name), 1);
+    _CCNxPortalMappedFile *result = (_CCNxPortalMappedFile *) parcHashMap_Get(store->files, fileName);
+
+    if (result == NULL) {
+        char *path = _ccnxPortalFileStore_CreatePath(store, name, ccnxName_GetSegmentCount(store->prefix), segmentCount - 1);
+        if (path != NULL) {
+            result = _ccnxPortalMappedFile_Create(path);
+            if (result != NULL) {
+                parcHashMap_Put(store->files, fileName, result);
+                _ccnxPortalMappedFile_Release(&result);
+                result = (_CCNxPortalMappedFile *) parcHashMap_Get(store->files, fileName);
+            }
+            parcMemory_Deallocate(&path);
+        }
+    }
+    ccnxName_Release(&fileName);
+
+    return result;
+}
+
+/*
+ * Add a Content Object to the cache, evicting the oldest one if the cache is full. The lock must be held.
+ */
+static void
+_ccnxPortalFileStore_CachePut(CCNxPortalFileStore *store, const CCNxName *name, const CCNxContentObject *contentObject)
+{
+    if (store->cacheCapacity == 0) {
+        return;
+    }
+
+    if (store->cacheCount == store->cacheCapacity) {
+        CCNxName *oldest = store->cacheOrder[store->cacheHead];
+        parcHashMap_Remove(store->segments, oldest);
+        ccnxName_Release(&oldest);
+        store->cacheHead = (store->cacheHead + 1) % store->cacheCapacity;
+        store->cacheCount--;
+    }
+
+    parcHashMap_Put(store->segments, name, contentObject);
+    store->cacheOrder[(store->cacheHead + store->cacheCount) % store->cacheCapacity] = ccnxName_Acquire(name);
+    store->cacheCount++;
+}
+
+CCNxContentObject *
+ccnxPortalFileStore_GetSegment(CCNxPortalFileStore *store, const CCNxName *name)
+{
+    size_t prefixCount = ccnxName_GetSegmentCount(store->prefix);
+    size_t segmentCount = ccnxName_GetSegmentCount(name);
+
+    // At least one path component and the chunk number.
+    if (segmentCount < prefixCount + 2 || !ccnxName_StartsWith(name, store->prefix)) {
+        return NULL;
+    }
+    CCNxNameSegment *chunk = ccnxName_GetSegment(name, segmentCount - 1);
+    if (ccnxNameSegment_GetType(chunk) != CCNxNameLabelType_CHUNK || !ccnxNameSegmentNumber_IsValid(chunk)) {
+        return NULL;
+    }
+    uint64_t chunkNumber = ccnxNameSegmentNumber_Value(chunk);
+
+    CCNxContentObject *result = NULL;
+
+    pthread_mutex_lock(&store->lock);
+
+    const CCNxContentObject *cached = parcHashMap_Get(store->segments, name);
+    if (cached != NULL) {
+        result = ccnxContentObject_Acquire(cached);
+    } else {
+        _CCNxPortalMappedFile *file = _ccnxPortalFileStore_GetFile(store, name);
+        if (file != NULL) {
+            uint64_t finalChunkNumber = (file->length == 0) ? 0 : (file->length - 1) / store->segmentSize;
+
+            if (chunkNumber <= finalChunkNumber) {
+                size_t offset = (size_t) chunkNumber * store->segmentSize;
+                size_t length = file->length - offset;
+                if (length > store->segmentSize) {
+                    length = store->segmentSize;
+                }
+
+                PARCBuffer *payload = parcBuffer_Wrap(file->base, file->length, offset, offset + length);
+                result = ccnxContentObject_CreateWithNameAndPayload(name, payload);
+                parcBuffer_Release(&payload);
+
+                if (result != NULL) {
+                    ccnxContentObject_SetFinalChunkNumber(result, finalChunkNumber);
+                    _ccnxPortalFileStore_CachePut(store, name, result);
+                }
+            }
+        }
+    }
+
+    pthread_mutex_unlock(&store->lock);
+
+    return result;
+}
+
+size_t
+ccnxPortalFileStore_GetSegmentSize(const CCNxPortalFileStore *store)
+{
+    return store->segmentSize;
+}
+
+size_t
+ccnxPortalFileStore_GetCachedCount(const CCNxPortalFileStore *store)
+{
+    CCNxPortalFileStore *mutableStore = (CCNxPortalFileStore *) store;
+
+    pthread_mutex_lock(&mutableStore->lock);
+    size_t result = store->cacheCount;
+    pthread_mutex_unlock(&mutableStore->lock);
+
+    return result;
+}
@@ -0,0 +1,213 @@
+/*
+ * Copyright (c) 2016, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX OR PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ################################################################################
+ * #
+ * # PATENT NOTICE
+ * #
+ * # This software is distributed under the BSD 2-clause License (see LICENSE
+ * # file).  This BSD License does not make any patent claims and as such, does
+ * # not act as a patent grant.  The purpose of this section is for each contributor
+ * # to define their intentions with respect to intellectual property.
+ * #
+ * # Each contributor to this source code is encouraged to state their patent
+ * # claims and licensing mechanisms for any contributions made. At the end of
+ * # this section contributors may each make their own statements.  Contributor's
+ * # claims and grants only apply to the pieces (source code, programs, text,
+ * # media, etc) that they have contributed directly to this software.
+ * #
+ * # There is no guarantee that this section is complete, up to date or accurate. It
+ * # is up to the contributors to maintain their portion of this section and up to
+ * # the user of the software to verify any claims herein.
+ * #
+ * # Do not remove this header notification.  The contents of this section must be
+ * # present in all distributions of the software.  You may only modify your own
+ * # intellectual property statements.  Please provide contact information.
+ *
+ * - Palo Alto Research Center, Inc
+ * This software distribution does not grant any rights to patents owned by Palo
+ * Alto Research Center, Inc (PARC). Rights to these patents are available via
+ * various mechanisms. As of January 2016 PARC has committed to FRAND licensing any
+ * intellectual property used by its contributions to this software. You may
+ * contact PARC at cipo@parc.com for more information or visit http://www.ccnx.org
+ */
+/**
+ * @file ccnx_PortalFileStore.h
+ * @brief Serve the files of a directory tree as named, segmented content.
+ *
+ * A file store maps names under a prefix to the files under a directory.
+ * The name `lci:/prefix/a/b/chunk=N` names segment N of the file `a/b` under the directory,
+ * where every segment but the last holds exactly the segment size in bytes.
+ *
+ * Files are mapped into memory when first requested and stay mapped for the life of the store.
+ * The payload of each segment is a `PARCBuffer` view over the mapped file, so no file data is copied
+ * to build a Content Object. Those payloads, and the Content Objects holding them,
+ * must not be used after the last reference to the store is released.
+ *
+ * The most recently built Content Objects are held in a bounded cache,
+ * so a segment requested again is sent as the same, already signed, instance.
+ *
+ * A file store is thread-safe.
+ *
+ * @copyright (c) 2016, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC).  All rights reserved.
+ */
+#ifndef CCNx_Portal_API_ccnx_PortalFileStore_h
+#define CCNx_Portal_API_ccnx_PortalFileStore_h
+
+#include <stddef.h>
+
+#include <ccnx/common/ccnx_Name.h>
+#include <ccnx/common/ccnx_ContentObject.h>
+
+struct CCNxPortalFileStore;
+/**
+ * @typedef CCNxPortalFileStore
+ * @brief Serve the files of a directory tree as named, segmented content.
+ */
+typedef struct CCNxPortalFileStore CCNxPortalFileStore;
+
+/**
+ * Create a new `CCNxPortalFileStore` serving the files under @p directory with names under @p prefix.
+ *
+ * @param [in] directory The path of the directory to serve.
+ * @param [in] prefix A pointer to a valid `CCNxName` instance naming the directory.
+ * @param [in] segmentSize The number of bytes of file data in each segment. Must be greater than zero.
+ * @param [in] cacheCapacity The maximum number of Content Objects to cache. Zero disables the cache.
+ *
+ * @return non-NULL A pointer to a valid `CCNxPortalFileStore` instance.
+ * @return NULL @p directory is not an accessible directory, or memory could not be allocated. `errno` is set.
+ *
+ * Example:
+ * @code
+ * {
+ *     CCNxName *prefix = ccnxName_CreateFromCString("lci:/example/files");
+ *
+ *     CCNxPortalFileStore *store = ccnxPortalFileStore_Create("/var/www", prefix, 4096, 10000);
+ *
+ *     ccnxPortalFileStore_Release(&store);
+ *     ccnxName_Release(&prefix);
+ * }
+ * @endcode
+ */
+CCNxPortalFileStore *ccnxPortalFileStore_Create(const char *directory, const CCNxName *prefix, size_t segmentSize, size_t cacheCapacity);
+
+/**
+ * Increase the number of references to a `CCNxPortalFileStore` instance.
+ *
+ * @param [in] store A pointer to a valid `CCNxPortalFileStore` instance.
+ *
+ * @return The same value as @p store.
+ *
+ * Example:
+ * @code
+ * {
+ *     CCNxPortalFileStore *store = ccnxPortalFileStore_Create("/var/www", prefix, 4096, 10000);
+ *     CCNxPortalFileStore *reference = ccnxPortalFileStore_Acquire(store);
+ *
+ *     ccnxPortalFileStore_Release(&store);
+ *     ccnxPortalFileStore_Release(&reference);
+ * }
+ * @endcode
+ */
+CCNxPortalFileStore *ccnxPortalFileStore_Acquire(const CCNxPortalFileStore *store);
+
+/**
+ * Release a previously acquired reference to the given `CCNxPortalFileStore` instance,
+ * decrementing the reference count for the instance.
+ *
+ * The pointer to the instance is set to NULL as a side-effect of this function.
+ * Releasing the last reference unmaps every mapped file.
+ *
+ * @param [in,out] storePtr A pointer to a pointer to the instance to release.
+ *
+ * Example:
+ * @code
+ * {
+ *     CCNxPortalFileStore *store = ccnxPortalFileStore_Create("/var/www", prefix, 4096, 10000);
+ *
+ *     ccnxPortalFileStore_Release(&store);
+ * }
+ * @endcode
+ */
+void ccnxPortalFileStore_Release(CCNxPortalFileStore **storePtr);
+
+/**
+ * Get the Content Object for the segment named by @p name.
+ *
+ * The Content Object has the name @p name, the segment as its payload, and the number of the file's last segment
+ * as its final chunk number. An empty file has a single, empty segment.
+ *
+ * @param [in] store A pointer to a valid `CCNxPortalFileStore` instance.
+ * @param [in] name A pointer to a valid `CCNxName` instance.
+ *
+ * @return non-NULL A pointer to a `CCNxContentObject` instance that must be released by the caller.
+ * @return NULL @p name does not name a segment of a regular file under the directory.
+ *
+ * Example:
+ * @code
+ * {
+ *     CCNxContentObject *contentObject = ccnxPortalFileStore_GetSegment(store, ccnxInterest_GetName(interest));
+ *     if (contentObject != NULL) {
+ *         CCNxMetaMessage *message = ccnxMetaMessage_CreateFromContentObject(contentObject);
+ *         ccnxPortal_Send(portal, message, CCNxStackTimeout_Never);
+ *         ccnxMetaMessage_Release(&message);
+ *         ccnxContentObject_Release(&contentObject);
+ *     }
+ * }
+ * @endcode
+ */
+CCNxContentObject *ccnxPortalFileStore_GetSegment(CCNxPortalFileStore *store, const CCNxName *name);
+
+/**
+ * Get the number of bytes of file data in each segment.
+ *
+ * @param [in] store A pointer to a valid `CCNxPortalFileStore` instance.
+ *
+ * @return The segment size given when @p store was created.
+ *
+ * Example:
+ * @code
+ * {
+ *     size_t segmentSize = ccnxPortalFileStore_GetSegmentSize(store);
+ * }
+ * @endcode
+ */
+size_t ccnxPortalFileStore_GetSegmentSize(const CCNxPortalFileStore *store);
+
+/**
+ * Get the number of Content Objects currently held in the cache.
+ *
+ * @param [in] store A pointer to a valid `CCNxPortalFileStore` instance.
+ *
+ * @return The number of cached Content Objects, never more than the cache capacity.
+ *
+ * Example:
+ * @code
+ * {
+ *     printf("%zu segments cached\n", ccnxPortalFileStore_GetCachedCount(store));
+ * }
+ * @endcode
+ */
+size_t ccnxPortalFileStore_GetCachedCount(const CCNxPortalFileStore *store);
+#endif // CCNx_Portal_API_ccnx_PortalFileStore_h
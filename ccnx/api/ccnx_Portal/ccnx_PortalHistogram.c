@@ -0,0 +1,286 @@
+/*
+ * Copyright (c) 2016, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX OR PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ################################################################################
+ * #
+ * # PATENT NOTICE
+ * #
+ * # This software is distributed under the BSD 2-clause License (see LICENSE
+ * # file).  This BSD License does not make any patent claims and as such, does
+ * # not act as a patent grant.  The purpose of this section is for each contributor
+ * # to define their intentions with respect to intellectual property.
+ * #
+ * # Each contributor to this source code is encouraged to state their patent
+ * # claims and licensing mechanisms for any contributions made. At the end of
+ * # this section contributors may each make their own statements.  Contributor's
+ * # claims and grants only apply to the pieces (source code, programs, text,
+ * # media, etc) that they have contributed directly to this software.
+ * #
+ * # There is no guarantee that this section is complete, up to date or accurate. It
+ * # is up to the contributors to maintain their portion of this section and up to
+ * # the user of the software to verify any claims herein.
+ * #
+ * # Do not remove this header notification.  The contents of this section must be
+ * # present in all distributions of the software.  You may only modify your own
+ * # intellectual property statements.  Please provide contact information.
+ *
+ * - Palo Alto Research Center, Inc
+ * This software distribution does not grant any rights to patents owned by Palo
+ * Alto Research Center, Inc (PARC). Rights to these patents are available via
+ * various mechanisms. As of January 2016 PARC has committed to FRAND licensing any
+ * intellectual property used by its contributions to this software. You may
+ * contact PARC at cipo@parc.com for more information or visit http://www.ccnx.org
+ */
+/**
+ * @copyright (c) 2016, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC).  All rights reserved.
+ */
+#include <config.h>
+
+#include <math.h>
+
+#include <LongBow/runtime.h>
+
+#include <ccnx/api/ccnx_Portal/ccnx_PortalHistogram.h>
+
+#include <parc/algol/parc_Object.h>
+
+#define _subBucketBits 5
+#define _subBucketCount (1 << _subBucketBits)
+#define _bucketCount ((64 - _subBucketBits) * _subBucketCount + _subBucketCount)
+
+struct CCNxPortalHistogram {
+    uint64_t count;
+    uint64_t sum;
+    uint64_t min;
+    uint64_t max;
+    uint64_t buckets[_bucketCount];
+};
+
+static size_t
+_ccnxPortalHistogram_Index(uint64_t value)
+{
+    if (value < 2 * _subBucketCount) {
+        return (size_t) value;
+    }
+    unsigned int magnitude = 63 - __builtin_clzll(value);
+    unsigned int shift = magnitude - _subBucketBits;
+    return (shift + 1) * _subBucketCount + (size_t) ((value >> shift) - _subBucketCount);
+}
+
+static uint64_t
+_ccnxPortalHistogram_LowestEquivalentValue(size_t index)
+{
+    if (index < 2 * _subBucketCount) {
+        return index;
+    }
+    unsigned int shift = (unsigned int) (index / _subBucketCount) - 1;
+    uint64_t subBucket = (index % _subBucketCount) + _subBucketCount;
+    return subBucket << shift;
+}
+
+static uint64_t
+_ccnxPortalHistogram_HighestEquivalentValue(size_t index)
+{
+    if (index < 2 * _subBucketCount) {
+        return index;
+    }
+    unsigned int shift = (unsigned int) (index / _subBucketCount) - 1;
+    return _ccnxPortalHistogram_LowestEquivalentValue(index) + ((UINT64_C(1) << shift) - 1);
+}
+
+parcObject_ExtendPARCObject(CCNxPortalHistogram, NULL, NULL, NULL, NULL, NULL, NULL, NULL);
+
+parcObject_ImplementAcquire(ccnxPortalHistogram, CCNxPortalHistogram);
+
+parcObject_ImplementRelease(ccnxPortalHistogram, CCNxPortalHistogram);
+
+CCNxPortalHistogram *
+ccnxPortalHistogram_Create(void)
+{
+    CCNxPortalHistogram *result = parcObject_CreateInstance(CCNxPortalHistogram);
+    if (result != NULL) {
+        ccnxPortalHistogram_Reset(result);
+    }
+    return result;
+}
+
+void
+ccnxPortalHistogram_Record(CCNxPortalHistogram *histogram, uint64_t value)
+{
+    __atomic_fetch_add(&histogram->buckets[_ccnxPortalHistogram_Index(value)], 1, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&histogram->sum, value, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&histogram->count, 1, __ATOMIC_RELAXED);
+
+    uint64_t min = __atomic_load_n(&histogram->min, __ATOMIC_RELAXED);
+    while (value < min
+           && !__atomic_compare_exchange_n(&histogram->min, &min, value, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+        ;
+    }
+    uint64_t max = __atomic_load_n(&histogram->max, __ATOMIC_RELAXED);
+    while (value > max
+           && !__atomic_compare_exchange_n(&histogram->max, &max, value, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+        ;
+    }
+}
+
+void
+ccnxPortalHistogram_Reset(CCNxPortalHistogram *histogram)
+{
+    for (size_t i = 0; i < _bucketCount; i++) {
+        __atomic_store_n(&histogram->buckets[i], 0, __ATOMIC_RELAXED);
+    }
+    __atomic_store_n(&histogram->count, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&histogram->sum, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&histogram->min, UINT64_MAX, __ATOMIC_RELAXED);
+    __atomic_store_n(&histogram->max, 0, __ATOMIC_RELAXED);
+}
+
+void
+ccnxPortalHistogram_Add(CCNxPortalHistogram *histogram, const CCNxPortalHistogram *other)
+{
+    uint64_t count = 0;
+    for (size_t i = 0; i < _bucketCount; i++) {
+        uint64_t n = __atomic_load_n(&other->buckets[i], __ATOMIC_RELAXED);
+        if (n > 0) {
+            __atomic_fetch_add(&histogram->buckets[i], n, __ATOMIC_RELAXED);
+            count += n;
+        }
+    }
+    // The count and sum follow the buckets read, so that percentiles stay consistent with the count.
+    __atomic_fetch_add(&histogram->count, count, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&histogram->sum, __atomic_load_n(&other->sum, __ATOMIC_RELAXED), __ATOMIC_RELAXED);
+
+    uint64_t otherMin = __atomic_load_n(&other->min, __ATOMIC_RELAXED);
+    uint64_t min = __atomic_load_n(&histogram->min, __ATOMIC_RELAXED);
+    while (otherMin < min
+           && !__atomic_compare_exchange_n(&histogram->min, &min, otherMin, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+        ;
+    }
+    uint64_t otherMax = __atomic_load_n(&other->max, __ATOMIC_RELAXED);
+    uint64_t max = __atomic_load_n(&histogram->max, __ATOMIC_RELAXED);
+    while (otherMax > max
+           && !__atomic_compare_exchange_n(&histogram->max, &max, otherMax, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+        ;
+    }
+}
+
+uint64_t
+ccnxPortalHistogram_GetCount(const CCNxPortalHistogram *histogram)
+{
+    return __atomic_load_n(&histogram->count, __ATOMIC_RELAXED);
+}
+
+uint64_t
+ccnxPortalHistogram_GetMin(const CCNxPortalHistogram *histogram)
+{
+    uint64_t result = __atomic_load_n(&histogram->min, __ATOMIC_RELAXED);
+    return (result == UINT64_MAX) ? 0 : result;
+}
+
+uint64_t
+ccnxPortalHistogram_GetMax(const CCNxPortalHistogram *histogram)
+{
+    return __atomic_load_n(&histogram->max, __ATOMIC_RELAXED);
+}
+
+double
+ccnxPortalHistogram_GetMean(const CCNxPortalHistogram *histogram)
+{
+    uint64_t count = ccnxPortalHistogram_GetCount(histogram);
+    if (count == 0) {
+        return 0.0;
+    }
+    return (double) __atomic_load_n(&histogram->sum, __ATOMIC_RELAXED) / (double) count;
+}
+
+double
+ccnxPortalHistogram_GetStandardDeviation(const CCNxPortalHistogram *histogram)
+{
+    double mean = ccnxPortalHistogram_GetMean(histogram);
+
+    uint64_t count = 0;
+    double sumOfSquares = 0.0;
+    for (size_t i = 0; i < _bucketCount; i++) {
+        uint64_t n = __atomic_load_n(&histogram->buckets[i], __ATOMIC_RELAXED);
+        if (n > 0) {
+            double midpoint = ((double) _ccnxPortalHistogram_LowestEquivalentValue(i)
+                               + (double) _ccnxPortalHistogram_HighestEquivalentValue(i)) / 2.0;
+            double deviation = midpoint - mean;
+            sumOfSquares += deviation * deviation * (double) n;
+            count += n;
+        }
+    }
+
+    return (count == 0) ? 0.0 : sqrt(sumOfSquares / (double) count);
+}
+
+uint64_t
+ccnxPortalHistogram_GetValueAtPercentile(const CCNxPortalHistogram *histogram, double percentile)
+{
+    // Count from the buckets so that the total is consistent with the walk below.
+    uint64_t total = 0;
+    for (size_t i = 0; i < _bucketCount; i++) {
+        total += __atomic_load_n(&histogram->buckets[i], __ATOMIC_RELAXED);
+    }
+    if (total == 0) {
+        return 0;
+    }
+
+    if (percentile > 100.0) {
+        percentile = 100.0;
+    }
+    uint64_t target = (uint64_t) ceil((percentile / 100.0) * (double) total);
+    if (target == 0) {
+        target = 1;
+    }
+
+    uint64_t max = ccnxPortalHistogram_GetMax(histogram);
+    uint64_t seen = 0;
+    for (size_t i = 0; i < _bucketCount; i++) {
+        seen += __atomic_load_n(&histogram->buckets[i], __ATOMIC_RELAXED);
+        if (seen >= target) {
+            uint64_t result = _ccnxPortalHistogram_HighestEquivalentValue(i);
+            return (result > max) ? max : result;
+        }
+    }
+    return max;
+}
+
+PARCJSON *
+ccnxPortalHistogram_ToJSON(const CCNxPortalHistogram *histogram)
+{
+    PARCJSON *result = parcJSON_Create();
+
+    parcJSON_AddInteger(result, "count", (int64_t) ccnxPortalHistogram_GetCount(histogram));
+    parcJSON_AddInteger(result, "min", (int64_t) ccnxPortalHistogram_GetMin(histogram));
+    parcJSON_AddInteger(result, "max", (int64_t) ccnxPortalHistogram_GetMax(histogram));
+    parcJSON_AddInteger(result, "mean", (int64_t) llround(ccnxPortalHistogram_GetMean(histogram)));
+    parcJSON_AddInteger(result, "stddev", (int64_t) llround(ccnxPortalHistogram_GetStandardDeviation(histogram)));
+    parcJSON_AddInteger(result, "p50", (int64_t) ccnxPortalHistogram_GetValueAtPercentile(histogram, 50.0));
+    parcJSON_AddInteger(result, "p90", (int64_t) ccnxPortalHistogram_GetValueAtPercentile(histogram, 90.0));
+    parcJSON_AddInteger(result, "p99", (int64_t) ccnxPortalHistogram_GetValueAtPercentile(histogram, 99.0));
+    parcJSON_AddInteger(result, "p999", (int64_t) ccnxPortalHistogram_GetValueAtPercentile(histogram, 99.9));
+
+    return result;
+}
@@ -0,0 +1,215 @@
+/*
+ * Copyright (c) 2016, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX OR PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ################################################################################
+ * #
+ * # PATENT NOTICE
+ * #
+ * # This software is distributed under the BSD 2-clause License (see LICENSE
+ * # file).  This BSD License does not make any patent claims and as such, does
+ * # not act as a patent grant.  The purpose of this section is for each contributor
+ * # to define their intentions with respect to intellectual property.
+ * #
+ * # Each contributor to this source code is encouraged to state their patent
+ * # claims and licensing mechanisms for any contributions made. At the end of
+ * # this section contributors may each make their own statements.  Contributor's
+ * # claims and grants only apply to the pieces (source code, programs, text,
+ * # media, etc) that they have contributed directly to this software.
+ * #
+ * # There is no guarantee that this section is complete, up to date or accurate. It
+ * # is up to the contributors to maintain their portion of this section and up to
+ * # the user of the software to verify any claims herein.
+ * #
+ * # Do not remove this header notification.  The contents of this section must be
+ * # present in all distributions of the software.  You may only modify your own
+ * # intellectual property statements.  Please provide contact information.
+ *
+ * - Palo Alto Research Center, Inc
+ * This software distribution does not grant any rights to patents owned by Palo
+ * Alto Research Center, Inc (PARC). Rights to these patents are available via
+ * various mechanisms. As of January 2016 PARC has committed to FRAND licensing any
+ * intellectual property used by its contributions to this software. You may
+ * contact PARC at cipo@parc.com for more information or visit http://www.ccnx.org
+ */
+/**
+ * @file ccnx_PortalHistogram.h
+ * @brief A fixed-size, log-linear histogram of latency values.
+ *
+ * The histogram uses the bucket layout of an HDR histogram. Values below 64 have their own bucket,
+ * and every larger power of two is split into 32 equal sub-buckets. Each recorded value therefore
+ * lands in a bucket within about 3% of the value, across the whole 64-bit range, in constant space.
+ *
+ * Recording is a handful of relaxed atomic operations and never allocates or locks.
+ * A histogram may be read from any thread while others record into it.
+ * A reader sees each counter at some moment during the read, not necessarily the same moment.
+ *
+ * @copyright (c) 2016, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC).  All rights reserved.
+ */
+#ifndef CCNx_Portal_API_ccnx_PortalHistogram_h
+#define CCNx_Portal_API_ccnx_PortalHistogram_h
+
+#include <stdint.h>
+
+#include <parc/algol/parc_JSON.h>
+
+struct CCNxPortalHistogram;
+/**
+ * @typedef CCNxPortalHistogram
+ * @brief A log-linear histogram of non-negative integer values, typically nanoseconds.
+ */
+typedef struct CCNxPortalHistogram CCNxPortalHistogram;
+
+/**
+ * Create a new, empty `CCNxPortalHistogram`.
+ *
+ * @return non-NULL A pointer to a valid `CCNxPortalHistogram` instance.
+ * @return NULL Memory could not be allocated.
+ *
+ * Example:
+ * @code
+ * {
+ *     CCNxPortalHistogram *histogram = ccnxPortalHistogram_Create();
+ *
+ *     ccnxPortalHistogram_Record(histogram, 1250);
+ *     uint64_t p99 = ccnxPortalHistogram_GetValueAtPercentile(histogram, 99.0);
+ *
+ *     ccnxPortalHistogram_Release(&histogram);
+ * }
+ * @endcode
+ */
+CCNxPortalHistogram *ccnxPortalHistogram_Create(void);
+
+/**
+ * Increase the number of references to a `CCNxPortalHistogram` instance.
+ *
+ * @param [in] histogram A pointer to a valid `CCNxPortalHistogram` instance.
+ *
+ * @return The value of @p histogram.
+ */
+CCNxPortalHistogram *ccnxPortalHistogram_Acquire(const CCNxPortalHistogram *histogram);
+
+/**
+ * Release a previously acquired reference to the specified instance,
+ * decrementing the reference count for the instance.
+ *
+ * @param [in,out] histogramPtr A pointer to a pointer to the instance to release.
+ */
+void ccnxPortalHistogram_Release(CCNxPortalHistogram **histogramPtr);
+
+/**
+ * Record one occurrence of the given value.
+ *
+ * @param [in] histogram A pointer to a valid `CCNxPortalHistogram` instance.
+ * @param [in] value The value to record.
+ */
+void ccnxPortalHistogram_Record(CCNxPortalHistogram *histogram, uint64_t value);
+
+/**
+ * Discard all recorded values.
+ *
+ * Values recorded concurrently with a reset may be partially retained.
+ *
+ * @param [in] histogram A pointer to a valid `CCNxPortalHistogram` instance.
+ */
+void ccnxPortalHistogram_Reset(CCNxPortalHistogram *histogram);
+
+/**
+ * Add every value recorded in @p other to @p histogram, as if each had been recorded in both.
+ *
+ * Used to combine the histograms of several Portals into one view. @p other may be recording concurrently.
+ *
+ * @param [in] histogram A pointer to a valid `CCNxPortalHistogram` instance.
+ * @param [in] other A pointer to a valid `CCNxPortalHistogram` instance.
+ */
+void ccnxPortalHistogram_Add(CCNxPortalHistogram *histogram, const CCNxPortalHistogram *other);
+
+/**
+ * Get the number of values recorded.
+ *
+ * @param [in] histogram A pointer to a valid `CCNxPortalHistogram` instance.
+ *
+ * @return The number of values recorded.
+ */
+uint64_t ccnxPortalHistogram_GetCount(const CCNxPortalHistogram *histogram);
+
+/**
+ * Get the smallest value recorded.
+ *
+ * @param [in] histogram A pointer to a valid `CCNxPortalHistogram` instance.
+ *
+ * @return The smallest value recorded, or 0 if the histogram is empty.
+ */
+uint64_t ccnxPortalHistogram_GetMin(const CCNxPortalHistogram *histogram);
+
+/**
+ * Get the largest value recorded.
+ *
+ * @param [in] histogram A pointer to a valid `CCNxPortalHistogram` instance.
+ *
+ * @return The largest value recorded, or 0 if the histogram is empty.
+ */
+uint64_t ccnxPortalHistogram_GetMax(const CCNxPortalHistogram *histogram);
+
+/**
+ * Get the arithmetic mean of the values recorded.
+ *
+ * @param [in] histogram A pointer to a valid `CCNxPortalHistogram` instance.
+ *
+ * @return The mean, or 0 if the histogram is empty.
+ */
+double ccnxPortalHistogram_GetMean(const CCNxPortalHistogram *histogram);
+
+/**
+ * Get the standard deviation of the values recorded, computed from the bucket midpoints.
+ *
+ * @param [in] histogram A pointer to a valid `CCNxPortalHistogram` instance.
+ *
+ * @return The standard deviation, or 0 if the histogram is empty.
+ */
+double ccnxPortalHistogram_GetStandardDeviation(const CCNxPortalHistogram *histogram);
+
+/**
+ * Get the value at the given percentile.
+ *
+ * The result is the largest value equivalent to the bucket holding the percentile,
+ * limited to the largest value recorded.
+ *
+ * @param [in] histogram A pointer to a valid `CCNxPortalHistogram` instance.
+ * @param [in] percentile A percentile between 0.0 and 100.0.
+ *
+ * @return The value at @p percentile, or 0 if the histogram is empty.
+ */
+uint64_t ccnxPortalHistogram_GetValueAtPercentile(const CCNxPortalHistogram *histogram, double percentile);
+
+/**
+ * Create a `PARCJSON` summary of the histogram.
+ *
+ * The summary contains the count, min, max, mean, standard deviation and the 50th, 90th, 99th and 99.9th percentiles.
+ *
+ * @param [in] histogram A pointer to a valid `CCNxPortalHistogram` instance.
+ *
+ * @return A `PARCJSON` instance that must be released via `parcJSON_Release`.
+ */
+PARCJSON *ccnxPortalHistogram_ToJSON(const CCNxPortalHistogram *histogram);
+#endif // CCNx_Portal_API_ccnx_PortalHistogram_h
@@ -0,0 +1,185 @@
+/*
+ * Copyright (c) 2016, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX OR PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ################################################################################
+ * #
+ * # PATENT NOTICE
+ * #
+ * # This software is distributed under the BSD 2-clause License (see LICENSE
+ * # file).  This BSD License does not make any patent claims and as such, does
+ * # not act as a patent grant.  The purpose of this section is for each contributor
+ * # to define their intentions with respect to intellectual property.
+ * #
+ * # Each contributor to this source code is encouraged to state their patent
+ * # claims and licensing mechanisms for any contributions made. At the end of
+ * # this section contributors may each make their own statements.  Contributor's
+ * # claims and grants only apply to the pieces (source code, programs, text,
+ * # media, etc) that they have contributed directly to this software.
+ * #
+ * # There is no guarantee that this section is complete, up to date or accurate. It
+ * # is up to the contributors to maintain their portion of this section and up to
+ * # the user of the software to verify any claims herein.
+ * #
+ * # Do not remove this header notification.  The contents of this section must be
+ * # present in all distributions of the software.  You may only modify your own
+ * # intellectual property statements.  Please provide contact information.
+ *
+ * - Palo Alto Research Center, Inc
+ * This software distribution does not grant any rights to patents owned by Palo
+ * Alto Research Center, Inc (PARC). Rights to these patents are available via
+ * various mechanisms. As of January 2016 PARC has committed to FRAND licensing any
+ * intellectual property used by its contributions to this software. You may
+ * contact PARC at cipo@parc.com for more information or visit http://www.ccnx.org
+ */
+/**
+ * @copyright (c) 2016, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC).  All rights reserved.
+ */
+#include <config.h>
+
+#include <LongBow/runtime.h>
+
+#include <ccnx/api/ccnx_Portal/ccnx_PortalInterceptor.h>
+
+#include <parc/algol/parc_Object.h>
+
+struct CCNxPortalInterceptor {
+    bool (*send)(void *state, const CCNxPortalInterceptor *next, const CCNxMetaMessage *message, const CCNxStackTimeout *microSeconds);
+    CCNxMetaMessage *(*receive)(void *state, const CCNxPortalInterceptor *next, const CCNxStackTimeout *microSeconds);
+    bool (*listen)(void *state, const CCNxPortalInterceptor *next, const CCNxName *name, const CCNxStackTimeout *microSeconds);
+    bool (*ignore)(void *state, const CCNxPortalInterceptor *next, const CCNxName *name, const CCNxStackTimeout *microSeconds);
+
+    void *state;
+    void (*releaseState)(void **state);
+
+    bool linked;
+    CCNxPortalInterceptor *next;
+
+    // The nearest layer, starting with this one, that handles each operation.
+    // These are resolved when the interceptor is linked so that pass-through layers cost nothing at dispatch.
+    const CCNxPortalInterceptor *sendLayer;
+    const CCNxPortalInterceptor *receiveLayer;
+    const CCNxPortalInterceptor *listenLayer;
+    const CCNxPortalInterceptor *ignoreLayer;
+};
+
+static void
+_ccnxPortalInterceptor_Destroy(CCNxPortalInterceptor **interceptorPtr)
+{
+    CCNxPortalInterceptor *interceptor = *interceptorPtr;
+
+    if (interceptor->releaseState != NULL && interceptor->state != NULL) {
+        interceptor->releaseState(&interceptor->state);
+    }
+    if (interceptor->next != NULL) {
+        ccnxPortalInterceptor_Release(&interceptor->next);
+    }
+}
+
+parcObject_ExtendPARCObject(CCNxPortalInterceptor, _ccnxPortalInterceptor_Destroy, NULL, NULL, NULL, NULL, NULL, NULL);
+
+parcObject_ImplementAcquire(ccnxPortalInterceptor, CCNxPortalInterceptor);
+
+parcObject_ImplementRelease(ccnxPortalInterceptor, CCNxPortalInterceptor);
+
+CCNxPortalInterceptor *
+ccnxPortalInterceptor_Create(bool (*send)(void *state, const CCNxPortalInterceptor *next, const CCNxMetaMessage *message, const CCNxStackTimeout *microSeconds),
+                             CCNxMetaMessage *(*receive)(void *state, const CCNxPortalInterceptor *next, const CCNxStackTimeout *microSeconds),
+                             bool (*listen)(void *state, const CCNxPortalInterceptor *next, const CCNxName *name, const CCNxStackTimeout *microSeconds),
+                             bool (*ignore)(void *state, const CCNxPortalInterceptor *next, const CCNxName *name, const CCNxStackTimeout *microSeconds),
+                             void *state,
+                             void (*releaseState)(void **state))
+{
+    CCNxPortalInterceptor *result = parcObject_CreateInstance(CCNxPortalInterceptor);
+
+    if (result != NULL) {
+        result->send = send;
+        result->receive = receive;
+        result->listen = listen;
+        result->ignore = ignore;
+        result->state = state;
+        result->releaseState = releaseState;
+        result->linked = false;
+        result->next = NULL;
+        result->sendLayer = (send != NULL) ? result : NULL;
+        result->receiveLayer = (receive != NULL) ? result : NULL;
+        result->listenLayer = (listen != NULL) ? result : NULL;
+        result->ignoreLayer = (ignore != NULL) ? result : NULL;
+    }
+    return result;
+}
+
+bool
+ccnxPortalInterceptor_Link(CCNxPortalInterceptor *interceptor, const CCNxPortalInterceptor *next)
+{
+    if (interceptor->linked) {
+        return false;
+    }
+
+    interceptor->linked = true;
+    if (next != NULL) {
+        interceptor->next = ccnxPortalInterceptor_Acquire(next);
+
+        if (interceptor->sendLayer == NULL) {
+            interceptor->sendLayer = next->sendLayer;
+        }
+        if (interceptor->receiveLayer == NULL) {
+            interceptor->receiveLayer = next->receiveLayer;
+        }
+        if (interceptor->listenLayer == NULL) {
+            interceptor->listenLayer = next->listenLayer;
+        }
+        if (interceptor->ignoreLayer == NULL) {
+            interceptor->ignoreLayer = next->ignoreLayer;
+        }
+    }
+    return true;
+}
+
+bool
+ccnxPortalInterceptor_Send(const CCNxPortalInterceptor *layer, const CCNxMetaMessage *message, const CCNxStackTimeout *microSeconds)
+{
+    layer = layer->sendLayer;
+    return layer->send(layer->state, layer->next, message, microSeconds);
+}
+
+CCNxMetaMessage *
+ccnxPortalInterceptor_Receive(const CCNxPortalInterceptor *layer, const CCNxStackTimeout *microSeconds)
+{
+    layer = layer->receiveLayer;
+    return layer->receive(layer->state, layer->next, microSeconds);
+}
+
+bool
+ccnxPortalInterceptor_Listen(const CCNxPortalInterceptor *layer, const CCNxName *name, const CCNxStackTimeout *microSeconds)
+{
+    layer = layer->listenLayer;
+    return layer->listen(layer->state, layer->next, name, microSeconds);
+}
+
+bool
+ccnxPortalInterceptor_Ignore(const CCNxPortalInterceptor *layer, const CCNxName *name, const CCNxStackTimeout *microSeconds)
+{
+    layer = layer->ignoreLayer;
+    return layer->ignore(layer->state, layer->next, name, microSeconds);
+}
@@ -0,0 +1,211 @@
+/*
+ * Copyright (c) 2016, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX OR PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ################################################################################
+ * #
+ * # PATENT NOTICE
+ * #
+ * # This software is distributed under the BSD 2-clause License (see LICENSE
+ * # file).  This BSD License does not make any patent claims and as such, does
+ * # not act as a patent grant.  The purpose of this section is for each contributor
+ * # to define their intentions with respect to intellectual property.
+ * #
+ * # Each contributor to this source code is encouraged to state their patent
+ * # claims and licensing mechanisms for any contributions made. At the end of
+ * # this section contributors may each make their own statements.  Contributor's
+ * # claims and grants only apply to the pieces (source code, programs, text,
+ * # media, etc) that they have contributed directly to this software.
+ * #
+ * # There is no guarantee that this section is complete, up to date or accurate. It
+ * # is up to the contributors to maintain their portion of this section and up to
+ * # the user of the software to verify any claims herein.
+ * #
+ * # Do not remove this header notification.  The contents of this section must be
+ * # present in all distributions of the software.  You may only modify your own
+ * # intellectual property statements.  Please provide contact information.
+ *
+ * - Palo Alto Research Center, Inc
+ * This software distribution does not grant any rights to patents owned by Palo
+ * Alto Research Center, Inc (PARC). Rights to these patents are available via
+ * various mechanisms. As of January 2016 PARC has committed to FRAND licensing any
+ * intellectual property used by its contributions to this software. You may
+ * contact PARC at cipo@parc.com for more information or visit http://www.ccnx.org
+ */
+/**
+ * @file ccnx_PortalInterceptor.h
+ * @brief A layer that intercepts the operations of a `CCNxPortalStack`.
+ *
+ * Interceptors are stacked on a `CCNxPortalStack` to add caching, metrics, tracing and similar behaviour
+ * without modifying the stack implementation.
+ * Each interceptor may wrap any of the send, receive, listen and ignore operations.
+ * A wrapping function receives the next (lower) layer and passes the operation down by calling the matching
+ * `ccnxPortalInterceptor_Send`, `ccnxPortalInterceptor_Receive`, `ccnxPortalInterceptor_Listen` or
+ * `ccnxPortalInterceptor_Ignore` function on it.
+ * An operation given as NULL is passed to the next layer unchanged.
+ *
+ * The most recently added interceptor is the outermost layer: it sees sent messages first and received messages last.
+ * A stack without interceptors dispatches directly to its implementation.
+ *
+ * @code
+ * static bool
+ * _countingSend(void *state, const CCNxPortalInterceptor *next, const CCNxMetaMessage *message, const CCNxStackTimeout *timeout)
+ * {
+ *     uint64_t *count = state;
+ *     (*count)++;
+ *     return ccnxPortalInterceptor_Send(next, message, timeout);
+ * }
+ *
+ * {
+ *     CCNxPortalInterceptor *counter = ccnxPortalInterceptor_Create(_countingSend, NULL, NULL, NULL, &count, NULL);
+ *     ccnxPortal_AddInterceptor(portal, counter);
+ *     ccnxPortalInterceptor_Release(&counter);
+ * }
+ * @endcode
+ *
+ * @copyright (c) 2016, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC).  All rights reserved.
+ */
+#ifndef CCNx_Portal_API_ccnx_PortalInterceptor_h
+#define CCNx_Portal_API_ccnx_PortalInterceptor_h
+
+struct CCNxPortalInterceptor;
+/**
+ * @typedef CCNxPortalInterceptor
+ * @brief One layer of operations stacked on a `CCNxPortalStack`.
+ */
+typedef struct CCNxPortalInterceptor CCNxPortalInterceptor;
+
+#include <stdbool.h>
+
+#include <ccnx/common/ccnx_Name.h>
+#include <ccnx/transport/common/transport_MetaMessage.h>
+#include <ccnx/transport/common/transport.h>
+
+/**
+ * Create a new `CCNxPortalInterceptor` from the given operations.
+ *
+ * Any operation may be NULL, in which case it is passed to the next layer unchanged.
+ *
+ * @param [in] send The function intercepting sent messages, or NULL.
+ * @param [in] receive The function intercepting received messages, or NULL.
+ * @param [in] listen The function intercepting listen requests, or NULL.
+ * @param [in] ignore The function intercepting ignore requests, or NULL.
+ * @param [in] state A pointer passed as the first argument of each operation.
+ * @param [in] releaseState If not NULL, called with a pointer to @p state when the interceptor is destroyed.
+ *
+ * @return non-NULL A pointer to a valid `CCNxPortalInterceptor` instance.
+ * @return NULL Memory could not be allocated.
+ *
+ * Example:
+ * @code
+ * {
+ *     CCNxPortalInterceptor *interceptor = ccnxPortalInterceptor_Create(_countingSend, NULL, NULL, NULL, &count, NULL);
+ *
+ *     ccnxPortalInterceptor_Release(&interceptor);
+ * }
+ * @endcode
+ */
+CCNxPortalInterceptor *
+ccnxPortalInterceptor_Create(bool (*send)(void *state, const CCNxPortalInterceptor *next, const CCNxMetaMessage *message, const CCNxStackTimeout *microSeconds),
+                             CCNxMetaMessage *(*receive)(void *state, const CCNxPortalInterceptor *next, const CCNxStackTimeout *microSeconds),
+                             bool (*listen)(void *state, const CCNxPortalInterceptor *next, const CCNxName *name, const CCNxStackTimeout *microSeconds),
+                             bool (*ignore)(void *state, const CCNxPortalInterceptor *next, const CCNxName *name, const CCNxStackTimeout *microSeconds),
+                             void *state,
+                             void (*releaseState)(void **state));
+
+/**
+ * Increase the number of references to a `CCNxPortalInterceptor` instance.
+ *
+ * @param [in] interceptor A pointer to a valid `CCNxPortalInterceptor` instance.
+ *
+ * @return The value of @p interceptor.
+ */
+CCNxPortalInterceptor *ccnxPortalInterceptor_Acquire(const CCNxPortalInterceptor *interceptor);
+
+/**
+ * Release a previously acquired reference to the specified instance,
+ * decrementing the reference count for the instance.
+ *
+ * When the last reference is released the state is released and the reference to the next layer, if any, is released.
+ *
+ * @param [in,out] interceptorPtr A pointer to a pointer to the instance to release.
+ */
+void ccnxPortalInterceptor_Release(CCNxPortalInterceptor **interceptorPtr);
+
+/**
+ * Link @p interceptor on top of @p next.
+ *
+ * An interceptor can be linked only once, and so belongs to at most one stack.
+ * This is used by `ccnxPortalStack_AddInterceptor` and is not normally called directly.
+ *
+ * @param [in] interceptor A pointer to a valid, unlinked `CCNxPortalInterceptor` instance.
+ * @param [in] next A pointer to the `CCNxPortalInterceptor` layer below, which must handle every operation.
+ *
+ * @return `true` The interceptor was linked.
+ * @return `false` The interceptor was already linked.
+ */
+bool ccnxPortalInterceptor_Link(CCNxPortalInterceptor *interceptor, const CCNxPortalInterceptor *next);
+
+/**
+ * Send a message through the given layer.
+ *
+ * @param [in] layer A pointer to a valid `CCNxPortalInterceptor` instance, typically the `next` argument of an operation.
+ * @param [in] message A pointer to a valid `CCNxMetaMessage` instance.
+ * @param [in] microSeconds A pointer to the timeout value.
+ *
+ * @return The result of the lower layer.
+ */
+bool ccnxPortalInterceptor_Send(const CCNxPortalInterceptor *layer, const CCNxMetaMessage *message, const CCNxStackTimeout *microSeconds);
+
+/**
+ * Receive a message through the given layer.
+ *
+ * @param [in] layer A pointer to a valid `CCNxPortalInterceptor` instance, typically the `next` argument of an operation.
+ * @param [in] microSeconds A pointer to the timeout value.
+ *
+ * @return The result of the lower layer.
+ */
+CCNxMetaMessage *ccnxPortalInterceptor_Receive(const CCNxPortalInterceptor *layer, const CCNxStackTimeout *microSeconds);
+
+/**
+ * Listen for a name through the given layer.
+ *
+ * @param [in] layer A pointer to a valid `CCNxPortalInterceptor` instance, typically the `next` argument of an operation.
+ * @param [in] name A pointer to a valid `CCNxName` instance.
+ * @param [in] microSeconds A pointer to the timeout value.
+ *
+ * @return The result of the lower layer.
+ */
+bool ccnxPortalInterceptor_Listen(const CCNxPortalInterceptor *layer, const CCNxName *name, const CCNxStackTimeout *microSeconds);
+
+/**
+ * Ignore a name through the given layer.
+ *
+ * @param [in] layer A pointer to a valid `CCNxPortalInterceptor` instance, typically the `next` argument of an operation.
+ * @param [in] name A pointer to a valid `CCNxName` instance.
+ * @param [in] microSeconds A pointer to the timeout value.
+ *
+ * @return The result of the lower layer.
+ */
+bool ccnxPortalInterceptor_Ignore(const CCNxPortalInterceptor *layer, const CCNxName *name, const CCNxStackTimeout *microSeconds);
+#endif // CCNx_Portal_API_ccnx_PortalInterceptor_h
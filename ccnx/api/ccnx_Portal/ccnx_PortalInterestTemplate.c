@@ -0,0 +1,280 @@
+/*
+ * Copyright (c) 2016, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX OR PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ################################################################################
+ * #
+ * # PATENT NOTICE
+ * #
+ * # This software is distributed under the BSD 2-clause License (see LICENSE
+ * # file).  This BSD License does not make any patent claims and as such, does
+ * # not act as a patent grant.  The purpose of this section is for each contributor
+ * # to define their intentions with respect to intellectual property.
+ * #
+ * # Each contributor to this source code is encouraged to state their patent
+ * # claims and licensing mechanisms for any contributions made. At the end of
+ * # this section contributors may each make their own statements.  Contributor's
+ * # claims and grants only apply to the pieces (source code, programs, text,
+ * # media, etc) that they have contributed directly to this software.
+ * #
+ * # There is no guarantee that this section is complete, up to date or accurate. It
+ * # is up to the contributors to maintain their portion of this section and up to
+ * # the user of the software to verify any claims herein.
+ * #
+ * # Do not remove this header notification.  The contents of this section must be
+ * # present in all distributions of the software.  You may only modify your own
+ * # intellectual property statements.  Please provide contact information.
+ *
+ * - Palo Alto Research Center, Inc
+ * This software distribution does not grant any rights to patents owned by Palo
+ * Alto Research Center, Inc (PARC). Rights to these patents are available via
+ * various mechanisms. As of January 2016 PARC has committed to FRAND licensing any
+ * intellectual property used by its contributions to this software. You may
+ * contact PARC at cipo@parc.com for more information or visit http://www.ccnx.org
+ */
+/**
+ * @copyright (c) 2016, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC).  All rights reserved.
+ */
+#include <config.h>
+
+#include <errno.h>
+#include <string.h>
+
+#include <LongBow/runtime.h>
+
+#include <parc/algol/parc_Object.h>
+#include <parc/algol/parc_Memory.h>
+#include <parc/algol/parc_Buffer.h>
+
+#include <ccnx/api/ccnx_Portal/ccnx_PortalInterestTemplate.h>
+
+#include <ccnx/common/ccnx_WireFormatMessage.h>
+
+// The layout of a version 1 CCNx packet: a fixed header, hop-by-hop headers, then the message TLV containing the name TLV.
+#define _ccnxPortalInterestTemplate_Version 1
+#define _ccnxPortalInterestTemplate_FixedHeaderLength 8
+#define _ccnxPortalInterestTemplate_PacketLengthOffset 2
+#define _ccnxPortalInterestTemplate_HeaderLengthOffset 7
+#define _ccnxPortalInterestTemplate_TLHeaderLength 4
+#define _ccnxPortalInterestTemplate_TypeInterest 0x0001
+#define _ccnxPortalInterestTemplate_TypeName 0x0000
+
+// The length fields that enclose the final name segment's value, outermost first.
+typedef enum {
+    _CCNxPortalInterestTemplateLength_Packet = 0,
+    _CCNxPortalInterestTemplateLength_Message = 1,
+    _CCNxPortalInterestTemplateLength_Name = 2,
+    _CCNxPortalInterestTemplateLength_Segment = 3,
+    _CCNxPortalInterestTemplateLength_Count = 4
+} _CCNxPortalInterestTemplateLength;
+
+struct CCNxPortalInterestTemplate {
+    uint8_t *encoding;
+    size_t length;
+
+    size_t valueOffset;      // The offset of the final name segment's value.
+    size_t valueLength;      // The length of the final name segment's value in the encoding.
+
+    size_t lengthOffset[_CCNxPortalInterestTemplateLength_Count];
+    size_t lengthValue[_CCNxPortalInterestTemplateLength_Count];
+};
+
+static uint16_t
+_ccnxPortalInterestTemplate_GetUint16(const uint8_t *bytes)
+{
+    return (uint16_t) ((bytes[0] << 8) | bytes[1]);
+}
+
+static void
+_ccnxPortalInterestTemplate_PutUint16(uint8_t *bytes, size_t value)
+{
+    bytes[0] = (uint8_t) (value >> 8);
+    bytes[1] = (uint8_t) value;
+}
+
+/*
+ * Find the TLV of the given type among those between offset and end, returning its offset, or 0 if there is none.
+ */
+static size_t
+_ccnxPortalInterestTemplate_Find(const uint8_t *bytes, size_t offset, size_t end, uint16_t type)
+{
+    while (offset + _ccnxPortalInterestTemplate_TLHeaderLength <= end) {
+        size_t length = _ccnxPortalInterestTemplate_GetUint16(bytes + offset + 2);
+        if (_ccnxPortalInterestTemplate_GetUint16(bytes + offset) == type) {
+            return (offset + _ccnxPortalInterestTemplate_TLHeaderLength + length <= end) ? offset : 0;
+        }
+        offset += _ccnxPortalInterestTemplate_TLHeaderLength + length;
+    }
+    return 0;
+}
+
+/*
+ * Locate the final name segment, and the lengths that enclose it, in the template's encoding.
+ */
+static bool
+_ccnxPortalInterestTemplate_Parse(CCNxPortalInterestTemplate *template)
+{
+    const uint8_t *bytes = template->encoding;
+
+    if (template->length < _ccnxPortalInterestTemplate_FixedHeaderLength
+        || bytes[0] != _ccnxPortalInterestTemplate_Version
+        || _ccnxPortalInterestTemplate_GetUint16(bytes + _ccnxPortalInterestTemplate_PacketLengthOffset) != template->length) {
+        return false;
+    }
+    template->lengthOffset[_CCNxPortalInterestTemplateLength_Packet] = _ccnxPortalInterestTemplate_PacketLengthOffset;
+
+    size_t headerLength = bytes[_ccnxPortalInterestTemplate_HeaderLengthOffset];
+    if (headerLength < _ccnxPortalInterestTemplate_FixedHeaderLength) {
+        return false;
+    }
+
+    size_t message = _ccnxPortalInterestTemplate_Find(bytes, headerLength, template->length, _ccnxPortalInterestTemplate_TypeInterest);
+    if (message == 0) {
+        return false;
+    }
+    template->lengthOffset[_CCNxPortalInterestTemplateLength_Message] = message + 2;
+
+    size_t messageEnd = message + _ccnxPortalInterestTemplate_TLHeaderLength + _ccnxPortalInterestTemplate_GetUint16(bytes + message + 2);
+    size_t name = _ccnxPortalInterestTemplate_Find(bytes, message + _ccnxPortalInterestTemplate_TLHeaderLength, messageEnd,
+                                                   _ccnxPortalInterestTemplate_TypeName);
+    if (name == 0) {
+        return false;
+    }
+    template->lengthOffset[_CCNxPortalInterestTemplateLength_Name] = name + 2;
+
+    size_t segment = name + _ccnxPortalInterestTemplate_TLHeaderLength;
+    size_t nameEnd = segment + _ccnxPortalInterestTemplate_GetUint16(bytes + name + 2);
+    size_t lastSegment = 0;
+    while (segment + _ccnxPortalInterestTemplate_TLHeaderLength <= nameEnd) {
+        lastSegment = segment;
+        segment += _ccnxPortalInterestTemplate_TLHeaderLength + _ccnxPortalInterestTemplate_GetUint16(bytes + segment + 2);
+    }
+    if (lastSegment == 0 || segment != nameEnd) {
+        return false;
+    }
+    template->lengthOffset[_CCNxPortalInterestTemplateLength_Segment] = lastSegment + 2;
+
+    template->valueOffset = lastSegment + _ccnxPortalInterestTemplate_TLHeaderLength;
+    template->valueLength = _ccnxPortalInterestTemplate_GetUint16(bytes + lastSegment + 2);
+
+    for (int i = 0; i < _CCNxPortalInterestTemplateLength_Count; i++) {
+        template->lengthValue[i] = _ccnxPortalInterestTemplate_GetUint16(bytes + template->lengthOffset[i]);
+    }
+
+    return true;
+}
+
+static void
+_ccnxPortalInterestTemplate_Destroy(CCNxPortalInterestTemplate **templatePtr)
+{
+    CCNxPortalInterestTemplate *template = *templatePtr;
+
+    if (template->encoding != NULL) {
+        parcMemory_Deallocate(&template->encoding);
+    }
+}
+
+parcObject_ExtendPARCObject(CCNxPortalInterestTemplate, _ccnxPortalInterestTemplate_Destroy, NULL, NULL, NULL, NULL, NULL, NULL);
+
+parcObject_ImplementAcquire(ccnxPortalInterestTemplate, CCNxPortalInterestTemplate);
+
+parcObject_ImplementRelease(ccnxPortalInterestTemplate, CCNxPortalInterestTemplate);
+
+CCNxPortalInterestTemplate *
+ccnxPortalInterestTemplate_Create(const CCNxInterest *interest)
+{
+    CCNxMetaMessage *message = ccnxMetaMessage_CreateFromInterest(interest);
+    PARCBuffer *wireFormat = ccnxMetaMessage_CreateWireFormatBuffer(message, NULL);
+    ccnxMetaMessage_Release(&message);
+
+    if (wireFormat == NULL) {
+        errno = EINVAL;
+        return NULL;
+    }
+
+    CCNxPortalInterestTemplate *result = parcObject_CreateInstance(CCNxPortalInterestTemplate);
+    if (result != NULL) {
+        result->length = parcBuffer_Remaining(wireFormat);
+        result->encoding = parcMemory_Allocate(result->length);
+        if (result->encoding != NULL) {
+            parcBuffer_GetBytes(wireFormat, result->length, result->encoding);
+        }
+        if (result->encoding == NULL || _ccnxPortalInterestTemplate_Parse(result) == false) {
+            ccnxPortalInterestTemplate_Release(&result);
+            errno = EINVAL;
+        }
+    }
+
+    parcBuffer_Release(&wireFormat);
+    return result;
+}
+
+CCNxMetaMessage *
+ccnxPortalInterestTemplate_CreateMessage(const CCNxPortalInterestTemplate *template, const uint8_t *value, size_t length)
+{
+    // Every enclosing length grows or shrinks by the same amount. The packet length is the largest.
+    size_t packetLength = template->length - template->valueLength + length;
+    if (packetLength > UINT16_MAX) {
+        errno = EINVAL;
+        return NULL;
+    }
+
+    PARCBuffer *wireFormat = parcBuffer_Allocate(packetLength);
+    uint8_t *bytes = parcBuffer_Overlay(wireFormat, 0);
+
+    size_t tailOffset = template->valueOffset + template->valueLength;
+    memcpy(bytes, template->encoding, template->valueOffset);
+    memcpy(bytes + template->valueOffset, value, length);
+    memcpy(bytes + template->valueOffset + length, template->encoding + tailOffset, template->length - tailOffset);
+
+    for (int i = 0; i < _CCNxPortalInterestTemplateLength_Count; i++) {
+        _ccnxPortalInterestTemplate_PutUint16(bytes + template->lengthOffset[i], template->lengthValue[i] - template->valueLength + length);
+    }
+
+    CCNxMetaMessage *result = ccnxWireFormatMessage_Create(wireFormat);
+    parcBuffer_Release(&wireFormat);
+
+    return result;
+}
+
+CCNxMetaMessage *
+ccnxPortalInterestTemplate_CreateMessageWithNumber(const CCNxPortalInterestTemplate *template, uint64_t number)
+{
+    uint8_t value[sizeof(uint64_t)];
+
+    size_t length = 1;
+    while (length < sizeof(value) && (number >> (length * 8)) != 0) {
+        length++;
+    }
+    for (size_t i = 0; i < length; i++) {
+        value[i] = (uint8_t) (number >> ((length - 1 - i) * 8));
+    }
+
+    return ccnxPortalInterestTemplate_CreateMessage(template, value, length);
+}
+
+size_t
+ccnxPortalInterestTemplate_GetLength(const CCNxPortalInterestTemplate *template)
+{
+    return template->length;
+}
@@ -0,0 +1,209 @@
+/*
+ * Copyright (c) 2016, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX OR PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ################################################################################
+ * #
+ * # PATENT NOTICE
+ * #
+ * # This software is distributed under the BSD 2-clause License (see LICENSE
+ * # file).  This BSD License does not make any patent claims and as such, does
+ * # not act as a patent grant.  The purpose of this section is for each contributor
+ * # to define their intentions with respect to intellectual property.
+ * #
+ * # Each contributor to this source code is encouraged to state their patent
+ * # claims and licensing mechanisms for any contributions made. At the end of
+ * # this section contributors may each make their own statements.  Contributor's
+ * # claims and grants only apply to the pieces (source code, programs, text,
+ * # media, etc) that they have contributed directly to this software.
+ * #
+ * # There is no guarantee that this section is complete, up to date or accurate. It
+ * # is up to the contributors to maintain their portion of this section and up to
+ * # the user of the software to verify any claims herein.
+ * #
+ * # Do not remove this header notification.  The contents of this section must be
+ * # present in all distributions of the software.  You may only modify your own
+ * # intellectual property statements.  Please provide contact information.
+ *
+ * - Palo Alto Research Center, Inc
+ * This software distribution does not grant any rights to patents owned by Palo
+ * Alto Research Center, Inc (PARC). Rights to these patents are available via
+ * various mechanisms. As of January 2016 PARC has committed to FRAND licensing any
+ * intellectual property used by its contributions to this software. You may
+ * contact PARC at cipo@parc.com for more information or visit http://www.ccnx.org
+ */
+/**
+ * @file ccnx_PortalInterestTemplate.h
+ * @brief Send Interests that differ only in their final name segment without encoding each one.
+ *
+ * A consumer fetching a sequence of chunks sends Interests that differ only in the value of the last name segment.
+ * Creating a `CCNxInterest` for each, and having the stack encode it, repeats the same work for every send.
+ * An Interest template encodes an Interest once. Each message made from it is a copy of that encoding
+ * with a new value for the final name segment, and the enclosing lengths adjusted to suit.
+ *
+ * A message made from a template carries only its wire format; it is not decoded.
+ * Stacks that encode messages (the RTA stack does) send the wire format as it is.
+ * The loopback stacks pass the message to the receiver as it is, so its name is not available there.
+ *
+ * Templates are immutable once created and may be shared between threads.
+ *
+ * @copyright (c) 2016, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC).  All rights reserved.
+ */
+#ifndef CCNx_Portal_API_ccnx_PortalInterestTemplate_h
+#define CCNx_Portal_API_ccnx_PortalInterestTemplate_h
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <ccnx/common/ccnx_Interest.h>
+#include <ccnx/transport/common/transport_MetaMessage.h>
+
+struct CCNxPortalInterestTemplate;
+/**
+ * @typedef CCNxPortalInterestTemplate
+ * @brief An encoded Interest whose final name segment can be replaced.
+ */
+typedef struct CCNxPortalInterestTemplate CCNxPortalInterestTemplate;
+
+/**
+ * Create a new `CCNxPortalInterestTemplate` from the given Interest.
+ *
+ * The Interest is encoded once, unsigned. Its final name segment is the one each message replaces;
+ * the segment's type is kept and only its value changes.
+ *
+ * @param [in] interest A pointer to a valid `CCNxInterest` instance with at least one name segment.
+ *
+ * @return non-NULL A pointer to a valid `CCNxPortalInterestTemplate` instance.
+ * @return NULL The Interest has no name segments or could not be encoded. `errno` is set to `EINVAL`.
+ *
+ * Example:
+ * @code
+ * {
+ *     CCNxName *name = ccnxName_CreateFromCString("lci:/ccnx/example/Chunk=0");
+ *     CCNxInterest *interest = ccnxInterest_CreateSimple(name);
+ *
+ *     CCNxPortalInterestTemplate *template = ccnxPortalInterestTemplate_Create(interest);
+ *
+ *     ccnxInterest_Release(&interest);
+ *     ccnxName_Release(&name);
+ *     ccnxPortalInterestTemplate_Release(&template);
+ * }
+ * @endcode
+ */
+CCNxPortalInterestTemplate *ccnxPortalInterestTemplate_Create(const CCNxInterest *interest);
+
+/**
+ * Increase the number of references to a `CCNxPortalInterestTemplate` instance.
+ *
+ * @param [in] template A pointer to a valid `CCNxPortalInterestTemplate` instance.
+ *
+ * @return The same value as @p template.
+ *
+ * Example:
+ * @code
+ * {
+ *     CCNxPortalInterestTemplate *template = ccnxPortalInterestTemplate_Create(interest);
+ *     CCNxPortalInterestTemplate *reference = ccnxPortalInterestTemplate_Acquire(template);
+ *
+ *     ccnxPortalInterestTemplate_Release(&template);
+ *     ccnxPortalInterestTemplate_Release(&reference);
+ * }
+ * @endcode
+ */
+CCNxPortalInterestTemplate *ccnxPortalInterestTemplate_Acquire(const CCNxPortalInterestTemplate *template);
+
+/**
+ * Release a previously acquired reference to the given `CCNxPortalInterestTemplate` instance,
+ * decrementing the reference count for the instance.
+ *
+ * The pointer to the instance is set to NULL as a side-effect of this function.
+ * Messages made from the template remain valid until their own last reference is released.
+ *
+ * @param [in,out] templatePtr A pointer to a pointer to the instance to release.
+ *
+ * Example:
+ * @code
+ * {
+ *     CCNxPortalInterestTemplate *template = ccnxPortalInterestTemplate_Create(interest);
+ *
+ *     ccnxPortalInterestTemplate_Release(&template);
+ * }
+ * @endcode
+ */
+void ccnxPortalInterestTemplate_Release(CCNxPortalInterestTemplate **templatePtr);
+
+/**
+ * Create an Interest message from the template, with @p value as the value of the final name segment.
+ *
+ * @param [in] template A pointer to a valid `CCNxPortalInterestTemplate` instance.
+ * @param [in] value A pointer to the segment value.
+ * @param [in] length The length of the segment value in bytes.
+ *
+ * @return non-NULL A pointer to a `CCNxMetaMessage` instance holding the encoded Interest, that must be released by the caller.
+ * @return NULL The encoded Interest would exceed the largest packet length. `errno` is set to `EINVAL`.
+ *
+ * Example:
+ * @code
+ * {
+ *     CCNxMetaMessage *message = ccnxPortalInterestTemplate_CreateMessage(template, (const uint8_t *) "b", 1);
+ *
+ *     ccnxPortal_Send(portal, message, CCNxStackTimeout_Never);
+ *     ccnxMetaMessage_Release(&message);
+ * }
+ * @endcode
+ */
+CCNxMetaMessage *ccnxPortalInterestTemplate_CreateMessage(const CCNxPortalInterestTemplate *template, const uint8_t *value, size_t length);
+
+/**
+ * Create an Interest message from the template, with @p number as the value of the final name segment.
+ *
+ * The number is encoded as a numeric name segment value is, in the fewest big-endian bytes,
+ * so the final segment of the template is typically a chunk or sequence number segment.
+ *
+ * @param [in] template A pointer to a valid `CCNxPortalInterestTemplate` instance.
+ * @param [in] number The segment value.
+ *
+ * @return A pointer to a `CCNxMetaMessage` instance holding the encoded Interest, that must be released by the caller.
+ *
+ * Example:
+ * @code
+ * {
+ *     for (uint64_t chunk = 0; chunk < chunks; chunk++) {
+ *         CCNxMetaMessage *message = ccnxPortalInterestTemplate_CreateMessageWithNumber(template, chunk);
+ *         ccnxPortal_Send(portal, message, CCNxStackTimeout_Never);
+ *         ccnxMetaMessage_Release(&message);
+ *     }
+ * }
+ * @endcode
+ */
+CCNxMetaMessage *ccnxPortalInterestTemplate_CreateMessageWithNumber(const CCNxPortalInterestTemplate *template, uint64_t number);
+
+/**
+ * Get the length in bytes of the template's encoded Interest.
+ *
+ * @param [in] template A pointer to a valid `CCNxPortalInterestTemplate` instance.
+ *
+ * @return The length of the encoded Interest, with the final name segment value as given to `ccnxPortalInterestTemplate_Create`.
+ */
+size_t ccnxPortalInterestTemplate_GetLength(const CCNxPortalInterestTemplate *template);
+#endif // CCNx_Portal_API_ccnx_PortalInterestTemplate_h
@@ -0,0 +1,460 @@
+/*
+ * Copyright (c) 2016, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX OR PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ################################################################################
+ * #
+ * # PATENT NOTICE
+ * #
+ * # This software is distributed under the BSD 2-clause License (see LICENSE
+ * # file).  This BSD License does not make any patent claims and as such, does
+ * # not act as a patent grant.  The purpose of this section is for each contributor
+ * # to define their intentions with respect to intellectual property.
+ * #
+ * # Each contributor to this source code is encouraged to state their patent
+ * # claims and licensing mechanisms for any contributions made. At the end of
+ * # this section contributors may each make their own statements.  Contributor's
+ * # claims and grants only apply to the pieces (source code, programs, text,
+ * # media, etc) that they have contributed directly to this software.
+ * #
+ * # There is no guarantee that this section is complete, up to date or accurate. It
+ * # is up to the contributors to maintain their portion of this section and up to
+ * # the user of the software to verify any claims herein.
+ * #
+ * # Do not remove this header notification.  The contents of this section must be
+ * # present in all distributions of the software.  You may only modify your own
+ * # intellectual property statements.  Please provide contact information.
+ *
+ * - Palo Alto Research Center, Inc
+ * This software distribution does not grant any rights to patents owned by Palo
+ * Alto Research Center, Inc (PARC). Rights to these patents are available via
+ * various mechanisms. As of January 2016 PARC has committed to FRAND licensing any
+ * intellectual property used by its contributions to this software. You may
+ * contact PARC at cipo@parc.com for more information or visit http://www.ccnx.org
+ */
+/**
+ * @copyright (c) 2016, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC).  All rights reserved.
+ */
+#include <config.h>
+
+#include <errno.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <LongBow/runtime.h>
+
+#include <ccnx/api/ccnx_Portal/ccnx_PortalLogger.h>
+
+/*
+ * The ring is a bounded multi-producer, single-consumer queue.
+ * Each slot carries a sequence number: a producer may fill the slot at position p when its sequence is p,
+ * and publishes it by setting the sequence to p + 1; the consumer releases it by setting the sequence to p + _ringSize.
+ */
+#define _ringSize 4096
+#define _ringMask (_ringSize - 1)
+#define _categoryNameLength 32
+
+typedef struct {
+    uint64_t sequence;
+    uint64_t timestamp;
+    const char *format;
+    int64_t arguments[4];
+    CCNxPortalLoggerCategory category;
+    PARCLogLevel level;
+} _LogRecord;
+
+typedef struct {
+    bool inUse;
+    char name[_categoryNameLength];
+} _Category;
+
+const CCNxPortalLoggerCategory CCNxPortalLogger_DefaultCategory = 0;
+
+const CCNxPortalLoggerCategory CCNxPortalLogger_NoCategory = CCNxPortalLogger_MaxCategories;
+
+PARCLogLevel ccnxPortalLogger_CategoryLevels[CCNxPortalLogger_MaxCategories];
+
+static struct {
+    _LogRecord ring[_ringSize];
+    uint64_t head;
+    uint64_t tail;
+    uint64_t dropped;
+
+    // Held by the one thread consuming the ring and writing to the output.
+    pthread_mutex_t drainLock;
+    FILE *output;
+
+    pthread_mutex_t categoryLock;
+    _Category categories[CCNxPortalLogger_MaxCategories];
+
+    pthread_once_t once;
+
+    // The background thread runs while any category but the default is added. Held to start or stop it.
+    pthread_mutex_t threadLock;
+    unsigned int references;
+    pthread_t thread;
+    bool threaded;
+
+    // The background thread waits on wakeup when the ring is empty, and producers signal it only while it is waiting.
+    pthread_mutex_t wakeLock;
+    pthread_cond_t wakeup;
+    bool waiting;
+    bool stopping;
+} _logger = {
+    .drainLock    = PTHREAD_MUTEX_INITIALIZER,
+    .categoryLock = PTHREAD_MUTEX_INITIALIZER,
+    .categories   = { [0] = { .inUse = true, .name = "ccnxPortal" } },
+    .once         = PTHREAD_ONCE_INIT,
+    .threadLock   = PTHREAD_MUTEX_INITIALIZER,
+    .wakeLock     = PTHREAD_MUTEX_INITIALIZER,
+    .wakeup       = PTHREAD_COND_INITIALIZER
+};
+
+/*
+ * True if the record at the tail of the ring is ready to be taken.
+ */
+static bool
+_ccnxPortalLogger_IsReady(void)
+{
+    uint64_t position = __atomic_load_n(&_logger.tail, __ATOMIC_ACQUIRE);
+    return __atomic_load_n(&_logger.ring[position & _ringMask].sequence, __ATOMIC_ACQUIRE) == position + 1;
+}
+
+static bool
+_ccnxPortalLogger_Take(_LogRecord *record)
+{
+    uint64_t position = __atomic_load_n(&_logger.tail, __ATOMIC_RELAXED);
+    _LogRecord *slot = &_logger.ring[position & _ringMask];
+
+    if (__atomic_load_n(&slot->sequence, __ATOMIC_ACQUIRE) != position + 1) {
+        return false;
+    }
+
+    *record = *slot;
+    __atomic_store_n(&slot->sequence, position + _ringSize, __ATOMIC_RELEASE);
+    __atomic_store_n(&_logger.tail, position + 1, __ATOMIC_RELEASE);
+    return true;
+}
+
+/*
+ * Copy the category's name, so it can be written without holding the category lock.
+ */
+static void
+_ccnxPortalLogger_GetCategoryName(CCNxPortalLoggerCategory category, char name[_categoryNameLength])
+{
+    pthread_mutex_lock(&_logger.categoryLock);
+    if (category < CCNxPortalLogger_MaxCategories && _logger.categories[category].inUse) {
+        memcpy(name, _logger.categories[category].name, _categoryNameLength);
+    } else {
+        strcpy(name, "removed");
+    }
+    pthread_mutex_unlock(&_logger.categoryLock);
+}
+
+static void
+_ccnxPortalLogger_Format(FILE *output, const _LogRecord *record)
+{
+    char message[256];
+    snprintf(message, sizeof(message), record->format,
+             record->arguments[0], record->arguments[1], record->arguments[2], record->arguments[3]);
+
+    char name[_categoryNameLength];
+    _ccnxPortalLogger_GetCategoryName(record->category, name);
+
+    fprintf(output, "%" PRIu64 ".%06" PRIu64 " %-9s %s: %s\n",
+            record->timestamp / UINT64_C(1000000000), (record->timestamp % UINT64_C(1000000000)) / UINT64_C(1000),
+            parcLogLevel_ToString(record->level), name, message);
+}
+
+/*
+ * Drain the ring, returning the number of records written.
+ */
+static size_t
+_ccnxPortalLogger_Drain(void)
+{
+    size_t result = 0;
+    _LogRecord record;
+
+    pthread_mutex_lock(&_logger.drainLock);
+    FILE *output = (_logger.output == NULL) ? stderr : _logger.output;
+    while (_ccnxPortalLogger_Take(&record)) {
+        _ccnxPortalLogger_Format(output, &record);
+        result++;
+    }
+    if (result > 0) {
+        fflush(output);
+    }
+    pthread_mutex_unlock(&_logger.drainLock);
+
+    return result;
+}
+
+static void *
+_ccnxPortalLogger_Run(void *unused)
+{
+    pthread_mutex_lock(&_logger.wakeLock);
+    while (!_logger.stopping) {
+        pthread_mutex_unlock(&_logger.wakeLock);
+        _ccnxPortalLogger_Drain();
+        pthread_mutex_lock(&_logger.wakeLock);
+
+        // Announce the wait before looking at the ring again, so that a producer publishing after the look signals.
+        __atomic_store_n(&_logger.waiting, true, __ATOMIC_RELAXED);
+        __atomic_thread_fence(__ATOMIC_SEQ_CST);
+        if (!_logger.stopping && !_ccnxPortalLogger_IsReady()) {
+            pthread_cond_wait(&_logger.wakeup, &_logger.wakeLock);
+        }
+        __atomic_store_n(&_logger.waiting, false, __ATOMIC_RELAXED);
+    }
+    pthread_mutex_unlock(&_logger.wakeLock);
+
+    _ccnxPortalLogger_Drain();
+    return NULL;
+}
+
+/*
+ * Wake the background thread, if it is waiting, after publishing a record.
+ */
+static void
+_ccnxPortalLogger_Wake(void)
+{
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&_logger.waiting, __ATOMIC_RELAXED)) {
+        pthread_mutex_lock(&_logger.wakeLock);
+        if (_logger.waiting) {
+            _logger.waiting = false;
+            pthread_cond_signal(&_logger.wakeup);
+        }
+        pthread_mutex_unlock(&_logger.wakeLock);
+    }
+}
+
+/*
+ * Start the background thread. Called holding the thread lock.
+ */
+static void
+_ccnxPortalLogger_StartThread(void)
+{
+    _logger.stopping = false;
+    if (pthread_create(&_logger.thread, NULL, _ccnxPortalLogger_Run, NULL) == 0) {
+        __atomic_store_n(&_logger.threaded, true, __ATOMIC_RELEASE);
+    }
+}
+
+/*
+ * Stop and join the background thread, then write anything appended while it stopped. Called holding the thread lock.
+ */
+static void
+_ccnxPortalLogger_StopThread(void)
+{
+    if (!__atomic_load_n(&_logger.threaded, __ATOMIC_RELAXED)) {
+        return;
+    }
+    // From here producers write their own records.
+    __atomic_store_n(&_logger.threaded, false, __ATOMIC_RELEASE);
+
+    pthread_mutex_lock(&_logger.wakeLock);
+    _logger.stopping = true;
+    pthread_cond_signal(&_logger.wakeup);
+    pthread_mutex_unlock(&_logger.wakeLock);
+
+    pthread_join(_logger.thread, NULL);
+    _ccnxPortalLogger_Drain();
+}
+
+static void
+_ccnxPortalLogger_AtExit(void)
+{
+    _ccnxPortalLogger_Drain();
+}
+
+static void
+_ccnxPortalLogger_Initialize(void)
+{
+    for (uint64_t i = 0; i < _ringSize; i++) {
+        __atomic_store_n(&_logger.ring[i].sequence, i, __ATOMIC_RELAXED);
+    }
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+
+    atexit(_ccnxPortalLogger_AtExit);
+}
+
+bool
+ccnxPortalLogger_Write(CCNxPortalLoggerCategory category, PARCLogLevel level, const char *format,
+                       int64_t a0, int64_t a1, int64_t a2, int64_t a3)
+{
+    pthread_once(&_logger.once, _ccnxPortalLogger_Initialize);
+
+    struct timespec now;
+    clock_gettime(CLOCK_REALTIME, &now);
+
+    uint64_t position = __atomic_load_n(&_logger.head, __ATOMIC_RELAXED);
+    _LogRecord *slot;
+    while (true) {
+        slot = &_logger.ring[position & _ringMask];
+        int64_t difference = (int64_t) (__atomic_load_n(&slot->sequence, __ATOMIC_ACQUIRE) - position);
+        if (difference == 0) {
+            if (__atomic_compare_exchange_n(&_logger.head, &position, position + 1, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+                break;
+            }
+        } else if (difference < 0) {
+            __atomic_fetch_add(&_logger.dropped, 1, __ATOMIC_RELAXED);
+            return false;
+        } else {
+            position = __atomic_load_n(&_logger.head, __ATOMIC_RELAXED);
+        }
+    }
+
+    slot->timestamp = (uint64_t) now.tv_sec * UINT64_C(1000000000) + (uint64_t) now.tv_nsec;
+    slot->format = format;
+    slot->arguments[0] = a0;
+    slot->arguments[1] = a1;
+    slot->arguments[2] = a2;
+    slot->arguments[3] = a3;
+    slot->category = category;
+    slot->level = level;
+    __atomic_store_n(&slot->sequence, position + 1, __ATOMIC_RELEASE);
+
+    if (__atomic_load_n(&_logger.threaded, __ATOMIC_ACQUIRE)) {
+        _ccnxPortalLogger_Wake();
+    } else {
+        _ccnxPortalLogger_Drain();
+    }
+
+    return true;
+}
+
+CCNxPortalLoggerCategory
+ccnxPortalLogger_AddCategory(const char *name)
+{
+    pthread_once(&_logger.once, _ccnxPortalLogger_Initialize);
+
+    CCNxPortalLoggerCategory result = CCNxPortalLogger_NoCategory;
+
+    pthread_mutex_lock(&_logger.categoryLock);
+    for (CCNxPortalLoggerCategory i = 1; i < CCNxPortalLogger_MaxCategories; i++) {
+        if (!_logger.categories[i].inUse) {
+            _logger.categories[i].inUse = true;
+            strncpy(_logger.categories[i].name, name, _categoryNameLength - 1);
+            _logger.categories[i].name[_categoryNameLength - 1] = 0;
+            __atomic_store_n(&ccnxPortalLogger_CategoryLevels[i], PARCLogLevel_Off, __ATOMIC_RELAXED);
+            result = i;
+            break;
+        }
+    }
+    pthread_mutex_unlock(&_logger.categoryLock);
+
+    if (result == CCNxPortalLogger_NoCategory) {
+        errno = ENOSPC;
+        return result;
+    }
+
+    pthread_mutex_lock(&_logger.threadLock);
+    if (_logger.references++ == 0) {
+        _ccnxPortalLogger_StartThread();
+    }
+    pthread_mutex_unlock(&_logger.threadLock);
+
+    return result;
+}
+
+void
+ccnxPortalLogger_RemoveCategory(CCNxPortalLoggerCategory category)
+{
+    if (category == CCNxPortalLogger_DefaultCategory || category >= CCNxPortalLogger_MaxCategories) {
+        return;
+    }
+
+    pthread_mutex_lock(&_logger.categoryLock);
+    bool removed = _logger.categories[category].inUse;
+    __atomic_store_n(&ccnxPortalLogger_CategoryLevels[category], PARCLogLevel_Off, __ATOMIC_RELAXED);
+    _logger.categories[category].inUse = false;
+    pthread_mutex_unlock(&_logger.categoryLock);
+
+    if (removed) {
+        pthread_mutex_lock(&_logger.threadLock);
+        if (--_logger.references == 0) {
+            _ccnxPortalLogger_StopThread();
+        }
+        pthread_mutex_unlock(&_logger.threadLock);
+    }
+}
+
+void
+ccnxPortalLogger_SetLevel(CCNxPortalLoggerCategory category, PARCLogLevel level)
+{
+    if (category == CCNxPortalLogger_NoCategory) {
+        return;
+    }
+    assertTrue(category < CCNxPortalLogger_MaxCategories, "Invalid category %u", category);
+    __atomic_store_n(&ccnxPortalLogger_CategoryLevels[category], level, __ATOMIC_RELAXED);
+}
+
+PARCLogLevel
+ccnxPortalLogger_GetLevel(CCNxPortalLoggerCategory category)
+{
+    if (category == CCNxPortalLogger_NoCategory) {
+        return PARCLogLevel_Off;
+    }
+    assertTrue(category < CCNxPortalLogger_MaxCategories, "Invalid category %u", category);
+    return __atomic_load_n(&ccnxPortalLogger_CategoryLevels[category], __ATOMIC_RELAXED);
+}
+
+void
+ccnxPortalLogger_SetOutput(FILE *output)
+{
+    ccnxPortalLogger_Flush();
+
+    pthread_mutex_lock(&_logger.drainLock);
+    _logger.output = output;
+    pthread_mutex_unlock(&_logger.drainLock);
+}
+
+void
+ccnxPortalLogger_Flush(void)
+{
+    pthread_once(&_logger.once, _ccnxPortalLogger_Initialize);
+
+    uint64_t target = __atomic_load_n(&_logger.head, __ATOMIC_ACQUIRE);
+    struct timespec pause = { .tv_sec = 0, .tv_nsec = 100000 };
+
+    // Drain here rather than wait for the background thread, which may not be running.
+    // A record whose writer has not yet finished it holds up the ones after it, so pause until it is.
+    while (__atomic_load_n(&_logger.tail, __ATOMIC_ACQUIRE) < target) {
+        if (_ccnxPortalLogger_Drain() == 0) {
+            nanosleep(&pause, NULL);
+        }
+    }
+
+    pthread_mutex_lock(&_logger.drainLock);
+    fflush((_logger.output == NULL) ? stderr : _logger.output);
+    pthread_mutex_unlock(&_logger.drainLock);
+}
+
+uint64_t
+ccnxPortalLogger_GetDropped(void)
+{
+    return __atomic_load_n(&_logger.dropped, __ATOMIC_RELAXED);
+}
@@ -0,0 +1,244 @@
+/*
+ * Copyright (c) 2016, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX OR PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ################################################################################
+ * #
+ * # PATENT NOTICE
+ * #
+ * # This software is distributed under the BSD 2-clause License (see LICENSE
+ * # file).  This BSD License does not make any patent claims and as such, does
+ * # not act as a patent grant.  The purpose of this section is for each contributor
+ * # to define their intentions with respect to intellectual property.
+ * #
+ * # Each contributor to this source code is encouraged to state their patent
+ * # claims and licensing mechanisms for any contributions made. At the end of
+ * # this section contributors may each make their own statements.  Contributor's
+ * # claims and grants only apply to the pieces (source code, programs, text,
+ * # media, etc) that they have contributed directly to this software.
+ * #
+ * # There is no guarantee that this section is complete, up to date or accurate. It
+ * # is up to the contributors to maintain their portion of this section and up to
+ * # the user of the software to verify any claims herein.
+ * #
+ * # Do not remove this header notification.  The contents of this section must be
+ * # present in all distributions of the software.  You may only modify your own
+ * # intellectual property statements.  Please provide contact information.
+ *
+ * - Palo Alto Research Center, Inc
+ * This software distribution does not grant any rights to patents owned by Palo
+ * Alto Research Center, Inc (PARC). Rights to these patents are available via
+ * various mechanisms. As of January 2016 PARC has committed to FRAND licensing any
+ * intellectual property used by its contributions to this software. You may
+ * contact PARC at cipo@parc.com for more information or visit http://www.ccnx.org
+ */
+/**
+ * @file ccnx_PortalLogger.h
+ * @brief A process-wide, asynchronous logger for Portal Stacks.
+ *
+ * Logging from the I/O path must not format text, take locks or write to a file.
+ * Instead, each log statement appends a small binary record to a lock-free ring shared by the whole process,
+ * and a background thread formats the records and writes them to the output.
+ * The background thread runs while any category other than `CCNxPortalLogger_DefaultCategory` is added:
+ * it is started by the first `ccnxPortalLogger_AddCategory`, sleeps while the ring is empty,
+ * and is stopped and joined by the `ccnxPortalLogger_RemoveCategory` of the last such category.
+ * While it is not running, or if it cannot be started, each record is written by the thread appending it.
+ *
+ * Every record belongs to a category, typically one per Portal, and every category has its own level.
+ * A statement whose level is disabled for its category costs one load and one comparison;
+ * its arguments are not evaluated when it is written with `ccnxPortalLogger_Log`.
+ *
+ * A record holds a format string and up to four integer arguments.
+ * The format must be a string literal (it is formatted later, by another thread)
+ * and every conversion in it must take an `int64_t`, for example `"%" PRId64`.
+ *
+ * If the ring is full, records are dropped and counted rather than blocking the caller.
+ *
+ * @copyright (c) 2016, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC).  All rights reserved.
+ */
+#ifndef CCNx_Portal_API_ccnx_PortalLogger_h
+#define CCNx_Portal_API_ccnx_PortalLogger_h
+
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdio.h>
+
+#include <parc/logging/parc_LogLevel.h>
+
+/**
+ * The maximum number of categories that may exist at once.
+ */
+#define CCNxPortalLogger_MaxCategories 256
+
+/**
+ * @typedef CCNxPortalLoggerCategory
+ * @brief Identifies a logging category.
+ */
+typedef uint32_t CCNxPortalLoggerCategory;
+
+/**
+ * The category used when no other category is available. It is always present and never removed.
+ */
+extern const CCNxPortalLoggerCategory CCNxPortalLogger_DefaultCategory;
+
+/**
+ * The value returned by `ccnxPortalLogger_AddCategory` when every category is in use.
+ * Nothing is logged for it, and setting its level has no effect.
+ */
+extern const CCNxPortalLoggerCategory CCNxPortalLogger_NoCategory;
+
+/**
+ * The level of each category, indexed by category. Use `ccnxPortalLogger_SetLevel` to change a level.
+ */
+extern PARCLogLevel ccnxPortalLogger_CategoryLevels[CCNxPortalLogger_MaxCategories];
+
+/**
+ * Determine if a record at the given level would be logged for the given category.
+ *
+ * @param [in] category A category.
+ * @param [in] level The level of the record.
+ *
+ * @return true A record at @p level would be logged.
+ */
+static inline bool
+ccnxPortalLogger_IsLoggable(CCNxPortalLoggerCategory category, PARCLogLevel level)
+{
+    return category < CCNxPortalLogger_MaxCategories && level != PARCLogLevel_Off
+           && level <= __atomic_load_n(&ccnxPortalLogger_CategoryLevels[category], __ATOMIC_RELAXED);
+}
+
+/**
+ * Log a record if its level is enabled for its category.
+ *
+ * The arguments after @p format are not evaluated unless the record is logged.
+ *
+ * Example:
+ * @code
+ * {
+ *     ccnxPortalLogger_Log(category, PARCLogLevel_Debug, "send failed errno=%" PRId64, errno, 0, 0, 0);
+ * }
+ * @endcode
+ */
+#define ccnxPortalLogger_Log(_category_, _level_, _format_, _a0_, _a1_, _a2_, _a3_) \
+    do { \
+        if (ccnxPortalLogger_IsLoggable((_category_), (_level_))) { \
+            ccnxPortalLogger_Write((_category_), (_level_), (_format_), \
+                                   (int64_t) (_a0_), (int64_t) (_a1_), (int64_t) (_a2_), (int64_t) (_a3_)); \
+        } \
+    } while (0)
+
+/**
+ * Add a new category with the given name, initially at level `PARCLogLevel_Off`.
+ *
+ * @param [in] name The name printed with each record of the category. It is copied.
+ *
+ * @return The new category, or `CCNxPortalLogger_NoCategory` with errno set to ENOSPC if all categories are in use.
+ *
+ * Example:
+ * @code
+ * {
+ *     CCNxPortalLoggerCategory category = ccnxPortalLogger_AddCategory("ccnxPortalRTA");
+ *     ccnxPortalLogger_SetLevel(category, PARCLogLevel_Debug);
+ *
+ *     ccnxPortalLogger_RemoveCategory(category);
+ * }
+ * @endcode
+ */
+CCNxPortalLoggerCategory ccnxPortalLogger_AddCategory(const char *name);
+
+/**
+ * Remove a category, making it available to be added again.
+ *
+ * Records of the category still in the ring are written under the name "removed".
+ * Removing `CCNxPortalLogger_DefaultCategory` has no effect.
+ * Removing the last other category stops the background thread, waiting for it to write the records in the ring.
+ *
+ * @param [in] category The category to remove.
+ */
+void ccnxPortalLogger_RemoveCategory(CCNxPortalLoggerCategory category);
+
+/**
+ * Set the level of a category. Records above the level are discarded.
+ *
+ * Setting the level of `CCNxPortalLogger_NoCategory` has no effect.
+ *
+ * @param [in] category A category.
+ * @param [in] level The new level. `PARCLogLevel_Off` disables the category.
+ */
+void ccnxPortalLogger_SetLevel(CCNxPortalLoggerCategory category, PARCLogLevel level);
+
+/**
+ * Get the level of a category.
+ *
+ * @param [in] category A category.
+ *
+ * @return The level of the category, or `PARCLogLevel_Off` for `CCNxPortalLogger_NoCategory`.
+ */
+PARCLogLevel ccnxPortalLogger_GetLevel(CCNxPortalLoggerCategory category);
+
+/**
+ * Append a record to the ring, without checking the level. Use `ccnxPortalLogger_Log` instead.
+ *
+ * @param [in] category The category of the record.
+ * @param [in] level The level of the record.
+ * @param [in] format A string literal whose conversions each take an `int64_t`.
+ * @param [in] a0 The first argument.
+ * @param [in] a1 The second argument.
+ * @param [in] a2 The third argument.
+ * @param [in] a3 The fourth argument.
+ *
+ * @return true The record was appended.
+ * @return false The ring was full and the record was dropped.
+ */
+bool ccnxPortalLogger_Write(CCNxPortalLoggerCategory category, PARCLogLevel level, const char *format,
+                            int64_t a0, int64_t a1, int64_t a2, int64_t a3);
+
+/**
+ * Set the stream to which the background thread writes formatted records. The default is `stderr`.
+ *
+ * @param [in] output An open stream, which must remain open while the logger is in use.
+ */
+void ccnxPortalLogger_SetOutput(FILE *output);
+
+/**
+ * Write every record appended so far to the output, and flush the output.
+ *
+ * Records not yet written by the background thread are written by the caller.
+ *
+ * Example:
+ * @code
+ * {
+ *     ccnxPortalLogger_Log(category, PARCLogLevel_Info, "done", 0, 0, 0, 0);
+ *     ccnxPortalLogger_Flush();
+ * }
+ * @endcode
+ */
+void ccnxPortalLogger_Flush(void);
+
+/**
+ * Get the number of records dropped because the ring was full.
+ *
+ * @return The number of records dropped since the process started.
+ */
+uint64_t ccnxPortalLogger_GetDropped(void);
+#endif // CCNx_Portal_API_ccnx_PortalLogger_h
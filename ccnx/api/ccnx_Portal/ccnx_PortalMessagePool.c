@@ -0,0 +1,327 @@
+/*
+ * Copyright (c) 2016, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX OR PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ################################################################################
+ * #
+ * # PATENT NOTICE
+ * #
+ * # This software is distributed under the BSD 2-clause License (see LICENSE
+ * # file).  This BSD License does not make any patent claims and as such, does
+ * # not act as a patent grant.  The purpose of this section is for each contributor
+ * # to define their intentions with respect to intellectual property.
+ * #
+ * # Each contributor to this source code is encouraged to state their patent
+ * # claims and licensing mechanisms for any contributions made. At the end of
+ * # this section contributors may each make their own statements.  Contributor's
+ * # claims and grants only apply to the pieces (source code, programs, text,
+ * # media, etc) that they have contributed directly to this software.
+ * #
+ * # There is no guarantee that this section is complete, up to date or accurate. It
+ * # is up to the contributors to maintain their portion of this section and up to
+ * # the user of the software to verify any claims herein.
+ * #
+ * # Do not remove this header notification.  The contents of this section must be
+ * # present in all distributions of the software.  You may only modify your own
+ * # intellectual property statements.  Please provide contact information.
+ *
+ * - Palo Alto Research Center, Inc
+ * This software distribution does not grant any rights to patents owned by Palo
+ * Alto Research Center, Inc (PARC). Rights to these patents are available via
+ * various mechanisms. As of January 2016 PARC has committed to FRAND licensing any
+ * intellectual property used by its contributions to this software. You may
+ * contact PARC at cipo@parc.com for more information or visit http://www.ccnx.org
+ */
+/**
+ * @copyright (c) 2016, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC).  All rights reserved.
+ */
+#include <config.h>
+
+#include <errno.h>
+
+#include <LongBow/runtime.h>
+
+#include <parc/algol/parc_Object.h>
+#include <parc/algol/parc_Memory.h>
+
+#include <ccnx/api/ccnx_Portal/ccnx_PortalMessagePool.h>
+
+#include <ccnx/common/ccnx_Interest.h>
+#include <ccnx/common/ccnx_ContentObject.h>
+#include <ccnx/common/ccnx_WireFormatMessage.h>
+
+/*
+ * A pooled message, and the name and payload it was built with.
+ * The pool holds a reference to each, and the message holds another to its name and payload,
+ * so the message is idle when those are the only references.
+ */
+typedef struct {
+    CCNxMetaMessage *message;
+    CCNxName *name;
+    PARCBuffer *payload;
+    bool isInterest;
+} _CCNxPortalPooledMessage;
+
+struct CCNxPortalMessagePool {
+    size_t capacity;
+    size_t payloadCapacity;
+
+    _CCNxPortalPooledMessage *messages;
+    size_t messageCount;
+    size_t messageCursor;
+
+    PARCBuffer **buffers;
+    size_t bufferCount;
+    size_t bufferCursor;
+
+    size_t allocated;
+    size_t recycled;
+};
+
+static void
+_ccnxPortalPooledMessage_Clear(_CCNxPortalPooledMessage *pooled)
+{
+    if (pooled->message != NULL) {
+        ccnxMetaMessage_Release(&pooled->message);
+    }
+    if (pooled->name != NULL) {
+        ccnxName_Release(&pooled->name);
+    }
+    if (pooled->payload != NULL) {
+        parcBuffer_Release(&pooled->payload);
+    }
+}
+
+static bool
+_ccnxPortalPooledMessage_IsIdle(const _CCNxPortalPooledMessage *pooled)
+{
+    return parcObject_GetReferenceCount(pooled->message) == 1
+           && parcObject_GetReferenceCount(pooled->name) == 2
+           && (pooled->payload == NULL || parcObject_GetReferenceCount(pooled->payload) == 2);
+}
+
+/*
+ * A message a stack has encoded carries its wire format, which would be sent again in place of new contents.
+ */
+static bool
+_ccnxPortalPooledMessage_IsEncoded(const _CCNxPortalPooledMessage *pooled)
+{
+    return ccnxWireFormatMessage_GetWireFormatBuffer(pooled->message) != NULL
+           || ccnxWireFormatMessage_GetIoVec(pooled->message) != NULL;
+}
+
+/*
+ * Replace the segments of the pooled name with those of @p name, in place, so the message sees the new name.
+ */
+static void
+_ccnxPortalPooledMessage_SetName(_CCNxPortalPooledMessage *pooled, const CCNxName *name)
+{
+    if (ccnxName_Equals(pooled->name, name)) {
+        return;
+    }
+    ccnxName_Trim(pooled->name, ccnxName_GetSegmentCount(pooled->name));
+    size_t segmentCount = ccnxName_GetSegmentCount(name);
+    for (size_t i = 0; i < segmentCount; i++) {
+        ccnxName_Append(pooled->name, ccnxName_GetSegment(name, i));
+    }
+}
+
+static void
+_ccnxPortalPooledMessage_Build(_CCNxPortalPooledMessage *pooled, const CCNxName *name, bool isInterest, size_t payloadCapacity)
+{
+    pooled->isInterest = isInterest;
+    pooled->name = ccnxName_Copy(name);
+
+    if (isInterest) {
+        pooled->payload = NULL;
+        CCNxInterest *interest = ccnxInterest_CreateSimple(pooled->name);
+        pooled->message = ccnxMetaMessage_CreateFromInterest(interest);
+        ccnxInterest_Release(&interest);
+    } else {
+        pooled->payload = parcBuffer_Allocate(payloadCapacity);
+        CCNxContentObject *contentObject = ccnxContentObject_CreateWithNameAndPayload(pooled->name, pooled->payload);
+        pooled->message = ccnxMetaMessage_CreateFromContentObject(contentObject);
+        ccnxContentObject_Release(&contentObject);
+    }
+}
+
+static void
+_ccnxPortalMessagePool_Destroy(CCNxPortalMessagePool **poolPtr)
+{
+    CCNxPortalMessagePool *pool = *poolPtr;
+
+    for (size_t i = 0; i < pool->messageCount; i++) {
+        _ccnxPortalPooledMessage_Clear(&pool->messages[i]);
+    }
+    parcMemory_Deallocate(&pool->messages);
+
+    for (size_t i = 0; i < pool->bufferCount; i++) {
+        parcBuffer_Release(&pool->buffers[i]);
+    }
+    parcMemory_Deallocate(&pool->buffers);
+}
+
+parcObject_ExtendPARCObject(CCNxPortalMessagePool, _ccnxPortalMessagePool_Destroy, NULL, NULL, NULL, NULL, NULL, NULL);
+
+parcObject_ImplementAcquire(ccnxPortalMessagePool, CCNxPortalMessagePool);
+
+parcObject_ImplementRelease(ccnxPortalMessagePool, CCNxPortalMessagePool);
+
+CCNxPortalMessagePool *
+ccnxPortalMessagePool_Create(size_t capacity, size_t payloadCapacity)
+{
+    if (capacity == 0) {
+        errno = EINVAL;
+        return NULL;
+    }
+
+    CCNxPortalMessagePool *result = parcObject_CreateInstance(CCNxPortalMessagePool);
+    if (result == NULL) {
+        errno = ENOMEM;
+        return NULL;
+    }
+
+    result->capacity = capacity;
+    result->payloadCapacity = payloadCapacity;
+    result->messages = parcMemory_AllocateAndClear(capacity * sizeof(_CCNxPortalPooledMessage));
+    result->messageCount = 0;
+    result->messageCursor = 0;
+    result->buffers = parcMemory_AllocateAndClear(capacity * sizeof(PARCBuffer *));
+    result->bufferCount = 0;
+    result->bufferCursor = 0;
+    result->allocated = 0;
+    result->recycled = 0;
+
+    if (result->messages == NULL || result->buffers == NULL) {
+        ccnxPortalMessagePool_Release(&result);
+        errno = ENOMEM;
+        return NULL;
+    }
+
+    return result;
+}
+
+/*
+ * Find an idle pooled message of the given kind, starting after the one most recently handed out,
+ * so that messages are reused in the order they were sent.
+ * Return NULL if there is none.
+ */
+static _CCNxPortalPooledMessage *
+_ccnxPortalMessagePool_FindIdleMessage(CCNxPortalMessagePool *pool, bool isInterest)
+{
+    for (size_t i = 0; i < pool->messageCount; i++) {
+        size_t index = (pool->messageCursor + i) % pool->messageCount;
+        _CCNxPortalPooledMessage *pooled = &pool->messages[index];
+
+        if (pooled->isInterest == isInterest && parcObject_GetReferenceCount(pooled->message) == 1) {
+            if (_ccnxPortalPooledMessage_IsEncoded(pooled)) {
+                // It can never be reused, so rebuild it in place.
+                _ccnxPortalPooledMessage_Clear(pooled);
+                pool->messageCursor = (index + 1) % pool->messageCount;
+                return pooled;
+            }
+            if (_ccnxPortalPooledMessage_IsIdle(pooled)) {
+                pool->messageCursor = (index + 1) % pool->messageCount;
+                return pooled;
+            }
+        }
+    }
+    return NULL;
+}
+
+static CCNxMetaMessage *
+_ccnxPortalMessagePool_GetMessage(CCNxPortalMessagePool *pool, const CCNxName *name, bool isInterest)
+{
+    _CCNxPortalPooledMessage *pooled = _ccnxPortalMessagePool_FindIdleMessage(pool, isInterest);
+
+    if (pooled == NULL && pool->messageCount < pool->capacity) {
+        pooled = &pool->messages[pool->messageCount++];
+    }
+
+    if (pooled == NULL) {
+        // The pool is exhausted: build a message the pool does not keep.
+        _CCNxPortalPooledMessage unpooled;
+        _ccnxPortalPooledMessage_Build(&unpooled, name, isInterest, pool->payloadCapacity);
+        CCNxMetaMessage *result = ccnxMetaMessage_Acquire(unpooled.message);
+        _ccnxPortalPooledMessage_Clear(&unpooled);
+        pool->allocated++;
+        return result;
+    }
+
+    if (pooled->message == NULL) {
+        _ccnxPortalPooledMessage_Build(pooled, name, isInterest, pool->payloadCapacity);
+        pool->allocated++;
+    } else {
+        _ccnxPortalPooledMessage_SetName(pooled, name);
+        if (pooled->payload != NULL) {
+            parcBuffer_Clear(pooled->payload);
+        }
+        pool->recycled++;
+    }
+
+    return ccnxMetaMessage_Acquire(pooled->message);
+}
+
+CCNxMetaMessage *
+ccnxPortalMessagePool_GetContentObject(CCNxPortalMessagePool *pool, const CCNxName *name)
+{
+    return _ccnxPortalMessagePool_GetMessage(pool, name, false);
+}
+
+CCNxMetaMessage *
+ccnxPortalMessagePool_GetInterest(CCNxPortalMessagePool *pool, const CCNxName *name)
+{
+    return _ccnxPortalMessagePool_GetMessage(pool, name, true);
+}
+
+PARCBuffer *
+ccnxPortalMessagePool_GetBuffer(CCNxPortalMessagePool *pool)
+{
+    for (size_t i = 0; i < pool->bufferCount; i++) {
+        size_t index = (pool->bufferCursor + i) % pool->bufferCount;
+        if (parcObject_GetReferenceCount(pool->buffers[index]) == 1) {
+            pool->bufferCursor = (index + 1) % pool->bufferCount;
+            pool->recycled++;
+            return parcBuffer_Acquire(parcBuffer_Clear(pool->buffers[index]));
+        }
+    }
+
+    pool->allocated++;
+    PARCBuffer *result = parcBuffer_Allocate(pool->payloadCapacity);
+    if (result != NULL && pool->bufferCount < pool->capacity) {
+        pool->buffers[pool->bufferCount++] = parcBuffer_Acquire(result);
+    }
+    return result;
+}
+
+size_t
+ccnxPortalMessagePool_GetAllocatedCount(const CCNxPortalMessagePool *pool)
+{
+    return pool->allocated;
+}
+
+size_t
+ccnxPortalMessagePool_GetRecycledCount(const CCNxPortalMessagePool *pool)
+{
+    return pool->recycled;
+}
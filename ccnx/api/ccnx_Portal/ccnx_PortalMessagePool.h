@@ -0,0 +1,265 @@
+/*
+ * Copyright (c) 2016, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX OR PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ################################################################################
+ * #
+ * # PATENT NOTICE
+ * #
+ * # This software is distributed under the BSD 2-clause License (see LICENSE
+ * # file).  This BSD License does not make any patent claims and as such, does
+ * # not act as a patent grant.  The purpose of this section is for each contributor
+ * # to define their intentions with respect to intellectual property.
+ * #
+ * # Each contributor to this source code is encouraged to state their patent
+ * # claims and licensing mechanisms for any contributions made. At the end of
+ * # this section contributors may each make their own statements.  Contributor's
+ * # claims and grants only apply to the pieces (source code, programs, text,
+ * # media, etc) that they have contributed directly to this software.
+ * #
+ * # There is no guarantee that this section is complete, up to date or accurate. It
+ * # is up to the contributors to maintain their portion of this section and up to
+ * # the user of the software to verify any claims herein.
+ * #
+ * # Do not remove this header notification.  The contents of this section must be
+ * # present in all distributions of the software.  You may only modify your own
+ * # intellectual property statements.  Please provide contact information.
+ *
+ * - Palo Alto Research Center, Inc
+ * This software distribution does not grant any rights to patents owned by Palo
+ * Alto Research Center, Inc (PARC). Rights to these patents are available via
+ * various mechanisms. As of January 2016 PARC has committed to FRAND licensing any
+ * intellectual property used by its contributions to this software. You may
+ * contact PARC at cipo@parc.com for more information or visit http://www.ccnx.org
+ */
+/**
+ * @file ccnx_PortalMessagePool.h
+ * @brief Recycle the messages and payload buffers a producer sends.
+ *
+ * Building a message for every send allocates a Content Object or Interest, its name, and its payload buffer,
+ * all of which are released again as soon as the stack has finished with them.
+ * A message pool keeps those instances and hands them out again once every other reference to them has been released,
+ * so a producer that sends from a pool does not allocate memory once the pool has grown to its working size.
+ *
+ * A pooled message is idle when the pool holds the only reference to it.
+ * The caller, and any stack the message was sent through, release their references as usual;
+ * the last release makes the message available for reuse rather than freeing it.
+ *
+ * A stack that stores the encoded form of a message in the message itself (the RTA stack does)
+ * leaves a pooled message unusable with new contents. Such a message is released and rebuilt,
+ * so it stays correct, but over such a stack only the payload buffers from
+ * {@link ccnxPortalMessagePool_GetBuffer} are recycled without allocation.
+ *
+ * A message pool is not thread-safe. Use one per thread, as with a Portal.
+ *
+ * @copyright (c) 2016, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC).  All rights reserved.
+ */
+#ifndef CCNx_Portal_API_ccnx_PortalMessagePool_h
+#define CCNx_Portal_API_ccnx_PortalMessagePool_h
+
+#include <stddef.h>
+
+#include <parc/algol/parc_Buffer.h>
+
+#include <ccnx/common/ccnx_Name.h>
+#include <ccnx/transport/common/transport_MetaMessage.h>
+
+struct CCNxPortalMessagePool;
+/**
+ * @typedef CCNxPortalMessagePool
+ * @brief Recycle the messages and payload buffers a producer sends.
+ */
+typedef struct CCNxPortalMessagePool CCNxPortalMessagePool;
+
+/**
+ * Create a new `CCNxPortalMessagePool`.
+ *
+ * @param [in] capacity The most messages, and separately the most buffers, the pool keeps. Must be greater than zero.
+ * @param [in] payloadCapacity The capacity in bytes of every pooled payload buffer.
+ *
+ * @return non-NULL A pointer to a valid `CCNxPortalMessagePool` instance.
+ * @return NULL @p capacity is zero, or memory could not be allocated. `errno` is set.
+ *
+ * Example:
+ * @code
+ * {
+ *     CCNxPortalMessagePool *pool = ccnxPortalMessagePool_Create(256, 4096);
+ *
+ *     ccnxPortalMessagePool_Release(&pool);
+ * }
+ * @endcode
+ */
+CCNxPortalMessagePool *ccnxPortalMessagePool_Create(size_t capacity, size_t payloadCapacity);
+
+/**
+ * Increase the number of references to a `CCNxPortalMessagePool` instance.
+ *
+ * @param [in] pool A pointer to a valid `CCNxPortalMessagePool` instance.
+ *
+ * @return The same value as @p pool.
+ *
+ * Example:
+ * @code
+ * {
+ *     CCNxPortalMessagePool *pool = ccnxPortalMessagePool_Create(256, 4096);
+ *     CCNxPortalMessagePool *reference = ccnxPortalMessagePool_Acquire(pool);
+ *
+ *     ccnxPortalMessagePool_Release(&pool);
+ *     ccnxPortalMessagePool_Release(&reference);
+ * }
+ * @endcode
+ */
+CCNxPortalMessagePool *ccnxPortalMessagePool_Acquire(const CCNxPortalMessagePool *pool);
+
+/**
+ * Release a previously acquired reference to the given `CCNxPortalMessagePool` instance,
+ * decrementing the reference count for the instance.
+ *
+ * The pointer to the instance is set to NULL as a side-effect of this function.
+ * Messages and buffers obtained from the pool remain valid until their own last reference is released.
+ *
+ * @param [in,out] poolPtr A pointer to a pointer to the instance to release.
+ *
+ * Example:
+ * @code
+ * {
+ *     CCNxPortalMessagePool *pool = ccnxPortalMessagePool_Create(256, 4096);
+ *
+ *     ccnxPortalMessagePool_Release(&pool);
+ * }
+ * @endcode
+ */
+void ccnxPortalMessagePool_Release(CCNxPortalMessagePool **poolPtr);
+
+/**
+ * Get a Content Object message named @p name from the pool.
+ *
+ * The message's payload is a buffer of the pool's payload capacity, cleared and ready to be written:
+ * put the payload into the buffer returned by `ccnxContentObject_GetPayload` and flip it before sending.
+ * The message has no final chunk number or expiry time unless the caller sets them.
+ *
+ * If every pooled message is in use and the pool is at capacity, a new message is allocated and not pooled.
+ *
+ * @param [in] pool A pointer to a valid `CCNxPortalMessagePool` instance.
+ * @param [in] name A pointer to a valid `CCNxName` instance. The message's name is a copy.
+ *
+ * @return A pointer to a `CCNxMetaMessage` instance that must be released by the caller.
+ *
+ * Example:
+ * @code
+ * {
+ *     CCNxMetaMessage *message = ccnxPortalMessagePool_GetContentObject(pool, name);
+ *
+ *     PARCBuffer *payload = ccnxContentObject_GetPayload(ccnxMetaMessage_GetContentObject(message));
+ *     parcBuffer_PutArray(payload, length, data);
+ *     parcBuffer_Flip(payload);
+ *
+ *     ccnxPortal_Send(portal, message, CCNxStackTimeout_Never);
+ *     ccnxMetaMessage_Release(&message);
+ * }
+ * @endcode
+ */
+CCNxMetaMessage *ccnxPortalMessagePool_GetContentObject(CCNxPortalMessagePool *pool, const CCNxName *name);
+
+/**
+ * Get an Interest message named @p name, with no payload, from the pool.
+ *
+ * If every pooled message is in use and the pool is at capacity, a new message is allocated and not pooled.
+ *
+ * @param [in] pool A pointer to a valid `CCNxPortalMessagePool` instance.
+ * @param [in] name A pointer to a valid `CCNxName` instance. The message's name is a copy.
+ *
+ * @return A pointer to a `CCNxMetaMessage` instance that must be released by the caller.
+ *
+ * Example:
+ * @code
+ * {
+ *     CCNxMetaMessage *message = ccnxPortalMessagePool_GetInterest(pool, name);
+ *     ccnxPortal_Send(portal, message, CCNxStackTimeout_Never);
+ *     ccnxMetaMessage_Release(&message);
+ * }
+ * @endcode
+ */
+CCNxMetaMessage *ccnxPortalMessagePool_GetInterest(CCNxPortalMessagePool *pool, const CCNxName *name);
+
+/**
+ * Get a payload buffer of the pool's payload capacity, cleared and ready to be written.
+ *
+ * The buffer returns to the pool when every other reference to it, including those held by messages it is the payload of,
+ * has been released.
+ * If every pooled buffer is in use and the pool is at capacity, a new buffer is allocated and not pooled.
+ *
+ * @param [in] pool A pointer to a valid `CCNxPortalMessagePool` instance.
+ *
+ * @return A pointer to a `PARCBuffer` instance that must be released by the caller.
+ *
+ * Example:
+ * @code
+ * {
+ *     PARCBuffer *payload = ccnxPortalMessagePool_GetBuffer(pool);
+ *     parcBuffer_PutArray(payload, length, data);
+ *     parcBuffer_Flip(payload);
+ *
+ *     CCNxContentObject *contentObject = ccnxContentObject_CreateWithNameAndPayload(name, payload);
+ *     parcBuffer_Release(&payload);
+ * }
+ * @endcode
+ */
+PARCBuffer *ccnxPortalMessagePool_GetBuffer(CCNxPortalMessagePool *pool);
+
+/**
+ * Get the number of messages and buffers the pool has allocated, pooled or not.
+ *
+ * In steady state this stops increasing.
+ *
+ * @param [in] pool A pointer to a valid `CCNxPortalMessagePool` instance.
+ *
+ * @return The number of messages and buffers allocated since @p pool was created.
+ *
+ * Example:
+ * @code
+ * {
+ *     printf("%zu allocated, %zu recycled\n",
+ *            ccnxPortalMessagePool_GetAllocatedCount(pool), ccnxPortalMessagePool_GetRecycledCount(pool));
+ * }
+ * @endcode
+ */
+size_t ccnxPortalMessagePool_GetAllocatedCount(const CCNxPortalMessagePool *pool);
+
+/**
+ * Get the number of messages and buffers the pool has handed out again rather than allocating.
+ *
+ * @param [in] pool A pointer to a valid `CCNxPortalMessagePool` instance.
+ *
+ * @return The number of messages and buffers recycled since @p pool was created.
+ *
+ * Example:
+ * @code
+ * {
+ *     printf("%zu allocated, %zu recycled\n",
+ *            ccnxPortalMessagePool_GetAllocatedCount(pool), ccnxPortalMessagePool_GetRecycledCount(pool));
+ * }
+ * @endcode
+ */
+size_t ccnxPortalMessagePool_GetRecycledCount(const CCNxPortalMessagePool *pool);
+#endif // CCNx_Portal_API_ccnx_PortalMessagePool_h
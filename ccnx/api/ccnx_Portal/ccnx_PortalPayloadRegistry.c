@@ -0,0 +1,175 @@
+/*
+ * Copyright (c) 2016, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX OR PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ################################################################################
+ * #
+ * # PATENT NOTICE
+ * #
+ * # This software is distributed under the BSD 2-clause License (see LICENSE
+ * # file).  This BSD License does not make any patent claims and as such, does
+ * # not act as a patent grant.  The purpose of this section is for each contributor
+ * # to define their intentions with respect to intellectual property.
+ * #
+ * # Each contributor to this source code is encouraged to state their patent
+ * # claims and licensing mechanisms for any contributions made. At the end of
+ * # this section contributors may each make their own statements.  Contributor's
+ * # claims and grants only apply to the pieces (source code, programs, text,
+ * # media, etc) that they have contributed directly to this software.
+ * #
+ * # There is no guarantee that this section is complete, up to date or accurate. It
+ * # is up to the contributors to maintain their portion of this section and up to
+ * # the user of the software to verify any claims herein.
+ * #
+ * # Do not remove this header notification.  The contents of this section must be
+ * # present in all distributions of the software.  You may only modify your own
+ * # intellectual property statements.  Please provide contact information.
+ *
+ * - Palo Alto Research Center, Inc
+ * This software distribution does not grant any rights to patents owned by Palo
+ * Alto Research Center, Inc (PARC). Rights to these patents are available via
+ * various mechanisms. As of January 2016 PARC has committed to FRAND licensing any
+ * intellectual property used by its contributions to this software. You may
+ * contact PARC at cipo@parc.com for more information or visit http://www.ccnx.org
+ */
+/**
+ * @copyright (c) 2016, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC).  All rights reserved.
+ */
+#include <config.h>
+
+#include <errno.h>
+
+#include <LongBow/runtime.h>
+
+#include <parc/algol/parc_Object.h>
+#include <parc/algol/parc_Memory.h>
+
+#include <ccnx/api/ccnx_Portal/ccnx_PortalPayloadRegistry.h>
+
+typedef struct {
+    PARCBuffer *buffer;
+    void *memory;
+    size_t length;
+    CCNxPortalPayloadRelease *release;
+    void *context;
+} _CCNxPortalPayload;
+
+struct CCNxPortalPayloadRegistry {
+    _CCNxPortalPayload *payloads;
+    size_t capacity;
+    size_t count;
+};
+
+static void
+_ccnxPortalPayloadRegistry_Finish(_CCNxPortalPayload *payload)
+{
+    parcBuffer_Release(&payload->buffer);
+    if (payload->release != NULL) {
+        payload->release(payload->memory, payload->length, payload->context);
+    }
+}
+
+static void
+_ccnxPortalPayloadRegistry_Destroy(CCNxPortalPayloadRegistry **registryPtr)
+{
+    CCNxPortalPayloadRegistry *registry = *registryPtr;
+
+    for (size_t i = 0; i < registry->count; i++) {
+        _ccnxPortalPayloadRegistry_Finish(&registry->payloads[i]);
+    }
+    if (registry->payloads != NULL) {
+        parcMemory_Deallocate(&registry->payloads);
+    }
+}
+
+parcObject_ExtendPARCObject(CCNxPortalPayloadRegistry, _ccnxPortalPayloadRegistry_Destroy, NULL, NULL, NULL, NULL, NULL, NULL);
+
+parcObject_ImplementAcquire(ccnxPortalPayloadRegistry, CCNxPortalPayloadRegistry);
+
+parcObject_ImplementRelease(ccnxPortalPayloadRegistry, CCNxPortalPayloadRegistry);
+
+CCNxPortalPayloadRegistry *
+ccnxPortalPayloadRegistry_Create(void)
+{
+    CCNxPortalPayloadRegistry *result = parcObject_CreateInstance(CCNxPortalPayloadRegistry);
+    if (result != NULL) {
+        result->payloads = NULL;
+        result->capacity = 0;
+        result->count = 0;
+    }
+    return result;
+}
+
+PARCBuffer *
+ccnxPortalPayloadRegistry_Wrap(CCNxPortalPayloadRegistry *registry, void *memory, size_t length,
+                               CCNxPortalPayloadRelease *release, void *context)
+{
+    if (registry->count == registry->capacity) {
+        size_t capacity = (registry->capacity == 0) ? 16 : registry->capacity * 2;
+        _CCNxPortalPayload *payloads = parcMemory_Reallocate(registry->payloads, capacity * sizeof(_CCNxPortalPayload));
+        if (payloads == NULL) {
+            errno = ENOMEM;
+            return NULL;
+        }
+        registry->payloads = payloads;
+        registry->capacity = capacity;
+    }
+
+    PARCBuffer *buffer = parcBuffer_Wrap(memory, length, 0, length);
+    if (buffer == NULL) {
+        errno = ENOMEM;
+        return NULL;
+    }
+
+    _CCNxPortalPayload *payload = &registry->payloads[registry->count++];
+    payload->buffer = buffer;
+    payload->memory = memory;
+    payload->length = length;
+    payload->release = release;
+    payload->context = context;
+
+    return parcBuffer_Acquire(buffer);
+}
+
+size_t
+ccnxPortalPayloadRegistry_Reclaim(CCNxPortalPayloadRegistry *registry)
+{
+    size_t kept = 0;
+    for (size_t i = 0; i < registry->count; i++) {
+        _CCNxPortalPayload *payload = &registry->payloads[i];
+        if (parcObject_GetReferenceCount(payload->buffer) == 1) {
+            _ccnxPortalPayloadRegistry_Finish(payload);
+        } else {
+            registry->payloads[kept++] = *payload;
+        }
+    }
+    registry->count = kept;
+
+    return kept;
+}
+
+size_t
+ccnxPortalPayloadRegistry_GetCount(const CCNxPortalPayloadRegistry *registry)
+{
+    return registry->count;
+}
@@ -0,0 +1,210 @@
+/*
+ * Copyright (c) 2016, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX OR PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ################################################################################
+ * #
+ * # PATENT NOTICE
+ * #
+ * # This software is distributed under the BSD 2-clause License (see LICENSE
+ * # file).  This BSD License does not make any patent claims and as such, does
+ * # not act as a patent grant.  The purpose of this section is for each contributor
+ * # to define their intentions with respect to intellectual property.
+ * #
+ * # Each contributor to this source code is encouraged to state their patent
+ * # claims and licensing mechanisms for any contributions made. At the end of
+ * # this section contributors may each make their own statements.  Contributor's
+ * # claims and grants only apply to the pieces (source code, programs, text,
+ * # media, etc) that they have contributed directly to this software.
+ * #
+ * # There is no guarantee that this section is complete, up to date or accurate. It
+ * # is up to the contributors to maintain their portion of this section and up to
+ * # the user of the software to verify any claims herein.
+ * #
+ * # Do not remove this header notification.  The contents of this section must be
+ * # present in all distributions of the software.  You may only modify your own
+ * # intellectual property statements.  Please provide contact information.
+ *
+ * - Palo Alto Research Center, Inc
+ * This software distribution does not grant any rights to patents owned by Palo
+ * Alto Research Center, Inc (PARC). Rights to these patents are available via
+ * various mechanisms. As of January 2016 PARC has committed to FRAND licensing any
+ * intellectual property used by its contributions to this software. You may
+ * contact PARC at cipo@parc.com for more information or visit http://www.ccnx.org
+ */
+/**
+ * @file ccnx_PortalPayloadRegistry.h
+ * @brief Send payloads from memory the application owns, and learn when the stack has finished with it.
+ *
+ * A payload held in the application's own memory would normally be copied into a `PARCBuffer` to be sent.
+ * A payload registry instead wraps that memory in a `PARCBuffer` without copying it,
+ * and keeps a reference to the buffer. The buffer is used as any other payload, and its references released as usual.
+ * Once the registry holds the only reference, the stack and any receiver have finished with the memory,
+ * and the next call to {@link ccnxPortalPayloadRegistry_Reclaim} hands it back to the application
+ * by calling the release function given for it.
+ *
+ * Every registered payload's release function is called exactly once,
+ * whether the message it was sent in was sent, dropped, or never sent at all.
+ *
+ * The memory must not be modified or freed until its release function is called.
+ *
+ * A registry is not thread-safe, but the references to its buffers may be released on any thread.
+ *
+ * @copyright (c) 2016, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC).  All rights reserved.
+ */
+#ifndef CCNx_Portal_API_ccnx_PortalPayloadRegistry_h
+#define CCNx_Portal_API_ccnx_PortalPayloadRegistry_h
+
+#include <stddef.h>
+
+#include <parc/algol/parc_Buffer.h>
+
+struct CCNxPortalPayloadRegistry;
+/**
+ * @typedef CCNxPortalPayloadRegistry
+ * @brief The payloads in application memory that a stack may still refer to.
+ */
+typedef struct CCNxPortalPayloadRegistry CCNxPortalPayloadRegistry;
+
+/**
+ * The function called when the stack has finished with a payload.
+ *
+ * @param [in] memory The payload memory, as registered.
+ * @param [in] length The payload length in bytes, as registered.
+ * @param [in] context The context given when the payload was registered.
+ */
+typedef void (CCNxPortalPayloadRelease)(void *memory, size_t length, void *context);
+
+/**
+ * Create a new, empty `CCNxPortalPayloadRegistry`.
+ *
+ * @return non-NULL A pointer to a valid `CCNxPortalPayloadRegistry` instance.
+ * @return NULL Memory could not be allocated.
+ *
+ * Example:
+ * @code
+ * {
+ *     CCNxPortalPayloadRegistry *registry = ccnxPortalPayloadRegistry_Create();
+ *
+ *     ccnxPortalPayloadRegistry_Release(&registry);
+ * }
+ * @endcode
+ */
+CCNxPortalPayloadRegistry *ccnxPortalPayloadRegistry_Create(void);
+
+/**
+ * Increase the number of references to a `CCNxPortalPayloadRegistry` instance.
+ *
+ * @param [in] registry A pointer to a valid `CCNxPortalPayloadRegistry` instance.
+ *
+ * @return The same value as @p registry.
+ *
+ * Example:
+ * @code
+ * {
+ *     CCNxPortalPayloadRegistry *registry = ccnxPortalPayloadRegistry_Create();
+ *     CCNxPortalPayloadRegistry *reference = ccnxPortalPayloadRegistry_Acquire(registry);
+ *
+ *     ccnxPortalPayloadRegistry_Release(&registry);
+ *     ccnxPortalPayloadRegistry_Release(&reference);
+ * }
+ * @endcode
+ */
+CCNxPortalPayloadRegistry *ccnxPortalPayloadRegistry_Acquire(const CCNxPortalPayloadRegistry *registry);
+
+/**
+ * Release a previously acquired reference to the given `CCNxPortalPayloadRegistry` instance,
+ * decrementing the reference count for the instance.
+ *
+ * The pointer to the instance is set to NULL as a side-effect of this function.
+ * When the last reference is released, the release function of every payload still registered is called,
+ * whether or not its buffer is still referenced elsewhere.
+ *
+ * @param [in,out] registryPtr A pointer to a pointer to the instance to release.
+ *
+ * Example:
+ * @code
+ * {
+ *     CCNxPortalPayloadRegistry *registry = ccnxPortalPayloadRegistry_Create();
+ *
+ *     ccnxPortalPayloadRegistry_Release(&registry);
+ * }
+ * @endcode
+ */
+void ccnxPortalPayloadRegistry_Release(CCNxPortalPayloadRegistry **registryPtr);
+
+/**
+ * Register the given memory and return a `PARCBuffer` that refers to it without copying it.
+ *
+ * The buffer's position is 0 and its limit @p length.
+ *
+ * @param [in,out] registry A pointer to a valid `CCNxPortalPayloadRegistry` instance.
+ * @param [in] memory A pointer to the payload.
+ * @param [in] length The length of the payload in bytes.
+ * @param [in] release The function called once nothing but the registry refers to the buffer, or NULL.
+ * @param [in] context A value passed to @p release.
+ *
+ * @return non-NULL A pointer to a `PARCBuffer` instance that must be released by the caller.
+ * @return NULL Memory could not be allocated. @p release is not called.
+ *
+ * Example:
+ * @code
+ * {
+ *     PARCBuffer *payload = ccnxPortalPayloadRegistry_Wrap(registry, data, length, free_data, NULL);
+ *     CCNxContentObject *contentObject = ccnxContentObject_CreateWithNameAndPayload(name, payload);
+ *     parcBuffer_Release(&payload);
+ *
+ *     ...
+ * }
+ * @endcode
+ */
+PARCBuffer *ccnxPortalPayloadRegistry_Wrap(CCNxPortalPayloadRegistry *registry, void *memory, size_t length,
+                                           CCNxPortalPayloadRelease *release, void *context);
+
+/**
+ * Call the release function of every payload that nothing but the registry refers to any longer, and forget them.
+ *
+ * @param [in,out] registry A pointer to a valid `CCNxPortalPayloadRegistry` instance.
+ *
+ * @return The number of payloads still registered.
+ *
+ * Example:
+ * @code
+ * {
+ *     while (ccnxPortalPayloadRegistry_Reclaim(registry) > 0) {
+ *         ...
+ *     }
+ * }
+ * @endcode
+ */
+size_t ccnxPortalPayloadRegistry_Reclaim(CCNxPortalPayloadRegistry *registry);
+
+/**
+ * Get the number of payloads registered and not yet reclaimed.
+ *
+ * @param [in] registry A pointer to a valid `CCNxPortalPayloadRegistry` instance.
+ *
+ * @return The number of payloads still registered.
+ */
+size_t ccnxPortalPayloadRegistry_GetCount(const CCNxPortalPayloadRegistry *registry);
+#endif // CCNx_Portal_API_ccnx_PortalPayloadRegistry_h
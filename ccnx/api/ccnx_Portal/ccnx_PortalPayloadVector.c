@@ -0,0 +1,311 @@
+/*
+ * Copyright (c) 2016, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX OR PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ################################################################################
+ * #
+ * # PATENT NOTICE
+ * #
+ * # This software is distributed under the BSD 2-clause License (see LICENSE
+ * # file).  This BSD License does not make any patent claims and as such, does
+ * # not act as a patent grant.  The purpose of this section is for each contributor
+ * # to define their intentions with respect to intellectual property.
+ * #
+ * # Each contributor to this source code is encouraged to state their patent
+ * # claims and licensing mechanisms for any contributions made. At the end of
+ * # this section contributors may each make their own statements.  Contributor's
+ * # claims and grants only apply to the pieces (source code, programs, text,
+ * # media, etc) that they have contributed directly to this software.
+ * #
+ * # There is no guarantee that this section is complete, up to date or accurate. It
+ * # is up to the contributors to maintain their portion of this section and up to
+ * # the user of the software to verify any claims herein.
+ * #
+ * # Do not remove this header notification.  The contents of this section must be
+ * # present in all distributions of the software.  You may only modify your own
+ * # intellectual property statements.  Please provide contact information.
+ *
+ * - Palo Alto Research Center, Inc
+ * This software distribution does not grant any rights to patents owned by Palo
+ * Alto Research Center, Inc (PARC). Rights to these patents are available via
+ * various mechanisms. As of January 2016 PARC has committed to FRAND licensing any
+ * intellectual property used by its contributions to this software. You may
+ * contact PARC at cipo@parc.com for more information or visit http://www.ccnx.org
+ */
+/**
+ * @copyright (c) 2016, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC).  All rights reserved.
+ */
+#include <config.h>
+
+#include <errno.h>
+#include <string.h>
+
+#include <LongBow/runtime.h>
+
+#include <parc/algol/parc_Object.h>
+#include <parc/algol/parc_Memory.h>
+#include <parc/algol/parc_ByteArray.h>
+
+#include <ccnx/api/ccnx_Portal/ccnx_PortalPayloadVector.h>
+
+#include <ccnx/common/ccnx_ContentObject.h>
+#include <ccnx/common/ccnx_WireFormatMessage.h>
+
+// The layout of a version 1 CCNx packet: a fixed header, hop-by-hop headers, then the message TLV containing the payload TLV.
+#define _ccnxPortalPayloadVector_Version 1
+#define _ccnxPortalPayloadVector_FixedHeaderLength 8
+#define _ccnxPortalPayloadVector_PacketLengthOffset 2
+#define _ccnxPortalPayloadVector_HeaderLengthOffset 7
+#define _ccnxPortalPayloadVector_TLHeaderLength 4
+#define _ccnxPortalPayloadVector_TypeContentObject 0x0002
+#define _ccnxPortalPayloadVector_TypePayload 0x0001
+
+typedef struct {
+    PARCBuffer *buffer;
+    const uint8_t *bytes;
+    size_t length;
+} _CCNxPortalPayloadSlice;
+
+struct CCNxPortalPayloadVector {
+    _CCNxPortalPayloadSlice *slices;
+    size_t capacity;
+    size_t count;
+    size_t length;
+};
+
+static uint16_t
+_ccnxPortalPayloadVector_GetUint16(const uint8_t *bytes)
+{
+    return (uint16_t) ((bytes[0] << 8) | bytes[1]);
+}
+
+static void
+_ccnxPortalPayloadVector_PutUint16(uint8_t *bytes, size_t value)
+{
+    bytes[0] = (uint8_t) (value >> 8);
+    bytes[1] = (uint8_t) value;
+}
+
+/*
+ * Find the TLV of the given type among those between offset and end, returning its offset, or 0 if there is none.
+ */
+static size_t
+_ccnxPortalPayloadVector_Find(const uint8_t *bytes, size_t offset, size_t end, uint16_t type)
+{
+    while (offset + _ccnxPortalPayloadVector_TLHeaderLength <= end) {
+        size_t length = _ccnxPortalPayloadVector_GetUint16(bytes + offset + 2);
+        if (_ccnxPortalPayloadVector_GetUint16(bytes + offset) == type) {
+            return (offset + _ccnxPortalPayloadVector_TLHeaderLength + length <= end) ? offset : 0;
+        }
+        offset += _ccnxPortalPayloadVector_TLHeaderLength + length;
+    }
+    return 0;
+}
+
+static void
+_ccnxPortalPayloadVector_Destroy(CCNxPortalPayloadVector **vectorPtr)
+{
+    CCNxPortalPayloadVector *vector = *vectorPtr;
+
+    ccnxPortalPayloadVector_Clear(vector);
+    if (vector->slices != NULL) {
+        parcMemory_Deallocate(&vector->slices);
+    }
+}
+
+parcObject_ExtendPARCObject(CCNxPortalPayloadVector, _ccnxPortalPayloadVector_Destroy, NULL, NULL, NULL, NULL, NULL, NULL);
+
+parcObject_ImplementAcquire(ccnxPortalPayloadVector, CCNxPortalPayloadVector);
+
+parcObject_ImplementRelease(ccnxPortalPayloadVector, CCNxPortalPayloadVector);
+
+CCNxPortalPayloadVector *
+ccnxPortalPayloadVector_Create(void)
+{
+    CCNxPortalPayloadVector *result = parcObject_CreateInstance(CCNxPortalPayloadVector);
+    if (result != NULL) {
+        result->slices = NULL;
+        result->capacity = 0;
+        result->count = 0;
+        result->length = 0;
+    }
+    return result;
+}
+
+bool
+ccnxPortalPayloadVector_Append(CCNxPortalPayloadVector *vector, const PARCBuffer *slice)
+{
+    if (vector->count == vector->capacity) {
+        size_t capacity = (vector->capacity == 0) ? 8 : vector->capacity * 2;
+        _CCNxPortalPayloadSlice *slices = parcMemory_Reallocate(vector->slices, capacity * sizeof(_CCNxPortalPayloadSlice));
+        if (slices == NULL) {
+            errno = ENOMEM;
+            return false;
+        }
+        vector->slices = slices;
+        vector->capacity = capacity;
+    }
+
+    // Refer to the slice's bytes where they are, as they are now, rather than through the buffer's position.
+    _CCNxPortalPayloadSlice *entry = &vector->slices[vector->count++];
+    entry->buffer = parcBuffer_Acquire(slice);
+    entry->bytes = parcByteArray_Array(parcBuffer_Array(slice)) + parcBuffer_ArrayOffset(slice) + parcBuffer_Position(slice);
+    entry->length = parcBuffer_Remaining(slice);
+
+    vector->length += entry->length;
+
+    return true;
+}
+
+void
+ccnxPortalPayloadVector_Clear(CCNxPortalPayloadVector *vector)
+{
+    for (size_t i = 0; i < vector->count; i++) {
+        parcBuffer_Release(&vector->slices[i].buffer);
+    }
+    vector->count = 0;
+    vector->length = 0;
+}
+
+size_t
+ccnxPortalPayloadVector_GetCount(const CCNxPortalPayloadVector *vector)
+{
+    return vector->count;
+}
+
+size_t
+ccnxPortalPayloadVector_GetLength(const CCNxPortalPayloadVector *vector)
+{
+    return vector->length;
+}
+
+static uint8_t *
+_ccnxPortalPayloadVector_Gather(const CCNxPortalPayloadVector *vector, uint8_t *destination)
+{
+    for (size_t i = 0; i < vector->count; i++) {
+        memcpy(destination, vector->slices[i].bytes, vector->slices[i].length);
+        destination += vector->slices[i].length;
+    }
+    return destination;
+}
+
+PARCBuffer *
+ccnxPortalPayloadVector_Flatten(const CCNxPortalPayloadVector *vector)
+{
+    PARCBuffer *result = parcBuffer_Allocate(vector->length);
+    if (result != NULL) {
+        _ccnxPortalPayloadVector_Gather(vector, parcBuffer_Overlay(result, 0));
+        parcBuffer_Flip(result);
+    }
+    return result;
+}
+
+/*
+ * Encode a Content Object with the given name and a single byte payload, and find the payload in the encoding.
+ * Return the encoding, with the offsets of the packet, message and payload lengths, and of the payload's value.
+ */
+static PARCBuffer *
+_ccnxPortalPayloadVector_EncodeHeader(const CCNxName *name, size_t lengthOffset[3], size_t *valueOffset)
+{
+    uint8_t placeholder = 0;
+    PARCBuffer *payload = parcBuffer_Wrap(&placeholder, 1, 0, 1);
+    CCNxContentObject *contentObject = ccnxContentObject_CreateWithNameAndPayload(name, payload);
+    CCNxMetaMessage *message = ccnxMetaMessage_CreateFromContentObject(contentObject);
+    PARCBuffer *result = ccnxMetaMessage_CreateWireFormatBuffer(message, NULL);
+    ccnxMetaMessage_Release(&message);
+    ccnxContentObject_Release(&contentObject);
+    parcBuffer_Release(&payload);
+
+    if (result == NULL) {
+        return NULL;
+    }
+
+    const uint8_t *bytes = parcByteArray_Array(parcBuffer_Array(result)) + parcBuffer_ArrayOffset(result);
+    size_t length = parcBuffer_Remaining(result);
+
+    size_t headerLength = (length < _ccnxPortalPayloadVector_FixedHeaderLength) ? 0 : bytes[_ccnxPortalPayloadVector_HeaderLengthOffset];
+    size_t contentObjectOffset = 0;
+    size_t payloadOffset = 0;
+    if (headerLength >= _ccnxPortalPayloadVector_FixedHeaderLength
+        && bytes[0] == _ccnxPortalPayloadVector_Version
+        && _ccnxPortalPayloadVector_GetUint16(bytes + _ccnxPortalPayloadVector_PacketLengthOffset) == length) {
+        contentObjectOffset = _ccnxPortalPayloadVector_Find(bytes, headerLength, length, _ccnxPortalPayloadVector_TypeContentObject);
+    }
+    if (contentObjectOffset != 0) {
+        size_t contentObjectEnd = contentObjectOffset + _ccnxPortalPayloadVector_TLHeaderLength
+                                  + _ccnxPortalPayloadVector_GetUint16(bytes + contentObjectOffset + 2);
+        payloadOffset = _ccnxPortalPayloadVector_Find(bytes, contentObjectOffset + _ccnxPortalPayloadVector_TLHeaderLength,
+                                                      contentObjectEnd, _ccnxPortalPayloadVector_TypePayload);
+    }
+    if (payloadOffset == 0 || _ccnxPortalPayloadVector_GetUint16(bytes + payloadOffset + 2) != 1) {
+        parcBuffer_Release(&result);
+        return NULL;
+    }
+
+    lengthOffset[0] = _ccnxPortalPayloadVector_PacketLengthOffset;
+    lengthOffset[1] = contentObjectOffset + 2;
+    lengthOffset[2] = payloadOffset + 2;
+    *valueOffset = payloadOffset + _ccnxPortalPayloadVector_TLHeaderLength;
+
+    return result;
+}
+
+CCNxMetaMessage *
+ccnxPortalPayloadVector_CreateMessage(const CCNxPortalPayloadVector *vector, const CCNxName *name)
+{
+    size_t lengthOffset[3];
+    size_t valueOffset;
+    PARCBuffer *header = _ccnxPortalPayloadVector_EncodeHeader(name, lengthOffset, &valueOffset);
+    if (header == NULL) {
+        errno = EINVAL;
+        return NULL;
+    }
+
+    // Every enclosing length grows by the same amount. The packet length is the largest.
+    const uint8_t *encoding = parcByteArray_Array(parcBuffer_Array(header)) + parcBuffer_ArrayOffset(header);
+    size_t encodingLength = parcBuffer_Remaining(header);
+    size_t packetLength = encodingLength - 1 + vector->length;
+    if (packetLength > UINT16_MAX) {
+        parcBuffer_Release(&header);
+        errno = EINVAL;
+        return NULL;
+    }
+
+    PARCBuffer *wireFormat = parcBuffer_Allocate(packetLength);
+    uint8_t *bytes = parcBuffer_Overlay(wireFormat, 0);
+
+    memcpy(bytes, encoding, valueOffset);
+    uint8_t *tail = _ccnxPortalPayloadVector_Gather(vector, bytes + valueOffset);
+    memcpy(tail, encoding + valueOffset + 1, encodingLength - valueOffset - 1);
+
+    for (int i = 0; i < 3; i++) {
+        size_t length = _ccnxPortalPayloadVector_GetUint16(encoding + lengthOffset[i]) - 1 + vector->length;
+        _ccnxPortalPayloadVector_PutUint16(bytes + lengthOffset[i], length);
+    }
+    parcBuffer_Release(&header);
+
+    CCNxMetaMessage *result = ccnxWireFormatMessage_Create(wireFormat);
+    parcBuffer_Release(&wireFormat);
+
+    return result;
+}
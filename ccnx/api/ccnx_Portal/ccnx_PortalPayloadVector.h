@@ -0,0 +1,246 @@
+/*
+ * Copyright (c) 2016, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX OR PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ################################################################################
+ * #
+ * # PATENT NOTICE
+ * #
+ * # This software is distributed under the BSD 2-clause License (see LICENSE
+ * # file).  This BSD License does not make any patent claims and as such, does
+ * # not act as a patent grant.  The purpose of this section is for each contributor
+ * # to define their intentions with respect to intellectual property.
+ * #
+ * # Each contributor to this source code is encouraged to state their patent
+ * # claims and licensing mechanisms for any contributions made. At the end of
+ * # this section contributors may each make their own statements.  Contributor's
+ * # claims and grants only apply to the pieces (source code, programs, text,
+ * # media, etc) that they have contributed directly to this software.
+ * #
+ * # There is no guarantee that this section is complete, up to date or accurate. It
+ * # is up to the contributors to maintain their portion of this section and up to
+ * # the user of the software to verify any claims herein.
+ * #
+ * # Do not remove this header notification.  The contents of this section must be
+ * # present in all distributions of the software.  You may only modify your own
+ * # intellectual property statements.  Please provide contact information.
+ *
+ * - Palo Alto Research Center, Inc
+ * This software distribution does not grant any rights to patents owned by Palo
+ * Alto Research Center, Inc (PARC). Rights to these patents are available via
+ * various mechanisms. As of January 2016 PARC has committed to FRAND licensing any
+ * intellectual property used by its contributions to this software. You may
+ * contact PARC at cipo@parc.com for more information or visit http://www.ccnx.org
+ */
+/**
+ * @file ccnx_PortalPayloadVector.h
+ * @brief A Content Object payload made of a sequence of buffer slices.
+ *
+ * A producer that assembles a payload from several pieces, such as a header, a region of a file and a trailer,
+ * would otherwise flatten them into one contiguous `PARCBuffer` before creating the Content Object,
+ * and the stack would then copy that buffer again while encoding the message.
+ * A payload vector instead refers to each piece where it already is, without copying it,
+ * and {@link ccnxPortalPayloadVector_CreateMessage} gathers the pieces once, directly into the encoded message.
+ * The resulting message already has its wire format, so the stack sends it as it is.
+ *
+ * Each slice is the remaining bytes of a `PARCBuffer`, from its position to its limit, when it is appended.
+ * The vector holds a reference to each buffer, so the buffers' contents must not change while the vector refers to them.
+ *
+ * A vector is not thread-safe.
+ *
+ * @copyright (c) 2016, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC).  All rights reserved.
+ */
+#ifndef CCNx_Portal_API_ccnx_PortalPayloadVector_h
+#define CCNx_Portal_API_ccnx_PortalPayloadVector_h
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include <parc/algol/parc_Buffer.h>
+
+#include <ccnx/common/ccnx_Name.h>
+#include <ccnx/transport/common/transport_MetaMessage.h>
+
+struct CCNxPortalPayloadVector;
+/**
+ * @typedef CCNxPortalPayloadVector
+ * @brief An ordered sequence of buffer slices that together make one payload.
+ */
+typedef struct CCNxPortalPayloadVector CCNxPortalPayloadVector;
+
+/**
+ * Create a new, empty `CCNxPortalPayloadVector`.
+ *
+ * @return non-NULL A pointer to a valid `CCNxPortalPayloadVector` instance.
+ * @return NULL Memory could not be allocated.
+ *
+ * Example:
+ * @code
+ * {
+ *     CCNxPortalPayloadVector *vector = ccnxPortalPayloadVector_Create();
+ *
+ *     ccnxPortalPayloadVector_Release(&vector);
+ * }
+ * @endcode
+ */
+CCNxPortalPayloadVector *ccnxPortalPayloadVector_Create(void);
+
+/**
+ * Increase the number of references to a `CCNxPortalPayloadVector` instance.
+ *
+ * @param [in] vector A pointer to a valid `CCNxPortalPayloadVector` instance.
+ *
+ * @return The same value as @p vector.
+ *
+ * Example:
+ * @code
+ * {
+ *     CCNxPortalPayloadVector *vector = ccnxPortalPayloadVector_Create();
+ *     CCNxPortalPayloadVector *reference = ccnxPortalPayloadVector_Acquire(vector);
+ *
+ *     ccnxPortalPayloadVector_Release(&vector);
+ *     ccnxPortalPayloadVector_Release(&reference);
+ * }
+ * @endcode
+ */
+CCNxPortalPayloadVector *ccnxPortalPayloadVector_Acquire(const CCNxPortalPayloadVector *vector);
+
+/**
+ * Release a previously acquired reference to the given `CCNxPortalPayloadVector` instance,
+ * decrementing the reference count for the instance.
+ *
+ * The pointer to the instance is set to NULL as a side-effect of this function.
+ * When the last reference is released, the references to the slices' buffers are released.
+ *
+ * @param [in,out] vectorPtr A pointer to a pointer to the instance to release.
+ *
+ * Example:
+ * @code
+ * {
+ *     CCNxPortalPayloadVector *vector = ccnxPortalPayloadVector_Create();
+ *
+ *     ccnxPortalPayloadVector_Release(&vector);
+ * }
+ * @endcode
+ */
+void ccnxPortalPayloadVector_Release(CCNxPortalPayloadVector **vectorPtr);
+
+/**
+ * Append the remaining bytes of the given buffer to the payload, without copying them.
+ *
+ * The vector acquires a reference to @p slice. Changing the position or limit of @p slice afterwards does not change the vector.
+ *
+ * @param [in,out] vector A pointer to a valid `CCNxPortalPayloadVector` instance.
+ * @param [in] slice A pointer to a valid `PARCBuffer` instance.
+ *
+ * @return true The slice was appended.
+ * @return false Memory could not be allocated, and errno is set to ENOMEM.
+ *
+ * Example:
+ * @code
+ * {
+ *     CCNxPortalPayloadVector *vector = ccnxPortalPayloadVector_Create();
+ *     ccnxPortalPayloadVector_Append(vector, header);
+ *     ccnxPortalPayloadVector_Append(vector, body);
+ *     ccnxPortalPayloadVector_Append(vector, trailer);
+ *
+ *     ccnxPortalPayloadVector_Release(&vector);
+ * }
+ * @endcode
+ */
+bool ccnxPortalPayloadVector_Append(CCNxPortalPayloadVector *vector, const PARCBuffer *slice);
+
+/**
+ * Remove every slice from the payload, releasing the vector's references to their buffers, so that it may be reused.
+ *
+ * @param [in,out] vector A pointer to a valid `CCNxPortalPayloadVector` instance.
+ */
+void ccnxPortalPayloadVector_Clear(CCNxPortalPayloadVector *vector);
+
+/**
+ * Get the number of slices in the payload.
+ *
+ * @param [in] vector A pointer to a valid `CCNxPortalPayloadVector` instance.
+ *
+ * @return The number of slices.
+ */
+size_t ccnxPortalPayloadVector_GetCount(const CCNxPortalPayloadVector *vector);
+
+/**
+ * Get the length of the payload, the sum of the lengths of its slices, in bytes.
+ *
+ * @param [in] vector A pointer to a valid `CCNxPortalPayloadVector` instance.
+ *
+ * @return The length of the payload in bytes.
+ */
+size_t ccnxPortalPayloadVector_GetLength(const CCNxPortalPayloadVector *vector);
+
+/**
+ * Copy the payload into a single new `PARCBuffer`.
+ *
+ * This is the copy a payload vector otherwise avoids,
+ * for use where a contiguous payload is needed, such as a Content Object that is to be signed.
+ *
+ * @param [in] vector A pointer to a valid `CCNxPortalPayloadVector` instance.
+ *
+ * @return non-NULL A pointer to a `PARCBuffer` instance, with position 0 and limit the payload length, that must be released by the caller.
+ * @return NULL Memory could not be allocated.
+ *
+ * Example:
+ * @code
+ * {
+ *     PARCBuffer *payload = ccnxPortalPayloadVector_Flatten(vector);
+ *     CCNxContentObject *contentObject = ccnxContentObject_CreateWithNameAndPayload(name, payload);
+ *     parcBuffer_Release(&payload);
+ *
+ *     ...
+ * }
+ * @endcode
+ */
+PARCBuffer *ccnxPortalPayloadVector_Flatten(const CCNxPortalPayloadVector *vector);
+
+/**
+ * Create an encoded Content Object message with the given name and the payload, gathering the slices directly into the encoding.
+ *
+ * The Content Object carries only its name and payload. It is neither signed nor decoded:
+ * the returned message has only its wire format, which stacks send as it is.
+ *
+ * @param [in] vector A pointer to a valid `CCNxPortalPayloadVector` instance.
+ * @param [in] name A pointer to a valid `CCNxName` instance.
+ *
+ * @return non-NULL A pointer to a `CCNxMetaMessage` instance that must be released by the caller.
+ * @return NULL The message could not be encoded, and errno is set: EINVAL if it would exceed the largest CCNx packet.
+ *
+ * Example:
+ * @code
+ * {
+ *     CCNxMetaMessage *message = ccnxPortalPayloadVector_CreateMessage(vector, name);
+ *     if (message != NULL) {
+ *         ccnxPortal_Send(portal, message, CCNxStackTimeout_Never);
+ *         ccnxMetaMessage_Release(&message);
+ *     }
+ * }
+ * @endcode
+ */
+CCNxMetaMessage *ccnxPortalPayloadVector_CreateMessage(const CCNxPortalPayloadVector *vector, const CCNxName *name);
+#endif // CCNx_Portal_API_ccnx_PortalPayloadVector_h
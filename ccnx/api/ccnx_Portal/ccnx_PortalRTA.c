@@ -66,18 +66,20 @@
 #include <pthread.h>
 #include <poll.h>
 #include <stdio.h>
+#include <time.h>
+#include <sched.h>
+#include <sys/socket.h>
 
 #include <ccnx/api/ccnx_Portal/ccnx_PortalRTA.h>
 #include <ccnx/api/ccnx_Portal/ccnx_PortalFactory.h>
 #include <ccnx/api/ccnx_Portal/ccnx_PortalStack.h>
+#include <ccnx/api/ccnx_Portal/ccnx_PortalLogger.h>
 
 #include <parc/algol/parc_Object.h>
 #include <parc/algol/parc_List.h>
 #include <parc/algol/parc_ArrayList.h>
 #include <parc/algol/parc_DisplayIndented.h>
 
-#include <parc/logging/parc_Log.h>
-#include <parc/logging/parc_LogReporterTextStdout.h>
 
 #include <parc/security/parc_Signer.h>
 
@@ -120,19 +122,80 @@ typedef struct _CCNxPortalRTAContext {
     const CCNxTransportConfig *(*createTransportConfig)(const CCNxPortalFactory *, _CCNxPortalType, _CCNxPortalProtocol);
     const CCNxTransportConfig *configuration;
     int fileId;
-    PARCLog *logger;
+    CCNxPortalLoggerCategory logCategory;
+    CCNxPortalAttributes *attributes;
 } _CCNxPortalRTAContext;
 
+#ifdef __linux__
+// The Portal stack that pinned this thread for busy-polling, the CPU, and the thread's affinity before it was pinned.
+static __thread const _CCNxPortalRTAContext *_ccnxPortalRTA_PinnedBy = NULL;
+static __thread int _ccnxPortalRTA_PinnedCpu = -1;
+static __thread cpu_set_t _ccnxPortalRTA_UnpinnedCpuSet;
+#endif
+
+/*
+ * Restore the calling thread's affinity from before it was pinned, if the given Portal stack pinned it.
+ */
+static void
+_ccnxPortalRTA_UnpinThread(const _CCNxPortalRTAContext *transportContext)
+{
+#ifdef __linux__
+    if (_ccnxPortalRTA_PinnedBy == transportContext && transportContext != NULL) {
+        pthread_setaffinity_np(pthread_self(), sizeof(_ccnxPortalRTA_UnpinnedCpuSet), &_ccnxPortalRTA_UnpinnedCpuSet);
+        _ccnxPortalRTA_PinnedBy = NULL;
+        _ccnxPortalRTA_PinnedCpu = -1;
+    }
+#endif
+}
+
+/*
+ * Pin the calling thread to the given CPU on behalf of a Portal stack, saving the affinity it had before.
+ * A CPU of -1 restores that affinity.
+ */
+static void
+_ccnxPortalRTA_PinThread(const _CCNxPortalRTAContext *transportContext, int cpu)
+{
+#ifdef __linux__
+    if (cpu < 0 || cpu >= CPU_SETSIZE) {
+        _ccnxPortalRTA_UnpinThread(transportContext);
+        return;
+    }
+    if (_ccnxPortalRTA_PinnedBy == transportContext && _ccnxPortalRTA_PinnedCpu == cpu) {
+        return;
+    }
+
+    // A thread already pinned by another Portal keeps the affinity saved before the first pin.
+    if (_ccnxPortalRTA_PinnedBy == NULL
+        && pthread_getaffinity_np(pthread_self(), sizeof(_ccnxPortalRTA_UnpinnedCpuSet), &_ccnxPortalRTA_UnpinnedCpuSet) != 0) {
+        return;
+    }
+
+    cpu_set_t cpuSet;
+    CPU_ZERO(&cpuSet);
+    CPU_SET(cpu, &cpuSet);
+    if (pthread_setaffinity_np(pthread_self(), sizeof(cpuSet), &cpuSet) == 0) {
+        _ccnxPortalRTA_PinnedBy = transportContext;
+        _ccnxPortalRTA_PinnedCpu = cpu;
+    }
+#endif
+}
+
 static void
 _ccnxPortalRTAContext_Destroy(_CCNxPortalRTAContext **instancePtr)
 {
     _CCNxPortalRTAContext *instance = *instancePtr;
 
+    _ccnxPortalRTA_UnpinThread(instance);
+
     rtaTransport_Close(instance->rtaTransport, instance->fileId);
     rtaTransport_Destroy(&instance->rtaTransport);
 
     ccnxTransportConfig_Destroy((CCNxTransportConfig **) &instance->configuration);
-    parcLog_Release(&instance->logger);
+    ccnxPortalLogger_RemoveCategory(instance->logCategory);
+
+    if (instance->attributes != NULL) {
+        ccnxPortalAttributes_Release(&instance->attributes);
+    }
 }
 
 parcObject_ExtendPARCObject(_CCNxPortalRTAContext, _ccnxPortalRTAContext_Destroy,
@@ -148,11 +211,8 @@ _ccnxPortalRTAContext_Create(RTATransport *rtaTransport, const CCNxTransportConf
         result->rtaTransport = rtaTransport;
         result->configuration = configuration;
         result->fileId = fileId;
-
-        PARCLogReporter *reporter = parcLogReporterTextStdout_Create();
-        result->logger = parcLog_Create(NULL, "ccnxPortalRTA", NULL, reporter);
-        parcLogReporter_Release(&reporter);
-        parcLog_SetLevel(result->logger, PARCLogLevel_Debug);
+        result->attributes = NULL;
+        result->logCategory = ccnxPortalLogger_AddCategory("ccnxPortalRTA");
     }
 
     return result;
@@ -270,20 +330,76 @@ _ccnxPortalRTA_Send(void *privateData, const CCNxMetaMessage *portalMessage, con
     const _CCNxPortalRTAContext *transportContext = (_CCNxPortalRTAContext *) privateData;
 
     bool result = rtaTransport_Send(transportContext->rtaTransport, transportContext->fileId, portalMessage, microSeconds);
+    if (result == false) {
+        ccnxPortalLogger_Log(transportContext->logCategory, PARCLogLevel_Debug, "fd %" PRId64 " send failed: errno %" PRId64,
+                             transportContext->fileId, errno, 0, 0);
+    }
 
     return result;
 }
 
+static uint64_t
+_ccnxPortalRTA_NowMicroSeconds(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t) now.tv_sec * 1000000ULL + (uint64_t) now.tv_nsec / 1000ULL;
+}
+
+/*
+ * Spin until the descriptor is readable or the budget is spent.
+ * Returns the number of microseconds spent.
+ */
+static uint64_t
+_ccnxPortalRTA_BusyPoll(int fd, uint64_t budgetMicroSeconds)
+{
+    struct pollfd pollfd = { .fd = fd, .events = POLLIN };
+
+    uint64_t start = _ccnxPortalRTA_NowMicroSeconds();
+    uint64_t spent = 0;
+
+    while (spent < budgetMicroSeconds) {
+        if (poll(&pollfd, 1, 0) > 0) {
+            break;
+        }
+#if defined(__x86_64__) || defined(__i386__)
+        __builtin_ia32_pause();
+#endif
+        spent = _ccnxPortalRTA_NowMicroSeconds() - start;
+    }
+
+    return spent;
+}
+
 static CCNxMetaMessage *
 _ccnxPortalRTA_Receive(void *privateData, const CCNxStackTimeout *microSeconds)
 {
     const _CCNxPortalRTAContext *transportContext = (_CCNxPortalRTAContext *) privateData;
 
+    // Busy-poll for up to the configured budget, then fall back to waiting for the remainder of the timeout.
+    uint64_t remaining;
+    uint32_t busyPoll = (transportContext->attributes == NULL) ? 0 : ccnxPortalAttributes_GetBusyPollMicroSeconds(transportContext->attributes);
+    if (busyPoll > 0 && (microSeconds == CCNxStackTimeout_Never || *microSeconds > 0)) {
+        _ccnxPortalRTA_PinThread(transportContext, ccnxPortalAttributes_GetBusyPollCpu(transportContext->attributes));
+
+        uint64_t budget = (microSeconds == CCNxStackTimeout_Never || *microSeconds > busyPoll) ? busyPoll : *microSeconds;
+        uint64_t spent = _ccnxPortalRTA_BusyPoll(transportContext->fileId, budget);
+
+        if (microSeconds != CCNxStackTimeout_Never) {
+            remaining = (spent < *microSeconds) ? *microSeconds - spent : 0;
+            microSeconds = &remaining;
+        }
+    } else if (busyPoll == 0) {
+        _ccnxPortalRTA_UnpinThread(transportContext);
+    }
+
     CCNxMetaMessage *result = NULL;
 
     TransportIOStatus status = rtaTransport_Recv(transportContext->rtaTransport, transportContext->fileId, &result, microSeconds);
 
     if (status != TransportIOStatus_Success) {
+        ccnxPortalLogger_Log(transportContext->logCategory, PARCLogLevel_Debug, "fd %" PRId64 " receive status %" PRId64,
+                             transportContext->fileId, status, 0, 0);
         return NULL;
     }
 
@@ -301,31 +417,103 @@ _ccnxPortalRTA_GetFileId(void *privateData)
 static CCNxPortalAttributes *
 _ccnxPortalRTA_GetAttributes(void *privateData)
 {
-    return NULL;
+    const _CCNxPortalRTAContext *transportContext = (_CCNxPortalRTAContext *) privateData;
+
+    return transportContext->attributes;
 }
 
 static bool
-_nonBlockingPortal(const _CCNxPortalRTAContext *transportContext)
+_ccnxPortalRTA_SetBlocking(int fd, bool blocking)
 {
-    int fd = transportContext->fileId;
     int flags;
 
     if ((flags = fcntl(fd, F_GETFL, NULL)) != -1) {
-        if (fcntl(fd, F_SETFL, flags | O_NONBLOCK) != -1) {
+        flags = blocking ? (flags & ~O_NONBLOCK) : (flags | O_NONBLOCK);
+        if (fcntl(fd, F_SETFL, flags) != -1) {
             return true;
         }
     }
     return false;
 }
 
+/*
+ * Request a socket buffer size and return the size actually granted, which the kernel may round or double.
+ * A size of zero leaves the system default in place.
+ * The RTA API connector's descriptor is a socket; anything else (ENOTSOCK) keeps the requested value.
+ */
 static bool
-_ccnxPortalRTA_SetAttributes(void *privateData, const CCNxPortalAttributes *attributes)
+_ccnxPortalRTA_SetSocketBuffer(int fd, int option, size_t requested, size_t *granted)
 {
-    const _CCNxPortalRTAContext *transportContext = (_CCNxPortalRTAContext *) privateData;
+    *granted = requested;
+    if (requested == 0) {
+        return true;
+    }
 
-    bool result = _nonBlockingPortal(transportContext);
+    int size = (int) requested;
+    if (setsockopt(fd, SOL_SOCKET, option, &size, sizeof(size)) == -1) {
+        return errno == ENOTSOCK;
+    }
 
-    return result;
+    socklen_t length = sizeof(size);
+    if (getsockopt(fd, SOL_SOCKET, option, &size, &length) == 0) {
+        *granted = (size_t) size;
+    }
+    return true;
+}
+
+/*
+ * Apply the given attributes to the RTA file descriptor and remember the values in effect.
+ *
+ * The RTA API connector has no message queue of its own between the Portal and the transport:
+ * the socket buffers are the send and receive queues, so the queue limits are recorded but bounded by the buffer sizes.
+ */
+static bool
+_ccnxPortalRTA_ApplyAttributes(_CCNxPortalRTAContext *transportContext, const CCNxPortalAttributes *attributes)
+{
+    int fd = transportContext->fileId;
+
+    if (_ccnxPortalRTA_SetBlocking(fd, ccnxPortalAttributes_IsBlocking(attributes)) == false) {
+        return false;
+    }
+
+    size_t sendBufferSize;
+    size_t receiveBufferSize;
+    if (_ccnxPortalRTA_SetSocketBuffer(fd, SO_SNDBUF, ccnxPortalAttributes_GetSocketSendBufferSize(attributes), &sendBufferSize) == false) {
+        return false;
+    }
+    if (_ccnxPortalRTA_SetSocketBuffer(fd, SO_RCVBUF, ccnxPortalAttributes_GetSocketReceiveBufferSize(attributes), &receiveBufferSize) == false) {
+        return false;
+    }
+
+    CCNxPortalAttributes *effective = ccnxPortalAttributes_Copy(attributes);
+    if (effective == NULL) {
+        return false;
+    }
+    ccnxPortalAttributes_SetSocketSendBufferSize(effective, sendBufferSize);
+    ccnxPortalAttributes_SetSocketReceiveBufferSize(effective, receiveBufferSize);
+
+    ccnxPortalLogger_SetLevel(transportContext->logCategory,
+                              ccnxPortalAttributes_IsLogging(attributes) ? PARCLogLevel_Debug : PARCLogLevel_Off);
+
+    if (transportContext->attributes != NULL) {
+        ccnxPortalAttributes_Release(&transportContext->attributes);
+    }
+    transportContext->attributes = effective;
+
+    // Unpinning here covers the common case of the receiving thread clearing the CPU; other threads unpin on their next receive.
+    if (ccnxPortalAttributes_GetBusyPollMicroSeconds(effective) == 0 || ccnxPortalAttributes_GetBusyPollCpu(effective) < 0) {
+        _ccnxPortalRTA_UnpinThread(transportContext);
+    }
+
+    return true;
+}
+
+static bool
+_ccnxPortalRTA_SetAttributes(void *privateData, const CCNxPortalAttributes *attributes)
+{
+    _CCNxPortalRTAContext *transportContext = (_CCNxPortalRTAContext *) privateData;
+
+    return _ccnxPortalRTA_ApplyAttributes(transportContext, attributes);
 }
 
 static bool
@@ -463,7 +651,7 @@ _ccnxPortalRTA_CreatePortal(const CCNxPortalFactory *factory,
 
             if (result != NULL) {
                 if (_ccnxPortalRTA_IsConnected(result) == true) {
-                    _nonBlockingPortal(transportContext);
+                    ccnxPortal_SetAttributes(result, (attributes != NULL) ? attributes : &ccnxPortalAttributes_NonBlocking);
                 } else {
                     ccnxPortal_Release(&result);
                 }
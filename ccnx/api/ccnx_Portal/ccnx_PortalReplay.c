@@ -0,0 +1,396 @@
+/*
+ * Copyright (c) 2016, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX OR PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ################################################################################
+ * #
+ * # PATENT NOTICE
+ * #
+ * # This software is distributed under the BSD 2-clause License (see LICENSE
+ * # file).  This BSD License does not make any patent claims and as such, does
+ * # not act as a patent grant.  The purpose of this section is for each contributor
+ * # to define their intentions with respect to intellectual property.
+ * #
+ * # Each contributor to this source code is encouraged to state their patent
+ * # claims and licensing mechanisms for any contributions made. At the end of
+ * # this section contributors may each make their own statements.  Contributor's
+ * # claims and grants only apply to the pieces (source code, programs, text,
+ * # media, etc) that they have contributed directly to this software.
+ * #
+ * # There is no guarantee that this section is complete, up to date or accurate. It
+ * # is up to the contributors to maintain their portion of this section and up to
+ * # the user of the software to verify any claims herein.
+ * #
+ * # Do not remove this header notification.  The contents of this section must be
+ * # present in all distributions of the software.  You may only modify your own
+ * # intellectual property statements.  Please provide contact information.
+ *
+ * - Palo Alto Research Center, Inc
+ * This software distribution does not grant any rights to patents owned by Palo
+ * Alto Research Center, Inc (PARC). Rights to these patents are available via
+ * various mechanisms. As of January 2016 PARC has committed to FRAND licensing any
+ * intellectual property used by its contributions to this software. You may
+ * contact PARC at cipo@parc.com for more information or visit http://www.ccnx.org
+ */
+/**
+ * @copyright (c) 2016, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC).  All rights reserved.
+ */
+#include <config.h>
+
+#include <errno.h>
+#include <time.h>
+
+#include <LongBow/runtime.h>
+
+#include <ccnx/api/ccnx_Portal/ccnx_PortalArena.h>
+#include <ccnx/api/ccnx_Portal/ccnx_PortalReplay.h>
+#include <ccnx/api/ccnx_Portal/ccnx_PortalTrace.h>
+
+#include <parc/algol/parc_Object.h>
+#include <parc/algol/parc_Memory.h>
+
+#include <ccnx/api/control/cpi_Acks.h>
+
+const char *CCNxPortalReplay_File = "/localstack/portalReplay/ReplayFile";
+
+/*
+ * A response to a Control message the Portal sent, delivered ahead of the trace.
+ */
+typedef struct _ccnxPortalReplayReply {
+    CCNxMetaMessage *message;
+    struct _ccnxPortalReplayReply *next;
+} _CCNxPortalReplayReply;
+
+typedef struct {
+    CCNxPortalTrace *trace;
+    bool originalTiming;
+    bool ended;
+
+    CCNxName *anchorName;
+    unsigned int anchorResponsesDue;
+
+    CCNxMetaMessage *pending;
+    uint64_t pendingTimestamp;
+
+    _CCNxPortalReplayReply *replies;
+    _CCNxPortalReplayReply *lastReply;
+
+    bool started;
+    uint64_t firstTimestamp;
+    uint64_t startTime;
+} _CCNxPortalReplayContext;
+
+static CCNxMetaMessage *
+_ccnxPortalReplay_TakeReply(_CCNxPortalReplayContext *context)
+{
+    _CCNxPortalReplayReply *reply = context->replies;
+    context->replies = reply->next;
+    if (context->replies == NULL) {
+        context->lastReply = NULL;
+    }
+
+    CCNxMetaMessage *result = reply->message;
+    parcMemory_Deallocate((void **) &reply);
+    return result;
+}
+
+static void
+_ccnxPortalReplayContext_Destroy(_CCNxPortalReplayContext **instancePtr)
+{
+    _CCNxPortalReplayContext *instance = *instancePtr;
+
+    if (instance->pending != NULL) {
+        ccnxMetaMessage_Release(&instance->pending);
+    }
+    while (instance->replies != NULL) {
+        CCNxMetaMessage *reply = _ccnxPortalReplay_TakeReply(instance);
+        ccnxMetaMessage_Release(&reply);
+    }
+    ccnxName_Release(&instance->anchorName);
+    ccnxPortalTrace_Release(&instance->trace);
+}
+
+parcObject_ExtendPARCObject(_CCNxPortalReplayContext, _ccnxPortalReplayContext_Destroy, NULL, NULL, NULL, NULL, NULL, NULL);
+
+static parcObject_ImplementRelease(_ccnxPortalReplayContext, _CCNxPortalReplayContext);
+
+static uint64_t
+_ccnxPortalReplay_Monotonic(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t) now.tv_sec * 1000000000ULL + (uint64_t) now.tv_nsec;
+}
+
+static void
+_ccnxPortalReplay_Sleep(uint64_t nanoSeconds)
+{
+    struct timespec delay = { .tv_sec = nanoSeconds / 1000000000ULL, .tv_nsec = nanoSeconds % 1000000000ULL };
+    while (nanosleep(&delay, &delay) != 0 && errno == EINTR) {
+        ;
+    }
+}
+
+/*
+ * Ensure the next replayable message, if any, is in the pending slot.
+ * Messages the Portal sent, and Control messages received from the original stack, are skipped.
+ */
+static bool
+_ccnxPortalReplay_Fill(_CCNxPortalReplayContext *context)
+{
+    while (context->pending == NULL && !context->ended) {
+        CCNxPortalTraceDirection direction;
+        CCNxMetaMessage *message = ccnxPortalTrace_Next(context->trace, &direction, &context->pendingTimestamp);
+        if (message == NULL) {
+            context->ended = true;
+        } else if (direction == CCNxPortalTraceDirection_Receive && !ccnxMetaMessage_IsControl(message)) {
+            context->pending = message;
+        } else {
+            ccnxMetaMessage_Release(&message);
+        }
+    }
+    return context->pending != NULL;
+}
+
+/*
+ * As _ccnxPortalReplay_Fill, for a message that may stay pending beyond this receive.
+ * It is decoded with the receiving arena, if any, suspended, as it may outlive the batch.
+ */
+static bool
+_ccnxPortalReplay_FillAhead(_CCNxPortalReplayContext *context)
+{
+    CCNxPortalArena *arena = ccnxPortalArena_Suspend();
+    bool result = _ccnxPortalReplay_Fill(context);
+    ccnxPortalArena_Resume(arena);
+    return result;
+}
+
+static CCNxMetaMessage *
+_ccnxPortalReplay_TakePending(_CCNxPortalReplayContext *context)
+{
+    CCNxMetaMessage *result = context->pending;
+    context->pending = NULL;
+    return result;
+}
+
+static void
+_ccnxPortalReplay_Start(void *privateData)
+{
+}
+
+static void
+_ccnxPortalReplay_Stop(void *privateData)
+{
+}
+
+/*
+ * Acknowledge a CPI request from the Portal, such as the one `ccnxPortal_Flush` sends and waits on.
+ * The acknowledgement is received ahead of the rest of the trace.
+ */
+static bool
+_ccnxPortalReplay_Acknowledge(_CCNxPortalReplayContext *context, CCNxControl *control)
+{
+    _CCNxPortalReplayReply *reply = parcMemory_Allocate(sizeof(_CCNxPortalReplayReply));
+    if (reply == NULL) {
+        errno = ENOMEM;
+        return false;
+    }
+
+    PARCJSON *json = cpiAcks_CreateAck(ccnxControl_GetJson(control));
+    CCNxControl *ack = ccnxControl_CreateCPIRequest(json);
+    reply->message = ccnxMetaMessage_CreateFromControl(ack);
+    reply->next = NULL;
+    ccnxControl_Release(&ack);
+    parcJSON_Release(&json);
+
+    if (context->lastReply == NULL) {
+        context->replies = reply;
+    } else {
+        context->lastReply->next = reply;
+    }
+    context->lastReply = reply;
+    return true;
+}
+
+static bool
+_ccnxPortalReplay_Send(void *privateData, const CCNxMetaMessage *message, const CCNxStackTimeout *microSeconds)
+{
+    _CCNxPortalReplayContext *context = privateData;
+
+    // Control messages from the Portal are not part of the trace and do not consume it.
+    // CPI requests are acknowledged so callers waiting on a response, such as ccnxPortal_Flush, complete; others are ignored.
+    if (ccnxMetaMessage_IsControl(message)) {
+        CCNxControl *control = ccnxMetaMessage_GetControl(message);
+        if (ccnxControl_IsCPI(control)) {
+            return _ccnxPortalReplay_Acknowledge(context, control);
+        }
+    } else if (ccnxMetaMessage_IsInterest(message)) {
+        CCNxName *name = ccnxInterest_GetName(ccnxMetaMessage_GetInterest(message));
+        if (ccnxName_StartsWith(name, context->anchorName)) {
+            context->anchorResponsesDue++;
+        }
+    }
+    return true;
+}
+
+static CCNxMetaMessage *
+_ccnxPortalReplay_Receive(void *privateData, const CCNxStackTimeout *microSeconds)
+{
+    _CCNxPortalReplayContext *context = privateData;
+
+    if (context->replies != NULL) {
+        return _ccnxPortalReplay_TakeReply(context);
+    }
+
+    if (context->ended) {
+        errno = ENODATA;
+        return NULL;
+    }
+
+    if (context->anchorResponsesDue > 0) {
+        context->anchorResponsesDue--;
+        if (_ccnxPortalReplay_FillAhead(context) && !ccnxMetaMessage_IsInterest(context->pending)) {
+            return _ccnxPortalReplay_TakePending(context);
+        }
+        errno = EWOULDBLOCK;
+        return NULL;
+    }
+
+    // Replaying at the original timing may leave the message pending until a later receive.
+    bool filled = context->originalTiming ? _ccnxPortalReplay_FillAhead(context) : _ccnxPortalReplay_Fill(context);
+    if (!filled) {
+        errno = ENODATA;
+        return NULL;
+    }
+
+    if (context->originalTiming) {
+        uint64_t now = _ccnxPortalReplay_Monotonic();
+        if (!context->started) {
+            context->started = true;
+            context->firstTimestamp = context->pendingTimestamp;
+            context->startTime = now;
+        }
+
+        uint64_t offset = (context->pendingTimestamp > context->firstTimestamp) ? context->pendingTimestamp - context->firstTimestamp : 0;
+        uint64_t due = context->startTime + offset;
+        if (due > now) {
+            uint64_t delay = due - now;
+            if (microSeconds != CCNxStackTimeout_Never && *microSeconds * 1000ULL < delay) {
+                _ccnxPortalReplay_Sleep(*microSeconds * 1000ULL);
+                errno = EWOULDBLOCK;
+                return NULL;
+            }
+            _ccnxPortalReplay_Sleep(delay);
+        }
+    }
+
+    return _ccnxPortalReplay_TakePending(context);
+}
+
+static int
+_ccnxPortalReplay_GetFileId(void *privateData)
+{
+    return -1;
+}
+
+static CCNxPortalAttributes *
+_ccnxPortalReplay_GetAttributes(void *privateData)
+{
+    return NULL;
+}
+
+static bool
+_ccnxPortalReplay_SetAttributes(void *privateData, const CCNxPortalAttributes *attributes)
+{
+    return true;
+}
+
+static bool
+_ccnxPortalReplay_Listen(void *privateData, const CCNxName *name, const CCNxStackTimeout *microSeconds)
+{
+    return true;
+}
+
+static bool
+_ccnxPortalReplay_Ignore(void *privateData, const CCNxName *name, const CCNxStackTimeout *microSeconds)
+{
+    return true;
+}
+
+static CCNxPortal *
+_ccnxPortalReplay_Create(const CCNxPortalFactory *factory, const CCNxPortalAttributes *attributes, bool originalTiming)
+{
+    const char *fileName = ccnxPortalFactory_GetProperty(factory, CCNxPortalReplay_File, NULL);
+    if (fileName == NULL) {
+        errno = EINVAL;
+        return NULL;
+    }
+
+    CCNxPortalTrace *trace = ccnxPortalTrace_CreateReader(fileName);
+    if (trace == NULL) {
+        return NULL;
+    }
+
+    _CCNxPortalReplayContext *context = parcObject_CreateInstance(_CCNxPortalReplayContext);
+    context->trace = trace;
+    context->originalTiming = originalTiming;
+    context->ended = false;
+    context->anchorResponsesDue = 0;
+    context->pending = NULL;
+    context->pendingTimestamp = 0;
+    context->replies = NULL;
+    context->lastReply = NULL;
+    context->started = false;
+
+    context->anchorName = ccnxName_Acquire(ccnxPortalConfiguration_GetAnchorName(ccnxPortalFactory_GetConfiguration(factory)));
+
+    CCNxPortalStack *stack =
+        ccnxPortalStack_Create(factory,
+                               attributes,
+                               _ccnxPortalReplay_Start,
+                               _ccnxPortalReplay_Stop,
+                               _ccnxPortalReplay_Receive,
+                               _ccnxPortalReplay_Send,
+                               _ccnxPortalReplay_Listen,
+                               _ccnxPortalReplay_Ignore,
+                               _ccnxPortalReplay_GetFileId,
+                               _ccnxPortalReplay_SetAttributes,
+                               _ccnxPortalReplay_GetAttributes,
+                               context,
+                               (void (*)(void **))_ccnxPortalReplayContext_Release);
+
+    CCNxPortal *result = ccnxPortal_Create(attributes, stack);
+    return result;
+}
+
+CCNxPortal *
+ccnxPortalReplay_OriginalTiming(const CCNxPortalFactory *factory, const CCNxPortalAttributes *attributes)
+{
+    return _ccnxPortalReplay_Create(factory, attributes, true);
+}
+
+CCNxPortal *
+ccnxPortalReplay_AsFastAsPossible(const CCNxPortalFactory *factory, const CCNxPortalAttributes *attributes)
+{
+    return _ccnxPortalReplay_Create(factory, attributes, false);
+}
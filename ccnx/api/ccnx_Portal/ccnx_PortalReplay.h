@@ -0,0 +1,124 @@
+/*
+ * Copyright (c) 2016, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX OR PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ################################################################################
+ * #
+ * # PATENT NOTICE
+ * #
+ * # This software is distributed under the BSD 2-clause License (see LICENSE
+ * # file).  This BSD License does not make any patent claims and as such, does
+ * # not act as a patent grant.  The purpose of this section is for each contributor
+ * # to define their intentions with respect to intellectual property.
+ * #
+ * # Each contributor to this source code is encouraged to state their patent
+ * # claims and licensing mechanisms for any contributions made. At the end of
+ * # this section contributors may each make their own statements.  Contributor's
+ * # claims and grants only apply to the pieces (source code, programs, text,
+ * # media, etc) that they have contributed directly to this software.
+ * #
+ * # There is no guarantee that this section is complete, up to date or accurate. It
+ * # is up to the contributors to maintain their portion of this section and up to
+ * # the user of the software to verify any claims herein.
+ * #
+ * # Do not remove this header notification.  The contents of this section must be
+ * # present in all distributions of the software.  You may only modify your own
+ * # intellectual property statements.  Please provide contact information.
+ *
+ * - Palo Alto Research Center, Inc
+ * This software distribution does not grant any rights to patents owned by Palo
+ * Alto Research Center, Inc (PARC). Rights to these patents are available via
+ * various mechanisms. As of January 2016 PARC has committed to FRAND licensing any
+ * intellectual property used by its contributions to this software. You may
+ * contact PARC at cipo@parc.com for more information or visit http://www.ccnx.org
+ */
+/**
+ * @file ccnx_PortalReplay.h
+ * @brief Portal Protocol Stack implementations that replay a recorded trace.
+ *
+ * These stacks deliver the received messages of a trace file recorded via {@link CCNxPortalTrace_RecordFile}
+ * to `ccnxPortal_Receive` without a forwarder, either at their original timing or as fast as possible.
+ * The trace file is named by the `CCNxPortalFactory` property `CCNxPortalReplay_File`.
+ *
+ * Messages sent to a replay stack are discarded and `ccnxPortal_Listen` and `ccnxPortal_Ignore` always succeed.
+ * Received Control messages in the trace are not replayed.
+ * A recorded response to the anchor Interest sent by `ccnxPortal_Listen` is consumed by that call, as it was when recorded.
+ * Control messages sent to a replay stack do not consume the trace:
+ * CPI requests, such as the one sent by `ccnxPortal_Flush`, are acknowledged ahead of the remaining trace messages
+ * and other Control messages are discarded.
+ *
+ * When the trace is exhausted `ccnxPortal_Receive` returns NULL and the Portal error is `ENODATA`.
+ *
+ * @copyright (c) 2016, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC).  All rights reserved.
+ */
+#ifndef CCNx_Portal_API_ccnx_PortalReplay_h
+#define CCNx_Portal_API_ccnx_PortalReplay_h
+
+#include <ccnx/api/ccnx_Portal/ccnx_PortalAttributes.h>
+#include <ccnx/api/ccnx_Portal/ccnx_Portal.h>
+
+/**
+ * The name of the `CCNxPortalFactory` property containing the name of the trace file to replay.
+ */
+extern const char *CCNxPortalReplay_File;
+
+/**
+ * Specification for a stack that replays a trace preserving the original time between received messages.
+ *
+ * A call to `ccnxPortal_Receive` waits until the next message is due, or until its timeout expires.
+ *
+ * @param [in] factory A pointer to a valid {@link CCNxPortalFactory} instance.
+ * @param [in] attributes A pointer to a valid {@link CCNxPortalAttributes} instance.
+ *
+ * @return non-NULL A pointer to a valid {@link CCNxPortal} instance bound to the trace.
+ * @return NULL The trace file could not be opened. See the value of `errno`.
+ *
+ * Example:
+ * @code
+ * {
+ *     ccnxPortalFactory_SetProperty(factory, CCNxPortalReplay_File, "/tmp/server.trace");
+ *     CCNxPortal *portal = ccnxPortalFactory_CreatePortal(factory, ccnxPortalReplay_OriginalTiming);
+ * }
+ * @endcode
+ */
+CCNxPortal *ccnxPortalReplay_OriginalTiming(const CCNxPortalFactory *factory, const CCNxPortalAttributes *attributes);
+
+/**
+ * Specification for a stack that replays a trace as fast as the receiver consumes it.
+ *
+ * @param [in] factory A pointer to a valid {@link CCNxPortalFactory} instance.
+ * @param [in] attributes A pointer to a valid {@link CCNxPortalAttributes} instance.
+ *
+ * @return non-NULL A pointer to a valid {@link CCNxPortal} instance bound to the trace.
+ * @return NULL The trace file could not be opened. See the value of `errno`.
+ *
+ * Example:
+ * @code
+ * {
+ *     ccnxPortalFactory_SetProperty(factory, CCNxPortalReplay_File, "/tmp/server.trace");
+ *     CCNxPortal *portal = ccnxPortalFactory_CreatePortal(factory, ccnxPortalReplay_AsFastAsPossible);
+ * }
+ * @endcode
+ */
+CCNxPortal *ccnxPortalReplay_AsFastAsPossible(const CCNxPortalFactory *factory, const CCNxPortalAttributes *attributes);
+#endif // CCNx_Portal_API_ccnx_PortalReplay_h
@@ -0,0 +1,346 @@
+/*
+ * Copyright (c) 2016, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX OR PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ################################################################################
+ * #
+ * # PATENT NOTICE
+ * #
+ * # This software is distributed under the BSD 2-clause License (see LICENSE
+ * # file).  This BSD License does not make any patent claims and as such, does
+ * # not act as a patent grant.  The purpose of this section is for each contributor
+ * # to define their intentions with respect to intellectual property.
+ * #
+ * # Each contributor to this source code is encouraged to state their patent
+ * # claims and licensing mechanisms for any contributions made. At the end of
+ * # this section contributors may each make their own statements.  Contributor's
+ * # claims and grants only apply to the pieces (source code, programs, text,
+ * # media, etc) that they have contributed directly to this software.
+ * #
+ * # There is no guarantee that this section is complete, up to date or accurate. It
+ * # is up to the contributors to maintain their portion of this section and up to
+ * # the user of the software to verify any claims herein.
+ * #
+ * # Do not remove this header notification.  The contents of this section must be
+ * # present in all distributions of the software.  You may only modify your own
+ * # intellectual property statements.  Please provide contact information.
+ *
+ * - Palo Alto Research Center, Inc
+ * This software distribution does not grant any rights to patents owned by Palo
+ * Alto Research Center, Inc (PARC). Rights to these patents are available via
+ * various mechanisms. As of January 2016 PARC has committed to FRAND licensing any
+ * intellectual property used by its contributions to this software. You may
+ * contact PARC at cipo@parc.com for more information or visit http://www.ccnx.org
+ */
+/**
+ * @copyright (c) 2016, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC).  All rights reserved.
+ */
+#include <config.h>
+
+#include <errno.h>
+
+#include <LongBow/runtime.h>
+
+#include <parc/algol/parc_Object.h>
+#include <parc/algol/parc_Memory.h>
+
+#include <ccnx/api/ccnx_Portal/ccnx_PortalRetransmitter.h>
+
+/*
+ * Outstanding Interests are kept in a linear-probing table keyed by the hash of the Interest name,
+ * at most half full. A key of zero marks an empty slot, so every key has its low bit set.
+ */
+typedef struct {
+    uint64_t key;
+    CCNxMetaMessage *message;
+    const CCNxName *name;           // The name of the Interest in the message.
+    uint64_t sendTime;
+    uint64_t deadline;
+    unsigned int retransmissions;
+    bool ambiguous;                 // The response may answer more than one transmission, so its RTT is not measured.
+} _CCNxPortalRetransmitterEntry;
+
+struct CCNxPortalRetransmitter {
+    CCNxPortalRttEstimator *estimator;
+    unsigned int maxRetransmissions;
+
+    _CCNxPortalRetransmitterEntry *entries;
+    size_t slots;
+    size_t capacity;
+    size_t count;
+
+    // Never later than the earliest deadline. Only Expire makes it exact.
+    uint64_t nextDeadline;
+
+    uint64_t retransmissions;
+    uint64_t lost;
+    uint64_t untracked;
+};
+
+static void
+_ccnxPortalRetransmitter_Destroy(CCNxPortalRetransmitter **retransmitterPtr)
+{
+    CCNxPortalRetransmitter *retransmitter = *retransmitterPtr;
+
+    if (retransmitter->entries != NULL) {
+        for (size_t i = 0; i < retransmitter->slots; i++) {
+            if (retransmitter->entries[i].key != 0) {
+                ccnxMetaMessage_Release(&retransmitter->entries[i].message);
+            }
+        }
+        parcMemory_Deallocate(&retransmitter->entries);
+    }
+    if (retransmitter->estimator != NULL) {
+        ccnxPortalRttEstimator_Release(&retransmitter->estimator);
+    }
+}
+
+parcObject_ExtendPARCObject(CCNxPortalRetransmitter, _ccnxPortalRetransmitter_Destroy, NULL, NULL, NULL, NULL, NULL, NULL);
+
+parcObject_ImplementAcquire(ccnxPortalRetransmitter, CCNxPortalRetransmitter);
+
+parcObject_ImplementRelease(ccnxPortalRetransmitter, CCNxPortalRetransmitter);
+
+CCNxPortalRetransmitter *
+ccnxPortalRetransmitter_Create(CCNxPortalRttEstimator *estimator, unsigned int maxRetransmissions, size_t capacity)
+{
+    if (capacity == 0) {
+        errno = EINVAL;
+        return NULL;
+    }
+
+    CCNxPortalRetransmitter *result = parcObject_CreateInstance(CCNxPortalRetransmitter);
+    if (result == NULL) {
+        errno = ENOMEM;
+        return NULL;
+    }
+
+    result->estimator = ccnxPortalRttEstimator_Acquire(estimator);
+    result->maxRetransmissions = maxRetransmissions;
+    result->capacity = capacity;
+    result->count = 0;
+    result->nextDeadline = UINT64_MAX;
+    result->retransmissions = 0;
+    result->lost = 0;
+    result->untracked = 0;
+
+    result->slots = 2;
+    while (result->slots < 2 * capacity) {
+        result->slots *= 2;
+    }
+    result->entries = parcMemory_AllocateAndClear(result->slots * sizeof(_CCNxPortalRetransmitterEntry));
+    if (result->entries == NULL) {
+        ccnxPortalRetransmitter_Release(&result);
+        errno = ENOMEM;
+        return NULL;
+    }
+
+    return result;
+}
+
+static _CCNxPortalRetransmitterEntry *
+_ccnxPortalRetransmitter_Find(const CCNxPortalRetransmitter *retransmitter, const CCNxName *name, uint64_t key)
+{
+    size_t mask = retransmitter->slots - 1;
+    for (size_t i = key & mask; retransmitter->entries[i].key != 0; i = (i + 1) & mask) {
+        _CCNxPortalRetransmitterEntry *entry = &retransmitter->entries[i];
+        if (entry->key == key && ccnxName_Equals(entry->name, name)) {
+            return entry;
+        }
+    }
+    return NULL;
+}
+
+/*
+ * Remove an entry, shifting back the entries after it that were displaced past its slot,
+ * so that no probe sequence is broken and no tombstones are needed.
+ */
+static void
+_ccnxPortalRetransmitter_Remove(CCNxPortalRetransmitter *retransmitter, _CCNxPortalRetransmitterEntry *entry)
+{
+    _CCNxPortalRetransmitterEntry *entries = retransmitter->entries;
+    size_t mask = retransmitter->slots - 1;
+
+    ccnxMetaMessage_Release(&entry->message);
+
+    size_t hole = (size_t) (entry - entries);
+    for (size_t i = (hole + 1) & mask; entries[i].key != 0; i = (i + 1) & mask) {
+        size_t home = entries[i].key & mask;
+        if (((i - home) & mask) >= ((i - hole) & mask)) {
+            entries[hole] = entries[i];
+            hole = i;
+        }
+    }
+    entries[hole].key = 0;
+    entries[hole].message = NULL;
+    entries[hole].name = NULL;
+    retransmitter->count--;
+}
+
+bool
+ccnxPortalRetransmitter_Track(CCNxPortalRetransmitter *retransmitter, const CCNxMetaMessage *message, uint64_t now)
+{
+    // An Interest that is only wire format, such as one from a CCNxPortalInterestTemplate, has no decoded name to match.
+    const CCNxName *name = ccnxInterest_GetName(ccnxMetaMessage_GetInterest(message));
+    if (name == NULL) {
+        __atomic_fetch_add(&retransmitter->untracked, 1, __ATOMIC_RELAXED);
+        return false;
+    }
+    uint64_t key = ccnxName_HashCode(name) | 1;
+    uint64_t deadline = now + ccnxPortalRttEstimator_GetTimeout(retransmitter->estimator, name);
+
+    _CCNxPortalRetransmitterEntry *entry = _ccnxPortalRetransmitter_Find(retransmitter, name, key);
+    if (entry != NULL) {
+        // The application re-expressed an outstanding Interest.
+        ccnxMetaMessage_Release(&entry->message);
+        entry->ambiguous = true;
+    } else {
+        if (retransmitter->count == retransmitter->capacity) {
+            __atomic_fetch_add(&retransmitter->untracked, 1, __ATOMIC_RELAXED);
+            return false;
+        }
+
+        size_t mask = retransmitter->slots - 1;
+        size_t i = key & mask;
+        while (retransmitter->entries[i].key != 0) {
+            i = (i + 1) & mask;
+        }
+        entry = &retransmitter->entries[i];
+        entry->key = key;
+        entry->retransmissions = 0;
+        entry->ambiguous = false;
+        retransmitter->count++;
+    }
+
+    entry->message = ccnxMetaMessage_Acquire(message);
+    entry->name = ccnxInterest_GetName(ccnxMetaMessage_GetInterest(entry->message));
+    entry->sendTime = now;
+    entry->deadline = deadline;
+    if (deadline < retransmitter->nextDeadline) {
+        retransmitter->nextDeadline = deadline;
+    }
+    return true;
+}
+
+bool
+ccnxPortalRetransmitter_Match(CCNxPortalRetransmitter *retransmitter, const CCNxName *name, uint64_t now)
+{
+    _CCNxPortalRetransmitterEntry *entry = _ccnxPortalRetransmitter_Find(retransmitter, name, ccnxName_HashCode(name) | 1);
+    if (entry == NULL) {
+        return false;
+    }
+
+    if (entry->retransmissions == 0 && entry->ambiguous == false && now >= entry->sendTime) {
+        ccnxPortalRttEstimator_AddSample(retransmitter->estimator, name, now - entry->sendTime);
+    }
+    _ccnxPortalRetransmitter_Remove(retransmitter, entry);
+    return true;
+}
+
+bool
+ccnxPortalRetransmitter_Cancel(CCNxPortalRetransmitter *retransmitter, const CCNxName *name)
+{
+    _CCNxPortalRetransmitterEntry *entry = _ccnxPortalRetransmitter_Find(retransmitter, name, ccnxName_HashCode(name) | 1);
+    if (entry == NULL) {
+        return false;
+    }
+
+    _ccnxPortalRetransmitter_Remove(retransmitter, entry);
+    return true;
+}
+
+uint64_t
+ccnxPortalRetransmitter_GetNextDeadline(const CCNxPortalRetransmitter *retransmitter)
+{
+    return (retransmitter->count == 0) ? UINT64_MAX : retransmitter->nextDeadline;
+}
+
+size_t
+ccnxPortalRetransmitter_Expire(CCNxPortalRetransmitter *retransmitter, uint64_t now, CCNxMetaMessage **messages, size_t capacity)
+{
+    if (now < ccnxPortalRetransmitter_GetNextDeadline(retransmitter)) {
+        return 0;
+    }
+
+    size_t result = 0;
+    uint64_t nextDeadline = UINT64_MAX;
+
+    // A removal may shift a later entry into the current slot, so the slot is examined again.
+    size_t i = 0;
+    while (i < retransmitter->slots) {
+        _CCNxPortalRetransmitterEntry *entry = &retransmitter->entries[i];
+        if (entry->key != 0 && entry->deadline <= now) {
+            if (entry->retransmissions >= retransmitter->maxRetransmissions) {
+                ccnxPortalRttEstimator_Backoff(retransmitter->estimator, entry->name);
+                __atomic_fetch_add(&retransmitter->lost, 1, __ATOMIC_RELAXED);
+                _ccnxPortalRetransmitter_Remove(retransmitter, entry);
+                continue;
+            }
+            if (result < capacity) {
+                ccnxPortalRttEstimator_Backoff(retransmitter->estimator, entry->name);
+                entry->retransmissions++;
+                entry->sendTime = now;
+                entry->deadline = now + ccnxPortalRttEstimator_GetTimeout(retransmitter->estimator, entry->name);
+                messages[result++] = ccnxMetaMessage_Acquire(entry->message);
+                __atomic_fetch_add(&retransmitter->retransmissions, 1, __ATOMIC_RELAXED);
+            }
+        }
+        if (entry->key != 0 && entry->deadline < nextDeadline) {
+            nextDeadline = entry->deadline;
+        }
+        i++;
+    }
+
+    retransmitter->nextDeadline = nextDeadline;
+    return result;
+}
+
+size_t
+ccnxPortalRetransmitter_GetPending(const CCNxPortalRetransmitter *retransmitter)
+{
+    return retransmitter->count;
+}
+
+uint64_t
+ccnxPortalRetransmitter_GetRetransmissions(const CCNxPortalRetransmitter *retransmitter)
+{
+    return __atomic_load_n(&retransmitter->retransmissions, __ATOMIC_RELAXED);
+}
+
+uint64_t
+ccnxPortalRetransmitter_GetLost(const CCNxPortalRetransmitter *retransmitter)
+{
+    return __atomic_load_n(&retransmitter->lost, __ATOMIC_RELAXED);
+}
+
+uint64_t
+ccnxPortalRetransmitter_GetUntracked(const CCNxPortalRetransmitter *retransmitter)
+{
+    return __atomic_load_n(&retransmitter->untracked, __ATOMIC_RELAXED);
+}
+
+CCNxPortalRttEstimator *
+ccnxPortalRetransmitter_GetRttEstimator(const CCNxPortalRetransmitter *retransmitter)
+{
+    return retransmitter->estimator;
+}
@@ -0,0 +1,268 @@
+/*
+ * Copyright (c) 2016, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX OR PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ################################################################################
+ * #
+ * # PATENT NOTICE
+ * #
+ * # This software is distributed under the BSD 2-clause License (see LICENSE
+ * # file).  This BSD License does not make any patent claims and as such, does
+ * # not act as a patent grant.  The purpose of this section is for each contributor
+ * # to define their intentions with respect to intellectual property.
+ * #
+ * # Each contributor to this source code is encouraged to state their patent
+ * # claims and licensing mechanisms for any contributions made. At the end of
+ * # this section contributors may each make their own statements.  Contributor's
+ * # claims and grants only apply to the pieces (source code, programs, text,
+ * # media, etc) that they have contributed directly to this software.
+ * #
+ * # There is no guarantee that this section is complete, up to date or accurate. It
+ * # is up to the contributors to maintain their portion of this section and up to
+ * # the user of the software to verify any claims herein.
+ * #
+ * # Do not remove this header notification.  The contents of this section must be
+ * # present in all distributions of the software.  You may only modify your own
+ * # intellectual property statements.  Please provide contact information.
+ *
+ * - Palo Alto Research Center, Inc
+ * This software distribution does not grant any rights to patents owned by Palo
+ * Alto Research Center, Inc (PARC). Rights to these patents are available via
+ * various mechanisms. As of January 2016 PARC has committed to FRAND licensing any
+ * intellectual property used by its contributions to this software. You may
+ * contact PARC at cipo@parc.com for more information or visit http://www.ccnx.org
+ */
+/**
+ * @file ccnx_PortalRetransmitter.h
+ * @brief Re-express Interests that go unanswered within their retransmission timeout.
+ *
+ * A `CCNxPortalRetransmitter` tracks the Interests a Portal sends until a Content Object or Interest Return
+ * with the same name arrives. Each Interest has a deadline of its send time plus the RTO of its prefix,
+ * from a `CCNxPortalRttEstimator`. An Interest whose deadline passes is handed back to be sent again,
+ * after backing off its prefix's RTO, until it has been retransmitted the maximum number of times,
+ * when it is given up as lost.
+ *
+ * Answered Interests update their prefix's estimate with their round-trip time, unless they were retransmitted:
+ * a response to a retransmitted Interest could answer any of its transmissions (Karn's algorithm).
+ *
+ * A retransmitter is used by the thread that owns its Portal. Its counters and estimator may be read from any thread.
+ * Times are in microseconds.
+ *
+ * @copyright (c) 2016, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC).  All rights reserved.
+ */
+#ifndef CCNx_Portal_API_ccnx_PortalRetransmitter_h
+#define CCNx_Portal_API_ccnx_PortalRetransmitter_h
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <ccnx/api/ccnx_Portal/ccnx_PortalRttEstimator.h>
+
+#include <ccnx/common/ccnx_Name.h>
+#include <ccnx/transport/common/transport_MetaMessage.h>
+
+struct CCNxPortalRetransmitter;
+/**
+ * @typedef CCNxPortalRetransmitter
+ * @brief A set of outstanding Interests, with their retransmission deadlines.
+ */
+typedef struct CCNxPortalRetransmitter CCNxPortalRetransmitter;
+
+/**
+ * Create a new `CCNxPortalRetransmitter`.
+ *
+ * @param [in] estimator The estimator of the RTO of each Interest, which is acquired.
+ * @param [in] maxRetransmissions The number of times an Interest is retransmitted before it is given up as lost.
+ * @param [in] capacity The greatest number of Interests tracked at once.
+ *
+ * @return non-NULL A pointer to a valid `CCNxPortalRetransmitter` instance.
+ * @return NULL @p capacity is 0, and errno is set to EINVAL, or memory could not be allocated, and errno is set to ENOMEM.
+ *
+ * Example:
+ * @code
+ * {
+ *     CCNxPortalRttEstimator *estimator = ccnxPortalRttEstimator_Create(0);
+ *     CCNxPortalRetransmitter *retransmitter = ccnxPortalRetransmitter_Create(estimator, 3, 1024);
+ *     ccnxPortalRttEstimator_Release(&estimator);
+ *
+ *     ccnxPortalRetransmitter_Release(&retransmitter);
+ * }
+ * @endcode
+ */
+CCNxPortalRetransmitter *ccnxPortalRetransmitter_Create(CCNxPortalRttEstimator *estimator, unsigned int maxRetransmissions, size_t capacity);
+
+/**
+ * Increase the number of references to a `CCNxPortalRetransmitter` instance.
+ *
+ * @param [in] retransmitter A pointer to a valid `CCNxPortalRetransmitter` instance.
+ *
+ * @return The same value as @p retransmitter.
+ */
+CCNxPortalRetransmitter *ccnxPortalRetransmitter_Acquire(const CCNxPortalRetransmitter *retransmitter);
+
+/**
+ * Release a previously acquired reference to the specified instance,
+ * decrementing the reference count for the instance.
+ *
+ * The pointer to the instance is set to NULL as a side-effect of this function.
+ *
+ * @param [in,out] retransmitterPtr A pointer to a pointer to the instance to release.
+ */
+void ccnxPortalRetransmitter_Release(CCNxPortalRetransmitter **retransmitterPtr);
+
+/**
+ * Track an Interest that has just been sent.
+ *
+ * Tracking an Interest with the same name as one already tracked replaces it,
+ * and its round-trip time is not measured, since the response may answer either.
+ *
+ * @param [in,out] retransmitter A pointer to a valid `CCNxPortalRetransmitter` instance.
+ * @param [in] message A `CCNxMetaMessage` containing an Interest, which is acquired.
+ * @param [in] now The time the Interest was sent.
+ *
+ * An Interest without a decoded name, such as the wire-format message of a `CCNxPortalInterestTemplate`,
+ * cannot be matched with its response, so it is not tracked.
+ *
+ * @return true The Interest is tracked.
+ * @return false The retransmitter is full or the Interest has no decoded name, and the Interest will not be retransmitted.
+ */
+bool ccnxPortalRetransmitter_Track(CCNxPortalRetransmitter *retransmitter, const CCNxMetaMessage *message, uint64_t now);
+
+/**
+ * Stop tracking the Interest answered by a Content Object with the given name,
+ * measuring its round-trip time if it was not retransmitted.
+ *
+ * @param [in,out] retransmitter A pointer to a valid `CCNxPortalRetransmitter` instance.
+ * @param [in] name The name of the Content Object.
+ * @param [in] now The time the Content Object was received.
+ *
+ * @return true An Interest with the name was tracked.
+ * @return false No Interest with the name was tracked.
+ */
+bool ccnxPortalRetransmitter_Match(CCNxPortalRetransmitter *retransmitter, const CCNxName *name, uint64_t now);
+
+/**
+ * Stop tracking an Interest without measuring its round-trip time, as when an Interest Return for it is received.
+ *
+ * @param [in,out] retransmitter A pointer to a valid `CCNxPortalRetransmitter` instance.
+ * @param [in] name The name of the Interest.
+ *
+ * @return true An Interest with the name was tracked.
+ * @return false No Interest with the name was tracked.
+ */
+bool ccnxPortalRetransmitter_Cancel(CCNxPortalRetransmitter *retransmitter, const CCNxName *name);
+
+/**
+ * Get the time by which `ccnxPortalRetransmitter_Expire` must next be called.
+ *
+ * This may be earlier than the earliest deadline, but never later.
+ *
+ * @param [in] retransmitter A pointer to a valid `CCNxPortalRetransmitter` instance.
+ *
+ * @return The time, or UINT64_MAX if no Interest is tracked.
+ */
+uint64_t ccnxPortalRetransmitter_GetNextDeadline(const CCNxPortalRetransmitter *retransmitter);
+
+/**
+ * Collect the Interests whose deadlines have passed, to be sent again.
+ *
+ * The RTO of the prefix of each expired Interest is backed off, and the Interest is given a new deadline.
+ * Interests that have been retransmitted the maximum number of times are given up as lost instead.
+ * If more than @p capacity Interests have expired, the rest are left for the next call.
+ *
+ * @param [in,out] retransmitter A pointer to a valid `CCNxPortalRetransmitter` instance.
+ * @param [in] now The current time.
+ * @param [out] messages The Interests to send again, each of which must be released by the caller.
+ * @param [in] capacity The number of elements in @p messages.
+ *
+ * @return The number of Interests stored in @p messages.
+ *
+ * Example:
+ * @code
+ * {
+ *     CCNxMetaMessage *messages[16];
+ *     size_t count = ccnxPortalRetransmitter_Expire(retransmitter, now, messages, 16);
+ *     for (size_t i = 0; i < count; i++) {
+ *         ccnxPortal_Send(portal, messages[i], CCNxStackTimeout_Never);
+ *         ccnxMetaMessage_Release(&messages[i]);
+ *     }
+ * }
+ * @endcode
+ */
+size_t ccnxPortalRetransmitter_Expire(CCNxPortalRetransmitter *retransmitter, uint64_t now, CCNxMetaMessage **messages, size_t capacity);
+
+/**
+ * Get the number of Interests tracked.
+ *
+ * @param [in] retransmitter A pointer to a valid `CCNxPortalRetransmitter` instance.
+ *
+ * @return The number of Interests awaiting a response.
+ */
+size_t ccnxPortalRetransmitter_GetPending(const CCNxPortalRetransmitter *retransmitter);
+
+/**
+ * Get the number of retransmissions.
+ *
+ * @param [in] retransmitter A pointer to a valid `CCNxPortalRetransmitter` instance.
+ *
+ * @return The number of Interests handed back by `ccnxPortalRetransmitter_Expire`.
+ */
+uint64_t ccnxPortalRetransmitter_GetRetransmissions(const CCNxPortalRetransmitter *retransmitter);
+
+/**
+ * Get the number of Interests given up as lost.
+ *
+ * @param [in] retransmitter A pointer to a valid `CCNxPortalRetransmitter` instance.
+ *
+ * @return The number of Interests that went unanswered after the maximum number of retransmissions.
+ */
+uint64_t ccnxPortalRetransmitter_GetLost(const CCNxPortalRetransmitter *retransmitter);
+
+/**
+ * Get the number of Interests that could not be tracked, because the retransmitter was full or they had no decoded name.
+ *
+ * @param [in] retransmitter A pointer to a valid `CCNxPortalRetransmitter` instance.
+ *
+ * @return The number of untracked Interests.
+ */
+uint64_t ccnxPortalRetransmitter_GetUntracked(const CCNxPortalRetransmitter *retransmitter);
+
+/**
+ * Get the estimator of the RTO of each Interest.
+ *
+ * @param [in] retransmitter A pointer to a valid `CCNxPortalRetransmitter` instance.
+ *
+ * @return The estimator, which is not acquired.
+ *
+ * Example:
+ * @code
+ * {
+ *     PARCJSON *json = ccnxPortalRttEstimator_ToJSON(ccnxPortalRetransmitter_GetRttEstimator(retransmitter));
+ *
+ *     parcJSON_Release(&json);
+ * }
+ * @endcode
+ */
+CCNxPortalRttEstimator *ccnxPortalRetransmitter_GetRttEstimator(const CCNxPortalRetransmitter *retransmitter);
+#endif // CCNx_Portal_API_ccnx_PortalRetransmitter_h
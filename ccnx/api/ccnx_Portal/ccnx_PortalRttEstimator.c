@@ -0,0 +1,534 @@
+/*
+ * Copyright (c) 2016, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX OR PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ################################################################################
+ * #
+ * # PATENT NOTICE
+ * #
+ * # This software is distributed under the BSD 2-clause License (see LICENSE
+ * # file).  This BSD License does not make any patent claims and as such, does
+ * # not act as a patent grant.  The purpose of this section is for each contributor
+ * # to define their intentions with respect to intellectual property.
+ * #
+ * # Each contributor to this source code is encouraged to state their patent
+ * # claims and licensing mechanisms for any contributions made. At the end of
+ * # this section contributors may each make their own statements.  Contributor's
+ * # claims and grants only apply to the pieces (source code, programs, text,
+ * # media, etc) that they have contributed directly to this software.
+ * #
+ * # There is no guarantee that this section is complete, up to date or accurate. It
+ * # is up to the contributors to maintain their portion of this section and up to
+ * # the user of the software to verify any claims herein.
+ * #
+ * # Do not remove this header notification.  The contents of this section must be
+ * # present in all distributions of the software.  You may only modify your own
+ * # intellectual property statements.  Please provide contact information.
+ *
+ * - Palo Alto Research Center, Inc
+ * This software distribution does not grant any rights to patents owned by Palo
+ * Alto Research Center, Inc (PARC). Rights to these patents are available via
+ * various mechanisms. As of January 2016 PARC has committed to FRAND licensing any
+ * intellectual property used by its contributions to this software. You may
+ * contact PARC at cipo@parc.com for more information or visit http://www.ccnx.org
+ */
+/**
+ * @copyright (c) 2016, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC).  All rights reserved.
+ */
+#include <config.h>
+
+#include <errno.h>
+#include <pthread.h>
+#include <stdint.h>
+
+#include <LongBow/runtime.h>
+
+#include <parc/algol/parc_Object.h>
+#include <parc/algol/parc_Memory.h>
+
+#include <ccnx/api/ccnx_Portal/ccnx_PortalRttEstimator.h>
+
+/*
+ * Prefixes are kept in an open-addressed table keyed by the hash of their segments.
+ * A key of zero marks an empty slot, so every key has its low bit set.
+ * The entries are also linked, by slot, from the least to the most recently used,
+ * and once the table holds the maximum number of prefixes, adding one removes the least recently used.
+ */
+#define _initialSlots 16
+#define _none SIZE_MAX
+
+typedef struct {
+    uint64_t key;
+    CCNxName *prefix;
+    CCNxPortalRttEstimate estimate;
+    size_t older;
+    size_t newer;
+} _CCNxPortalRttEntry;
+
+struct CCNxPortalRttEstimator {
+    pthread_mutex_t lock;
+    size_t prefixSegments;
+
+    uint64_t initialTimeout;
+    uint64_t minimumTimeout;
+    uint64_t maximumTimeout;
+
+    _CCNxPortalRttEntry *entries;
+    size_t capacity;
+    size_t count;
+    size_t maxPrefixes;
+
+    size_t oldest;
+    size_t newest;
+    uint64_t evictions;
+};
+
+static void
+_ccnxPortalRttEstimator_Destroy(CCNxPortalRttEstimator **estimatorPtr)
+{
+    CCNxPortalRttEstimator *estimator = *estimatorPtr;
+
+    if (estimator->entries != NULL) {
+        for (size_t i = 0; i < estimator->capacity; i++) {
+            if (estimator->entries[i].key != 0) {
+                ccnxName_Release(&estimator->entries[i].prefix);
+            }
+        }
+        parcMemory_Deallocate(&estimator->entries);
+    }
+    pthread_mutex_destroy(&estimator->lock);
+}
+
+parcObject_ExtendPARCObject(CCNxPortalRttEstimator, _ccnxPortalRttEstimator_Destroy, NULL, NULL, NULL, NULL, NULL, NULL);
+
+parcObject_ImplementAcquire(ccnxPortalRttEstimator, CCNxPortalRttEstimator);
+
+parcObject_ImplementRelease(ccnxPortalRttEstimator, CCNxPortalRttEstimator);
+
+CCNxPortalRttEstimator *
+ccnxPortalRttEstimator_Create(size_t prefixSegments)
+{
+    CCNxPortalRttEstimator *result = parcObject_CreateInstance(CCNxPortalRttEstimator);
+    if (result == NULL) {
+        errno = ENOMEM;
+        return NULL;
+    }
+
+    pthread_mutex_init(&result->lock, NULL);
+    result->prefixSegments = prefixSegments;
+    result->initialTimeout = CCNxPortalRttEstimator_DefaultInitialTimeout;
+    result->minimumTimeout = CCNxPortalRttEstimator_DefaultMinimumTimeout;
+    result->maximumTimeout = CCNxPortalRttEstimator_DefaultMaximumTimeout;
+    result->capacity = _initialSlots;
+    result->count = 0;
+    result->maxPrefixes = CCNxPortalRttEstimator_DefaultMaxPrefixes;
+    result->oldest = _none;
+    result->newest = _none;
+    result->evictions = 0;
+    result->entries = parcMemory_AllocateAndClear(_initialSlots * sizeof(_CCNxPortalRttEntry));
+    if (result->entries == NULL) {
+        ccnxPortalRttEstimator_Release(&result);
+        errno = ENOMEM;
+        return NULL;
+    }
+
+    return result;
+}
+
+bool
+ccnxPortalRttEstimator_SetBounds(CCNxPortalRttEstimator *estimator, uint64_t initial, uint64_t minimum, uint64_t maximum)
+{
+    if (minimum == 0 || initial < minimum || initial > maximum) {
+        errno = EINVAL;
+        return false;
+    }
+
+    pthread_mutex_lock(&estimator->lock);
+    estimator->initialTimeout = initial;
+    estimator->minimumTimeout = minimum;
+    estimator->maximumTimeout = maximum;
+    pthread_mutex_unlock(&estimator->lock);
+    return true;
+}
+
+static size_t
+_ccnxPortalRttEstimator_PrefixLength(const CCNxPortalRttEstimator *estimator, const CCNxName *name)
+{
+    size_t segments = ccnxName_GetSegmentCount(name);
+    if (estimator->prefixSegments == 0) {
+        return (segments > 1) ? segments - 1 : segments;
+    }
+    return (estimator->prefixSegments < segments) ? estimator->prefixSegments : segments;
+}
+
+// An FNV-1a combination of the hash codes of the first prefixLength segments of the name.
+static uint64_t
+_ccnxPortalRttEstimator_Key(const CCNxName *name, size_t prefixLength)
+{
+    uint64_t result = 14695981039346656037ULL;
+    for (size_t i = 0; i < prefixLength; i++) {
+        result ^= ccnxNameSegment_HashCode(ccnxName_GetSegment(name, i));
+        result *= 1099511628211ULL;
+    }
+    return result | 1;
+}
+
+static _CCNxPortalRttEntry *
+_ccnxPortalRttEstimator_Find(const CCNxPortalRttEstimator *estimator, const CCNxName *name, size_t prefixLength, uint64_t key)
+{
+    size_t mask = estimator->capacity - 1;
+    for (size_t i = key & mask; estimator->entries[i].key != 0; i = (i + 1) & mask) {
+        _CCNxPortalRttEntry *entry = &estimator->entries[i];
+        if (entry->key == key
+            && ccnxName_GetSegmentCount(entry->prefix) == prefixLength
+            && ccnxName_StartsWith(name, entry->prefix)) {
+            return entry;
+        }
+    }
+    return NULL;
+}
+
+static size_t
+_ccnxPortalRttEstimator_Insert(_CCNxPortalRttEntry *entries, size_t capacity, uint64_t key)
+{
+    size_t mask = capacity - 1;
+    size_t i = key & mask;
+    while (entries[i].key != 0) {
+        i = (i + 1) & mask;
+    }
+    entries[i].key = key;
+    return i;
+}
+
+static void
+_ccnxPortalRttEstimator_Unlink(CCNxPortalRttEstimator *estimator, size_t slot)
+{
+    _CCNxPortalRttEntry *entry = &estimator->entries[slot];
+
+    if (entry->older == _none) {
+        estimator->oldest = entry->newer;
+    } else {
+        estimator->entries[entry->older].newer = entry->newer;
+    }
+    if (entry->newer == _none) {
+        estimator->newest = entry->older;
+    } else {
+        estimator->entries[entry->newer].older = entry->older;
+    }
+}
+
+static void
+_ccnxPortalRttEstimator_LinkNewest(CCNxPortalRttEstimator *estimator, size_t slot)
+{
+    _CCNxPortalRttEntry *entry = &estimator->entries[slot];
+
+    entry->older = estimator->newest;
+    entry->newer = _none;
+    if (estimator->newest == _none) {
+        estimator->oldest = slot;
+    } else {
+        estimator->entries[estimator->newest].newer = slot;
+    }
+    estimator->newest = slot;
+}
+
+// Mark the entry in the given slot as the most recently used.
+static void
+_ccnxPortalRttEstimator_Touch(CCNxPortalRttEstimator *estimator, size_t slot)
+{
+    if (estimator->newest != slot) {
+        _ccnxPortalRttEstimator_Unlink(estimator, slot);
+        _ccnxPortalRttEstimator_LinkNewest(estimator, slot);
+    }
+}
+
+/*
+ * Remove the entry in the given slot, moving back any entry of the same probe sequence
+ * that the empty slot would otherwise hide from _ccnxPortalRttEstimator_Find.
+ */
+static void
+_ccnxPortalRttEstimator_Remove(CCNxPortalRttEstimator *estimator, size_t slot)
+{
+    size_t mask = estimator->capacity - 1;
+    _CCNxPortalRttEntry *entries = estimator->entries;
+
+    _ccnxPortalRttEstimator_Unlink(estimator, slot);
+    ccnxName_Release(&entries[slot].prefix);
+    entries[slot].key = 0;
+    estimator->count--;
+
+    for (size_t next = (slot + 1) & mask; entries[next].key != 0; next = (next + 1) & mask) {
+        size_t home = entries[next].key & mask;
+        bool reachable = (slot < next) ? (slot < home && home <= next) : (slot < home || home <= next);
+        if (!reachable) {
+            entries[slot] = entries[next];
+            entries[next].key = 0;
+
+            // Relink the moved entry at its new slot.
+            if (entries[slot].older == _none) {
+                estimator->oldest = slot;
+            } else {
+                entries[entries[slot].older].newer = slot;
+            }
+            if (entries[slot].newer == _none) {
+                estimator->newest = slot;
+            } else {
+                entries[entries[slot].newer].older = slot;
+            }
+            slot = next;
+        }
+    }
+}
+
+static void
+_ccnxPortalRttEstimator_Evict(CCNxPortalRttEstimator *estimator, size_t maxPrefixes)
+{
+    while (estimator->count > maxPrefixes) {
+        _ccnxPortalRttEstimator_Remove(estimator, estimator->oldest);
+        estimator->evictions++;
+    }
+}
+
+static bool
+_ccnxPortalRttEstimator_Grow(CCNxPortalRttEstimator *estimator)
+{
+    size_t capacity = estimator->capacity * 2;
+    _CCNxPortalRttEntry *entries = parcMemory_AllocateAndClear(capacity * sizeof(_CCNxPortalRttEntry));
+    if (entries == NULL) {
+        return false;
+    }
+
+    // Reinsert from the least to the most recently used, so that the new links keep the same order.
+    _CCNxPortalRttEntry *previous = estimator->entries;
+    size_t slot = estimator->oldest;
+    estimator->entries = entries;
+    estimator->capacity = capacity;
+    estimator->oldest = _none;
+    estimator->newest = _none;
+
+    while (slot != _none) {
+        size_t newer = previous[slot].newer;
+        size_t moved = _ccnxPortalRttEstimator_Insert(entries, capacity, previous[slot].key);
+        entries[moved].prefix = previous[slot].prefix;
+        entries[moved].estimate = previous[slot].estimate;
+        _ccnxPortalRttEstimator_LinkNewest(estimator, moved);
+        slot = newer;
+    }
+    parcMemory_Deallocate(&previous);
+    return true;
+}
+
+/*
+ * Find the entry of the name's prefix, adding it if it is new, and mark it as the most recently used.
+ * Returns NULL if memory could not be allocated, in which case the caller drops the update.
+ */
+static _CCNxPortalRttEntry *
+_ccnxPortalRttEstimator_FindOrAdd(CCNxPortalRttEstimator *estimator, const CCNxName *name)
+{
+    size_t prefixLength = _ccnxPortalRttEstimator_PrefixLength(estimator, name);
+    uint64_t key = _ccnxPortalRttEstimator_Key(name, prefixLength);
+
+    _CCNxPortalRttEntry *result = _ccnxPortalRttEstimator_Find(estimator, name, prefixLength, key);
+    if (result != NULL) {
+        _ccnxPortalRttEstimator_Touch(estimator, (size_t) (result - estimator->entries));
+        return result;
+    }
+
+    CCNxName *prefix = ccnxName_Copy(name);
+    if (prefix == NULL) {
+        return NULL;
+    }
+    ccnxName_Trim(prefix, ccnxName_GetSegmentCount(name) - prefixLength);
+
+    _ccnxPortalRttEstimator_Evict(estimator, estimator->maxPrefixes - 1);
+    if ((estimator->count + 1) * 2 > estimator->capacity && _ccnxPortalRttEstimator_Grow(estimator) == false) {
+        ccnxName_Release(&prefix);
+        return NULL;
+    }
+
+    size_t slot = _ccnxPortalRttEstimator_Insert(estimator->entries, estimator->capacity, key);
+    result = &estimator->entries[slot];
+    result->prefix = prefix;
+    result->estimate = (CCNxPortalRttEstimate) {
+        .retransmissionTimeout = estimator->initialTimeout
+    };
+    _ccnxPortalRttEstimator_LinkNewest(estimator, slot);
+    estimator->count++;
+
+    return result;
+}
+
+static uint64_t
+_ccnxPortalRttEstimator_Clamp(const CCNxPortalRttEstimator *estimator, uint64_t timeout)
+{
+    if (timeout < estimator->minimumTimeout) {
+        return estimator->minimumTimeout;
+    }
+    if (timeout > estimator->maximumTimeout) {
+        return estimator->maximumTimeout;
+    }
+    return timeout;
+}
+
+uint64_t
+ccnxPortalRttEstimator_GetTimeout(const CCNxPortalRttEstimator *estimator, const CCNxName *name)
+{
+    CCNxPortalRttEstimator *mutable = (CCNxPortalRttEstimator *) estimator;
+
+    size_t prefixLength = _ccnxPortalRttEstimator_PrefixLength(estimator, name);
+    uint64_t key = _ccnxPortalRttEstimator_Key(name, prefixLength);
+
+    pthread_mutex_lock(&mutable->lock);
+    _CCNxPortalRttEntry *entry = _ccnxPortalRttEstimator_Find(estimator, name, prefixLength, key);
+    uint64_t result = estimator->initialTimeout;
+    if (entry != NULL) {
+        result = entry->estimate.retransmissionTimeout;
+        _ccnxPortalRttEstimator_Touch(mutable, (size_t) (entry - estimator->entries));
+    }
+    pthread_mutex_unlock(&mutable->lock);
+
+    return result;
+}
+
+void
+ccnxPortalRttEstimator_AddSample(CCNxPortalRttEstimator *estimator, const CCNxName *name, uint64_t rtt)
+{
+    pthread_mutex_lock(&estimator->lock);
+    _CCNxPortalRttEntry *entry = _ccnxPortalRttEstimator_FindOrAdd(estimator, name);
+    if (entry != NULL) {
+        CCNxPortalRttEstimate *estimate = &entry->estimate;
+        if (estimate->samples == 0) {
+            estimate->smoothedRtt = rtt;
+            estimate->rttVariation = rtt / 2;
+        } else {
+            uint64_t deviation = (estimate->smoothedRtt > rtt) ? estimate->smoothedRtt - rtt : rtt - estimate->smoothedRtt;
+            estimate->rttVariation = (3 * estimate->rttVariation + deviation) / 4;
+            estimate->smoothedRtt = (7 * estimate->smoothedRtt + rtt) / 8;
+        }
+        estimate->samples++;
+
+        // Recomputing the RTO from the new estimate also undoes any backoff.
+        estimate->retransmissionTimeout =
+            _ccnxPortalRttEstimator_Clamp(estimator, estimate->smoothedRtt + 4 * estimate->rttVariation);
+    }
+    pthread_mutex_unlock(&estimator->lock);
+}
+
+void
+ccnxPortalRttEstimator_Backoff(CCNxPortalRttEstimator *estimator, const CCNxName *name)
+{
+    pthread_mutex_lock(&estimator->lock);
+    _CCNxPortalRttEntry *entry = _ccnxPortalRttEstimator_FindOrAdd(estimator, name);
+    if (entry != NULL) {
+        CCNxPortalRttEstimate *estimate = &entry->estimate;
+        estimate->retransmissionTimeout = _ccnxPortalRttEstimator_Clamp(estimator, 2 * estimate->retransmissionTimeout);
+        estimate->timeouts++;
+    }
+    pthread_mutex_unlock(&estimator->lock);
+}
+
+bool
+ccnxPortalRttEstimator_GetEstimate(const CCNxPortalRttEstimator *estimator, const CCNxName *name, CCNxPortalRttEstimate *estimate)
+{
+    CCNxPortalRttEstimator *mutable = (CCNxPortalRttEstimator *) estimator;
+
+    size_t prefixLength = _ccnxPortalRttEstimator_PrefixLength(estimator, name);
+    uint64_t key = _ccnxPortalRttEstimator_Key(name, prefixLength);
+
+    pthread_mutex_lock(&mutable->lock);
+    _CCNxPortalRttEntry *entry = _ccnxPortalRttEstimator_Find(estimator, name, prefixLength, key);
+    if (entry != NULL) {
+        *estimate = entry->estimate;
+    }
+    pthread_mutex_unlock(&mutable->lock);
+
+    return entry != NULL;
+}
+
+size_t
+ccnxPortalRttEstimator_GetCount(const CCNxPortalRttEstimator *estimator)
+{
+    CCNxPortalRttEstimator *mutable = (CCNxPortalRttEstimator *) estimator;
+
+    pthread_mutex_lock(&mutable->lock);
+    size_t result = estimator->count;
+    pthread_mutex_unlock(&mutable->lock);
+
+    return result;
+}
+
+bool
+ccnxPortalRttEstimator_SetMaxPrefixes(CCNxPortalRttEstimator *estimator, size_t maxPrefixes)
+{
+    if (maxPrefixes == 0) {
+        errno = EINVAL;
+        return false;
+    }
+
+    pthread_mutex_lock(&estimator->lock);
+    estimator->maxPrefixes = maxPrefixes;
+    _ccnxPortalRttEstimator_Evict(estimator, maxPrefixes);
+    pthread_mutex_unlock(&estimator->lock);
+    return true;
+}
+
+uint64_t
+ccnxPortalRttEstimator_GetEvictions(const CCNxPortalRttEstimator *estimator)
+{
+    CCNxPortalRttEstimator *mutable = (CCNxPortalRttEstimator *) estimator;
+
+    pthread_mutex_lock(&mutable->lock);
+    uint64_t result = estimator->evictions;
+    pthread_mutex_unlock(&mutable->lock);
+
+    return result;
+}
+
+PARCJSON *
+ccnxPortalRttEstimator_ToJSON(const CCNxPortalRttEstimator *estimator)
+{
+    CCNxPortalRttEstimator *mutable = (CCNxPortalRttEstimator *) estimator;
+
+    PARCJSON *result = parcJSON_Create();
+
+    pthread_mutex_lock(&mutable->lock);
+    for (size_t i = 0; i < estimator->capacity; i++) {
+        const _CCNxPortalRttEntry *entry = &estimator->entries[i];
+        if (entry->key != 0) {
+            PARCJSON *json = parcJSON_Create();
+            parcJSON_AddInteger(json, "srtt", (int64_t) entry->estimate.smoothedRtt);
+            parcJSON_AddInteger(json, "rttvar", (int64_t) entry->estimate.rttVariation);
+            parcJSON_AddInteger(json, "rto", (int64_t) entry->estimate.retransmissionTimeout);
+            parcJSON_AddInteger(json, "samples", (int64_t) entry->estimate.samples);
+            parcJSON_AddInteger(json, "timeouts", (int64_t) entry->estimate.timeouts);
+
+            char *uri = ccnxName_ToString(entry->prefix);
+            parcJSON_AddObject(result, uri, json);
+            parcMemory_Deallocate(&uri);
+            parcJSON_Release(&json);
+        }
+    }
+    pthread_mutex_unlock(&mutable->lock);
+
+    return result;
+}
@@ -0,0 +1,304 @@
+/*
+ * Copyright (c) 2016, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX OR PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ################################################################################
+ * #
+ * # PATENT NOTICE
+ * #
+ * # This software is distributed under the BSD 2-clause License (see LICENSE
+ * # file).  This BSD License does not make any patent claims and as such, does
+ * # not act as a patent grant.  The purpose of this section is for each contributor
+ * # to define their intentions with respect to intellectual property.
+ * #
+ * # Each contributor to this source code is encouraged to state their patent
+ * # claims and licensing mechanisms for any contributions made. At the end of
+ * # this section contributors may each make their own statements.  Contributor's
+ * # claims and grants only apply to the pieces (source code, programs, text,
+ * # media, etc) that they have contributed directly to this software.
+ * #
+ * # There is no guarantee that this section is complete, up to date or accurate. It
+ * # is up to the contributors to maintain their portion of this section and up to
+ * # the user of the software to verify any claims herein.
+ * #
+ * # Do not remove this header notification.  The contents of this section must be
+ * # present in all distributions of the software.  You may only modify your own
+ * # intellectual property statements.  Please provide contact information.
+ *
+ * - Palo Alto Research Center, Inc
+ * This software distribution does not grant any rights to patents owned by Palo
+ * Alto Research Center, Inc (PARC). Rights to these patents are available via
+ * various mechanisms. As of January 2016 PARC has committed to FRAND licensing any
+ * intellectual property used by its contributions to this software. You may
+ * contact PARC at cipo@parc.com for more information or visit http://www.ccnx.org
+ */
+/**
+ * @file ccnx_PortalRttEstimator.h
+ * @brief Per-prefix round-trip time estimates, and the retransmission timeouts derived from them.
+ *
+ * Each name prefix has its own estimator, computed as TCP computes its retransmission timer (RFC 6298):
+ * a smoothed round-trip time (SRTT) and round-trip time variation (RTTVAR), updated with gains of 1/8 and 1/4,
+ * and a retransmission timeout (RTO) of SRTT + 4 * RTTVAR, clamped to configurable bounds.
+ * Each timeout doubles a prefix's RTO, up to the maximum, until the next sample recomputes it.
+ *
+ * The prefix of a name is its first `prefixSegments` segments, or by default every segment but the last,
+ * so that the chunks of one object share an estimate.
+ * Prefixes are found by hashing their segments, without allocating, once a prefix has been seen.
+ * An estimator keeps at most a maximum number of prefixes; adding one more forgets the least recently used,
+ * which then starts again from the initial RTO if it is seen again.
+ *
+ * Times are in microseconds, the unit of `CCNxStackTimeout`.
+ *
+ * An estimator is thread-safe, so that it can be read for monitoring while a Portal updates it.
+ *
+ * @copyright (c) 2016, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC).  All rights reserved.
+ */
+#ifndef CCNx_Portal_API_ccnx_PortalRttEstimator_h
+#define CCNx_Portal_API_ccnx_PortalRttEstimator_h
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <parc/algol/parc_JSON.h>
+
+#include <ccnx/common/ccnx_Name.h>
+
+struct CCNxPortalRttEstimator;
+/**
+ * @typedef CCNxPortalRttEstimator
+ * @brief A table of round-trip time estimators by name prefix.
+ */
+typedef struct CCNxPortalRttEstimator CCNxPortalRttEstimator;
+
+/**
+ * @typedef CCNxPortalRttEstimate
+ * @brief The state of one prefix's estimator. Times are in microseconds.
+ */
+typedef struct {
+    uint64_t smoothedRtt;            /**< SRTT, or 0 before the first sample */
+    uint64_t rttVariation;           /**< RTTVAR, or 0 before the first sample */
+    uint64_t retransmissionTimeout;  /**< RTO, including any backoff */
+    uint64_t samples;                /**< The number of round-trip times measured */
+    uint64_t timeouts;               /**< The number of Interests that went unanswered within the RTO */
+} CCNxPortalRttEstimate;
+
+/**
+ * The RTO of a prefix before its first sample, in microseconds, as recommended by RFC 6298.
+ */
+#define CCNxPortalRttEstimator_DefaultInitialTimeout 1000000
+
+/**
+ * The least RTO, in microseconds. RFC 6298 recommends a second, which is far longer than most CCN round trips,
+ * so this is the 200 milliseconds common in CCN and NDN consumers.
+ */
+#define CCNxPortalRttEstimator_DefaultMinimumTimeout 200000
+
+/**
+ * The greatest RTO, in microseconds, including backoff.
+ */
+#define CCNxPortalRttEstimator_DefaultMaximumTimeout 60000000
+
+/**
+ * The most prefixes an estimator keeps by default.
+ */
+#define CCNxPortalRttEstimator_DefaultMaxPrefixes 1024
+
+/**
+ * Create a new, empty `CCNxPortalRttEstimator`.
+ *
+ * @param [in] prefixSegments The number of leading name segments that identify a prefix,
+ *                            or 0 for every segment but the last.
+ *
+ * @return non-NULL A pointer to a valid `CCNxPortalRttEstimator` instance.
+ * @return NULL Memory could not be allocated, and errno is set to ENOMEM.
+ *
+ * Example:
+ * @code
+ * {
+ *     CCNxPortalRttEstimator *estimator = ccnxPortalRttEstimator_Create(0);
+ *
+ *     ccnxPortalRttEstimator_Release(&estimator);
+ * }
+ * @endcode
+ */
+CCNxPortalRttEstimator *ccnxPortalRttEstimator_Create(size_t prefixSegments);
+
+/**
+ * Increase the number of references to a `CCNxPortalRttEstimator` instance.
+ *
+ * @param [in] estimator A pointer to a valid `CCNxPortalRttEstimator` instance.
+ *
+ * @return The same value as @p estimator.
+ */
+CCNxPortalRttEstimator *ccnxPortalRttEstimator_Acquire(const CCNxPortalRttEstimator *estimator);
+
+/**
+ * Release a previously acquired reference to the specified instance,
+ * decrementing the reference count for the instance.
+ *
+ * The pointer to the instance is set to NULL as a side-effect of this function.
+ *
+ * @param [in,out] estimatorPtr A pointer to a pointer to the instance to release.
+ */
+void ccnxPortalRttEstimator_Release(CCNxPortalRttEstimator **estimatorPtr);
+
+/**
+ * Set the RTO of new prefixes, and the bounds of every prefix's RTO, in microseconds.
+ *
+ * @param [in,out] estimator A pointer to a valid `CCNxPortalRttEstimator` instance.
+ * @param [in] initial The RTO of a prefix before its first sample.
+ * @param [in] minimum The least RTO.
+ * @param [in] maximum The greatest RTO.
+ *
+ * @return true The bounds were set.
+ * @return false The bounds are inconsistent, @p minimum being 0 or @p initial not between @p minimum and @p maximum,
+ *               and errno is set to EINVAL.
+ *
+ * Example:
+ * @code
+ * {
+ *     // A data centre network, where round trips take tens of microseconds.
+ *     ccnxPortalRttEstimator_SetBounds(estimator, 100000, 1000, 1000000);
+ * }
+ * @endcode
+ */
+bool ccnxPortalRttEstimator_SetBounds(CCNxPortalRttEstimator *estimator, uint64_t initial, uint64_t minimum, uint64_t maximum);
+
+/**
+ * Set the most prefixes the estimator keeps, forgetting the least recently used beyond it.
+ *
+ * A prefix is used when its RTO is read, a sample is added, or it backs off.
+ *
+ * @param [in,out] estimator A pointer to a valid `CCNxPortalRttEstimator` instance.
+ * @param [in] maxPrefixes The most prefixes to keep. The default is `CCNxPortalRttEstimator_DefaultMaxPrefixes`.
+ *
+ * @return true The maximum was set.
+ * @return false @p maxPrefixes is 0, and errno is set to EINVAL.
+ *
+ * Example:
+ * @code
+ * {
+ *     ccnxPortalRttEstimator_SetMaxPrefixes(estimator, 64);
+ * }
+ * @endcode
+ */
+bool ccnxPortalRttEstimator_SetMaxPrefixes(CCNxPortalRttEstimator *estimator, size_t maxPrefixes);
+
+/**
+ * Get the number of prefixes forgotten to keep within the maximum.
+ *
+ * @param [in] estimator A pointer to a valid `CCNxPortalRttEstimator` instance.
+ *
+ * @return The number of prefixes forgotten since the estimator was created.
+ */
+uint64_t ccnxPortalRttEstimator_GetEvictions(const CCNxPortalRttEstimator *estimator);
+
+/**
+ * Get the RTO for an Interest with the given name, from the estimator of its prefix.
+ *
+ * @param [in] estimator A pointer to a valid `CCNxPortalRttEstimator` instance.
+ * @param [in] name A pointer to a valid `CCNxName` instance.
+ *
+ * @return The RTO in microseconds, or the initial RTO for a prefix not seen before.
+ */
+uint64_t ccnxPortalRttEstimator_GetTimeout(const CCNxPortalRttEstimator *estimator, const CCNxName *name);
+
+/**
+ * Update the estimator of the given name's prefix with a measured round-trip time.
+ *
+ * Only the round trips of Interests that were not retransmitted are measured, as TCP does (Karn's algorithm),
+ * since a response to a retransmitted Interest may answer any of its transmissions.
+ *
+ * @param [in,out] estimator A pointer to a valid `CCNxPortalRttEstimator` instance.
+ * @param [in] name The name of the Interest.
+ * @param [in] rtt The round-trip time in microseconds.
+ *
+ * Example:
+ * @code
+ * {
+ *     ccnxPortalRttEstimator_AddSample(estimator, name, receiveTime - sendTime);
+ * }
+ * @endcode
+ */
+void ccnxPortalRttEstimator_AddSample(CCNxPortalRttEstimator *estimator, const CCNxName *name, uint64_t rtt);
+
+/**
+ * Record that an Interest with the given name went unanswered within its RTO, doubling its prefix's RTO up to the maximum.
+ *
+ * @param [in,out] estimator A pointer to a valid `CCNxPortalRttEstimator` instance.
+ * @param [in] name The name of the Interest.
+ */
+void ccnxPortalRttEstimator_Backoff(CCNxPortalRttEstimator *estimator, const CCNxName *name);
+
+/**
+ * Get the estimate of the given name's prefix.
+ *
+ * @param [in] estimator A pointer to a valid `CCNxPortalRttEstimator` instance.
+ * @param [in] name A name under the prefix.
+ * @param [out] estimate The estimate.
+ *
+ * @return true The prefix has an estimator, and @p estimate is set.
+ * @return false No Interest under the prefix has been answered or has timed out.
+ *
+ * Example:
+ * @code
+ * {
+ *     CCNxPortalRttEstimate estimate;
+ *     if (ccnxPortalRttEstimator_GetEstimate(estimator, name, &estimate)) {
+ *         printf("srtt %" PRIu64 "us rto %" PRIu64 "us\n", estimate.smoothedRtt, estimate.retransmissionTimeout);
+ *     }
+ * }
+ * @endcode
+ */
+bool ccnxPortalRttEstimator_GetEstimate(const CCNxPortalRttEstimator *estimator, const CCNxName *name, CCNxPortalRttEstimate *estimate);
+
+/**
+ * Get the number of prefixes with an estimator.
+ *
+ * @param [in] estimator A pointer to a valid `CCNxPortalRttEstimator` instance.
+ *
+ * @return The number of prefixes.
+ */
+size_t ccnxPortalRttEstimator_GetCount(const CCNxPortalRttEstimator *estimator);
+
+/**
+ * Create a `PARCJSON` representation of every prefix's estimate, keyed by the prefix's URI.
+ *
+ * @param [in] estimator A pointer to a valid `CCNxPortalRttEstimator` instance.
+ *
+ * @return A `PARCJSON` instance that must be released via `parcJSON_Release`.
+ *
+ * Example:
+ * @code
+ * {
+ *     PARCJSON *json = ccnxPortalRttEstimator_ToJSON(estimator);
+ *     char *string = parcJSON_ToString(json);
+ *     printf("%s\n", string);
+ *     parcMemory_Deallocate(&string);
+ *     parcJSON_Release(&json);
+ * }
+ * @endcode
+ */
+PARCJSON *ccnxPortalRttEstimator_ToJSON(const CCNxPortalRttEstimator *estimator);
+#endif // CCNx_Portal_API_ccnx_PortalRttEstimator_h
@@ -0,0 +1,568 @@
+/*
+ * Copyright (c) 2016, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX OR PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ################################################################################
+ * #
+ * # PATENT NOTICE
+ * #
+ * # This software is distributed under the BSD 2-clause License (see LICENSE
+ * # file).  This BSD License does not make any patent claims and as such, does
+ * # not act as a patent grant.  The purpose of this section is for each contributor
+ * # to define their intentions with respect to intellectual property.
+ * #
+ * # Each contributor to this source code is encouraged to state their patent
+ * # claims and licensing mechanisms for any contributions made. At the end of
+ * # this section contributors may each make their own statements.  Contributor's
+ * # claims and grants only apply to the pieces (source code, programs, text,
+ * # media, etc) that they have contributed directly to this software.
+ * #
+ * # There is no guarantee that this section is complete, up to date or accurate. It
+ * # is up to the contributors to maintain their portion of this section and up to
+ * # the user of the software to verify any claims herein.
+ * #
+ * # Do not remove this header notification.  The contents of this section must be
+ * # present in all distributions of the software.  You may only modify your own
+ * # intellectual property statements.  Please provide contact information.
+ *
+ * - Palo Alto Research Center, Inc
+ * This software distribution does not grant any rights to patents owned by Palo
+ * Alto Research Center, Inc (PARC). Rights to these patents are available via
+ * various mechanisms. As of January 2016 PARC has committed to FRAND licensing any
+ * intellectual property used by its contributions to this software. You may
+ * contact PARC at cipo@parc.com for more information or visit http://www.ccnx.org
+ */
+/**
+ * @copyright (c) 2016, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC).  All rights reserved.
+ */
+#include <config.h>
+
+#include <errno.h>
+#include <pthread.h>
+#include <time.h>
+
+#include <LongBow/runtime.h>
+
+#include <parc/algol/parc_Object.h>
+#include <parc/algol/parc_Memory.h>
+#include <parc/algol/parc_HashMap.h>
+#include <parc/algol/parc_Iterator.h>
+
+#include <ccnx/api/ccnx_Portal/ccnx_PortalServer.h>
+#include <ccnx/api/ccnx_Portal/ccnx_PortalStatistics.h>
+
+// How long a registered prefix is listened for.
+#define _ccnxPortalServer_ListenSeconds (365 * 86400)
+
+// How long each receive waits before the server checks whether it has been stopped.
+#define _ccnxPortalServer_ReceiveMicroSeconds 100000
+
+// How long each receive waits, while handlers are running on an executor, before the server sends their responses.
+#define _ccnxPortalServer_BusyReceiveMicroSeconds 1000
+
+/*
+ * A node of the name tree. The path of segments from the root to a node is a name prefix,
+ * and the node holds the handler for that prefix, if there is one.
+ * Nodes without a handler exist only as long as they have children.
+ */
+typedef struct _CCNxPortalServerNode {
+    CCNxNameSegment *segment;
+    struct _CCNxPortalServerNode *parent;
+    PARCHashMap *children;
+    CCNxName *prefix;                  // Non-NULL when a handler is registered for the node.
+    CCNxPortalServerHandler *handler;
+    void *context;
+} _CCNxPortalServerNode;
+
+/*
+ * The responses handed back by workers, as an array that grows as needed.
+ */
+typedef struct {
+    CCNxMetaMessage **messages;
+    size_t count;
+    size_t capacity;
+} _CCNxPortalServerReplies;
+
+struct CCNxPortalServer {
+    CCNxPortal *portal;
+    _CCNxPortalServerNode *root;
+    size_t count;
+    bool stopping;
+
+    CCNxPortalExecutor *executor;
+
+    // Workers add to the replies, and finish jobs, under the lock.
+    // The server swaps the replies with the batch it sends, so that it sends them without holding the lock.
+    pthread_mutex_t replyLock;
+    pthread_cond_t jobsFinished;
+    size_t jobs;
+    _CCNxPortalServerReplies replies;
+    _CCNxPortalServerReplies sending;
+};
+
+/*
+ * An Interest queued to an executor, with the handler it was dispatched to.
+ */
+typedef struct {
+    CCNxPortalServer *server;
+    CCNxPortalServerHandler *handler;
+    CCNxName *prefix;
+    CCNxInterest *interest;
+    void *context;
+} _CCNxPortalServerJob;
+
+static void
+_ccnxPortalServerNode_Destroy(_CCNxPortalServerNode **nodePtr)
+{
+    _CCNxPortalServerNode *node = *nodePtr;
+
+    if (node->segment != NULL) {
+        ccnxNameSegment_Release(&node->segment);
+    }
+    if (node->children != NULL) {
+        parcHashMap_Release(&node->children);
+    }
+    if (node->prefix != NULL) {
+        ccnxName_Release(&node->prefix);
+    }
+}
+
+parcObject_ExtendPARCObject(_CCNxPortalServerNode, _ccnxPortalServerNode_Destroy, NULL, NULL, NULL, NULL, NULL, NULL);
+
+static parcObject_ImplementRelease(_ccnxPortalServerNode, _CCNxPortalServerNode);
+
+static _CCNxPortalServerNode *
+_ccnxPortalServerNode_Create(const CCNxNameSegment *segment, _CCNxPortalServerNode *parent)
+{
+    _CCNxPortalServerNode *result = parcObject_CreateInstance(_CCNxPortalServerNode);
+    if (result != NULL) {
+        result->segment = (segment == NULL) ? NULL : ccnxNameSegment_Acquire(segment);
+        result->parent = parent;
+        result->children = NULL;
+        result->prefix = NULL;
+        result->handler = NULL;
+        result->context = NULL;
+    }
+    return result;
+}
+
+/*
+ * Ignore the prefix of every node holding a handler at or under the given node.
+ */
+static void
+_ccnxPortalServer_IgnoreUnder(CCNxPortalServer *server, _CCNxPortalServerNode *node)
+{
+    if (node->prefix != NULL) {
+        ccnxPortal_Ignore(server->portal, node->prefix, CCNxStackTimeout_Never);
+    }
+
+    if (node->children != NULL) {
+        PARCIterator *iterator = parcHashMap_CreateValueIterator(node->children);
+        while (parcIterator_HasNext(iterator)) {
+            _ccnxPortalServer_IgnoreUnder(server, parcIterator_Next(iterator));
+        }
+        parcIterator_Release(&iterator);
+    }
+}
+
+static void
+_ccnxPortalServer_Destroy(CCNxPortalServer **serverPtr)
+{
+    CCNxPortalServer *server = *serverPtr;
+
+    // Queued jobs refer to the server, so wait for them, and send their responses while the Portal is still held.
+    pthread_mutex_lock(&server->replyLock);
+    while (__atomic_load_n(&server->jobs, __ATOMIC_ACQUIRE) > 0) {
+        pthread_cond_wait(&server->jobsFinished, &server->replyLock);
+    }
+    pthread_mutex_unlock(&server->replyLock);
+    ccnxPortalServer_SendReplies(server);
+
+    if (server->executor != NULL) {
+        ccnxPortalExecutor_Release(&server->executor);
+    }
+    if (server->root != NULL) {
+        _ccnxPortalServer_IgnoreUnder(server, server->root);
+        _ccnxPortalServerNode_Release(&server->root);
+    }
+    ccnxPortal_Release(&server->portal);
+
+    if (server->replies.messages != NULL) {
+        parcMemory_Deallocate(&server->replies.messages);
+    }
+    if (server->sending.messages != NULL) {
+        parcMemory_Deallocate(&server->sending.messages);
+    }
+    pthread_cond_destroy(&server->jobsFinished);
+    pthread_mutex_destroy(&server->replyLock);
+}
+
+parcObject_ExtendPARCObject(CCNxPortalServer, _ccnxPortalServer_Destroy, NULL, NULL, NULL, NULL, NULL, NULL);
+
+parcObject_ImplementAcquire(ccnxPortalServer, CCNxPortalServer);
+
+parcObject_ImplementRelease(ccnxPortalServer, CCNxPortalServer);
+
+CCNxPortalServer *
+ccnxPortalServer_Create(CCNxPortal *portal)
+{
+    CCNxPortalServer *result = parcObject_CreateInstance(CCNxPortalServer);
+    if (result != NULL) {
+        result->portal = ccnxPortal_Acquire(portal);
+        result->root = _ccnxPortalServerNode_Create(NULL, NULL);
+        result->count = 0;
+        result->stopping = false;
+        result->executor = NULL;
+        pthread_mutex_init(&result->replyLock, NULL);
+        pthread_cond_init(&result->jobsFinished, NULL);
+        result->jobs = 0;
+        result->replies = (_CCNxPortalServerReplies) { .messages = NULL, .count = 0, .capacity = 0 };
+        result->sending = (_CCNxPortalServerReplies) { .messages = NULL, .count = 0, .capacity = 0 };
+
+        if (result->root == NULL) {
+            ccnxPortalServer_Release(&result);
+        }
+    }
+    return result;
+}
+
+/*
+ * Find the node for the given name, optionally creating it and any missing nodes on the path to it.
+ */
+static _CCNxPortalServerNode *
+_ccnxPortalServer_FindNode(const CCNxPortalServer *server, const CCNxName *name, bool create)
+{
+    _CCNxPortalServerNode *node = server->root;
+    size_t segmentCount = ccnxName_GetSegmentCount(name);
+
+    for (size_t i = 0; i < segmentCount && node != NULL; i++) {
+        CCNxNameSegment *segment = ccnxName_GetSegment(name, i);
+
+        _CCNxPortalServerNode *child = NULL;
+        if (node->children != NULL) {
+            child = (_CCNxPortalServerNode *) parcHashMap_Get(node->children, segment);
+        }
+
+        if (child == NULL && create) {
+            if (node->children == NULL) {
+                node->children = parcHashMap_Create();
+            }
+            child = _ccnxPortalServerNode_Create(segment, node);
+            if (node->children == NULL || child == NULL) {
+                if (child != NULL) {
+                    _ccnxPortalServerNode_Release(&child);
+                }
+                return NULL;
+            }
+            parcHashMap_Put(node->children, segment, child);
+
+            // The parent's map now holds the node.
+            _CCNxPortalServerNode *reference = child;
+            _ccnxPortalServerNode_Release(&reference);
+        }
+
+        node = child;
+    }
+
+    return node;
+}
+
+/*
+ * Remove the given node, and then its ancestors, for as long as they hold neither a handler nor children.
+ */
+static void
+_ccnxPortalServer_Prune(CCNxPortalServer *server, _CCNxPortalServerNode *node)
+{
+    while (node != server->root && node->prefix == NULL &&
+           (node->children == NULL || parcHashMap_Size(node->children) == 0)) {
+        _CCNxPortalServerNode *parent = node->parent;
+
+        // Removing the node from its parent releases it, and with it the segment used as the key.
+        CCNxNameSegment *segment = ccnxNameSegment_Acquire(node->segment);
+        parcHashMap_Remove(parent->children, segment);
+        ccnxNameSegment_Release(&segment);
+
+        node = parent;
+    }
+}
+
+bool
+ccnxPortalServer_Register(CCNxPortalServer *server, const CCNxName *prefix, CCNxPortalServerHandler *handler, void *context)
+{
+    _CCNxPortalServerNode *node = _ccnxPortalServer_FindNode(server, prefix, true);
+    if (node == NULL) {
+        errno = ENOMEM;
+        return false;
+    }
+
+    if (node->prefix == NULL) {
+        if (ccnxPortal_Listen(server->portal, prefix, _ccnxPortalServer_ListenSeconds, CCNxStackTimeout_Never) == false) {
+            _ccnxPortalServer_Prune(server, node);
+            return false;
+        }
+        node->prefix = ccnxName_Acquire(prefix);
+        server->count++;
+    }
+
+    node->handler = handler;
+    node->context = context;
+
+    return true;
+}
+
+bool
+ccnxPortalServer_Unregister(CCNxPortalServer *server, const CCNxName *prefix)
+{
+    _CCNxPortalServerNode *node = _ccnxPortalServer_FindNode(server, prefix, false);
+    if (node == NULL || node->prefix == NULL) {
+        return false;
+    }
+
+    bool result = ccnxPortal_Ignore(server->portal, node->prefix, CCNxStackTimeout_Never);
+
+    ccnxName_Release(&node->prefix);
+    node->handler = NULL;
+    node->context = NULL;
+    server->count--;
+    _ccnxPortalServer_Prune(server, node);
+
+    return result;
+}
+
+/*
+ * Find the node holding the handler for the longest registered prefix of the given name, or NULL if there is none.
+ */
+static _CCNxPortalServerNode *
+_ccnxPortalServer_LongestPrefixMatch(const CCNxPortalServer *server, const CCNxName *name)
+{
+    _CCNxPortalServerNode *node = server->root;
+    _CCNxPortalServerNode *result = (node->prefix != NULL) ? node : NULL;
+    size_t segmentCount = ccnxName_GetSegmentCount(name);
+
+    for (size_t i = 0; i < segmentCount && node->children != NULL; i++) {
+        node = (_CCNxPortalServerNode *) parcHashMap_Get(node->children, ccnxName_GetSegment(name, i));
+        if (node == NULL) {
+            break;
+        }
+        if (node->prefix != NULL) {
+            result = node;
+        }
+    }
+
+    return result;
+}
+
+/*
+ * Run a queued job's handler on a worker, and hand its response back to the server.
+ */
+static void
+_ccnxPortalServer_RunJob(void *argument)
+{
+    _CCNxPortalServerJob *job = argument;
+    CCNxPortalServer *server = job->server;
+
+    CCNxMetaMessage *response = job->handler(server, job->prefix, job->interest, job->context);
+
+    ccnxInterest_Release(&job->interest);
+    ccnxName_Release(&job->prefix);
+    parcMemory_Deallocate(&job);
+
+    pthread_mutex_lock(&server->replyLock);
+    if (response != NULL) {
+        _CCNxPortalServerReplies *replies = &server->replies;
+        if (replies->count == replies->capacity) {
+            size_t capacity = (replies->capacity == 0) ? 64 : replies->capacity * 2;
+            CCNxMetaMessage **messages = parcMemory_Reallocate(replies->messages, capacity * sizeof(CCNxMetaMessage *));
+            if (messages != NULL) {
+                replies->messages = messages;
+                replies->capacity = capacity;
+            }
+        }
+        if (replies->count < replies->capacity) {
+            replies->messages[replies->count] = response;
+            __atomic_store_n(&replies->count, replies->count + 1, __ATOMIC_RELEASE);
+        } else {
+            ccnxMetaMessage_Release(&response);
+        }
+    }
+    if (__atomic_sub_fetch(&server->jobs, 1, __ATOMIC_ACQ_REL) == 0) {
+        pthread_cond_broadcast(&server->jobsFinished);
+    }
+    pthread_mutex_unlock(&server->replyLock);
+}
+
+static bool
+_ccnxPortalServer_Submit(CCNxPortalServer *server, _CCNxPortalServerNode *node, CCNxInterest *interest)
+{
+    _CCNxPortalServerJob *job = parcMemory_Allocate(sizeof(_CCNxPortalServerJob));
+    if (job == NULL) {
+        errno = ENOMEM;
+        return false;
+    }
+    job->server = server;
+    job->handler = node->handler;
+    job->prefix = ccnxName_Acquire(node->prefix);
+    job->interest = ccnxInterest_Acquire(interest);
+    job->context = node->context;
+
+    __atomic_add_fetch(&server->jobs, 1, __ATOMIC_ACQ_REL);
+    if (ccnxPortalExecutor_Submit(server->executor, _ccnxPortalServer_RunJob, job) == false) {
+        __atomic_sub_fetch(&server->jobs, 1, __ATOMIC_ACQ_REL);
+        ccnxInterest_Release(&job->interest);
+        ccnxName_Release(&job->prefix);
+        parcMemory_Deallocate(&job);
+        return false;
+    }
+    return true;
+}
+
+bool
+ccnxPortalServer_Dispatch(CCNxPortalServer *server, const CCNxMetaMessage *message)
+{
+    if (!ccnxMetaMessage_IsInterest(message)) {
+        return false;
+    }
+
+    CCNxInterest *interest = ccnxMetaMessage_GetInterest(message);
+    _CCNxPortalServerNode *node = _ccnxPortalServer_LongestPrefixMatch(server, ccnxInterest_GetName(interest));
+    if (node == NULL) {
+        return false;
+    }
+
+    if (server->executor != NULL) {
+        return _ccnxPortalServer_Submit(server, node, interest);
+    }
+
+    CCNxMetaMessage *response = node->handler(server, node->prefix, interest, node->context);
+    if (response != NULL) {
+        ccnxPortal_Send(server->portal, response, CCNxStackTimeout_Never);
+        ccnxMetaMessage_Release(&response);
+    }
+
+    return true;
+}
+
+/*
+ * A receive that returns nothing because it timed out or was interrupted is not a failure of the Portal.
+ */
+static bool
+_ccnxPortalServer_IsFatal(const CCNxPortal *portal)
+{
+    return ccnxPortal_IsError(portal) && !ccnxPortal_IsTimeout(portal) && ccnxPortal_GetError(portal) != EINTR;
+}
+
+void
+ccnxPortalServer_SetExecutor(CCNxPortalServer *server, CCNxPortalExecutor *executor)
+{
+    if (server->executor != NULL) {
+        ccnxPortalExecutor_Release(&server->executor);
+    }
+    if (executor != NULL) {
+        server->executor = ccnxPortalExecutor_Acquire(executor);
+    }
+}
+
+size_t
+ccnxPortalServer_SendReplies(CCNxPortalServer *server)
+{
+    if (__atomic_load_n(&server->replies.count, __ATOMIC_ACQUIRE) == 0) {
+        return 0;
+    }
+
+    pthread_mutex_lock(&server->replyLock);
+    _CCNxPortalServerReplies batch = server->replies;
+    server->replies = server->sending;
+    pthread_mutex_unlock(&server->replyLock);
+
+    for (size_t i = 0; i < batch.count; i++) {
+        ccnxPortal_Send(server->portal, batch.messages[i], CCNxStackTimeout_Never);
+        ccnxMetaMessage_Release(&batch.messages[i]);
+    }
+
+    size_t result = batch.count;
+    batch.count = 0;
+    server->sending = batch;
+
+    return result;
+}
+
+/*
+ * Sleep out what remains of a receive's wait, for stacks that return at once when they have nothing,
+ * so that an idle server does not spin.
+ */
+static void
+_ccnxPortalServer_Idle(uint64_t start, uint64_t waitMicroSeconds)
+{
+    uint64_t elapsed = (ccnxPortalStatistics_Now() - start) / 1000;
+    if (elapsed < waitMicroSeconds) {
+        uint64_t remaining = waitMicroSeconds - elapsed;
+        struct timespec delay = { .tv_sec = remaining / 1000000, .tv_nsec = (remaining % 1000000) * 1000 };
+        nanosleep(&delay, NULL);
+    }
+}
+
+bool
+ccnxPortalServer_Run(CCNxPortalServer *server)
+{
+    bool result = true;
+
+    __atomic_store_n(&server->stopping, false, __ATOMIC_RELEASE);
+
+    while (!__atomic_load_n(&server->stopping, __ATOMIC_ACQUIRE)) {
+        uint64_t wait = (__atomic_load_n(&server->jobs, __ATOMIC_ACQUIRE) > 0)
+                        ? _ccnxPortalServer_BusyReceiveMicroSeconds : _ccnxPortalServer_ReceiveMicroSeconds;
+        uint64_t start = ccnxPortalStatistics_Now();
+        CCNxMetaMessage *message = ccnxPortal_Receive(server->portal, CCNxStackTimeout_MicroSeconds(wait));
+        if (message == NULL) {
+            if (_ccnxPortalServer_IsFatal(server->portal)) {
+                result = false;
+                break;
+            }
+            _ccnxPortalServer_Idle(start, wait);
+        } else {
+            ccnxPortalServer_Dispatch(server, message);
+            ccnxMetaMessage_Release(&message);
+        }
+        ccnxPortalServer_SendReplies(server);
+    }
+
+    return result;
+}
+
+void
+ccnxPortalServer_Stop(CCNxPortalServer *server)
+{
+    __atomic_store_n(&server->stopping, true, __ATOMIC_RELEASE);
+}
+
+CCNxPortal *
+ccnxPortalServer_GetPortal(const CCNxPortalServer *server)
+{
+    return server->portal;
+}
+
+size_t
+ccnxPortalServer_GetCount(const CCNxPortalServer *server)
+{
+    return server->count;
+}
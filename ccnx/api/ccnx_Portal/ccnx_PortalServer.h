@@ -0,0 +1,347 @@
+/*
+ * Copyright (c) 2016, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX OR PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ################################################################################
+ * #
+ * # PATENT NOTICE
+ * #
+ * # This software is distributed under the BSD 2-clause License (see LICENSE
+ * # file).  This BSD License does not make any patent claims and as such, does
+ * # not act as a patent grant.  The purpose of this section is for each contributor
+ * # to define their intentions with respect to intellectual property.
+ * #
+ * # Each contributor to this source code is encouraged to state their patent
+ * # claims and licensing mechanisms for any contributions made. At the end of
+ * # this section contributors may each make their own statements.  Contributor's
+ * # claims and grants only apply to the pieces (source code, programs, text,
+ * # media, etc) that they have contributed directly to this software.
+ * #
+ * # There is no guarantee that this section is complete, up to date or accurate. It
+ * # is up to the contributors to maintain their portion of this section and up to
+ * # the user of the software to verify any claims herein.
+ * #
+ * # Do not remove this header notification.  The contents of this section must be
+ * # present in all distributions of the software.  You may only modify your own
+ * # intellectual property statements.  Please provide contact information.
+ *
+ * - Palo Alto Research Center, Inc
+ * This software distribution does not grant any rights to patents owned by Palo
+ * Alto Research Center, Inc (PARC). Rights to these patents are available via
+ * various mechanisms. As of January 2016 PARC has committed to FRAND licensing any
+ * intellectual property used by its contributions to this software. You may
+ * contact PARC at cipo@parc.com for more information or visit http://www.ccnx.org
+ */
+/**
+ * @file ccnx_PortalServer.h
+ * @brief Serve Interests by dispatching them to handlers registered for name prefixes.
+ *
+ * A server owns the Listen and Ignore calls for a `CCNxPortal`:
+ * registering a handler for a name prefix listens for it, and unregistering the handler, or releasing the server, ignores it.
+ * Each Interest the server receives is dispatched to the handler registered for the longest prefix of its name.
+ * Handlers are indexed by a tree of name segments, so dispatching an Interest costs time proportional to the number of
+ * segments in its name, independent of the number of handlers registered.
+ *
+ * A handler may return a response, which the server sends, or send any number of messages itself through
+ * the server's Portal.
+ *
+ * Handlers are called on the thread dispatching the Interests, unless the server is given a `CCNxPortalExecutor`.
+ * The server then queues each Interest to the executor's workers, so slow handlers run in parallel with each other
+ * and with the receiving of further Interests. A worker hands its handler's response back to the server,
+ * which sends the responses collected since it last sent any together, on its own thread, since a Portal is not thread-safe.
+ * An Interest arriving when the executor's queues are full is dropped, to be retransmitted by its sender.
+ *
+ * A server is not thread-safe, except for {@link ccnxPortalServer_Stop}, which may be called from any thread.
+ *
+ * @copyright (c) 2016, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC).  All rights reserved.
+ */
+#ifndef CCNx_Portal_API_ccnx_PortalServer_h
+#define CCNx_Portal_API_ccnx_PortalServer_h
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include <ccnx/api/ccnx_Portal/ccnx_Portal.h>
+#include <ccnx/api/ccnx_Portal/ccnx_PortalExecutor.h>
+
+#include <ccnx/common/ccnx_Name.h>
+#include <ccnx/common/ccnx_Interest.h>
+
+struct CCNxPortalServer;
+/**
+ * @typedef CCNxPortalServer
+ * @brief A table of handlers by name prefix, serving the Interests received by a `CCNxPortal`.
+ */
+typedef struct CCNxPortalServer CCNxPortalServer;
+
+/**
+ * The function called for each Interest whose name's longest registered prefix is the one the handler was registered for.
+ *
+ * A handler run by an executor runs on a worker thread, at the same time as other handlers.
+ * It must not use the server's Portal, and must return its response instead of sending it.
+ *
+ * @param [in] server The server dispatching the Interest.
+ * @param [in] prefix The prefix the handler was registered for.
+ * @param [in] interest The Interest.
+ * @param [in] context The context given when the handler was registered.
+ *
+ * @return non-NULL A message the server sends in response, and then releases.
+ * @return NULL The handler sends nothing, or has sent its response itself.
+ */
+typedef CCNxMetaMessage *(CCNxPortalServerHandler)(CCNxPortalServer *server, const CCNxName *prefix,
+                                                   const CCNxInterest *interest, void *context);
+
+/**
+ * Create a new `CCNxPortalServer` serving the Interests received by the given `CCNxPortal`.
+ *
+ * The server acquires a reference to @p portal.
+ *
+ * @param [in] portal A pointer to a valid `CCNxPortal` instance.
+ *
+ * @return non-NULL A pointer to a valid `CCNxPortalServer` instance.
+ * @return NULL Memory could not be allocated.
+ *
+ * Example:
+ * @code
+ * {
+ *     CCNxPortal *portal = ccnxPortalFactory_CreatePortal(factory, ccnxPortalRTA_Message);
+ *     CCNxPortalServer *server = ccnxPortalServer_Create(portal);
+ *
+ *     ccnxPortalServer_Release(&server);
+ *     ccnxPortal_Release(&portal);
+ * }
+ * @endcode
+ */
+CCNxPortalServer *ccnxPortalServer_Create(CCNxPortal *portal);
+
+/**
+ * Increase the number of references to a `CCNxPortalServer` instance.
+ *
+ * @param [in] server A pointer to a valid `CCNxPortalServer` instance.
+ *
+ * @return The same value as @p server.
+ *
+ * Example:
+ * @code
+ * {
+ *     CCNxPortalServer *server = ccnxPortalServer_Create(portal);
+ *     CCNxPortalServer *reference = ccnxPortalServer_Acquire(server);
+ *
+ *     ccnxPortalServer_Release(&server);
+ *     ccnxPortalServer_Release(&reference);
+ * }
+ * @endcode
+ */
+CCNxPortalServer *ccnxPortalServer_Acquire(const CCNxPortalServer *server);
+
+/**
+ * Release a previously acquired reference to the given `CCNxPortalServer` instance,
+ * decrementing the reference count for the instance.
+ *
+ * The pointer to the instance is set to NULL as a side-effect of this function.
+ * When the last reference is released, the handlers still running on an executor are waited for and their responses sent,
+ * every prefix still registered is ignored, and the references to the Portal and the executor released.
+ *
+ * @param [in,out] serverPtr A pointer to a pointer to the instance to release.
+ *
+ * Example:
+ * @code
+ * {
+ *     CCNxPortalServer *server = ccnxPortalServer_Create(portal);
+ *
+ *     ccnxPortalServer_Release(&server);
+ * }
+ * @endcode
+ */
+void ccnxPortalServer_Release(CCNxPortalServer **serverPtr);
+
+/**
+ * Register a handler for the Interests under the given name prefix, listening for the prefix.
+ *
+ * Registering a prefix again replaces its handler and context, without listening again.
+ *
+ * @param [in,out] server A pointer to a valid `CCNxPortalServer` instance.
+ * @param [in] prefix A pointer to a valid `CCNxName` instance.
+ * @param [in] handler The function called for each Interest dispatched to @p prefix.
+ * @param [in] context A value passed to @p handler.
+ *
+ * @return true The handler was registered.
+ * @return false The Portal could not listen for @p prefix (see `ccnxPortal_GetError`), or memory could not be allocated.
+ *
+ * Example:
+ * @code
+ * {
+ *     CCNxName *prefix = ccnxName_CreateFromCString("lci:/example/files");
+ *
+ *     ccnxPortalServer_Register(server, prefix, serveFile, fileStore);
+ *
+ *     ccnxName_Release(&prefix);
+ * }
+ * @endcode
+ */
+bool ccnxPortalServer_Register(CCNxPortalServer *server, const CCNxName *prefix, CCNxPortalServerHandler *handler, void *context);
+
+/**
+ * Unregister the handler for the given name prefix, ignoring the prefix.
+ *
+ * The handler is unregistered even if the Portal fails to ignore the prefix.
+ *
+ * @param [in,out] server A pointer to a valid `CCNxPortalServer` instance.
+ * @param [in] prefix A pointer to a valid `CCNxName` instance.
+ *
+ * @return true The handler was unregistered and the prefix ignored.
+ * @return false No handler was registered for @p prefix, or the Portal failed to ignore it (see `ccnxPortal_GetError`).
+ *
+ * Example:
+ * @code
+ * {
+ *     ccnxPortalServer_Unregister(server, prefix);
+ * }
+ * @endcode
+ */
+bool ccnxPortalServer_Unregister(CCNxPortalServer *server, const CCNxName *prefix);
+
+/**
+ * Dispatch the given message to the handler registered for the longest prefix of its name, and send the handler's response.
+ *
+ * Only Interests are dispatched.
+ * With an executor, the handler is queued to run on a worker, and its response is sent by `ccnxPortalServer_SendReplies`.
+ *
+ * @param [in,out] server A pointer to a valid `CCNxPortalServer` instance.
+ * @param [in] message A pointer to a valid `CCNxMetaMessage` instance.
+ *
+ * @return true The message was an Interest, and a handler was called, or queued, for it.
+ * @return false The message was not an Interest, no registered prefix is a prefix of its name,
+ *               or the executor's queues were full and errno is set to EBUSY.
+ *
+ * Example:
+ * @code
+ * {
+ *     CCNxMetaMessage *message = ccnxPortal_Receive(portal, CCNxStackTimeout_Never);
+ *     if (message != NULL) {
+ *         ccnxPortalServer_Dispatch(server, message);
+ *         ccnxMetaMessage_Release(&message);
+ *     }
+ * }
+ * @endcode
+ */
+bool ccnxPortalServer_Dispatch(CCNxPortalServer *server, const CCNxMetaMessage *message);
+
+/**
+ * Run the given handlers on the given executor's worker threads, instead of on the thread dispatching the Interests.
+ *
+ * The server acquires a reference to @p executor. An executor may be shared by several servers.
+ *
+ * @param [in,out] server A pointer to a valid `CCNxPortalServer` instance.
+ * @param [in] executor A pointer to a valid `CCNxPortalExecutor` instance, or NULL to call handlers on the dispatching thread.
+ *
+ * Example:
+ * @code
+ * {
+ *     CCNxPortalExecutor *executor = ccnxPortalExecutor_Create(4, 256);
+ *     ccnxPortalServer_SetExecutor(server, executor);
+ *     ccnxPortalExecutor_Release(&executor);
+ *
+ *     ccnxPortalServer_Run(server);
+ * }
+ * @endcode
+ */
+void ccnxPortalServer_SetExecutor(CCNxPortalServer *server, CCNxPortalExecutor *executor);
+
+/**
+ * Send the responses the executor's workers have handed back since the last call, in one batch.
+ *
+ * `ccnxPortalServer_Run` calls this after each message it dispatches, and whenever a receive times out.
+ *
+ * @param [in,out] server A pointer to a valid `CCNxPortalServer` instance.
+ *
+ * @return The number of responses sent.
+ *
+ * Example:
+ * @code
+ * {
+ *     ccnxPortalServer_Dispatch(server, message);
+ *     ...
+ *     ccnxPortalServer_SendReplies(server);
+ * }
+ * @endcode
+ */
+size_t ccnxPortalServer_SendReplies(CCNxPortalServer *server);
+
+/**
+ * Receive and dispatch messages until {@link ccnxPortalServer_Stop} is called, or the Portal fails.
+ *
+ * While handlers are running on an executor, receives wait at most a millisecond, so their responses are sent promptly.
+ * A receive that returns nothing before its wait is over, as the loopback stack does when it is empty, is waited out.
+ *
+ * Each run starts afresh: a {@link ccnxPortalServer_Stop} made while the server was not running does not end it.
+ *
+ * @param [in,out] server A pointer to a valid `CCNxPortalServer` instance.
+ *
+ * @return true The server was stopped.
+ * @return false Receiving failed (see `ccnxPortal_GetError`).
+ *
+ * Example:
+ * @code
+ * {
+ *     ccnxPortalServer_Register(server, prefix, serveFile, fileStore);
+ *
+ *     if (ccnxPortalServer_Run(server) == false) {
+ *         fprintf(stderr, "ccnxPortal_Receive failed: %d\n", ccnxPortal_GetError(portal));
+ *     }
+ * }
+ * @endcode
+ */
+bool ccnxPortalServer_Run(CCNxPortalServer *server);
+
+/**
+ * Make {@link ccnxPortalServer_Run} return.
+ *
+ * A server that is running returns after dispatching the message it has received, if any,
+ * and otherwise within its receive timeout of 100 milliseconds.
+ * A server that is not running returns from its next call to `ccnxPortalServer_Run` at once.
+ *
+ * This may be called from any thread, or from a handler.
+ *
+ * @param [in] server A pointer to a valid `CCNxPortalServer` instance.
+ */
+void ccnxPortalServer_Stop(CCNxPortalServer *server);
+
+/**
+ * Get the Portal the given server serves.
+ *
+ * @param [in] server A pointer to a valid `CCNxPortalServer` instance.
+ *
+ * @return The Portal, valid for as long as the server is.
+ */
+CCNxPortal *ccnxPortalServer_GetPortal(const CCNxPortalServer *server);
+
+/**
+ * Get the number of name prefixes with a registered handler.
+ *
+ * @param [in] server A pointer to a valid `CCNxPortalServer` instance.
+ *
+ * @return The number of registered prefixes.
+ */
+size_t ccnxPortalServer_GetCount(const CCNxPortalServer *server);
+#endif // CCNx_Portal_API_ccnx_PortalServer_h
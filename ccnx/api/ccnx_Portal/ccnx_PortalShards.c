@@ -0,0 +1,319 @@
+/*
+ * Copyright (c) 2016, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX OR PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ################################################################################
+ * #
+ * # PATENT NOTICE
+ * #
+ * # This software is distributed under the BSD 2-clause License (see LICENSE
+ * # file).  This BSD License does not make any patent claims and as such, does
+ * # not act as a patent grant.  The purpose of this section is for each contributor
+ * # to define their intentions with respect to intellectual property.
+ * #
+ * # Each contributor to this source code is encouraged to state their patent
+ * # claims and licensing mechanisms for any contributions made. At the end of
+ * # this section contributors may each make their own statements.  Contributor's
+ * # claims and grants only apply to the pieces (source code, programs, text,
+ * # media, etc) that they have contributed directly to this software.
+ * #
+ * # There is no guarantee that this section is complete, up to date or accurate. It
+ * # is up to the contributors to maintain their portion of this section and up to
+ * # the user of the software to verify any claims herein.
+ * #
+ * # Do not remove this header notification.  The contents of this section must be
+ * # present in all distributions of the software.  You may only modify your own
+ * # intellectual property statements.  Please provide contact information.
+ *
+ * - Palo Alto Research Center, Inc
+ * This software distribution does not grant any rights to patents owned by Palo
+ * Alto Research Center, Inc (PARC). Rights to these patents are available via
+ * various mechanisms. As of January 2016 PARC has committed to FRAND licensing any
+ * intellectual property used by its contributions to this software. You may
+ * contact PARC at cipo@parc.com for more information or visit http://www.ccnx.org
+ */
+/**
+ * @copyright (c) 2016, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC).  All rights reserved.
+ */
+#include <config.h>
+
+#include <errno.h>
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+
+#include <LongBow/runtime.h>
+
+#include <parc/algol/parc_Object.h>
+#include <parc/algol/parc_Memory.h>
+
+#include <ccnx/api/ccnx_Portal/ccnx_PortalShards.h>
+
+typedef struct {
+    CCNxPortal *portal;
+    CCNxPortalServer *server;
+    pthread_t thread;
+    bool started;
+    int cpu;       // The CPU the shard is pinned to when it starts.
+    int pinnedCpu; // The CPU its thread was pinned to, or -1.
+} _CCNxPortalShard;
+
+struct CCNxPortalShards {
+    size_t count;
+    _CCNxPortalShard *shards;
+    bool running;
+};
+
+static size_t
+_ccnxPortalShards_OnlineCpus(void)
+{
+    long result = sysconf(_SC_NPROCESSORS_ONLN);
+    return (result > 0) ? (size_t) result : 1;
+}
+
+/*
+ * Pin the calling thread to the given CPU, where the platform supports it.
+ * Returns the CPU, or -1 if the thread is not pinned.
+ */
+static int
+_ccnxPortalShards_PinThread(int cpu)
+{
+#ifdef __linux__
+    if (cpu < CPU_SETSIZE) {
+        cpu_set_t cpuSet;
+        CPU_ZERO(&cpuSet);
+        CPU_SET(cpu, &cpuSet);
+        if (pthread_setaffinity_np(pthread_self(), sizeof(cpuSet), &cpuSet) == 0) {
+            return cpu;
+        }
+    }
+#endif
+    return -1;
+}
+
+static void *
+_ccnxPortalShards_Run(void *argument)
+{
+    _CCNxPortalShard *shard = argument;
+
+    __atomic_store_n(&shard->pinnedCpu, _ccnxPortalShards_PinThread(shard->cpu), __ATOMIC_RELEASE);
+    ccnxPortalServer_Run(shard->server);
+
+    return NULL;
+}
+
+static void
+_ccnxPortalShards_Destroy(CCNxPortalShards **shardsPtr)
+{
+    CCNxPortalShards *shards = *shardsPtr;
+
+    if (shards->shards != NULL) {
+        ccnxPortalShards_Stop(shards);
+        for (size_t i = 0; i < shards->count; i++) {
+            if (shards->shards[i].server != NULL) {
+                ccnxPortalServer_Release(&shards->shards[i].server);
+            }
+            if (shards->shards[i].portal != NULL) {
+                ccnxPortal_Release(&shards->shards[i].portal);
+            }
+        }
+        parcMemory_Deallocate(&shards->shards);
+    }
+}
+
+parcObject_ExtendPARCObject(CCNxPortalShards, _ccnxPortalShards_Destroy, NULL, NULL, NULL, NULL, NULL, NULL);
+
+parcObject_ImplementAcquire(ccnxPortalShards, CCNxPortalShards);
+
+parcObject_ImplementRelease(ccnxPortalShards, CCNxPortalShards);
+
+CCNxPortalShards *
+ccnxPortalShards_Create(const CCNxPortalFactory *factory, CCNxStackImpl *stack, size_t shardCount)
+{
+    size_t cpus = _ccnxPortalShards_OnlineCpus();
+    if (shardCount == 0) {
+        shardCount = cpus;
+    }
+
+    CCNxPortalShards *result = parcObject_CreateInstance(CCNxPortalShards);
+    if (result == NULL) {
+        errno = ENOMEM;
+        return NULL;
+    }
+    result->count = shardCount;
+    result->running = false;
+    result->shards = parcMemory_AllocateAndClear(shardCount * sizeof(_CCNxPortalShard));
+    if (result->shards == NULL) {
+        ccnxPortalShards_Release(&result);
+        errno = ENOMEM;
+        return NULL;
+    }
+
+    for (size_t i = 0; i < shardCount; i++) {
+        _CCNxPortalShard *shard = &result->shards[i];
+        shard->cpu = (int) (i % cpus);
+        shard->pinnedCpu = -1;
+
+        shard->portal = ccnxPortalFactory_CreatePortal(factory, stack);
+        if (shard->portal == NULL) {
+            int error = errno;
+            ccnxPortalShards_Release(&result);
+            errno = error;
+            return NULL;
+        }
+        shard->server = ccnxPortalServer_Create(shard->portal);
+        if (shard->server == NULL) {
+            ccnxPortalShards_Release(&result);
+            errno = ENOMEM;
+            return NULL;
+        }
+    }
+
+    return result;
+}
+
+bool
+ccnxPortalShards_Register(CCNxPortalShards *shards, const CCNxName *prefix, CCNxPortalServerHandler *handler, void *context)
+{
+    if (shards->running) {
+        errno = EBUSY;
+        return false;
+    }
+
+    for (size_t i = 0; i < shards->count; i++) {
+        if (ccnxPortalServer_Register(shards->shards[i].server, prefix, handler, context) == false) {
+            int error = errno;
+            for (size_t j = 0; j < i; j++) {
+                ccnxPortalServer_Unregister(shards->shards[j].server, prefix);
+            }
+            errno = error;
+            return false;
+        }
+    }
+    return true;
+}
+
+bool
+ccnxPortalShards_Unregister(CCNxPortalShards *shards, const CCNxName *prefix)
+{
+    if (shards->running) {
+        errno = EBUSY;
+        return false;
+    }
+
+    bool result = false;
+    for (size_t i = 0; i < shards->count; i++) {
+        if (ccnxPortalServer_Unregister(shards->shards[i].server, prefix)) {
+            result = true;
+        }
+    }
+    return result;
+}
+
+bool
+ccnxPortalShards_Start(CCNxPortalShards *shards)
+{
+    if (shards->running) {
+        return true;
+    }
+    shards->running = true;
+
+    for (size_t i = 0; i < shards->count; i++) {
+        _CCNxPortalShard *shard = &shards->shards[i];
+        int error = pthread_create(&shard->thread, NULL, _ccnxPortalShards_Run, shard);
+        if (error != 0) {
+            ccnxPortalShards_Stop(shards);
+            errno = error;
+            return false;
+        }
+        shard->started = true;
+    }
+    return true;
+}
+
+void
+ccnxPortalShards_Stop(CCNxPortalShards *shards)
+{
+    if (!shards->running) {
+        return;
+    }
+
+    for (size_t i = 0; i < shards->count; i++) {
+        if (shards->shards[i].started) {
+            ccnxPortalServer_Stop(shards->shards[i].server);
+        }
+    }
+    for (size_t i = 0; i < shards->count; i++) {
+        _CCNxPortalShard *shard = &shards->shards[i];
+        if (shard->started) {
+            pthread_join(shard->thread, NULL);
+            shard->started = false;
+        }
+    }
+    shards->running = false;
+}
+
+bool
+ccnxPortalShards_IsRunning(const CCNxPortalShards *shards)
+{
+    return shards->running;
+}
+
+size_t
+ccnxPortalShards_GetCount(const CCNxPortalShards *shards)
+{
+    return shards->count;
+}
+
+CCNxPortal *
+ccnxPortalShards_GetPortal(const CCNxPortalShards *shards, size_t index)
+{
+    assertTrue(index < shards->count, "Invalid shard %zu of %zu", index, shards->count);
+    return shards->shards[index].portal;
+}
+
+CCNxPortalServer *
+ccnxPortalShards_GetServer(const CCNxPortalShards *shards, size_t index)
+{
+    assertTrue(index < shards->count, "Invalid shard %zu of %zu", index, shards->count);
+    return shards->shards[index].server;
+}
+
+int
+ccnxPortalShards_GetCpu(const CCNxPortalShards *shards, size_t index)
+{
+    assertTrue(index < shards->count, "Invalid shard %zu of %zu", index, shards->count);
+    return __atomic_load_n(&shards->shards[index].pinnedCpu, __ATOMIC_ACQUIRE);
+}
+
+CCNxPortalStatistics *
+ccnxPortalShards_CreateStatistics(const CCNxPortalShards *shards)
+{
+    CCNxPortalStatistics *result = ccnxPortalStatistics_Create();
+    if (result != NULL) {
+        for (size_t i = 0; i < shards->count; i++) {
+            ccnxPortalStatistics_Add(result, ccnxPortal_GetStatistics(shards->shards[i].portal));
+        }
+    }
+    return result;
+}
@@ -0,0 +1,300 @@
+/*
+ * Copyright (c) 2016, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX OR PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ################################################################################
+ * #
+ * # PATENT NOTICE
+ * #
+ * # This software is distributed under the BSD 2-clause License (see LICENSE
+ * # file).  This BSD License does not make any patent claims and as such, does
+ * # not act as a patent grant.  The purpose of this section is for each contributor
+ * # to define their intentions with respect to intellectual property.
+ * #
+ * # Each contributor to this source code is encouraged to state their patent
+ * # claims and licensing mechanisms for any contributions made. At the end of
+ * # this section contributors may each make their own statements.  Contributor's
+ * # claims and grants only apply to the pieces (source code, programs, text,
+ * # media, etc) that they have contributed directly to this software.
+ * #
+ * # There is no guarantee that this section is complete, up to date or accurate. It
+ * # is up to the contributors to maintain their portion of this section and up to
+ * # the user of the software to verify any claims herein.
+ * #
+ * # Do not remove this header notification.  The contents of this section must be
+ * # present in all distributions of the software.  You may only modify your own
+ * # intellectual property statements.  Please provide contact information.
+ *
+ * - Palo Alto Research Center, Inc
+ * This software distribution does not grant any rights to patents owned by Palo
+ * Alto Research Center, Inc (PARC). Rights to these patents are available via
+ * various mechanisms. As of January 2016 PARC has committed to FRAND licensing any
+ * intellectual property used by its contributions to this software. You may
+ * contact PARC at cipo@parc.com for more information or visit http://www.ccnx.org
+ */
+/**
+ * @file ccnx_PortalShards.h
+ * @brief Serve the same name prefixes from one Portal per core, each on its own pinned thread.
+ *
+ * A single Portal, with its single transport connection, is served by a single thread, so it is limited to one core.
+ * A `CCNxPortalShards` creates a number of Portals, usually one per online CPU, each with its own connection,
+ * and a `CCNxPortalServer` for each. Registering a handler registers it with every shard's server,
+ * so every connection listens for the same prefix, and the forwarder spreads the Interests for it across the connections,
+ * according to the strategy configured for the prefix.
+ *
+ * Once started, each shard receives and dispatches on its own thread, pinned to its own CPU where the platform supports it.
+ * A handler is therefore called on several threads at once, and its context must be safe to share between them.
+ * Handlers are registered and unregistered while the shards are stopped.
+ *
+ * The statistics of every shard's Portal can be combined into one view with {@link ccnxPortalShards_CreateStatistics}.
+ *
+ * @copyright (c) 2016, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC).  All rights reserved.
+ */
+#ifndef CCNx_Portal_API_ccnx_PortalShards_h
+#define CCNx_Portal_API_ccnx_PortalShards_h
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include <ccnx/api/ccnx_Portal/ccnx_PortalFactory.h>
+#include <ccnx/api/ccnx_Portal/ccnx_PortalServer.h>
+#include <ccnx/api/ccnx_Portal/ccnx_PortalStatistics.h>
+
+struct CCNxPortalShards;
+/**
+ * @typedef CCNxPortalShards
+ * @brief A set of Portals serving the same prefixes, each on its own thread.
+ */
+typedef struct CCNxPortalShards CCNxPortalShards;
+
+/**
+ * Create a new `CCNxPortalShards` with the given number of shards, each with its own Portal created by the given factory.
+ *
+ * Shard `i` is pinned to CPU `i` modulo the number of online CPUs when it is started.
+ *
+ * @param [in] factory A pointer to a valid `CCNxPortalFactory` instance.
+ * @param [in] stack The stack implementation of each shard's Portal.
+ * @param [in] shardCount The number of shards, or 0 for one per online CPU.
+ *
+ * @return non-NULL A pointer to a valid `CCNxPortalShards` instance.
+ * @return NULL An error occurred, and errno is set: ENOMEM, or the error creating a Portal.
+ *
+ * Example:
+ * @code
+ * {
+ *     CCNxPortalShards *shards = ccnxPortalShards_Create(factory, ccnxPortalRTA_Message, 0);
+ *
+ *     ccnxPortalShards_Release(&shards);
+ * }
+ * @endcode
+ */
+CCNxPortalShards *ccnxPortalShards_Create(const CCNxPortalFactory *factory, CCNxStackImpl *stack, size_t shardCount);
+
+/**
+ * Increase the number of references to a `CCNxPortalShards` instance.
+ *
+ * @param [in] shards A pointer to a valid `CCNxPortalShards` instance.
+ *
+ * @return The same value as @p shards.
+ *
+ * Example:
+ * @code
+ * {
+ *     CCNxPortalShards *shards = ccnxPortalShards_Create(factory, ccnxPortalRTA_Message, 0);
+ *     CCNxPortalShards *reference = ccnxPortalShards_Acquire(shards);
+ *
+ *     ccnxPortalShards_Release(&shards);
+ *     ccnxPortalShards_Release(&reference);
+ * }
+ * @endcode
+ */
+CCNxPortalShards *ccnxPortalShards_Acquire(const CCNxPortalShards *shards);
+
+/**
+ * Release a previously acquired reference to the specified instance,
+ * decrementing the reference count for the instance.
+ *
+ * The pointer to the instance is set to NULL as a side-effect of this function.
+ * When the last reference is released, the shards are stopped, and their servers and Portals released.
+ *
+ * @param [in,out] shardsPtr A pointer to a pointer to the instance to release.
+ *
+ * Example:
+ * @code
+ * {
+ *     CCNxPortalShards *shards = ccnxPortalShards_Create(factory, ccnxPortalRTA_Message, 0);
+ *
+ *     ccnxPortalShards_Release(&shards);
+ * }
+ * @endcode
+ */
+void ccnxPortalShards_Release(CCNxPortalShards **shardsPtr);
+
+/**
+ * Register the given handler for the given prefix with every shard's server.
+ *
+ * @param [in,out] shards A pointer to a valid `CCNxPortalShards` instance.
+ * @param [in] prefix A pointer to a valid `CCNxName` instance.
+ * @param [in] handler The function called for the Interests under @p prefix, on any of the shards' threads.
+ * @param [in] context The value passed to @p handler, shared by every shard.
+ *
+ * @return true The handler is registered with every shard.
+ * @return false The handler is registered with none of the shards, and errno is set:
+ *               EBUSY if the shards are running, or the error registering it with a shard.
+ *
+ * Example:
+ * @code
+ * {
+ *     CCNxName *prefix = ccnxName_CreateFromCString("lci:/example/files");
+ *     ccnxPortalShards_Register(shards, prefix, serveFile, store);
+ *     ccnxName_Release(&prefix);
+ * }
+ * @endcode
+ */
+bool ccnxPortalShards_Register(CCNxPortalShards *shards, const CCNxName *prefix, CCNxPortalServerHandler *handler, void *context);
+
+/**
+ * Unregister the handler for the given prefix from every shard's server.
+ *
+ * @param [in,out] shards A pointer to a valid `CCNxPortalShards` instance.
+ * @param [in] prefix A pointer to a valid `CCNxName` instance.
+ *
+ * @return true The prefix was registered, and is now unregistered from every shard.
+ * @return false The prefix was not registered, or errno is set to EBUSY because the shards are running.
+ *
+ * Example:
+ * @code
+ * {
+ *     ccnxPortalShards_Unregister(shards, prefix);
+ * }
+ * @endcode
+ */
+bool ccnxPortalShards_Unregister(CCNxPortalShards *shards, const CCNxName *prefix);
+
+/**
+ * Start a thread for each shard, which pins itself to the shard's CPU and runs the shard's server.
+ *
+ * Starting running shards does nothing.
+ *
+ * @param [in,out] shards A pointer to a valid `CCNxPortalShards` instance.
+ *
+ * @return true Every shard is running.
+ * @return false A thread could not be started, the shards already started are stopped, and errno is set.
+ *
+ * Example:
+ * @code
+ * {
+ *     ccnxPortalShards_Start(shards);
+ *     ...
+ *     ccnxPortalShards_Stop(shards);
+ * }
+ * @endcode
+ */
+bool ccnxPortalShards_Start(CCNxPortalShards *shards);
+
+/**
+ * Stop every shard's server, and wait for the shards' threads to finish.
+ *
+ * Each thread finishes within its server's receive timeout. Stopping stopped shards does nothing.
+ *
+ * @param [in,out] shards A pointer to a valid `CCNxPortalShards` instance.
+ *
+ * Example:
+ * @code
+ * {
+ *     ccnxPortalShards_Stop(shards);
+ * }
+ * @endcode
+ */
+void ccnxPortalShards_Stop(CCNxPortalShards *shards);
+
+/**
+ * Determine whether the shards' threads have been started and not yet stopped.
+ *
+ * @param [in] shards A pointer to a valid `CCNxPortalShards` instance.
+ *
+ * @return true The shards are running.
+ * @return false The shards are stopped.
+ */
+bool ccnxPortalShards_IsRunning(const CCNxPortalShards *shards);
+
+/**
+ * Get the number of shards.
+ *
+ * @param [in] shards A pointer to a valid `CCNxPortalShards` instance.
+ *
+ * @return The number of shards.
+ */
+size_t ccnxPortalShards_GetCount(const CCNxPortalShards *shards);
+
+/**
+ * Get the Portal of the given shard.
+ *
+ * @param [in] shards A pointer to a valid `CCNxPortalShards` instance.
+ * @param [in] index The index of the shard, less than `ccnxPortalShards_GetCount`.
+ *
+ * @return A pointer to the shard's `CCNxPortal`, valid for the lifetime of @p shards.
+ */
+CCNxPortal *ccnxPortalShards_GetPortal(const CCNxPortalShards *shards, size_t index);
+
+/**
+ * Get the server of the given shard.
+ *
+ * @param [in] shards A pointer to a valid `CCNxPortalShards` instance.
+ * @param [in] index The index of the shard, less than `ccnxPortalShards_GetCount`.
+ *
+ * @return A pointer to the shard's `CCNxPortalServer`, valid for the lifetime of @p shards.
+ */
+CCNxPortalServer *ccnxPortalShards_GetServer(const CCNxPortalShards *shards, size_t index);
+
+/**
+ * Get the CPU the given shard's thread is pinned to.
+ *
+ * @param [in] shards A pointer to a valid `CCNxPortalShards` instance.
+ * @param [in] index The index of the shard, less than `ccnxPortalShards_GetCount`.
+ *
+ * @return The CPU the shard's thread runs on, or -1 if the shard has not been pinned, or the platform does not support pinning.
+ */
+int ccnxPortalShards_GetCpu(const CCNxPortalShards *shards, size_t index);
+
+/**
+ * Create a `CCNxPortalStatistics` combining the counters and histograms of every shard's Portal.
+ *
+ * The result is a snapshot, taken while the shards may still be running.
+ *
+ * @param [in] shards A pointer to a valid `CCNxPortalShards` instance.
+ *
+ * @return non-NULL A pointer to a `CCNxPortalStatistics` instance that must be released via `ccnxPortalStatistics_Release`.
+ * @return NULL Memory could not be allocated.
+ *
+ * Example:
+ * @code
+ * {
+ *     CCNxPortalStatistics *statistics = ccnxPortalShards_CreateStatistics(shards);
+ *     uint64_t served = ccnxPortalStatistics_GetCounter(statistics, CCNxPortalStatisticsCounter_InterestsReceived);
+ *     ccnxPortalStatistics_Release(&statistics);
+ * }
+ * @endcode
+ */
+CCNxPortalStatistics *ccnxPortalShards_CreateStatistics(const CCNxPortalShards *shards);
+#endif // CCNx_Portal_API_ccnx_PortalShards_h
@@ -68,7 +68,10 @@
 struct CCNxPortalStack {
     CCNxPortalFactory *factory;
 
-    const CCNxPortalAttributes *attributes;
+    // The factory's configuration when the stack was created, held so that changing the factory's properties cannot free it.
+    CCNxPortalConfiguration *configuration;
+
+    CCNxPortalAttributes *attributes;
 
     void *privateData;
 
@@ -91,17 +94,30 @@ struct CCNxPortalStack {
     CCNxPortalAttributes * (*getAttributes)(void *privateData);
 
     void (*releasePrivateData)(void **privateData);
+
+    CCNxPortalInterceptor *interceptors;
 };
 
+// The arena given to ccnxPortalStack_ReceiveIntoArena, for the stack implementation's read beneath the interceptors.
+static __thread CCNxPortalArena *_ccnxPortalStack_ReceiveArena;
+
 static void
 _destroy(CCNxPortalStack **instancePtr)
 {
     CCNxPortalStack *instance = *instancePtr;
 
+    if (instance->interceptors != NULL) {
+        ccnxPortalInterceptor_Release(&instance->interceptors);
+    }
+
     if (instance->privateData != NULL) {
         instance->releasePrivateData(&instance->privateData);
     }
 
+    ccnxPortalAttributes_Release(&instance->attributes);
+
+    ccnxPortalConfiguration_Release(&instance->configuration);
+
     ccnxPortalFactory_Release(&instance->factory);
 }
 
@@ -130,7 +146,8 @@ ccnxPortalStack_Create(const CCNxPortalFactory *factory,
 
     if (result != NULL) {
         result->factory = ccnxPortalFactory_Acquire(factory);
-        result->attributes = attributes;
+        result->configuration = ccnxPortalConfiguration_Acquire(ccnxPortalFactory_GetConfiguration(factory));
+        result->attributes = ccnxPortalAttributes_Copy((attributes != NULL) ? attributes : &ccnxPortalAttributes_NonBlocking);
         result->start = start;
         result->stop = stop;
         result->read = receive;
@@ -142,6 +159,7 @@ ccnxPortalStack_Create(const CCNxPortalFactory *factory,
         result->getAttributes = getAttributes;
         result->privateData = privateData;
         result->releasePrivateData = releasePrivateData;
+        result->interceptors = NULL;
     }
     return result;
 }
@@ -160,38 +178,154 @@ ccnxPortalStack_Stop(const CCNxPortalStack *portalStack)
     return true;
 }
 
+/*
+ * Read from the stack implementation, with the arena of the receive in progress, if any, active.
+ * The arena is not passed on to anything the read itself receives from, such as another stack.
+ */
+static CCNxMetaMessage *
+_ccnxPortalStack_Read(const CCNxPortalStack *portalStack, const CCNxStackTimeout *microSeconds)
+{
+    CCNxPortalArena *arena = _ccnxPortalStack_ReceiveArena;
+    if (arena == NULL) {
+        return portalStack->read(portalStack->privateData, microSeconds);
+    }
+
+    _ccnxPortalStack_ReceiveArena = NULL;
+    ccnxPortalArena_Begin(arena);
+    CCNxMetaMessage *result = portalStack->read(portalStack->privateData, microSeconds);
+    ccnxPortalArena_End(arena);
+    _ccnxPortalStack_ReceiveArena = arena;
+
+    return result;
+}
+
 CCNxMetaMessage *
 ccnxPortalStack_Receive(const CCNxPortalStack *restrict portalStack, const CCNxStackTimeout *microSeconds)
 {
-    CCNxMetaMessage *result = portalStack->read(portalStack->privateData, microSeconds);
+    return ccnxPortalStack_ReceiveIntoArena(portalStack, microSeconds, NULL);
+}
+
+CCNxMetaMessage *
+ccnxPortalStack_ReceiveIntoArena(const CCNxPortalStack *portalStack, const CCNxStackTimeout *microSeconds, CCNxPortalArena *arena)
+{
+    CCNxPortalArena *previous = _ccnxPortalStack_ReceiveArena;
+    _ccnxPortalStack_ReceiveArena = arena;
+
+    CCNxMetaMessage *result;
+    if (portalStack->interceptors != NULL) {
+        result = ccnxPortalInterceptor_Receive(portalStack->interceptors, microSeconds);
+    } else {
+        result = _ccnxPortalStack_Read(portalStack, microSeconds);
+    }
 
+    _ccnxPortalStack_ReceiveArena = previous;
     return result;
 }
 
 bool
 ccnxPortalStack_Send(const CCNxPortalStack *portalStack, const CCNxMetaMessage *portalMessage, const CCNxStackTimeout *microSeconds)
 {
+    if (portalStack->interceptors != NULL) {
+        return ccnxPortalInterceptor_Send(portalStack->interceptors, portalMessage, microSeconds);
+    }
     return portalStack->write(portalStack->privateData, portalMessage, microSeconds);
 }
 
 bool
 ccnxPortalStack_SetAttributes(const CCNxPortalStack *portalStack, const CCNxPortalAttributes *attributes)
 {
-    return portalStack->setAttributes(portalStack->privateData, attributes);
+    bool result = portalStack->setAttributes(portalStack->privateData, attributes);
+
+    if (result == true) {
+        CCNxPortalAttributes *copy = ccnxPortalAttributes_Copy(attributes);
+        if (copy != NULL) {
+            CCNxPortalStack *stack = (CCNxPortalStack *) portalStack;
+            ccnxPortalAttributes_Release(&stack->attributes);
+            stack->attributes = copy;
+        }
+    }
+
+    return result;
 }
 
 bool
 ccnxPortalStack_Listen(const CCNxPortalStack *portalStack, const CCNxName *name, const CCNxStackTimeout *microSeconds)
 {
+    if (portalStack->interceptors != NULL) {
+        return ccnxPortalInterceptor_Listen(portalStack->interceptors, name, microSeconds);
+    }
     return portalStack->listen(portalStack->privateData, name, microSeconds);
 }
 
 bool
 ccnxPortalStack_Ignore(const CCNxPortalStack *portalStack, const CCNxName *name, const CCNxStackTimeout *microSeconds)
 {
+    if (portalStack->interceptors != NULL) {
+        return ccnxPortalInterceptor_Ignore(portalStack->interceptors, name, microSeconds);
+    }
+    return portalStack->ignore(portalStack->privateData, name, microSeconds);
+}
+
+/*
+ * The operations of the bottom layer of the interceptor chain, which call the stack implementation.
+ */
+static bool
+_ccnxPortalStack_ImplementationSend(void *state, const CCNxPortalInterceptor *next, const CCNxMetaMessage *message, const CCNxStackTimeout *microSeconds)
+{
+    const CCNxPortalStack *portalStack = state;
+    return portalStack->write(portalStack->privateData, message, microSeconds);
+}
+
+static CCNxMetaMessage *
+_ccnxPortalStack_ImplementationReceive(void *state, const CCNxPortalInterceptor *next, const CCNxStackTimeout *microSeconds)
+{
+    const CCNxPortalStack *portalStack = state;
+    return _ccnxPortalStack_Read(portalStack, microSeconds);
+}
+
+static bool
+_ccnxPortalStack_ImplementationListen(void *state, const CCNxPortalInterceptor *next, const CCNxName *name, const CCNxStackTimeout *microSeconds)
+{
+    const CCNxPortalStack *portalStack = state;
+    return portalStack->listen(portalStack->privateData, name, microSeconds);
+}
+
+static bool
+_ccnxPortalStack_ImplementationIgnore(void *state, const CCNxPortalInterceptor *next, const CCNxName *name, const CCNxStackTimeout *microSeconds)
+{
+    const CCNxPortalStack *portalStack = state;
     return portalStack->ignore(portalStack->privateData, name, microSeconds);
 }
 
+bool
+ccnxPortalStack_AddInterceptor(CCNxPortalStack *portalStack, CCNxPortalInterceptor *interceptor)
+{
+    if (portalStack->interceptors == NULL) {
+        // The stack owns the bottom layer, so the layer refers to the stack without holding a reference to it.
+        CCNxPortalInterceptor *implementation =
+            ccnxPortalInterceptor_Create(_ccnxPortalStack_ImplementationSend,
+                                         _ccnxPortalStack_ImplementationReceive,
+                                         _ccnxPortalStack_ImplementationListen,
+                                         _ccnxPortalStack_ImplementationIgnore,
+                                         portalStack,
+                                         NULL);
+        if (implementation == NULL) {
+            return false;
+        }
+        ccnxPortalInterceptor_Link(implementation, NULL);
+        portalStack->interceptors = implementation;
+    }
+
+    if (ccnxPortalInterceptor_Link(interceptor, portalStack->interceptors) == false) {
+        return false;
+    }
+
+    // The new top layer now holds the reference to the previous top layer.
+    ccnxPortalInterceptor_Release(&portalStack->interceptors);
+    portalStack->interceptors = ccnxPortalInterceptor_Acquire(interceptor);
+    return true;
+}
+
 int
 ccnxPortalStack_GetErrorCode(const CCNxPortalStack *portalStack)
 {
@@ -199,9 +333,21 @@ ccnxPortalStack_GetErrorCode(const CCNxPortalStack *portalStack)
     return errno;
 }
 
+bool
+ccnxPortalStack_IsTimeoutError(int error)
+{
+    return error == EWOULDBLOCK || error == EAGAIN || error == ETIMEDOUT || error == ENOMSG;
+}
+
 const CCNxPortalAttributes *
 ccnxPortalStack_GetAttributes(const CCNxPortalStack *portalStack)
 {
+    if (portalStack->getAttributes != NULL) {
+        const CCNxPortalAttributes *result = portalStack->getAttributes(portalStack->privateData);
+        if (result != NULL) {
+            return result;
+        }
+    }
     return portalStack->attributes;
 }
 
@@ -228,3 +374,9 @@ ccnxPortalStack_GetProperty(const CCNxPortalStack *portalStack, const char *rest
 {
     return ccnxPortalFactory_GetProperty(portalStack->factory, name, defaultValue);
 }
+
+const CCNxPortalConfiguration *
+ccnxPortalStack_GetConfiguration(const CCNxPortalStack *portalStack)
+{
+    return portalStack->configuration;
+}
@@ -70,7 +70,10 @@ struct CCNxPortalStack;
 typedef struct CCNxPortalStack CCNxPortalStack;
 
 #include <parc/algol/parc_Properties.h>
+#include <ccnx/api/ccnx_Portal/ccnx_PortalArena.h>
+#include <ccnx/api/ccnx_Portal/ccnx_PortalConfiguration.h>
 #include <ccnx/api/ccnx_Portal/ccnx_PortalFactory.h>
+#include <ccnx/api/ccnx_Portal/ccnx_PortalInterceptor.h>
 
 /**
  * Create function for a `CCNxPortalStack`
@@ -215,6 +218,28 @@ bool ccnxPortalStack_Stop(const CCNxPortalStack *implementation);
  */
 CCNxMetaMessage *ccnxPortalStack_Receive(const CCNxPortalStack *portalStack, const CCNxStackTimeout *microSeconds);
 
+/**
+ * Receive a message from a `CCNxPortalStack`, allocating it from an arena.
+ *
+ * The arena is active only while the stack implementation itself reads the message,
+ * beneath any interceptors, so that interceptors run with no arena active.
+ *
+ * @param [in] portalStack A pointer to an instance of `CCNxPortalStack`
+ * @param [in] microSeconds A pointer to a `struct timeval` or NULL indicating no timeout.
+ * @param [in] arena A pointer to a `CCNxPortalArena` instance, or NULL to allocate as `ccnxPortalStack_Receive` does.
+ *
+ * @return An instance of {@link CCNxMetaMessage}.
+ *
+ * Example:
+ * @code
+ * {
+ *     CCNxMetaMessage *message = ccnxPortalStack_ReceiveIntoArena(stack, CCNxStackTimeout_Never, arena);
+ * }
+ * @endcode
+ */
+CCNxMetaMessage *ccnxPortalStack_ReceiveIntoArena(const CCNxPortalStack *portalStack, const CCNxStackTimeout *microSeconds,
+                                                  CCNxPortalArena *arena);
+
 /**
  * Send a message through a `CCNxPortalStack`
  *
@@ -233,6 +258,9 @@ bool ccnxPortalStack_Send(const CCNxPortalStack *implementation, const CCNxMetaM
 /**
  * Set the attributes on a `CCNxPortalStack`.
  *
+ * The attributes are applied by the Stack implementation.
+ * If it succeeds, the Stack keeps a copy of @p attributes, so the caller may release or reuse its instance.
+ *
  * @param [in] implementation A pointer to an instance of `CCNxPortalStack`.
  * @param [in] attributes A pointer to an instance of `CCNxPortalAttributes`.
  * @return `true` if attributes set successfully, else `false`.
@@ -248,8 +276,11 @@ bool ccnxPortalStack_SetAttributes(const CCNxPortalStack *implementation, const
 /**
  * Get the attributes from a `CCNxPortalStack`.
  *
+ * If the Stack implementation reports the attributes in effect, for example the socket buffer sizes actually granted,
+ * those are returned. Otherwise the result is the attributes given at creation or most recently set successfully.
+ *
  * @param [in] implementation A pointer to an instance of `CCNxPortalStack`.
- * @return A pointer to an instance of `CCNxPortalAttributes` associated with the @p implementation.
+ * @return A pointer to an instance of `CCNxPortalAttributes` associated with the @p implementation, valid until the attributes are next set.
  *
  * Example:
  * @code
@@ -287,6 +318,31 @@ bool ccnxPortalStack_Listen(const CCNxPortalStack *implementation, const CCNxNam
  */
 
 bool ccnxPortalStack_Ignore(const CCNxPortalStack *implementation, const CCNxName *name, const CCNxStackTimeout *microSeconds);
+
+/**
+ * Add an interceptor as the outermost layer of the given `CCNxPortalStack`.
+ *
+ * All subsequent sends, receives, listens and ignores pass through @p interceptor before reaching
+ * any previously added interceptors and, finally, the stack implementation.
+ * Interceptors should be added before the stack is used by more than one thread.
+ *
+ * @param [in] portalStack A pointer to a valid `CCNxPortalStack` instance.
+ * @param [in] interceptor A pointer to a valid `CCNxPortalInterceptor` instance not already added to a stack.
+ *
+ * @return `true` The interceptor was added, and the stack holds a reference to it.
+ * @return `false` The interceptor already belongs to a stack, or memory could not be allocated.
+ *
+ * Example:
+ * @code
+ * {
+ *     CCNxPortalInterceptor *interceptor = ccnxPortalInterceptor_Create(_countingSend, NULL, NULL, NULL, &count, NULL);
+ *     ccnxPortalStack_AddInterceptor(stack, interceptor);
+ *     ccnxPortalInterceptor_Release(&interceptor);
+ * }
+ * @endcode
+ */
+bool ccnxPortalStack_AddInterceptor(CCNxPortalStack *portalStack, CCNxPortalInterceptor *interceptor);
+
 /**
  * Get the file ID for @p implementation.
  *
@@ -331,6 +387,28 @@ const PARCKeyId *ccnxPortalStack_GetKeyId(const CCNxPortalStack *implementation)
  */
 int ccnxPortalStack_GetErrorCode(const CCNxPortalStack *implementation);
 
+/**
+ * Determine if an error code reports that an operation timed out, rather than that it failed.
+ *
+ * Stacks report a timeout with any of EWOULDBLOCK, EAGAIN, ETIMEDOUT or, for the RTA stack, ENOMSG.
+ *
+ * @param [in] error A value of `errno`, as from `ccnxPortalStack_GetErrorCode`.
+ *
+ * @return true @p error reports a timeout.
+ * @return false @p error reports a failure, or is 0.
+ *
+ * Example:
+ * @code
+ * {
+ *     CCNxMetaMessage *message = ccnxPortalStack_Receive(stack, CCNxStackTimeout_MicroSeconds(1000));
+ *     if (message == NULL && !ccnxPortalStack_IsTimeoutError(ccnxPortalStack_GetErrorCode(stack))) {
+ *         // The stack failed.
+ *     }
+ * }
+ * @endcode
+ */
+bool ccnxPortalStack_IsTimeoutError(int error);
+
 /**
  * <#One Line Description#>
  *
@@ -368,4 +446,25 @@ PARCProperties *ccnxPortalStack_GetProperties(const CCNxPortalStack *portalStack
  * @endcode
  */
 const char *ccnxPortalStack_GetProperty(const CCNxPortalStack *portalStack, const char *restrict name, const char *restrict defaultValue);
+
+/**
+ * Get the typed configuration snapshot of the factory that created the given `CCNxPortalStack`.
+ *
+ * The stack holds its own reference to the snapshot the factory had when the stack was created,
+ * so the result stays valid for the life of the stack, and later changes to the factory's properties do not affect it.
+ *
+ * @param [in] portalStack A pointer to a valid `CCNxPortalStack` instance.
+ *
+ * @return A pointer to a valid `CCNxPortalConfiguration` instance.
+ *
+ * Example:
+ * @code
+ * {
+ *     const CCNxName *anchorName = ccnxPortalConfiguration_GetAnchorName(ccnxPortalStack_GetConfiguration(portalStack));
+ * }
+ * @endcode
+ *
+ * @see ccnxPortalFactory_GetConfiguration
+ */
+const CCNxPortalConfiguration *ccnxPortalStack_GetConfiguration(const CCNxPortalStack *portalStack);
 #endif
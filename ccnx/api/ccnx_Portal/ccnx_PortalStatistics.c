@@ -0,0 +1,362 @@
+/*
+ * Copyright (c) 2016, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX OR PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ################################################################################
+ * #
+ * # PATENT NOTICE
+ * #
+ * # This software is distributed under the BSD 2-clause License (see LICENSE
+ * # file).  This BSD License does not make any patent claims and as such, does
+ * # not act as a patent grant.  The purpose of this section is for each contributor
+ * # to define their intentions with respect to intellectual property.
+ * #
+ * # Each contributor to this source code is encouraged to state their patent
+ * # claims and licensing mechanisms for any contributions made. At the end of
+ * # this section contributors may each make their own statements.  Contributor's
+ * # claims and grants only apply to the pieces (source code, programs, text,
+ * # media, etc) that they have contributed directly to this software.
+ * #
+ * # There is no guarantee that this section is complete, up to date or accurate. It
+ * # is up to the contributors to maintain their portion of this section and up to
+ * # the user of the software to verify any claims herein.
+ * #
+ * # Do not remove this header notification.  The contents of this section must be
+ * # present in all distributions of the software.  You may only modify your own
+ * # intellectual property statements.  Please provide contact information.
+ *
+ * - Palo Alto Research Center, Inc
+ * This software distribution does not grant any rights to patents owned by Palo
+ * Alto Research Center, Inc (PARC). Rights to these patents are available via
+ * various mechanisms. As of January 2016 PARC has committed to FRAND licensing any
+ * intellectual property used by its contributions to this software. You may
+ * contact PARC at cipo@parc.com for more information or visit http://www.ccnx.org
+ */
+/**
+ * @copyright (c) 2016, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC).  All rights reserved.
+ */
+#include <config.h>
+
+#include <errno.h>
+#include <time.h>
+
+#include <LongBow/runtime.h>
+
+#include <ccnx/api/ccnx_Portal/ccnx_PortalStatistics.h>
+#include <ccnx/api/ccnx_Portal/ccnx_PortalStack.h>
+
+#include <parc/algol/parc_Object.h>
+
+/*
+ * Outstanding Interests are tracked in a fixed, open-addressed table keyed by the hash of the Interest name.
+ * A key of zero marks an empty slot, so every key has its low bit set.
+ */
+#define _pendingSlots 1024
+#define _pendingProbes 8
+
+typedef struct {
+    uint64_t key;
+    uint64_t sendTime;
+} _PendingInterest;
+
+struct CCNxPortalStatistics {
+    uint64_t counters[CCNxPortalStatisticsCounter_Count];
+    CCNxPortalHistogram *histograms[CCNxPortalStatisticsHistogram_Count];
+    _PendingInterest pending[_pendingSlots];
+};
+
+static const char *_counterNames[CCNxPortalStatisticsCounter_Count] = {
+    [CCNxPortalStatisticsCounter_InterestsSent]          = "interestsSent",
+    [CCNxPortalStatisticsCounter_InterestsReceived]      = "interestsReceived",
+    [CCNxPortalStatisticsCounter_ContentObjectsSent]     = "contentObjectsSent",
+    [CCNxPortalStatisticsCounter_ContentObjectsReceived] = "contentObjectsReceived",
+    [CCNxPortalStatisticsCounter_ControlsSent]           = "controlsSent",
+    [CCNxPortalStatisticsCounter_ControlsReceived]       = "controlsReceived",
+    [CCNxPortalStatisticsCounter_NacksSent]              = "nacksSent",
+    [CCNxPortalStatisticsCounter_NacksReceived]          = "nacksReceived",
+    [CCNxPortalStatisticsCounter_BytesSent]              = "bytesSent",
+    [CCNxPortalStatisticsCounter_BytesReceived]          = "bytesReceived",
+    [CCNxPortalStatisticsCounter_SendTimeouts]           = "sendTimeouts",
+    [CCNxPortalStatisticsCounter_ReceiveTimeouts]        = "receiveTimeouts",
+    [CCNxPortalStatisticsCounter_SendErrors]             = "sendErrors",
+    [CCNxPortalStatisticsCounter_ReceiveErrors]          = "receiveErrors",
+};
+
+static const char *_histogramNames[CCNxPortalStatisticsHistogram_Count] = {
+    [CCNxPortalStatisticsHistogram_Send]      = "send",
+    [CCNxPortalStatisticsHistogram_Receive]   = "receive",
+    [CCNxPortalStatisticsHistogram_Listen]    = "listen",
+    [CCNxPortalStatisticsHistogram_Flush]     = "flush",
+    [CCNxPortalStatisticsHistogram_RoundTrip] = "roundTrip",
+};
+
+static void
+_ccnxPortalStatistics_Destroy(CCNxPortalStatistics **statisticsPtr)
+{
+    CCNxPortalStatistics *statistics = *statisticsPtr;
+
+    for (int i = 0; i < CCNxPortalStatisticsHistogram_Count; i++) {
+        if (statistics->histograms[i] != NULL) {
+            ccnxPortalHistogram_Release(&statistics->histograms[i]);
+        }
+    }
+}
+
+parcObject_ExtendPARCObject(CCNxPortalStatistics, _ccnxPortalStatistics_Destroy, NULL, NULL, NULL, NULL, NULL, NULL);
+
+parcObject_ImplementAcquire(ccnxPortalStatistics, CCNxPortalStatistics);
+
+parcObject_ImplementRelease(ccnxPortalStatistics, CCNxPortalStatistics);
+
+CCNxPortalStatistics *
+ccnxPortalStatistics_Create(void)
+{
+    CCNxPortalStatistics *result = parcObject_CreateAndClearInstance(CCNxPortalStatistics);
+    if (result != NULL) {
+        for (int i = 0; i < CCNxPortalStatisticsHistogram_Count; i++) {
+            result->histograms[i] = ccnxPortalHistogram_Create();
+            if (result->histograms[i] == NULL) {
+                ccnxPortalStatistics_Release(&result);
+                break;
+            }
+        }
+    }
+    return result;
+}
+
+uint64_t
+ccnxPortalStatistics_Now(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t) now.tv_sec * 1000000000ULL + (uint64_t) now.tv_nsec;
+}
+
+uint64_t
+ccnxPortalStatistics_GetCounter(const CCNxPortalStatistics *statistics, CCNxPortalStatisticsCounter counter)
+{
+    assertTrue(counter < CCNxPortalStatisticsCounter_Count, "Invalid counter %d", counter);
+    return __atomic_load_n(&statistics->counters[counter], __ATOMIC_RELAXED);
+}
+
+const CCNxPortalHistogram *
+ccnxPortalStatistics_GetHistogram(const CCNxPortalStatistics *statistics, CCNxPortalStatisticsHistogram histogram)
+{
+    assertTrue(histogram < CCNxPortalStatisticsHistogram_Count, "Invalid histogram %d", histogram);
+    return statistics->histograms[histogram];
+}
+
+void
+ccnxPortalStatistics_Reset(CCNxPortalStatistics *statistics)
+{
+    for (int i = 0; i < CCNxPortalStatisticsCounter_Count; i++) {
+        __atomic_store_n(&statistics->counters[i], 0, __ATOMIC_RELAXED);
+    }
+    for (int i = 0; i < CCNxPortalStatisticsHistogram_Count; i++) {
+        ccnxPortalHistogram_Reset(statistics->histograms[i]);
+    }
+    for (int i = 0; i < _pendingSlots; i++) {
+        __atomic_store_n(&statistics->pending[i].key, 0, __ATOMIC_RELAXED);
+    }
+}
+
+void
+ccnxPortalStatistics_Add(CCNxPortalStatistics *statistics, const CCNxPortalStatistics *other)
+{
+    for (int i = 0; i < CCNxPortalStatisticsCounter_Count; i++) {
+        __atomic_fetch_add(&statistics->counters[i], __atomic_load_n(&other->counters[i], __ATOMIC_RELAXED), __ATOMIC_RELAXED);
+    }
+    for (int i = 0; i < CCNxPortalStatisticsHistogram_Count; i++) {
+        ccnxPortalHistogram_Add(statistics->histograms[i], other->histograms[i]);
+    }
+}
+
+static inline void
+_ccnxPortalStatistics_Increment(CCNxPortalStatistics *statistics, CCNxPortalStatisticsCounter counter, uint64_t amount)
+{
+    __atomic_fetch_add(&statistics->counters[counter], amount, __ATOMIC_RELAXED);
+}
+
+static inline uint64_t
+_ccnxPortalStatistics_Key(const CCNxName *name)
+{
+    return ccnxName_HashCode(name) | 1;
+}
+
+/*
+ * Remember when an Interest with the given name was sent.
+ * If all of the probed slots are in use, the first is taken over; its Interest will simply never be matched.
+ */
+static void
+_ccnxPortalStatistics_AddPending(CCNxPortalStatistics *statistics, const CCNxName *name, uint64_t now)
+{
+    uint64_t key = _ccnxPortalStatistics_Key(name);
+    size_t home = (size_t) (key % _pendingSlots);
+
+    for (size_t probe = 0; probe < _pendingProbes; probe++) {
+        _PendingInterest *slot = &statistics->pending[(home + probe) % _pendingSlots];
+        uint64_t expected = 0;
+        if (__atomic_compare_exchange_n(&slot->key, &expected, key, false, __ATOMIC_RELAXED, __ATOMIC_RELAXED)
+            || expected == key) {
+            __atomic_store_n(&slot->sendTime, now, __ATOMIC_RELAXED);
+            return;
+        }
+    }
+
+    _PendingInterest *slot = &statistics->pending[home];
+    __atomic_store_n(&slot->key, key, __ATOMIC_RELAXED);
+    __atomic_store_n(&slot->sendTime, now, __ATOMIC_RELAXED);
+}
+
+/*
+ * Match a response to an outstanding Interest and record the round-trip time.
+ * Under heavy contention an occasional sample may be lost; the counters are never affected.
+ */
+static void
+_ccnxPortalStatistics_MatchPending(CCNxPortalStatistics *statistics, const CCNxName *name, uint64_t now)
+{
+    uint64_t key = _ccnxPortalStatistics_Key(name);
+    size_t home = (size_t) (key % _pendingSlots);
+
+    for (size_t probe = 0; probe < _pendingProbes; probe++) {
+        _PendingInterest *slot = &statistics->pending[(home + probe) % _pendingSlots];
+        uint64_t expected = key;
+        if (__atomic_compare_exchange_n(&slot->key, &expected, 0, false, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+            uint64_t sendTime = __atomic_exchange_n(&slot->sendTime, 0, __ATOMIC_RELAXED);
+            if (sendTime != 0 && now >= sendTime) {
+                ccnxPortalHistogram_Record(statistics->histograms[CCNxPortalStatisticsHistogram_RoundTrip], now - sendTime);
+            }
+            return;
+        }
+    }
+}
+
+static inline size_t
+_ccnxPortalStatistics_PayloadLength(const PARCBuffer *payload)
+{
+    return (payload == NULL) ? 0 : parcBuffer_Remaining(payload);
+}
+
+void
+ccnxPortalStatistics_RecordSend(CCNxPortalStatistics *statistics, const CCNxMetaMessage *message, bool success, int error, uint64_t startTime)
+{
+    if (!success) {
+        _ccnxPortalStatistics_Increment(statistics,
+                                        ccnxPortalStack_IsTimeoutError(error) ? CCNxPortalStatisticsCounter_SendTimeouts : CCNxPortalStatisticsCounter_SendErrors,
+                                        1);
+        return;
+    }
+
+    uint64_t now = ccnxPortalStatistics_Now();
+    ccnxPortalHistogram_Record(statistics->histograms[CCNxPortalStatisticsHistogram_Send], now - startTime);
+
+    if (ccnxMetaMessage_IsInterestReturn(message)) {
+        _ccnxPortalStatistics_Increment(statistics, CCNxPortalStatisticsCounter_NacksSent, 1);
+    } else if (ccnxMetaMessage_IsInterest(message)) {
+        CCNxInterest *interest = ccnxMetaMessage_GetInterest(message);
+        _ccnxPortalStatistics_Increment(statistics, CCNxPortalStatisticsCounter_InterestsSent, 1);
+        _ccnxPortalStatistics_Increment(statistics, CCNxPortalStatisticsCounter_BytesSent,
+                                        _ccnxPortalStatistics_PayloadLength(ccnxInterest_GetPayload(interest)));
+        const CCNxName *name = ccnxInterest_GetName(interest);
+        if (name != NULL) {
+            _ccnxPortalStatistics_AddPending(statistics, name, startTime);
+        }
+    } else if (ccnxMetaMessage_IsContentObject(message)) {
+        CCNxContentObject *contentObject = ccnxMetaMessage_GetContentObject(message);
+        _ccnxPortalStatistics_Increment(statistics, CCNxPortalStatisticsCounter_ContentObjectsSent, 1);
+        _ccnxPortalStatistics_Increment(statistics, CCNxPortalStatisticsCounter_BytesSent,
+                                        _ccnxPortalStatistics_PayloadLength(ccnxContentObject_GetPayload(contentObject)));
+    } else if (ccnxMetaMessage_IsControl(message)) {
+        _ccnxPortalStatistics_Increment(statistics, CCNxPortalStatisticsCounter_ControlsSent, 1);
+    }
+}
+
+void
+ccnxPortalStatistics_RecordReceive(CCNxPortalStatistics *statistics, const CCNxMetaMessage *message, int error, uint64_t startTime)
+{
+    if (message == NULL) {
+        _ccnxPortalStatistics_Increment(statistics,
+                                        ccnxPortalStack_IsTimeoutError(error) ? CCNxPortalStatisticsCounter_ReceiveTimeouts : CCNxPortalStatisticsCounter_ReceiveErrors,
+                                        1);
+        return;
+    }
+
+    uint64_t now = ccnxPortalStatistics_Now();
+    ccnxPortalHistogram_Record(statistics->histograms[CCNxPortalStatisticsHistogram_Receive], now - startTime);
+
+    if (ccnxMetaMessage_IsInterestReturn(message)) {
+        _ccnxPortalStatistics_Increment(statistics, CCNxPortalStatisticsCounter_NacksReceived, 1);
+        // An Interest Return is the returned Interest, so its name is the name of the original Interest.
+        const CCNxName *name = ccnxInterest_GetName(ccnxMetaMessage_GetInterestReturn(message));
+        if (name != NULL) {
+            _ccnxPortalStatistics_MatchPending(statistics, name, now);
+        }
+    } else if (ccnxMetaMessage_IsInterest(message)) {
+        CCNxInterest *interest = ccnxMetaMessage_GetInterest(message);
+        _ccnxPortalStatistics_Increment(statistics, CCNxPortalStatisticsCounter_InterestsReceived, 1);
+        _ccnxPortalStatistics_Increment(statistics, CCNxPortalStatisticsCounter_BytesReceived,
+                                        _ccnxPortalStatistics_PayloadLength(ccnxInterest_GetPayload(interest)));
+    } else if (ccnxMetaMessage_IsContentObject(message)) {
+        CCNxContentObject *contentObject = ccnxMetaMessage_GetContentObject(message);
+        _ccnxPortalStatistics_Increment(statistics, CCNxPortalStatisticsCounter_ContentObjectsReceived, 1);
+        _ccnxPortalStatistics_Increment(statistics, CCNxPortalStatisticsCounter_BytesReceived,
+                                        _ccnxPortalStatistics_PayloadLength(ccnxContentObject_GetPayload(contentObject)));
+        const CCNxName *name = ccnxContentObject_GetName(contentObject);
+        if (name != NULL) {
+            _ccnxPortalStatistics_MatchPending(statistics, name, now);
+        }
+    } else if (ccnxMetaMessage_IsControl(message)) {
+        _ccnxPortalStatistics_Increment(statistics, CCNxPortalStatisticsCounter_ControlsReceived, 1);
+    }
+}
+
+void
+ccnxPortalStatistics_RecordLatency(CCNxPortalStatistics *statistics, CCNxPortalStatisticsHistogram histogram, uint64_t startTime)
+{
+    assertTrue(histogram < CCNxPortalStatisticsHistogram_Count, "Invalid histogram %d", histogram);
+    ccnxPortalHistogram_Record(statistics->histograms[histogram], ccnxPortalStatistics_Now() - startTime);
+}
+
+PARCJSON *
+ccnxPortalStatistics_ToJSON(const CCNxPortalStatistics *statistics)
+{
+    PARCJSON *result = parcJSON_Create();
+
+    PARCJSON *counters = parcJSON_Create();
+    for (int i = 0; i < CCNxPortalStatisticsCounter_Count; i++) {
+        parcJSON_AddInteger(counters, _counterNames[i], (int64_t) ccnxPortalStatistics_GetCounter(statistics, i));
+    }
+    parcJSON_AddObject(result, "counters", counters);
+    parcJSON_Release(&counters);
+
+    PARCJSON *latencies = parcJSON_Create();
+    for (int i = 0; i < CCNxPortalStatisticsHistogram_Count; i++) {
+        PARCJSON *histogram = ccnxPortalHistogram_ToJSON(statistics->histograms[i]);
+        parcJSON_AddObject(latencies, _histogramNames[i], histogram);
+        parcJSON_Release(&histogram);
+    }
+    parcJSON_AddObject(result, "latencies", latencies);
+    parcJSON_Release(&latencies);
+
+    return result;
+}
@@ -0,0 +1,280 @@
+/*
+ * Copyright (c) 2016, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX OR PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ################################################################################
+ * #
+ * # PATENT NOTICE
+ * #
+ * # This software is distributed under the BSD 2-clause License (see LICENSE
+ * # file).  This BSD License does not make any patent claims and as such, does
+ * # not act as a patent grant.  The purpose of this section is for each contributor
+ * # to define their intentions with respect to intellectual property.
+ * #
+ * # Each contributor to this source code is encouraged to state their patent
+ * # claims and licensing mechanisms for any contributions made. At the end of
+ * # this section contributors may each make their own statements.  Contributor's
+ * # claims and grants only apply to the pieces (source code, programs, text,
+ * # media, etc) that they have contributed directly to this software.
+ * #
+ * # There is no guarantee that this section is complete, up to date or accurate. It
+ * # is up to the contributors to maintain their portion of this section and up to
+ * # the user of the software to verify any claims herein.
+ * #
+ * # Do not remove this header notification.  The contents of this section must be
+ * # present in all distributions of the software.  You may only modify your own
+ * # intellectual property statements.  Please provide contact information.
+ *
+ * - Palo Alto Research Center, Inc
+ * This software distribution does not grant any rights to patents owned by Palo
+ * Alto Research Center, Inc (PARC). Rights to these patents are available via
+ * various mechanisms. As of January 2016 PARC has committed to FRAND licensing any
+ * intellectual property used by its contributions to this software. You may
+ * contact PARC at cipo@parc.com for more information or visit http://www.ccnx.org
+ */
+/**
+ * @file ccnx_PortalStatistics.h
+ * @brief Counters and latency histograms for one `CCNxPortal`.
+ *
+ * Every `CCNxPortal` maintains a `CCNxPortalStatistics` instance, available via `ccnxPortal_GetStatistics`.
+ * Counters and histograms are updated with relaxed atomic operations, so a monitoring thread may read them
+ * at any time without locking and without disturbing the threads using the Portal.
+ *
+ * Latencies are recorded in nanoseconds.
+ * The round-trip time is measured from sending an Interest to receiving a Content Object or Interest Return
+ * with the same name. A bounded number of outstanding Interests are tracked; an Interest that is never
+ * answered is eventually displaced by newer Interests.
+ *
+ * @copyright (c) 2016, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC).  All rights reserved.
+ */
+#ifndef CCNx_Portal_API_ccnx_PortalStatistics_h
+#define CCNx_Portal_API_ccnx_PortalStatistics_h
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include <parc/algol/parc_JSON.h>
+
+#include <ccnx/api/ccnx_Portal/ccnx_PortalHistogram.h>
+
+#include <ccnx/transport/common/transport_MetaMessage.h>
+
+struct CCNxPortalStatistics;
+/**
+ * @typedef CCNxPortalStatistics
+ * @brief The counters and latency histograms of a `CCNxPortal`.
+ */
+typedef struct CCNxPortalStatistics CCNxPortalStatistics;
+
+/**
+ * @typedef CCNxPortalStatisticsCounter
+ * @brief The counters maintained for each Portal.
+ */
+typedef enum {
+    CCNxPortalStatisticsCounter_InterestsSent = 0,
+    CCNxPortalStatisticsCounter_InterestsReceived,
+    CCNxPortalStatisticsCounter_ContentObjectsSent,
+    CCNxPortalStatisticsCounter_ContentObjectsReceived,
+    CCNxPortalStatisticsCounter_ControlsSent,
+    CCNxPortalStatisticsCounter_ControlsReceived,
+    CCNxPortalStatisticsCounter_NacksSent,             /**< Interest Returns sent */
+    CCNxPortalStatisticsCounter_NacksReceived,         /**< Interest Returns received */
+    CCNxPortalStatisticsCounter_BytesSent,             /**< Payload bytes of the Interests and Content Objects sent */
+    CCNxPortalStatisticsCounter_BytesReceived,         /**< Payload bytes of the Interests and Content Objects received */
+    CCNxPortalStatisticsCounter_SendTimeouts,
+    CCNxPortalStatisticsCounter_ReceiveTimeouts,
+    CCNxPortalStatisticsCounter_SendErrors,            /**< Failed sends, other than timeouts */
+    CCNxPortalStatisticsCounter_ReceiveErrors,         /**< Failed receives, other than timeouts */
+    CCNxPortalStatisticsCounter_Count
+} CCNxPortalStatisticsCounter;
+
+/**
+ * @typedef CCNxPortalStatisticsHistogram
+ * @brief The latency histograms maintained for each Portal.
+ */
+typedef enum {
+    CCNxPortalStatisticsHistogram_Send = 0,
+    CCNxPortalStatisticsHistogram_Receive,
+    CCNxPortalStatisticsHistogram_Listen,
+    CCNxPortalStatisticsHistogram_Flush,
+    CCNxPortalStatisticsHistogram_RoundTrip,           /**< From sending an Interest to receiving its response */
+    CCNxPortalStatisticsHistogram_Count
+} CCNxPortalStatisticsHistogram;
+
+/**
+ * Create a new `CCNxPortalStatistics` instance with all counters zero and all histograms empty.
+ *
+ * @return non-NULL A pointer to a valid `CCNxPortalStatistics` instance.
+ * @return NULL Memory could not be allocated.
+ *
+ * Example:
+ * @code
+ * {
+ *     CCNxPortalStatistics *statistics = ccnxPortalStatistics_Create();
+ *
+ *     ccnxPortalStatistics_Release(&statistics);
+ * }
+ * @endcode
+ */
+CCNxPortalStatistics *ccnxPortalStatistics_Create(void);
+
+/**
+ * Increase the number of references to a `CCNxPortalStatistics` instance.
+ *
+ * @param [in] statistics A pointer to a valid `CCNxPortalStatistics` instance.
+ *
+ * @return The value of @p statistics.
+ */
+CCNxPortalStatistics *ccnxPortalStatistics_Acquire(const CCNxPortalStatistics *statistics);
+
+/**
+ * Release a previously acquired reference to the specified instance,
+ * decrementing the reference count for the instance.
+ *
+ * @param [in,out] statisticsPtr A pointer to a pointer to the instance to release.
+ */
+void ccnxPortalStatistics_Release(CCNxPortalStatistics **statisticsPtr);
+
+/**
+ * Get the current value of a counter.
+ *
+ * @param [in] statistics A pointer to a valid `CCNxPortalStatistics` instance.
+ * @param [in] counter The counter to read.
+ *
+ * @return The value of the counter.
+ *
+ * Example:
+ * @code
+ * {
+ *     const CCNxPortalStatistics *statistics = ccnxPortal_GetStatistics(portal);
+ *     uint64_t sent = ccnxPortalStatistics_GetCounter(statistics, CCNxPortalStatisticsCounter_InterestsSent);
+ * }
+ * @endcode
+ */
+uint64_t ccnxPortalStatistics_GetCounter(const CCNxPortalStatistics *statistics, CCNxPortalStatisticsCounter counter);
+
+/**
+ * Get one of the latency histograms.
+ *
+ * @param [in] statistics A pointer to a valid `CCNxPortalStatistics` instance.
+ * @param [in] histogram The histogram to get.
+ *
+ * @return A pointer to the histogram, valid for the lifetime of @p statistics.
+ *
+ * Example:
+ * @code
+ * {
+ *     const CCNxPortalStatistics *statistics = ccnxPortal_GetStatistics(portal);
+ *     const CCNxPortalHistogram *rtt = ccnxPortalStatistics_GetHistogram(statistics, CCNxPortalStatisticsHistogram_RoundTrip);
+ *     uint64_t p99 = ccnxPortalHistogram_GetValueAtPercentile(rtt, 99.0);
+ * }
+ * @endcode
+ */
+const CCNxPortalHistogram *ccnxPortalStatistics_GetHistogram(const CCNxPortalStatistics *statistics, CCNxPortalStatisticsHistogram histogram);
+
+/**
+ * Reset all counters to zero and empty all histograms.
+ *
+ * @param [in] statistics A pointer to a valid `CCNxPortalStatistics` instance.
+ */
+void ccnxPortalStatistics_Reset(CCNxPortalStatistics *statistics);
+
+/**
+ * Add the counters and histograms of @p other to those of @p statistics.
+ *
+ * Used to combine the statistics of several Portals, such as the shards of a `CCNxPortalShards`, into one view.
+ * Outstanding Interests awaiting a response are not carried over.
+ *
+ * @param [in] statistics A pointer to a valid `CCNxPortalStatistics` instance.
+ * @param [in] other A pointer to a valid `CCNxPortalStatistics` instance.
+ *
+ * Example:
+ * @code
+ * {
+ *     CCNxPortalStatistics *total = ccnxPortalStatistics_Create();
+ *     ccnxPortalStatistics_Add(total, ccnxPortal_GetStatistics(portalA));
+ *     ccnxPortalStatistics_Add(total, ccnxPortal_GetStatistics(portalB));
+ *
+ *     ccnxPortalStatistics_Release(&total);
+ * }
+ * @endcode
+ */
+void ccnxPortalStatistics_Add(CCNxPortalStatistics *statistics, const CCNxPortalStatistics *other);
+
+/**
+ * The current time in nanoseconds from a monotonic clock, used to measure latencies.
+ *
+ * @return The current monotonic time in nanoseconds.
+ */
+uint64_t ccnxPortalStatistics_Now(void);
+
+/**
+ * Account for an attempt to send a message.
+ *
+ * @param [in] statistics A pointer to a valid `CCNxPortalStatistics` instance.
+ * @param [in] message The message sent.
+ * @param [in] success The result of the send.
+ * @param [in] error The value of `errno` if the send failed.
+ * @param [in] startTime The value of `ccnxPortalStatistics_Now()` before the send.
+ */
+void ccnxPortalStatistics_RecordSend(CCNxPortalStatistics *statistics, const CCNxMetaMessage *message, bool success, int error, uint64_t startTime);
+
+/**
+ * Account for an attempt to receive a message.
+ *
+ * @param [in] statistics A pointer to a valid `CCNxPortalStatistics` instance.
+ * @param [in] message The message received, or NULL.
+ * @param [in] error The value of `errno` if no message was received.
+ * @param [in] startTime The value of `ccnxPortalStatistics_Now()` before the receive.
+ */
+void ccnxPortalStatistics_RecordReceive(CCNxPortalStatistics *statistics, const CCNxMetaMessage *message, int error, uint64_t startTime);
+
+/**
+ * Record the latency of an operation in the given histogram.
+ *
+ * @param [in] statistics A pointer to a valid `CCNxPortalStatistics` instance.
+ * @param [in] histogram The histogram to record into.
+ * @param [in] startTime The value of `ccnxPortalStatistics_Now()` before the operation.
+ */
+void ccnxPortalStatistics_RecordLatency(CCNxPortalStatistics *statistics, CCNxPortalStatisticsHistogram histogram, uint64_t startTime);
+
+/**
+ * Create a `PARCJSON` representation of all counters and histograms.
+ *
+ * @param [in] statistics A pointer to a valid `CCNxPortalStatistics` instance.
+ *
+ * @return A `PARCJSON` instance that must be released via `parcJSON_Release`.
+ *
+ * Example:
+ * @code
+ * {
+ *     PARCJSON *json = ccnxPortalStatistics_ToJSON(ccnxPortal_GetStatistics(portal));
+ *     char *string = parcJSON_ToString(json);
+ *     printf("%s\n", string);
+ *     parcMemory_Deallocate(&string);
+ *     parcJSON_Release(&json);
+ * }
+ * @endcode
+ */
+PARCJSON *ccnxPortalStatistics_ToJSON(const CCNxPortalStatistics *statistics);
+#endif // CCNx_Portal_API_ccnx_PortalStatistics_h
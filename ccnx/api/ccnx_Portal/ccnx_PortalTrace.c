@@ -0,0 +1,390 @@
+/*
+ * Copyright (c) 2016, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX OR PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ################################################################################
+ * #
+ * # PATENT NOTICE
+ * #
+ * # This software is distributed under the BSD 2-clause License (see LICENSE
+ * # file).  This BSD License does not make any patent claims and as such, does
+ * # not act as a patent grant.  The purpose of this section is for each contributor
+ * # to define their intentions with respect to intellectual property.
+ * #
+ * # Each contributor to this source code is encouraged to state their patent
+ * # claims and licensing mechanisms for any contributions made. At the end of
+ * # this section contributors may each make their own statements.  Contributor's
+ * # claims and grants only apply to the pieces (source code, programs, text,
+ * # media, etc) that they have contributed directly to this software.
+ * #
+ * # There is no guarantee that this section is complete, up to date or accurate. It
+ * # is up to the contributors to maintain their portion of this section and up to
+ * # the user of the software to verify any claims herein.
+ * #
+ * # Do not remove this header notification.  The contents of this section must be
+ * # present in all distributions of the software.  You may only modify your own
+ * # intellectual property statements.  Please provide contact information.
+ *
+ * - Palo Alto Research Center, Inc
+ * This software distribution does not grant any rights to patents owned by Palo
+ * Alto Research Center, Inc (PARC). Rights to these patents are available via
+ * various mechanisms. As of January 2016 PARC has committed to FRAND licensing any
+ * intellectual property used by its contributions to this software. You may
+ * contact PARC at cipo@parc.com for more information or visit http://www.ccnx.org
+ */
+/**
+ * @copyright (c) 2016, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC).  All rights reserved.
+ */
+#include <config.h>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <time.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include <LongBow/runtime.h>
+
+#include <ccnx/api/ccnx_Portal/ccnx_PortalTrace.h>
+
+#include <parc/algol/parc_Object.h>
+#include <parc/algol/parc_Buffer.h>
+
+#include <ccnx/transport/common/transport_MetaMessage.h>
+
+const char *CCNxPortalTrace_RecordFile = "/localstack/portalTrace/RecordFile";
+
+#define _ccnxPortalTrace_Magic 0x43435452    // "CCTR"
+#define _ccnxPortalTrace_Version 1
+#define _ccnxPortalTrace_FileHeaderLength 8
+#define _ccnxPortalTrace_RecordHeaderLength 13  // length(4) timestamp(8) direction(1)
+#define _ccnxPortalTrace_InitialCapacity (1024 * 1024)
+
+struct CCNxPortalTrace {
+    int fd;
+    bool writer;
+    uint8_t *map;
+    size_t capacity;
+    size_t position;
+    uint64_t count;
+    pthread_mutex_t mutex;
+};
+
+static void
+_ccnxPortalTrace_PutUint32(uint8_t *p, uint32_t value)
+{
+    p[0] = (uint8_t) (value >> 24);
+    p[1] = (uint8_t) (value >> 16);
+    p[2] = (uint8_t) (value >> 8);
+    p[3] = (uint8_t) value;
+}
+
+static void
+_ccnxPortalTrace_PutUint64(uint8_t *p, uint64_t value)
+{
+    _ccnxPortalTrace_PutUint32(p, (uint32_t) (value >> 32));
+    _ccnxPortalTrace_PutUint32(p + 4, (uint32_t) value);
+}
+
+static uint32_t
+_ccnxPortalTrace_GetUint32(const uint8_t *p)
+{
+    return ((uint32_t) p[0] << 24) | ((uint32_t) p[1] << 16) | ((uint32_t) p[2] << 8) | (uint32_t) p[3];
+}
+
+static uint64_t
+_ccnxPortalTrace_GetUint64(const uint8_t *p)
+{
+    return ((uint64_t) _ccnxPortalTrace_GetUint32(p) << 32) | _ccnxPortalTrace_GetUint32(p + 4);
+}
+
+static void
+_ccnxPortalTrace_Destroy(CCNxPortalTrace **tracePtr)
+{
+    CCNxPortalTrace *trace = *tracePtr;
+
+    if (trace->map != NULL) {
+        munmap(trace->map, trace->capacity);
+    }
+    if (trace->fd >= 0) {
+        if (trace->writer) {
+            // Trim the preallocated, unused tail of the file.
+            // If this fails the tail remains zero-filled, which a reader treats as the end of the trace.
+            if (ftruncate(trace->fd, (off_t) trace->position) != 0) {
+                close(trace->fd);
+                trace->fd = -1;
+            }
+        }
+        if (trace->fd >= 0) {
+            close(trace->fd);
+        }
+    }
+    pthread_mutex_destroy(&trace->mutex);
+}
+
+parcObject_ExtendPARCObject(CCNxPortalTrace, _ccnxPortalTrace_Destroy, NULL, NULL, NULL, NULL, NULL, NULL);
+
+parcObject_ImplementAcquire(ccnxPortalTrace, CCNxPortalTrace);
+
+parcObject_ImplementRelease(ccnxPortalTrace, CCNxPortalTrace);
+
+static CCNxPortalTrace *
+_ccnxPortalTrace_Create(int fd, bool writer)
+{
+    CCNxPortalTrace *result = parcObject_CreateInstance(CCNxPortalTrace);
+    if (result != NULL) {
+        result->fd = fd;
+        result->writer = writer;
+        result->map = NULL;
+        result->capacity = 0;
+        result->position = _ccnxPortalTrace_FileHeaderLength;
+        result->count = 0;
+        pthread_mutex_init(&result->mutex, NULL);
+    } else {
+        close(fd);
+    }
+    return result;
+}
+
+/*
+ * Extend the backing file and map it again so that at least `required` bytes are available.
+ * The caller must hold the trace mutex.
+ */
+static bool
+_ccnxPortalTrace_Reserve(CCNxPortalTrace *trace, size_t required)
+{
+    if (required <= trace->capacity) {
+        return true;
+    }
+
+    size_t capacity = (trace->capacity == 0) ? _ccnxPortalTrace_InitialCapacity : trace->capacity;
+    while (capacity < required) {
+        capacity *= 2;
+    }
+
+    if (ftruncate(trace->fd, (off_t) capacity) != 0) {
+        return false;
+    }
+
+    uint8_t *map = mmap(NULL, capacity, PROT_READ | PROT_WRITE, MAP_SHARED, trace->fd, 0);
+    if (map == MAP_FAILED) {
+        return false;
+    }
+
+    if (trace->map != NULL) {
+        munmap(trace->map, trace->capacity);
+    }
+    trace->map = map;
+    trace->capacity = capacity;
+    return true;
+}
+
+CCNxPortalTrace *
+ccnxPortalTrace_CreateWriter(const char *fileName)
+{
+    int fd = open(fileName, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        return NULL;
+    }
+
+    CCNxPortalTrace *result = _ccnxPortalTrace_Create(fd, true);
+    if (result != NULL) {
+        if (_ccnxPortalTrace_Reserve(result, _ccnxPortalTrace_FileHeaderLength)) {
+            _ccnxPortalTrace_PutUint32(result->map, _ccnxPortalTrace_Magic);
+            _ccnxPortalTrace_PutUint32(result->map + 4, _ccnxPortalTrace_Version << 16);
+        } else {
+            int savedErrno = errno;
+            result->position = 0;
+            ccnxPortalTrace_Release(&result);
+            errno = savedErrno;
+        }
+    }
+    return result;
+}
+
+CCNxPortalTrace *
+ccnxPortalTrace_CreateReader(const char *fileName)
+{
+    int fd = open(fileName, O_RDONLY);
+    if (fd < 0) {
+        return NULL;
+    }
+
+    struct stat statBuffer;
+    if (fstat(fd, &statBuffer) != 0 || statBuffer.st_size < _ccnxPortalTrace_FileHeaderLength) {
+        close(fd);
+        errno = EINVAL;
+        return NULL;
+    }
+
+    CCNxPortalTrace *result = _ccnxPortalTrace_Create(fd, false);
+    if (result != NULL) {
+        void *map = mmap(NULL, (size_t) statBuffer.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (map != MAP_FAILED) {
+            result->map = map;
+            result->capacity = (size_t) statBuffer.st_size;
+        }
+
+        if (result->map == NULL
+            || _ccnxPortalTrace_GetUint32(result->map) != _ccnxPortalTrace_Magic
+            || (_ccnxPortalTrace_GetUint32(result->map + 4) >> 16) != _ccnxPortalTrace_Version) {
+            ccnxPortalTrace_Release(&result);
+            errno = EINVAL;
+        }
+    }
+    return result;
+}
+
+bool
+ccnxPortalTrace_Append(CCNxPortalTrace *trace, CCNxPortalTraceDirection direction, uint64_t timestamp, const CCNxMetaMessage *message)
+{
+    PARCBuffer *wireFormat = ccnxMetaMessage_CreateWireFormatBuffer((CCNxMetaMessage *) message, NULL);
+    if (wireFormat == NULL) {
+        errno = EINVAL;
+        return false;
+    }
+
+    size_t length = parcBuffer_Remaining(wireFormat);
+    size_t recordLength = _ccnxPortalTrace_RecordHeaderLength + length;
+
+    pthread_mutex_lock(&trace->mutex);
+
+    bool result = _ccnxPortalTrace_Reserve(trace, trace->position + recordLength);
+    if (result) {
+        uint8_t *record = trace->map + trace->position;
+        _ccnxPortalTrace_PutUint32(record, (uint32_t) recordLength);
+        _ccnxPortalTrace_PutUint64(record + 4, timestamp);
+        record[12] = (uint8_t) direction;
+        parcBuffer_GetBytes(wireFormat, length, record + _ccnxPortalTrace_RecordHeaderLength);
+
+        trace->position += recordLength;
+        trace->count++;
+    }
+
+    pthread_mutex_unlock(&trace->mutex);
+
+    parcBuffer_Release(&wireFormat);
+    return result;
+}
+
+CCNxMetaMessage *
+ccnxPortalTrace_Next(CCNxPortalTrace *trace, CCNxPortalTraceDirection *direction, uint64_t *timestamp)
+{
+    CCNxMetaMessage *result = NULL;
+
+    pthread_mutex_lock(&trace->mutex);
+
+    size_t remaining = trace->capacity - trace->position;
+    if (remaining >= _ccnxPortalTrace_RecordHeaderLength) {
+        const uint8_t *record = trace->map + trace->position;
+        size_t recordLength = _ccnxPortalTrace_GetUint32(record);
+
+        if (recordLength >= _ccnxPortalTrace_RecordHeaderLength && recordLength <= remaining) {
+            if (direction != NULL) {
+                *direction = (CCNxPortalTraceDirection) record[12];
+            }
+            if (timestamp != NULL) {
+                *timestamp = _ccnxPortalTrace_GetUint64(record + 4);
+            }
+
+            // The decoded message may outlive the mapping, so it gets its own copy of the wire format.
+            PARCBuffer *wireFormat = parcBuffer_CreateFromArray(record + _ccnxPortalTrace_RecordHeaderLength,
+                                                                recordLength - _ccnxPortalTrace_RecordHeaderLength);
+            parcBuffer_Flip(wireFormat);
+            result = ccnxMetaMessage_CreateFromWireFormatBuffer(wireFormat);
+            parcBuffer_Release(&wireFormat);
+
+            trace->position += recordLength;
+            trace->count++;
+        }
+    }
+
+    pthread_mutex_unlock(&trace->mutex);
+
+    return result;
+}
+
+void
+ccnxPortalTrace_Rewind(CCNxPortalTrace *trace)
+{
+    pthread_mutex_lock(&trace->mutex);
+    if (!trace->writer) {
+        trace->position = _ccnxPortalTrace_FileHeaderLength;
+        trace->count = 0;
+    }
+    pthread_mutex_unlock(&trace->mutex);
+}
+
+uint64_t
+ccnxPortalTrace_GetCount(const CCNxPortalTrace *trace)
+{
+    return trace->count;
+}
+
+uint64_t
+ccnxPortalTrace_Now(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_REALTIME, &now);
+    return (uint64_t) now.tv_sec * 1000000000ULL + (uint64_t) now.tv_nsec;
+}
+
+static bool
+_ccnxPortalTraceRecorder_Send(void *state, const CCNxPortalInterceptor *next, const CCNxMetaMessage *message, const CCNxStackTimeout *microSeconds)
+{
+    CCNxPortalTrace *trace = state;
+
+    uint64_t timestamp = ccnxPortalTrace_Now();
+    bool result = ccnxPortalInterceptor_Send(next, message, microSeconds);
+    if (result) {
+        int savedErrno = errno;
+        ccnxPortalTrace_Append(trace, CCNxPortalTraceDirection_Send, timestamp, message);
+        errno = savedErrno;
+    }
+    return result;
+}
+
+static CCNxMetaMessage *
+_ccnxPortalTraceRecorder_Receive(void *state, const CCNxPortalInterceptor *next, const CCNxStackTimeout *microSeconds)
+{
+    CCNxPortalTrace *trace = state;
+
+    CCNxMetaMessage *result = ccnxPortalInterceptor_Receive(next, microSeconds);
+    if (result != NULL) {
+        ccnxPortalTrace_Append(trace, CCNxPortalTraceDirection_Receive, ccnxPortalTrace_Now(), result);
+    }
+    return result;
+}
+
+CCNxPortalInterceptor *
+ccnxPortalTrace_CreateInterceptor(CCNxPortalTrace *trace)
+{
+    return ccnxPortalInterceptor_Create(_ccnxPortalTraceRecorder_Send,
+                                        _ccnxPortalTraceRecorder_Receive,
+                                        NULL,
+                                        NULL,
+                                        ccnxPortalTrace_Acquire(trace),
+                                        (void (*)(void **))ccnxPortalTrace_Release);
+}
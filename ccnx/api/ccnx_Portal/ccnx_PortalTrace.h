@@ -0,0 +1,250 @@
+/*
+ * Copyright (c) 2016, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX OR PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ################################################################################
+ * #
+ * # PATENT NOTICE
+ * #
+ * # This software is distributed under the BSD 2-clause License (see LICENSE
+ * # file).  This BSD License does not make any patent claims and as such, does
+ * # not act as a patent grant.  The purpose of this section is for each contributor
+ * # to define their intentions with respect to intellectual property.
+ * #
+ * # Each contributor to this source code is encouraged to state their patent
+ * # claims and licensing mechanisms for any contributions made. At the end of
+ * # this section contributors may each make their own statements.  Contributor's
+ * # claims and grants only apply to the pieces (source code, programs, text,
+ * # media, etc) that they have contributed directly to this software.
+ * #
+ * # There is no guarantee that this section is complete, up to date or accurate. It
+ * # is up to the contributors to maintain their portion of this section and up to
+ * # the user of the software to verify any claims herein.
+ * #
+ * # Do not remove this header notification.  The contents of this section must be
+ * # present in all distributions of the software.  You may only modify your own
+ * # intellectual property statements.  Please provide contact information.
+ *
+ * - Palo Alto Research Center, Inc
+ * This software distribution does not grant any rights to patents owned by Palo
+ * Alto Research Center, Inc (PARC). Rights to these patents are available via
+ * various mechanisms. As of January 2016 PARC has committed to FRAND licensing any
+ * intellectual property used by its contributions to this software. You may
+ * contact PARC at cipo@parc.com for more information or visit http://www.ccnx.org
+ */
+/**
+ * @file ccnx_PortalTrace.h
+ * @brief A memory-mapped trace of the messages sent and received by a `CCNxPortal`.
+ *
+ * A trace file is a short file header followed by a sequence of length-prefixed records.
+ * Each record carries a nanosecond timestamp, the direction of the message (sent or received)
+ * and the message itself in its TLV wire format.
+ * All integers are stored in network byte order.
+ *
+ * @code
+ *     file   := magic(4) version(2) reserved(2) record*
+ *     record := length(4) timestamp(8) direction(1) wire-format(length - 9)
+ * @endcode
+ *
+ * Recording is enabled for any `CCNxPortal` by setting the `CCNxPortalFactory` property
+ * named by `CCNxPortalTrace_RecordFile` to the name of the trace file to create.
+ * A trace can be fed back into `ccnxPortal_Receive` by the stacks in {@link ccnx_PortalReplay.h}.
+ *
+ * @copyright (c) 2016, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC).  All rights reserved.
+ */
+#ifndef CCNx_Portal_API_ccnx_PortalTrace_h
+#define CCNx_Portal_API_ccnx_PortalTrace_h
+
+struct CCNxPortalTrace;
+/**
+ * @typedef CCNxPortalTrace
+ * @brief A memory-mapped trace file open for either writing or reading.
+ */
+typedef struct CCNxPortalTrace CCNxPortalTrace;
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include <ccnx/api/ccnx_Portal/ccnx_PortalInterceptor.h>
+
+/**
+ * The name of the `CCNxPortalFactory` property containing the name of the file
+ * to record the traffic of each new `CCNxPortal`.
+ */
+extern const char *CCNxPortalTrace_RecordFile;
+
+/**
+ * @typedef CCNxPortalTraceDirection
+ * @brief Whether a traced message was sent or received by the Portal.
+ */
+typedef enum {
+    CCNxPortalTraceDirection_Send = 0,
+    CCNxPortalTraceDirection_Receive = 1
+} CCNxPortalTraceDirection;
+
+/**
+ * Create a new, empty trace file for writing.
+ *
+ * An existing file with the same name is truncated.
+ * The file is extended and remapped as records are appended,
+ * and trimmed to the length of the recorded data when the instance is released.
+ *
+ * @param [in] fileName The name of the trace file to create.
+ *
+ * @return non-NULL A pointer to a valid `CCNxPortalTrace` instance.
+ * @return NULL The file could not be created or mapped. See the value of `errno`.
+ *
+ * Example:
+ * @code
+ * {
+ *     CCNxPortalTrace *trace = ccnxPortalTrace_CreateWriter("/tmp/portal.trace");
+ *
+ *     ccnxPortalTrace_Append(trace, CCNxPortalTraceDirection_Send, ccnxPortalTrace_Now(), message);
+ *
+ *     ccnxPortalTrace_Release(&trace);
+ * }
+ * @endcode
+ */
+CCNxPortalTrace *ccnxPortalTrace_CreateWriter(const char *fileName);
+
+/**
+ * Open an existing trace file for reading.
+ *
+ * @param [in] fileName The name of the trace file to open.
+ *
+ * @return non-NULL A pointer to a valid `CCNxPortalTrace` instance.
+ * @return NULL The file could not be opened, mapped, or is not a trace file. See the value of `errno`.
+ *
+ * Example:
+ * @code
+ * {
+ *     CCNxPortalTrace *trace = ccnxPortalTrace_CreateReader("/tmp/portal.trace");
+ *
+ *     CCNxPortalTraceDirection direction;
+ *     uint64_t timestamp;
+ *     CCNxMetaMessage *message;
+ *     while ((message = ccnxPortalTrace_Next(trace, &direction, &timestamp)) != NULL) {
+ *         ccnxMetaMessage_Release(&message);
+ *     }
+ *
+ *     ccnxPortalTrace_Release(&trace);
+ * }
+ * @endcode
+ */
+CCNxPortalTrace *ccnxPortalTrace_CreateReader(const char *fileName);
+
+/**
+ * Increase the number of references to a `CCNxPortalTrace` instance.
+ *
+ * @param [in] trace A pointer to a valid `CCNxPortalTrace` instance.
+ *
+ * @return The value of @p trace.
+ */
+CCNxPortalTrace *ccnxPortalTrace_Acquire(const CCNxPortalTrace *trace);
+
+/**
+ * Release a previously acquired reference to the specified instance,
+ * decrementing the reference count for the instance.
+ *
+ * When the last reference is released a writer is trimmed to its recorded length, and the file is unmapped and closed.
+ *
+ * @param [in,out] tracePtr A pointer to a pointer to the instance to release.
+ */
+void ccnxPortalTrace_Release(CCNxPortalTrace **tracePtr);
+
+/**
+ * Append a message to a trace open for writing.
+ *
+ * This function is safe to call from multiple threads.
+ *
+ * @param [in] trace A pointer to a valid `CCNxPortalTrace` instance created by `ccnxPortalTrace_CreateWriter`.
+ * @param [in] direction Whether the message was sent or received.
+ * @param [in] timestamp The time, in nanoseconds, of the event.
+ * @param [in] message A pointer to a valid `CCNxMetaMessage` instance.
+ *
+ * @return `true` The message was appended.
+ * @return `false` The message could not be encoded or the file could not be extended. See the value of `errno`.
+ */
+bool ccnxPortalTrace_Append(CCNxPortalTrace *trace, CCNxPortalTraceDirection direction, uint64_t timestamp, const CCNxMetaMessage *message);
+
+/**
+ * Decode the next message from a trace open for reading.
+ *
+ * @param [in] trace A pointer to a valid `CCNxPortalTrace` instance created by `ccnxPortalTrace_CreateReader`.
+ * @param [out] direction If not NULL, set to the direction of the message.
+ * @param [out] timestamp If not NULL, set to the recorded time of the message in nanoseconds.
+ *
+ * @return non-NULL A `CCNxMetaMessage` that must be released via `ccnxMetaMessage_Release`.
+ * @return NULL The end of the trace was reached, or the trace is corrupt.
+ */
+CCNxMetaMessage *ccnxPortalTrace_Next(CCNxPortalTrace *trace, CCNxPortalTraceDirection *direction, uint64_t *timestamp);
+
+/**
+ * Reposition a trace open for reading at its first record.
+ *
+ * @param [in] trace A pointer to a valid `CCNxPortalTrace` instance.
+ */
+void ccnxPortalTrace_Rewind(CCNxPortalTrace *trace);
+
+/**
+ * Get the number of records appended to, or read from, the given trace.
+ *
+ * @param [in] trace A pointer to a valid `CCNxPortalTrace` instance.
+ *
+ * @return The number of records processed so far.
+ */
+uint64_t ccnxPortalTrace_GetCount(const CCNxPortalTrace *trace);
+
+/**
+ * The current wall-clock time in nanoseconds, suitable as a record timestamp.
+ *
+ * @return The number of nanoseconds since the Epoch.
+ */
+uint64_t ccnxPortalTrace_Now(void);
+
+/**
+ * Create a `CCNxPortalInterceptor` that records all messages sent and received through the layers below it.
+ *
+ * Every message successfully sent and every message received is appended to the trace.
+ * The interceptor holds a reference to @p trace.
+ *
+ * @param [in] trace A pointer to a valid `CCNxPortalTrace` instance created by `ccnxPortalTrace_CreateWriter`.
+ *
+ * @return non-NULL A pointer to a valid `CCNxPortalInterceptor` instance.
+ * @return NULL Memory could not be allocated.
+ *
+ * Example:
+ * @code
+ * {
+ *     CCNxPortalTrace *trace = ccnxPortalTrace_CreateWriter("/tmp/portal.trace");
+ *     CCNxPortalInterceptor *recorder = ccnxPortalTrace_CreateInterceptor(trace);
+ *
+ *     ccnxPortal_AddInterceptor(portal, recorder);
+ *
+ *     ccnxPortalInterceptor_Release(&recorder);
+ *     ccnxPortalTrace_Release(&trace);
+ * }
+ * @endcode
+ */
+CCNxPortalInterceptor *ccnxPortalTrace_CreateInterceptor(CCNxPortalTrace *trace);
+#endif // CCNx_Portal_API_ccnx_PortalTrace_h
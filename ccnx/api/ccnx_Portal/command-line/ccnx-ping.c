@@ -0,0 +1,660 @@
+/*
+ * Copyright (c) 2016, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX OR PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ################################################################################
+ * #
+ * # PATENT NOTICE
+ * #
+ * # This software is distributed under the BSD 2-clause License (see LICENSE
+ * # file).  This BSD License does not make any patent claims and as such, does
+ * # not act as a patent grant.  The purpose of this section is for each contributor
+ * # to define their intentions with respect to intellectual property.
+ * #
+ * # Each contributor to this source code is encouraged to state their patent
+ * # claims and licensing mechanisms for any contributions made. At the end of
+ * # this section contributors may each make their own statements.  Contributor's
+ * # claims and grants only apply to the pieces (source code, programs, text,
+ * # media, etc) that they have contributed directly to this software.
+ * #
+ * # There is no guarantee that this section is complete, up to date or accurate. It
+ * # is up to the contributors to maintain their portion of this section and up to
+ * # the user of the software to verify any claims herein.
+ * #
+ * # Do not remove this header notification.  The contents of this section must be
+ * # present in all distributions of the software.  You may only modify your own
+ * # intellectual property statements.  Please provide contact information.
+ *
+ * - Palo Alto Research Center, Inc
+ * This software distribution does not grant any rights to patents owned by Palo
+ * Alto Research Center, Inc (PARC). Rights to these patents are available via
+ * various mechanisms. As of January 2016 PARC has committed to FRAND licensing any
+ * intellectual property used by its contributions to this software. You may
+ * contact PARC at cipo@parc.com for more information or visit http://www.ccnx.org
+ */
+/**
+ * Measure the Interest to Content Object round trip through a portal.
+ *
+ * `ccnx-ping --server lci:/prefix` answers Interests for lci:/prefix/chunk=N, for N below the number of slots,
+ * with Content Objects that were built, encoded and signed once at start-up.
+ * Answering an Interest sends one of those messages again, so the responder does no per-request allocation or signing.
+ * The Content Objects carry an expiry time in the past, so no Content Store answers a later ping on their behalf.
+ *
+ * `ccnx-ping lci:/prefix` sends Interests for the slots in turn, either one per interval or, with --flood,
+ * as fast as the outstanding limit allows. The send time of each Interest is kept with its slot.
+ *
+ * The client can also answer its own Interests over a loopback stack, which isolates the cost of the layers:
+ * `--stack api` measures the portal alone, `--stack rta-loopback` adds the transport stack,
+ * and the default `--stack rta` goes through the forwarder to a `--server`.
+ *
+ * @copyright (c) 2016, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC).  All rights reserved.
+ */
+#include <config.h>
+
+#include <errno.h>
+#include <getopt.h>
+#include <math.h>
+#include <signal.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <LongBow/runtime.h>
+
+#include <ccnx/api/ccnx_Portal/ccnx_Portal.h>
+#include <ccnx/api/ccnx_Portal/ccnx_PortalAPI.h>
+#include <ccnx/api/ccnx_Portal/ccnx_PortalRTA.h>
+#include <ccnx/api/ccnx_Portal/ccnx_PortalHistogram.h>
+
+#include <parc/algol/parc_Buffer.h>
+#include <parc/algol/parc_Memory.h>
+#include <parc/security/parc_Security.h>
+#include <parc/security/parc_IdentityFile.h>
+
+#include <ccnx/common/ccnx_Name.h>
+#include <ccnx/common/ccnx_NameSegmentNumber.h>
+#include <ccnx/common/ccnx_ContentObject.h>
+#include <ccnx/common/ccnx_Interest.h>
+
+typedef enum {
+    PingStack_RTA,
+    PingStack_RTALoopBack,
+    PingStack_API
+} PingStack;
+
+/**
+ * The configuration of the client or the responder.
+ */
+typedef struct {
+    bool server;
+    PingStack stack;
+    size_t slots;                  // The number of distinct names, and the limit on outstanding Interests.
+    size_t payloadSize;            // The size of the responder's payloads.
+    unsigned int count;            // The number of Interests to send. Zero sends until interrupted.
+    uint64_t intervalMicroSeconds;
+    uint64_t timeoutMicroSeconds;
+    bool flood;
+    unsigned int outstanding;      // With --flood, the number of Interests kept outstanding.
+    bool quiet;
+} PingOptions;
+
+extern int ccnPing(const PARCIdentity *identity, const CCNxName *prefix, const PingOptions *options);
+extern void usage(void);
+
+static volatile sig_atomic_t _interrupted = 0;
+
+static void
+_ping_Interrupt(int signal)
+{
+    _interrupted = 1;
+}
+
+static uint64_t
+_nanoTime(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t) now.tv_sec * 1000000000ULL + (uint64_t) now.tv_nsec;
+}
+
+static CCNxName *
+_ping_CreateSlotName(const CCNxName *prefix, uint64_t slot)
+{
+    CCNxName *result = ccnxName_Copy(prefix);
+    CCNxNameSegment *segment = ccnxNameSegmentNumber_Create(CCNxNameLabelType_CHUNK, slot);
+    ccnxName_Append(result, segment);
+    ccnxNameSegment_Release(&segment);
+    return result;
+}
+
+/*
+ * Return the slot named by @p name, or -1 if @p name is not prefix/chunk=N with N below the number of slots.
+ */
+static int64_t
+_ping_Slot(const CCNxName *prefix, const CCNxName *name, size_t slots)
+{
+    size_t prefixCount = ccnxName_GetSegmentCount(prefix);
+    if (name == NULL || ccnxName_GetSegmentCount(name) != prefixCount + 1 || !ccnxName_StartsWith(name, prefix)) {
+        return -1;
+    }
+    CCNxNameSegment *segment = ccnxName_GetSegment(name, prefixCount);
+    if (ccnxNameSegment_GetType(segment) != CCNxNameLabelType_CHUNK || !ccnxNameSegmentNumber_IsValid(segment)) {
+        return -1;
+    }
+    uint64_t slot = ccnxNameSegmentNumber_Value(segment);
+    return (slot < slots) ? (int64_t) slot : -1;
+}
+
+/*
+ * Build the responses for every slot once. For the RTA stacks they are encoded and signed here,
+ * so sending one again costs neither an encoding nor a signature.
+ */
+static CCNxMetaMessage **
+_ping_CreateResponses(const PARCIdentity *identity, const CCNxName *prefix, const PingOptions *options)
+{
+    CCNxMetaMessage **result = parcMemory_AllocateAndClear(options->slots * sizeof(CCNxMetaMessage *));
+    assertNotNull(result, "parcMemory_AllocateAndClear(%zu) returned NULL", options->slots * sizeof(CCNxMetaMessage *));
+
+    PARCSigner *signer = parcIdentity_CreateSigner(identity);
+    PARCBuffer *payload = parcBuffer_Allocate(options->payloadSize);
+    uint64_t now = (uint64_t) time(0) * 1000;
+
+    for (size_t slot = 0; slot < options->slots; slot++) {
+        CCNxName *name = _ping_CreateSlotName(prefix, slot);
+        CCNxContentObject *contentObject = ccnxContentObject_CreateWithNameAndPayload(name, payload);
+        ccnxContentObject_SetExpiryTime(contentObject, now);
+        CCNxMetaMessage *message = ccnxMetaMessage_CreateFromContentObject(contentObject);
+
+        if (options->stack == PingStack_API) {
+            result[slot] = message;
+        } else {
+            PARCBuffer *wireFormat = ccnxMetaMessage_CreateWireFormatBuffer(message, signer);
+            result[slot] = ccnxMetaMessage_CreateFromWireFormatBuffer(wireFormat);
+            parcBuffer_Release(&wireFormat);
+            ccnxMetaMessage_Release(&message);
+        }
+
+        ccnxContentObject_Release(&contentObject);
+        ccnxName_Release(&name);
+    }
+
+    parcBuffer_Release(&payload);
+    parcSigner_Release(&signer);
+
+    return result;
+}
+
+static void
+_ping_ReleaseResponses(CCNxMetaMessage ***responsesPtr, size_t slots)
+{
+    for (size_t slot = 0; slot < slots; slot++) {
+        ccnxMetaMessage_Release(&(*responsesPtr)[slot]);
+    }
+    parcMemory_Deallocate(responsesPtr);
+}
+
+static bool
+_ping_Answer(CCNxPortal *portal, const CCNxName *prefix, const PingOptions *options, CCNxMetaMessage **responses,
+             const CCNxInterest *interest)
+{
+    int64_t slot = _ping_Slot(prefix, ccnxInterest_GetName(interest), options->slots);
+    if (slot < 0) {
+        return false;
+    }
+    return ccnxPortal_Send(portal, responses[slot], CCNxStackTimeout_Never);
+}
+
+static bool
+_ping_IsFatal(const CCNxPortal *portal)
+{
+    return ccnxPortal_IsError(portal) && !ccnxPortal_IsTimeout(portal) && ccnxPortal_GetError(portal) != EINTR;
+}
+
+static int
+_ping_Server(CCNxPortal *portal, const CCNxName *prefix, const PingOptions *options, CCNxMetaMessage **responses)
+{
+    if (ccnxPortal_Listen(portal, prefix, 365 * 86400, CCNxStackTimeout_Never) == false) {
+        fprintf(stderr, "ccnxPortal_Listen failed: %d\n", ccnxPortal_GetError(portal));
+        return 1;
+    }
+
+    uint64_t answered = 0;
+    while (!_interrupted) {
+        CCNxMetaMessage *request = ccnxPortal_Receive(portal, CCNxStackTimeout_MicroSeconds(100000));
+        if (request == NULL) {
+            if (_ping_IsFatal(portal)) {
+                fprintf(stderr, "ccnxPortal_Receive failed: %d\n", ccnxPortal_GetError(portal));
+                break;
+            }
+            continue;
+        }
+        if (ccnxMetaMessage_IsInterest(request)) {
+            if (_ping_Answer(portal, prefix, options, responses, ccnxMetaMessage_GetInterest(request))) {
+                answered++;
+            }
+        }
+        ccnxMetaMessage_Release(&request);
+    }
+
+    printf("%" PRIu64 " Interests answered\n", answered);
+    return 0;
+}
+
+typedef struct {
+    uint64_t sendTime;             // Zero when the slot is free.
+    unsigned int sequence;
+} _PingSlot;
+
+typedef struct {
+    unsigned int transmitted;
+    unsigned int received;
+    unsigned int late;
+    uint64_t min;
+    uint64_t max;
+    double sum;
+    double sumOfSquares;
+    uint64_t buckets[64];          // Round trips by power of two of microseconds.
+    CCNxPortalHistogram *histogram;
+} _PingStatistics;
+
+static void
+_ping_Record(_PingStatistics *statistics, uint64_t rtt)
+{
+    statistics->received++;
+    if (statistics->received == 1 || rtt < statistics->min) {
+        statistics->min = rtt;
+    }
+    if (rtt > statistics->max) {
+        statistics->max = rtt;
+    }
+    statistics->sum += rtt;
+    statistics->sumOfSquares += (double) rtt * rtt;
+
+    uint64_t microSeconds = rtt / 1000;
+    unsigned int bucket = 0;
+    while (microSeconds > 1 && bucket < 63) {
+        microSeconds >>= 1;
+        bucket++;
+    }
+    statistics->buckets[bucket]++;
+    ccnxPortalHistogram_Record(statistics->histogram, rtt);
+}
+
+static void
+_ping_Summary(const _PingStatistics *statistics, const CCNxName *prefix, double seconds)
+{
+    char *name = ccnxName_ToString(prefix);
+    printf("\n--- %s ping statistics ---\n", name);
+    parcMemory_Deallocate((void **) &name);
+
+    unsigned int lost = statistics->transmitted - statistics->received;
+    printf("%u Interests transmitted, %u Content Objects received, %.1f%% loss, %u late, time %.0f ms\n",
+           statistics->transmitted, statistics->received,
+           (statistics->transmitted > 0) ? 100.0 * lost / statistics->transmitted : 0.0, statistics->late, seconds * 1000);
+    if (statistics->received == 0) {
+        return;
+    }
+
+    double mean = statistics->sum / statistics->received;
+    double variance = statistics->sumOfSquares / statistics->received - mean * mean;
+    double stddev = (variance > 0) ? sqrt(variance) : 0.0;
+    printf("rtt min/avg/max/stddev = %.3f/%.3f/%.3f/%.3f ms\n",
+           statistics->min / 1e6, mean / 1e6, statistics->max / 1e6, stddev / 1e6);
+    printf("rtt p50/p90/p99/p99.9 = %.3f/%.3f/%.3f/%.3f ms\n",
+           ccnxPortalHistogram_GetValueAtPercentile(statistics->histogram, 50.0) / 1e6,
+           ccnxPortalHistogram_GetValueAtPercentile(statistics->histogram, 90.0) / 1e6,
+           ccnxPortalHistogram_GetValueAtPercentile(statistics->histogram, 99.0) / 1e6,
+           ccnxPortalHistogram_GetValueAtPercentile(statistics->histogram, 99.9) / 1e6);
+
+    uint64_t largest = 0;
+    for (size_t i = 0; i < 64; i++) {
+        if (statistics->buckets[i] > largest) {
+            largest = statistics->buckets[i];
+        }
+    }
+    for (size_t i = 0; i < 64; i++) {
+        if (statistics->buckets[i] > 0) {
+            char bar[51];
+            size_t length = (size_t) (50 * statistics->buckets[i] / largest);
+            memset(bar, '#', length);
+            bar[length] = '\0';
+            printf("%10" PRIu64 " us %10" PRIu64 " %s\n", (i == 0) ? 0 : (UINT64_C(1) << i), statistics->buckets[i], bar);
+        }
+    }
+}
+
+static bool
+_ping_SendInterest(CCNxPortal *portal, const CCNxName *prefix, uint64_t slot)
+{
+    CCNxName *name = _ping_CreateSlotName(prefix, slot);
+    CCNxInterest *interest = ccnxInterest_CreateSimple(name);
+    CCNxMetaMessage *message = ccnxMetaMessage_CreateFromInterest(interest);
+
+    bool result = ccnxPortal_Send(portal, message, CCNxStackTimeout_Never);
+
+    ccnxMetaMessage_Release(&message);
+    ccnxInterest_Release(&interest);
+    ccnxName_Release(&name);
+
+    return result;
+}
+
+static int
+_ping_Client(CCNxPortal *portal, const CCNxName *prefix, const PingOptions *options, CCNxMetaMessage **responses)
+{
+    // Over a loopback stack the client's own Interests come back to it, and it answers them itself.
+    bool loopBack = options->stack != PingStack_RTA;
+    if (loopBack) {
+        ccnxPortal_Listen(portal, prefix, 365 * 86400, CCNxStackTimeout_Never);
+    }
+
+    size_t limit = options->flood ? options->outstanding : options->slots;
+    if (limit > options->slots) {
+        limit = options->slots;
+    }
+
+    _PingSlot *slots = parcMemory_AllocateAndClear(options->slots * sizeof(_PingSlot));
+    assertNotNull(slots, "parcMemory_AllocateAndClear(%zu) returned NULL", options->slots * sizeof(_PingSlot));
+    _PingStatistics statistics = { .histogram = ccnxPortalHistogram_Create() };
+
+    uint64_t timeout = options->timeoutMicroSeconds * 1000;
+    uint64_t interval = options->intervalMicroSeconds * 1000;
+    uint64_t start = _nanoTime();
+    uint64_t nextSend = start;
+    size_t outstanding = 0;
+    unsigned int sequence = 0;
+
+    while (!_interrupted) {
+        uint64_t now = _nanoTime();
+        bool sending = (options->count == 0 || sequence < options->count);
+
+        // Expire the Interests that have waited too long.
+        for (size_t i = 0; i < options->slots; i++) {
+            if (slots[i].sendTime != 0 && now - slots[i].sendTime >= timeout) {
+                if (!options->quiet) {
+                    printf("Request timeout for seq=%u\n", slots[i].sequence);
+                }
+                slots[i].sendTime = 0;
+                outstanding--;
+            }
+        }
+
+        if (!sending && outstanding == 0) {
+            break;
+        }
+
+        uint64_t slot = sequence % options->slots;
+        if (sending && outstanding < limit && slots[slot].sendTime == 0 && (options->flood || now >= nextSend)) {
+            uint64_t sendTime = _nanoTime();
+            slots[slot].sendTime = sendTime;
+            slots[slot].sequence = sequence;
+            if (_ping_SendInterest(portal, prefix, slot)) {
+                statistics.transmitted++;
+                outstanding++;
+            } else {
+                fprintf(stderr, "ccnxPortal_Send failed: %d\n", ccnxPortal_GetError(portal));
+                slots[slot].sendTime = 0;
+            }
+            sequence++;
+            nextSend = sendTime + interval;
+            continue;
+        }
+
+        uint64_t wait = 100000;
+        if (sending && !options->flood && nextSend > now && (nextSend - now) / 1000 < wait) {
+            wait = (nextSend - now) / 1000;
+        }
+        CCNxMetaMessage *message = ccnxPortal_Receive(portal, CCNxStackTimeout_MicroSeconds(wait));
+        if (message == NULL) {
+            if (_ping_IsFatal(portal)) {
+                fprintf(stderr, "ccnxPortal_Receive failed: %d\n", ccnxPortal_GetError(portal));
+                break;
+            }
+            continue;
+        }
+
+        if (ccnxMetaMessage_IsInterest(message)) {
+            if (loopBack) {
+                _ping_Answer(portal, prefix, options, responses, ccnxMetaMessage_GetInterest(message));
+            }
+        } else if (ccnxMetaMessage_IsContentObject(message)) {
+            uint64_t received = _nanoTime();
+            CCNxContentObject *contentObject = ccnxMetaMessage_GetContentObject(message);
+            int64_t index = _ping_Slot(prefix, ccnxContentObject_GetName(contentObject), options->slots);
+            if (index >= 0 && slots[index].sendTime != 0) {
+                uint64_t rtt = received - slots[index].sendTime;
+                _ping_Record(&statistics, rtt);
+                if (!options->quiet) {
+                    PARCBuffer *payload = ccnxContentObject_GetPayload(contentObject);
+                    printf("%zu bytes: slot=%" PRId64 " seq=%u time=%.3f ms\n",
+                           (payload == NULL) ? 0 : parcBuffer_Remaining(payload), index, slots[index].sequence, rtt / 1e6);
+                }
+                slots[index].sendTime = 0;
+                outstanding--;
+            } else if (index >= 0) {
+                statistics.late++;
+            }
+        }
+        ccnxMetaMessage_Release(&message);
+    }
+
+    _ping_Summary(&statistics, prefix, (_nanoTime() - start) / 1e9);
+
+    ccnxPortalHistogram_Release(&statistics.histogram);
+    parcMemory_Deallocate(&slots);
+
+    return (statistics.received > 0) ? 0 : 1;
+}
+
+int
+ccnPing(const PARCIdentity *identity, const CCNxName *prefix, const PingOptions *options)
+{
+    parcSecurity_Init();
+
+    CCNxPortalFactory *factory = ccnxPortalFactory_Create(identity);
+
+    CCNxStackImpl *stackImplementation = ccnxPortalRTA_Message;
+    if (options->stack == PingStack_RTALoopBack) {
+        stackImplementation = ccnxPortalRTA_LoopBack;
+    } else if (options->stack == PingStack_API) {
+        stackImplementation = ccnxPortalAPI_LoopBack;
+    }
+    CCNxPortal *portal = ccnxPortalFactory_CreatePortal(factory, stackImplementation);
+    assertNotNull(portal, "Expected a non-null CCNxPortal pointer.");
+
+    CCNxMetaMessage **responses = NULL;
+    if (options->server || options->stack != PingStack_RTA) {
+        responses = _ping_CreateResponses(identity, prefix, options);
+    }
+
+    int result = options->server
+        ? _ping_Server(portal, prefix, options, responses)
+        : _ping_Client(portal, prefix, options, responses);
+
+    if (responses != NULL) {
+        _ping_ReleaseResponses(&responses, options->slots);
+    }
+
+    ccnxPortal_Release(&portal);
+    ccnxPortalFactory_Release(&factory);
+
+    parcSecurity_Fini();
+
+    return result;
+}
+
+void
+usage(void)
+{
+    printf("ccnx-ping --identity <file> --password <password> [options] lci:/prefix\n");
+    printf("ccnx-ping --identity <file> --password <password> --server [--size <bytes>] [--slots <n>] lci:/prefix\n");
+    printf("ccnx-ping [-h | --help]\n");
+    printf("\n");
+    printf("    --identity         The file name containing a PKCS12 keystore\n");
+    printf("    --password         The password to unlock the keystore\n");
+    printf("    --server           Answer pings for lci:/prefix instead of sending them\n");
+    printf("    --size             The payload size of the responses (default 64)\n");
+    printf("    --slots            The number of distinct names, which limits outstanding Interests (default 256)\n");
+    printf("    --count            The number of Interests to send (default 10, 0 until interrupted)\n");
+    printf("    --interval         Milliseconds between Interests (default 1000)\n");
+    printf("    --flood            Send as fast as the outstanding limit allows\n");
+    printf("    --outstanding      With --flood, the number of Interests kept outstanding (default 1)\n");
+    printf("    --timeout          Milliseconds to wait for each Content Object (default 1000)\n");
+    printf("    --stack            rta (through the forwarder), rta-loopback or api (answered locally) (default rta)\n");
+    printf("    --quiet            Print only the summary\n");
+}
+
+int
+main(int argc, char *argv[argc])
+{
+    char *keystoreFile = NULL;
+    char *keystorePassword = NULL;
+    PingOptions options = {
+        .server               = false,
+        .stack                = PingStack_RTA,
+        .slots                = 256,
+        .payloadSize          = 64,
+        .count                = 10,
+        .intervalMicroSeconds = 1000000,
+        .timeoutMicroSeconds  = 1000000,
+        .flood                = false,
+        .outstanding          = 1,
+        .quiet                = false
+    };
+
+    static struct option longopts[] = {
+        { "identity",    required_argument, NULL, 'f' },
+        { "password",    required_argument, NULL, 'p' },
+        { "server",      no_argument,       NULL, 'S' },
+        { "size",        required_argument, NULL, 's' },
+        { "slots",       required_argument, NULL, 'n' },
+        { "count",       required_argument, NULL, 'c' },
+        { "interval",    required_argument, NULL, 'i' },
+        { "flood",       no_argument,       NULL, 'F' },
+        { "outstanding", required_argument, NULL, 'o' },
+        { "timeout",     required_argument, NULL, 't' },
+        { "stack",       required_argument, NULL, 'k' },
+        { "quiet",       no_argument,       NULL, 'q' },
+        { "help",        no_argument,       NULL, 'h' },
+        { NULL,          0,                 NULL, 0   }
+    };
+
+    int ch;
+    while ((ch = getopt_long(argc, argv, "f:p:c:i:qh", longopts, NULL)) != -1) {
+        switch (ch) {
+            case 'f':
+                keystoreFile = optarg;
+                break;
+
+            case 'p':
+                keystorePassword = optarg;
+                break;
+
+            case 'S':
+                options.server = true;
+                break;
+
+            case 's':
+                options.payloadSize = (size_t) strtoul(optarg, NULL, 10);
+                break;
+
+            case 'n':
+                options.slots = (size_t) strtoul(optarg, NULL, 10);
+                break;
+
+            case 'c':
+                options.count = (unsigned int) strtoul(optarg, NULL, 10);
+                break;
+
+            case 'i':
+                options.intervalMicroSeconds = strtoull(optarg, NULL, 10) * 1000;
+                break;
+
+            case 'F':
+                options.flood = true;
+                break;
+
+            case 'o':
+                options.outstanding = (unsigned int) strtoul(optarg, NULL, 10);
+                break;
+
+            case 't':
+                options.timeoutMicroSeconds = strtoull(optarg, NULL, 10) * 1000;
+                break;
+
+            case 'k':
+                if (strcmp(optarg, "rta") == 0) {
+                    options.stack = PingStack_RTA;
+                } else if (strcmp(optarg, "rta-loopback") == 0) {
+                    options.stack = PingStack_RTALoopBack;
+                } else if (strcmp(optarg, "api") == 0) {
+                    options.stack = PingStack_API;
+                } else {
+                    printf("--stack must be rta, rta-loopback or api.\n");
+                    return -1;
+                }
+                break;
+
+            case 'q':
+                options.quiet = true;
+                break;
+
+            case 'h':
+                usage();
+                return 0;
+
+            default:
+                usage();
+                return -1;
+        }
+    }
+
+    argc -= optind;
+    argv += optind;
+
+    if (argc < 1 || keystoreFile == NULL || keystorePassword == NULL
+        || options.slots == 0 || options.outstanding == 0 || options.timeoutMicroSeconds == 0) {
+        usage();
+        return -1;
+    }
+
+    PARCIdentityFile *identityFile = parcIdentityFile_Create(keystoreFile, keystorePassword);
+    if (parcIdentityFile_Exists(identityFile) == false) {
+        printf("Inaccessible keystore file '%s'.\n", keystoreFile);
+        exit(1);
+    }
+    PARCIdentity *identity = parcIdentity_Create(identityFile, PARCIdentityFileAsPARCIdentity);
+    parcIdentityFile_Release(&identityFile);
+
+    signal(SIGINT, _ping_Interrupt);
+
+    CCNxName *prefix = ccnxName_CreateFromCString(argv[0]);
+
+    int result = ccnPing(identity, prefix, &options);
+
+    ccnxName_Release(&prefix);
+    parcIdentity_Release(&identity);
+
+    return result;
+}
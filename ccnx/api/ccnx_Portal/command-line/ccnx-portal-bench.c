@@ -0,0 +1,704 @@
+/*
+ * Copyright (c) 2016, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX OR PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ################################################################################
+ * #
+ * # PATENT NOTICE
+ * #
+ * # This software is distributed under the BSD 2-clause License (see LICENSE
+ * # file).  This BSD License does not make any patent claims and as such, does
+ * # not act as a patent grant.  The purpose of this section is for each contributor
+ * # to define their intentions with respect to intellectual property.
+ * #
+ * # Each contributor to this source code is encouraged to state their patent
+ * # claims and licensing mechanisms for any contributions made. At the end of
+ * # this section contributors may each make their own statements.  Contributor's
+ * # claims and grants only apply to the pieces (source code, programs, text,
+ * # media, etc) that they have contributed directly to this software.
+ * #
+ * # There is no guarantee that this section is complete, up to date or accurate. It
+ * # is up to the contributors to maintain their portion of this section and up to
+ * # the user of the software to verify any claims herein.
+ * #
+ * # Do not remove this header notification.  The contents of this section must be
+ * # present in all distributions of the software.  You may only modify your own
+ * # intellectual property statements.  Please provide contact information.
+ *
+ * - Palo Alto Research Center, Inc
+ * This software distribution does not grant any rights to patents owned by Palo
+ * Alto Research Center, Inc (PARC). Rights to these patents are available via
+ * various mechanisms. As of January 2016 PARC has committed to FRAND licensing any
+ * intellectual property used by its contributions to this software. You may
+ * contact PARC at cipo@parc.com for more information or visit http://www.ccnx.org
+ */
+/**
+ * A load generator for the Portal API.
+ *
+ * Drives a number of loopback portals from a number of threads, each portal sending Interests and answering them
+ * with an in-process stand-in responder, so that every request crosses the portal stack four times:
+ * the Interest is sent and received, and the Content Object is sent and received.
+ * No forwarder is involved, so the results measure the portal and its stack.
+ *
+ * In closed-loop mode each portal keeps a fixed number of requests outstanding.
+ * In open-loop mode each portal sends at a fixed rate whether or not responses keep up,
+ * and latency is measured from the time a request was scheduled, so that a stalled stack shows up as latency.
+ *
+ * Request names and response payload sizes follow fixed, deterministic distributions so that runs are comparable.
+ * The results are printed as JSON.
+ *
+ * @copyright (c) 2016, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC).  All rights reserved.
+ */
+#include <config.h>
+
+#include <errno.h>
+#include <getopt.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <LongBow/runtime.h>
+
+#include <ccnx/api/ccnx_Portal/ccnx_Portal.h>
+#include <ccnx/api/ccnx_Portal/ccnx_PortalAPI.h>
+#include <ccnx/api/ccnx_Portal/ccnx_PortalRTA.h>
+#include <ccnx/api/ccnx_Portal/ccnx_PortalHistogram.h>
+
+#include <parc/algol/parc_Buffer.h>
+#include <parc/algol/parc_JSON.h>
+#include <parc/algol/parc_Memory.h>
+#include <parc/security/parc_Security.h>
+#include <parc/security/parc_IdentityFile.h>
+#include <parc/security/parc_Pkcs12KeyStore.h>
+
+#include <ccnx/common/ccnx_Name.h>
+#include <ccnx/common/ccnx_NameSegmentNumber.h>
+#include <ccnx/common/ccnx_ContentObject.h>
+#include <ccnx/common/ccnx_Interest.h>
+
+#define MAX_PAYLOAD_SIZES 16
+
+// The number of send times each portal remembers, which bounds its outstanding requests.
+#define SEQUENCE_WINDOW 65536
+
+/**
+ * The configuration of a benchmark run.
+ */
+typedef struct {
+    bool useRTA;                   // Use the RTA loopback stack rather than the API loopback stack.
+    bool openLoop;                 // Send at a fixed rate rather than keeping a fixed number of requests outstanding.
+    unsigned int portals;
+    unsigned int threads;
+    unsigned int outstanding;      // Closed loop: the requests each portal keeps outstanding.
+    double rate;                   // Open loop: the total requests per second across all portals.
+    unsigned int durationSeconds;
+    unsigned int warmupSeconds;
+    unsigned int nameComponents;   // The number of fixed name components between the portal's prefix and the sequence number.
+    const char *payloadSizesString;
+    size_t payloadSizes[MAX_PAYLOAD_SIZES];
+    unsigned int payloadWeights[MAX_PAYLOAD_SIZES];
+    size_t payloadSizeCount;
+    unsigned int totalWeight;
+} BenchOptions;
+
+extern int ccnBench(const PARCIdentity *identity, const BenchOptions *options);
+extern void usage(void);
+
+typedef struct {
+    CCNxPortal *portal;
+    CCNxName *prefix;
+    uint64_t nextSequence;
+    uint64_t outstanding;
+    uint64_t nextSendTime;
+    uint64_t interval;
+    uint64_t sendTimes[SEQUENCE_WINDOW];
+} _BenchPortal;
+
+typedef struct {
+    const BenchOptions *options;
+    CCNxPortalHistogram *latency;
+    uint64_t measureStart;
+    uint64_t measureEnd;
+
+    _BenchPortal **portals;
+    size_t portalCount;
+    PARCBuffer *payloads[MAX_PAYLOAD_SIZES];
+
+    uint64_t requests;
+    uint64_t responses;
+    uint64_t responseBytes;
+    uint64_t overruns;
+    uint64_t errors;
+} _BenchThread;
+
+static uint64_t
+_nanoTime(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t) now.tv_sec * 1000000000ULL + (uint64_t) now.tv_nsec;
+}
+
+/*
+ * The payload size class for a sequence number: a fixed hash of the number, weighted by the size distribution.
+ */
+static size_t
+_bench_PayloadClass(const BenchOptions *options, uint64_t sequence)
+{
+    uint64_t z = sequence + 0x9E3779B97F4A7C15ULL;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    z ^= z >> 31;
+
+    unsigned int pick = (unsigned int) (z % options->totalWeight);
+    size_t result = 0;
+    while (pick >= options->payloadWeights[result]) {
+        pick -= options->payloadWeights[result];
+        result++;
+    }
+    return result;
+}
+
+static uint64_t
+_bench_Sequence(const CCNxName *name)
+{
+    CCNxNameSegment *segment = ccnxName_GetSegment(name, ccnxName_GetSegmentCount(name) - 1);
+    return ccnxNameSegmentNumber_Value(segment);
+}
+
+static bool
+_bench_SendInterest(_BenchThread *thread, _BenchPortal *portal, uint64_t sendTime)
+{
+    uint64_t sequence = portal->nextSequence;
+
+    CCNxName *name = ccnxName_Copy(portal->prefix);
+    CCNxNameSegment *segment = ccnxNameSegmentNumber_Create(CCNxNameLabelType_CHUNK, sequence);
+    ccnxName_Append(name, segment);
+    ccnxNameSegment_Release(&segment);
+
+    CCNxInterest *interest = ccnxInterest_CreateSimple(name);
+    CCNxMetaMessage *message = ccnxMetaMessage_CreateFromInterest(interest);
+
+    portal->sendTimes[sequence % SEQUENCE_WINDOW] = sendTime;
+    bool result = ccnxPortal_Send(portal->portal, message, CCNxStackTimeout_Never);
+    if (result) {
+        portal->nextSequence++;
+        portal->outstanding++;
+        if (sendTime >= thread->measureStart && sendTime < thread->measureEnd) {
+            thread->requests++;
+        }
+    } else {
+        thread->errors++;
+    }
+
+    ccnxMetaMessage_Release(&message);
+    ccnxInterest_Release(&interest);
+    ccnxName_Release(&name);
+
+    return result;
+}
+
+/*
+ * The stand-in responder: answer an Interest with a Content Object of the size its sequence number selects.
+ */
+static void
+_bench_Respond(_BenchThread *thread, _BenchPortal *portal, const CCNxInterest *interest)
+{
+    const CCNxName *name = ccnxInterest_GetName(interest);
+    size_t payloadClass = _bench_PayloadClass(thread->options, _bench_Sequence(name));
+
+    CCNxContentObject *contentObject = ccnxContentObject_CreateWithNameAndPayload(name, thread->payloads[payloadClass]);
+    CCNxMetaMessage *message = ccnxMetaMessage_CreateFromContentObject(contentObject);
+
+    if (ccnxPortal_Send(portal->portal, message, CCNxStackTimeout_Never) == false) {
+        thread->errors++;
+    }
+
+    ccnxMetaMessage_Release(&message);
+    ccnxContentObject_Release(&contentObject);
+}
+
+static void
+_bench_ReceiveResponse(_BenchThread *thread, _BenchPortal *portal, const CCNxContentObject *contentObject)
+{
+    uint64_t now = _nanoTime();
+    uint64_t sequence = _bench_Sequence(ccnxContentObject_GetName(contentObject));
+
+    if (sequence >= portal->nextSequence || portal->nextSequence - sequence > SEQUENCE_WINDOW) {
+        return;
+    }
+    portal->outstanding--;
+
+    uint64_t sendTime = portal->sendTimes[sequence % SEQUENCE_WINDOW];
+    if (sendTime >= thread->measureStart && sendTime < thread->measureEnd) {
+        ccnxPortalHistogram_Record(thread->latency, now - sendTime);
+        thread->responses++;
+        PARCBuffer *payload = ccnxContentObject_GetPayload(contentObject);
+        thread->responseBytes += (payload == NULL) ? 0 : parcBuffer_Remaining(payload);
+    }
+}
+
+/*
+ * Send what is due and handle what has arrived on one portal. Returns true if there was anything to do.
+ */
+static bool
+_bench_Service(_BenchThread *thread, _BenchPortal *portal, uint64_t now, bool sending)
+{
+    bool result = false;
+    const BenchOptions *options = thread->options;
+
+    if (sending) {
+        if (options->openLoop) {
+            while (portal->nextSendTime <= now) {
+                if (portal->outstanding >= SEQUENCE_WINDOW) {
+                    thread->overruns++;
+                } else {
+                    _bench_SendInterest(thread, portal, portal->nextSendTime);
+                }
+                portal->nextSendTime += portal->interval;
+                result = true;
+            }
+        } else {
+            while (portal->outstanding < options->outstanding) {
+                if (_bench_SendInterest(thread, portal, _nanoTime()) == false) {
+                    break;
+                }
+                result = true;
+            }
+        }
+    }
+
+    CCNxMetaMessage *message;
+    while ((message = ccnxPortal_Receive(portal->portal, CCNxStackTimeout_Immediate)) != NULL) {
+        if (ccnxMetaMessage_IsInterest(message)) {
+            _bench_Respond(thread, portal, ccnxMetaMessage_GetInterest(message));
+        } else if (ccnxMetaMessage_IsContentObject(message)) {
+            _bench_ReceiveResponse(thread, portal, ccnxMetaMessage_GetContentObject(message));
+        }
+        ccnxMetaMessage_Release(&message);
+        result = true;
+    }
+
+    return result;
+}
+
+static void *
+_bench_Thread(void *argument)
+{
+    _BenchThread *thread = argument;
+
+    uint64_t now = _nanoTime();
+    for (size_t i = 0; i < thread->portalCount; i++) {
+        thread->portals[i]->nextSendTime = now;
+    }
+
+    // Stop sending at the end of the measurement, then allow a moment for the last responses to arrive.
+    uint64_t drainEnd = thread->measureEnd + 1000000000ULL;
+    while ((now = _nanoTime()) < drainEnd) {
+        bool sending = now < thread->measureEnd;
+        bool busy = false;
+        for (size_t i = 0; i < thread->portalCount; i++) {
+            busy |= _bench_Service(thread, thread->portals[i], now, sending);
+        }
+        if (!sending) {
+            bool idle = true;
+            for (size_t i = 0; i < thread->portalCount; i++) {
+                idle &= (thread->portals[i]->outstanding == 0);
+            }
+            if (idle) {
+                break;
+            }
+        }
+        if (!busy) {
+            sched_yield();
+        }
+    }
+
+    return NULL;
+}
+
+static PARCJSON *
+_bench_CreateConfigurationJSON(const BenchOptions *options)
+{
+    PARCJSON *result = parcJSON_Create();
+    parcJSON_AddString(result, "stack", options->useRTA ? "rta" : "api");
+    parcJSON_AddString(result, "mode", options->openLoop ? "open" : "closed");
+    parcJSON_AddInteger(result, "portals", options->portals);
+    parcJSON_AddInteger(result, "threads", options->threads);
+    if (options->openLoop) {
+        PARCJSONValue *value = parcJSONValue_CreateFromFloat(options->rate);
+        parcJSON_AddValue(result, "rate", value);
+        parcJSONValue_Release(&value);
+    } else {
+        parcJSON_AddInteger(result, "outstanding", options->outstanding);
+    }
+    parcJSON_AddInteger(result, "durationSeconds", options->durationSeconds);
+    parcJSON_AddInteger(result, "warmupSeconds", options->warmupSeconds);
+    parcJSON_AddInteger(result, "nameComponents", options->nameComponents);
+    parcJSON_AddString(result, "payloadSizes", options->payloadSizesString);
+
+    return result;
+}
+
+static void
+_bench_Report(const BenchOptions *options, _BenchThread *threads, const CCNxPortalHistogram *latency)
+{
+    uint64_t requests = 0;
+    uint64_t responses = 0;
+    uint64_t responseBytes = 0;
+    uint64_t overruns = 0;
+    uint64_t errors = 0;
+    for (unsigned int i = 0; i < options->threads; i++) {
+        requests += threads[i].requests;
+        responses += threads[i].responses;
+        responseBytes += threads[i].responseBytes;
+        overruns += threads[i].overruns;
+        errors += threads[i].errors;
+    }
+
+    PARCJSON *json = parcJSON_Create();
+
+    PARCJSON *configuration = _bench_CreateConfigurationJSON(options);
+    parcJSON_AddObject(json, "configuration", configuration);
+    parcJSON_Release(&configuration);
+
+    parcJSON_AddInteger(json, "requests", (int64_t) requests);
+    parcJSON_AddInteger(json, "responses", (int64_t) responses);
+    parcJSON_AddInteger(json, "unanswered", (int64_t) (requests - responses));
+    parcJSON_AddInteger(json, "overruns", (int64_t) overruns);
+    parcJSON_AddInteger(json, "errors", (int64_t) errors);
+
+    PARCJSONValue *value = parcJSONValue_CreateFromFloat((double) responses / options->durationSeconds);
+    parcJSON_AddValue(json, "responsesPerSecond", value);
+    parcJSONValue_Release(&value);
+    value = parcJSONValue_CreateFromFloat((double) responseBytes / options->durationSeconds);
+    parcJSON_AddValue(json, "payloadBytesPerSecond", value);
+    parcJSONValue_Release(&value);
+
+    PARCJSON *histogram = ccnxPortalHistogram_ToJSON(latency);
+    parcJSON_AddObject(json, "latencyNanoseconds", histogram);
+    parcJSON_Release(&histogram);
+
+    char *string = parcJSON_ToString(json);
+    printf("%s\n", string);
+    parcMemory_Deallocate(&string);
+    parcJSON_Release(&json);
+}
+
+static CCNxName *
+_bench_CreatePrefix(const BenchOptions *options, unsigned int portalIndex)
+{
+    char uri[64];
+    sprintf(uri, "lci:/bench/portal%u", portalIndex);
+    CCNxName *result = ccnxName_CreateFromCString(uri);
+
+    for (unsigned int i = 0; i < options->nameComponents; i++) {
+        char component[16];
+        sprintf(component, "c%07u", i);
+        CCNxName *longer = ccnxName_ComposeNAME(result, component);
+        ccnxName_Release(&result);
+        result = longer;
+    }
+    return result;
+}
+
+int
+ccnBench(const PARCIdentity *identity, const BenchOptions *options)
+{
+    CCNxPortalFactory *factory = ccnxPortalFactory_Create(identity);
+
+    CCNxPortalHistogram *latency = ccnxPortalHistogram_Create();
+
+    _BenchPortal **portals = parcMemory_AllocateAndClear(options->portals * sizeof(_BenchPortal *));
+    assertNotNull(portals, "parcMemory_AllocateAndClear(%zu) returned NULL", options->portals * sizeof(_BenchPortal *));
+    for (unsigned int i = 0; i < options->portals; i++) {
+        portals[i] = parcMemory_AllocateAndClear(sizeof(_BenchPortal));
+        assertNotNull(portals[i], "parcMemory_AllocateAndClear(%zu) returned NULL", sizeof(_BenchPortal));
+        portals[i]->portal = ccnxPortalFactory_CreatePortal(factory, options->useRTA ? ccnxPortalRTA_LoopBack : ccnxPortalAPI_LoopBack);
+        assertNotNull(portals[i]->portal, "Expected a non-null CCNxPortal pointer.");
+        portals[i]->prefix = _bench_CreatePrefix(options, i);
+        portals[i]->interval = options->openLoop ? (uint64_t) (1e9 * options->portals / options->rate) : 0;
+        ccnxPortal_Listen(portals[i]->portal, portals[i]->prefix, 365 * 86400, CCNxStackTimeout_Never);
+    }
+
+    uint64_t start = _nanoTime();
+    _BenchThread *threads = parcMemory_AllocateAndClear(options->threads * sizeof(_BenchThread));
+    assertNotNull(threads, "parcMemory_AllocateAndClear(%zu) returned NULL", options->threads * sizeof(_BenchThread));
+    for (unsigned int t = 0; t < options->threads; t++) {
+        _BenchThread *thread = &threads[t];
+        thread->options = options;
+        thread->latency = latency;
+        thread->measureStart = start + options->warmupSeconds * 1000000000ULL;
+        thread->measureEnd = thread->measureStart + options->durationSeconds * 1000000000ULL;
+        thread->portals = parcMemory_AllocateAndClear(options->portals * sizeof(_BenchPortal *));
+        assertNotNull(thread->portals, "parcMemory_AllocateAndClear(%zu) returned NULL", options->portals * sizeof(_BenchPortal *));
+        for (unsigned int i = t; i < options->portals; i += options->threads) {
+            thread->portals[thread->portalCount++] = portals[i];
+        }
+        // Each thread has its own payloads, so no buffer is shared between threads.
+        for (size_t i = 0; i < options->payloadSizeCount; i++) {
+            thread->payloads[i] = parcBuffer_Allocate(options->payloadSizes[i]);
+        }
+    }
+
+    pthread_t *threadIds = parcMemory_AllocateAndClear(options->threads * sizeof(pthread_t));
+    assertNotNull(threadIds, "parcMemory_AllocateAndClear(%zu) returned NULL", options->threads * sizeof(pthread_t));
+    for (unsigned int t = 0; t < options->threads; t++) {
+        pthread_create(&threadIds[t], NULL, _bench_Thread, &threads[t]);
+    }
+    for (unsigned int t = 0; t < options->threads; t++) {
+        pthread_join(threadIds[t], NULL);
+    }
+    parcMemory_Deallocate(&threadIds);
+
+    _bench_Report(options, threads, latency);
+
+    for (unsigned int t = 0; t < options->threads; t++) {
+        for (size_t i = 0; i < options->payloadSizeCount; i++) {
+            parcBuffer_Release(&threads[t].payloads[i]);
+        }
+        parcMemory_Deallocate(&threads[t].portals);
+    }
+    parcMemory_Deallocate(&threads);
+    for (unsigned int i = 0; i < options->portals; i++) {
+        ccnxPortal_Release(&portals[i]->portal);
+        ccnxName_Release(&portals[i]->prefix);
+        parcMemory_Deallocate(&portals[i]);
+    }
+    parcMemory_Deallocate(&portals);
+    ccnxPortalHistogram_Release(&latency);
+    ccnxPortalFactory_Release(&factory);
+
+    return 0;
+}
+
+/*
+ * Parse a payload size distribution of the form size[:weight],size[:weight],...
+ */
+static bool
+_bench_ParsePayloadSizes(BenchOptions *options, const char *string)
+{
+    options->payloadSizesString = string;
+    options->payloadSizeCount = 0;
+    options->totalWeight = 0;
+
+    const char *cursor = string;
+    while (*cursor != '\0') {
+        if (options->payloadSizeCount == MAX_PAYLOAD_SIZES) {
+            return false;
+        }
+        char *end;
+        unsigned long size = strtoul(cursor, &end, 10);
+        if (end == cursor) {
+            return false;
+        }
+        unsigned long weight = 1;
+        if (*end == ':') {
+            cursor = end + 1;
+            weight = strtoul(cursor, &end, 10);
+            if (end == cursor || weight == 0) {
+                return false;
+            }
+        }
+        options->payloadSizes[options->payloadSizeCount] = (size_t) size;
+        options->payloadWeights[options->payloadSizeCount] = (unsigned int) weight;
+        options->payloadSizeCount++;
+        options->totalWeight += (unsigned int) weight;
+
+        if (*end == ',') {
+            end++;
+        } else if (*end != '\0') {
+            return false;
+        }
+        cursor = end;
+    }
+
+    return options->payloadSizeCount > 0;
+}
+
+void
+usage(void)
+{
+    printf("ccnx-portal-bench [--identity <file> --password <password>] [options]\n");
+    printf("ccnx-portal-bench [-h | --help]\n");
+    printf("\n");
+    printf("    --identity         The file name containing a PKCS12 keystore (default a temporary keystore)\n");
+    printf("    --password         The password to unlock the keystore\n");
+    printf("    --stack            rta or api: the loopback stack to drive (default rta)\n");
+    printf("    --portals          The number of portals (default 1)\n");
+    printf("    --threads          The number of threads driving the portals (default 1)\n");
+    printf("    --outstanding      Closed loop: the requests each portal keeps outstanding (default 1)\n");
+    printf("    --rate             Open loop: the total requests per second; selects open-loop mode\n");
+    printf("    --duration         Seconds to measure (default 10)\n");
+    printf("    --warmup           Seconds to run before measuring (default 1)\n");
+    printf("    --name-components  The number of fixed name components in each request name (default 4)\n");
+    printf("    --payload-sizes    The response payload sizes as size[:weight],... (default 64:50,1024:40,8192:10)\n");
+}
+
+int
+main(int argc, char *argv[argc])
+{
+    char *keystoreFile = NULL;
+    char *keystorePassword = NULL;
+    BenchOptions options = {
+        .useRTA          = true,
+        .openLoop        = false,
+        .portals         = 1,
+        .threads         = 1,
+        .outstanding     = 1,
+        .rate            = 0,
+        .durationSeconds = 10,
+        .warmupSeconds   = 1,
+        .nameComponents  = 4
+    };
+    _bench_ParsePayloadSizes(&options, "64:50,1024:40,8192:10");
+
+    static struct option longopts[] = {
+        { "identity",        required_argument, NULL, 'f' },
+        { "password",        required_argument, NULL, 'p' },
+        { "stack",           required_argument, NULL, 's' },
+        { "portals",         required_argument, NULL, 'P' },
+        { "threads",         required_argument, NULL, 't' },
+        { "outstanding",     required_argument, NULL, 'o' },
+        { "rate",            required_argument, NULL, 'r' },
+        { "duration",        required_argument, NULL, 'd' },
+        { "warmup",          required_argument, NULL, 'w' },
+        { "name-components", required_argument, NULL, 'n' },
+        { "payload-sizes",   required_argument, NULL, 'z' },
+        { "help",            no_argument,       NULL, 'h' },
+        { NULL,              0,                 NULL, 0   }
+    };
+
+    int ch;
+    while ((ch = getopt_long(argc, argv, "f:p:h", longopts, NULL)) != -1) {
+        switch (ch) {
+            case 'f':
+                keystoreFile = optarg;
+                break;
+
+            case 'p':
+                keystorePassword = optarg;
+                break;
+
+            case 's':
+                if (strcmp(optarg, "rta") == 0) {
+                    options.useRTA = true;
+                } else if (strcmp(optarg, "api") == 0) {
+                    options.useRTA = false;
+                } else {
+                    printf("--stack must be rta or api.\n");
+                    return -1;
+                }
+                break;
+
+            case 'P':
+                options.portals = (unsigned int) strtoul(optarg, NULL, 10);
+                break;
+
+            case 't':
+                options.threads = (unsigned int) strtoul(optarg, NULL, 10);
+                break;
+
+            case 'o':
+                options.outstanding = (unsigned int) strtoul(optarg, NULL, 10);
+                break;
+
+            case 'r':
+                options.rate = strtod(optarg, NULL);
+                options.openLoop = true;
+                break;
+
+            case 'd':
+                options.durationSeconds = (unsigned int) strtoul(optarg, NULL, 10);
+                break;
+
+            case 'w':
+                options.warmupSeconds = (unsigned int) strtoul(optarg, NULL, 10);
+                break;
+
+            case 'n':
+                options.nameComponents = (unsigned int) strtoul(optarg, NULL, 10);
+                break;
+
+            case 'z':
+                if (_bench_ParsePayloadSizes(&options, optarg) == false) {
+                    printf("--payload-sizes must be a list of size[:weight].\n");
+                    return -1;
+                }
+                break;
+
+            case 'h':
+                usage();
+                return 0;
+
+            default:
+                usage();
+                return -1;
+        }
+    }
+
+    if (options.portals == 0 || options.threads == 0 || options.durationSeconds == 0
+        || (options.openLoop ? options.rate <= 0 : (options.outstanding == 0 || options.outstanding > SEQUENCE_WINDOW))) {
+        usage();
+        return -1;
+    }
+    if (options.threads > options.portals) {
+        options.threads = options.portals;
+    }
+
+    parcSecurity_Init();
+
+    char temporaryKeystore[64] = "";
+    if (keystoreFile == NULL) {
+        sprintf(temporaryKeystore, "/tmp/ccnx-portal-bench-%d.p12", (int) getpid());
+        keystoreFile = temporaryKeystore;
+        keystorePassword = "ccnx-portal-bench";
+        if (parcPkcs12KeyStore_CreateFile(keystoreFile, keystorePassword, "ccnx-portal-bench", 1024, 1) == false) {
+            printf("Cannot create a temporary keystore '%s'.\n", keystoreFile);
+            parcSecurity_Fini();
+            return 1;
+        }
+    }
+
+    PARCIdentityFile *identityFile = parcIdentityFile_Create(keystoreFile, keystorePassword);
+    if (parcIdentityFile_Exists(identityFile) == false) {
+        printf("Inaccessible keystore file '%s'.\n", keystoreFile);
+        exit(1);
+    }
+    PARCIdentity *identity = parcIdentity_Create(identityFile, PARCIdentityFileAsPARCIdentity);
+    parcIdentityFile_Release(&identityFile);
+
+    int result = ccnBench(identity, &options);
+
+    parcIdentity_Release(&identity);
+    if (temporaryKeystore[0] != '\0') {
+        unlink(temporaryKeystore);
+    }
+
+    parcSecurity_Fini();
+
+    return result;
+}
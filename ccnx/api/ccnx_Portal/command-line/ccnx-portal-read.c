@@ -52,126 +52,523 @@
  * intellectual property used by its contributions to this software. You may
  * contact PARC at cipo@parc.com for more information or visit http://www.ccnx.org
  */
+/**
+ * Fetch a segmented object, keeping a window of Interests outstanding, and report how the transfer went.
+ *
+ * Interests are sent for lci:/name/chunk=N, keeping at most the window size of chunks between the next chunk to be
+ * delivered in order and the newest chunk requested. The end of the object is learned from the final chunk number
+ * carried by the segments. An Interest not answered within the timeout is sent again,
+ * and round-trip times are recorded only for segments whose Interest was sent once.
+ *
+ * @copyright (c) 2016, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC).  All rights reserved.
+ */
+#include <config.h>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <getopt.h>
 #include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
 
 #include <LongBow/runtime.h>
 
 #include <ccnx/api/ccnx_Portal/ccnx_Portal.h>
+#include <ccnx/api/ccnx_Portal/ccnx_PortalRTA.h>
+#include <ccnx/api/ccnx_Portal/ccnx_PortalHistogram.h>
 
+#include <parc/algol/parc_Buffer.h>
+#include <parc/algol/parc_JSON.h>
+#include <parc/algol/parc_Memory.h>
 #include <parc/security/parc_Security.h>
-#include <parc/security/parc_PublicKeySignerPkcs12Store.h>
 #include <parc/security/parc_IdentityFile.h>
 
 #include <ccnx/common/ccnx_Name.h>
-#include <ccnx/common/ccnx_SignedInfo.h>
+#include <ccnx/common/ccnx_NameSegmentNumber.h>
 #include <ccnx/common/ccnx_ContentObject.h>
-#include <ccnx/common/ccnx_TimeStamp.h>
+#include <ccnx/common/ccnx_Interest.h>
 
-PARCIdentity *
-getIdentity_FromFile(const char *keystoreFileName, const char *password)
-{
-    PARCIdentity *result = NULL;
+/**
+ * The tunable parts of the consumer.
+ */
+typedef struct {
+    size_t window;                 // The maximum number of chunks requested but not yet delivered in order.
+    uint64_t timeoutMicroSeconds;  // How long to wait for a segment before sending its Interest again.
+    unsigned int maxRetries;       // How many times an Interest is sent again before the transfer fails.
+    bool json;                     // Report as JSON rather than text.
+} ReaderOptions;
 
-    PARCIdentityFile *identityFile = parcIdentityFile_Create(keystoreFileName, password);
-    if (identityFile != NULL) {
-        result = parcIdentity_Create(identityFile, PARCIdentityFileAsPARCIdentity);
-        parcIdentityFile_Release(&identityFile);
-    }
+extern int ccnRead(const PARCIdentity *identity, const CCNxName *name, int output, const ReaderOptions *options);
+extern void usage(void);
 
-    return result;
+/*
+ * A chunk that has been requested and not yet delivered in order.
+ */
+typedef struct {
+    bool inUse;
+    uint64_t chunkNumber;
+    uint64_t sentTime;
+    unsigned int retries;
+    PARCBuffer *payload;
+} _Slot;
+
+typedef struct {
+    CCNxPortal *portal;
+    const CCNxName *name;
+    const ReaderOptions *options;
+    int output;
+
+    _Slot *slots;                  // Indexed by chunk number modulo the window.
+    uint64_t nextToRequest;
+    uint64_t nextToDeliver;
+    uint64_t finalChunkNumber;     // UINT64_MAX until a segment carries it.
+
+    CCNxPortalHistogram *rtt;
+    uint64_t bytesDelivered;
+    uint64_t interestsSent;
+    uint64_t retransmissions;
+    uint64_t duplicates;
+    uint64_t startTime;
+    uint64_t endTime;
+    bool failed;
+} _Reader;
+
+static uint64_t
+_nanoTime(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t) now.tv_sec * 1000000000ULL + (uint64_t) now.tv_nsec;
 }
 
-int
-reader_writer(CCNxPortalFactory *factory, const char *uri)
+static bool
+_reader_SendInterest(_Reader *reader, uint64_t chunkNumber)
 {
+    CCNxName *name = ccnxName_Copy(reader->name);
+    CCNxNameSegment *chunk = ccnxNameSegmentNumber_Create(CCNxNameLabelType_CHUNK, chunkNumber);
+    ccnxName_Append(name, chunk);
+    ccnxNameSegment_Release(&chunk);
+
+    CCNxInterest *interest = ccnxInterest_CreateSimple(name);
+    CCNxMetaMessage *message = ccnxMetaMessage_CreateFromInterest(interest);
+
+    bool result = ccnxPortal_Send(reader->portal, message, CCNxStackTimeout_Never);
+    if (result) {
+        reader->interestsSent++;
+    } else {
+        fprintf(stderr, "ccnxPortal_Send failed: %d\n", ccnxPortal_GetError(reader->portal));
+    }
 
-    CCNxPortal *portal = ccnxPortalFactory_GetInstance(factory, ccnxPortalTypeDatagram, ccnxPortalProtocol_TLV, &ccnxPortalAttributes_Blocking);
+    ccnxMetaMessage_Release(&message);
+    ccnxInterest_Release(&interest);
+    ccnxName_Release(&name);
 
-    CCNxName *prefix = ccnxName_CreateFromURI(uri);
-    CCNxName *bye = ccnxName_CreateFromURI("lci:/Hello/Goodbye%21");
-    CCNxName *contentname = ccnxName_CreateFromURI("lci:/Hello/World");
+    return result;
+}
 
-    if (ccnxPortal_Listen(portal, prefix, 365 * 86400, CCNxStackTimeout_Never)) {
-        CCNxMetaMessage *msg;
+/*
+ * Request chunks until the window is full or the final chunk has been requested.
+ */
+static bool
+_reader_FillWindow(_Reader *reader)
+{
+    while (reader->nextToRequest < reader->nextToDeliver + reader->options->window
+           && reader->nextToRequest <= reader->finalChunkNumber) {
+        _Slot *slot = &reader->slots[reader->nextToRequest % reader->options->window];
+        slot->inUse = true;
+        slot->chunkNumber = reader->nextToRequest;
+        slot->sentTime = _nanoTime();
+        slot->retries = 0;
+        slot->payload = NULL;
+
+        if (_reader_SendInterest(reader, reader->nextToRequest) == false) {
+            return false;
+        }
+        reader->nextToRequest++;
+    }
+    return true;
+}
 
-        while ((msg = ccnxPortal_Receive(portal, CCNxStackTimeout_Never)) != NULL) {
+/*
+ * Write out the chunks that are now contiguous with what has already been delivered.
+ */
+static bool
+_reader_Deliver(_Reader *reader)
+{
+    while (reader->nextToDeliver < reader->nextToRequest) {
+        _Slot *slot = &reader->slots[reader->nextToDeliver % reader->options->window];
+        if (slot->payload == NULL) {
+            break;
+        }
 
-            if (ccnxMetaMessage_IsInterest(msg)) {
-                CCNxInterest *interest = ccnxMetaMessage_GetInterest(msg);
+        size_t length = parcBuffer_Remaining(slot->payload);
+        if (reader->output >= 0 && length > 0) {
+            const uint8_t *bytes = parcBuffer_Overlay(slot->payload, 0);
+            size_t written = 0;
+            while (written < length) {
+                ssize_t nwritten = write(reader->output, bytes + written, length - written);
+                if (nwritten < 0) {
+                    if (errno == EINTR) {
+                        continue;
+                    }
+                    perror("write");
+                    return false;
+                }
+                written += (size_t) nwritten;
+            }
+        }
+        reader->bytesDelivered += length;
 
-                CCNxName *interestName = ccnxInterest_GetName(interest);
+        parcBuffer_Release(&slot->payload);
+        slot->inUse = false;
+        reader->nextToDeliver++;
+    }
+    return true;
+}
 
-                if (ccnxName_Equals(interestName, contentname)) {
-                    const PARCKeyId *publisherKeyId = ccnxPortal_GetKeyId(portal);
+static void
+_reader_ReceiveContentObject(_Reader *reader, const CCNxContentObject *contentObject)
+{
+    const CCNxName *name = ccnxContentObject_GetName(contentObject);
+    size_t prefixCount = ccnxName_GetSegmentCount(reader->name);
+    if (name == NULL || ccnxName_GetSegmentCount(name) != prefixCount + 1 || !ccnxName_StartsWith(name, reader->name)) {
+        return;
+    }
+    CCNxNameSegment *chunk = ccnxName_GetSegment(name, prefixCount);
+    if (ccnxNameSegment_GetType(chunk) != CCNxNameLabelType_CHUNK || !ccnxNameSegmentNumber_IsValid(chunk)) {
+        return;
+    }
+    uint64_t chunkNumber = ccnxNameSegmentNumber_Value(chunk);
 
-                    char buffer[128];
-                    time_t theTime = time(0);
-                    sprintf(buffer, "Hello World. The time is %s", ctime(&theTime));
+    _Slot *slot = &reader->slots[chunkNumber % reader->options->window];
+    if (chunkNumber < reader->nextToDeliver || !slot->inUse || slot->chunkNumber != chunkNumber || slot->payload != NULL) {
+        reader->duplicates++;
+        return;
+    }
 
-                    PARCBuffer *payload = parcBuffer_CreateFromArray(buffer, 128);
-                    parcBuffer_Flip(payload);
+    // Karn's rule: the round trip of a retransmitted Interest is ambiguous.
+    if (slot->retries == 0) {
+        ccnxPortalHistogram_Record(reader->rtt, _nanoTime() - slot->sentTime);
+    }
 
-                    PARCBuffer *b = parcBuffer_Acquire(payload);
-                    CCNxContentObject *uob = ccnxContentObject_CreateWithNameAndPayload(contentname, b);
+    PARCBuffer *payload = ccnxContentObject_GetPayload(contentObject);
+    slot->payload = (payload == NULL) ? parcBuffer_Allocate(0) : parcBuffer_Acquire(payload);
 
-                    // missing NULL check, case 1024
+    if (ccnxContentObject_HasFinalChunkNumber(contentObject)) {
+        uint64_t finalChunkNumber = ccnxContentObject_GetFinalChunkNumber(contentObject);
+        if (finalChunkNumber < reader->finalChunkNumber) {
+            reader->finalChunkNumber = finalChunkNumber;
 
-                    CCNxMetaMessage *message = ccnxMetaMessage_CreateFromContentObject(uob);
-                    if (ccnxPortal_Send(portal, message, CCNxTransportStackTimeCCNxStackTimeout_Neverout_Never) == false) {
-                        fprintf(stderr, "ccnx_write failed\n");
-                    }
-                    // ccnxMessage_Release(message);
-                } else if (ccnxName_Equals(interestName, bye)) {
-                    break;
+            // Forget the chunks requested past the end.
+            for (uint64_t i = finalChunkNumber + 1; i < reader->nextToRequest; i++) {
+                _Slot *beyond = &reader->slots[i % reader->options->window];
+                if (beyond->payload != NULL) {
+                    parcBuffer_Release(&beyond->payload);
                 }
-            } else {
-                ccnxMetaMessage_Display(msg, 0);
+                beyond->inUse = false;
+            }
+            if (reader->nextToRequest > finalChunkNumber + 1) {
+                reader->nextToRequest = finalChunkNumber + 1;
             }
-            ccnxMetaMessage_Release(&msg);
         }
     }
+}
 
-    ccnxName_Release(&prefix);
-    ccnxName_Release(&bye);
-    ccnxName_Release(&contentname);
+/*
+ * Send again the Interests that have timed out, and return the time until the next one will.
+ */
+static uint64_t
+_reader_Retransmit(_Reader *reader)
+{
+    uint64_t timeout = reader->options->timeoutMicroSeconds * 1000;
+    uint64_t now = _nanoTime();
+    uint64_t result = timeout;
+
+    for (uint64_t chunkNumber = reader->nextToDeliver; chunkNumber < reader->nextToRequest; chunkNumber++) {
+        _Slot *slot = &reader->slots[chunkNumber % reader->options->window];
+        if (slot->payload != NULL) {
+            continue;
+        }
+        if (now - slot->sentTime >= timeout) {
+            if (slot->retries == reader->options->maxRetries) {
+                fprintf(stderr, "No response for chunk %" PRIu64 " after %u retries\n", chunkNumber, slot->retries);
+                reader->failed = true;
+                return 0;
+            }
+            slot->retries++;
+            slot->sentTime = now;
+            reader->retransmissions++;
+            if (_reader_SendInterest(reader, chunkNumber) == false) {
+                reader->failed = true;
+                return 0;
+            }
+        } else if (timeout - (now - slot->sentTime) < result) {
+            result = timeout - (now - slot->sentTime);
+        }
+    }
 
-    ccnxPortal_Release(&portal);
+    return result;
+}
+
+static void
+_reader_ReportText(const _Reader *reader, FILE *output)
+{
+    double seconds = (reader->endTime - reader->startTime) / 1e9;
+    const CCNxPortalHistogram *rtt = reader->rtt;
+
+    fprintf(output, "%s: %" PRIu64 " bytes in %" PRIu64 " segments, %.3f seconds\n",
+            reader->failed ? "failed" : "complete", reader->bytesDelivered, reader->nextToDeliver, seconds);
+    fprintf(output, "goodput          %12.3f Mbit/s\n", (seconds > 0) ? reader->bytesDelivered * 8 / seconds / 1e6 : 0.0);
+    fprintf(output, "segments         %12.1f /s\n", (seconds > 0) ? reader->nextToDeliver / seconds : 0.0);
+    fprintf(output, "interests        %12" PRIu64 "\n", reader->interestsSent);
+    fprintf(output, "retransmissions  %12" PRIu64 "\n", reader->retransmissions);
+    fprintf(output, "duplicates       %12" PRIu64 "\n", reader->duplicates);
+    fprintf(output, "rtt us  min %" PRIu64 " p50 %" PRIu64 " p90 %" PRIu64 " p99 %" PRIu64 " p99.9 %" PRIu64 " max %" PRIu64 "\n",
+            ccnxPortalHistogram_GetMin(rtt) / 1000,
+            ccnxPortalHistogram_GetValueAtPercentile(rtt, 50.0) / 1000,
+            ccnxPortalHistogram_GetValueAtPercentile(rtt, 90.0) / 1000,
+            ccnxPortalHistogram_GetValueAtPercentile(rtt, 99.0) / 1000,
+            ccnxPortalHistogram_GetValueAtPercentile(rtt, 99.9) / 1000,
+            ccnxPortalHistogram_GetMax(rtt) / 1000);
+}
 
-    return 0;
+static void
+_reader_ReportJSON(const _Reader *reader, FILE *output)
+{
+    double seconds = (reader->endTime - reader->startTime) / 1e9;
+
+    PARCJSON *json = parcJSON_Create();
+    parcJSON_AddBoolean(json, "complete", !reader->failed);
+    parcJSON_AddInteger(json, "bytes", (int64_t) reader->bytesDelivered);
+    parcJSON_AddInteger(json, "segments", (int64_t) reader->nextToDeliver);
+    parcJSON_AddInteger(json, "nanoseconds", (int64_t) (reader->endTime - reader->startTime));
+
+    PARCJSONValue *value = parcJSONValue_CreateFromFloat((seconds > 0) ? reader->bytesDelivered * 8 / seconds : 0.0);
+    parcJSON_AddValue(json, "goodputBitsPerSecond", value);
+    parcJSONValue_Release(&value);
+    value = parcJSONValue_CreateFromFloat((seconds > 0) ? reader->nextToDeliver / seconds : 0.0);
+    parcJSON_AddValue(json, "segmentsPerSecond", value);
+    parcJSONValue_Release(&value);
+
+    parcJSON_AddInteger(json, "interests", (int64_t) reader->interestsSent);
+    parcJSON_AddInteger(json, "retransmissions", (int64_t) reader->retransmissions);
+    parcJSON_AddInteger(json, "duplicates", (int64_t) reader->duplicates);
+
+    PARCJSON *rtt = ccnxPortalHistogram_ToJSON(reader->rtt);
+    parcJSON_AddObject(json, "rttNanoseconds", rtt);
+    parcJSON_Release(&rtt);
+
+    char *string = parcJSON_ToString(json);
+    fprintf(output, "%s\n", string);
+    parcMemory_Deallocate(&string);
+    parcJSON_Release(&json);
 }
 
 int
-ccnx_Portal_Reader(char *keystoreFileName, const char *password, const char *uri)
+ccnRead(const PARCIdentity *identity, const CCNxName *name, int output, const ReaderOptions *options)
 {
     parcSecurity_Init();
 
-    PARCIdentity *identity = getIdentity_FromFile(keystoreFileName, password);
+    CCNxPortalFactory *factory = ccnxPortalFactory_Create(identity);
+    CCNxPortal *portal = ccnxPortalFactory_CreatePortal(factory, ccnxPortalRTA_Message);
+    assertNotNull(portal, "Expected a non-null CCNxPortal pointer.");
+
+    _Reader reader = {
+        .portal           = portal,
+        .name             = name,
+        .options          = options,
+        .output           = output,
+        .slots            = parcMemory_AllocateAndClear(options->window * sizeof(_Slot)),
+        .finalChunkNumber = UINT64_MAX,
+        .rtt              = ccnxPortalHistogram_Create(),
+        .startTime        = _nanoTime()
+    };
+    assertNotNull(reader.slots, "parcMemory_AllocateAndClear(%zu) returned NULL", options->window * sizeof(_Slot));
+
+    while (reader.failed == false && reader.nextToDeliver <= reader.finalChunkNumber) {
+        if (_reader_FillWindow(&reader) == false) {
+            reader.failed = true;
+            break;
+        }
 
-    if (identity != NULL) {
-        CCNxPortalFactory *factory = ccnxPortalFactory_Create(identity);
+        uint64_t wait = _reader_Retransmit(&reader);
+        if (reader.failed) {
+            break;
+        }
 
-        reader_writer(factory, uri);
+        CCNxMetaMessage *response = ccnxPortal_Receive(portal, CCNxStackTimeout_MicroSeconds(wait / 1000 + 1));
+        if (response != NULL) {
+            if (ccnxMetaMessage_IsContentObject(response)) {
+                _reader_ReceiveContentObject(&reader, ccnxMetaMessage_GetContentObject(response));
+            }
+            ccnxMetaMessage_Release(&response);
 
-        ccnxPortalFactory_Release(&factory);
-        parcIdentity_Release(&identity);
+            if (_reader_Deliver(&reader) == false) {
+                reader.failed = true;
+            }
+        } else if (ccnxPortal_IsError(portal)) {
+            int error = ccnxPortal_GetError(portal);
+            if (!ccnxPortal_IsTimeout(portal) && error != EINTR) {
+                fprintf(stderr, "ccnxPortal_Receive failed: %d\n", error);
+                reader.failed = true;
+            }
+        }
+    }
+    reader.endTime = _nanoTime();
+
+    if (options->json) {
+        _reader_ReportJSON(&reader, stderr);
+    } else {
+        _reader_ReportText(&reader, stderr);
+    }
+
+    for (size_t i = 0; i < options->window; i++) {
+        if (reader.slots[i].payload != NULL) {
+            parcBuffer_Release(&reader.slots[i].payload);
+        }
     }
+    parcMemory_Deallocate(&reader.slots);
+    ccnxPortalHistogram_Release(&reader.rtt);
+
+    ccnxPortal_Release(&portal);
+    ccnxPortalFactory_Release(&factory);
 
     parcSecurity_Fini();
 
-    return 0;
+    return reader.failed ? 1 : 0;
+}
+
+void
+usage(void)
+{
+    printf("ccnx-portal-read --identity <file> --password <password> [options] lci:/ccn-name\n");
+    printf("ccnx-portal-read [-h | --help]\n");
+    printf("\n");
+    printf("    --identity         The file name containing a PKCS12 keystore\n");
+    printf("    --password         The password to unlock the keystore\n");
+    printf("    --window           The number of chunks requested ahead of in-order delivery (default 16)\n");
+    printf("    --timeout          Milliseconds to wait for a segment before sending its Interest again (default 1000)\n");
+    printf("    --retries          The number of times an Interest is sent again before giving up (default 8)\n");
+    printf("    --output           Write the object to this file, or - for standard output (default discard)\n");
+    printf("    --json             Report as JSON instead of text\n");
+    printf("    lci:/ccn-name      The name of the object, fetched as lci:/ccn-name/chunk=N\n");
+    printf("\n");
+    printf("The report is written to standard error.\n");
 }
 
 int
 main(int argc, char *argv[argc])
 {
-    char *keystoreFileName = argv[1];
-    char *password = argv[2];
-    char *uri = argv[3];
+    char *keystoreFile = NULL;
+    char *keystorePassword = NULL;
+    char *outputFile = NULL;
+    ReaderOptions options = {
+        .window              = 16,
+        .timeoutMicroSeconds = 1000000,
+        .maxRetries          = 8,
+        .json                = false
+    };
+
+    static struct option longopts[] = {
+        { "identity", required_argument, NULL, 'f' },
+        { "password", required_argument, NULL, 'p' },
+        { "window",   required_argument, NULL, 'w' },
+        { "timeout",  required_argument, NULL, 't' },
+        { "retries",  required_argument, NULL, 'r' },
+        { "output",   required_argument, NULL, 'o' },
+        { "json",     no_argument,       NULL, 'j' },
+        { "help",     no_argument,       NULL, 'h' },
+        { NULL,       0,                 NULL, 0   }
+    };
+
+    int ch;
+    while ((ch = getopt_long(argc, argv, "f:p:o:h", longopts, NULL)) != -1) {
+        switch (ch) {
+            case 'f':
+                keystoreFile = optarg;
+                break;
+
+            case 'p':
+                keystorePassword = optarg;
+                break;
+
+            case 'w':
+                options.window = (size_t) strtoul(optarg, NULL, 10);
+                if (options.window == 0) {
+                    printf("--window must be at least 1.\n");
+                    return -1;
+                }
+                break;
+
+            case 't':
+                options.timeoutMicroSeconds = strtoull(optarg, NULL, 10) * 1000;
+                if (options.timeoutMicroSeconds == 0) {
+                    printf("--timeout must be at least 1.\n");
+                    return -1;
+                }
+                break;
+
+            case 'r':
+                options.maxRetries = (unsigned int) strtoul(optarg, NULL, 10);
+                break;
+
+            case 'o':
+                outputFile = optarg;
+                break;
+
+            case 'j':
+                options.json = true;
+                break;
 
-    keystoreFileName = "/tmp/keystore";
-    password = "password";
-    uri = "lci:/Hello";
+            case 'h':
+                usage();
+                return 0;
+
+            default:
+                usage();
+                return -1;
+        }
+    }
+
+    argc -= optind;
+    argv += optind;
+
+    if (argc < 1 || keystoreFile == NULL || keystorePassword == NULL) {
+        usage();
+        return -1;
+    }
 
-    // read fileName password  lci://my/name  lci
-    return ccnx_Portal_Reader(keystoreFileName, password, uri);
+    int output = -1;
+    if (outputFile != NULL) {
+        if (strcmp(outputFile, "-") == 0) {
+            output = STDOUT_FILENO;
+        } else {
+            output = open(outputFile, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+            if (output < 0) {
+                printf("Cannot open '%s': %s\n", outputFile, strerror(errno));
+                return 1;
+            }
+        }
+    }
+
+    PARCIdentityFile *identityFile = parcIdentityFile_Create(keystoreFile, keystorePassword);
+    if (parcIdentityFile_Exists(identityFile) == false) {
+        printf("Inaccessible keystore file '%s'.\n", keystoreFile);
+        exit(1);
+    }
+    PARCIdentity *identity = parcIdentity_Create(identityFile, PARCIdentityFileAsPARCIdentity);
+    parcIdentityFile_Release(&identityFile);
+
+    CCNxName *name = ccnxName_CreateFromCString(argv[0]);
+
+    int result = ccnRead(identity, name, output, &options);
+
+    ccnxName_Release(&name);
+    parcIdentity_Release(&identity);
+    if (output > STDOUT_FILENO) {
+        close(output);
+    }
+
+    return result;
 }
@@ -52,9 +52,671 @@
  * intellectual property used by its contributions to this software. You may
  * contact PARC at cipo@parc.com for more information or visit http://www.ccnx.org
  */
-// Needs to be implemented, case 1037
+/**
+ * Publish standard input, or a file, as a segmented and signed object.
+ *
+ * A reader thread reads the input in large blocks and cuts it into segments that share the blocks' memory.
+ * A pool of signer threads encodes and signs the segments into wire format while the input is still being read,
+ * and the main thread answers Interests for lci:/name/chunk=N with the signed segments.
+ * An Interest for a segment that is still being signed is answered as soon as the signer finishes it:
+ * the signer hands the segment back to the main thread, which is the only thread using the Portal.
+ *
+ * @copyright (c) 2016, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC).  All rights reserved.
+ */
+#include <config.h>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <getopt.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <LongBow/runtime.h>
+
+#include <ccnx/api/ccnx_Portal/ccnx_Portal.h>
+#include <ccnx/api/ccnx_Portal/ccnx_PortalRTA.h>
+
+#include <parc/algol/parc_Buffer.h>
+#include <parc/algol/parc_Memory.h>
+#include <parc/security/parc_Security.h>
+#include <parc/security/parc_IdentityFile.h>
+
+#include <ccnx/common/ccnx_Name.h>
+#include <ccnx/common/ccnx_NameSegmentNumber.h>
+#include <ccnx/common/ccnx_ContentObject.h>
+
+/**
+ * The tunable parts of the publisher.
+ */
+typedef struct {
+    size_t segmentSize;            // The number of bytes of input in each segment.
+    unsigned int signers;          // The number of threads signing segments.
+    unsigned int lingerSeconds;    // How long to keep answering Interests after every segment has been sent once.
+} WriterOptions;
+
+extern int ccnWrite(const PARCIdentity *identity, const CCNxName *name, int input, const WriterOptions *options);
+extern void usage(void);
+
+/*
+ * One segment of the input. The payload is released once the segment is signed.
+ */
+typedef struct _segment {
+    uint64_t chunkNumber;
+    bool isFinal;
+    PARCBuffer *payload;
+    CCNxMetaMessage *signedMessage;
+    bool requested;
+    bool sent;
+    struct _segment *nextReady;
+} _Segment;
+
+/*
+ * A bounded queue of segments waiting to be signed.
+ */
+typedef struct {
+    pthread_mutex_t lock;
+    pthread_cond_t notEmpty;
+    pthread_cond_t notFull;
+    _Segment **items;
+    size_t capacity;
+    size_t head;
+    size_t count;
+    bool closed;
+} _Queue;
+
+typedef struct {
+    CCNxPortal *portal;
+    const PARCIdentity *identity;
+    const CCNxName *name;
+    const WriterOptions *options;
+    int input;
+
+    _Queue work;
+
+    // The segments read so far, indexed by chunk number. Guarded by lock.
+    pthread_mutex_t lock;
+    _Segment **segments;
+    size_t segmentCount;
+    size_t segmentCapacity;
+    bool complete;
+    size_t sentCount;
+
+    // Requested segments still being signed, and those signed since and waiting to be sent. Guarded by lock.
+    size_t waitingCount;
+    _Segment *ready;
+
+    uint64_t bytesRead;
+    uint64_t signingTime;
+    uint64_t startTime;
+    uint64_t readTime;
+    uint64_t publishedTime;
+} _Writer;
+
+static uint64_t
+_nanoTime(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t) now.tv_sec * 1000000000ULL + (uint64_t) now.tv_nsec;
+}
+
+static void
+_queue_Init(_Queue *queue, size_t capacity)
+{
+    pthread_mutex_init(&queue->lock, NULL);
+    pthread_cond_init(&queue->notEmpty, NULL);
+    pthread_cond_init(&queue->notFull, NULL);
+    queue->items = parcMemory_AllocateAndClear(capacity * sizeof(_Segment *));
+    assertNotNull(queue->items, "parcMemory_AllocateAndClear(%zu) returned NULL", capacity * sizeof(_Segment *));
+    queue->capacity = capacity;
+    queue->head = 0;
+    queue->count = 0;
+    queue->closed = false;
+}
+
+static void
+_queue_Fini(_Queue *queue)
+{
+    parcMemory_Deallocate(&queue->items);
+    pthread_cond_destroy(&queue->notFull);
+    pthread_cond_destroy(&queue->notEmpty);
+    pthread_mutex_destroy(&queue->lock);
+}
+
+static bool
+_queue_Put(_Queue *queue, _Segment *segment)
+{
+    bool result = false;
+
+    pthread_mutex_lock(&queue->lock);
+    while (queue->count == queue->capacity && !queue->closed) {
+        pthread_cond_wait(&queue->notFull, &queue->lock);
+    }
+    if (!queue->closed) {
+        queue->items[(queue->head + queue->count) % queue->capacity] = segment;
+        queue->count++;
+        pthread_cond_signal(&queue->notEmpty);
+        result = true;
+    }
+    pthread_mutex_unlock(&queue->lock);
+
+    return result;
+}
+
+static _Segment *
+_queue_Take(_Queue *queue)
+{
+    _Segment *result = NULL;
+
+    pthread_mutex_lock(&queue->lock);
+    while (queue->count == 0 && !queue->closed) {
+        pthread_cond_wait(&queue->notEmpty, &queue->lock);
+    }
+    if (queue->count > 0) {
+        result = queue->items[queue->head];
+        queue->head = (queue->head + 1) % queue->capacity;
+        queue->count--;
+        pthread_cond_signal(&queue->notFull);
+    }
+    pthread_mutex_unlock(&queue->lock);
+
+    return result;
+}
+
+static void
+_queue_Close(_Queue *queue)
+{
+    pthread_mutex_lock(&queue->lock);
+    queue->closed = true;
+    pthread_cond_broadcast(&queue->notEmpty);
+    pthread_cond_broadcast(&queue->notFull);
+    pthread_mutex_unlock(&queue->lock);
+}
+
+static void
+_segment_Destroy(_Segment **segmentPtr)
+{
+    _Segment *segment = *segmentPtr;
+
+    if (segment->payload != NULL) {
+        parcBuffer_Release(&segment->payload);
+    }
+    if (segment->signedMessage != NULL) {
+        ccnxMetaMessage_Release(&segment->signedMessage);
+    }
+    parcMemory_Deallocate(segmentPtr);
+}
+
+/*
+ * Add a segment to the table and hand it to the signers.
+ */
+static void
+_writer_Dispatch(_Writer *writer, _Segment *segment, bool isFinal)
+{
+    segment->isFinal = isFinal;
+
+    pthread_mutex_lock(&writer->lock);
+    if (writer->segmentCount == writer->segmentCapacity) {
+        size_t capacity = (writer->segmentCapacity == 0) ? 1024 : writer->segmentCapacity * 2;
+        writer->segments = parcMemory_Reallocate(writer->segments, capacity * sizeof(_Segment *));
+        assertNotNull(writer->segments, "parcMemory_Reallocate(%zu) returned NULL", capacity * sizeof(_Segment *));
+        writer->segmentCapacity = capacity;
+    }
+    writer->segments[writer->segmentCount++] = segment;
+    writer->complete = isFinal;
+    pthread_mutex_unlock(&writer->lock);
+
+    _queue_Put(&writer->work, segment);
+}
+
+/*
+ * Fill the buffer from the input, stopping early only at end of input.
+ */
+static size_t
+_writer_ReadBlock(_Writer *writer, PARCBuffer *block)
+{
+    uint8_t *array = parcBuffer_Overlay(block, 0);
+    size_t capacity = parcBuffer_Capacity(block);
+    size_t length = 0;
+
+    while (length < capacity) {
+        ssize_t nread = read(writer->input, array + length, capacity - length);
+        if (nread == 0) {
+            break;
+        }
+        if (nread < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            perror("read");
+            break;
+        }
+        length += (size_t) nread;
+    }
+
+    return length;
+}
+
+/*
+ * Read the input in blocks of whole segments. Each segment's payload is a slice of its block.
+ * The last segment read is held back until the next read shows whether it is the final one.
+ */
+static void *
+_writer_Reader(void *argument)
+{
+    _Writer *writer = argument;
+    size_t segmentSize = writer->options->segmentSize;
+    size_t segmentsPerBlock = (segmentSize >= (1 << 20)) ? 1 : (1 << 20) / segmentSize;
+
+    uint64_t chunkNumber = 0;
+    _Segment *held = NULL;
+
+    while (true) {
+        PARCBuffer *block = parcBuffer_Allocate(segmentsPerBlock * segmentSize);
+        size_t length = _writer_ReadBlock(writer, block);
+
+        for (size_t offset = 0; offset < length; offset += segmentSize) {
+            size_t limit = (offset + segmentSize < length) ? offset + segmentSize : length;
+            parcBuffer_SetLimit(block, limit);
+            parcBuffer_SetPosition(block, offset);
+
+            if (held != NULL) {
+                _writer_Dispatch(writer, held, false);
+            }
+            held = parcMemory_AllocateAndClear(sizeof(_Segment));
+            assertNotNull(held, "parcMemory_AllocateAndClear(%zu) returned NULL", sizeof(_Segment));
+            held->chunkNumber = chunkNumber++;
+            held->payload = parcBuffer_Slice(block);
+        }
+        parcBuffer_Release(&block);
+
+        writer->bytesRead += length;
+        if (length < segmentsPerBlock * segmentSize) {
+            break;
+        }
+    }
+
+    // Empty input is published as a single, empty segment.
+    if (held == NULL) {
+        held = parcMemory_AllocateAndClear(sizeof(_Segment));
+        assertNotNull(held, "parcMemory_AllocateAndClear(%zu) returned NULL", sizeof(_Segment));
+        held->payload = parcBuffer_Allocate(0);
+    }
+    _writer_Dispatch(writer, held, true);
+
+    writer->readTime = _nanoTime();
+    _queue_Close(&writer->work);
+
+    return NULL;
+}
+
+/*
+ * Send a signed segment. Only the main thread sends.
+ */
+static void
+_writer_Send(_Writer *writer, _Segment *segment)
+{
+    if (ccnxPortal_Send(writer->portal, segment->signedMessage, CCNxStackTimeout_Never) == false) {
+        fprintf(stderr, "ccnxPortal_Send failed: %d\n", ccnxPortal_GetError(writer->portal));
+        return;
+    }
+
+    pthread_mutex_lock(&writer->lock);
+    if (segment->sent == false) {
+        segment->sent = true;
+        writer->sentCount++;
+        if (writer->complete && writer->sentCount == writer->segmentCount) {
+            writer->publishedTime = _nanoTime();
+        }
+    }
+    pthread_mutex_unlock(&writer->lock);
+}
+
+/*
+ * Encode and sign segments into wire format, each signer with its own PARCSigner.
+ */
+static void *
+_writer_Signer(void *argument)
+{
+    _Writer *writer = argument;
+    PARCSigner *signer = parcIdentity_CreateSigner(writer->identity);
+
+    _Segment *segment;
+    while ((segment = _queue_Take(&writer->work)) != NULL) {
+        uint64_t start = _nanoTime();
+
+        CCNxName *name = ccnxName_Copy(writer->name);
+        CCNxNameSegment *chunk = ccnxNameSegmentNumber_Create(CCNxNameLabelType_CHUNK, segment->chunkNumber);
+        ccnxName_Append(name, chunk);
+        ccnxNameSegment_Release(&chunk);
+
+        CCNxContentObject *contentObject = ccnxContentObject_CreateWithNameAndPayload(name, segment->payload);
+        if (segment->isFinal) {
+            ccnxContentObject_SetFinalChunkNumber(contentObject, segment->chunkNumber);
+        }
+        CCNxMetaMessage *message = ccnxMetaMessage_CreateFromContentObject(contentObject);
+        PARCBuffer *wireFormat = ccnxMetaMessage_CreateWireFormatBuffer(message, signer);
+        CCNxMetaMessage *signedMessage = ccnxMetaMessage_CreateFromWireFormatBuffer(wireFormat);
+
+        parcBuffer_Release(&wireFormat);
+        ccnxMetaMessage_Release(&message);
+        ccnxContentObject_Release(&contentObject);
+        ccnxName_Release(&name);
+
+        __atomic_fetch_add(&writer->signingTime, _nanoTime() - start, __ATOMIC_RELAXED);
+
+        pthread_mutex_lock(&writer->lock);
+        parcBuffer_Release(&segment->payload);
+        segment->signedMessage = signedMessage;
+        if (segment->requested) {
+            segment->nextReady = writer->ready;
+            writer->ready = segment;
+            writer->waitingCount--;
+        }
+        pthread_mutex_unlock(&writer->lock);
+    }
+
+    parcSigner_Release(&signer);
+
+    return NULL;
+}
+
+/*
+ * Answer an Interest for one of the segments. A segment still being signed is sent once its signer hands it back.
+ */
+static void
+_writer_Respond(_Writer *writer, const CCNxName *interestName)
+{
+    size_t prefixCount = ccnxName_GetSegmentCount(writer->name);
+    if (ccnxName_GetSegmentCount(interestName) != prefixCount + 1 || !ccnxName_StartsWith(interestName, writer->name)) {
+        return;
+    }
+    CCNxNameSegment *chunk = ccnxName_GetSegment(interestName, prefixCount);
+    if (ccnxNameSegment_GetType(chunk) != CCNxNameLabelType_CHUNK || !ccnxNameSegmentNumber_IsValid(chunk)) {
+        return;
+    }
+    uint64_t chunkNumber = ccnxNameSegmentNumber_Value(chunk);
+
+    _Segment *ready = NULL;
+
+    pthread_mutex_lock(&writer->lock);
+    if (chunkNumber < writer->segmentCount) {
+        _Segment *segment = writer->segments[chunkNumber];
+        if (segment->signedMessage != NULL) {
+            ready = segment;
+        } else if (segment->requested == false) {
+            segment->requested = true;
+            writer->waitingCount++;
+        }
+    }
+    pthread_mutex_unlock(&writer->lock);
+
+    if (ready != NULL) {
+        _writer_Send(writer, ready);
+    }
+}
+
+/*
+ * Send the requested segments the signers have finished since the last call.
+ */
+static void
+_writer_SendReady(_Writer *writer)
+{
+    pthread_mutex_lock(&writer->lock);
+    _Segment *ready = writer->ready;
+    writer->ready = NULL;
+    pthread_mutex_unlock(&writer->lock);
+
+    while (ready != NULL) {
+        _Segment *next = ready->nextReady;
+        ready->nextReady = NULL;
+        _writer_Send(writer, ready);
+        ready = next;
+    }
+}
+
+/*
+ * Whether a requested segment is still being signed, so the main thread should not wait long in a receive.
+ */
+static bool
+_writer_IsWaiting(_Writer *writer)
+{
+    pthread_mutex_lock(&writer->lock);
+    bool result = writer->waitingCount > 0 || writer->ready != NULL;
+    pthread_mutex_unlock(&writer->lock);
+
+    return result;
+}
+
+static bool
+_writer_IsPublished(_Writer *writer)
+{
+    pthread_mutex_lock(&writer->lock);
+    bool result = writer->complete && writer->sentCount == writer->segmentCount;
+    pthread_mutex_unlock(&writer->lock);
+
+    return result;
+}
+
+static void
+_writer_Report(const _Writer *writer)
+{
+    double readSeconds = (writer->readTime - writer->startTime) / 1e9;
+    double signingSeconds = writer->signingTime / 1e9;
+
+    printf("%" PRIu64 " bytes in %zu segments of %zu bytes\n", writer->bytesRead, writer->segmentCount, writer->options->segmentSize);
+    printf("read      %10.3f seconds %10.1f MB/s\n", readSeconds, (readSeconds > 0) ? writer->bytesRead / readSeconds / 1e6 : 0.0);
+    printf("signing   %10.3f seconds %10.1f us/segment, %u signers, %.1f MB/s per signer\n",
+           signingSeconds, writer->signingTime / 1e3 / writer->segmentCount, writer->options->signers,
+           (signingSeconds > 0) ? writer->bytesRead / signingSeconds / 1e6 : 0.0);
+    if (writer->publishedTime != 0) {
+        double publishSeconds = (writer->publishedTime - writer->startTime) / 1e9;
+        printf("published %10.3f seconds %10.1f MB/s\n", publishSeconds, writer->bytesRead / publishSeconds / 1e6);
+    } else {
+        printf("published incomplete, %zu of %zu segments sent\n", writer->sentCount, writer->segmentCount);
+    }
+}
+
+int
+ccnWrite(const PARCIdentity *identity, const CCNxName *name, int input, const WriterOptions *options)
+{
+    parcSecurity_Init();
+
+    CCNxPortalFactory *factory = ccnxPortalFactory_Create(identity);
+    CCNxPortal *portal = ccnxPortalFactory_CreatePortal(factory, ccnxPortalRTA_Message);
+    assertNotNull(portal, "Expected a non-null CCNxPortal pointer.");
+
+    _Writer writer = {
+        .portal    = portal,
+        .identity  = identity,
+        .name      = name,
+        .options   = options,
+        .input     = input,
+        .startTime = _nanoTime()
+    };
+    pthread_mutex_init(&writer.lock, NULL);
+    _queue_Init(&writer.work, 4 * options->signers);
+
+    int result = 0;
+
+    if (ccnxPortal_Listen(portal, name, 365 * 86400, CCNxStackTimeout_Never)) {
+        pthread_t reader;
+        pthread_create(&reader, NULL, _writer_Reader, &writer);
+        pthread_t *signers = parcMemory_AllocateAndClear(options->signers * sizeof(pthread_t));
+        assertNotNull(signers, "parcMemory_AllocateAndClear(%zu) returned NULL", options->signers * sizeof(pthread_t));
+        for (unsigned int i = 0; i < options->signers; i++) {
+            pthread_create(&signers[i], NULL, _writer_Signer, &writer);
+        }
+
+        uint64_t lingerUntil = 0;
+        while (lingerUntil == 0 || _nanoTime() < lingerUntil) {
+            uint64_t wait = _writer_IsWaiting(&writer) ? 1000 : 100000;
+            CCNxMetaMessage *request = ccnxPortal_Receive(portal, CCNxStackTimeout_MicroSeconds(wait));
+
+            if (request != NULL) {
+                if (ccnxMetaMessage_IsInterest(request)) {
+                    _writer_Respond(&writer, ccnxInterest_GetName(ccnxMetaMessage_GetInterest(request)));
+                }
+                ccnxMetaMessage_Release(&request);
+            } else if (ccnxPortal_IsError(portal)) {
+                int error = ccnxPortal_GetError(portal);
+                if (!ccnxPortal_IsTimeout(portal) && error != EINTR) {
+                    fprintf(stderr, "ccnxPortal_Receive failed: %d\n", error);
+                    result = 1;
+                    break;
+                }
+            }
+            _writer_SendReady(&writer);
+
+            if (lingerUntil == 0 && _writer_IsPublished(&writer)) {
+                lingerUntil = _nanoTime() + options->lingerSeconds * 1000000000ULL;
+            }
+        }
+
+        _queue_Close(&writer.work);
+        pthread_join(reader, NULL);
+        for (unsigned int i = 0; i < options->signers; i++) {
+            pthread_join(signers[i], NULL);
+        }
+        parcMemory_Deallocate(&signers);
+
+        _writer_Report(&writer);
+    } else {
+        fprintf(stderr, "ccnxPortal_Listen failed: %d\n", ccnxPortal_GetError(portal));
+        result = 1;
+    }
+
+    for (size_t i = 0; i < writer.segmentCount; i++) {
+        _segment_Destroy(&writer.segments[i]);
+    }
+    if (writer.segments != NULL) {
+        parcMemory_Deallocate(&writer.segments);
+    }
+    _queue_Fini(&writer.work);
+    pthread_mutex_destroy(&writer.lock);
+
+    ccnxPortal_Release(&portal);
+    ccnxPortalFactory_Release(&factory);
+
+    parcSecurity_Fini();
+
+    return result;
+}
+
+void
+usage(void)
+{
+    printf("ccnx-portal-write --identity <file> --password <password> [options] lci:/ccn-name [file]\n");
+    printf("ccnx-portal-write [-h | --help]\n");
+    printf("\n");
+    printf("    --identity         The file name containing a PKCS12 keystore\n");
+    printf("    --password         The password to unlock the keystore\n");
+    printf("    --segment-size     The number of bytes of input in each segment (default 4096)\n");
+    printf("    --signers          The number of threads signing segments (default 2)\n");
+    printf("    --linger           Seconds to keep answering Interests after every segment was sent once (default 0)\n");
+    printf("    lci:/ccn-name      The name to publish under, as lci:/ccn-name/chunk=N\n");
+    printf("    file               The file to publish (default standard input)\n");
+}
+
 int
 main(int argc, char *argv[argc])
 {
-    return 0;
+    char *keystoreFile = NULL;
+    char *keystorePassword = NULL;
+    WriterOptions options = {
+        .segmentSize   = 4096,
+        .signers       = 2,
+        .lingerSeconds = 0
+    };
+
+    static struct option longopts[] = {
+        { "identity",     required_argument, NULL, 'f' },
+        { "password",     required_argument, NULL, 'p' },
+        { "segment-size", required_argument, NULL, 's' },
+        { "signers",      required_argument, NULL, 'n' },
+        { "linger",       required_argument, NULL, 'l' },
+        { "help",         no_argument,       NULL, 'h' },
+        { NULL,           0,                 NULL, 0   }
+    };
+
+    int ch;
+    while ((ch = getopt_long(argc, argv, "f:p:h", longopts, NULL)) != -1) {
+        switch (ch) {
+            case 'f':
+                keystoreFile = optarg;
+                break;
+
+            case 'p':
+                keystorePassword = optarg;
+                break;
+
+            case 's':
+                options.segmentSize = (size_t) strtoul(optarg, NULL, 10);
+                if (options.segmentSize == 0) {
+                    printf("--segment-size must be at least 1.\n");
+                    return -1;
+                }
+                break;
+
+            case 'n':
+                options.signers = (unsigned int) strtoul(optarg, NULL, 10);
+                if (options.signers == 0) {
+                    printf("--signers must be at least 1.\n");
+                    return -1;
+                }
+                break;
+
+            case 'l':
+                options.lingerSeconds = (unsigned int) strtoul(optarg, NULL, 10);
+                break;
+
+            case 'h':
+                usage();
+                return 0;
+
+            default:
+                usage();
+                return -1;
+        }
+    }
+
+    argc -= optind;
+    argv += optind;
+
+    if (argc < 1 || keystoreFile == NULL || keystorePassword == NULL) {
+        usage();
+        return -1;
+    }
+
+    int input = STDIN_FILENO;
+    if (argc > 1) {
+        input = open(argv[1], O_RDONLY);
+        if (input < 0) {
+            printf("Cannot open '%s': %s\n", argv[1], strerror(errno));
+            return 1;
+        }
+    }
+
+    PARCIdentityFile *identityFile = parcIdentityFile_Create(keystoreFile, keystorePassword);
+    if (parcIdentityFile_Exists(identityFile) == false) {
+        printf("Inaccessible keystore file '%s'.\n", keystoreFile);
+        exit(1);
+    }
+    PARCIdentity *identity = parcIdentity_Create(identityFile, PARCIdentityFileAsPARCIdentity);
+    parcIdentityFile_Release(&identityFile);
+
+    CCNxName *name = ccnxName_CreateFromCString(argv[0]);
+
+    int result = ccnWrite(identity, name, input, &options);
+
+    ccnxName_Release(&name);
+    parcIdentity_Release(&identity);
+    if (input != STDIN_FILENO) {
+        close(input);
+    }
+
+    return result;
 }
@@ -59,7 +59,11 @@
 #include <config.h>
 #include <LongBow/runtime.h>
 
+#include <errno.h>
+#include <string.h>
 #include <time.h>
+#include <pthread.h>
+#include <unistd.h>
 
 #include <getopt.h>
 #include <stdio.h>
@@ -68,18 +72,38 @@
 
 #include <ccnx/api/ccnx_Portal/ccnx_Portal.h>
 #include <ccnx/api/ccnx_Portal/ccnx_PortalRTA.h>
+#include <ccnx/api/ccnx_Portal/ccnx_PortalTrace.h>
+#include <ccnx/api/ccnx_Portal/ccnx_PortalReplay.h>
+#include <ccnx/api/ccnx_Portal/ccnx_PortalFileStore.h>
+#include <ccnx/api/ccnx_Portal/ccnx_PortalServer.h>
+#include <ccnx/api/ccnx_Portal/ccnx_PortalExecutor.h>
 
 #include <parc/algol/parc_Buffer.h>
 #include <parc/algol/parc_BufferComposer.h>
+#include <parc/algol/parc_HashMap.h>
 #include <parc/algol/parc_Memory.h>
+#include <parc/algol/parc_Object.h>
 #include <parc/security/parc_Security.h>
 #include <parc/security/parc_PublicKeySigner.h>
 #include <parc/security/parc_IdentityFile.h>
 
 #include <ccnx/common/ccnx_Name.h>
 
+/**
+ * The tunable parts of the server.
+ */
+typedef struct {
+    unsigned int threads;          // The number of worker threads running the command.
+    unsigned int cacheSeconds;     // How long a response is reused for the same name. Zero disables the cache.
+    size_t cacheEntries;           // The maximum number of cached responses.
+    unsigned int reportSeconds;    // The interval between throughput reports. Zero reports only at exit.
+    const char *directory;         // If not NULL, serve the files under this directory instead of running a command.
+    size_t segmentSize;            // The number of bytes of file data in each segment.
+} ServerOptions;
+
 extern PARCBuffer *makePayload(const CCNxName *interestName, const char *commandString);
-extern int ccnServe(const PARCIdentity *identity, const CCNxName *listenName, const char *commandString);
+extern int ccnServe(const PARCIdentity *identity, const CCNxName *listenName, const char *commandString,
+                    const char *recordFile, const char *replayFile, bool fast, const ServerOptions *options);
 extern void usage(void);
 
 PARCBuffer *
@@ -96,10 +120,10 @@ makePayload(const CCNxName *interestName, const char *commandString)
 
     FILE *fp = popen(commandToExecute, "r");
     if (fp != NULL) {
-        unsigned char buffer[1024];
+        unsigned char buffer[65536];
 
-        while (feof(fp) == 0) {
-            size_t length = fread(buffer, sizeof(char), sizeof(buffer), fp);
+        size_t length;
+        while ((length = fread(buffer, sizeof(char), sizeof(buffer), fp)) > 0) {
             parcBufferComposer_PutArray(accumulator, buffer, length);
         }
         pclose(fp);
@@ -107,6 +131,7 @@ makePayload(const CCNxName *interestName, const char *commandString)
         parcBufferComposer_PutString(accumulator, "Cannot execute: ");
         parcBufferComposer_PutString(accumulator, commandString);
     }
+    free(commandToExecute);
 
     PARCBuffer *payload = parcBufferComposer_ProduceBuffer(accumulator);
     parcBufferComposer_Release(&accumulator);
@@ -114,53 +139,439 @@ makePayload(const CCNxName *interestName, const char *commandString)
     return payload;
 }
 
-int
-ccnServe(const PARCIdentity *identity, const CCNxName *listenName, const char *commandString)
+static uint64_t
+_nanoTime(void)
 {
-    parcSecurity_Init();
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t) now.tv_sec * 1000000000ULL + (uint64_t) now.tv_nsec;
+}
 
-    CCNxPortalFactory *factory = ccnxPortalFactory_Create(identity);
+/*
+ * A bounded queue of pointers, shared between threads.
+ */
+typedef struct {
+    pthread_mutex_t lock;
+    pthread_cond_t notEmpty;
+    pthread_cond_t notFull;
+    void **items;
+    size_t capacity;
+    size_t head;
+    size_t count;
+    bool closed;
+} _Queue;
+
+static void
+_queue_Init(_Queue *queue, size_t capacity)
+{
+    pthread_mutex_init(&queue->lock, NULL);
+    pthread_cond_init(&queue->notEmpty, NULL);
+    pthread_cond_init(&queue->notFull, NULL);
+    queue->items = parcMemory_AllocateAndClear(capacity * sizeof(void *));
+    assertNotNull(queue->items, "parcMemory_AllocateAndClear(%zu) returned NULL", capacity * sizeof(void *));
+    queue->capacity = capacity;
+    queue->head = 0;
+    queue->count = 0;
+    queue->closed = false;
+}
 
-    CCNxPortal *portal = ccnxPortalFactory_CreatePortal(factory, ccnxPortalRTA_Message);
-    assertNotNull(portal, "Expected a non-null CCNxPortal pointer.");
+static void
+_queue_Fini(_Queue *queue)
+{
+    parcMemory_Deallocate(&queue->items);
+    pthread_cond_destroy(&queue->notFull);
+    pthread_cond_destroy(&queue->notEmpty);
+    pthread_mutex_destroy(&queue->lock);
+}
 
-    if (ccnxPortal_Listen(portal, listenName, 365 * 86400, CCNxStackTimeout_Never)) {
-        while (true) {
-            CCNxMetaMessage *request = ccnxPortal_Receive(portal, CCNxStackTimeout_Never);
+/*
+ * Append an item, waiting for space if @p wait is true. Returns false if the item was not queued.
+ */
+static bool
+_queue_Put(_Queue *queue, void *item, bool wait)
+{
+    bool result = false;
 
-            if (request == NULL) {
-                break;
-            }
+    pthread_mutex_lock(&queue->lock);
+    while (wait && queue->count == queue->capacity && !queue->closed) {
+        pthread_cond_wait(&queue->notFull, &queue->lock);
+    }
+    if (queue->count < queue->capacity && !queue->closed) {
+        queue->items[(queue->head + queue->count) % queue->capacity] = item;
+        queue->count++;
+        pthread_cond_signal(&queue->notEmpty);
+        result = true;
+    }
+    pthread_mutex_unlock(&queue->lock);
 
-            CCNxInterest *interest = ccnxMetaMessage_GetInterest(request);
+    return result;
+}
 
-            if (interest != NULL) {
-                CCNxName *interestName = ccnxInterest_GetName(interest);
+/*
+ * Remove the next item, waiting until there is one. Returns NULL once the queue is closed and empty.
+ */
+static void *
+_queue_Take(_Queue *queue)
+{
+    void *result = NULL;
 
-                PARCBuffer *payload = makePayload(interestName, commandString);
+    pthread_mutex_lock(&queue->lock);
+    while (queue->count == 0 && !queue->closed) {
+        pthread_cond_wait(&queue->notEmpty, &queue->lock);
+    }
+    if (queue->count > 0) {
+        result = queue->items[queue->head];
+        queue->head = (queue->head + 1) % queue->capacity;
+        queue->count--;
+        pthread_cond_signal(&queue->notFull);
+    }
+    pthread_mutex_unlock(&queue->lock);
 
-                CCNxContentObject *contentObject = ccnxContentObject_CreateWithNameAndPayload(interestName, payload);
+    return result;
+}
 
-                CCNxMetaMessage *message = ccnxMetaMessage_CreateFromContentObject(contentObject);
-                if (ccnxPortal_Send(portal, message, CCNxStackTimeout_Never) == false) {
-                    fprintf(stderr, "ccnxPortal_Write failed: %d\n", ccnxPortal_GetError(portal));
-                }
-                {
-                    char *name = ccnxName_ToString(interestName);
-                    time_t theTime = time(0);
-                    char *time = ctime(&theTime);
-                    printf("%24.24s  %s\n", time, name);
-                    parcMemory_Deallocate((void **) &name);
-                }
+static void
+_queue_Close(_Queue *queue)
+{
+    pthread_mutex_lock(&queue->lock);
+    queue->closed = true;
+    pthread_cond_broadcast(&queue->notEmpty);
+    pthread_cond_broadcast(&queue->notFull);
+    pthread_mutex_unlock(&queue->lock);
+}
 
-                parcBuffer_Release(&payload);
+/*
+ * A cached response: the payload produced by the command for one name, and when it stops being reused.
+ */
+typedef struct {
+    PARCBuffer *payload;
+    uint64_t expiresAt;
+} _CacheEntry;
+
+static void
+_cacheEntry_Destroy(_CacheEntry **entryPtr)
+{
+    parcBuffer_Release(&(*entryPtr)->payload);
+}
+
+parcObject_ExtendPARCObject(_CacheEntry, _cacheEntry_Destroy, NULL, NULL, NULL, NULL, NULL, NULL);
+
+static parcObject_ImplementRelease(_cacheEntry, _CacheEntry);
+
+/*
+ * The number of Interests each worker holds before new ones are shed.
+ */
+static const size_t _serverWorkerQueueCapacity = 256;
+
+/*
+ * The state shared by the handlers running on the workers, the access logger and the reporter.
+ */
+typedef struct {
+    const char *commandString;
+    const ServerOptions *options;
+    CCNxPortalFileStore *files;
+    CCNxPortalExecutor *executor;
+    bool accessLog;
+
+    _Queue accessRecords;
+
+    pthread_mutex_t cacheLock;
+    PARCHashMap *cache;
+
+    uint64_t startTime;
+    uint64_t requestCount;
+    uint64_t responseCount;
+    uint64_t cacheHits;
+    uint64_t accessRecordsDropped;
+
+    pthread_mutex_t reportLock;
+    pthread_cond_t reportWakeup;
+    bool stopping;
+} _Server;
+
+typedef struct {
+    time_t time;
+    CCNxName *name;
+    bool cacheHit;
+} _AccessRecord;
+
+/*
+ * Get a cached payload for the name, or NULL if there is none or it has expired.
+ */
+static PARCBuffer *
+_server_CacheGet(_Server *server, const CCNxName *name, uint64_t now)
+{
+    PARCBuffer *result = NULL;
+
+    pthread_mutex_lock(&server->cacheLock);
+    const _CacheEntry *entry = parcHashMap_Get(server->cache, name);
+    if (entry != NULL) {
+        if (entry->expiresAt > now) {
+            result = parcBuffer_Acquire(entry->payload);
+        } else {
+            parcHashMap_Remove(server->cache, name);
+        }
+    }
+    pthread_mutex_unlock(&server->cacheLock);
+
+    return result;
+}
+
+static void
+_server_CachePut(_Server *server, const CCNxName *name, const PARCBuffer *payload, uint64_t now)
+{
+    _CacheEntry *entry = parcObject_CreateInstance(_CacheEntry);
+    if (entry == NULL) {
+        return;
+    }
+    entry->payload = parcBuffer_Acquire(payload);
+    entry->expiresAt = now + server->options->cacheSeconds * 1000000000ULL;
+
+    pthread_mutex_lock(&server->cacheLock);
+    if (parcHashMap_Size(server->cache) >= server->options->cacheEntries) {
+        // Start over rather than track recency: every entry expires within the TTL anyway.
+        parcHashMap_Release(&server->cache);
+        server->cache = parcHashMap_Create();
+    }
+    parcHashMap_Put(server->cache, name, entry);
+    pthread_mutex_unlock(&server->cacheLock);
+
+    _cacheEntry_Release(&entry);
+}
+
+/*
+ * Run the command for the name, or reuse its output if the name was requested within the cache TTL.
+ */
+static CCNxContentObject *
+_server_CreateCommandResponse(_Server *server, const CCNxName *interestName, bool *cacheHit)
+{
+    bool useCache = server->options->cacheSeconds > 0;
+    uint64_t now = useCache ? _nanoTime() : 0;
+
+    PARCBuffer *payload = useCache ? _server_CacheGet(server, interestName, now) : NULL;
+    *cacheHit = (payload != NULL);
+
+    if (payload == NULL) {
+        payload = makePayload(interestName, server->commandString);
+        if (useCache) {
+            _server_CachePut(server, interestName, payload, now);
+        }
+    } else {
+        __atomic_fetch_add(&server->cacheHits, 1, __ATOMIC_RELAXED);
+    }
+
+    CCNxContentObject *result = ccnxContentObject_CreateWithNameAndPayload(interestName, payload);
+    parcBuffer_Release(&payload);
+
+    return result;
+}
+
+/*
+ * Build the response to an Interest on a worker thread.
+ * The response is handed back to the thread receiving Interests, which is the only one using the Portal.
+ */
+static CCNxMetaMessage *
+_server_Respond(CCNxPortalServer *portalServer, const CCNxName *prefix, const CCNxInterest *interest, void *context)
+{
+    _Server *server = context;
+    CCNxName *interestName = ccnxInterest_GetName(interest);
+    bool cacheHit = false;
+
+    __atomic_fetch_add(&server->requestCount, 1, __ATOMIC_RELAXED);
+
+    CCNxContentObject *contentObject = (server->files != NULL)
+        ? ccnxPortalFileStore_GetSegment(server->files, interestName)
+        : _server_CreateCommandResponse(server, interestName, &cacheHit);
+    if (contentObject == NULL) {
+        return NULL;
+    }
+
+    CCNxMetaMessage *result = ccnxMetaMessage_CreateFromContentObject(contentObject);
+    ccnxContentObject_Release(&contentObject);
+    __atomic_fetch_add(&server->responseCount, 1, __ATOMIC_RELAXED);
+
+    if (server->accessLog) {
+        _AccessRecord *record = parcMemory_Allocate(sizeof(_AccessRecord));
+        if (record != NULL) {
+            record->time = time(0);
+            record->name = ccnxName_Acquire(interestName);
+            record->cacheHit = cacheHit;
+            if (_queue_Put(&server->accessRecords, record, false) == false) {
+                ccnxName_Release(&record->name);
+                parcMemory_Deallocate(&record);
+                __atomic_fetch_add(&server->accessRecordsDropped, 1, __ATOMIC_RELAXED);
             }
-            ccnxMetaMessage_Release(&request);
         }
     }
 
+    return result;
+}
+
+/*
+ * Format access records off the request path. Output is buffered and written in batches.
+ */
+static void *
+_server_AccessLogger(void *argument)
+{
+    _Server *server = argument;
+
+    _AccessRecord *record;
+    while ((record = _queue_Take(&server->accessRecords)) != NULL) {
+        char *name = ccnxName_ToString(record->name);
+        char time[26];
+        ctime_r(&record->time, time);
+        printf("%24.24s  %s%s\n", time, name, record->cacheHit ? "  (cached)" : "");
+        parcMemory_Deallocate((void **) &name);
+
+        ccnxName_Release(&record->name);
+        parcMemory_Deallocate(&record);
+    }
+    fflush(stdout);
+
+    return NULL;
+}
+
+static void
+_server_Report(_Server *server, FILE *output)
+{
+    uint64_t elapsed = _nanoTime() - server->startTime;
+    uint64_t requests = __atomic_load_n(&server->requestCount, __ATOMIC_RELAXED);
+    uint64_t responses = __atomic_load_n(&server->responseCount, __ATOMIC_RELAXED);
+    uint64_t hits = __atomic_load_n(&server->cacheHits, __ATOMIC_RELAXED);
+
+    fprintf(output, "%" PRIu64 " requests, %" PRIu64 " responses (%" PRIu64 " cached) in %.3f seconds, %.1f responses/second",
+            requests, responses, hits, elapsed / 1e9, (elapsed > 0) ? responses * 1e9 / elapsed : 0.0);
+    uint64_t shed = ccnxPortalExecutor_GetShedCount(server->executor);
+    if (shed > 0) {
+        fprintf(output, ", %" PRIu64 " requests shed", shed);
+    }
+    uint64_t dropped = __atomic_load_n(&server->accessRecordsDropped, __ATOMIC_RELAXED);
+    if (dropped > 0) {
+        fprintf(output, ", %" PRIu64 " access log records dropped", dropped);
+    }
+    fprintf(output, "\n");
+    fflush(output);
+}
+
+static void *
+_server_Reporter(void *argument)
+{
+    _Server *server = argument;
+
+    pthread_mutex_lock(&server->reportLock);
+    while (!server->stopping) {
+        struct timespec deadline;
+        clock_gettime(CLOCK_REALTIME, &deadline);
+        deadline.tv_sec += server->options->reportSeconds;
+        pthread_cond_timedwait(&server->reportWakeup, &server->reportLock, &deadline);
+        if (!server->stopping) {
+            _server_Report(server, stderr);
+        }
+    }
+    pthread_mutex_unlock(&server->reportLock);
+
+    return NULL;
+}
+
+int
+ccnServe(const PARCIdentity *identity, const CCNxName *listenName, const char *commandString,
+         const char *recordFile, const char *replayFile, bool fast, const ServerOptions *options)
+{
+    parcSecurity_Init();
+
+    CCNxPortalFactory *factory = ccnxPortalFactory_Create(identity);
+
+    if (recordFile != NULL) {
+        ccnxPortalFactory_SetProperty(factory, CCNxPortalTrace_RecordFile, recordFile);
+    }
+
+    CCNxStackImpl *stackImplementation = ccnxPortalRTA_Message;
+    if (replayFile != NULL) {
+        ccnxPortalFactory_SetProperty(factory, CCNxPortalReplay_File, replayFile);
+        stackImplementation = fast ? ccnxPortalReplay_AsFastAsPossible : ccnxPortalReplay_OriginalTiming;
+    }
+
+    CCNxPortalFileStore *files = NULL;
+    if (options->directory != NULL) {
+        files = ccnxPortalFileStore_Create(options->directory, listenName, options->segmentSize, options->cacheEntries);
+        if (files == NULL) {
+            fprintf(stderr, "Cannot serve '%s': %s\n", options->directory, strerror(errno));
+            ccnxPortalFactory_Release(&factory);
+            parcSecurity_Fini();
+            return 1;
+        }
+    }
+
+    CCNxPortal *portal = ccnxPortalFactory_CreatePortal(factory, stackImplementation);
+    assertNotNull(portal, "Expected a non-null CCNxPortal pointer.");
+
+    CCNxPortalExecutor *executor = ccnxPortalExecutor_Create(options->threads, _serverWorkerQueueCapacity);
+    assertNotNull(executor, "ccnxPortalExecutor_Create(%u, %zu) failed: %s", options->threads, _serverWorkerQueueCapacity, strerror(errno));
+
+    CCNxPortalServer *portalServer = ccnxPortalServer_Create(portal);
+    assertNotNull(portalServer, "Expected a non-null CCNxPortalServer pointer.");
+    ccnxPortalServer_SetExecutor(portalServer, executor);
+
+    _Server server = {
+        .commandString = commandString,
+        .options       = options,
+        .files         = files,
+        .executor      = executor,
+        .accessLog     = (replayFile == NULL),
+        .cache         = parcHashMap_Create(),
+        .stopping      = false
+    };
+    pthread_mutex_init(&server.cacheLock, NULL);
+    pthread_mutex_init(&server.reportLock, NULL);
+    pthread_cond_init(&server.reportWakeup, NULL);
+    _queue_Init(&server.accessRecords, 4096);
+
+    pthread_t accessLogger;
+    pthread_create(&accessLogger, NULL, _server_AccessLogger, &server);
+    pthread_t reporter;
+    if (options->reportSeconds > 0) {
+        pthread_create(&reporter, NULL, _server_Reporter, &server);
+    }
+
+    server.startTime = _nanoTime();
+
+    // The workers only build responses: this thread sends them between receives, so nothing else uses the Portal.
+    if (ccnxPortalServer_Register(portalServer, listenName, _server_Respond, &server) == false) {
+        fprintf(stderr, "ccnxPortal_Listen failed: %d\n", ccnxPortal_GetError(portal));
+    } else if (ccnxPortalServer_Run(portalServer) == false && ccnxPortal_GetError(portal) != ENODATA) {
+        // A replay ends with ENODATA once every recorded Interest has been served.
+        fprintf(stderr, "ccnxPortal_Receive failed: %d\n", ccnxPortal_GetError(portal));
+    }
+
+    // Waits for the handlers still running, and sends their responses.
+    ccnxPortalServer_Release(&portalServer);
+
+    _queue_Close(&server.accessRecords);
+    pthread_join(accessLogger, NULL);
+    if (options->reportSeconds > 0) {
+        pthread_mutex_lock(&server.reportLock);
+        server.stopping = true;
+        pthread_cond_signal(&server.reportWakeup);
+        pthread_mutex_unlock(&server.reportLock);
+        pthread_join(reporter, NULL);
+    }
+
+    _server_Report(&server, stdout);
+
+    ccnxPortalExecutor_Release(&executor);
+    _queue_Fini(&server.accessRecords);
+    parcHashMap_Release(&server.cache);
+    pthread_cond_destroy(&server.reportWakeup);
+    pthread_mutex_destroy(&server.reportLock);
+    pthread_mutex_destroy(&server.cacheLock);
+
     ccnxPortal_Release(&portal);
 
+    // The file segments sent through the portal are views of the store's mapped files.
+    if (files != NULL) {
+        ccnxPortalFileStore_Release(&files);
+    }
+
     ccnxPortalFactory_Release(&factory);
 
     parcSecurity_Fini();
@@ -171,12 +582,23 @@ ccnServe(const PARCIdentity *identity, const CCNxName *listenName, const char *c
 void
 usage(void)
 {
-    printf("ccnx-server --identity <file> --password <password> lci:/ccn-name command-to-execute\n");
+    printf("ccnx-server --identity <file> --password <password> [options] [--record <file>] lci:/ccn-name command-to-execute\n");
+    printf("ccnx-server --identity <file> --password <password> [options] --replay <file> [--fast] lci:/ccn-name command-to-execute\n");
+    printf("ccnx-server --identity <file> --password <password> [options] --directory <path> [--segment-size <bytes>] lci:/ccn-name\n");
     printf("ccnx-server [-h | --help]\n");
     printf("ccnx-server [-v | --version]\n");
     printf("\n");
     printf("    --identity         The file name containing a PKCS12 keystore\n");
     printf("    --password         The password to unlock the keystore\n");
+    printf("    --record           Record all traffic to the given trace file\n");
+    printf("    --replay           Serve the Interests in the given trace file instead of the network\n");
+    printf("    --fast             Replay as fast as possible rather than at the recorded timing\n");
+    printf("    --threads          The number of worker threads running the command (default 4)\n");
+    printf("    --cache-ttl        Seconds to reuse the response for a name without running the command (default 1, 0 disables)\n");
+    printf("    --cache-size       The maximum number of cached responses or file segments (default 10000)\n");
+    printf("    --report           Print a throughput report every given number of seconds (default 0, only at exit)\n");
+    printf("    --directory        Serve the files under this directory as lci:/ccn-name/path/chunk=N instead of running a command\n");
+    printf("    --segment-size     The number of bytes of file data in each segment (default 4096)\n");
     printf("    lci:/ccn-name      The LCI name of the object fetch\n");
     printf("    program-to-execute The program to run (eg. /bin/date)\n");
 }
@@ -188,14 +610,34 @@ main(int argc, char *argv[argc])
     char *keystorePassword = NULL;
     char *commandString = "/bin/date";
     char *listenName = "lci:/Server";
+    char *recordFile = NULL;
+    char *replayFile = NULL;
+    bool fast = false;
+    ServerOptions options = {
+        .threads       = 4,
+        .cacheSeconds  = 1,
+        .cacheEntries  = 10000,
+        .reportSeconds = 0,
+        .directory     = NULL,
+        .segmentSize   = 4096
+    };
 
     /* options descriptor */
     static struct option longopts[] = {
-        { "identity", required_argument, NULL, 'f' },
-        { "password", required_argument, NULL, 'p' },
-        { "help",     no_argument,       NULL, 'h' },
-        { "version",  no_argument,       NULL, 'v' },
-        { NULL,       0,                 NULL, 0   }
+        { "identity",     required_argument, NULL, 'f' },
+        { "password",     required_argument, NULL, 'p' },
+        { "record",       required_argument, NULL, 'r' },
+        { "replay",       required_argument, NULL, 'R' },
+        { "fast",         no_argument,       NULL, 'F' },
+        { "threads",      required_argument, NULL, 't' },
+        { "cache-ttl",    required_argument, NULL, 'T' },
+        { "cache-size",   required_argument, NULL, 'S' },
+        { "report",       required_argument, NULL, 'i' },
+        { "directory",    required_argument, NULL, 'd' },
+        { "segment-size", required_argument, NULL, 's' },
+        { "help",         no_argument,       NULL, 'h' },
+        { "version",      no_argument,       NULL, 'v' },
+        { NULL,           0,                 NULL, 0   }
     };
 
     if (argc < 2) {
@@ -214,6 +656,53 @@ main(int argc, char *argv[argc])
                 keystorePassword = optarg;
                 break;
 
+            case 'r':
+                recordFile = optarg;
+                break;
+
+            case 'R':
+                replayFile = optarg;
+                break;
+
+            case 'F':
+                fast = true;
+                break;
+
+            case 't':
+                options.threads = (unsigned int) strtoul(optarg, NULL, 10);
+                if (options.threads == 0) {
+                    printf("--threads must be at least 1.\n");
+                    return -1;
+                }
+                break;
+
+            case 'T':
+                options.cacheSeconds = (unsigned int) strtoul(optarg, NULL, 10);
+                break;
+
+            case 'S':
+                options.cacheEntries = (size_t) strtoul(optarg, NULL, 10);
+                if (options.cacheEntries == 0) {
+                    options.cacheSeconds = 0;
+                }
+                break;
+
+            case 'i':
+                options.reportSeconds = (unsigned int) strtoul(optarg, NULL, 10);
+                break;
+
+            case 'd':
+                options.directory = optarg;
+                break;
+
+            case 's':
+                options.segmentSize = (size_t) strtoul(optarg, NULL, 10);
+                if (options.segmentSize == 0) {
+                    printf("--segment-size must be at least 1.\n");
+                    return -1;
+                }
+                break;
+
             case 'v':
                 printf("%s\n", ccnxPortalServerAbout_Version());
                 return 0;
@@ -251,7 +740,7 @@ main(int argc, char *argv[argc])
 
     CCNxName *name = ccnxName_CreateFromCString(listenName);
 
-    int result = ccnServe(identity, name, commandString);
+    int result = ccnServe(identity, name, commandString, recordFile, replayFile, fast, &options);
 
     ccnxName_Release(&name);
 
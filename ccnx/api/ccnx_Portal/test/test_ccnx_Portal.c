@@ -58,6 +58,7 @@
 #include <LongBow/unit-test.h>
 #include <LongBow/debugging.h>
 
+#include <inttypes.h>
 #include <stdio.h>
 #include <sys/errno.h>
 
@@ -112,10 +113,14 @@ LONGBOW_TEST_FIXTURE(Global)
     LONGBOW_RUN_TEST_CASE(Global, ccnxPortal_Open_NonBlocking);
 
     LONGBOW_RUN_TEST_CASE(Global, ccnxPortal_Send);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortal_SendInterestTemplate);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortal_SendPayload);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortal_SendPayloadVector);
     LONGBOW_RUN_TEST_CASE(Global, ccnxPortal_GetStatus);
     LONGBOW_RUN_TEST_CASE(Global, ccnxPortal_GetError);
     LONGBOW_RUN_TEST_CASE(Global, ccnxPortal_GetFileId);
     LONGBOW_RUN_TEST_CASE(Global, ccnxPortal_Listen);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortal_Listen_NameTooLong);
     LONGBOW_RUN_TEST_CASE(Global, ccnxPortal_Ignore);
     LONGBOW_RUN_TEST_CASE(Global, ccnxPortal_GetKeyId);
 
@@ -128,6 +133,14 @@ LONGBOW_TEST_FIXTURE(Global)
     LONGBOW_RUN_TEST_CASE(Global, ccnxPortal_Receive_ImmediateTimeout);
     LONGBOW_RUN_TEST_CASE(Global, ccnxPortal_Receive_ImmediateTimeout_NoData);
     LONGBOW_RUN_TEST_CASE(Global, ccnxPortal_Receive_5SecondTimeout);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortal_ReceiveBatch);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortal_ReceiveBatch_Arena);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortal_ReceiveBatch_Arena_Interceptor);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortal_EnableRetransmission);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortal_Retransmission_Answered);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortal_Retransmission_Lost);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortal_Retransmission_InterestTemplate);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortal_Retransmission_Arena);
    
     LONGBOW_RUN_TEST_CASE(Global, ccnxPortal_Send_NeverTimeout);
     LONGBOW_RUN_TEST_CASE(Global, ccnxPortal_Send_ImmediateTimeout);
@@ -249,6 +262,101 @@ LONGBOW_TEST_CASE(Global, ccnxPortal_Send)
     assertTrue(actual, "Expected ccnxPortal_Send to be successful.");
 }
 
+LONGBOW_TEST_CASE(Global, ccnxPortal_SendInterestTemplate)
+{
+    TestData *data = longBowTestCase_GetClipBoardData(testCase);
+
+    CCNxPortal *portalOut = ccnxPortalFactory_CreatePortal(data->factory, TEST_STACK);
+    CCNxPortal *portalIn = ccnxPortalFactory_CreatePortal(data->factory, TEST_STACK);
+
+    CCNxName *name = ccnxName_CreateFromCString("lci:/Hello/World");
+    CCNxInterest *interest = ccnxInterest_CreateSimple(name);
+    CCNxPortalInterestTemplate *template = ccnxPortalInterestTemplate_Create(interest);
+
+    assertTrue(ccnxPortal_SendInterestTemplate(portalOut, template, 42, CCNxStackTimeout_Never), "Expected the send to succeed.");
+    sleep(2);
+
+    CCNxMetaMessage *message = ccnxPortal_Receive(portalIn, CCNxStackTimeout_Immediate);
+    assertNotNull(message, "Expected the Interest to be received.");
+    assertTrue(ccnxMetaMessage_IsInterest(message), "Expected an Interest.");
+
+    ccnxMetaMessage_Release(&message);
+    ccnxPortalInterestTemplate_Release(&template);
+    ccnxInterest_Release(&interest);
+    ccnxName_Release(&name);
+    ccnxPortal_Release(&portalIn);
+    ccnxPortal_Release(&portalOut);
+}
+
+static void
+_countPayloadRelease(void *memory, size_t length, void *context)
+{
+    (*(int *) context)++;
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortal_SendPayload)
+{
+    TestData *data = longBowTestCase_GetClipBoardData(testCase);
+
+    CCNxPortal *portalOut = ccnxPortalFactory_CreatePortal(data->factory, TEST_STACK);
+    CCNxPortal *portalIn = ccnxPortalFactory_CreatePortal(data->factory, TEST_STACK);
+
+    CCNxName *name = ccnxName_CreateFromCString("lci:/Hello/World");
+    char payload[] = "Hello World";
+    int releases = 0;
+
+    assertTrue(ccnxPortal_SendPayload(portalOut, name, payload, sizeof(payload), _countPayloadRelease, &releases, CCNxStackTimeout_Never),
+               "Expected the send to succeed.");
+    sleep(2);
+
+    CCNxMetaMessage *message = ccnxPortal_Receive(portalIn, CCNxStackTimeout_Immediate);
+    assertNotNull(message, "Expected the Content Object to be received.");
+    PARCBuffer *received = ccnxContentObject_GetPayload(ccnxMetaMessage_GetContentObject(message));
+    assertTrue(parcBuffer_Remaining(received) == sizeof(payload), "Expected the whole payload.");
+    ccnxMetaMessage_Release(&message);
+
+    // Wait for the stack to release its references.
+    for (int i = 0; i < 100 && ccnxPortal_ReclaimPayloads(portalOut) > 0; i++) {
+        usleep(10000);
+    }
+    assertTrue(releases == 1, "Expected the release function to be called once, actual %d", releases);
+
+    ccnxName_Release(&name);
+    ccnxPortal_Release(&portalIn);
+    ccnxPortal_Release(&portalOut);
+    assertTrue(releases == 1, "Expected the release function to be called only once, actual %d", releases);
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortal_SendPayloadVector)
+{
+    TestData *data = longBowTestCase_GetClipBoardData(testCase);
+
+    CCNxPortal *portalOut = ccnxPortalFactory_CreatePortal(data->factory, TEST_STACK);
+    CCNxPortal *portalIn = ccnxPortalFactory_CreatePortal(data->factory, TEST_STACK);
+
+    CCNxName *name = ccnxName_CreateFromCString("lci:/Hello/World");
+    CCNxPortalPayloadVector *payload = ccnxPortalPayloadVector_Create();
+    PARCBuffer *hello = parcBuffer_WrapCString("Hello ");
+    PARCBuffer *world = parcBuffer_WrapCString("World");
+    ccnxPortalPayloadVector_Append(payload, hello);
+    ccnxPortalPayloadVector_Append(payload, world);
+
+    assertTrue(ccnxPortal_SendPayloadVector(portalOut, name, payload, CCNxStackTimeout_Never), "Expected the send to succeed.");
+    sleep(2);
+
+    CCNxMetaMessage *message = ccnxPortal_Receive(portalIn, CCNxStackTimeout_Immediate);
+    assertNotNull(message, "Expected the Content Object to be received.");
+    assertTrue(ccnxMetaMessage_IsContentObject(message), "Expected a Content Object.");
+
+    ccnxMetaMessage_Release(&message);
+    parcBuffer_Release(&world);
+    parcBuffer_Release(&hello);
+    ccnxPortalPayloadVector_Release(&payload);
+    ccnxName_Release(&name);
+    ccnxPortal_Release(&portalIn);
+    ccnxPortal_Release(&portalOut);
+}
+
 LONGBOW_TEST_CASE(Global, ccnxPortal_GetStatus)
 {
     TestData *data = longBowTestCase_GetClipBoardData(testCase);
@@ -377,12 +485,47 @@ LONGBOW_TEST_CASE(Global, ccnxPortal_Listen)
 
     CCNxName *name = ccnxName_CreateFromCString("lci:/Hello/World");
     bool actual = ccnxPortal_Listen(portal, name, 60, CCNxStackTimeout_Never);
-   
+
+    CCNxPortalAnchor *anchor = ccnxPortalAnchorRegistry_Get(ccnxPortal_GetAnchors(portal), name);
+    bool anchored = (anchor != NULL);
+
+    ccnxPortal_Ignore(portal, name, CCNxStackTimeout_Never);
+    bool removed = (ccnxPortalAnchorRegistry_Get(ccnxPortal_GetAnchors(portal), name) == NULL);
+
     ccnxName_Release(&name);
 
     ccnxPortal_Release(&portal);
 
     assertTrue(actual, "Expected ccnxPortal_Listen to return true");
+    assertTrue(anchored, "Expected ccnxPortal_Listen to record its anchor");
+    assertTrue(removed, "Expected ccnxPortal_Ignore to remove the anchor");
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortal_Listen_NameTooLong)
+{
+    TestData *data = longBowTestCase_GetClipBoardData(testCase);
+
+    CCNxPortal *portal = ccnxPortalFactory_CreatePortal(data->factory, TEST_STACK);
+
+    // A name segment longer than the anchor encoding allows.
+    CCNxName *name = ccnxName_CreateFromCString("lci:/Hello");
+    PARCBuffer *value = parcBuffer_Allocate(UINT16_MAX + 1);
+    CCNxNameSegment *segment = ccnxNameSegment_CreateTypeValue(CCNxNameLabelType_NAME, value);
+    ccnxName_Append(name, segment);
+    ccnxNameSegment_Release(&segment);
+    parcBuffer_Release(&value);
+
+    bool actual = ccnxPortal_Listen(portal, name, 60, CCNxStackTimeout_Never);
+    int error = ccnxPortal_GetError(portal);
+    bool anchored = (ccnxPortalAnchorRegistry_Get(ccnxPortal_GetAnchors(portal), name) != NULL);
+
+    ccnxName_Release(&name);
+
+    ccnxPortal_Release(&portal);
+
+    assertFalse(actual, "Expected ccnxPortal_Listen to fail for a name too long to anchor");
+    assertTrue(error == ENAMETOOLONG, "Expected ENAMETOOLONG, actual %d", error);
+    assertFalse(anchored, "Expected no anchor to be recorded");
 }
 
 LONGBOW_TEST_CASE(Global, ccnxPortal_Ignore)
@@ -562,6 +705,319 @@ LONGBOW_TEST_CASE(Global, ccnxPortal_Receive_ImmediateTimeout_NoData)
     ccnxPortal_Release(&portalIn);
 }
 
+LONGBOW_TEST_CASE(Global, ccnxPortal_ReceiveBatch)
+{
+    TestData *data = longBowTestCase_GetClipBoardData(testCase);
+
+    CCNxPortal *portalOut = ccnxPortalFactory_CreatePortal(data->factory, TEST_STACK);
+    CCNxPortal *portalIn = ccnxPortalFactory_CreatePortal(data->factory, TEST_STACK);
+
+    CCNxPortalAttributes *attributes = ccnxPortalAttributes_Copy(ccnxPortal_GetAttributes(portalIn));
+    ccnxPortalAttributes_SetMaxBatchSize(attributes, 2);
+    ccnxPortal_SetAttributes(portalIn, attributes);
+    ccnxPortalAttributes_Release(&attributes);
+
+    CCNxName *name = ccnxName_CreateFromCString("lci:/Hello/World");
+    CCNxInterest *interest = ccnxInterest_CreateSimple(name);
+    ccnxName_Release(&name);
+    CCNxMetaMessage *interestMessage = ccnxMetaMessage_CreateFromInterest(interest);
+
+    for (int i = 0; i < 3; i++) {
+        assertTrue(ccnxPortal_Send(portalOut, interestMessage, CCNxStackTimeout_Never), "Expected the send to succeed.");
+    }
+    ccnxMetaMessage_Release(&interestMessage);
+    sleep(2);
+
+    CCNxMetaMessage *messages[8];
+    size_t count = ccnxPortal_ReceiveBatch(portalIn, messages, 8, NULL, CCNxStackTimeout_Never);
+    assertTrue(count == 2, "Expected the batch to be limited to the maximum batch size, actual %zu", count);
+    for (size_t i = 0; i < count; i++) {
+        ccnxMetaMessage_Release(&messages[i]);
+    }
+
+    count = ccnxPortal_ReceiveBatch(portalIn, messages, 8, NULL, CCNxStackTimeout_Never);
+    assertTrue(count == 1, "Expected the remaining message, actual %zu", count);
+    assertTrue(ccnxInterest_Equals(interest, ccnxMetaMessage_GetInterest(messages[0])), "Expected Interest to be received.");
+    assertFalse(ccnxPortal_IsError(portalIn), "Expected no error after a partial batch.");
+    ccnxMetaMessage_Release(&messages[0]);
+
+    count = ccnxPortal_ReceiveBatch(portalIn, messages, 8, NULL, CCNxStackTimeout_Immediate);
+    assertTrue(count == 0, "Expected an empty batch, actual %zu", count);
+
+    ccnxInterest_Release(&interest);
+    ccnxPortal_Release(&portalIn);
+    ccnxPortal_Release(&portalOut);
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortal_ReceiveBatch_Arena)
+{
+    TestData *data = longBowTestCase_GetClipBoardData(testCase);
+
+    CCNxPortal *portalOut = ccnxPortalFactory_CreatePortal(data->factory, TEST_STACK);
+    CCNxPortal *portalIn = ccnxPortalFactory_CreatePortal(data->factory, TEST_STACK);
+    ccnxPortalArena_Install();
+    CCNxPortalArena *arena = ccnxPortalArena_Create();
+
+    CCNxName *name = ccnxName_CreateFromCString("lci:/Hello/World");
+    CCNxInterest *interest = ccnxInterest_CreateSimple(name);
+    ccnxName_Release(&name);
+    CCNxMetaMessage *interestMessage = ccnxMetaMessage_CreateFromInterest(interest);
+    ccnxPortal_Send(portalOut, interestMessage, CCNxStackTimeout_Never);
+    ccnxMetaMessage_Release(&interestMessage);
+    sleep(2);
+
+    CCNxMetaMessage *messages[1];
+    size_t count = ccnxPortal_ReceiveBatch(portalIn, messages, 1, arena, CCNxStackTimeout_Never);
+    assertTrue(count == 1, "Expected one message, actual %zu", count);
+    assertTrue(ccnxInterest_Equals(interest, ccnxMetaMessage_GetInterest(messages[0])), "Expected Interest to be received.");
+    ccnxMetaMessage_Release(&messages[0]);
+    ccnxPortalArena_Reset(arena);
+
+    ccnxPortalArena_Release(&arena);
+    ccnxPortalArena_Uninstall();
+    ccnxInterest_Release(&interest);
+    ccnxPortal_Release(&portalIn);
+    ccnxPortal_Release(&portalOut);
+}
+
+/*
+ * An interceptor that keeps a copy of the name of every message it receives.
+ */
+static CCNxMetaMessage *
+_retainingReceive(void *state, const CCNxPortalInterceptor *next, const CCNxStackTimeout *microSeconds)
+{
+    CCNxName **retained = state;
+
+    CCNxMetaMessage *result = ccnxPortalInterceptor_Receive(next, microSeconds);
+    if (result != NULL && ccnxMetaMessage_IsInterest(result)) {
+        if (*retained != NULL) {
+            ccnxName_Release(retained);
+        }
+        *retained = ccnxName_Copy(ccnxInterest_GetName(ccnxMetaMessage_GetInterest(result)));
+    }
+    return result;
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortal_ReceiveBatch_Arena_Interceptor)
+{
+    TestData *data = longBowTestCase_GetClipBoardData(testCase);
+
+    CCNxPortal *portalOut = ccnxPortalFactory_CreatePortal(data->factory, TEST_STACK);
+    CCNxPortal *portalIn = ccnxPortalFactory_CreatePortal(data->factory, TEST_STACK);
+    CCNxName *retained = NULL;
+    CCNxPortalInterceptor *interceptor = ccnxPortalInterceptor_Create(NULL, _retainingReceive, NULL, NULL, &retained, NULL);
+    ccnxPortal_AddInterceptor(portalIn, interceptor);
+    ccnxPortalInterceptor_Release(&interceptor);
+    ccnxPortalArena_Install();
+    CCNxPortalArena *arena = ccnxPortalArena_Create();
+
+    CCNxName *name = ccnxName_CreateFromCString("lci:/Hello/World");
+    CCNxInterest *interest = ccnxInterest_CreateSimple(name);
+    CCNxMetaMessage *interestMessage = ccnxMetaMessage_CreateFromInterest(interest);
+    ccnxPortal_Send(portalOut, interestMessage, CCNxStackTimeout_Never);
+    ccnxMetaMessage_Release(&interestMessage);
+    sleep(2);
+
+    CCNxMetaMessage *messages[1];
+    size_t count = ccnxPortal_ReceiveBatch(portalIn, messages, 1, arena, CCNxStackTimeout_Never);
+    assertTrue(count == 1, "Expected one message, actual %zu", count);
+    ccnxMetaMessage_Release(&messages[0]);
+
+    // Resetting traps if anything the interceptor kept had come from the arena.
+    ccnxPortalArena_Reset(arena);
+    assertNotNull(retained, "Expected the interceptor to have seen the Interest.");
+    assertTrue(ccnxName_Equals(name, retained), "Expected the retained name to survive the arena reset.");
+
+    ccnxName_Release(&retained);
+    ccnxPortalArena_Release(&arena);
+    ccnxPortalArena_Uninstall();
+    ccnxName_Release(&name);
+    ccnxInterest_Release(&interest);
+    ccnxPortal_Release(&portalIn);
+    ccnxPortal_Release(&portalOut);
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortal_EnableRetransmission)
+{
+    TestData *data = longBowTestCase_GetClipBoardData(testCase);
+
+    CCNxPortal *portal = ccnxPortalFactory_CreatePortal(data->factory, TEST_STACK);
+    assertNull(ccnxPortal_GetRetransmitter(portal), "Expected retransmission to be disabled by default.");
+
+    assertTrue(ccnxPortal_EnableRetransmission(portal, 3), "Expected retransmission to be enabled.");
+    assertNotNull(ccnxPortal_GetRetransmitter(portal), "Expected a retransmitter.");
+
+    ccnxPortal_DisableRetransmission(portal);
+    assertNull(ccnxPortal_GetRetransmitter(portal), "Expected retransmission to be disabled.");
+
+    ccnxPortal_Release(&portal);
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortal_Retransmission_Answered)
+{
+    TestData *data = longBowTestCase_GetClipBoardData(testCase);
+
+    CCNxPortal *portalOut = ccnxPortalFactory_CreatePortal(data->factory, TEST_STACK);
+    CCNxPortal *portalIn = ccnxPortalFactory_CreatePortal(data->factory, TEST_STACK);
+    ccnxPortal_EnableRetransmission(portalOut, 3);
+    const CCNxPortalRetransmitter *retransmitter = ccnxPortal_GetRetransmitter(portalOut);
+
+    CCNxName *name = ccnxName_CreateFromCString("lci:/Hello/World/1");
+    CCNxInterest *interest = ccnxInterest_CreateSimple(name);
+    CCNxMetaMessage *interestMessage = ccnxMetaMessage_CreateFromInterest(interest);
+    ccnxPortal_Send(portalOut, interestMessage, CCNxStackTimeout_Never);
+    ccnxMetaMessage_Release(&interestMessage);
+    assertTrue(ccnxPortalRetransmitter_GetPending(retransmitter) == 1, "Expected the Interest to be tracked.");
+
+    CCNxMetaMessage *request = ccnxPortal_Receive(portalIn, CCNxStackTimeout_MicroSeconds(5000000));
+    assertNotNull(request, "Expected the Interest to be received.");
+    ccnxMetaMessage_Release(&request);
+
+    CCNxContentObject *contentObject = ccnxContentObject_CreateWithNameAndPayload(name, NULL);
+    CCNxMetaMessage *contentObjectMessage = ccnxMetaMessage_CreateFromContentObject(contentObject);
+    ccnxPortal_Send(portalIn, contentObjectMessage, CCNxStackTimeout_Never);
+    ccnxMetaMessage_Release(&contentObjectMessage);
+    ccnxContentObject_Release(&contentObject);
+
+    CCNxMetaMessage *response = ccnxPortal_Receive(portalOut, CCNxStackTimeout_MicroSeconds(5000000));
+    assertNotNull(response, "Expected the Content Object to be received.");
+    assertTrue(ccnxMetaMessage_IsContentObject(response), "Expected a Content Object.");
+    ccnxMetaMessage_Release(&response);
+
+    assertTrue(ccnxPortalRetransmitter_GetPending(retransmitter) == 0, "Expected the Content Object to answer the Interest.");
+    CCNxPortalRttEstimate estimate;
+    assertTrue(ccnxPortalRttEstimator_GetEstimate(ccnxPortalRetransmitter_GetRttEstimator(retransmitter), name, &estimate),
+               "Expected the round trip to be measured.");
+    assertTrue(estimate.samples == 1, "Expected 1 sample, actual %" PRIu64, estimate.samples);
+
+    ccnxInterest_Release(&interest);
+    ccnxName_Release(&name);
+    ccnxPortal_Release(&portalIn);
+    ccnxPortal_Release(&portalOut);
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortal_Retransmission_Arena)
+{
+    TestData *data = longBowTestCase_GetClipBoardData(testCase);
+
+    CCNxPortal *portalOut = ccnxPortalFactory_CreatePortal(data->factory, TEST_STACK);
+    CCNxPortal *portalIn = ccnxPortalFactory_CreatePortal(data->factory, TEST_STACK);
+    ccnxPortal_EnableRetransmission(portalOut, 3);
+    const CCNxPortalRetransmitter *retransmitter = ccnxPortal_GetRetransmitter(portalOut);
+    ccnxPortalArena_Install();
+    CCNxPortalArena *arena = ccnxPortalArena_Create();
+
+    CCNxName *name = ccnxName_CreateFromCString("lci:/Hello/World/1");
+    CCNxInterest *interest = ccnxInterest_CreateSimple(name);
+    CCNxMetaMessage *interestMessage = ccnxMetaMessage_CreateFromInterest(interest);
+    ccnxPortal_Send(portalOut, interestMessage, CCNxStackTimeout_Never);
+    ccnxMetaMessage_Release(&interestMessage);
+
+    CCNxMetaMessage *request = ccnxPortal_Receive(portalIn, CCNxStackTimeout_MicroSeconds(5000000));
+    assertNotNull(request, "Expected the Interest to be received.");
+    ccnxMetaMessage_Release(&request);
+
+    CCNxContentObject *contentObject = ccnxContentObject_CreateWithNameAndPayload(name, NULL);
+    CCNxMetaMessage *contentObjectMessage = ccnxMetaMessage_CreateFromContentObject(contentObject);
+    ccnxPortal_Send(portalIn, contentObjectMessage, CCNxStackTimeout_Never);
+    ccnxMetaMessage_Release(&contentObjectMessage);
+    ccnxContentObject_Release(&contentObject);
+
+    CCNxMetaMessage *messages[1];
+    size_t count = ccnxPortal_ReceiveBatch(portalOut, messages, 1, arena, CCNxStackTimeout_MicroSeconds(5000000));
+    assertTrue(count == 1, "Expected one message, actual %zu", count);
+    assertTrue(ccnxMetaMessage_IsContentObject(messages[0]), "Expected a Content Object.");
+    ccnxMetaMessage_Release(&messages[0]);
+    ccnxPortalArena_Reset(arena);
+
+    // Reuse the arena's memory so that anything the retransmitter left in it is overwritten.
+    void *filler[64];
+    ccnxPortalArena_Begin(arena);
+    for (int i = 0; i < 64; i++) {
+        filler[i] = parcMemory_Allocate(64);
+        memset(filler[i], 0xA5, 64);
+    }
+    ccnxPortalArena_End(arena);
+    for (int i = 0; i < 64; i++) {
+        parcMemory_Deallocate(&filler[i]);
+    }
+
+    CCNxPortalRttEstimate estimate;
+    assertTrue(ccnxPortalRttEstimator_GetEstimate(ccnxPortalRetransmitter_GetRttEstimator(retransmitter), name, &estimate),
+               "Expected the round trip estimate to survive the arena reset.");
+    assertTrue(estimate.samples == 1, "Expected 1 sample, actual %" PRIu64, estimate.samples);
+
+    ccnxPortalArena_Reset(arena);
+    ccnxPortalArena_Release(&arena);
+    ccnxPortalArena_Uninstall();
+    ccnxInterest_Release(&interest);
+    ccnxName_Release(&name);
+    ccnxPortal_Release(&portalIn);
+    ccnxPortal_Release(&portalOut);
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortal_Retransmission_InterestTemplate)
+{
+    TestData *data = longBowTestCase_GetClipBoardData(testCase);
+
+    CCNxPortal *portal = ccnxPortalFactory_CreatePortal(data->factory, TEST_STACK);
+    ccnxPortal_EnableRetransmission(portal, 3);
+
+    CCNxName *name = ccnxName_CreateFromCString("lci:/Hello/World");
+    CCNxInterest *interest = ccnxInterest_CreateSimple(name);
+    CCNxPortalInterestTemplate *template = ccnxPortalInterestTemplate_Create(interest);
+
+    assertTrue(ccnxPortal_SendInterestTemplate(portal, template, 42, CCNxStackTimeout_Never), "Expected the send to succeed.");
+
+    // Template Interests are only wire format, so they are sent but not retransmitted.
+    const CCNxPortalRetransmitter *retransmitter = ccnxPortal_GetRetransmitter(portal);
+    assertTrue(ccnxPortalRetransmitter_GetPending(retransmitter) == 0, "Expected the template Interest not to be tracked.");
+    assertTrue(ccnxPortalRetransmitter_GetUntracked(retransmitter) == 1, "Expected the template Interest to be counted as untracked.");
+
+    ccnxPortalInterestTemplate_Release(&template);
+    ccnxInterest_Release(&interest);
+    ccnxName_Release(&name);
+    ccnxPortal_Release(&portal);
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortal_Retransmission_Lost)
+{
+    TestData *data = longBowTestCase_GetClipBoardData(testCase);
+
+    CCNxPortal *portal = ccnxPortalFactory_CreatePortal(data->factory, TEST_STACK);
+    ccnxPortal_EnableRetransmission(portal, 2);
+    const CCNxPortalRetransmitter *retransmitter = ccnxPortal_GetRetransmitter(portal);
+    ccnxPortalRttEstimator_SetBounds(ccnxPortalRetransmitter_GetRttEstimator(retransmitter), 10000, 10000, 80000);
+
+    CCNxName *name = ccnxName_CreateFromCString("lci:/Hello/World/1");
+    CCNxInterest *interest = ccnxInterest_CreateSimple(name);
+    CCNxMetaMessage *interestMessage = ccnxMetaMessage_CreateFromInterest(interest);
+    ccnxPortal_Send(portal, interestMessage, CCNxStackTimeout_Never);
+    ccnxMetaMessage_Release(&interestMessage);
+
+    // Nothing answers, so the Interest is sent after 10ms and 20ms more, then given up after another 40ms.
+    uint64_t end = ccnxPortalStatistics_Now() + 500000000ULL;
+    while (ccnxPortalStatistics_Now() < end) {
+        CCNxMetaMessage *message = ccnxPortal_Receive(portal, CCNxStackTimeout_MicroSeconds(10000));
+        if (message != NULL) {
+            ccnxMetaMessage_Release(&message);
+        }
+    }
+
+    assertTrue(ccnxPortalRetransmitter_GetRetransmissions(retransmitter) == 2,
+               "Expected 2 retransmissions, actual %" PRIu64, ccnxPortalRetransmitter_GetRetransmissions(retransmitter));
+    assertTrue(ccnxPortalRetransmitter_GetLost(retransmitter) == 1, "Expected the Interest to be given up.");
+    assertTrue(ccnxPortalRetransmitter_GetPending(retransmitter) == 0, "Expected no pending Interests.");
+
+    CCNxPortalRttEstimate estimate;
+    ccnxPortalRttEstimator_GetEstimate(ccnxPortalRetransmitter_GetRttEstimator(retransmitter), name, &estimate);
+    assertTrue(estimate.timeouts == 3, "Expected 3 timeouts, actual %" PRIu64, estimate.timeouts);
+
+    ccnxInterest_Release(&interest);
+    ccnxName_Release(&name);
+    ccnxPortal_Release(&portal);
+}
+
 LONGBOW_TEST_CASE(Global, ccnxPortal_Receive_5SecondTimeout)
 {
     TestData *data = longBowTestCase_GetClipBoardData(testCase);
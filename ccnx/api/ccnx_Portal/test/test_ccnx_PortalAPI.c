@@ -63,6 +63,7 @@
 
 #include <stdio.h>
 #include <unistd.h>
+#include <errno.h>
 
 #include <ccnx/api/ccnx_Portal/ccnx_PortalAPI.h>
 #include <parc/algol/parc_Memory.h>
@@ -95,6 +96,9 @@ LONGBOW_TEST_FIXTURE(Global)
     LONGBOW_RUN_TEST_CASE(Global, ccnxPortalAPI_CreateRelease);
     LONGBOW_RUN_TEST_CASE(Global, ccnxPortalAPI_SendReceive);
     LONGBOW_RUN_TEST_CASE(Global, ccnxPortalAPI_GetFileId);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortalAPI_QueueLimit);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortalAPI_QueueGrowth);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortalAPI_ReleaseQueued);
 }
 
 static size_t InitialMemoryOutstanding = 0;
@@ -206,6 +210,100 @@ LONGBOW_TEST_CASE(Global, ccnxPortalAPI_GetFileId)
     ccnxPortal_Release(&portal);
 }
 
+LONGBOW_TEST_CASE(Global, ccnxPortalAPI_QueueLimit)
+{
+    CCNxPortalFactory *factory = longBowTestCase_GetClipBoardData(testCase);
+
+    CCNxPortal *portal = ccnxPortalFactory_CreatePortal(factory, ccnxPortalAPI_LoopBack);
+
+    CCNxPortalAttributes *attributes = ccnxPortalAttributes_Copy(ccnxPortal_GetAttributes(portal));
+    ccnxPortalAttributes_SetReceiveQueueLimit(attributes, 2);
+    assertTrue(ccnxPortal_SetAttributes(portal, attributes), "Expected ccnxPortal_SetAttributes to succeed");
+    ccnxPortalAttributes_Release(&attributes);
+
+    assertTrue(ccnxPortalAttributes_GetReceiveQueueLimit(ccnxPortal_GetAttributes(portal)) == 2, "Expected the new limit to be in effect");
+
+    CCNxName *name = ccnxName_CreateFromCString("lci:/Hello/World");
+    CCNxInterest *interest = ccnxInterest_CreateSimple(name);
+    CCNxMetaMessage *message = ccnxMetaMessage_CreateFromInterest(interest);
+
+    assertTrue(ccnxPortal_Send(portal, message, CCNxStackTimeout_Never), "Expected the first send to succeed");
+    assertTrue(ccnxPortal_Send(portal, message, CCNxStackTimeout_Never), "Expected the second send to succeed");
+    assertFalse(ccnxPortal_Send(portal, message, CCNxStackTimeout_Never), "Expected the third send to exceed the queue limit");
+    assertTrue(ccnxPortal_GetError(portal) == ENOBUFS, "Expected ENOBUFS, actual %d", ccnxPortal_GetError(portal));
+
+    for (int i = 0; i < 2; i++) {
+        CCNxMetaMessage *received = ccnxPortal_Receive(portal, CCNxStackTimeout_Never);
+        ccnxMetaMessage_Release(&received);
+    }
+
+    ccnxMetaMessage_Release(&message);
+    ccnxInterest_Release(&interest);
+    ccnxName_Release(&name);
+    ccnxPortal_Release(&portal);
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortalAPI_QueueGrowth)
+{
+    CCNxPortalFactory *factory = longBowTestCase_GetClipBoardData(testCase);
+
+    CCNxPortal *portal = ccnxPortalFactory_CreatePortal(factory, ccnxPortalAPI_LoopBack);
+
+    CCNxInterest *interests[100];
+    for (int i = 0; i < 100; i++) {
+        char uri[64];
+        sprintf(uri, "lci:/Hello/World/%d", i);
+        CCNxName *name = ccnxName_CreateFromCString(uri);
+        interests[i] = ccnxInterest_CreateSimple(name);
+        ccnxName_Release(&name);
+
+        CCNxMetaMessage *message = ccnxMetaMessage_CreateFromInterest(interests[i]);
+        assertTrue(ccnxPortal_Send(portal, message, CCNxStackTimeout_Never), "Expected send %d to succeed", i);
+        ccnxMetaMessage_Release(&message);
+
+        // Receive every third message as we go so that the queue wraps as well as grows.
+        if (i % 3 == 2) {
+            CCNxMetaMessage *received = ccnxPortal_Receive(portal, CCNxStackTimeout_Never);
+            assertTrue(ccnxInterest_Equals(interests[i / 3], ccnxMetaMessage_GetInterest(received)),
+                       "Expected message %d in order", i / 3);
+            ccnxMetaMessage_Release(&received);
+        }
+    }
+
+    for (int i = 100 / 3; i < 100; i++) {
+        CCNxMetaMessage *received = ccnxPortal_Receive(portal, CCNxStackTimeout_Never);
+        assertTrue(ccnxInterest_Equals(interests[i], ccnxMetaMessage_GetInterest(received)), "Expected message %d in order", i);
+        ccnxMetaMessage_Release(&received);
+    }
+    assertNull(ccnxPortal_Receive(portal, CCNxStackTimeout_Immediate), "Expected the queue to be empty");
+
+    for (int i = 0; i < 100; i++) {
+        ccnxInterest_Release(&interests[i]);
+    }
+    ccnxPortal_Release(&portal);
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortalAPI_ReleaseQueued)
+{
+    CCNxPortalFactory *factory = longBowTestCase_GetClipBoardData(testCase);
+
+    CCNxPortal *portal = ccnxPortalFactory_CreatePortal(factory, ccnxPortalAPI_LoopBack);
+
+    CCNxName *name = ccnxName_CreateFromCString("lci:/Hello/World");
+    CCNxInterest *interest = ccnxInterest_CreateSimple(name);
+    CCNxMetaMessage *message = ccnxMetaMessage_CreateFromInterest(interest);
+
+    ccnxPortal_Send(portal, message, CCNxStackTimeout_Never);
+    ccnxPortal_Send(portal, message, CCNxStackTimeout_Never);
+
+    ccnxMetaMessage_Release(&message);
+    ccnxInterest_Release(&interest);
+    ccnxName_Release(&name);
+
+    // Messages still queued are released with the Portal; the fixture teardown checks for the leak.
+    ccnxPortal_Release(&portal);
+}
+
 int
 main(int argc, char *argv[argc])
 {
@@ -75,6 +75,7 @@ LONGBOW_TEST_RUNNER(ccnx_PortalAnchor)
     LONGBOW_RUN_TEST_FIXTURE(CreateAcquireRelease);
     LONGBOW_RUN_TEST_FIXTURE(Object);
     LONGBOW_RUN_TEST_FIXTURE(Specialization);
+    LONGBOW_RUN_TEST_FIXTURE(Performance);
 }
 
 // The Test Runner calls this function once before any Test Fixtures are run.
@@ -133,6 +134,10 @@ LONGBOW_TEST_FIXTURE(Object)
     LONGBOW_RUN_TEST_CASE(Object, ccnxPortalAnchor_ToJSON);
     LONGBOW_RUN_TEST_CASE(Object, ccnxPortalAnchor_ToString);
     LONGBOW_RUN_TEST_CASE(Object, ccnxPortalAnchor_SerializeDeserialize);
+    LONGBOW_RUN_TEST_CASE(Object, ccnxPortalAnchor_Serialize_Binary);
+    LONGBOW_RUN_TEST_CASE(Object, ccnxPortalAnchor_Deserialize_JSON);
+    LONGBOW_RUN_TEST_CASE(Object, ccnxPortalAnchor_Deserialize_Truncated);
+    LONGBOW_RUN_TEST_CASE(Object, ccnxPortalAnchor_Deserialize_UnknownField);
 }
 
 LONGBOW_TEST_FIXTURE_SETUP(Object)
@@ -151,8 +156,25 @@ LONGBOW_TEST_FIXTURE_TEARDOWN(Object)
 
 LONGBOW_TEST_CASE(Object,  ccnxPortalAnchor_Compare)
 {
-    testUnimplemented("");
+    CCNxName *name = ccnxName_CreateFromCString("lci:/name");
+    CCNxName *longer = ccnxName_CreateFromCString("lci:/name/longer");
+    CCNxPortalAnchor *x = ccnxPortalAnchor_Create(name, 123);
+    CCNxPortalAnchor *y = ccnxPortalAnchor_Create(name, 123);
+    CCNxPortalAnchor *later = ccnxPortalAnchor_Create(name, 456);
+    CCNxPortalAnchor *greater = ccnxPortalAnchor_Create(longer, 0);
+
+    assertTrue(ccnxPortalAnchor_Compare(x, y) == 0, "Expected equal anchors to compare the same");
+    assertTrue(ccnxPortalAnchor_Compare(x, later) < 0, "Expected the earlier expiry to be less");
+    assertTrue(ccnxPortalAnchor_Compare(later, x) > 0, "Expected the later expiry to be greater");
+    assertTrue(ccnxPortalAnchor_Compare(later, greater) < 0, "Expected the name to order before the expiry");
+    assertTrue(ccnxPortalAnchor_Compare(NULL, x) < 0, "Expected NULL to be less than any anchor");
 
+    ccnxPortalAnchor_Release(&x);
+    ccnxPortalAnchor_Release(&y);
+    ccnxPortalAnchor_Release(&later);
+    ccnxPortalAnchor_Release(&greater);
+    ccnxName_Release(&name);
+    ccnxName_Release(&longer);
 }
 
 LONGBOW_TEST_CASE(Object, ccnxPortalAnchor_Copy)
@@ -204,6 +226,11 @@ LONGBOW_TEST_CASE(Object, ccnxPortalAnchor_HashCode)
 
     parcObjectTesting_AssertHashCode(x, y);
 
+    CCNxPortalAnchor *later = ccnxPortalAnchor_Create(name, expireTime + 1);
+    assertFalse(ccnxPortalAnchor_HashCode(x) == ccnxPortalAnchor_HashCode(later),
+                "Expected the expiry time to contribute to the hash code");
+    ccnxPortalAnchor_Release(&later);
+
     ccnxPortalAnchor_Release(&x);
     ccnxPortalAnchor_Release(&y);
     ccnxName_Release(&name);
@@ -270,6 +297,100 @@ LONGBOW_TEST_CASE(Object, ccnxPortalAnchor_SerializeDeserialize)
     ccnxName_Release(&name);
 }
 
+LONGBOW_TEST_CASE(Object, ccnxPortalAnchor_Serialize_Binary)
+{
+    CCNxName *name = ccnxName_CreateFromCString("lci:/a/bc");
+    CCNxPortalAnchor *instance = ccnxPortalAnchor_Create(name, -1);
+
+    PARCBufferComposer *composer = parcBufferComposer_Create();
+    ccnxPortalAnchor_Serialize(instance, composer);
+    PARCBuffer *buffer = parcBufferComposer_ProduceBuffer(composer);
+
+    uint8_t expected[] = {
+        0x00, 0x00, 0x00, 0x0b,
+        0x00, 0x01, 0x00, 0x01, 'a',
+        0x00, 0x01, 0x00, 0x02, 'b', 'c',
+        0x00, 0x01, 0x00, 0x08,
+        0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff
+    };
+    PARCBuffer *expectedBuffer = parcBuffer_Wrap(expected, sizeof(expected), 0, sizeof(expected));
+    assertTrue(parcBuffer_Equals(expectedBuffer, buffer), "Expected the binary anchor encoding");
+
+    CCNxPortalAnchor *copy = ccnxPortalAnchor_Deserialize(buffer);
+    assertTrue(ccnxPortalAnchor_Equals(instance, copy), "Expected a never-expiring anchor to survive the round trip");
+
+    ccnxPortalAnchor_Release(&copy);
+    parcBuffer_Release(&expectedBuffer);
+    parcBuffer_Release(&buffer);
+    parcBufferComposer_Release(&composer);
+    ccnxPortalAnchor_Release(&instance);
+    ccnxName_Release(&name);
+}
+
+LONGBOW_TEST_CASE(Object, ccnxPortalAnchor_Deserialize_JSON)
+{
+    CCNxName *name = ccnxName_CreateFromCString("lci:/name");
+    CCNxPortalAnchor *instance = ccnxPortalAnchor_Create(name, 123);
+
+    PARCBufferComposer *composer = parcBufferComposer_Create();
+    _ccnxPortalAnchor_SerializeJSON(instance, composer);
+    PARCBuffer *buffer = parcBufferComposer_ProduceBuffer(composer);
+    CCNxPortalAnchor *copy = ccnxPortalAnchor_Deserialize(buffer);
+
+    assertTrue(ccnxPortalAnchor_Equals(instance, copy), "Expected the JSON form to be accepted");
+
+    ccnxPortalAnchor_Release(&copy);
+    parcBuffer_Release(&buffer);
+    parcBufferComposer_Release(&composer);
+    ccnxPortalAnchor_Release(&instance);
+    ccnxName_Release(&name);
+}
+
+LONGBOW_TEST_CASE(Object, ccnxPortalAnchor_Deserialize_Truncated)
+{
+    CCNxName *name = ccnxName_CreateFromCString("lci:/name");
+    CCNxPortalAnchor *instance = ccnxPortalAnchor_Create(name, 123);
+
+    PARCBufferComposer *composer = parcBufferComposer_Create();
+    ccnxPortalAnchor_Serialize(instance, composer);
+    PARCBuffer *buffer = parcBufferComposer_ProduceBuffer(composer);
+    size_t length = parcBuffer_Limit(buffer);
+
+    for (size_t limit = 0; limit < length; limit++) {
+        parcBuffer_SetPosition(buffer, 0);
+        parcBuffer_SetLimit(buffer, limit);
+        CCNxPortalAnchor *copy = ccnxPortalAnchor_Deserialize(buffer);
+        assertNull(copy, "Expected NULL for an anchor truncated to %zu of %zu bytes", limit, length);
+    }
+
+    parcBuffer_Release(&buffer);
+    parcBufferComposer_Release(&composer);
+    ccnxPortalAnchor_Release(&instance);
+    ccnxName_Release(&name);
+}
+
+LONGBOW_TEST_CASE(Object, ccnxPortalAnchor_Deserialize_UnknownField)
+{
+    CCNxName *name = ccnxName_CreateFromCString("lci:/name");
+    CCNxPortalAnchor *instance = ccnxPortalAnchor_Create(name, 123);
+
+    PARCBufferComposer *composer = parcBufferComposer_Create();
+    parcBufferComposer_PutUint16(composer, 0x7fff);
+    parcBufferComposer_PutUint16(composer, 3);
+    parcBufferComposer_PutString(composer, "abc");
+    ccnxPortalAnchor_Serialize(instance, composer);
+    PARCBuffer *buffer = parcBufferComposer_ProduceBuffer(composer);
+    CCNxPortalAnchor *copy = ccnxPortalAnchor_Deserialize(buffer);
+
+    assertTrue(ccnxPortalAnchor_Equals(instance, copy), "Expected unknown fields to be skipped");
+
+    ccnxPortalAnchor_Release(&copy);
+    parcBuffer_Release(&buffer);
+    parcBufferComposer_Release(&composer);
+    ccnxPortalAnchor_Release(&instance);
+    ccnxName_Release(&name);
+}
+
 LONGBOW_TEST_FIXTURE(Specialization)
 {
     LONGBOW_RUN_TEST_CASE(Specialization, ccnxPortalAnchor_GetNamePrefix);
@@ -317,6 +438,67 @@ LONGBOW_TEST_CASE(Specialization, ccnxPortalAnchor_GetExpireTime)
     ccnxName_Release(&name);
 }
 
+LONGBOW_TEST_FIXTURE_OPTIONS(Performance, .enabled = false)
+{
+    LONGBOW_RUN_TEST_CASE(Performance, ccnxPortalAnchor_Serialize_BinaryVersusJSON);
+}
+
+LONGBOW_TEST_FIXTURE_SETUP(Performance)
+{
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_FIXTURE_TEARDOWN(Performance)
+{
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+static double
+_nanoSecondsPerRoundTrip(const CCNxPortalAnchor *anchor,
+                         PARCBufferComposer *(*serialize)(const CCNxPortalAnchor *, PARCBufferComposer *),
+                         size_t *encodedLength, int iterations)
+{
+    struct timespec start, stop;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    for (int i = 0; i < iterations; i++) {
+        PARCBufferComposer *composer = parcBufferComposer_Create();
+        serialize(anchor, composer);
+        PARCBuffer *buffer = parcBufferComposer_ProduceBuffer(composer);
+        *encodedLength = parcBuffer_Remaining(buffer);
+
+        CCNxPortalAnchor *copy = ccnxPortalAnchor_Deserialize(buffer);
+        assertNotNull(copy, "Expected the anchor to deserialize");
+
+        ccnxPortalAnchor_Release(&copy);
+        parcBuffer_Release(&buffer);
+        parcBufferComposer_Release(&composer);
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &stop);
+    double elapsed = (stop.tv_sec - start.tv_sec) * 1e9 + (stop.tv_nsec - start.tv_nsec);
+    return elapsed / iterations;
+}
+
+LONGBOW_TEST_CASE(Performance, ccnxPortalAnchor_Serialize_BinaryVersusJSON)
+{
+    const int iterations = 100000;
+
+    CCNxName *name = ccnxName_CreateFromCString("lci:/org/example/service/videos/2016");
+    CCNxPortalAnchor *anchor = ccnxPortalAnchor_Create(name, time(0) + 3600);
+
+    size_t binaryLength;
+    size_t jsonLength;
+    double binary = _nanoSecondsPerRoundTrip(anchor, ccnxPortalAnchor_Serialize, &binaryLength, iterations);
+    double json = _nanoSecondsPerRoundTrip(anchor, _ccnxPortalAnchor_SerializeJSON, &jsonLength, iterations);
+
+    printf("anchor round trip: binary %.0f ns (%zu bytes), JSON %.0f ns (%zu bytes), %.1fx\n",
+           binary, binaryLength, json, jsonLength, json / binary);
+
+    ccnxPortalAnchor_Release(&anchor);
+    ccnxName_Release(&name);
+}
+
 
 int
 main(int argc, char *argv[argc])
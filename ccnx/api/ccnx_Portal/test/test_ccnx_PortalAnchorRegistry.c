@@ -0,0 +1,390 @@
+/*
+ * Copyright (c) 2016, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX OR PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ################################################################################
+ * #
+ * # PATENT NOTICE
+ * #
+ * # This software is distributed under the BSD 2-clause License (see LICENSE
+ * # file).  This BSD License does not make any patent claims and as such, does
+ * # not act as a patent grant.  The purpose of this section is for each contributor
+ * # to define their intentions with respect to intellectual property.
+ * #
+ * # Each contributor to this source code is encouraged to state their patent
+ * # claims and licensing mechanisms for any contributions made. At the end of
+ * # this section contributors may each make their own statements.  Contributor's
+ * # claims and grants only apply to the pieces (source code, programs, text,
+ * # media, etc) that they have contributed directly to this software.
+ * #
+ * # There is no guarantee that this section is complete, up to date or accurate. It
+ * # is up to the contributors to maintain their portion of this section and up to
+ * # the user of the software to verify any claims herein.
+ * #
+ * # Do not remove this header notification.  The contents of this section must be
+ * # present in all distributions of the software.  You may only modify your own
+ * # intellectual property statements.  Please provide contact information.
+ *
+ * - Palo Alto Research Center, Inc
+ * This software distribution does not grant any rights to patents owned by Palo
+ * Alto Research Center, Inc (PARC). Rights to these patents are available via
+ * various mechanisms. As of January 2016 PARC has committed to FRAND licensing any
+ * intellectual property used by its contributions to this software. You may
+ * contact PARC at cipo@parc.com for more information or visit http://www.ccnx.org
+ */
+/**
+ * @copyright (c) 2016, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC).  All rights reserved.
+ */
+#include "../ccnx_PortalAnchorRegistry.c"
+
+#include <LongBow/unit-test.h>
+#include <LongBow/debugging.h>
+
+#include <stdio.h>
+#include <unistd.h>
+
+#include <parc/algol/parc_Memory.h>
+#include <parc/algol/parc_SafeMemory.h>
+#include <parc/testing/parc_ObjectTesting.h>
+
+LONGBOW_TEST_RUNNER(test_ccnx_PortalAnchorRegistry)
+{
+    LONGBOW_RUN_TEST_FIXTURE(Global);
+    LONGBOW_RUN_TEST_FIXTURE(Performance);
+}
+
+LONGBOW_TEST_RUNNER_SETUP(test_ccnx_PortalAnchorRegistry)
+{
+    parcMemory_SetInterface(&PARCSafeMemoryAsPARCMemory);
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_RUNNER_TEARDOWN(test_ccnx_PortalAnchorRegistry)
+{
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+/*
+ * Put an anchor for the given name into the registry.
+ */
+static void
+_put(CCNxPortalAnchorRegistry *registry, const char *uri, time_t expireTime)
+{
+    CCNxName *name = ccnxName_CreateFromCString(uri);
+    CCNxPortalAnchor *anchor = ccnxPortalAnchor_Create(name, expireTime);
+
+    assertTrue(ccnxPortalAnchorRegistry_Put(registry, anchor), "Expected ccnxPortalAnchorRegistry_Put to succeed");
+
+    ccnxPortalAnchor_Release(&anchor);
+    ccnxName_Release(&name);
+}
+
+/*
+ * Return the expiry time of the anchor the registry holds for the given name, or -2 if there is none.
+ */
+static time_t
+_getExpireTime(const CCNxPortalAnchorRegistry *registry, const char *uri, bool longestPrefixMatch)
+{
+    CCNxName *name = ccnxName_CreateFromCString(uri);
+
+    CCNxPortalAnchor *anchor = longestPrefixMatch
+        ? ccnxPortalAnchorRegistry_LongestPrefixMatch(registry, name)
+        : ccnxPortalAnchorRegistry_Get(registry, name);
+
+    ccnxName_Release(&name);
+
+    return (anchor == NULL) ? -2 : ccnxPortalAnchor_GetExpireTime(anchor);
+}
+
+LONGBOW_TEST_FIXTURE(Global)
+{
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortalAnchorRegistry_CreateAcquireRelease);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortalAnchorRegistry_Put_Get);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortalAnchorRegistry_Put_Replace);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortalAnchorRegistry_LongestPrefixMatch);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortalAnchorRegistry_CreateListUnder);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortalAnchorRegistry_Remove);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortalAnchorRegistry_PeekNextExpiring);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortalAnchorRegistry_RemoveExpired);
+}
+
+static size_t InitialMemoryOutstanding = 0;
+
+LONGBOW_TEST_FIXTURE_SETUP(Global)
+{
+    InitialMemoryOutstanding = parcMemory_Outstanding();
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_FIXTURE_TEARDOWN(Global)
+{
+    if (parcMemory_Outstanding() != InitialMemoryOutstanding) {
+        parcSafeMemory_ReportAllocation(STDOUT_FILENO);
+        printf("('%s' leaks memory by %zd\n",
+               longBowTestCase_GetName(testCase), parcMemory_Outstanding() - InitialMemoryOutstanding);
+        return LONGBOW_STATUS_MEMORYLEAK;
+    }
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortalAnchorRegistry_CreateAcquireRelease)
+{
+    CCNxPortalAnchorRegistry *registry = ccnxPortalAnchorRegistry_Create();
+    assertNotNull(registry, "Expected a non-null registry");
+    assertTrue(ccnxPortalAnchorRegistry_Size(registry) == 0, "Expected an empty registry");
+
+    parcObjectTesting_AssertAcquireReleaseContract(ccnxPortalAnchorRegistry_Acquire, registry);
+
+    ccnxPortalAnchorRegistry_Release(&registry);
+    assertNull(registry, "Expected ccnxPortalAnchorRegistry_Release to null the pointer");
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortalAnchorRegistry_Put_Get)
+{
+    CCNxPortalAnchorRegistry *registry = ccnxPortalAnchorRegistry_Create();
+
+    _put(registry, "lci:/a/b", 100);
+    _put(registry, "lci:/a/c", 200);
+
+    assertTrue(ccnxPortalAnchorRegistry_Size(registry) == 2, "Expected 2 anchors");
+    assertTrue(_getExpireTime(registry, "lci:/a/b", false) == 100, "Expected the anchor for lci:/a/b");
+    assertTrue(_getExpireTime(registry, "lci:/a/c", false) == 200, "Expected the anchor for lci:/a/c");
+    assertTrue(_getExpireTime(registry, "lci:/a", false) == -2, "Expected no anchor for the interior prefix lci:/a");
+    assertTrue(_getExpireTime(registry, "lci:/a/b/c", false) == -2, "Expected no anchor for lci:/a/b/c");
+
+    ccnxPortalAnchorRegistry_Release(&registry);
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortalAnchorRegistry_Put_Replace)
+{
+    CCNxPortalAnchorRegistry *registry = ccnxPortalAnchorRegistry_Create();
+
+    _put(registry, "lci:/a", 100);
+    _put(registry, "lci:/b", 200);
+    _put(registry, "lci:/a", 300);
+
+    assertTrue(ccnxPortalAnchorRegistry_Size(registry) == 2, "Expected the renewal to replace the anchor");
+    assertTrue(_getExpireTime(registry, "lci:/a", false) == 300, "Expected the renewed expiry time");
+
+    CCNxPortalAnchor *next = ccnxPortalAnchorRegistry_PeekNextExpiring(registry);
+    assertTrue(ccnxPortalAnchor_GetExpireTime(next) == 200, "Expected the renewal to reorder the expiry heap");
+
+    ccnxPortalAnchorRegistry_Release(&registry);
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortalAnchorRegistry_LongestPrefixMatch)
+{
+    CCNxPortalAnchorRegistry *registry = ccnxPortalAnchorRegistry_Create();
+
+    _put(registry, "lci:/a", 1);
+    _put(registry, "lci:/a/b/c", 3);
+
+    assertTrue(_getExpireTime(registry, "lci:/a/b/c/d", true) == 3, "Expected the longest match lci:/a/b/c");
+    assertTrue(_getExpireTime(registry, "lci:/a/b/c", true) == 3, "Expected an exact match");
+    assertTrue(_getExpireTime(registry, "lci:/a/b", true) == 1, "Expected the match lci:/a");
+    assertTrue(_getExpireTime(registry, "lci:/a/x/c", true) == 1, "Expected the match lci:/a");
+    assertTrue(_getExpireTime(registry, "lci:/b", true) == -2, "Expected no match");
+
+    ccnxPortalAnchorRegistry_Release(&registry);
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortalAnchorRegistry_CreateListUnder)
+{
+    CCNxPortalAnchorRegistry *registry = ccnxPortalAnchorRegistry_Create();
+
+    _put(registry, "lci:/a", 1);
+    _put(registry, "lci:/a/b", 2);
+    _put(registry, "lci:/a/b/c", 3);
+    _put(registry, "lci:/a/d", 4);
+    _put(registry, "lci:/e", 5);
+
+    CCNxName *prefix = ccnxName_CreateFromCString("lci:/a/b");
+    PARCArrayList *list = ccnxPortalAnchorRegistry_CreateListUnder(registry, prefix);
+
+    assertTrue(parcArrayList_Size(list) == 2, "Expected 2 anchors under lci:/a/b, actual %zu", parcArrayList_Size(list));
+    time_t sum = 0;
+    for (size_t i = 0; i < parcArrayList_Size(list); i++) {
+        CCNxPortalAnchor *anchor = parcArrayList_Get(list, i);
+        assertTrue(ccnxName_StartsWith(ccnxPortalAnchor_GetNamePrefix(anchor), prefix), "Expected only anchors under lci:/a/b");
+        sum += ccnxPortalAnchor_GetExpireTime(anchor);
+    }
+    assertTrue(sum == 5, "Expected the anchors lci:/a/b and lci:/a/b/c");
+
+    parcArrayList_Destroy(&list);
+    ccnxName_Release(&prefix);
+
+    prefix = ccnxName_CreateFromCString("lci:/x");
+    list = ccnxPortalAnchorRegistry_CreateListUnder(registry, prefix);
+    assertTrue(parcArrayList_Size(list) == 0, "Expected no anchors under lci:/x");
+    parcArrayList_Destroy(&list);
+    ccnxName_Release(&prefix);
+
+    ccnxPortalAnchorRegistry_Release(&registry);
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortalAnchorRegistry_Remove)
+{
+    CCNxPortalAnchorRegistry *registry = ccnxPortalAnchorRegistry_Create();
+
+    _put(registry, "lci:/a", 1);
+    _put(registry, "lci:/a/b/c", 3);
+
+    CCNxName *name = ccnxName_CreateFromCString("lci:/a/b/c");
+    assertTrue(ccnxPortalAnchorRegistry_Remove(registry, name), "Expected lci:/a/b/c to be removed");
+    assertFalse(ccnxPortalAnchorRegistry_Remove(registry, name), "Expected nothing left to remove");
+    ccnxName_Release(&name);
+
+    assertTrue(ccnxPortalAnchorRegistry_Size(registry) == 1, "Expected 1 anchor");
+    assertTrue(_getExpireTime(registry, "lci:/a/b/c", true) == 1, "Expected the match to fall back to lci:/a");
+
+    CCNxNameSegment *segment = ccnxName_GetSegment(ccnxPortalAnchor_GetNamePrefix(ccnxPortalAnchorRegistry_PeekNextExpiring(registry)), 0);
+    _CCNxPortalAnchorNode *node = (_CCNxPortalAnchorNode *) parcHashMap_Get(registry->root->children, segment);
+    assertTrue(node->children == NULL || parcHashMap_Size(node->children) == 0, "Expected the empty path to lci:/a/b/c to be pruned");
+
+    ccnxPortalAnchorRegistry_Release(&registry);
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortalAnchorRegistry_PeekNextExpiring)
+{
+    CCNxPortalAnchorRegistry *registry = ccnxPortalAnchorRegistry_Create();
+
+    assertNull(ccnxPortalAnchorRegistry_PeekNextExpiring(registry), "Expected NULL for an empty registry");
+
+    _put(registry, "lci:/never", -1);
+    _put(registry, "lci:/c", 30);
+    _put(registry, "lci:/a", 10);
+    _put(registry, "lci:/b", 20);
+
+    CCNxPortalAnchor *next = ccnxPortalAnchorRegistry_PeekNextExpiring(registry);
+    assertTrue(ccnxPortalAnchor_GetExpireTime(next) == 10, "Expected 10, actual %ld", ccnxPortalAnchor_GetExpireTime(next));
+
+    ccnxPortalAnchorRegistry_Release(&registry);
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortalAnchorRegistry_RemoveExpired)
+{
+    CCNxPortalAnchorRegistry *registry = ccnxPortalAnchorRegistry_Create();
+
+    for (int i = 0; i < 100; i++) {
+        char uri[64];
+        sprintf(uri, "lci:/anchor/%d", (i * 37) % 100);
+        _put(registry, uri, (i * 37) % 100);
+    }
+    _put(registry, "lci:/never", -1);
+
+    size_t removed = ccnxPortalAnchorRegistry_RemoveExpired(registry, 49);
+    assertTrue(removed == 50, "Expected 50 expired anchors, actual %zu", removed);
+    assertTrue(ccnxPortalAnchorRegistry_Size(registry) == 51, "Expected 51 anchors left");
+    assertTrue(_getExpireTime(registry, "lci:/anchor/49", false) == -2, "Expected lci:/anchor/49 to have expired");
+    assertTrue(_getExpireTime(registry, "lci:/anchor/50", false) == 50, "Expected lci:/anchor/50 to remain");
+
+    removed = ccnxPortalAnchorRegistry_RemoveExpired(registry, 1000);
+    assertTrue(removed == 50, "Expected 50 expired anchors, actual %zu", removed);
+    assertTrue(_getExpireTime(registry, "lci:/never", false) == -1, "Expected an anchor that never expires to remain");
+
+    ccnxPortalAnchorRegistry_Release(&registry);
+}
+
+LONGBOW_TEST_FIXTURE_OPTIONS(Performance, .enabled = false)
+{
+    LONGBOW_RUN_TEST_CASE(Performance, ccnxPortalAnchorRegistry_100000);
+}
+
+LONGBOW_TEST_FIXTURE_SETUP(Performance)
+{
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_FIXTURE_TEARDOWN(Performance)
+{
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+static double
+_nanoSecondsSince(const struct timespec *start, size_t operations)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return ((now.tv_sec - start->tv_sec) * 1e9 + (now.tv_nsec - start->tv_nsec)) / operations;
+}
+
+LONGBOW_TEST_CASE(Performance, ccnxPortalAnchorRegistry_100000)
+{
+    const size_t count = 100000;
+
+    CCNxName **names = parcMemory_Allocate(count * sizeof(CCNxName *));
+    CCNxName **longerNames = parcMemory_Allocate(count * sizeof(CCNxName *));
+    CCNxPortalAnchor **anchors = parcMemory_Allocate(count * sizeof(CCNxPortalAnchor *));
+    for (size_t i = 0; i < count; i++) {
+        char uri[128];
+        sprintf(uri, "lci:/org/example/tenant%zu/service%zu", i % 100, i);
+        names[i] = ccnxName_CreateFromCString(uri);
+        sprintf(uri, "lci:/org/example/tenant%zu/service%zu/videos/%zu/chunk=1", i % 100, i, i);
+        longerNames[i] = ccnxName_CreateFromCString(uri);
+        anchors[i] = ccnxPortalAnchor_Create(names[i], (time_t) ((i * 7919) % count));
+    }
+
+    CCNxPortalAnchorRegistry *registry = ccnxPortalAnchorRegistry_Create();
+    struct timespec start;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (size_t i = 0; i < count; i++) {
+        ccnxPortalAnchorRegistry_Put(registry, anchors[i]);
+    }
+    printf("Put                %8.0f ns\n", _nanoSecondsSince(&start, count));
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (size_t i = 0; i < count; i++) {
+        ccnxPortalAnchorRegistry_Get(registry, names[i]);
+    }
+    printf("Get                %8.0f ns\n", _nanoSecondsSince(&start, count));
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (size_t i = 0; i < count; i++) {
+        ccnxPortalAnchorRegistry_LongestPrefixMatch(registry, longerNames[i]);
+    }
+    printf("LongestPrefixMatch %8.0f ns\n", _nanoSecondsSince(&start, count));
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    size_t removed = ccnxPortalAnchorRegistry_RemoveExpired(registry, (time_t) count);
+    printf("RemoveExpired      %8.0f ns\n", _nanoSecondsSince(&start, removed));
+
+    ccnxPortalAnchorRegistry_Release(&registry);
+    for (size_t i = 0; i < count; i++) {
+        ccnxPortalAnchor_Release(&anchors[i]);
+        ccnxName_Release(&longerNames[i]);
+        ccnxName_Release(&names[i]);
+    }
+    parcMemory_Deallocate(&anchors);
+    parcMemory_Deallocate(&longerNames);
+    parcMemory_Deallocate(&names);
+}
+
+int
+main(int argc, char *argv[argc])
+{
+    LongBowRunner *testRunner = LONGBOW_TEST_RUNNER_CREATE(test_ccnx_PortalAnchorRegistry);
+    int exitStatus = longBowMain(argc, argv, testRunner, NULL);
+    longBowTestRunner_Destroy(&testRunner);
+    exit(exitStatus);
+}
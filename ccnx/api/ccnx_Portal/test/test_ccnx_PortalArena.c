@@ -0,0 +1,389 @@
+/*
+ * Copyright (c) 2016, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX OR PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ################################################################################
+ * #
+ * # PATENT NOTICE
+ * #
+ * # This software is distributed under the BSD 2-clause License (see LICENSE
+ * # file).  This BSD License does not make any patent claims and as such, does
+ * # not act as a patent grant.  The purpose of this section is for each contributor
+ * # to define their intentions with respect to intellectual property.
+ * #
+ * # Each contributor to this source code is encouraged to state their patent
+ * # claims and licensing mechanisms for any contributions made. At the end of
+ * # this section contributors may each make their own statements.  Contributor's
+ * # claims and grants only apply to the pieces (source code, programs, text,
+ * # media, etc) that they have contributed directly to this software.
+ * #
+ * # There is no guarantee that this section is complete, up to date or accurate. It
+ * # is up to the contributors to maintain their portion of this section and up to
+ * # the user of the software to verify any claims herein.
+ * #
+ * # Do not remove this header notification.  The contents of this section must be
+ * # present in all distributions of the software.  You may only modify your own
+ * # intellectual property statements.  Please provide contact information.
+ *
+ * - Palo Alto Research Center, Inc
+ * This software distribution does not grant any rights to patents owned by Palo
+ * Alto Research Center, Inc (PARC). Rights to these patents are available via
+ * various mechanisms. As of January 2016 PARC has committed to FRAND licensing any
+ * intellectual property used by its contributions to this software. You may
+ * contact PARC at cipo@parc.com for more information or visit http://www.ccnx.org
+ */
+/**
+ * @copyright (c) 2016, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC).  All rights reserved.
+ */
+#include "../ccnx_PortalArena.c"
+
+#include <LongBow/unit-test.h>
+#include <LongBow/debugging.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <parc/algol/parc_Memory.h>
+#include <parc/algol/parc_SafeMemory.h>
+#include <parc/algol/parc_Buffer.h>
+#include <parc/testing/parc_ObjectTesting.h>
+
+LONGBOW_TEST_RUNNER(test_ccnx_PortalArena)
+{
+    LONGBOW_RUN_TEST_FIXTURE(Global);
+}
+
+LONGBOW_TEST_RUNNER_SETUP(test_ccnx_PortalArena)
+{
+    parcMemory_SetInterface(&PARCSafeMemoryAsPARCMemory);
+    ccnxPortalArena_Install();
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_RUNNER_TEARDOWN(test_ccnx_PortalArena)
+{
+    ccnxPortalArena_Uninstall();
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_FIXTURE(Global)
+{
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortalArena_CreateAcquireRelease);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortalArena_Create_NotInstalled);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortalArena_Install);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortalArena_Uninstall_Busy);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortalArena_Allocate);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortalArena_Allocate_Inactive);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortalArena_Allocate_Large);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortalArena_Deallocate);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortalArena_Reallocate);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortalArena_StringDuplicate);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortalArena_Reset);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortalArena_Nested);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortalArena_Suspend);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortalArena_Objects);
+}
+
+static size_t InitialMemoryOutstanding = 0;
+
+LONGBOW_TEST_FIXTURE_SETUP(Global)
+{
+    InitialMemoryOutstanding = parcMemory_Outstanding();
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_FIXTURE_TEARDOWN(Global)
+{
+    if (parcMemory_Outstanding() != InitialMemoryOutstanding) {
+        parcSafeMemory_ReportAllocation(STDOUT_FILENO);
+        printf("('%s' leaks memory by %zd\n",
+               longBowTestCase_GetName(testCase), parcMemory_Outstanding() - InitialMemoryOutstanding);
+        return LONGBOW_STATUS_MEMORYLEAK;
+    }
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortalArena_CreateAcquireRelease)
+{
+    CCNxPortalArena *arena = ccnxPortalArena_Create();
+    assertNotNull(arena, "Expected a non-null arena");
+    assertTrue(ccnxPortalArena_GetAllocationCount(arena) == 0, "Expected no allocations");
+    assertTrue(ccnxPortalArena_GetBlockCount(arena) == 0, "Expected no blocks before the first allocation");
+
+    parcObjectTesting_AssertAcquireReleaseContract(ccnxPortalArena_Acquire, arena);
+
+    ccnxPortalArena_Release(&arena);
+    assertNull(arena, "Expected ccnxPortalArena_Release to null the pointer");
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortalArena_Create_NotInstalled)
+{
+    assertTrue(ccnxPortalArena_Uninstall(), "Expected the arena memory interface to be uninstalled");
+    assertFalse(ccnxPortalArena_IsInstalled(), "Expected the arena memory interface not to be installed");
+
+    errno = 0;
+    CCNxPortalArena *arena = ccnxPortalArena_Create();
+    assertNull(arena, "Expected no arena without the arena memory interface");
+    assertTrue(errno == EPERM, "Expected EPERM, actual %d", errno);
+
+    assertTrue(ccnxPortalArena_Install(), "Expected the arena memory interface to be installed");
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortalArena_Install)
+{
+    assertTrue(ccnxPortalArena_IsInstalled(), "Expected the arena memory interface to be installed");
+
+    errno = 0;
+    assertFalse(ccnxPortalArena_Install(), "Expected a second install to fail");
+    assertTrue(errno == EALREADY, "Expected EALREADY, actual %d", errno);
+
+    // Memory allocated outside an arena comes from the interface beneath, so it survives uninstalling.
+    void *memory = parcMemory_Allocate(10);
+    assertTrue(ccnxPortalArena_Uninstall(), "Expected the arena memory interface to be uninstalled");
+    parcMemory_Deallocate(&memory);
+
+    errno = 0;
+    assertFalse(ccnxPortalArena_Uninstall(), "Expected a second uninstall to fail");
+    assertTrue(errno == EINVAL, "Expected EINVAL, actual %d", errno);
+
+    assertTrue(ccnxPortalArena_Install(), "Expected the arena memory interface to be installed");
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortalArena_Uninstall_Busy)
+{
+    CCNxPortalArena *arena = ccnxPortalArena_Create();
+
+    errno = 0;
+    assertFalse(ccnxPortalArena_Uninstall(), "Expected the arena memory interface to stay while an arena exists");
+    assertTrue(errno == EBUSY, "Expected EBUSY, actual %d", errno);
+    assertTrue(ccnxPortalArena_IsInstalled(), "Expected the arena memory interface to be installed");
+
+    ccnxPortalArena_Release(&arena);
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortalArena_Allocate)
+{
+    CCNxPortalArena *arena = ccnxPortalArena_Create();
+
+    ccnxPortalArena_Begin(arena);
+    uint8_t *a = parcMemory_Allocate(10);
+    uint8_t *b = parcMemory_AllocateAndClear(100);
+    ccnxPortalArena_End(arena);
+
+    assertTrue(_ccnxPortalArena_Owner(a) == arena, "Expected the allocation to come from the arena");
+    assertTrue(_ccnxPortalArena_Owner(b) == arena, "Expected the allocation to come from the arena");
+    assertTrue(((uintptr_t) a % _ccnxPortalArena_Alignment) == 0, "Expected aligned memory");
+    assertTrue(b[99] == 0, "Expected cleared memory");
+    assertTrue(ccnxPortalArena_GetAllocationCount(arena) == 2, "Expected 2 allocations, actual %zu",
+               ccnxPortalArena_GetAllocationCount(arena));
+    assertTrue(ccnxPortalArena_GetBlockCount(arena) == 1, "Expected 1 block, actual %zu", ccnxPortalArena_GetBlockCount(arena));
+
+    parcMemory_Deallocate(&a);
+    parcMemory_Deallocate(&b);
+    ccnxPortalArena_Release(&arena);
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortalArena_Allocate_Inactive)
+{
+    CCNxPortalArena *arena = ccnxPortalArena_Create();
+
+    void *memory = parcMemory_Allocate(10);
+    assertNull(_ccnxPortalArena_Owner(memory), "Expected the allocation not to come from an inactive arena");
+    assertTrue(ccnxPortalArena_GetAllocationCount(arena) == 0, "Expected no allocations");
+
+    parcMemory_Deallocate(&memory);
+    ccnxPortalArena_Release(&arena);
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortalArena_Allocate_Large)
+{
+    CCNxPortalArena *arena = ccnxPortalArena_Create();
+
+    ccnxPortalArena_Begin(arena);
+    void *memory = parcMemory_Allocate(_ccnxPortalArena_LargeAllocation + 1);
+    ccnxPortalArena_End(arena);
+
+    assertNull(_ccnxPortalArena_Owner(memory), "Expected a large allocation to bypass the arena");
+    assertTrue(ccnxPortalArena_GetAllocationCount(arena) == 0, "Expected no allocations");
+
+    parcMemory_Deallocate(&memory);
+    ccnxPortalArena_Release(&arena);
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortalArena_Deallocate)
+{
+    CCNxPortalArena *arena = ccnxPortalArena_Create();
+
+    ccnxPortalArena_Begin(arena);
+    void *memory = parcMemory_Allocate(10);
+    ccnxPortalArena_End(arena);
+
+    uint32_t outstanding = parcMemory_Outstanding();
+    parcMemory_Deallocate(&memory);
+    assertNull(memory, "Expected parcMemory_Deallocate to null the pointer");
+    assertTrue(parcMemory_Outstanding() == outstanding - 1, "Expected one fewer outstanding allocation");
+    assertTrue(ccnxPortalArena_GetAllocationCount(arena) == 1, "Expected the allocation to remain counted until a reset");
+
+    ccnxPortalArena_Release(&arena);
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortalArena_Reallocate)
+{
+    CCNxPortalArena *arena = ccnxPortalArena_Create();
+
+    ccnxPortalArena_Begin(arena);
+    char *memory = parcMemory_Allocate(4);
+    memcpy(memory, "abc", 4);
+    memory = parcMemory_Reallocate(memory, 1000);
+    ccnxPortalArena_End(arena);
+
+    assertTrue(_ccnxPortalArena_Owner(memory) == arena, "Expected the reallocation to come from the arena");
+    assertTrue(strcmp(memory, "abc") == 0, "Expected the contents to be preserved, actual '%s'", memory);
+
+    memory = parcMemory_Reallocate(memory, 8);
+    assertNull(_ccnxPortalArena_Owner(memory), "Expected a reallocation outside the arena to come from the heap");
+    assertTrue(strcmp(memory, "abc") == 0, "Expected the contents to be preserved, actual '%s'", memory);
+
+    parcMemory_Deallocate(&memory);
+    ccnxPortalArena_Release(&arena);
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortalArena_StringDuplicate)
+{
+    CCNxPortalArena *arena = ccnxPortalArena_Create();
+
+    ccnxPortalArena_Begin(arena);
+    char *string = parcMemory_StringDuplicate("Hello World", 5);
+    ccnxPortalArena_End(arena);
+
+    assertTrue(_ccnxPortalArena_Owner(string) == arena, "Expected the string to come from the arena");
+    assertTrue(strcmp(string, "Hello") == 0, "Expected 'Hello', actual '%s'", string);
+
+    parcMemory_Deallocate(&string);
+    ccnxPortalArena_Release(&arena);
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortalArena_Reset)
+{
+    CCNxPortalArena *arena = ccnxPortalArena_Create();
+
+    void *memory[1000];
+    for (int batch = 0; batch < 3; batch++) {
+        ccnxPortalArena_Begin(arena);
+        for (int i = 0; i < 1000; i++) {
+            memory[i] = parcMemory_Allocate(1000);
+        }
+        ccnxPortalArena_End(arena);
+
+        assertTrue(ccnxPortalArena_GetAllocationCount(arena) == 1000, "Expected 1000 allocations, actual %zu",
+                   ccnxPortalArena_GetAllocationCount(arena));
+        for (int i = 0; i < 1000; i++) {
+            parcMemory_Deallocate(&memory[i]);
+        }
+        ccnxPortalArena_Reset(arena);
+        assertTrue(ccnxPortalArena_GetAllocationCount(arena) == 0, "Expected no allocations after a reset");
+        assertTrue(ccnxPortalArena_GetAllocatedBytes(arena) == 0, "Expected no bytes after a reset");
+    }
+
+    size_t blocks = ccnxPortalArena_GetBlockCount(arena);
+    assertTrue(blocks == 4, "Expected the blocks of the first batch to be reused, actual %zu", blocks);
+
+    ccnxPortalArena_Release(&arena);
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortalArena_Nested)
+{
+    CCNxPortalArena *outer = ccnxPortalArena_Create();
+    CCNxPortalArena *inner = ccnxPortalArena_Create();
+
+    ccnxPortalArena_Begin(outer);
+    void *a = parcMemory_Allocate(10);
+    ccnxPortalArena_Begin(inner);
+    void *b = parcMemory_Allocate(10);
+    ccnxPortalArena_End(inner);
+    void *c = parcMemory_Allocate(10);
+    ccnxPortalArena_End(outer);
+
+    assertTrue(_ccnxPortalArena_Owner(a) == outer, "Expected the outer arena");
+    assertTrue(_ccnxPortalArena_Owner(b) == inner, "Expected the inner arena");
+    assertTrue(_ccnxPortalArena_Owner(c) == outer, "Expected the outer arena to be restored");
+
+    parcMemory_Deallocate(&a);
+    parcMemory_Deallocate(&b);
+    parcMemory_Deallocate(&c);
+
+    ccnxPortalArena_Release(&inner);
+    ccnxPortalArena_Release(&outer);
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortalArena_Suspend)
+{
+    CCNxPortalArena *arena = ccnxPortalArena_Create();
+
+    assertNull(ccnxPortalArena_Suspend(), "Expected no arena to be active");
+    ccnxPortalArena_Resume(NULL);
+
+    ccnxPortalArena_Begin(arena);
+    void *a = parcMemory_Allocate(10);
+    CCNxPortalArena *suspended = ccnxPortalArena_Suspend();
+    void *b = parcMemory_Allocate(10);
+    ccnxPortalArena_Resume(suspended);
+    void *c = parcMemory_Allocate(10);
+    ccnxPortalArena_End(arena);
+
+    assertTrue(suspended == arena, "Expected the active arena to be returned");
+    assertTrue(_ccnxPortalArena_Owner(a) == arena, "Expected the arena");
+    assertNull(_ccnxPortalArena_Owner(b), "Expected no arena while suspended");
+    assertTrue(_ccnxPortalArena_Owner(c) == arena, "Expected the arena to be resumed");
+
+    parcMemory_Deallocate(&a);
+    parcMemory_Deallocate(&b);
+    parcMemory_Deallocate(&c);
+    ccnxPortalArena_Release(&arena);
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortalArena_Objects)
+{
+    CCNxPortalArena *arena = ccnxPortalArena_Create();
+
+    ccnxPortalArena_Begin(arena);
+    PARCBuffer *buffer = parcBuffer_Allocate(64);
+    ccnxPortalArena_End(arena);
+
+    assertTrue(ccnxPortalArena_GetAllocationCount(arena) > 0, "Expected the buffer to be allocated from the arena");
+    parcBuffer_PutUint32(buffer, 42);
+    parcBuffer_Release(&buffer);
+
+    ccnxPortalArena_Reset(arena);
+    ccnxPortalArena_Release(&arena);
+}
+
+int
+main(int argc, char *argv[argc])
+{
+    LongBowRunner *testRunner = LONGBOW_TEST_RUNNER_CREATE(test_ccnx_PortalArena);
+    int exitStatus = longBowMain(argc, argv, testRunner, NULL);
+    longBowTestRunner_Destroy(&testRunner);
+    exit(exitStatus);
+}
@@ -0,0 +1,226 @@
+/*
+ * Copyright (c) 2016, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX OR PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ################################################################################
+ * #
+ * # PATENT NOTICE
+ * #
+ * # This software is distributed under the BSD 2-clause License (see LICENSE
+ * # file).  This BSD License does not make any patent claims and as such, does
+ * # not act as a patent grant.  The purpose of this section is for each contributor
+ * # to define their intentions with respect to intellectual property.
+ * #
+ * # Each contributor to this source code is encouraged to state their patent
+ * # claims and licensing mechanisms for any contributions made. At the end of
+ * # this section contributors may each make their own statements.  Contributor's
+ * # claims and grants only apply to the pieces (source code, programs, text,
+ * # media, etc) that they have contributed directly to this software.
+ * #
+ * # There is no guarantee that this section is complete, up to date or accurate. It
+ * # is up to the contributors to maintain their portion of this section and up to
+ * # the user of the software to verify any claims herein.
+ * #
+ * # Do not remove this header notification.  The contents of this section must be
+ * # present in all distributions of the software.  You may only modify your own
+ * # intellectual property statements.  Please provide contact information.
+ *
+ * - Palo Alto Research Center, Inc
+ * This software distribution does not grant any rights to patents owned by Palo
+ * Alto Research Center, Inc (PARC). Rights to these patents are available via
+ * various mechanisms. As of January 2016 PARC has committed to FRAND licensing any
+ * intellectual property used by its contributions to this software. You may
+ * contact PARC at cipo@parc.com for more information or visit http://www.ccnx.org
+ */
+/**
+ * @copyright (c) 2016, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC).  All rights reserved.
+ */
+#include "../ccnx_PortalAttributes.c"
+
+#include <LongBow/unit-test.h>
+#include <LongBow/debugging.h>
+
+#include <stdio.h>
+#include <unistd.h>
+
+#include <parc/algol/parc_Memory.h>
+#include <parc/algol/parc_SafeMemory.h>
+#include <parc/testing/parc_ObjectTesting.h>
+
+LONGBOW_TEST_RUNNER(test_ccnx_PortalAttributes)
+{
+    LONGBOW_RUN_TEST_FIXTURE(Global);
+}
+
+LONGBOW_TEST_RUNNER_SETUP(test_ccnx_PortalAttributes)
+{
+    parcMemory_SetInterface(&PARCSafeMemoryAsPARCMemory);
+
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_RUNNER_TEARDOWN(test_ccnx_PortalAttributes)
+{
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_FIXTURE(Global)
+{
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortalAttributes_Constants);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortalAttributes_CreateAcquireRelease);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortalAttributes_Copy);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortalAttributes_Equals);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortalAttributes_SetGet);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortalAttributes_SetMaxBatchSize_Zero);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortalAttributes_ToJSON);
+}
+
+static size_t InitialMemoryOutstanding = 0;
+
+LONGBOW_TEST_FIXTURE_SETUP(Global)
+{
+    InitialMemoryOutstanding = parcMemory_Outstanding();
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_FIXTURE_TEARDOWN(Global)
+{
+    if (parcMemory_Outstanding() != InitialMemoryOutstanding) {
+        parcSafeMemory_ReportAllocation(STDOUT_FILENO);
+        printf("('%s' leaks memory by %zd\n",
+               longBowTestCase_GetName(testCase), parcMemory_Outstanding() - InitialMemoryOutstanding);
+        return LONGBOW_STATUS_MEMORYLEAK;
+    }
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortalAttributes_Constants)
+{
+    assertFalse(ccnxPortalAttributes_IsBlocking(&ccnxPortalAttributes_NonBlocking), "Expected NonBlocking not to block");
+    assertTrue(ccnxPortalAttributes_IsBlocking(&ccnxPortalAttributes_Blocking), "Expected Blocking to block");
+    assertFalse(ccnxPortalAttributes_IsLogging(&ccnxPortalAttributes_NonBlocking), "Expected logging to be off");
+    assertTrue(ccnxPortalAttributes_GetMaxBatchSize(&ccnxPortalAttributes_NonBlocking) == 1, "Expected a batch size of 1");
+    assertTrue(ccnxPortalAttributes_GetBusyPollCpu(&ccnxPortalAttributes_NonBlocking) == -1, "Expected no CPU pinning");
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortalAttributes_CreateAcquireRelease)
+{
+    CCNxPortalAttributes *attributes = ccnxPortalAttributes_Create();
+    assertNotNull(attributes, "Expected a non-null CCNxPortalAttributes");
+    assertTrue(ccnxPortalAttributes_Equals(attributes, &ccnxPortalAttributes_NonBlocking), "Expected the NonBlocking values");
+
+    parcObjectTesting_AssertAcquireReleaseContract(ccnxPortalAttributes_Acquire, attributes);
+
+    ccnxPortalAttributes_Release(&attributes);
+    assertNull(attributes, "Expected ccnxPortalAttributes_Release to null the pointer");
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortalAttributes_Copy)
+{
+    CCNxPortalAttributes *copy = ccnxPortalAttributes_Copy(&ccnxPortalAttributes_Blocking);
+    assertTrue(ccnxPortalAttributes_Equals(copy, &ccnxPortalAttributes_Blocking), "Expected the copy to equal the original");
+
+    ccnxPortalAttributes_SetBlocking(copy, false);
+    assertTrue(ccnxPortalAttributes_IsBlocking(&ccnxPortalAttributes_Blocking), "Expected the original to be unchanged");
+
+    ccnxPortalAttributes_Release(&copy);
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortalAttributes_Equals)
+{
+    CCNxPortalAttributes *x = ccnxPortalAttributes_Create();
+    CCNxPortalAttributes *y = ccnxPortalAttributes_Create();
+    CCNxPortalAttributes *z = ccnxPortalAttributes_Create();
+    CCNxPortalAttributes *u1 = ccnxPortalAttributes_Create();
+    ccnxPortalAttributes_SetBusyPollMicroSeconds(u1, 10);
+    CCNxPortalAttributes *u2 = ccnxPortalAttributes_Create();
+    ccnxPortalAttributes_SetSocketSendBufferSize(u2, 8192);
+
+    parcObjectTesting_AssertEqualsFunction(ccnxPortalAttributes_Equals, x, y, z, u1, u2, NULL);
+
+    ccnxPortalAttributes_Release(&u2);
+    ccnxPortalAttributes_Release(&u1);
+    ccnxPortalAttributes_Release(&z);
+    ccnxPortalAttributes_Release(&y);
+    ccnxPortalAttributes_Release(&x);
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortalAttributes_SetGet)
+{
+    CCNxPortalAttributes *attributes = ccnxPortalAttributes_Create();
+
+    ccnxPortalAttributes_SetLogging(attributes, true);
+    ccnxPortalAttributes_SetBlocking(attributes, true);
+    ccnxPortalAttributes_SetSendQueueLimit(attributes, 10);
+    ccnxPortalAttributes_SetReceiveQueueLimit(attributes, 20);
+    ccnxPortalAttributes_SetMaxBatchSize(attributes, 30);
+    ccnxPortalAttributes_SetBusyPollMicroSeconds(attributes, 40);
+    ccnxPortalAttributes_SetBusyPollCpu(attributes, 2);
+    ccnxPortalAttributes_SetSocketSendBufferSize(attributes, 50);
+    ccnxPortalAttributes_SetSocketReceiveBufferSize(attributes, 60);
+
+    assertTrue(ccnxPortalAttributes_IsLogging(attributes), "Expected logging");
+    assertTrue(ccnxPortalAttributes_IsBlocking(attributes), "Expected blocking");
+    assertTrue(ccnxPortalAttributes_GetSendQueueLimit(attributes) == 10, "Expected send queue limit 10");
+    assertTrue(ccnxPortalAttributes_GetReceiveQueueLimit(attributes) == 20, "Expected receive queue limit 20");
+    assertTrue(ccnxPortalAttributes_GetMaxBatchSize(attributes) == 30, "Expected max batch size 30");
+    assertTrue(ccnxPortalAttributes_GetBusyPollMicroSeconds(attributes) == 40, "Expected busy-poll 40");
+    assertTrue(ccnxPortalAttributes_GetBusyPollCpu(attributes) == 2, "Expected busy-poll CPU 2");
+    assertTrue(ccnxPortalAttributes_GetSocketSendBufferSize(attributes) == 50, "Expected send buffer 50");
+    assertTrue(ccnxPortalAttributes_GetSocketReceiveBufferSize(attributes) == 60, "Expected receive buffer 60");
+
+    ccnxPortalAttributes_Release(&attributes);
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortalAttributes_SetMaxBatchSize_Zero)
+{
+    CCNxPortalAttributes *attributes = ccnxPortalAttributes_Create();
+
+    ccnxPortalAttributes_SetMaxBatchSize(attributes, 0);
+    assertTrue(ccnxPortalAttributes_GetMaxBatchSize(attributes) == 1, "Expected a batch size of 0 to mean 1");
+
+    ccnxPortalAttributes_Release(&attributes);
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortalAttributes_ToJSON)
+{
+    CCNxPortalAttributes *attributes = ccnxPortalAttributes_Create();
+    ccnxPortalAttributes_SetBusyPollMicroSeconds(attributes, 25);
+
+    PARCJSON *json = ccnxPortalAttributes_ToJSON(attributes);
+    const PARCJSONValue *value = parcJSON_GetValueByName(json, "busyPollMicroSeconds");
+    assertNotNull(value, "Expected a busyPollMicroSeconds member");
+    assertTrue(parcJSONValue_GetInteger(value) == 25, "Expected busyPollMicroSeconds 25");
+
+    parcJSON_Release(&json);
+    ccnxPortalAttributes_Release(&attributes);
+}
+
+int
+main(int argc, char *argv[argc])
+{
+    LongBowRunner *testRunner = LONGBOW_TEST_RUNNER_CREATE(test_ccnx_PortalAttributes);
+    int exitStatus = longBowMain(argc, argv, testRunner, NULL);
+    longBowTestRunner_Destroy(&testRunner);
+    exit(exitStatus);
+}
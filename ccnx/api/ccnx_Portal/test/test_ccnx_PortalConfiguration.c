@@ -0,0 +1,211 @@
+/*
+ * Copyright (c) 2016, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX OR PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ################################################################################
+ * #
+ * # PATENT NOTICE
+ * #
+ * # This software is distributed under the BSD 2-clause License (see LICENSE
+ * # file).  This BSD License does not make any patent claims and as such, does
+ * # not act as a patent grant.  The purpose of this section is for each contributor
+ * # to define their intentions with respect to intellectual property.
+ * #
+ * # Each contributor to this source code is encouraged to state their patent
+ * # claims and licensing mechanisms for any contributions made. At the end of
+ * # this section contributors may each make their own statements.  Contributor's
+ * # claims and grants only apply to the pieces (source code, programs, text,
+ * # media, etc) that they have contributed directly to this software.
+ * #
+ * # There is no guarantee that this section is complete, up to date or accurate. It
+ * # is up to the contributors to maintain their portion of this section and up to
+ * # the user of the software to verify any claims herein.
+ * #
+ * # Do not remove this header notification.  The contents of this section must be
+ * # present in all distributions of the software.  You may only modify your own
+ * # intellectual property statements.  Please provide contact information.
+ *
+ * - Palo Alto Research Center, Inc
+ * This software distribution does not grant any rights to patents owned by Palo
+ * Alto Research Center, Inc (PARC). Rights to these patents are available via
+ * various mechanisms. As of January 2016 PARC has committed to FRAND licensing any
+ * intellectual property used by its contributions to this software. You may
+ * contact PARC at cipo@parc.com for more information or visit http://www.ccnx.org
+ */
+/**
+ * @copyright (c) 2016, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC).  All rights reserved.
+ */
+#include "../ccnx_PortalConfiguration.c"
+
+#include <LongBow/unit-test.h>
+#include <LongBow/debugging.h>
+
+#include <stdio.h>
+#include <unistd.h>
+
+#include <parc/algol/parc_Memory.h>
+#include <parc/algol/parc_SafeMemory.h>
+#include <parc/testing/parc_ObjectTesting.h>
+
+LONGBOW_TEST_RUNNER(test_ccnx_PortalConfiguration)
+{
+    LONGBOW_RUN_TEST_FIXTURE(Global);
+}
+
+LONGBOW_TEST_RUNNER_SETUP(test_ccnx_PortalConfiguration)
+{
+    parcMemory_SetInterface(&PARCSafeMemoryAsPARCMemory);
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_RUNNER_TEARDOWN(test_ccnx_PortalConfiguration)
+{
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_FIXTURE(Global)
+{
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortalConfiguration_CreateAcquireRelease);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortalConfiguration_Create_Defaults);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortalConfiguration_Create_Properties);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortalConfiguration_Create_Malformed);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortalConfiguration_IsConfigurationProperty);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortalConfiguration_IsValidProperty);
+}
+
+static size_t InitialMemoryOutstanding = 0;
+
+LONGBOW_TEST_FIXTURE_SETUP(Global)
+{
+    InitialMemoryOutstanding = parcMemory_Outstanding();
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_FIXTURE_TEARDOWN(Global)
+{
+    if (parcMemory_Outstanding() != InitialMemoryOutstanding) {
+        parcSafeMemory_ReportAllocation(STDOUT_FILENO);
+        printf("('%s' leaks memory by %zd\n",
+               longBowTestCase_GetName(testCase), parcMemory_Outstanding() - InitialMemoryOutstanding);
+        return LONGBOW_STATUS_MEMORYLEAK;
+    }
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortalConfiguration_CreateAcquireRelease)
+{
+    PARCProperties *properties = parcProperties_Create();
+
+    CCNxPortalConfiguration *configuration = ccnxPortalConfiguration_Create(properties);
+    assertNotNull(configuration, "Expected a non-null configuration");
+
+    parcObjectTesting_AssertAcquireReleaseContract(ccnxPortalConfiguration_Acquire, configuration);
+
+    ccnxPortalConfiguration_Release(&configuration);
+    assertNull(configuration, "Expected ccnxPortalConfiguration_Release to null the pointer");
+    parcProperties_Release(&properties);
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortalConfiguration_Create_Defaults)
+{
+    PARCProperties *properties = parcProperties_Create();
+    CCNxPortalConfiguration *configuration = ccnxPortalConfiguration_Create(properties);
+
+    CCNxName *routerName = ccnxName_CreateFromCString("lci:/local/dcr");
+    CCNxName *anchorName = ccnxName_CreateFromCString("lci:/local/dcr/anchor");
+
+    assertTrue(ccnxName_Equals(routerName, ccnxPortalConfiguration_GetLocalRouterName(configuration)), "Expected the default router name");
+    assertTrue(ccnxName_Equals(anchorName, ccnxPortalConfiguration_GetAnchorName(configuration)), "Expected the default anchor name");
+    assertTrue(ccnxPortalConfiguration_GetLocalRouterTimeout(configuration) == 1000000, "Expected the default timeout");
+
+    ccnxName_Release(&anchorName);
+    ccnxName_Release(&routerName);
+    ccnxPortalConfiguration_Release(&configuration);
+    parcProperties_Release(&properties);
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortalConfiguration_Create_Properties)
+{
+    PARCProperties *properties = parcProperties_Create();
+    parcProperties_SetProperty(properties, CCNxPortalFactory_LocalRouterName, "lci:/my/router");
+    parcProperties_SetProperty(properties, CCNxPortalFactory_LocalRouterTimeout, "2500");
+
+    CCNxPortalConfiguration *configuration = ccnxPortalConfiguration_Create(properties);
+
+    CCNxName *anchorName = ccnxName_CreateFromCString("lci:/my/router/anchor");
+    assertTrue(ccnxName_Equals(anchorName, ccnxPortalConfiguration_GetAnchorName(configuration)), "Expected the anchor name under lci:/my/router");
+    assertTrue(ccnxPortalConfiguration_GetLocalRouterTimeout(configuration) == 2500, "Expected timeout 2500");
+
+    ccnxName_Release(&anchorName);
+    ccnxPortalConfiguration_Release(&configuration);
+    parcProperties_Release(&properties);
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortalConfiguration_Create_Malformed)
+{
+    const char *properties[][2] = {
+        { CCNxPortalFactory_LocalRouterName,    "not a name"  },
+        { CCNxPortalFactory_LocalRouterTimeout, "-1"          },
+        { CCNxPortalFactory_LocalRouterTimeout, "1000 us"     },
+        { CCNxPortalFactory_LocalRouterTimeout, ""            },
+        { NULL,                                 NULL          }
+    };
+
+    for (int i = 0; properties[i][0] != NULL; i++) {
+        PARCProperties *malformed = parcProperties_Create();
+        parcProperties_SetProperty(malformed, properties[i][0], properties[i][1]);
+
+        errno = 0;
+        CCNxPortalConfiguration *configuration = ccnxPortalConfiguration_Create(malformed);
+
+        assertNull(configuration, "Expected '%s' to be rejected", properties[i][1]);
+        assertTrue(errno == EINVAL, "Expected EINVAL for '%s', actual %d", properties[i][1], errno);
+
+        parcProperties_Release(&malformed);
+    }
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortalConfiguration_IsConfigurationProperty)
+{
+    assertTrue(ccnxPortalConfiguration_IsConfigurationProperty(CCNxPortalFactory_LocalRouterName), "Expected LocalRouterName");
+    assertTrue(ccnxPortalConfiguration_IsConfigurationProperty(CCNxPortalFactory_LocalRouterTimeout), "Expected LocalRouterTimeout");
+    assertFalse(ccnxPortalConfiguration_IsConfigurationProperty("/other"), "Expected other properties not to be part of the configuration");
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortalConfiguration_IsValidProperty)
+{
+    assertTrue(ccnxPortalConfiguration_IsValidProperty(CCNxPortalFactory_LocalRouterName, "lci:/my/router"), "Expected a valid name");
+    assertFalse(ccnxPortalConfiguration_IsValidProperty(CCNxPortalFactory_LocalRouterName, "not a name"), "Expected an invalid name");
+    assertTrue(ccnxPortalConfiguration_IsValidProperty(CCNxPortalFactory_LocalRouterTimeout, "2500"), "Expected a valid timeout");
+    assertFalse(ccnxPortalConfiguration_IsValidProperty(CCNxPortalFactory_LocalRouterTimeout, "1 second"), "Expected an invalid timeout");
+    assertTrue(ccnxPortalConfiguration_IsValidProperty("/other", "anything"), "Expected any value for other properties");
+}
+
+int
+main(int argc, char *argv[argc])
+{
+    LongBowRunner *testRunner = LONGBOW_TEST_RUNNER_CREATE(test_ccnx_PortalConfiguration);
+    int exitStatus = longBowMain(argc, argv, testRunner, NULL);
+    longBowTestRunner_Destroy(&testRunner);
+    exit(exitStatus);
+}
@@ -0,0 +1,278 @@
+/*
+ * Copyright (c) 2016, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX OR PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ################################################################################
+ * #
+ * # PATENT NOTICE
+ * #
+ * # This software is distributed under the BSD 2-clause License (see LICENSE
+ * # file).  This BSD License does not make any patent claims and as such, does
+ * # not act as a patent grant.  The purpose of this section is for each contributor
+ * # to define their intentions with respect to intellectual property.
+ * #
+ * # Each contributor to this source code is encouraged to state their patent
+ * # claims and licensing mechanisms for any contributions made. At the end of
+ * # this section contributors may each make their own statements.  Contributor's
+ * # claims and grants only apply to the pieces (source code, programs, text,
+ * # media, etc) that they have contributed directly to this software.
+ * #
+ * # There is no guarantee that this section is complete, up to date or accurate. It
+ * # is up to the contributors to maintain their portion of this section and up to
+ * # the user of the software to verify any claims herein.
+ * #
+ * # Do not remove this header notification.  The contents of this section must be
+ * # present in all distributions of the software.  You may only modify your own
+ * # intellectual property statements.  Please provide contact information.
+ *
+ * - Palo Alto Research Center, Inc
+ * This software distribution does not grant any rights to patents owned by Palo
+ * Alto Research Center, Inc (PARC). Rights to these patents are available via
+ * various mechanisms. As of January 2016 PARC has committed to FRAND licensing any
+ * intellectual property used by its contributions to this software. You may
+ * contact PARC at cipo@parc.com for more information or visit http://www.ccnx.org
+ */
+/**
+ * @copyright (c) 2016, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC).  All rights reserved.
+ */
+#include "../ccnx_PortalExecutor.c"
+
+#include <LongBow/unit-test.h>
+#include <LongBow/debugging.h>
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <unistd.h>
+
+#include <parc/algol/parc_Memory.h>
+#include <parc/algol/parc_SafeMemory.h>
+#include <parc/testing/parc_ObjectTesting.h>
+
+LONGBOW_TEST_RUNNER(test_ccnx_PortalExecutor)
+{
+    LONGBOW_RUN_TEST_FIXTURE(Global);
+}
+
+LONGBOW_TEST_RUNNER_SETUP(test_ccnx_PortalExecutor)
+{
+    parcMemory_SetInterface(&PARCSafeMemoryAsPARCMemory);
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_RUNNER_TEARDOWN(test_ccnx_PortalExecutor)
+{
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_FIXTURE(Global)
+{
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortalExecutor_CreateAcquireRelease);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortalExecutor_Create_Invalid);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortalExecutor_Submit_Wait);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortalExecutor_Submit_Shed);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortalExecutor_Submit_FromTask_Stolen);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortalExecutor_Release_RunsQueued);
+}
+
+static size_t InitialMemoryOutstanding = 0;
+
+LONGBOW_TEST_FIXTURE_SETUP(Global)
+{
+    InitialMemoryOutstanding = parcMemory_Outstanding();
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_FIXTURE_TEARDOWN(Global)
+{
+    if (parcMemory_Outstanding() != InitialMemoryOutstanding) {
+        parcSafeMemory_ReportAllocation(STDOUT_FILENO);
+        printf("('%s' leaks memory by %zd\n",
+               longBowTestCase_GetName(testCase), parcMemory_Outstanding() - InitialMemoryOutstanding);
+        return LONGBOW_STATUS_MEMORYLEAK;
+    }
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+/*
+ * The state shared by a test and its tasks.
+ * A gated task waits until the test opens the gate, so the test can keep workers busy while it fills their queues.
+ */
+typedef struct {
+    CCNxPortalExecutor *executor;
+    int runs;
+    int started;
+    bool open;
+    int children;
+} _TestTaskState;
+
+// The most a task or test waits for another thread, in milliseconds, before giving up.
+#define _TestPatienceMilliseconds 5000
+
+static bool
+_waitFor(const int *counter, int expected)
+{
+    for (int i = 0; i < _TestPatienceMilliseconds; i++) {
+        if (__atomic_load_n(counter, __ATOMIC_ACQUIRE) >= expected) {
+            return true;
+        }
+        usleep(1000);
+    }
+    return false;
+}
+
+static void
+_countTask(void *argument)
+{
+    _TestTaskState *state = argument;
+    __atomic_add_fetch(&state->runs, 1, __ATOMIC_ACQ_REL);
+}
+
+static void
+_gatedTask(void *argument)
+{
+    _TestTaskState *state = argument;
+    __atomic_add_fetch(&state->started, 1, __ATOMIC_ACQ_REL);
+    for (int i = 0; i < _TestPatienceMilliseconds && !__atomic_load_n(&state->open, __ATOMIC_ACQUIRE); i++) {
+        usleep(1000);
+    }
+    __atomic_add_fetch(&state->runs, 1, __ATOMIC_ACQ_REL);
+}
+
+/*
+ * Queue tasks on this task's own worker, then wait for them without returning to the worker,
+ * so only another worker stealing them can run them.
+ */
+static void
+_parentTask(void *argument)
+{
+    _TestTaskState *state = argument;
+    for (int i = 0; i < state->children; i++) {
+        ccnxPortalExecutor_Submit(state->executor, _countTask, state);
+    }
+    _waitFor(&state->runs, state->children);
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortalExecutor_CreateAcquireRelease)
+{
+    CCNxPortalExecutor *executor = ccnxPortalExecutor_Create(4, 16);
+    assertNotNull(executor, "Expected a non-null executor");
+    assertTrue(ccnxPortalExecutor_GetWorkerCount(executor) == 4, "Expected 4 workers, actual %zu", ccnxPortalExecutor_GetWorkerCount(executor));
+    assertTrue(ccnxPortalExecutor_GetPendingCount(executor) == 0, "Expected no pending tasks");
+
+    parcObjectTesting_AssertAcquireReleaseContract(ccnxPortalExecutor_Acquire, executor);
+
+    ccnxPortalExecutor_Release(&executor);
+    assertNull(executor, "Expected ccnxPortalExecutor_Release to null the pointer");
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortalExecutor_Create_Invalid)
+{
+    errno = 0;
+    assertNull(ccnxPortalExecutor_Create(0, 16), "Expected NULL for no workers");
+    assertTrue(errno == EINVAL, "Expected EINVAL, actual %d", errno);
+
+    errno = 0;
+    assertNull(ccnxPortalExecutor_Create(4, 0), "Expected NULL for no queue capacity");
+    assertTrue(errno == EINVAL, "Expected EINVAL, actual %d", errno);
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortalExecutor_Submit_Wait)
+{
+    CCNxPortalExecutor *executor = ccnxPortalExecutor_Create(4, 64);
+    _TestTaskState state = { .executor = executor };
+
+    for (int i = 0; i < 200; i++) {
+        assertTrue(ccnxPortalExecutor_Submit(executor, _countTask, &state), "Expected task %d to be queued", i);
+    }
+    ccnxPortalExecutor_Wait(executor);
+
+    assertTrue(state.runs == 200, "Expected 200 runs, actual %d", state.runs);
+    assertTrue(ccnxPortalExecutor_GetCompletedCount(executor) == 200,
+               "Expected 200 completed, actual %" PRIu64, ccnxPortalExecutor_GetCompletedCount(executor));
+    assertTrue(ccnxPortalExecutor_GetPendingCount(executor) == 0, "Expected no pending tasks");
+    assertTrue(ccnxPortalExecutor_GetShedCount(executor) == 0, "Expected no shed tasks");
+
+    ccnxPortalExecutor_Release(&executor);
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortalExecutor_Submit_Shed)
+{
+    CCNxPortalExecutor *executor = ccnxPortalExecutor_Create(1, 2);
+    _TestTaskState state = { .executor = executor };
+
+    // Keep the only worker busy, so the queue fills.
+    ccnxPortalExecutor_Submit(executor, _gatedTask, &state);
+    assertTrue(_waitFor(&state.started, 1), "Expected the gated task to start");
+
+    assertTrue(ccnxPortalExecutor_Submit(executor, _countTask, &state), "Expected the first task to be queued");
+    assertTrue(ccnxPortalExecutor_Submit(executor, _countTask, &state), "Expected the second task to be queued");
+
+    errno = 0;
+    assertFalse(ccnxPortalExecutor_Submit(executor, _countTask, &state), "Expected a task beyond the capacity to be shed");
+    assertTrue(errno == EBUSY, "Expected EBUSY, actual %d", errno);
+    assertTrue(ccnxPortalExecutor_GetShedCount(executor) == 1,
+               "Expected 1 shed task, actual %" PRIu64, ccnxPortalExecutor_GetShedCount(executor));
+
+    __atomic_store_n(&state.open, true, __ATOMIC_RELEASE);
+    ccnxPortalExecutor_Wait(executor);
+    assertTrue(state.runs == 3, "Expected the gated and the 2 queued tasks to run, actual %d", state.runs);
+
+    ccnxPortalExecutor_Release(&executor);
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortalExecutor_Submit_FromTask_Stolen)
+{
+    CCNxPortalExecutor *executor = ccnxPortalExecutor_Create(2, 16);
+    _TestTaskState state = { .executor = executor, .children = 8 };
+
+    ccnxPortalExecutor_Submit(executor, _parentTask, &state);
+    ccnxPortalExecutor_Wait(executor);
+
+    assertTrue(state.runs == 8, "Expected every child task to run, actual %d", state.runs);
+    assertTrue(ccnxPortalExecutor_GetStolenCount(executor) >= 8,
+               "Expected the idle worker to steal the children, actual %" PRIu64, ccnxPortalExecutor_GetStolenCount(executor));
+
+    ccnxPortalExecutor_Release(&executor);
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortalExecutor_Release_RunsQueued)
+{
+    CCNxPortalExecutor *executor = ccnxPortalExecutor_Create(2, 64);
+    _TestTaskState state = { .executor = executor };
+
+    for (int i = 0; i < 100; i++) {
+        ccnxPortalExecutor_Submit(executor, _countTask, &state);
+    }
+    ccnxPortalExecutor_Release(&executor);
+
+    assertTrue(state.runs == 100, "Expected the queued tasks to run before the workers stop, actual %d", state.runs);
+}
+
+int
+main(int argc, char *argv[argc])
+{
+    LongBowRunner *testRunner = LONGBOW_TEST_RUNNER_CREATE(test_ccnx_PortalExecutor);
+    int exitStatus = longBowMain(argc, argv, testRunner, NULL);
+    longBowTestRunner_Destroy(&testRunner);
+    exit(exitStatus);
+}
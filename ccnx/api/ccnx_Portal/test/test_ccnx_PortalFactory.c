@@ -173,6 +173,8 @@ LONGBOW_TEST_FIXTURE(Global)
 {
     LONGBOW_RUN_TEST_CASE(Global, ccnxPortalFactory_GetIdentity);
     LONGBOW_RUN_TEST_CASE(Global, ccnxPortalFactory_GetKeyId);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortalFactory_SetAttributes);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortalFactory_GetConfiguration);
 }
 
 LONGBOW_TEST_FIXTURE_SETUP(Global)
@@ -247,6 +249,86 @@ LONGBOW_TEST_CASE(Global, ccnxPortalFactory_GetKeyId)
     parcSecurity_Fini();
 }
 
+LONGBOW_TEST_CASE(Global, ccnxPortalFactory_SetAttributes)
+{
+    const char *keystoreName = "ccnxPortalFactory_keystore";
+
+    parcSecurity_Init();
+    bool success = parcPkcs12KeyStore_CreateFile(keystoreName, "keystore_password", "consumer", 1024, 30);
+    assertTrue(success, "parcPkcs12KeyStore_CreateFile('%s', 'keystore_password') failed.", keystoreName);
+
+    PARCIdentityFile *identityFile = parcIdentityFile_Create(keystoreName, "keystore_password");
+    PARCIdentity *identity = parcIdentity_Create(identityFile, PARCIdentityFileAsPARCIdentity);
+
+    CCNxPortalFactory *factory = ccnxPortalFactory_Create(identity);
+
+    CCNxPortalAttributes *defaults = ccnxPortalAttributes_Acquire(ccnxPortalFactory_GetAttributes(factory));
+    assertTrue(ccnxPortalAttributes_Equals(defaults, &ccnxPortalAttributes_NonBlocking),
+               "Expected the default attributes to be non-blocking");
+
+    CCNxPortalAttributes *attributes = ccnxPortalAttributes_Copy(&ccnxPortalAttributes_Blocking);
+    ccnxPortalAttributes_SetMaxBatchSize(attributes, 32);
+    ccnxPortalFactory_SetAttributes(factory, attributes);
+
+    const CCNxPortalAttributes *actual = ccnxPortalFactory_GetAttributes(factory);
+    assertTrue(actual != attributes, "Expected the factory to keep its own copy");
+    assertTrue(ccnxPortalAttributes_Equals(actual, attributes), "Expected the attributes that were set");
+    assertTrue(ccnxPortalAttributes_Equals(defaults, &ccnxPortalAttributes_NonBlocking),
+               "Expected an acquired reference to the default attributes to outlive setting new ones");
+
+    ccnxPortalAttributes_Release(&defaults);
+    ccnxPortalAttributes_Release(&attributes);
+    ccnxPortalFactory_Release(&factory);
+
+    parcIdentityFile_Release(&identityFile);
+    parcIdentity_Release(&identity);
+
+    parcSecurity_Fini();
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortalFactory_GetConfiguration)
+{
+    const char *keystoreName = "ccnxPortalFactory_keystore";
+
+    parcSecurity_Init();
+    bool success = parcPkcs12KeyStore_CreateFile(keystoreName, "keystore_password", "consumer", 1024, 30);
+    assertTrue(success, "parcPkcs12KeyStore_CreateFile('%s', 'keystore_password') failed.", keystoreName);
+
+    PARCIdentityFile *identityFile = parcIdentityFile_Create(keystoreName, "keystore_password");
+    PARCIdentity *identity = parcIdentity_Create(identityFile, PARCIdentityFileAsPARCIdentity);
+
+    CCNxPortalFactory *factory = ccnxPortalFactory_Create(identity);
+
+    const CCNxPortalConfiguration *initial = ccnxPortalFactory_GetConfiguration(factory);
+    assertTrue(ccnxPortalConfiguration_GetLocalRouterTimeout(initial) == 1000000, "Expected the default timeout");
+
+    ccnxPortalFactory_SetProperty(factory, "unrelated", "value");
+    assertTrue(ccnxPortalFactory_GetConfiguration(factory) == initial, "Expected an unrelated property to keep the snapshot");
+
+    ccnxPortalFactory_SetProperty(factory, CCNxPortalFactory_LocalRouterTimeout, "1000000");
+    assertTrue(ccnxPortalFactory_GetConfiguration(factory) == initial, "Expected an unchanged value to keep the snapshot");
+
+    ccnxPortalFactory_SetProperty(factory, CCNxPortalFactory_LocalRouterName, "lci:/router");
+    const CCNxPortalConfiguration *actual = ccnxPortalFactory_GetConfiguration(factory);
+
+    CCNxName *expected = ccnxName_CreateFromCString("lci:/router/anchor");
+    assertTrue(ccnxName_Equals(expected, ccnxPortalConfiguration_GetAnchorName(actual)), "Expected the anchor name to follow the router name");
+    ccnxName_Release(&expected);
+
+    assertFalse(ccnxPortalFactory_SetProperty(factory, CCNxPortalFactory_LocalRouterTimeout, "-1"), "Expected a negative timeout to be rejected");
+    assertTrue(errno == EINVAL, "Expected EINVAL, actual %d", errno);
+    assertTrue(strcmp(ccnxPortalFactory_GetProperty(factory, CCNxPortalFactory_LocalRouterTimeout, ""), "1000000") == 0,
+               "Expected a rejected value to leave the property unchanged");
+    assertTrue(ccnxPortalFactory_GetConfiguration(factory) == actual, "Expected a rejected value to keep the snapshot");
+
+    ccnxPortalFactory_Release(&factory);
+
+    parcIdentityFile_Release(&identityFile);
+    parcIdentity_Release(&identity);
+
+    parcSecurity_Fini();
+}
+
 LONGBOW_TEST_FIXTURE(Errors)
 {
     LONGBOW_RUN_TEST_CASE(Errors, ccnxPortalFactory_Create_NULL_Identity);
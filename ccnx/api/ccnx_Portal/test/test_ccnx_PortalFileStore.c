@@ -0,0 +1,384 @@
+/*
+ * Copyright (c) 2016, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX OR PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ################################################################################
+ * #
+ * # PATENT NOTICE
+ * #
+ * # This software is distributed under the BSD 2-clause License (see LICENSE
+ * # file).  This BSD License does not make any patent claims and as such, does
+ * # not act as a patent grant.  The purpose of this section is for each contributor
+ * # to define their intentions with respect to intellectual property.
+ * #
+ * # Each contributor to this source code is encouraged to state their patent
+ * # claims and licensing mechanisms for any contributions made. At the end of
+ * # this section contributors may each make their own statements.  Contributor's
+ * # claims and grants only apply to the pieces (source code, programs, text,
+ * # media, etc) that they have contributed directly to this software.
+ * #
+ * # There is no guarantee that this section is complete, up to date or accurate. It
+ * # is up to the contributors to maintain their portion of this section and up to
+ * # the user of the software to verify any claims herein.
+ * #
+ * # Do not remove this header notification.  The contents of this section must be
+ * # present in all distributions of the software.  You may only modify your own
+ * # intellectual property statements.  Please provide contact information.
+ *
+ * - Palo Alto Research Center, Inc
+ * This software distribution does not grant any rights to patents owned by Palo
+ * Alto Research Center, Inc (PARC). Rights to these patents are available via
+ * various mechanisms. As of January 2016 PARC has committed to FRAND licensing any
+ * intellectual property used by its contributions to this software. You may
+ * contact PARC at cipo@parc.com for more information or visit http://www.ccnx.org
+ */
+/**
+ * @copyright (c) 2016, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC).  All rights reserved.
+ */
+#include "../ccnx_PortalFileStore.c"
+
+#include <LongBow/unit-test.h>
+#include <LongBow/debugging.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <parc/algol/parc_Memory.h>
+#include <parc/algol/parc_SafeMemory.h>
+#include <parc/testing/parc_ObjectTesting.h>
+
+LONGBOW_TEST_RUNNER(test_ccnx_PortalFileStore)
+{
+    LONGBOW_RUN_TEST_FIXTURE(Global);
+    LONGBOW_RUN_TEST_FIXTURE(Performance);
+}
+
+LONGBOW_TEST_RUNNER_SETUP(test_ccnx_PortalFileStore)
+{
+    parcMemory_SetInterface(&PARCSafeMemoryAsPARCMemory);
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_RUNNER_TEARDOWN(test_ccnx_PortalFileStore)
+{
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+static char testDirectory[64];
+static char testFile[128];
+static char testEmptyFile[128];
+
+/*
+ * Write a file of the given length whose byte at offset i is (i & 0xFF).
+ */
+static void
+_writeFile(const char *path, size_t length)
+{
+    FILE *file = fopen(path, "w");
+    assertNotNull(file, "Expected to create %s", path);
+    for (size_t i = 0; i < length; i++) {
+        fputc((int) (i & 0xFF), file);
+    }
+    fclose(file);
+}
+
+/*
+ * Create the name of the given segment under lci:/files.
+ */
+static CCNxName *
+_createSegmentName(const char *path, uint64_t chunkNumber)
+{
+    char uri[128];
+    sprintf(uri, "lci:/files/%s", path);
+    CCNxName *result = ccnxName_CreateFromCString(uri);
+
+    CCNxNameSegment *chunk = ccnxNameSegmentNumber_Create(CCNxNameLabelType_CHUNK, chunkNumber);
+    ccnxName_Append(result, chunk);
+    ccnxNameSegment_Release(&chunk);
+
+    return result;
+}
+
+static CCNxPortalFileStore *
+_createStore(size_t segmentSize, size_t cacheCapacity)
+{
+    CCNxName *prefix = ccnxName_CreateFromCString("lci:/files");
+    CCNxPortalFileStore *result = ccnxPortalFileStore_Create(testDirectory, prefix, segmentSize, cacheCapacity);
+    ccnxName_Release(&prefix);
+
+    return result;
+}
+
+LONGBOW_TEST_FIXTURE(Global)
+{
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortalFileStore_CreateAcquireRelease);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortalFileStore_Create_NotADirectory);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortalFileStore_GetSegment);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortalFileStore_GetSegment_EmptyFile);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortalFileStore_GetSegment_Rejected);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortalFileStore_GetSegment_Cache);
+}
+
+static size_t InitialMemoryOutstanding = 0;
+
+LONGBOW_TEST_FIXTURE_SETUP(Global)
+{
+    strcpy(testDirectory, "/tmp/test_ccnx_PortalFileStore.XXXXXX");
+    assertNotNull(mkdtemp(testDirectory), "Expected mkdtemp to succeed");
+
+    sprintf(testFile, "%s/ten", testDirectory);
+    _writeFile(testFile, 10);
+    sprintf(testEmptyFile, "%s/empty", testDirectory);
+    _writeFile(testEmptyFile, 0);
+
+    InitialMemoryOutstanding = parcMemory_Outstanding();
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_FIXTURE_TEARDOWN(Global)
+{
+    unlink(testFile);
+    unlink(testEmptyFile);
+    rmdir(testDirectory);
+
+    if (parcMemory_Outstanding() != InitialMemoryOutstanding) {
+        parcSafeMemory_ReportAllocation(STDOUT_FILENO);
+        printf("('%s' leaks memory by %zd\n",
+               longBowTestCase_GetName(testCase), parcMemory_Outstanding() - InitialMemoryOutstanding);
+        return LONGBOW_STATUS_MEMORYLEAK;
+    }
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortalFileStore_CreateAcquireRelease)
+{
+    CCNxPortalFileStore *store = _createStore(4, 10);
+    assertNotNull(store, "Expected a non-null store");
+    assertTrue(ccnxPortalFileStore_GetSegmentSize(store) == 4, "Expected the segment size 4");
+    assertTrue(ccnxPortalFileStore_GetCachedCount(store) == 0, "Expected an empty cache");
+
+    parcObjectTesting_AssertAcquireReleaseContract(ccnxPortalFileStore_Acquire, store);
+
+    ccnxPortalFileStore_Release(&store);
+    assertNull(store, "Expected ccnxPortalFileStore_Release to null the pointer");
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortalFileStore_Create_NotADirectory)
+{
+    CCNxName *prefix = ccnxName_CreateFromCString("lci:/files");
+
+    CCNxPortalFileStore *store = ccnxPortalFileStore_Create(testFile, prefix, 4, 10);
+    assertNull(store, "Expected NULL for a path that is not a directory");
+    assertTrue(errno == ENOTDIR, "Expected ENOTDIR, actual %d", errno);
+
+    store = ccnxPortalFileStore_Create(testDirectory, prefix, 0, 10);
+    assertNull(store, "Expected NULL for a zero segment size");
+    assertTrue(errno == EINVAL, "Expected EINVAL, actual %d", errno);
+
+    ccnxName_Release(&prefix);
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortalFileStore_GetSegment)
+{
+    CCNxPortalFileStore *store = _createStore(4, 10);
+
+    size_t expectedLength[] = { 4, 4, 2 };
+    for (uint64_t chunkNumber = 0; chunkNumber < 3; chunkNumber++) {
+        CCNxName *name = _createSegmentName("ten", chunkNumber);
+        CCNxContentObject *contentObject = ccnxPortalFileStore_GetSegment(store, name);
+        assertNotNull(contentObject, "Expected segment %" PRIu64, chunkNumber);
+
+        assertTrue(ccnxName_Equals(ccnxContentObject_GetName(contentObject), name), "Expected the segment to have the requested name");
+        assertTrue(ccnxContentObject_GetFinalChunkNumber(contentObject) == 2, "Expected the final chunk number 2");
+
+        PARCBuffer *payload = ccnxContentObject_GetPayload(contentObject);
+        assertTrue(parcBuffer_Remaining(payload) == expectedLength[chunkNumber],
+                   "Expected %zu bytes in segment %" PRIu64 ", actual %zu",
+                   expectedLength[chunkNumber], chunkNumber, parcBuffer_Remaining(payload));
+        for (size_t i = 0; i < expectedLength[chunkNumber]; i++) {
+            assertTrue(parcBuffer_GetAtIndex(payload, parcBuffer_Position(payload) + i) == chunkNumber * 4 + i,
+                       "Expected the file data at offset %" PRIu64, chunkNumber * 4 + i);
+        }
+
+        ccnxContentObject_Release(&contentObject);
+        ccnxName_Release(&name);
+    }
+
+    CCNxName *name = _createSegmentName("ten", 3);
+    assertNull(ccnxPortalFileStore_GetSegment(store, name), "Expected no segment past the end of the file");
+    ccnxName_Release(&name);
+
+    ccnxPortalFileStore_Release(&store);
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortalFileStore_GetSegment_EmptyFile)
+{
+    CCNxPortalFileStore *store = _createStore(4, 10);
+
+    CCNxName *name = _createSegmentName("empty", 0);
+    CCNxContentObject *contentObject = ccnxPortalFileStore_GetSegment(store, name);
+    assertNotNull(contentObject, "Expected a single segment for an empty file");
+    assertTrue(parcBuffer_Remaining(ccnxContentObject_GetPayload(contentObject)) == 0, "Expected an empty payload");
+    assertTrue(ccnxContentObject_GetFinalChunkNumber(contentObject) == 0, "Expected the final chunk number 0");
+    ccnxContentObject_Release(&contentObject);
+    ccnxName_Release(&name);
+
+    name = _createSegmentName("empty", 1);
+    assertNull(ccnxPortalFileStore_GetSegment(store, name), "Expected no second segment for an empty file");
+    ccnxName_Release(&name);
+
+    ccnxPortalFileStore_Release(&store);
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortalFileStore_GetSegment_Rejected)
+{
+    CCNxPortalFileStore *store = _createStore(4, 10);
+
+    const char *rejected[] = { "missing", "..", ".", "ten/extra" };
+    for (size_t i = 0; i < sizeof(rejected) / sizeof(rejected[0]); i++) {
+        CCNxName *name = _createSegmentName(rejected[i], 0);
+        assertNull(ccnxPortalFileStore_GetSegment(store, name), "Expected no segment for '%s'", rejected[i]);
+        ccnxName_Release(&name);
+    }
+
+    CCNxName *name = ccnxName_CreateFromCString("lci:/files/ten");
+    assertNull(ccnxPortalFileStore_GetSegment(store, name), "Expected no segment for a name without a chunk number");
+    ccnxName_Release(&name);
+
+    name = ccnxName_CreateFromCString("lci:/other/ten");
+    CCNxNameSegment *chunk = ccnxNameSegmentNumber_Create(CCNxNameLabelType_CHUNK, 0);
+    ccnxName_Append(name, chunk);
+    ccnxNameSegment_Release(&chunk);
+    assertNull(ccnxPortalFileStore_GetSegment(store, name), "Expected no segment for a name outside the prefix");
+    ccnxName_Release(&name);
+
+    ccnxPortalFileStore_Release(&store);
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortalFileStore_GetSegment_Cache)
+{
+    CCNxPortalFileStore *store = _createStore(4, 2);
+
+    CCNxName *first = _createSegmentName("ten", 0);
+    CCNxContentObject *original = ccnxPortalFileStore_GetSegment(store, first);
+    CCNxContentObject *again = ccnxPortalFileStore_GetSegment(store, first);
+    assertTrue(original == again, "Expected the cached instance to be returned");
+    ccnxContentObject_Release(&again);
+
+    for (uint64_t chunkNumber = 1; chunkNumber < 3; chunkNumber++) {
+        CCNxName *name = _createSegmentName("ten", chunkNumber);
+        CCNxContentObject *contentObject = ccnxPortalFileStore_GetSegment(store, name);
+        ccnxContentObject_Release(&contentObject);
+        ccnxName_Release(&name);
+    }
+    assertTrue(ccnxPortalFileStore_GetCachedCount(store) == 2, "Expected the cache to hold at most 2 segments");
+
+    again = ccnxPortalFileStore_GetSegment(store, first);
+    assertFalse(original == again, "Expected the oldest segment to have been evicted");
+    assertTrue(parcBuffer_Equals(ccnxContentObject_GetPayload(original), ccnxContentObject_GetPayload(again)),
+               "Expected a rebuilt segment to have the same payload");
+    ccnxContentObject_Release(&again);
+
+    ccnxContentObject_Release(&original);
+    ccnxName_Release(&first);
+    ccnxPortalFileStore_Release(&store);
+}
+
+LONGBOW_TEST_FIXTURE_OPTIONS(Performance, .enabled = false)
+{
+    LONGBOW_RUN_TEST_CASE(Performance, ccnxPortalFileStore_4GB);
+}
+
+LONGBOW_TEST_FIXTURE_SETUP(Performance)
+{
+    strcpy(testDirectory, "/tmp/test_ccnx_PortalFileStore.XXXXXX");
+    assertNotNull(mkdtemp(testDirectory), "Expected mkdtemp to succeed");
+    sprintf(testFile, "%s/large", testDirectory);
+
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_FIXTURE_TEARDOWN(Performance)
+{
+    unlink(testFile);
+    rmdir(testDirectory);
+
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+/*
+ * Serve every segment of a 4 GiB file, reading every byte of each payload as a sender would.
+ * The file is sparse, so this measures the cost of the store and of the page faults, not of the disk.
+ */
+LONGBOW_TEST_CASE(Performance, ccnxPortalFileStore_4GB)
+{
+    const uint64_t fileLength = UINT64_C(4) << 30;
+    const size_t segmentSize = 8192;
+
+    int fd = open(testFile, O_CREAT | O_WRONLY, 0600);
+    assertTrue(fd >= 0 && ftruncate(fd, (off_t) fileLength) == 0, "Expected to create a %" PRIu64 " byte file", fileLength);
+    close(fd);
+
+    CCNxPortalFileStore *store = _createStore(segmentSize, 1000);
+
+    struct timespec start;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    uint64_t served = 0;
+    uint64_t checksum = 0;
+    for (uint64_t chunkNumber = 0; served < fileLength; chunkNumber++) {
+        CCNxName *name = _createSegmentName("large", chunkNumber);
+        CCNxContentObject *contentObject = ccnxPortalFileStore_GetSegment(store, name);
+        assertNotNull(contentObject, "Expected segment %" PRIu64, chunkNumber);
+
+        PARCBuffer *payload = ccnxContentObject_GetPayload(contentObject);
+        size_t length = parcBuffer_Remaining(payload);
+        const uint64_t *words = parcBuffer_Overlay(payload, 0);
+        for (size_t i = 0; i < length / sizeof(uint64_t); i++) {
+            checksum += words[i];
+        }
+        served += length;
+
+        ccnxContentObject_Release(&contentObject);
+        ccnxName_Release(&name);
+    }
+
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    double seconds = (now.tv_sec - start.tv_sec) + (now.tv_nsec - start.tv_nsec) / 1e9;
+
+    printf("Served %" PRIu64 " bytes in %.3f seconds, %.1f MB/s (checksum %" PRIu64 ")\n",
+           served, seconds, served / seconds / 1e6, checksum);
+
+    ccnxPortalFileStore_Release(&store);
+}
+
+int
+main(int argc, char *argv[argc])
+{
+    LongBowRunner *testRunner = LONGBOW_TEST_RUNNER_CREATE(test_ccnx_PortalFileStore);
+    int exitStatus = longBowMain(argc, argv, testRunner, NULL);
+    longBowTestRunner_Destroy(&testRunner);
+    exit(exitStatus);
+}
@@ -0,0 +1,316 @@
+/*
+ * Copyright (c) 2016, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX OR PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ################################################################################
+ * #
+ * # PATENT NOTICE
+ * #
+ * # This software is distributed under the BSD 2-clause License (see LICENSE
+ * # file).  This BSD License does not make any patent claims and as such, does
+ * # not act as a patent grant.  The purpose of this section is for each contributor
+ * # to define their intentions with respect to intellectual property.
+ * #
+ * # Each contributor to this source code is encouraged to state their patent
+ * # claims and licensing mechanisms for any contributions made. At the end of
+ * # this section contributors may each make their own statements.  Contributor's
+ * # claims and grants only apply to the pieces (source code, programs, text,
+ * # media, etc) that they have contributed directly to this software.
+ * #
+ * # There is no guarantee that this section is complete, up to date or accurate. It
+ * # is up to the contributors to maintain their portion of this section and up to
+ * # the user of the software to verify any claims herein.
+ * #
+ * # Do not remove this header notification.  The contents of this section must be
+ * # present in all distributions of the software.  You may only modify your own
+ * # intellectual property statements.  Please provide contact information.
+ *
+ * - Palo Alto Research Center, Inc
+ * This software distribution does not grant any rights to patents owned by Palo
+ * Alto Research Center, Inc (PARC). Rights to these patents are available via
+ * various mechanisms. As of January 2016 PARC has committed to FRAND licensing any
+ * intellectual property used by its contributions to this software. You may
+ * contact PARC at cipo@parc.com for more information or visit http://www.ccnx.org
+ */
+/**
+ * @copyright (c) 2016, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC).  All rights reserved.
+ */
+#include "../ccnx_PortalHistogram.c"
+
+#include <LongBow/unit-test.h>
+#include <LongBow/debugging.h>
+
+#include <stdio.h>
+#include <unistd.h>
+#include <inttypes.h>
+
+#include <parc/algol/parc_Memory.h>
+#include <parc/algol/parc_SafeMemory.h>
+#include <parc/testing/parc_ObjectTesting.h>
+
+LONGBOW_TEST_RUNNER(test_ccnx_PortalHistogram)
+{
+    LONGBOW_RUN_TEST_FIXTURE(Global);
+    LONGBOW_RUN_TEST_FIXTURE(Local);
+}
+
+LONGBOW_TEST_RUNNER_SETUP(test_ccnx_PortalHistogram)
+{
+    parcMemory_SetInterface(&PARCSafeMemoryAsPARCMemory);
+
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_RUNNER_TEARDOWN(test_ccnx_PortalHistogram)
+{
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_FIXTURE(Global)
+{
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortalHistogram_CreateAcquireRelease);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortalHistogram_Empty);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortalHistogram_Record);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortalHistogram_GetValueAtPercentile);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortalHistogram_GetValueAtPercentile_Precision);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortalHistogram_GetStandardDeviation);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortalHistogram_Reset);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortalHistogram_Add);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortalHistogram_ToJSON);
+}
+
+static size_t InitialMemoryOutstanding = 0;
+
+LONGBOW_TEST_FIXTURE_SETUP(Global)
+{
+    InitialMemoryOutstanding = parcMemory_Outstanding();
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_FIXTURE_TEARDOWN(Global)
+{
+    if (parcMemory_Outstanding() != InitialMemoryOutstanding) {
+        parcSafeMemory_ReportAllocation(STDOUT_FILENO);
+        printf("('%s' leaks memory by %zd\n",
+               longBowTestCase_GetName(testCase), parcMemory_Outstanding() - InitialMemoryOutstanding);
+        return LONGBOW_STATUS_MEMORYLEAK;
+    }
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortalHistogram_CreateAcquireRelease)
+{
+    CCNxPortalHistogram *histogram = ccnxPortalHistogram_Create();
+    assertNotNull(histogram, "Expected a non-null histogram");
+
+    parcObjectTesting_AssertAcquireReleaseContract(ccnxPortalHistogram_Acquire, histogram);
+
+    ccnxPortalHistogram_Release(&histogram);
+    assertNull(histogram, "Expected ccnxPortalHistogram_Release to null the pointer");
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortalHistogram_Empty)
+{
+    CCNxPortalHistogram *histogram = ccnxPortalHistogram_Create();
+
+    assertTrue(ccnxPortalHistogram_GetCount(histogram) == 0, "Expected an empty histogram");
+    assertTrue(ccnxPortalHistogram_GetMin(histogram) == 0, "Expected min 0 for an empty histogram");
+    assertTrue(ccnxPortalHistogram_GetMax(histogram) == 0, "Expected max 0 for an empty histogram");
+    assertTrue(ccnxPortalHistogram_GetMean(histogram) == 0.0, "Expected mean 0 for an empty histogram");
+    assertTrue(ccnxPortalHistogram_GetValueAtPercentile(histogram, 99.0) == 0, "Expected p99 0 for an empty histogram");
+
+    ccnxPortalHistogram_Release(&histogram);
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortalHistogram_Record)
+{
+    CCNxPortalHistogram *histogram = ccnxPortalHistogram_Create();
+
+    ccnxPortalHistogram_Record(histogram, 10);
+    ccnxPortalHistogram_Record(histogram, 20);
+    ccnxPortalHistogram_Record(histogram, 30);
+
+    assertTrue(ccnxPortalHistogram_GetCount(histogram) == 3, "Expected 3, actual %" PRIu64, ccnxPortalHistogram_GetCount(histogram));
+    assertTrue(ccnxPortalHistogram_GetMin(histogram) == 10, "Expected 10, actual %" PRIu64, ccnxPortalHistogram_GetMin(histogram));
+    assertTrue(ccnxPortalHistogram_GetMax(histogram) == 30, "Expected 30, actual %" PRIu64, ccnxPortalHistogram_GetMax(histogram));
+    assertTrue(ccnxPortalHistogram_GetMean(histogram) == 20.0, "Expected 20, actual %f", ccnxPortalHistogram_GetMean(histogram));
+
+    ccnxPortalHistogram_Release(&histogram);
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortalHistogram_GetValueAtPercentile)
+{
+    CCNxPortalHistogram *histogram = ccnxPortalHistogram_Create();
+
+    for (uint64_t i = 1; i <= 50; i++) {
+        ccnxPortalHistogram_Record(histogram, i);
+    }
+
+    // Values below 64 are recorded exactly.
+    uint64_t p50 = ccnxPortalHistogram_GetValueAtPercentile(histogram, 50.0);
+    assertTrue(p50 == 25, "Expected 25, actual %" PRIu64, p50);
+    uint64_t p100 = ccnxPortalHistogram_GetValueAtPercentile(histogram, 100.0);
+    assertTrue(p100 == 50, "Expected 50, actual %" PRIu64, p100);
+    uint64_t p0 = ccnxPortalHistogram_GetValueAtPercentile(histogram, 0.0);
+    assertTrue(p0 == 1, "Expected 1, actual %" PRIu64, p0);
+
+    ccnxPortalHistogram_Release(&histogram);
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortalHistogram_GetValueAtPercentile_Precision)
+{
+    CCNxPortalHistogram *histogram = ccnxPortalHistogram_Create();
+
+    uint64_t values[] = { 1000, 123456, 987654321, UINT64_C(1) << 40 };
+    for (size_t i = 0; i < sizeof(values) / sizeof(values[0]); i++) {
+        ccnxPortalHistogram_Reset(histogram);
+        ccnxPortalHistogram_Record(histogram, values[i]);
+        ccnxPortalHistogram_Record(histogram, values[i] * 2);
+
+        // The p50 value is the top of the bucket holding values[i], which is within 1/32 of it.
+        uint64_t p50 = ccnxPortalHistogram_GetValueAtPercentile(histogram, 50.0);
+        assertTrue(p50 >= values[i] && p50 - values[i] <= values[i] / _subBucketCount,
+                   "Expected %" PRIu64 " within 1/%d, actual %" PRIu64, values[i], _subBucketCount, p50);
+    }
+
+    ccnxPortalHistogram_Release(&histogram);
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortalHistogram_GetStandardDeviation)
+{
+    CCNxPortalHistogram *histogram = ccnxPortalHistogram_Create();
+
+    ccnxPortalHistogram_Record(histogram, 2);
+    ccnxPortalHistogram_Record(histogram, 4);
+    ccnxPortalHistogram_Record(histogram, 4);
+    ccnxPortalHistogram_Record(histogram, 4);
+    ccnxPortalHistogram_Record(histogram, 5);
+    ccnxPortalHistogram_Record(histogram, 5);
+    ccnxPortalHistogram_Record(histogram, 7);
+    ccnxPortalHistogram_Record(histogram, 9);
+
+    double stddev = ccnxPortalHistogram_GetStandardDeviation(histogram);
+    assertTrue(stddev == 2.0, "Expected 2.0, actual %f", stddev);
+
+    ccnxPortalHistogram_Release(&histogram);
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortalHistogram_Reset)
+{
+    CCNxPortalHistogram *histogram = ccnxPortalHistogram_Create();
+
+    ccnxPortalHistogram_Record(histogram, 1000000);
+    ccnxPortalHistogram_Reset(histogram);
+
+    assertTrue(ccnxPortalHistogram_GetCount(histogram) == 0, "Expected an empty histogram after reset");
+    assertTrue(ccnxPortalHistogram_GetMax(histogram) == 0, "Expected max 0 after reset");
+    assertTrue(ccnxPortalHistogram_GetValueAtPercentile(histogram, 50.0) == 0, "Expected p50 0 after reset");
+
+    ccnxPortalHistogram_Release(&histogram);
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortalHistogram_Add)
+{
+    CCNxPortalHistogram *histogram = ccnxPortalHistogram_Create();
+    CCNxPortalHistogram *other = ccnxPortalHistogram_Create();
+    CCNxPortalHistogram *empty = ccnxPortalHistogram_Create();
+
+    ccnxPortalHistogram_Record(histogram, 10);
+    ccnxPortalHistogram_Record(histogram, 20);
+    ccnxPortalHistogram_Record(other, 5);
+    ccnxPortalHistogram_Record(other, 45);
+
+    ccnxPortalHistogram_Add(histogram, other);
+    ccnxPortalHistogram_Add(histogram, empty);
+
+    assertTrue(ccnxPortalHistogram_GetCount(histogram) == 4, "Expected 4, actual %" PRIu64, ccnxPortalHistogram_GetCount(histogram));
+    assertTrue(ccnxPortalHistogram_GetMin(histogram) == 5, "Expected 5, actual %" PRIu64, ccnxPortalHistogram_GetMin(histogram));
+    assertTrue(ccnxPortalHistogram_GetMax(histogram) == 45, "Expected 45, actual %" PRIu64, ccnxPortalHistogram_GetMax(histogram));
+    assertTrue(ccnxPortalHistogram_GetMean(histogram) == 20.0, "Expected 20, actual %f", ccnxPortalHistogram_GetMean(histogram));
+    uint64_t p50 = ccnxPortalHistogram_GetValueAtPercentile(histogram, 50.0);
+    assertTrue(p50 == 10, "Expected 10, actual %" PRIu64, p50);
+    assertTrue(ccnxPortalHistogram_GetCount(other) == 2, "Expected the other histogram to be unchanged");
+
+    ccnxPortalHistogram_Release(&empty);
+    ccnxPortalHistogram_Release(&other);
+    ccnxPortalHistogram_Release(&histogram);
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortalHistogram_ToJSON)
+{
+    CCNxPortalHistogram *histogram = ccnxPortalHistogram_Create();
+    ccnxPortalHistogram_Record(histogram, 42);
+
+    PARCJSON *json = ccnxPortalHistogram_ToJSON(histogram);
+    assertNotNull(json, "Expected a JSON representation");
+
+    const PARCJSONValue *count = parcJSON_GetValueByName(json, "count");
+    assertNotNull(count, "Expected a count member");
+    assertTrue(parcJSONValue_GetInteger(count) == 1, "Expected count 1");
+
+    const PARCJSONValue *p999 = parcJSON_GetValueByName(json, "p999");
+    assertNotNull(p999, "Expected a p999 member");
+    assertTrue(parcJSONValue_GetInteger(p999) == 42, "Expected p999 42");
+
+    parcJSON_Release(&json);
+    ccnxPortalHistogram_Release(&histogram);
+}
+
+LONGBOW_TEST_FIXTURE(Local)
+{
+    LONGBOW_RUN_TEST_CASE(Local, _ccnxPortalHistogram_Index);
+}
+
+LONGBOW_TEST_FIXTURE_SETUP(Local)
+{
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_FIXTURE_TEARDOWN(Local)
+{
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_CASE(Local, _ccnxPortalHistogram_Index)
+{
+    assertTrue(_ccnxPortalHistogram_Index(UINT64_MAX) == _bucketCount - 1, "Expected the largest value in the last bucket");
+
+    for (size_t index = 0; index < _bucketCount; index++) {
+        uint64_t low = _ccnxPortalHistogram_LowestEquivalentValue(index);
+        uint64_t high = _ccnxPortalHistogram_HighestEquivalentValue(index);
+        assertTrue(_ccnxPortalHistogram_Index(low) == index, "Expected the lowest value of bucket %zu in that bucket", index);
+        assertTrue(_ccnxPortalHistogram_Index(high) == index, "Expected the highest value of bucket %zu in that bucket", index);
+        if (index + 1 < _bucketCount) {
+            assertTrue(_ccnxPortalHistogram_LowestEquivalentValue(index + 1) == high + 1, "Expected no gap after bucket %zu", index);
+        }
+    }
+}
+
+int
+main(int argc, char *argv[argc])
+{
+    LongBowRunner *testRunner = LONGBOW_TEST_RUNNER_CREATE(test_ccnx_PortalHistogram);
+    int exitStatus = longBowMain(argc, argv, testRunner, NULL);
+    longBowTestRunner_Destroy(&testRunner);
+    exit(exitStatus);
+}
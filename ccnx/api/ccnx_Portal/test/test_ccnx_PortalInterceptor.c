@@ -0,0 +1,329 @@
+/*
+ * Copyright (c) 2016, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX OR PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ################################################################################
+ * #
+ * # PATENT NOTICE
+ * #
+ * # This software is distributed under the BSD 2-clause License (see LICENSE
+ * # file).  This BSD License does not make any patent claims and as such, does
+ * # not act as a patent grant.  The purpose of this section is for each contributor
+ * # to define their intentions with respect to intellectual property.
+ * #
+ * # Each contributor to this source code is encouraged to state their patent
+ * # claims and licensing mechanisms for any contributions made. At the end of
+ * # this section contributors may each make their own statements.  Contributor's
+ * # claims and grants only apply to the pieces (source code, programs, text,
+ * # media, etc) that they have contributed directly to this software.
+ * #
+ * # There is no guarantee that this section is complete, up to date or accurate. It
+ * # is up to the contributors to maintain their portion of this section and up to
+ * # the user of the software to verify any claims herein.
+ * #
+ * # Do not remove this header notification.  The contents of this section must be
+ * # present in all distributions of the software.  You may only modify your own
+ * # intellectual property statements.  Please provide contact information.
+ *
+ * - Palo Alto Research Center, Inc
+ * This software distribution does not grant any rights to patents owned by Palo
+ * Alto Research Center, Inc (PARC). Rights to these patents are available via
+ * various mechanisms. As of January 2016 PARC has committed to FRAND licensing any
+ * intellectual property used by its contributions to this software. You may
+ * contact PARC at cipo@parc.com for more information or visit http://www.ccnx.org
+ */
+/**
+ * @copyright (c) 2016, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC).  All rights reserved.
+ */
+#include "../ccnx_PortalInterceptor.c"
+
+#include <LongBow/unit-test.h>
+#include <LongBow/debugging.h>
+
+#include <stdio.h>
+#include <unistd.h>
+
+#include <parc/algol/parc_Memory.h>
+#include <parc/algol/parc_SafeMemory.h>
+#include <parc/testing/parc_ObjectTesting.h>
+
+#include <ccnx/common/ccnx_Interest.h>
+
+LONGBOW_TEST_RUNNER(test_ccnx_PortalInterceptor)
+{
+    LONGBOW_RUN_TEST_FIXTURE(Global);
+}
+
+LONGBOW_TEST_RUNNER_SETUP(test_ccnx_PortalInterceptor)
+{
+    parcMemory_SetInterface(&PARCSafeMemoryAsPARCMemory);
+
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_RUNNER_TEARDOWN(test_ccnx_PortalInterceptor)
+{
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_FIXTURE(Global)
+{
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortalInterceptor_CreateAcquireRelease);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortalInterceptor_Link);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortalInterceptor_Send);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortalInterceptor_Receive);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortalInterceptor_ListenIgnore);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortalInterceptor_PassThrough);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortalInterceptor_ReleaseState);
+}
+
+static size_t InitialMemoryOutstanding = 0;
+
+LONGBOW_TEST_FIXTURE_SETUP(Global)
+{
+    InitialMemoryOutstanding = parcMemory_Outstanding();
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_FIXTURE_TEARDOWN(Global)
+{
+    if (parcMemory_Outstanding() != InitialMemoryOutstanding) {
+        parcSafeMemory_ReportAllocation(STDOUT_FILENO);
+        printf("('%s' leaks memory by %zd\n",
+               longBowTestCase_GetName(testCase), parcMemory_Outstanding() - InitialMemoryOutstanding);
+        return LONGBOW_STATUS_MEMORYLEAK;
+    }
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+/*
+ * Each layer appends its tag to a shared trail, so the tests can check the order in which layers were called.
+ */
+typedef struct {
+    char tag;
+    char *trail;
+} _Layer;
+
+static void
+_mark(const _Layer *layer)
+{
+    size_t length = strlen(layer->trail);
+    layer->trail[length] = layer->tag;
+    layer->trail[length + 1] = 0;
+}
+
+static bool
+_layerSend(void *state, const CCNxPortalInterceptor *next, const CCNxMetaMessage *message, const CCNxStackTimeout *microSeconds)
+{
+    _mark(state);
+    return (next == NULL) ? true : ccnxPortalInterceptor_Send(next, message, microSeconds);
+}
+
+static CCNxMetaMessage *
+_layerReceive(void *state, const CCNxPortalInterceptor *next, const CCNxStackTimeout *microSeconds)
+{
+    _mark(state);
+    if (next == NULL) {
+        CCNxName *name = ccnxName_CreateFromCString("lci:/interceptor");
+        CCNxInterest *interest = ccnxInterest_CreateSimple(name);
+        CCNxMetaMessage *result = ccnxMetaMessage_CreateFromInterest(interest);
+        ccnxInterest_Release(&interest);
+        ccnxName_Release(&name);
+        return result;
+    }
+    return ccnxPortalInterceptor_Receive(next, microSeconds);
+}
+
+static bool
+_layerListen(void *state, const CCNxPortalInterceptor *next, const CCNxName *name, const CCNxStackTimeout *microSeconds)
+{
+    _mark(state);
+    return (next == NULL) ? true : ccnxPortalInterceptor_Listen(next, name, microSeconds);
+}
+
+static bool
+_layerIgnore(void *state, const CCNxPortalInterceptor *next, const CCNxName *name, const CCNxStackTimeout *microSeconds)
+{
+    _mark(state);
+    return (next == NULL) ? true : ccnxPortalInterceptor_Ignore(next, name, microSeconds);
+}
+
+static CCNxPortalInterceptor *
+_createLayer(_Layer *layer, const CCNxPortalInterceptor *next)
+{
+    CCNxPortalInterceptor *result = ccnxPortalInterceptor_Create(_layerSend, _layerReceive, _layerListen, _layerIgnore, layer, NULL);
+    ccnxPortalInterceptor_Link(result, next);
+    return result;
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortalInterceptor_CreateAcquireRelease)
+{
+    CCNxPortalInterceptor *interceptor = ccnxPortalInterceptor_Create(NULL, NULL, NULL, NULL, NULL, NULL);
+    assertNotNull(interceptor, "Expected ccnxPortalInterceptor_Create to return non-NULL.");
+
+    parcObjectTesting_AssertAcquireReleaseContract(ccnxPortalInterceptor_Acquire, interceptor);
+
+    ccnxPortalInterceptor_Release(&interceptor);
+    assertNull(interceptor, "Expected ccnxPortalInterceptor_Release to NULL the pointer.");
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortalInterceptor_Link)
+{
+    char trail[8] = "";
+    _Layer bottom = { .tag = 'b', .trail = trail };
+
+    CCNxPortalInterceptor *implementation = _createLayer(&bottom, NULL);
+    CCNxPortalInterceptor *interceptor = ccnxPortalInterceptor_Create(NULL, NULL, NULL, NULL, NULL, NULL);
+
+    assertTrue(ccnxPortalInterceptor_Link(interceptor, implementation), "Expected the first Link to succeed.");
+    assertFalse(ccnxPortalInterceptor_Link(interceptor, implementation), "Expected a second Link to fail.");
+
+    ccnxPortalInterceptor_Release(&interceptor);
+    ccnxPortalInterceptor_Release(&implementation);
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortalInterceptor_Send)
+{
+    char trail[8] = "";
+    _Layer bottom = { .tag = 'b', .trail = trail };
+    _Layer middle = { .tag = 'm', .trail = trail };
+    _Layer top = { .tag = 't', .trail = trail };
+
+    CCNxPortalInterceptor *b = _createLayer(&bottom, NULL);
+    CCNxPortalInterceptor *m = _createLayer(&middle, b);
+    CCNxPortalInterceptor *t = _createLayer(&top, m);
+    ccnxPortalInterceptor_Release(&b);
+    ccnxPortalInterceptor_Release(&m);
+
+    CCNxName *name = ccnxName_CreateFromCString("lci:/interceptor");
+    CCNxInterest *interest = ccnxInterest_CreateSimple(name);
+    CCNxMetaMessage *message = ccnxMetaMessage_CreateFromInterest(interest);
+
+    assertTrue(ccnxPortalInterceptor_Send(t, message, CCNxStackTimeout_Never), "Expected Send to succeed.");
+    assertTrue(strcmp(trail, "tmb") == 0, "Expected the layers to be called top down, actual '%s'", trail);
+
+    ccnxMetaMessage_Release(&message);
+    ccnxInterest_Release(&interest);
+    ccnxName_Release(&name);
+    ccnxPortalInterceptor_Release(&t);
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortalInterceptor_Receive)
+{
+    char trail[8] = "";
+    _Layer bottom = { .tag = 'b', .trail = trail };
+    _Layer top = { .tag = 't', .trail = trail };
+
+    CCNxPortalInterceptor *b = _createLayer(&bottom, NULL);
+    CCNxPortalInterceptor *t = _createLayer(&top, b);
+    ccnxPortalInterceptor_Release(&b);
+
+    CCNxMetaMessage *message = ccnxPortalInterceptor_Receive(t, CCNxStackTimeout_Never);
+    assertNotNull(message, "Expected the bottom layer's message.");
+    assertTrue(strcmp(trail, "tb") == 0, "Expected the layers to be called top down, actual '%s'", trail);
+
+    ccnxMetaMessage_Release(&message);
+    ccnxPortalInterceptor_Release(&t);
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortalInterceptor_ListenIgnore)
+{
+    char trail[8] = "";
+    _Layer bottom = { .tag = 'b', .trail = trail };
+    _Layer top = { .tag = 't', .trail = trail };
+
+    CCNxPortalInterceptor *b = _createLayer(&bottom, NULL);
+    CCNxPortalInterceptor *t = _createLayer(&top, b);
+    ccnxPortalInterceptor_Release(&b);
+
+    CCNxName *name = ccnxName_CreateFromCString("lci:/interceptor");
+    assertTrue(ccnxPortalInterceptor_Listen(t, name, CCNxStackTimeout_Never), "Expected Listen to succeed.");
+    assertTrue(ccnxPortalInterceptor_Ignore(t, name, CCNxStackTimeout_Never), "Expected Ignore to succeed.");
+    assertTrue(strcmp(trail, "tbtb") == 0, "Expected the layers to be called top down, actual '%s'", trail);
+    ccnxName_Release(&name);
+
+    ccnxPortalInterceptor_Release(&t);
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortalInterceptor_PassThrough)
+{
+    char trail[8] = "";
+    _Layer bottom = { .tag = 'b', .trail = trail };
+    _Layer top = { .tag = 't', .trail = trail };
+
+    CCNxPortalInterceptor *b = _createLayer(&bottom, NULL);
+
+    CCNxPortalInterceptor *passThrough = ccnxPortalInterceptor_Create(NULL, NULL, NULL, NULL, NULL, NULL);
+    ccnxPortalInterceptor_Link(passThrough, b);
+
+    CCNxPortalInterceptor *t = ccnxPortalInterceptor_Create(NULL, _layerReceive, NULL, NULL, &top, NULL);
+    ccnxPortalInterceptor_Link(t, passThrough);
+
+    ccnxPortalInterceptor_Release(&b);
+    ccnxPortalInterceptor_Release(&passThrough);
+
+    CCNxName *name = ccnxName_CreateFromCString("lci:/interceptor");
+    ccnxPortalInterceptor_Listen(t, name, CCNxStackTimeout_Never);
+    ccnxName_Release(&name);
+    assertTrue(strcmp(trail, "b") == 0, "Expected NULL operations to pass through, actual '%s'", trail);
+
+    CCNxMetaMessage *message = ccnxPortalInterceptor_Receive(t, CCNxStackTimeout_Never);
+    assertTrue(strcmp(trail, "btb") == 0, "Expected the top receive to be called, actual '%s'", trail);
+    ccnxMetaMessage_Release(&message);
+
+    ccnxPortalInterceptor_Release(&t);
+}
+
+static unsigned int _releaseStateCount;
+
+static void
+_releaseState(void **statePtr)
+{
+    _releaseStateCount++;
+    *statePtr = NULL;
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortalInterceptor_ReleaseState)
+{
+    _releaseStateCount = 0;
+
+    CCNxPortalInterceptor *b = ccnxPortalInterceptor_Create(NULL, NULL, NULL, NULL, &_releaseStateCount, _releaseState);
+    ccnxPortalInterceptor_Link(b, NULL);
+    CCNxPortalInterceptor *t = ccnxPortalInterceptor_Create(NULL, NULL, NULL, NULL, &_releaseStateCount, _releaseState);
+    ccnxPortalInterceptor_Link(t, b);
+    ccnxPortalInterceptor_Release(&b);
+
+    assertTrue(_releaseStateCount == 0, "Expected no state released while the chain is referenced.");
+
+    ccnxPortalInterceptor_Release(&t);
+    assertTrue(_releaseStateCount == 2, "Expected each layer's state to be released, actual %u", _releaseStateCount);
+}
+
+int
+main(int argc, char *argv[argc])
+{
+    LongBowRunner *testRunner = LONGBOW_TEST_RUNNER_CREATE(test_ccnx_PortalInterceptor);
+    int exitStatus = longBowMain(argc, argv, testRunner, NULL);
+    longBowTestRunner_Destroy(&testRunner);
+    exit(exitStatus);
+}
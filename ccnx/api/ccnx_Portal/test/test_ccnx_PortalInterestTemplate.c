@@ -0,0 +1,273 @@
+/*
+ * Copyright (c) 2016, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX OR PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ################################################################################
+ * #
+ * # PATENT NOTICE
+ * #
+ * # This software is distributed under the BSD 2-clause License (see LICENSE
+ * # file).  This BSD License does not make any patent claims and as such, does
+ * # not act as a patent grant.  The purpose of this section is for each contributor
+ * # to define their intentions with respect to intellectual property.
+ * #
+ * # Each contributor to this source code is encouraged to state their patent
+ * # claims and licensing mechanisms for any contributions made. At the end of
+ * # this section contributors may each make their own statements.  Contributor's
+ * # claims and grants only apply to the pieces (source code, programs, text,
+ * # media, etc) that they have contributed directly to this software.
+ * #
+ * # There is no guarantee that this section is complete, up to date or accurate. It
+ * # is up to the contributors to maintain their portion of this section and up to
+ * # the user of the software to verify any claims herein.
+ * #
+ * # Do not remove this header notification.  The contents of this section must be
+ * # present in all distributions of the software.  You may only modify your own
+ * # intellectual property statements.  Please provide contact information.
+ *
+ * - Palo Alto Research Center, Inc
+ * This software distribution does not grant any rights to patents owned by Palo
+ * Alto Research Center, Inc (PARC). Rights to these patents are available via
+ * various mechanisms. As of January 2016 PARC has committed to FRAND licensing any
+ * intellectual property used by its contributions to this software. You may
+ * contact PARC at cipo@parc.com for more information or visit http://www.ccnx.org
+ */
+/**
+ * @copyright (c) 2016, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC).  All rights reserved.
+ */
+#include "../ccnx_PortalInterestTemplate.c"
+
+#include <LongBow/unit-test.h>
+#include <LongBow/debugging.h>
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <parc/algol/parc_Memory.h>
+#include <parc/algol/parc_SafeMemory.h>
+#include <parc/testing/parc_ObjectTesting.h>
+
+#include <ccnx/common/ccnx_NameSegmentNumber.h>
+
+LONGBOW_TEST_RUNNER(test_ccnx_PortalInterestTemplate)
+{
+    LONGBOW_RUN_TEST_FIXTURE(Global);
+}
+
+LONGBOW_TEST_RUNNER_SETUP(test_ccnx_PortalInterestTemplate)
+{
+    parcMemory_SetInterface(&PARCSafeMemoryAsPARCMemory);
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_RUNNER_TEARDOWN(test_ccnx_PortalInterestTemplate)
+{
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_FIXTURE(Global)
+{
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortalInterestTemplate_CreateAcquireRelease);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortalInterestTemplate_Create_NoSegments);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortalInterestTemplate_CreateMessageWithNumber);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortalInterestTemplate_CreateMessageWithNumber_Decoded);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortalInterestTemplate_CreateMessage);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortalInterestTemplate_CreateMessage_TooLong);
+}
+
+static size_t InitialMemoryOutstanding = 0;
+
+LONGBOW_TEST_FIXTURE_SETUP(Global)
+{
+    InitialMemoryOutstanding = parcMemory_Outstanding();
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_FIXTURE_TEARDOWN(Global)
+{
+    if (parcMemory_Outstanding() != InitialMemoryOutstanding) {
+        parcSafeMemory_ReportAllocation(STDOUT_FILENO);
+        printf("('%s' leaks memory by %zd\n",
+               longBowTestCase_GetName(testCase), parcMemory_Outstanding() - InitialMemoryOutstanding);
+        return LONGBOW_STATUS_MEMORYLEAK;
+    }
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+static CCNxName *
+_createChunkName(uint64_t chunk)
+{
+    CCNxName *result = ccnxName_CreateFromCString("lci:/ccnx/template/test");
+    CCNxNameSegment *segment = ccnxNameSegmentNumber_Create(CCNxNameLabelType_CHUNK, chunk);
+    ccnxName_Append(result, segment);
+    ccnxNameSegment_Release(&segment);
+
+    return result;
+}
+
+static CCNxInterest *
+_createChunkInterest(uint64_t chunk)
+{
+    CCNxName *name = _createChunkName(chunk);
+    CCNxInterest *result = ccnxInterest_CreateSimple(name);
+    ccnxName_Release(&name);
+
+    return result;
+}
+
+/*
+ * The wire format the stack would produce for the Interest for the given chunk.
+ */
+static PARCBuffer *
+_encodeChunkInterest(uint64_t chunk)
+{
+    CCNxInterest *interest = _createChunkInterest(chunk);
+    CCNxMetaMessage *message = ccnxMetaMessage_CreateFromInterest(interest);
+    PARCBuffer *result = ccnxMetaMessage_CreateWireFormatBuffer(message, NULL);
+    ccnxMetaMessage_Release(&message);
+    ccnxInterest_Release(&interest);
+
+    return result;
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortalInterestTemplate_CreateAcquireRelease)
+{
+    CCNxInterest *interest = _createChunkInterest(0);
+    CCNxPortalInterestTemplate *template = ccnxPortalInterestTemplate_Create(interest);
+    assertNotNull(template, "Expected a non-null template");
+
+    PARCBuffer *expected = _encodeChunkInterest(0);
+    assertTrue(ccnxPortalInterestTemplate_GetLength(template) == parcBuffer_Remaining(expected),
+               "Expected the length of the encoded Interest, actual %zu", ccnxPortalInterestTemplate_GetLength(template));
+    parcBuffer_Release(&expected);
+
+    parcObjectTesting_AssertAcquireReleaseContract(ccnxPortalInterestTemplate_Acquire, template);
+
+    ccnxPortalInterestTemplate_Release(&template);
+    assertNull(template, "Expected ccnxPortalInterestTemplate_Release to null the pointer");
+    ccnxInterest_Release(&interest);
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortalInterestTemplate_Create_NoSegments)
+{
+    CCNxName *name = ccnxName_CreateFromCString("lci:/");
+    CCNxInterest *interest = ccnxInterest_CreateSimple(name);
+
+    CCNxPortalInterestTemplate *template = ccnxPortalInterestTemplate_Create(interest);
+    assertNull(template, "Expected NULL for a name without segments");
+    assertTrue(errno == EINVAL, "Expected EINVAL, actual %d", errno);
+
+    ccnxInterest_Release(&interest);
+    ccnxName_Release(&name);
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortalInterestTemplate_CreateMessageWithNumber)
+{
+    CCNxInterest *interest = _createChunkInterest(1);
+    CCNxPortalInterestTemplate *template = ccnxPortalInterestTemplate_Create(interest);
+
+    // Values shorter, the same length as, and longer than the template's.
+    uint64_t chunks[] = { 0, 7, 300, 1ULL << 40, UINT64_MAX };
+    for (size_t i = 0; i < sizeof(chunks) / sizeof(chunks[0]); i++) {
+        CCNxMetaMessage *message = ccnxPortalInterestTemplate_CreateMessageWithNumber(template, chunks[i]);
+        PARCBuffer *expected = _encodeChunkInterest(chunks[i]);
+
+        assertTrue(parcBuffer_Equals(ccnxWireFormatMessage_GetWireFormatBuffer(message), expected),
+                   "Expected the encoding of a newly created Interest for chunk %" PRIu64, chunks[i]);
+
+        parcBuffer_Release(&expected);
+        ccnxMetaMessage_Release(&message);
+    }
+
+    ccnxPortalInterestTemplate_Release(&template);
+    ccnxInterest_Release(&interest);
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortalInterestTemplate_CreateMessageWithNumber_Decoded)
+{
+    CCNxInterest *interest = _createChunkInterest(0);
+    CCNxPortalInterestTemplate *template = ccnxPortalInterestTemplate_Create(interest);
+
+    CCNxMetaMessage *message = ccnxPortalInterestTemplate_CreateMessageWithNumber(template, 123456);
+    assertTrue(ccnxMetaMessage_IsInterest(message), "Expected an Interest");
+
+    CCNxMetaMessage *decoded = ccnxMetaMessage_CreateFromWireFormatBuffer(ccnxWireFormatMessage_GetWireFormatBuffer(message));
+    CCNxName *expected = _createChunkName(123456);
+    assertTrue(ccnxName_Equals(expected, ccnxInterest_GetName(ccnxMetaMessage_GetInterest(decoded))),
+               "Expected the final name segment to be replaced");
+
+    ccnxName_Release(&expected);
+    ccnxMetaMessage_Release(&decoded);
+    ccnxMetaMessage_Release(&message);
+    ccnxPortalInterestTemplate_Release(&template);
+    ccnxInterest_Release(&interest);
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortalInterestTemplate_CreateMessage)
+{
+    CCNxName *name = ccnxName_CreateFromCString("lci:/ccnx/template/a");
+    CCNxInterest *interest = ccnxInterest_CreateSimple(name);
+    CCNxPortalInterestTemplate *template = ccnxPortalInterestTemplate_Create(interest);
+
+    CCNxMetaMessage *message = ccnxPortalInterestTemplate_CreateMessage(template, (const uint8_t *) "bcd", 3);
+    CCNxMetaMessage *decoded = ccnxMetaMessage_CreateFromWireFormatBuffer(ccnxWireFormatMessage_GetWireFormatBuffer(message));
+
+    CCNxName *expected = ccnxName_CreateFromCString("lci:/ccnx/template/bcd");
+    assertTrue(ccnxName_Equals(expected, ccnxInterest_GetName(ccnxMetaMessage_GetInterest(decoded))),
+               "Expected the final name segment to be replaced");
+
+    ccnxName_Release(&expected);
+    ccnxMetaMessage_Release(&decoded);
+    ccnxMetaMessage_Release(&message);
+    ccnxPortalInterestTemplate_Release(&template);
+    ccnxInterest_Release(&interest);
+    ccnxName_Release(&name);
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortalInterestTemplate_CreateMessage_TooLong)
+{
+    CCNxInterest *interest = _createChunkInterest(0);
+    CCNxPortalInterestTemplate *template = ccnxPortalInterestTemplate_Create(interest);
+
+    size_t length = UINT16_MAX;
+    uint8_t *value = parcMemory_AllocateAndClear(length);
+
+    CCNxMetaMessage *message = ccnxPortalInterestTemplate_CreateMessage(template, value, length);
+    assertNull(message, "Expected NULL for a packet longer than the largest packet length");
+    assertTrue(errno == EINVAL, "Expected EINVAL, actual %d", errno);
+
+    parcMemory_Deallocate(&value);
+    ccnxPortalInterestTemplate_Release(&template);
+    ccnxInterest_Release(&interest);
+}
+
+int
+main(int argc, char *argv[argc])
+{
+    LongBowRunner *testRunner = LONGBOW_TEST_RUNNER_CREATE(test_ccnx_PortalInterestTemplate);
+    int exitStatus = longBowMain(argc, argv, testRunner, NULL);
+    longBowTestRunner_Destroy(&testRunner);
+    exit(exitStatus);
+}
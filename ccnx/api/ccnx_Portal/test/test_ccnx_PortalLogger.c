@@ -0,0 +1,420 @@
+/*
+ * Copyright (c) 2016, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX OR PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ################################################################################
+ * #
+ * # PATENT NOTICE
+ * #
+ * # This software is distributed under the BSD 2-clause License (see LICENSE
+ * # file).  This BSD License does not make any patent claims and as such, does
+ * # not act as a patent grant.  The purpose of this section is for each contributor
+ * # to define their intentions with respect to intellectual property.
+ * #
+ * # Each contributor to this source code is encouraged to state their patent
+ * # claims and licensing mechanisms for any contributions made. At the end of
+ * # this section contributors may each make their own statements.  Contributor's
+ * # claims and grants only apply to the pieces (source code, programs, text,
+ * # media, etc) that they have contributed directly to this software.
+ * #
+ * # There is no guarantee that this section is complete, up to date or accurate. It
+ * # is up to the contributors to maintain their portion of this section and up to
+ * # the user of the software to verify any claims herein.
+ * #
+ * # Do not remove this header notification.  The contents of this section must be
+ * # present in all distributions of the software.  You may only modify your own
+ * # intellectual property statements.  Please provide contact information.
+ *
+ * - Palo Alto Research Center, Inc
+ * This software distribution does not grant any rights to patents owned by Palo
+ * Alto Research Center, Inc (PARC). Rights to these patents are available via
+ * various mechanisms. As of January 2016 PARC has committed to FRAND licensing any
+ * intellectual property used by its contributions to this software. You may
+ * contact PARC at cipo@parc.com for more information or visit http://www.ccnx.org
+ */
+/**
+ * @copyright (c) 2016, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC).  All rights reserved.
+ */
+#include "../ccnx_PortalLogger.c"
+
+#include <LongBow/unit-test.h>
+#include <LongBow/debugging.h>
+
+#include <stdio.h>
+#include <unistd.h>
+#include <inttypes.h>
+
+#include <parc/algol/parc_Memory.h>
+#include <parc/algol/parc_SafeMemory.h>
+
+LONGBOW_TEST_RUNNER(test_ccnx_PortalLogger)
+{
+    LONGBOW_RUN_TEST_FIXTURE(Global);
+    LONGBOW_RUN_TEST_FIXTURE(Local);
+}
+
+LONGBOW_TEST_RUNNER_SETUP(test_ccnx_PortalLogger)
+{
+    parcMemory_SetInterface(&PARCSafeMemoryAsPARCMemory);
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_RUNNER_TEARDOWN(test_ccnx_PortalLogger)
+{
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+/*
+ * Flush the logger into a temporary file and return what it holds.
+ */
+static char *
+_readLog(FILE *file, char *buffer, size_t length)
+{
+    ccnxPortalLogger_Flush();
+
+    rewind(file);
+    size_t count = fread(buffer, 1, length - 1, file);
+    buffer[count] = 0;
+    return buffer;
+}
+
+static int _evaluations = 0;
+
+static int64_t
+_countEvaluation(void)
+{
+    _evaluations++;
+    return 0;
+}
+
+LONGBOW_TEST_FIXTURE(Global)
+{
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortalLogger_AddCategory);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortalLogger_AddCategory_Full);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortalLogger_RemoveCategory);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortalLogger_RemoveCategory_Default);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortalLogger_SetLevel);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortalLogger_IsLoggable);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortalLogger_Log);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortalLogger_Log_Disabled);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortalLogger_Write_Full);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortalLogger_Write_Unthreaded);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortalLogger_Write_Wakeup);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortalLogger_Thread_Lifetime);
+}
+
+static size_t InitialMemoryOutstanding = 0;
+
+LONGBOW_TEST_FIXTURE_SETUP(Global)
+{
+    InitialMemoryOutstanding = parcMemory_Outstanding();
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_FIXTURE_TEARDOWN(Global)
+{
+    if (parcMemory_Outstanding() != InitialMemoryOutstanding) {
+        parcSafeMemory_ReportAllocation(STDOUT_FILENO);
+        printf("('%s' leaks memory by %zd\n",
+               longBowTestCase_GetName(testCase), parcMemory_Outstanding() - InitialMemoryOutstanding);
+        return LONGBOW_STATUS_MEMORYLEAK;
+    }
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortalLogger_AddCategory)
+{
+    CCNxPortalLoggerCategory first = ccnxPortalLogger_AddCategory("first");
+    CCNxPortalLoggerCategory second = ccnxPortalLogger_AddCategory("second");
+
+    assertFalse(first == CCNxPortalLogger_DefaultCategory, "Expected a new category");
+    assertFalse(first == second, "Expected distinct categories");
+    assertTrue(ccnxPortalLogger_GetLevel(first) == PARCLogLevel_Off, "Expected a new category to be off");
+
+    ccnxPortalLogger_RemoveCategory(first);
+    ccnxPortalLogger_RemoveCategory(second);
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortalLogger_AddCategory_Full)
+{
+    CCNxPortalLoggerCategory categories[CCNxPortalLogger_MaxCategories];
+    size_t count = 0;
+    while ((categories[count] = ccnxPortalLogger_AddCategory("full")) != CCNxPortalLogger_NoCategory) {
+        count++;
+    }
+
+    assertTrue(count == CCNxPortalLogger_MaxCategories - 1, "Expected every category but the default, actual %zu", count);
+    assertTrue(errno == ENOSPC, "Expected ENOSPC, actual %d", errno);
+
+    PARCLogLevel defaultLevel = ccnxPortalLogger_GetLevel(CCNxPortalLogger_DefaultCategory);
+    ccnxPortalLogger_SetLevel(CCNxPortalLogger_NoCategory, PARCLogLevel_Debug);
+    assertTrue(ccnxPortalLogger_GetLevel(CCNxPortalLogger_DefaultCategory) == defaultLevel,
+               "Expected the default category's level to be unchanged");
+    assertFalse(ccnxPortalLogger_IsLoggable(CCNxPortalLogger_NoCategory, PARCLogLevel_Error),
+                "Expected nothing loggable without a category");
+
+    for (size_t i = 0; i < count; i++) {
+        ccnxPortalLogger_RemoveCategory(categories[i]);
+    }
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortalLogger_RemoveCategory)
+{
+    CCNxPortalLoggerCategory category = ccnxPortalLogger_AddCategory("removed");
+    ccnxPortalLogger_SetLevel(category, PARCLogLevel_Debug);
+
+    ccnxPortalLogger_RemoveCategory(category);
+
+    assertTrue(ccnxPortalLogger_GetLevel(category) == PARCLogLevel_Off, "Expected a removed category to be off");
+
+    CCNxPortalLoggerCategory reused = ccnxPortalLogger_AddCategory("reused");
+    assertTrue(reused == category, "Expected the removed slot to be reused, actual %u", reused);
+    ccnxPortalLogger_RemoveCategory(reused);
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortalLogger_RemoveCategory_Default)
+{
+    ccnxPortalLogger_RemoveCategory(CCNxPortalLogger_DefaultCategory);
+
+    assertTrue(_logger.categories[CCNxPortalLogger_DefaultCategory].inUse, "Expected the default category to remain");
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortalLogger_SetLevel)
+{
+    CCNxPortalLoggerCategory category = ccnxPortalLogger_AddCategory("level");
+
+    ccnxPortalLogger_SetLevel(category, PARCLogLevel_Warning);
+    assertTrue(ccnxPortalLogger_GetLevel(category) == PARCLogLevel_Warning,
+               "Expected %d, actual %d", PARCLogLevel_Warning, ccnxPortalLogger_GetLevel(category));
+
+    ccnxPortalLogger_RemoveCategory(category);
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortalLogger_IsLoggable)
+{
+    CCNxPortalLoggerCategory category = ccnxPortalLogger_AddCategory("loggable");
+
+    assertFalse(ccnxPortalLogger_IsLoggable(category, PARCLogLevel_Error), "Expected nothing loggable when off");
+
+    ccnxPortalLogger_SetLevel(category, PARCLogLevel_Warning);
+    assertTrue(ccnxPortalLogger_IsLoggable(category, PARCLogLevel_Error), "Expected Error loggable at Warning");
+    assertTrue(ccnxPortalLogger_IsLoggable(category, PARCLogLevel_Warning), "Expected Warning loggable at Warning");
+    assertFalse(ccnxPortalLogger_IsLoggable(category, PARCLogLevel_Debug), "Expected Debug not loggable at Warning");
+
+    ccnxPortalLogger_RemoveCategory(category);
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortalLogger_Log)
+{
+    FILE *file = tmpfile();
+    ccnxPortalLogger_SetOutput(file);
+
+    CCNxPortalLoggerCategory category = ccnxPortalLogger_AddCategory("testLog");
+    ccnxPortalLogger_SetLevel(category, PARCLogLevel_Info);
+
+    ccnxPortalLogger_Log(category, PARCLogLevel_Info, "value %" PRId64 " of %" PRId64, 42, 99, 0, 0);
+
+    char buffer[1024];
+    char *actual = _readLog(file, buffer, sizeof(buffer));
+    assertNotNull(strstr(actual, "testLog: value 42 of 99\n"), "Expected the record in the output, actual '%s'", actual);
+
+    ccnxPortalLogger_RemoveCategory(category);
+    ccnxPortalLogger_SetOutput(stderr);
+    fclose(file);
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortalLogger_Log_Disabled)
+{
+    FILE *file = tmpfile();
+    ccnxPortalLogger_SetOutput(file);
+
+    CCNxPortalLoggerCategory category = ccnxPortalLogger_AddCategory("disabled");
+    ccnxPortalLogger_SetLevel(category, PARCLogLevel_Error);
+
+    _evaluations = 0;
+    ccnxPortalLogger_Log(category, PARCLogLevel_Debug, "value %" PRId64, _countEvaluation(), 0, 0, 0);
+
+    assertTrue(_evaluations == 0, "Expected the arguments of a disabled record not to be evaluated");
+
+    char buffer[1024];
+    char *actual = _readLog(file, buffer, sizeof(buffer));
+    assertTrue(actual[0] == 0, "Expected no output, actual '%s'", actual);
+
+    ccnxPortalLogger_RemoveCategory(category);
+    ccnxPortalLogger_SetOutput(stderr);
+    fclose(file);
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortalLogger_Write_Full)
+{
+    FILE *file = tmpfile();
+    ccnxPortalLogger_SetOutput(file);
+
+    CCNxPortalLoggerCategory category = ccnxPortalLogger_AddCategory("full");
+
+    // Hold the consumer off the ring so that it fills.
+    pthread_mutex_lock(&_logger.drainLock);
+    uint64_t dropped = ccnxPortalLogger_GetDropped();
+    size_t written = 0;
+    for (size_t i = 0; i < 2 * _ringSize; i++) {
+        if (ccnxPortalLogger_Write(category, PARCLogLevel_Info, "record %" PRId64, (int64_t) i, 0, 0, 0)) {
+            written++;
+        }
+    }
+    pthread_mutex_unlock(&_logger.drainLock);
+
+    assertTrue(written == _ringSize, "Expected a ring of records to be written, actual %zu", written);
+    assertTrue(ccnxPortalLogger_GetDropped() - dropped == 2 * _ringSize - written,
+               "Expected %zu dropped, actual %" PRIu64, 2 * _ringSize - written, ccnxPortalLogger_GetDropped() - dropped);
+
+    ccnxPortalLogger_Flush();
+
+    ccnxPortalLogger_RemoveCategory(category);
+    ccnxPortalLogger_SetOutput(stderr);
+    fclose(file);
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortalLogger_Write_Unthreaded)
+{
+    FILE *file = tmpfile();
+    ccnxPortalLogger_SetOutput(file);
+
+    CCNxPortalLoggerCategory category = ccnxPortalLogger_AddCategory("unthreaded");
+    ccnxPortalLogger_SetLevel(category, PARCLogLevel_Info);
+
+    // As if the background thread could not be started: the record is written before the call returns.
+    _logger.threaded = false;
+    ccnxPortalLogger_Log(category, PARCLogLevel_Info, "value %" PRId64, 7, 0, 0, 0);
+    _logger.threaded = true;
+
+    char buffer[1024];
+    rewind(file);
+    size_t count = fread(buffer, 1, sizeof(buffer) - 1, file);
+    buffer[count] = 0;
+    assertNotNull(strstr(buffer, "unthreaded: value 7\n"), "Expected the record in the output, actual '%s'", buffer);
+
+    ccnxPortalLogger_RemoveCategory(category);
+    ccnxPortalLogger_SetOutput(stderr);
+    fclose(file);
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortalLogger_Write_Wakeup)
+{
+    FILE *file = tmpfile();
+    ccnxPortalLogger_SetOutput(file);
+
+    CCNxPortalLoggerCategory category = ccnxPortalLogger_AddCategory("wakeup");
+    ccnxPortalLogger_SetLevel(category, PARCLogLevel_Info);
+
+    // Let the background thread go idle, then check that appending a record wakes it without a flush.
+    usleep(10000);
+    ccnxPortalLogger_Log(category, PARCLogLevel_Info, "value %" PRId64, 11, 0, 0, 0);
+
+    uint64_t head = __atomic_load_n(&_logger.head, __ATOMIC_ACQUIRE);
+    for (int i = 0; i < 1000 && __atomic_load_n(&_logger.tail, __ATOMIC_ACQUIRE) < head; i++) {
+        usleep(1000);
+    }
+    assertTrue(__atomic_load_n(&_logger.tail, __ATOMIC_ACQUIRE) >= head, "Expected the background thread to write the record");
+
+    ccnxPortalLogger_RemoveCategory(category);
+    ccnxPortalLogger_SetOutput(stderr);
+    fclose(file);
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortalLogger_Thread_Lifetime)
+{
+    FILE *file = tmpfile();
+    ccnxPortalLogger_SetOutput(file);
+
+    CCNxPortalLoggerCategory first = ccnxPortalLogger_AddCategory("first");
+    CCNxPortalLoggerCategory second = ccnxPortalLogger_AddCategory("second");
+    assertTrue(_logger.threaded, "Expected the background thread to run while categories are added");
+
+    ccnxPortalLogger_SetLevel(first, PARCLogLevel_Info);
+    ccnxPortalLogger_Log(first, PARCLogLevel_Info, "value %" PRId64, 5, 0, 0, 0);
+
+    ccnxPortalLogger_RemoveCategory(first);
+    ccnxPortalLogger_RemoveCategory(first);
+    assertTrue(_logger.threaded, "Expected the background thread to run until the last category is removed");
+
+    ccnxPortalLogger_RemoveCategory(second);
+    assertFalse(_logger.threaded, "Expected the background thread to be stopped");
+    assertTrue(_logger.tail == _logger.head, "Expected the ring to be written when the background thread stopped");
+
+    char buffer[1024];
+    rewind(file);
+    size_t count = fread(buffer, 1, sizeof(buffer) - 1, file);
+    buffer[count] = 0;
+    assertNotNull(strstr(buffer, ": value 5\n"), "Expected the record in the output, actual '%s'", buffer);
+
+    CCNxPortalLoggerCategory again = ccnxPortalLogger_AddCategory("again");
+    assertTrue(_logger.threaded, "Expected the background thread to be started again");
+    ccnxPortalLogger_RemoveCategory(again);
+
+    ccnxPortalLogger_SetOutput(stderr);
+    fclose(file);
+}
+
+LONGBOW_TEST_FIXTURE(Local)
+{
+    LONGBOW_RUN_TEST_CASE(Local, _ccnxPortalLogger_Format);
+}
+
+LONGBOW_TEST_FIXTURE_SETUP(Local)
+{
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_FIXTURE_TEARDOWN(Local)
+{
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_CASE(Local, _ccnxPortalLogger_Format)
+{
+    _LogRecord record = {
+        .timestamp = UINT64_C(1451606400123456789),
+        .format    = "%" PRId64 " %" PRId64 " %" PRId64 " %" PRId64,
+        .arguments = { 1, -2, 3, -4 },
+        .category  = CCNxPortalLogger_DefaultCategory,
+        .level     = PARCLogLevel_Warning
+    };
+
+    char buffer[256];
+    FILE *file = fmemopen(buffer, sizeof(buffer), "w");
+    _ccnxPortalLogger_Format(file, &record);
+    fclose(file);
+
+    char expected[256];
+    snprintf(expected, sizeof(expected), "1451606400.123456 %-9s ccnxPortal: 1 -2 3 -4\n", parcLogLevel_ToString(PARCLogLevel_Warning));
+    assertTrue(strcmp(buffer, expected) == 0, "Expected '%s', actual '%s'", expected, buffer);
+}
+
+int
+main(int argc, char *argv[argc])
+{
+    LongBowRunner *testRunner = LONGBOW_TEST_RUNNER_CREATE(test_ccnx_PortalLogger);
+    int exitStatus = longBowMain(argc, argv, testRunner, NULL);
+    longBowTestRunner_Destroy(&testRunner);
+    exit(exitStatus);
+}
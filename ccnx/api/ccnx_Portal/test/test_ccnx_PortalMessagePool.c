@@ -0,0 +1,348 @@
+/*
+ * Copyright (c) 2016, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX OR PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ################################################################################
+ * #
+ * # PATENT NOTICE
+ * #
+ * # This software is distributed under the BSD 2-clause License (see LICENSE
+ * # file).  This BSD License does not make any patent claims and as such, does
+ * # not act as a patent grant.  The purpose of this section is for each contributor
+ * # to define their intentions with respect to intellectual property.
+ * #
+ * # Each contributor to this source code is encouraged to state their patent
+ * # claims and licensing mechanisms for any contributions made. At the end of
+ * # this section contributors may each make their own statements.  Contributor's
+ * # claims and grants only apply to the pieces (source code, programs, text,
+ * # media, etc) that they have contributed directly to this software.
+ * #
+ * # There is no guarantee that this section is complete, up to date or accurate. It
+ * # is up to the contributors to maintain their portion of this section and up to
+ * # the user of the software to verify any claims herein.
+ * #
+ * # Do not remove this header notification.  The contents of this section must be
+ * # present in all distributions of the software.  You may only modify your own
+ * # intellectual property statements.  Please provide contact information.
+ *
+ * - Palo Alto Research Center, Inc
+ * This software distribution does not grant any rights to patents owned by Palo
+ * Alto Research Center, Inc (PARC). Rights to these patents are available via
+ * various mechanisms. As of January 2016 PARC has committed to FRAND licensing any
+ * intellectual property used by its contributions to this software. You may
+ * contact PARC at cipo@parc.com for more information or visit http://www.ccnx.org
+ */
+/**
+ * @copyright (c) 2016, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC).  All rights reserved.
+ */
+#include "../ccnx_PortalMessagePool.c"
+
+#include <LongBow/unit-test.h>
+#include <LongBow/debugging.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <parc/algol/parc_Memory.h>
+#include <parc/algol/parc_SafeMemory.h>
+#include <parc/testing/parc_ObjectTesting.h>
+
+LONGBOW_TEST_RUNNER(test_ccnx_PortalMessagePool)
+{
+    LONGBOW_RUN_TEST_FIXTURE(Global);
+}
+
+LONGBOW_TEST_RUNNER_SETUP(test_ccnx_PortalMessagePool)
+{
+    parcMemory_SetInterface(&PARCSafeMemoryAsPARCMemory);
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_RUNNER_TEARDOWN(test_ccnx_PortalMessagePool)
+{
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_FIXTURE(Global)
+{
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortalMessagePool_CreateAcquireRelease);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortalMessagePool_Create_ZeroCapacity);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortalMessagePool_GetContentObject);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortalMessagePool_GetContentObject_Recycled);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortalMessagePool_GetContentObject_InUse);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortalMessagePool_GetContentObject_NameHeld);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortalMessagePool_GetContentObject_Exhausted);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortalMessagePool_GetInterest);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortalMessagePool_GetBuffer);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortalMessagePool_SteadyState);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortalMessagePool_OutlivesPool);
+}
+
+static size_t InitialMemoryOutstanding = 0;
+
+LONGBOW_TEST_FIXTURE_SETUP(Global)
+{
+    InitialMemoryOutstanding = parcMemory_Outstanding();
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_FIXTURE_TEARDOWN(Global)
+{
+    if (parcMemory_Outstanding() != InitialMemoryOutstanding) {
+        parcSafeMemory_ReportAllocation(STDOUT_FILENO);
+        printf("('%s' leaks memory by %zd\n",
+               longBowTestCase_GetName(testCase), parcMemory_Outstanding() - InitialMemoryOutstanding);
+        return LONGBOW_STATUS_MEMORYLEAK;
+    }
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortalMessagePool_CreateAcquireRelease)
+{
+    CCNxPortalMessagePool *pool = ccnxPortalMessagePool_Create(4, 16);
+    assertNotNull(pool, "Expected a non-null pool");
+    assertTrue(ccnxPortalMessagePool_GetAllocatedCount(pool) == 0, "Expected nothing allocated");
+    assertTrue(ccnxPortalMessagePool_GetRecycledCount(pool) == 0, "Expected nothing recycled");
+
+    parcObjectTesting_AssertAcquireReleaseContract(ccnxPortalMessagePool_Acquire, pool);
+
+    ccnxPortalMessagePool_Release(&pool);
+    assertNull(pool, "Expected ccnxPortalMessagePool_Release to null the pointer");
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortalMessagePool_Create_ZeroCapacity)
+{
+    CCNxPortalMessagePool *pool = ccnxPortalMessagePool_Create(0, 16);
+    assertNull(pool, "Expected NULL for a zero capacity");
+    assertTrue(errno == EINVAL, "Expected EINVAL, actual %d", errno);
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortalMessagePool_GetContentObject)
+{
+    CCNxPortalMessagePool *pool = ccnxPortalMessagePool_Create(4, 16);
+    CCNxName *name = ccnxName_CreateFromCString("lci:/pool/a");
+
+    CCNxMetaMessage *message = ccnxPortalMessagePool_GetContentObject(pool, name);
+    assertTrue(ccnxMetaMessage_IsContentObject(message), "Expected a Content Object");
+
+    CCNxContentObject *contentObject = ccnxMetaMessage_GetContentObject(message);
+    assertTrue(ccnxName_Equals(name, ccnxContentObject_GetName(contentObject)), "Expected the requested name");
+
+    PARCBuffer *payload = ccnxContentObject_GetPayload(contentObject);
+    assertTrue(parcBuffer_Position(payload) == 0, "Expected a cleared payload");
+    assertTrue(parcBuffer_Remaining(payload) == 16, "Expected the payload capacity, actual %zu", parcBuffer_Remaining(payload));
+
+    ccnxMetaMessage_Release(&message);
+    ccnxName_Release(&name);
+    ccnxPortalMessagePool_Release(&pool);
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortalMessagePool_GetContentObject_Recycled)
+{
+    CCNxPortalMessagePool *pool = ccnxPortalMessagePool_Create(4, 16);
+    CCNxName *first = ccnxName_CreateFromCString("lci:/pool/a");
+    CCNxName *second = ccnxName_CreateFromCString("lci:/pool/b/c");
+
+    CCNxMetaMessage *message = ccnxPortalMessagePool_GetContentObject(pool, first);
+    PARCBuffer *payload = ccnxContentObject_GetPayload(ccnxMetaMessage_GetContentObject(message));
+    parcBuffer_PutUint8(payload, 42);
+    parcBuffer_Flip(payload);
+    CCNxMetaMessage *expected = message;
+    ccnxMetaMessage_Release(&message);
+
+    message = ccnxPortalMessagePool_GetContentObject(pool, second);
+    assertTrue(message == expected, "Expected the released message to be recycled");
+    assertTrue(ccnxPortalMessagePool_GetRecycledCount(pool) == 1, "Expected one recycled message");
+
+    CCNxContentObject *contentObject = ccnxMetaMessage_GetContentObject(message);
+    assertTrue(ccnxName_Equals(second, ccnxContentObject_GetName(contentObject)), "Expected the new name");
+    payload = ccnxContentObject_GetPayload(contentObject);
+    assertTrue(parcBuffer_Position(payload) == 0 && parcBuffer_Remaining(payload) == 16, "Expected the payload to be cleared");
+
+    ccnxMetaMessage_Release(&message);
+    ccnxName_Release(&first);
+    ccnxName_Release(&second);
+    ccnxPortalMessagePool_Release(&pool);
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortalMessagePool_GetContentObject_InUse)
+{
+    CCNxPortalMessagePool *pool = ccnxPortalMessagePool_Create(4, 16);
+    CCNxName *name = ccnxName_CreateFromCString("lci:/pool/a");
+
+    CCNxMetaMessage *first = ccnxPortalMessagePool_GetContentObject(pool, name);
+    CCNxMetaMessage *second = ccnxPortalMessagePool_GetContentObject(pool, name);
+    assertFalse(first == second, "Expected a message in use not to be handed out again");
+    assertTrue(ccnxPortalMessagePool_GetAllocatedCount(pool) == 2, "Expected two allocated messages");
+
+    ccnxMetaMessage_Release(&first);
+    ccnxMetaMessage_Release(&second);
+    ccnxName_Release(&name);
+    ccnxPortalMessagePool_Release(&pool);
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortalMessagePool_GetContentObject_NameHeld)
+{
+    CCNxPortalMessagePool *pool = ccnxPortalMessagePool_Create(4, 16);
+    CCNxName *first = ccnxName_CreateFromCString("lci:/pool/a");
+    CCNxName *second = ccnxName_CreateFromCString("lci:/pool/b");
+
+    CCNxMetaMessage *message = ccnxPortalMessagePool_GetContentObject(pool, first);
+    CCNxMetaMessage *expected = message;
+    CCNxName *held = ccnxName_Acquire(ccnxContentObject_GetName(ccnxMetaMessage_GetContentObject(message)));
+    ccnxMetaMessage_Release(&message);
+
+    // Someone still holds the message's name, so reusing the message would change their name.
+    message = ccnxPortalMessagePool_GetContentObject(pool, second);
+    assertFalse(message == expected, "Expected a message whose name is held elsewhere not to be recycled");
+    assertTrue(ccnxName_Equals(first, held), "Expected the held name to be unchanged");
+
+    ccnxMetaMessage_Release(&message);
+    ccnxName_Release(&held);
+    ccnxName_Release(&first);
+    ccnxName_Release(&second);
+    ccnxPortalMessagePool_Release(&pool);
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortalMessagePool_GetContentObject_Exhausted)
+{
+    CCNxPortalMessagePool *pool = ccnxPortalMessagePool_Create(1, 16);
+    CCNxName *name = ccnxName_CreateFromCString("lci:/pool/a");
+
+    CCNxMetaMessage *pooled = ccnxPortalMessagePool_GetContentObject(pool, name);
+    CCNxMetaMessage *unpooled = ccnxPortalMessagePool_GetContentObject(pool, name);
+    assertNotNull(unpooled, "Expected a message even when the pool is exhausted");
+    assertTrue(ccnxName_Equals(name, ccnxContentObject_GetName(ccnxMetaMessage_GetContentObject(unpooled))), "Expected the requested name");
+    assertTrue(parcObject_GetReferenceCount(unpooled) == 1, "Expected the pool to keep no reference to an unpooled message");
+
+    ccnxMetaMessage_Release(&pooled);
+    ccnxMetaMessage_Release(&unpooled);
+    ccnxName_Release(&name);
+    ccnxPortalMessagePool_Release(&pool);
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortalMessagePool_GetInterest)
+{
+    CCNxPortalMessagePool *pool = ccnxPortalMessagePool_Create(4, 16);
+    CCNxName *name = ccnxName_CreateFromCString("lci:/pool/a");
+
+    CCNxMetaMessage *contentObject = ccnxPortalMessagePool_GetContentObject(pool, name);
+    ccnxMetaMessage_Release(&contentObject);
+
+    CCNxMetaMessage *message = ccnxPortalMessagePool_GetInterest(pool, name);
+    assertTrue(ccnxMetaMessage_IsInterest(message), "Expected an Interest, not the idle Content Object");
+    assertTrue(ccnxName_Equals(name, ccnxInterest_GetName(ccnxMetaMessage_GetInterest(message))), "Expected the requested name");
+    CCNxMetaMessage *expected = message;
+    ccnxMetaMessage_Release(&message);
+
+    message = ccnxPortalMessagePool_GetInterest(pool, name);
+    assertTrue(message == expected, "Expected the released Interest to be recycled");
+
+    ccnxMetaMessage_Release(&message);
+    ccnxName_Release(&name);
+    ccnxPortalMessagePool_Release(&pool);
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortalMessagePool_GetBuffer)
+{
+    CCNxPortalMessagePool *pool = ccnxPortalMessagePool_Create(2, 16);
+
+    PARCBuffer *buffer = ccnxPortalMessagePool_GetBuffer(pool);
+    assertTrue(parcBuffer_Capacity(buffer) == 16, "Expected the payload capacity");
+    parcBuffer_PutUint8(buffer, 42);
+    PARCBuffer *expected = buffer;
+
+    // Held as the payload of a Content Object, the buffer is still in use after the caller releases it.
+    CCNxName *name = ccnxName_CreateFromCString("lci:/pool/a");
+    parcBuffer_Flip(buffer);
+    CCNxContentObject *contentObject = ccnxContentObject_CreateWithNameAndPayload(name, buffer);
+    parcBuffer_Release(&buffer);
+
+    buffer = ccnxPortalMessagePool_GetBuffer(pool);
+    assertFalse(buffer == expected, "Expected a buffer held by a Content Object not to be recycled");
+    parcBuffer_Release(&buffer);
+
+    ccnxContentObject_Release(&contentObject);
+    ccnxName_Release(&name);
+
+    buffer = ccnxPortalMessagePool_GetBuffer(pool);
+    PARCBuffer *other = ccnxPortalMessagePool_GetBuffer(pool);
+    assertTrue(buffer == expected || other == expected, "Expected the released buffer to be recycled");
+    assertTrue(parcBuffer_Position(expected) == 0 && parcBuffer_Remaining(expected) == 16, "Expected the buffer to be cleared");
+
+    parcBuffer_Release(&buffer);
+    parcBuffer_Release(&other);
+    ccnxPortalMessagePool_Release(&pool);
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortalMessagePool_SteadyState)
+{
+    CCNxPortalMessagePool *pool = ccnxPortalMessagePool_Create(8, 64);
+    CCNxName *name = ccnxName_CreateFromCString("lci:/pool/steady/state");
+    uint8_t data[64] = { 0 };
+
+    CCNxMetaMessage *warm = ccnxPortalMessagePool_GetContentObject(pool, name);
+    ccnxMetaMessage_Release(&warm);
+
+    size_t outstanding = parcMemory_Outstanding();
+    for (int i = 0; i < 100; i++) {
+        CCNxMetaMessage *message = ccnxPortalMessagePool_GetContentObject(pool, name);
+        PARCBuffer *payload = ccnxContentObject_GetPayload(ccnxMetaMessage_GetContentObject(message));
+        parcBuffer_PutArray(payload, sizeof(data), data);
+        parcBuffer_Flip(payload);
+        assertTrue(parcMemory_Outstanding() == outstanding, "Expected no allocation for a recycled message");
+        ccnxMetaMessage_Release(&message);
+    }
+    assertTrue(ccnxPortalMessagePool_GetAllocatedCount(pool) == 1, "Expected a single allocated message");
+    assertTrue(ccnxPortalMessagePool_GetRecycledCount(pool) == 100, "Expected every message to be recycled");
+
+    ccnxName_Release(&name);
+    ccnxPortalMessagePool_Release(&pool);
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortalMessagePool_OutlivesPool)
+{
+    CCNxPortalMessagePool *pool = ccnxPortalMessagePool_Create(4, 16);
+    CCNxName *name = ccnxName_CreateFromCString("lci:/pool/a");
+
+    CCNxMetaMessage *message = ccnxPortalMessagePool_GetContentObject(pool, name);
+    PARCBuffer *buffer = ccnxPortalMessagePool_GetBuffer(pool);
+    ccnxPortalMessagePool_Release(&pool);
+
+    assertTrue(ccnxName_Equals(name, ccnxContentObject_GetName(ccnxMetaMessage_GetContentObject(message))),
+               "Expected the message to remain valid after the pool is released");
+
+    parcBuffer_Release(&buffer);
+    ccnxMetaMessage_Release(&message);
+    ccnxName_Release(&name);
+}
+
+int
+main(int argc, char *argv[argc])
+{
+    LongBowRunner *testRunner = LONGBOW_TEST_RUNNER_CREATE(test_ccnx_PortalMessagePool);
+    int exitStatus = longBowMain(argc, argv, testRunner, NULL);
+    longBowTestRunner_Destroy(&testRunner);
+    exit(exitStatus);
+}
@@ -0,0 +1,254 @@
+/*
+ * Copyright (c) 2016, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX OR PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ################################################################################
+ * #
+ * # PATENT NOTICE
+ * #
+ * # This software is distributed under the BSD 2-clause License (see LICENSE
+ * # file).  This BSD License does not make any patent claims and as such, does
+ * # not act as a patent grant.  The purpose of this section is for each contributor
+ * # to define their intentions with respect to intellectual property.
+ * #
+ * # Each contributor to this source code is encouraged to state their patent
+ * # claims and licensing mechanisms for any contributions made. At the end of
+ * # this section contributors may each make their own statements.  Contributor's
+ * # claims and grants only apply to the pieces (source code, programs, text,
+ * # media, etc) that they have contributed directly to this software.
+ * #
+ * # There is no guarantee that this section is complete, up to date or accurate. It
+ * # is up to the contributors to maintain their portion of this section and up to
+ * # the user of the software to verify any claims herein.
+ * #
+ * # Do not remove this header notification.  The contents of this section must be
+ * # present in all distributions of the software.  You may only modify your own
+ * # intellectual property statements.  Please provide contact information.
+ *
+ * - Palo Alto Research Center, Inc
+ * This software distribution does not grant any rights to patents owned by Palo
+ * Alto Research Center, Inc (PARC). Rights to these patents are available via
+ * various mechanisms. As of January 2016 PARC has committed to FRAND licensing any
+ * intellectual property used by its contributions to this software. You may
+ * contact PARC at cipo@parc.com for more information or visit http://www.ccnx.org
+ */
+/**
+ * @copyright (c) 2016, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC).  All rights reserved.
+ */
+#include "../ccnx_PortalPayloadRegistry.c"
+
+#include <LongBow/unit-test.h>
+#include <LongBow/debugging.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <parc/algol/parc_Memory.h>
+#include <parc/algol/parc_SafeMemory.h>
+#include <parc/testing/parc_ObjectTesting.h>
+
+LONGBOW_TEST_RUNNER(test_ccnx_PortalPayloadRegistry)
+{
+    LONGBOW_RUN_TEST_FIXTURE(Global);
+}
+
+LONGBOW_TEST_RUNNER_SETUP(test_ccnx_PortalPayloadRegistry)
+{
+    parcMemory_SetInterface(&PARCSafeMemoryAsPARCMemory);
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_RUNNER_TEARDOWN(test_ccnx_PortalPayloadRegistry)
+{
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_FIXTURE(Global)
+{
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortalPayloadRegistry_CreateAcquireRelease);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortalPayloadRegistry_Wrap);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortalPayloadRegistry_Reclaim);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortalPayloadRegistry_Reclaim_Referenced);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortalPayloadRegistry_Reclaim_Many);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortalPayloadRegistry_Release);
+}
+
+static size_t InitialMemoryOutstanding = 0;
+
+LONGBOW_TEST_FIXTURE_SETUP(Global)
+{
+    InitialMemoryOutstanding = parcMemory_Outstanding();
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_FIXTURE_TEARDOWN(Global)
+{
+    if (parcMemory_Outstanding() != InitialMemoryOutstanding) {
+        parcSafeMemory_ReportAllocation(STDOUT_FILENO);
+        printf("('%s' leaks memory by %zd\n",
+               longBowTestCase_GetName(testCase), parcMemory_Outstanding() - InitialMemoryOutstanding);
+        return LONGBOW_STATUS_MEMORYLEAK;
+    }
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+typedef struct {
+    int calls;
+    void *memory;
+    size_t length;
+} _ReleaseRecord;
+
+static void
+_recordRelease(void *memory, size_t length, void *context)
+{
+    _ReleaseRecord *record = context;
+    record->calls++;
+    record->memory = memory;
+    record->length = length;
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortalPayloadRegistry_CreateAcquireRelease)
+{
+    CCNxPortalPayloadRegistry *registry = ccnxPortalPayloadRegistry_Create();
+    assertNotNull(registry, "Expected a non-null registry");
+    assertTrue(ccnxPortalPayloadRegistry_GetCount(registry) == 0, "Expected an empty registry");
+
+    parcObjectTesting_AssertAcquireReleaseContract(ccnxPortalPayloadRegistry_Acquire, registry);
+
+    ccnxPortalPayloadRegistry_Release(&registry);
+    assertNull(registry, "Expected ccnxPortalPayloadRegistry_Release to null the pointer");
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortalPayloadRegistry_Wrap)
+{
+    CCNxPortalPayloadRegistry *registry = ccnxPortalPayloadRegistry_Create();
+    char memory[] = "Hello World";
+    _ReleaseRecord record = { 0 };
+
+    PARCBuffer *buffer = ccnxPortalPayloadRegistry_Wrap(registry, memory, sizeof(memory), _recordRelease, &record);
+    assertNotNull(buffer, "Expected a non-null buffer");
+    assertTrue(parcBuffer_Remaining(buffer) == sizeof(memory), "Expected the whole payload to remain");
+    assertTrue(parcBuffer_Overlay(buffer, 0) == (void *) memory, "Expected the buffer to refer to the memory, not a copy");
+    assertTrue(ccnxPortalPayloadRegistry_GetCount(registry) == 1, "Expected one registered payload");
+
+    parcBuffer_Release(&buffer);
+    ccnxPortalPayloadRegistry_Release(&registry);
+    assertTrue(record.calls == 1, "Expected the release function to be called once, actual %d", record.calls);
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortalPayloadRegistry_Reclaim)
+{
+    CCNxPortalPayloadRegistry *registry = ccnxPortalPayloadRegistry_Create();
+    char memory[] = "Hello World";
+    _ReleaseRecord record = { 0 };
+
+    PARCBuffer *buffer = ccnxPortalPayloadRegistry_Wrap(registry, memory, sizeof(memory), _recordRelease, &record);
+    parcBuffer_Release(&buffer);
+
+    size_t count = ccnxPortalPayloadRegistry_Reclaim(registry);
+    assertTrue(count == 0, "Expected no payloads to remain, actual %zu", count);
+    assertTrue(record.calls == 1, "Expected the release function to be called once, actual %d", record.calls);
+    assertTrue(record.memory == memory, "Expected the registered memory");
+    assertTrue(record.length == sizeof(memory), "Expected the registered length");
+
+    ccnxPortalPayloadRegistry_Reclaim(registry);
+    ccnxPortalPayloadRegistry_Release(&registry);
+    assertTrue(record.calls == 1, "Expected the release function to be called only once, actual %d", record.calls);
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortalPayloadRegistry_Reclaim_Referenced)
+{
+    CCNxPortalPayloadRegistry *registry = ccnxPortalPayloadRegistry_Create();
+    char memory[] = "Hello World";
+    _ReleaseRecord record = { 0 };
+
+    PARCBuffer *buffer = ccnxPortalPayloadRegistry_Wrap(registry, memory, sizeof(memory), _recordRelease, &record);
+
+    size_t count = ccnxPortalPayloadRegistry_Reclaim(registry);
+    assertTrue(count == 1, "Expected the referenced payload to remain, actual %zu", count);
+    assertTrue(record.calls == 0, "Expected the release function not to be called");
+
+    parcBuffer_Release(&buffer);
+    ccnxPortalPayloadRegistry_Reclaim(registry);
+    assertTrue(record.calls == 1, "Expected the release function to be called once, actual %d", record.calls);
+
+    ccnxPortalPayloadRegistry_Release(&registry);
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortalPayloadRegistry_Reclaim_Many)
+{
+    CCNxPortalPayloadRegistry *registry = ccnxPortalPayloadRegistry_Create();
+    char memory[100];
+    _ReleaseRecord record = { 0 };
+
+    PARCBuffer *buffers[100];
+    for (size_t i = 0; i < 100; i++) {
+        buffers[i] = ccnxPortalPayloadRegistry_Wrap(registry, &memory[i], 1, _recordRelease, &record);
+    }
+    for (size_t i = 0; i < 100; i += 2) {
+        parcBuffer_Release(&buffers[i]);
+    }
+
+    size_t count = ccnxPortalPayloadRegistry_Reclaim(registry);
+    assertTrue(count == 50, "Expected the 50 referenced payloads to remain, actual %zu", count);
+    assertTrue(record.calls == 50, "Expected 50 release calls, actual %d", record.calls);
+
+    for (size_t i = 1; i < 100; i += 2) {
+        parcBuffer_Release(&buffers[i]);
+    }
+    count = ccnxPortalPayloadRegistry_Reclaim(registry);
+    assertTrue(count == 0, "Expected no payloads to remain, actual %zu", count);
+    assertTrue(record.calls == 100, "Expected 100 release calls, actual %d", record.calls);
+
+    ccnxPortalPayloadRegistry_Release(&registry);
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortalPayloadRegistry_Release)
+{
+    CCNxPortalPayloadRegistry *registry = ccnxPortalPayloadRegistry_Create();
+    char memory[] = "Hello World";
+    _ReleaseRecord record = { 0 };
+
+    _ReleaseRecord referencedRecord = { 0 };
+
+    PARCBuffer *buffer = ccnxPortalPayloadRegistry_Wrap(registry, memory, sizeof(memory), _recordRelease, &record);
+    parcBuffer_Release(&buffer);
+    PARCBuffer *referenced = ccnxPortalPayloadRegistry_Wrap(registry, memory, sizeof(memory), _recordRelease, &referencedRecord);
+
+    ccnxPortalPayloadRegistry_Release(&registry);
+    assertTrue(record.calls == 1, "Expected the release function to be called on release, actual %d", record.calls);
+    assertTrue(referencedRecord.calls == 1,
+               "Expected the release function of a referenced payload to be called on release, actual %d", referencedRecord.calls);
+
+    parcBuffer_Release(&referenced);
+}
+
+int
+main(int argc, char *argv[argc])
+{
+    LongBowRunner *testRunner = LONGBOW_TEST_RUNNER_CREATE(test_ccnx_PortalPayloadRegistry);
+    int exitStatus = longBowMain(argc, argv, testRunner, NULL);
+    longBowTestRunner_Destroy(&testRunner);
+    exit(exitStatus);
+}
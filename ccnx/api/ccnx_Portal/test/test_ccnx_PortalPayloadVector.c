@@ -0,0 +1,304 @@
+/*
+ * Copyright (c) 2016, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX OR PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ################################################################################
+ * #
+ * # PATENT NOTICE
+ * #
+ * # This software is distributed under the BSD 2-clause License (see LICENSE
+ * # file).  This BSD License does not make any patent claims and as such, does
+ * # not act as a patent grant.  The purpose of this section is for each contributor
+ * # to define their intentions with respect to intellectual property.
+ * #
+ * # Each contributor to this source code is encouraged to state their patent
+ * # claims and licensing mechanisms for any contributions made. At the end of
+ * # this section contributors may each make their own statements.  Contributor's
+ * # claims and grants only apply to the pieces (source code, programs, text,
+ * # media, etc) that they have contributed directly to this software.
+ * #
+ * # There is no guarantee that this section is complete, up to date or accurate. It
+ * # is up to the contributors to maintain their portion of this section and up to
+ * # the user of the software to verify any claims herein.
+ * #
+ * # Do not remove this header notification.  The contents of this section must be
+ * # present in all distributions of the software.  You may only modify your own
+ * # intellectual property statements.  Please provide contact information.
+ *
+ * - Palo Alto Research Center, Inc
+ * This software distribution does not grant any rights to patents owned by Palo
+ * Alto Research Center, Inc (PARC). Rights to these patents are available via
+ * various mechanisms. As of January 2016 PARC has committed to FRAND licensing any
+ * intellectual property used by its contributions to this software. You may
+ * contact PARC at cipo@parc.com for more information or visit http://www.ccnx.org
+ */
+/**
+ * @copyright (c) 2016, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC).  All rights reserved.
+ */
+#include "../ccnx_PortalPayloadVector.c"
+
+#include <LongBow/unit-test.h>
+#include <LongBow/debugging.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <parc/algol/parc_Memory.h>
+#include <parc/algol/parc_SafeMemory.h>
+#include <parc/testing/parc_ObjectTesting.h>
+
+LONGBOW_TEST_RUNNER(test_ccnx_PortalPayloadVector)
+{
+    LONGBOW_RUN_TEST_FIXTURE(Global);
+}
+
+LONGBOW_TEST_RUNNER_SETUP(test_ccnx_PortalPayloadVector)
+{
+    parcMemory_SetInterface(&PARCSafeMemoryAsPARCMemory);
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_RUNNER_TEARDOWN(test_ccnx_PortalPayloadVector)
+{
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_FIXTURE(Global)
+{
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortalPayloadVector_CreateAcquireRelease);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortalPayloadVector_Append);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortalPayloadVector_Append_Many);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortalPayloadVector_Clear);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortalPayloadVector_Flatten);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortalPayloadVector_CreateMessage);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortalPayloadVector_CreateMessage_Decoded);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortalPayloadVector_CreateMessage_TooLong);
+}
+
+static size_t InitialMemoryOutstanding = 0;
+
+LONGBOW_TEST_FIXTURE_SETUP(Global)
+{
+    InitialMemoryOutstanding = parcMemory_Outstanding();
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_FIXTURE_TEARDOWN(Global)
+{
+    if (parcMemory_Outstanding() != InitialMemoryOutstanding) {
+        parcSafeMemory_ReportAllocation(STDOUT_FILENO);
+        printf("('%s' leaks memory by %zd\n",
+               longBowTestCase_GetName(testCase), parcMemory_Outstanding() - InitialMemoryOutstanding);
+        return LONGBOW_STATUS_MEMORYLEAK;
+    }
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+/*
+ * A vector of a header, the middle of a larger buffer, and a trailer, making the payload "header:body:trailer".
+ */
+static CCNxPortalPayloadVector *
+_createVector(void)
+{
+    CCNxPortalPayloadVector *result = ccnxPortalPayloadVector_Create();
+
+    PARCBuffer *header = parcBuffer_WrapCString("header:");
+    PARCBuffer *body = parcBuffer_WrapCString("xxbody:yy");
+    parcBuffer_SetPosition(body, 2);
+    parcBuffer_SetLimit(body, 7);
+    PARCBuffer *trailer = parcBuffer_WrapCString("trailer");
+
+    ccnxPortalPayloadVector_Append(result, header);
+    ccnxPortalPayloadVector_Append(result, body);
+    ccnxPortalPayloadVector_Append(result, trailer);
+
+    parcBuffer_Release(&trailer);
+    parcBuffer_Release(&body);
+    parcBuffer_Release(&header);
+
+    return result;
+}
+
+/*
+ * The wire format the stack would produce for a Content Object with the given name and payload.
+ */
+static PARCBuffer *
+_encodeContentObject(const CCNxName *name, const PARCBuffer *payload)
+{
+    CCNxContentObject *contentObject = ccnxContentObject_CreateWithNameAndPayload(name, payload);
+    CCNxMetaMessage *message = ccnxMetaMessage_CreateFromContentObject(contentObject);
+    PARCBuffer *result = ccnxMetaMessage_CreateWireFormatBuffer(message, NULL);
+    ccnxMetaMessage_Release(&message);
+    ccnxContentObject_Release(&contentObject);
+
+    return result;
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortalPayloadVector_CreateAcquireRelease)
+{
+    CCNxPortalPayloadVector *vector = ccnxPortalPayloadVector_Create();
+    assertNotNull(vector, "Expected a non-null vector");
+    assertTrue(ccnxPortalPayloadVector_GetCount(vector) == 0, "Expected an empty vector");
+    assertTrue(ccnxPortalPayloadVector_GetLength(vector) == 0, "Expected an empty payload");
+
+    parcObjectTesting_AssertAcquireReleaseContract(ccnxPortalPayloadVector_Acquire, vector);
+
+    ccnxPortalPayloadVector_Release(&vector);
+    assertNull(vector, "Expected ccnxPortalPayloadVector_Release to null the pointer");
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortalPayloadVector_Append)
+{
+    CCNxPortalPayloadVector *vector = ccnxPortalPayloadVector_Create();
+
+    PARCBuffer *slice = parcBuffer_WrapCString("slice");
+    assertTrue(ccnxPortalPayloadVector_Append(vector, slice), "Expected the slice to be appended");
+    assertTrue(parcObject_GetReferenceCount(slice) == 2, "Expected the vector to hold a reference to the slice");
+
+    // Moving the slice's position afterwards does not change the payload.
+    parcBuffer_SetPosition(slice, 3);
+    assertTrue(ccnxPortalPayloadVector_GetCount(vector) == 1, "Expected 1 slice, actual %zu", ccnxPortalPayloadVector_GetCount(vector));
+    assertTrue(ccnxPortalPayloadVector_GetLength(vector) == 5, "Expected 5 bytes, actual %zu", ccnxPortalPayloadVector_GetLength(vector));
+
+    ccnxPortalPayloadVector_Release(&vector);
+    assertTrue(parcObject_GetReferenceCount(slice) == 1, "Expected the vector's reference to be released");
+    parcBuffer_Release(&slice);
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortalPayloadVector_Append_Many)
+{
+    CCNxPortalPayloadVector *vector = ccnxPortalPayloadVector_Create();
+
+    PARCBuffer *slice = parcBuffer_WrapCString("0123456789");
+    for (size_t i = 0; i < 100; i++) {
+        ccnxPortalPayloadVector_Append(vector, slice);
+    }
+    parcBuffer_Release(&slice);
+
+    assertTrue(ccnxPortalPayloadVector_GetCount(vector) == 100, "Expected 100 slices, actual %zu", ccnxPortalPayloadVector_GetCount(vector));
+    assertTrue(ccnxPortalPayloadVector_GetLength(vector) == 1000, "Expected 1000 bytes, actual %zu", ccnxPortalPayloadVector_GetLength(vector));
+
+    ccnxPortalPayloadVector_Release(&vector);
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortalPayloadVector_Clear)
+{
+    CCNxPortalPayloadVector *vector = _createVector();
+
+    ccnxPortalPayloadVector_Clear(vector);
+    assertTrue(ccnxPortalPayloadVector_GetCount(vector) == 0, "Expected an empty vector");
+    assertTrue(ccnxPortalPayloadVector_GetLength(vector) == 0, "Expected an empty payload");
+
+    PARCBuffer *slice = parcBuffer_WrapCString("again");
+    ccnxPortalPayloadVector_Append(vector, slice);
+    parcBuffer_Release(&slice);
+    assertTrue(ccnxPortalPayloadVector_GetLength(vector) == 5, "Expected 5 bytes, actual %zu", ccnxPortalPayloadVector_GetLength(vector));
+
+    ccnxPortalPayloadVector_Release(&vector);
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortalPayloadVector_Flatten)
+{
+    CCNxPortalPayloadVector *vector = _createVector();
+
+    PARCBuffer *actual = ccnxPortalPayloadVector_Flatten(vector);
+    PARCBuffer *expected = parcBuffer_WrapCString("header:body:trailer");
+    assertTrue(parcBuffer_Equals(expected, actual), "Expected the slices concatenated in order");
+
+    parcBuffer_Release(&expected);
+    parcBuffer_Release(&actual);
+    ccnxPortalPayloadVector_Release(&vector);
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortalPayloadVector_CreateMessage)
+{
+    CCNxName *name = ccnxName_CreateFromCString("lci:/ccnx/vector/test");
+    CCNxPortalPayloadVector *vector = _createVector();
+
+    CCNxMetaMessage *message = ccnxPortalPayloadVector_CreateMessage(vector, name);
+    assertNotNull(message, "Expected a non-null message");
+
+    PARCBuffer *payload = ccnxPortalPayloadVector_Flatten(vector);
+    PARCBuffer *expected = _encodeContentObject(name, payload);
+    assertTrue(parcBuffer_Equals(ccnxWireFormatMessage_GetWireFormatBuffer(message), expected),
+               "Expected the encoding of a Content Object with the flattened payload");
+
+    parcBuffer_Release(&expected);
+    parcBuffer_Release(&payload);
+    ccnxMetaMessage_Release(&message);
+    ccnxPortalPayloadVector_Release(&vector);
+    ccnxName_Release(&name);
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortalPayloadVector_CreateMessage_Decoded)
+{
+    CCNxName *name = ccnxName_CreateFromCString("lci:/ccnx/vector/test");
+    CCNxPortalPayloadVector *vector = _createVector();
+
+    CCNxMetaMessage *message = ccnxPortalPayloadVector_CreateMessage(vector, name);
+    CCNxMetaMessage *decoded = ccnxMetaMessage_CreateFromWireFormatBuffer(ccnxWireFormatMessage_GetWireFormatBuffer(message));
+    assertTrue(ccnxMetaMessage_IsContentObject(decoded), "Expected a Content Object");
+
+    CCNxContentObject *contentObject = ccnxMetaMessage_GetContentObject(decoded);
+    assertTrue(ccnxName_Equals(name, ccnxContentObject_GetName(contentObject)), "Expected the given name");
+
+    PARCBuffer *expected = parcBuffer_WrapCString("header:body:trailer");
+    assertTrue(parcBuffer_Equals(expected, ccnxContentObject_GetPayload(contentObject)), "Expected the slices concatenated in order");
+
+    parcBuffer_Release(&expected);
+    ccnxMetaMessage_Release(&decoded);
+    ccnxMetaMessage_Release(&message);
+    ccnxPortalPayloadVector_Release(&vector);
+    ccnxName_Release(&name);
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortalPayloadVector_CreateMessage_TooLong)
+{
+    CCNxName *name = ccnxName_CreateFromCString("lci:/ccnx/vector/test");
+    CCNxPortalPayloadVector *vector = ccnxPortalPayloadVector_Create();
+
+    size_t length = UINT16_MAX / 2;
+    uint8_t *memory = parcMemory_AllocateAndClear(length);
+    PARCBuffer *slice = parcBuffer_Wrap(memory, length, 0, length);
+    ccnxPortalPayloadVector_Append(vector, slice);
+    ccnxPortalPayloadVector_Append(vector, slice);
+    parcBuffer_Release(&slice);
+
+    CCNxMetaMessage *message = ccnxPortalPayloadVector_CreateMessage(vector, name);
+    assertNull(message, "Expected NULL for a packet longer than the largest packet length");
+    assertTrue(errno == EINVAL, "Expected EINVAL, actual %d", errno);
+
+    ccnxPortalPayloadVector_Release(&vector);
+    parcMemory_Deallocate(&memory);
+    ccnxName_Release(&name);
+}
+
+int
+main(int argc, char *argv[argc])
+{
+    LongBowRunner *testRunner = LONGBOW_TEST_RUNNER_CREATE(test_ccnx_PortalPayloadVector);
+    int exitStatus = longBowMain(argc, argv, testRunner, NULL);
+    longBowTestRunner_Destroy(&testRunner);
+    exit(exitStatus);
+}
@@ -59,6 +59,11 @@
 
 #include <LongBow/unit-test.h>
 
+#include <string.h>
+#include <inttypes.h>
+
+#include <ccnx/api/ccnx_Portal/ccnx_PortalHistogram.h>
+
 LONGBOW_TEST_RUNNER(ccnx_PortalRTA)
 {
     // The following Test Fixtures will run their corresponding Test Cases.
@@ -66,6 +71,7 @@ LONGBOW_TEST_RUNNER(ccnx_PortalRTA)
     // Never rely on the execution order of tests or share state between them.
     LONGBOW_RUN_TEST_FIXTURE(Global);
     LONGBOW_RUN_TEST_FIXTURE(Static);
+    LONGBOW_RUN_TEST_FIXTURE(Performance);
 }
 
 // The Test Runner calls this function once before any Test Fixtures are run.
@@ -133,7 +139,8 @@ LONGBOW_TEST_FIXTURE(Static)
     LONGBOW_RUN_TEST_CASE(Static, _ccnxPortalRTA_Start);
     LONGBOW_RUN_TEST_CASE(Static, _ccnxPortalRTA_Stop);
     LONGBOW_RUN_TEST_CASE(Static, _createTransportConfig);
-    LONGBOW_RUN_TEST_CASE(Static, _nonBlockingPortal);
+    LONGBOW_RUN_TEST_CASE(Static, _ccnxPortalRTA_ApplyAttributes);
+    LONGBOW_RUN_TEST_CASE(Static, _ccnxPortalRTA_PinThread);
 }
 
 LONGBOW_TEST_FIXTURE_SETUP(Static)
@@ -241,9 +248,184 @@ LONGBOW_TEST_CASE(Static, _createTransportConfig)
     testUnimplemented("");
 }
 
-LONGBOW_TEST_CASE(Static, _nonBlockingPortal)
+LONGBOW_TEST_CASE(Static, _ccnxPortalRTA_ApplyAttributes)
 {
-    testUnimplemented("");
+    int fds[2];
+    assertTrue(socketpair(AF_UNIX, SOCK_STREAM, 0, fds) == 0, "socketpair failed: %s", strerror(errno));
+
+    _CCNxPortalRTAContext context = { .fileId = fds[0], .attributes = NULL };
+
+    CCNxPortalAttributes *attributes = ccnxPortalAttributes_Copy(&ccnxPortalAttributes_NonBlocking);
+    ccnxPortalAttributes_SetSocketReceiveBufferSize(attributes, 64 * 1024);
+
+    bool success = _ccnxPortalRTA_ApplyAttributes(&context, attributes);
+    assertTrue(success, "Expected the attributes to be applied");
+    assertTrue(fcntl(fds[0], F_GETFL, NULL) & O_NONBLOCK, "Expected the descriptor to be non-blocking");
+    assertTrue(ccnxPortalAttributes_GetSocketReceiveBufferSize(context.attributes) >= 64 * 1024,
+               "Expected at least the requested receive buffer size, actual %zu",
+               ccnxPortalAttributes_GetSocketReceiveBufferSize(context.attributes));
+    assertTrue(ccnxPortalAttributes_GetSocketSendBufferSize(context.attributes) == 0,
+               "Expected the default send buffer size to be left alone");
+
+    success = _ccnxPortalRTA_ApplyAttributes(&context, &ccnxPortalAttributes_Blocking);
+    assertTrue(success, "Expected the attributes to be applied");
+    assertFalse(fcntl(fds[0], F_GETFL, NULL) & O_NONBLOCK, "Expected the descriptor to be blocking");
+    assertTrue(ccnxPortalAttributes_IsBlocking(context.attributes), "Expected the effective attributes to be blocking");
+
+    ccnxPortalAttributes_Release(&context.attributes);
+    ccnxPortalAttributes_Release(&attributes);
+    close(fds[0]);
+    close(fds[1]);
+}
+
+LONGBOW_TEST_CASE(Static, _ccnxPortalRTA_PinThread)
+{
+#ifdef __linux__
+    cpu_set_t original;
+    assertTrue(pthread_getaffinity_np(pthread_self(), sizeof(original), &original) == 0, "Expected the thread affinity");
+
+    int cpu = 0;
+    while (cpu < CPU_SETSIZE && !CPU_ISSET(cpu, &original)) {
+        cpu++;
+    }
+
+    // Only the addresses of the contexts are used.
+    _CCNxPortalRTAContext pinning;
+    _CCNxPortalRTAContext other;
+
+    _ccnxPortalRTA_PinThread(&pinning, cpu);
+    cpu_set_t actual;
+    pthread_getaffinity_np(pthread_self(), sizeof(actual), &actual);
+    assertTrue(CPU_COUNT(&actual) == 1 && CPU_ISSET(cpu, &actual), "Expected the thread to be pinned to CPU %d", cpu);
+
+    _ccnxPortalRTA_UnpinThread(&other);
+    pthread_getaffinity_np(pthread_self(), sizeof(actual), &actual);
+    assertTrue(CPU_COUNT(&actual) == 1, "Expected a Portal that did not pin the thread to leave it pinned");
+
+    _ccnxPortalRTA_PinThread(&pinning, -1);
+    pthread_getaffinity_np(pthread_self(), sizeof(actual), &actual);
+    assertTrue(CPU_EQUAL(&actual, &original), "Expected clearing the CPU to restore the original affinity");
+    assertNull(_ccnxPortalRTA_PinnedBy, "Expected the thread not to be pinned");
+#endif
+}
+
+LONGBOW_TEST_FIXTURE_OPTIONS(Performance, .enabled = false)
+{
+    LONGBOW_RUN_TEST_CASE(Performance, _ccnxPortalRTA_BusyPoll_PingPong);
+}
+
+LONGBOW_TEST_FIXTURE_SETUP(Performance)
+{
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_FIXTURE_TEARDOWN(Performance)
+{
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+/*
+ * A ping-pong over a socket pair, in which each side waits for the other either by blocking in poll(2)
+ * or by busy-polling first, the way _ccnxPortalRTA_Receive does.
+ */
+typedef struct {
+    int fd;
+    uint64_t busyPollMicroSeconds;
+    int cpu;
+    unsigned int iterations;
+} _PingPongPeer;
+
+static void
+_pingPongWait(const _PingPongPeer *peer)
+{
+    if (peer->busyPollMicroSeconds > 0) {
+        _ccnxPortalRTA_BusyPoll(peer->fd, peer->busyPollMicroSeconds);
+    }
+    struct pollfd pollfd = { .fd = peer->fd, .events = POLLIN };
+    poll(&pollfd, 1, -1);
+}
+
+static void *
+_pingPongEcho(void *arg)
+{
+    const _PingPongPeer *peer = arg;
+    _CCNxPortalRTAContext owner;
+    _ccnxPortalRTA_PinThread(&owner, peer->cpu);
+
+    char byte;
+    for (unsigned int i = 0; i < peer->iterations; i++) {
+        _pingPongWait(peer);
+        if (read(peer->fd, &byte, 1) != 1 || write(peer->fd, &byte, 1) != 1) {
+            break;
+        }
+    }
+    return NULL;
+}
+
+static CCNxPortalHistogram *
+_pingPong(uint64_t busyPollMicroSeconds, unsigned int iterations)
+{
+    int fds[2];
+    assertTrue(socketpair(AF_UNIX, SOCK_STREAM, 0, fds) == 0, "socketpair failed: %s", strerror(errno));
+
+    bool pin = sysconf(_SC_NPROCESSORS_ONLN) >= 2 && busyPollMicroSeconds > 0;
+    _PingPongPeer echo = { .fd = fds[1], .busyPollMicroSeconds = busyPollMicroSeconds, .cpu = pin ? 1 : -1, .iterations = iterations };
+    _PingPongPeer ping = { .fd = fds[0], .busyPollMicroSeconds = busyPollMicroSeconds, .cpu = pin ? 0 : -1, .iterations = iterations };
+
+    pthread_t thread;
+    pthread_create(&thread, NULL, _pingPongEcho, &echo);
+    _CCNxPortalRTAContext owner;
+    _ccnxPortalRTA_PinThread(&owner, ping.cpu);
+
+    CCNxPortalHistogram *result = ccnxPortalHistogram_Create();
+    char byte = 'x';
+    for (unsigned int i = 0; i < iterations; i++) {
+        struct timespec start, end;
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        if (write(ping.fd, &byte, 1) != 1) {
+            break;
+        }
+        _pingPongWait(&ping);
+        if (read(ping.fd, &byte, 1) != 1) {
+            break;
+        }
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        ccnxPortalHistogram_Record(result, (uint64_t) (end.tv_sec - start.tv_sec) * 1000000000ULL + (uint64_t) end.tv_nsec - (uint64_t) start.tv_nsec);
+    }
+
+    pthread_join(thread, NULL);
+    _ccnxPortalRTA_UnpinThread(&owner);
+    close(fds[0]);
+    close(fds[1]);
+    return result;
+}
+
+LONGBOW_TEST_CASE(Performance, _ccnxPortalRTA_BusyPoll_PingPong)
+{
+    const unsigned int iterations = 100000;
+
+    if (sysconf(_SC_NPROCESSORS_ONLN) < 2) {
+        printf("Only one CPU is online: the busy-poll modes will starve the peer thread.\n");
+    }
+    printf("%-12s %10s %10s %10s\n", "mode", "p50 ns", "p99 ns", "p999 ns");
+
+    uint64_t budgets[] = { 0, 10, 100 };
+    for (size_t i = 0; i < sizeof(budgets) / sizeof(budgets[0]); i++) {
+        CCNxPortalHistogram *rtt = _pingPong(budgets[i], iterations);
+
+        char mode[32];
+        if (budgets[i] == 0) {
+            snprintf(mode, sizeof(mode), "blocking");
+        } else {
+            snprintf(mode, sizeof(mode), "spin %" PRIu64 "us", budgets[i]);
+        }
+        printf("%-12s %10" PRIu64 " %10" PRIu64 " %10" PRIu64 "\n", mode,
+               ccnxPortalHistogram_GetValueAtPercentile(rtt, 50.0),
+               ccnxPortalHistogram_GetValueAtPercentile(rtt, 99.0),
+               ccnxPortalHistogram_GetValueAtPercentile(rtt, 99.9));
+
+        ccnxPortalHistogram_Release(&rtt);
+    }
 }
 
 int
@@ -0,0 +1,326 @@
+/*
+ * Copyright (c) 2016, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX OR PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ################################################################################
+ * #
+ * # PATENT NOTICE
+ * #
+ * # This software is distributed under the BSD 2-clause License (see LICENSE
+ * # file).  This BSD License does not make any patent claims and as such, does
+ * # not act as a patent grant.  The purpose of this section is for each contributor
+ * # to define their intentions with respect to intellectual property.
+ * #
+ * # Each contributor to this source code is encouraged to state their patent
+ * # claims and licensing mechanisms for any contributions made. At the end of
+ * # this section contributors may each make their own statements.  Contributor's
+ * # claims and grants only apply to the pieces (source code, programs, text,
+ * # media, etc) that they have contributed directly to this software.
+ * #
+ * # There is no guarantee that this section is complete, up to date or accurate. It
+ * # is up to the contributors to maintain their portion of this section and up to
+ * # the user of the software to verify any claims herein.
+ * #
+ * # Do not remove this header notification.  The contents of this section must be
+ * # present in all distributions of the software.  You may only modify your own
+ * # intellectual property statements.  Please provide contact information.
+ *
+ * - Palo Alto Research Center, Inc
+ * This software distribution does not grant any rights to patents owned by Palo
+ * Alto Research Center, Inc (PARC). Rights to these patents are available via
+ * various mechanisms. As of January 2016 PARC has committed to FRAND licensing any
+ * intellectual property used by its contributions to this software. You may
+ * contact PARC at cipo@parc.com for more information or visit http://www.ccnx.org
+ */
+/**
+ * @copyright (c) 2016, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC).  All rights reserved.
+ */
+#include "../ccnx_PortalReplay.c"
+
+#include <LongBow/unit-test.h>
+#include <LongBow/debugging.h>
+
+#include <stdio.h>
+#include <unistd.h>
+
+#include <parc/algol/parc_Memory.h>
+#include <parc/algol/parc_SafeMemory.h>
+
+#include <parc/security/parc_IdentityFile.h>
+#include <parc/security/parc_Security.h>
+#include <parc/security/parc_Pkcs12KeyStore.h>
+
+#include <ccnx/common/ccnx_Interest.h>
+#include <ccnx/common/ccnx_ContentObject.h>
+
+#define _testTraceFile "test_ccnx_PortalReplay.trace"
+
+LONGBOW_TEST_RUNNER(test_ccnx_PortalReplay)
+{
+    LONGBOW_RUN_TEST_FIXTURE(Global);
+}
+
+LONGBOW_TEST_RUNNER_SETUP(test_ccnx_PortalReplay)
+{
+    parcMemory_SetInterface(&PARCSafeMemoryAsPARCMemory);
+
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_RUNNER_TEARDOWN(test_ccnx_PortalReplay)
+{
+    unlink(_testTraceFile);
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_FIXTURE(Global)
+{
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortalReplay_NoFile);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortalReplay_AsFastAsPossible);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortalReplay_OriginalTiming);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortalReplay_OriginalTiming_Timeout);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortalReplay_Listen);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortalReplay_Flush);
+}
+
+static size_t InitialMemoryOutstanding = 0;
+
+LONGBOW_TEST_FIXTURE_SETUP(Global)
+{
+    InitialMemoryOutstanding = parcMemory_Outstanding();
+
+    parcSecurity_Init();
+
+    bool success = parcPkcs12KeyStore_CreateFile("my_keystore", "my_keystore_password", "test_ccnx_PortalReplay", 1024, 30);
+    assertTrue(success, "parcPkcs12KeyStore_CreateFile('my_keystore', 'my_keystore_password') failed.");
+
+    PARCIdentityFile *identityFile = parcIdentityFile_Create("my_keystore", "my_keystore_password");
+    PARCIdentity *identity = parcIdentity_Create(identityFile, PARCIdentityFileAsPARCIdentity);
+
+    CCNxPortalFactory *factory = ccnxPortalFactory_Create(identity);
+    ccnxPortalFactory_SetProperty(factory, CCNxPortalReplay_File, _testTraceFile);
+    parcIdentityFile_Release(&identityFile);
+    parcIdentity_Release(&identity);
+
+    longBowTestCase_SetClipBoardData(testCase, factory);
+
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_FIXTURE_TEARDOWN(Global)
+{
+    CCNxPortalFactory *factory = longBowTestCase_GetClipBoardData(testCase);
+    ccnxPortalFactory_Release(&factory);
+
+    parcSecurity_Fini();
+
+    if (parcMemory_Outstanding() != InitialMemoryOutstanding) {
+        parcSafeMemory_ReportAllocation(STDOUT_FILENO);
+        printf("('%s' leaks memory by %zd\n",
+               longBowTestCase_GetName(testCase), parcMemory_Outstanding() - InitialMemoryOutstanding);
+        return LONGBOW_STATUS_MEMORYLEAK;
+    }
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+static void
+_appendInterest(CCNxPortalTrace *trace, CCNxPortalTraceDirection direction, uint64_t timestamp, const char *uri)
+{
+    CCNxName *name = ccnxName_CreateFromCString(uri);
+    CCNxInterest *interest = ccnxInterest_CreateSimple(name);
+    CCNxMetaMessage *message = ccnxMetaMessage_CreateFromInterest(interest);
+
+    ccnxPortalTrace_Append(trace, direction, timestamp, message);
+
+    ccnxMetaMessage_Release(&message);
+    ccnxInterest_Release(&interest);
+    ccnxName_Release(&name);
+}
+
+static void
+_appendContentObject(CCNxPortalTrace *trace, uint64_t timestamp, const char *uri)
+{
+    CCNxName *name = ccnxName_CreateFromCString(uri);
+    PARCBuffer *payload = parcBuffer_AllocateCString("anchor response");
+    CCNxContentObject *contentObject = ccnxContentObject_CreateWithNameAndPayload(name, payload);
+    CCNxMetaMessage *message = ccnxMetaMessage_CreateFromContentObject(contentObject);
+
+    ccnxPortalTrace_Append(trace, CCNxPortalTraceDirection_Receive, timestamp, message);
+
+    ccnxMetaMessage_Release(&message);
+    ccnxContentObject_Release(&contentObject);
+    parcBuffer_Release(&payload);
+    ccnxName_Release(&name);
+}
+
+static void
+_assertReceiveInterest(CCNxPortal *portal, const CCNxStackTimeout *timeout, const char *uri)
+{
+    CCNxMetaMessage *message = ccnxPortal_Receive(portal, timeout);
+    assertNotNull(message, "Expected an Interest for %s", uri);
+    assertTrue(ccnxMetaMessage_IsInterest(message), "Expected an Interest for %s", uri);
+
+    CCNxName *expected = ccnxName_CreateFromCString(uri);
+    assertTrue(ccnxName_Equals(expected, ccnxInterest_GetName(ccnxMetaMessage_GetInterest(message))), "Expected the Interest for %s", uri);
+    ccnxName_Release(&expected);
+    ccnxMetaMessage_Release(&message);
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortalReplay_NoFile)
+{
+    CCNxPortalFactory *factory = longBowTestCase_GetClipBoardData(testCase);
+    ccnxPortalFactory_SetProperty(factory, CCNxPortalReplay_File, "/nonexistent/test_ccnx_PortalReplay.trace");
+
+    CCNxPortal *portal = ccnxPortalFactory_CreatePortal(factory, ccnxPortalReplay_AsFastAsPossible);
+    assertNull(portal, "Expected no Portal for a missing trace file.");
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortalReplay_AsFastAsPossible)
+{
+    CCNxPortalFactory *factory = longBowTestCase_GetClipBoardData(testCase);
+
+    uint64_t now = ccnxPortalTrace_Now();
+    CCNxPortalTrace *trace = ccnxPortalTrace_CreateWriter(_testTraceFile);
+    _appendInterest(trace, CCNxPortalTraceDirection_Receive, now, "lci:/replay/1");
+    _appendInterest(trace, CCNxPortalTraceDirection_Send, now + 1000, "lci:/replay/sent");
+    _appendInterest(trace, CCNxPortalTraceDirection_Receive, now + 3600000000000ULL, "lci:/replay/2");
+    ccnxPortalTrace_Release(&trace);
+
+    CCNxPortal *portal = ccnxPortalFactory_CreatePortal(factory, ccnxPortalReplay_AsFastAsPossible);
+    assertNotNull(portal, "Expected a Portal.");
+
+    // The second Interest was recorded an hour after the first.
+    _assertReceiveInterest(portal, CCNxStackTimeout_Immediate, "lci:/replay/1");
+    _assertReceiveInterest(portal, CCNxStackTimeout_Immediate, "lci:/replay/2");
+
+    CCNxMetaMessage *message = ccnxPortal_Receive(portal, CCNxStackTimeout_Never);
+    assertNull(message, "Expected the end of the replay.");
+    assertTrue(ccnxPortal_GetError(portal) == ENODATA, "Expected ENODATA, actual %d", ccnxPortal_GetError(portal));
+
+    ccnxPortal_Release(&portal);
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortalReplay_OriginalTiming)
+{
+    CCNxPortalFactory *factory = longBowTestCase_GetClipBoardData(testCase);
+
+    uint64_t now = ccnxPortalTrace_Now();
+    uint64_t gap = 50000000ULL;
+    CCNxPortalTrace *trace = ccnxPortalTrace_CreateWriter(_testTraceFile);
+    _appendInterest(trace, CCNxPortalTraceDirection_Receive, now, "lci:/replay/1");
+    _appendInterest(trace, CCNxPortalTraceDirection_Receive, now + gap, "lci:/replay/2");
+    ccnxPortalTrace_Release(&trace);
+
+    CCNxPortal *portal = ccnxPortalFactory_CreatePortal(factory, ccnxPortalReplay_OriginalTiming);
+
+    uint64_t start = _ccnxPortalReplay_Monotonic();
+    _assertReceiveInterest(portal, CCNxStackTimeout_Never, "lci:/replay/1");
+    _assertReceiveInterest(portal, CCNxStackTimeout_Never, "lci:/replay/2");
+    uint64_t elapsed = _ccnxPortalReplay_Monotonic() - start;
+
+    assertTrue(elapsed >= gap, "Expected the original %" PRIu64 "ns between messages, actual %" PRIu64 "ns", gap, elapsed);
+
+    ccnxPortal_Release(&portal);
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortalReplay_OriginalTiming_Timeout)
+{
+    CCNxPortalFactory *factory = longBowTestCase_GetClipBoardData(testCase);
+
+    uint64_t now = ccnxPortalTrace_Now();
+    CCNxPortalTrace *trace = ccnxPortalTrace_CreateWriter(_testTraceFile);
+    _appendInterest(trace, CCNxPortalTraceDirection_Receive, now, "lci:/replay/1");
+    _appendInterest(trace, CCNxPortalTraceDirection_Receive, now + 3600000000000ULL, "lci:/replay/2");
+    ccnxPortalTrace_Release(&trace);
+
+    CCNxPortal *portal = ccnxPortalFactory_CreatePortal(factory, ccnxPortalReplay_OriginalTiming);
+
+    _assertReceiveInterest(portal, CCNxStackTimeout_Immediate, "lci:/replay/1");
+
+    CCNxMetaMessage *message = ccnxPortal_Receive(portal, CCNxStackTimeout_MicroSeconds(1000));
+    assertNull(message, "Expected the second Interest not to be due yet.");
+    assertTrue(ccnxPortal_GetError(portal) == EWOULDBLOCK, "Expected EWOULDBLOCK, actual %d", ccnxPortal_GetError(portal));
+
+    ccnxPortal_Release(&portal);
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortalReplay_Listen)
+{
+    CCNxPortalFactory *factory = longBowTestCase_GetClipBoardData(testCase);
+
+    uint64_t now = ccnxPortalTrace_Now();
+    CCNxPortalTrace *trace = ccnxPortalTrace_CreateWriter(_testTraceFile);
+    _appendInterest(trace, CCNxPortalTraceDirection_Send, now, "lci:/local/dcr/anchor");
+    _appendContentObject(trace, now + 1000, "lci:/local/dcr/anchor");
+    _appendInterest(trace, CCNxPortalTraceDirection_Receive, now + 2000, "lci:/replay/1");
+    ccnxPortalTrace_Release(&trace);
+
+    CCNxPortal *portal = ccnxPortalFactory_CreatePortal(factory, ccnxPortalReplay_AsFastAsPossible);
+
+    CCNxName *prefix = ccnxName_CreateFromCString("lci:/replay");
+    assertTrue(ccnxPortal_Listen(portal, prefix, 60, CCNxStackTimeout_Never), "Expected Listen to succeed.");
+    ccnxName_Release(&prefix);
+
+    // The recorded anchor response was consumed by ccnxPortal_Listen.
+    _assertReceiveInterest(portal, CCNxStackTimeout_Never, "lci:/replay/1");
+
+    ccnxPortal_Release(&portal);
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortalReplay_Flush)
+{
+    CCNxPortalFactory *factory = longBowTestCase_GetClipBoardData(testCase);
+
+    uint64_t now = ccnxPortalTrace_Now();
+    CCNxPortalTrace *trace = ccnxPortalTrace_CreateWriter(_testTraceFile);
+    _appendInterest(trace, CCNxPortalTraceDirection_Receive, now, "lci:/replay/1");
+    _appendInterest(trace, CCNxPortalTraceDirection_Receive, now + 1000, "lci:/replay/2");
+    _appendInterest(trace, CCNxPortalTraceDirection_Receive, now + 2000, "lci:/replay/3");
+    ccnxPortalTrace_Release(&trace);
+
+    CCNxPortal *portal = ccnxPortalFactory_CreatePortal(factory, ccnxPortalReplay_AsFastAsPossible);
+    assertNotNull(portal, "Expected a Portal.");
+
+    _assertReceiveInterest(portal, CCNxStackTimeout_Immediate, "lci:/replay/1");
+
+    // The flush is acknowledged without consuming or ending the replay.
+    assertTrue(ccnxPortal_Flush(portal, CCNxStackTimeout_Never), "Expected ccnxPortal_Flush to succeed mid-replay.");
+
+    _assertReceiveInterest(portal, CCNxStackTimeout_Immediate, "lci:/replay/2");
+    _assertReceiveInterest(portal, CCNxStackTimeout_Immediate, "lci:/replay/3");
+
+    CCNxMetaMessage *message = ccnxPortal_Receive(portal, CCNxStackTimeout_Never);
+    assertNull(message, "Expected the end of the replay.");
+    assertTrue(ccnxPortal_GetError(portal) == ENODATA, "Expected ENODATA, actual %d", ccnxPortal_GetError(portal));
+
+    ccnxPortal_Release(&portal);
+}
+
+int
+main(int argc, char *argv[argc])
+{
+    LongBowRunner *testRunner = LONGBOW_TEST_RUNNER_CREATE(test_ccnx_PortalReplay);
+    int exitStatus = longBowMain(argc, argv, testRunner, NULL);
+    longBowTestRunner_Destroy(&testRunner);
+    exit(exitStatus);
+}
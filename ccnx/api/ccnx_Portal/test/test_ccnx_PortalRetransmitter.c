@@ -0,0 +1,409 @@
+/*
+ * Copyright (c) 2016, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX OR PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ################################################################################
+ * #
+ * # PATENT NOTICE
+ * #
+ * # This software is distributed under the BSD 2-clause License (see LICENSE
+ * # file).  This BSD License does not make any patent claims and as such, does
+ * # not act as a patent grant.  The purpose of this section is for each contributor
+ * # to define their intentions with respect to intellectual property.
+ * #
+ * # Each contributor to this source code is encouraged to state their patent
+ * # claims and licensing mechanisms for any contributions made. At the end of
+ * # this section contributors may each make their own statements.  Contributor's
+ * # claims and grants only apply to the pieces (source code, programs, text,
+ * # media, etc) that they have contributed directly to this software.
+ * #
+ * # There is no guarantee that this section is complete, up to date or accurate. It
+ * # is up to the contributors to maintain their portion of this section and up to
+ * # the user of the software to verify any claims herein.
+ * #
+ * # Do not remove this header notification.  The contents of this section must be
+ * # present in all distributions of the software.  You may only modify your own
+ * # intellectual property statements.  Please provide contact information.
+ *
+ * - Palo Alto Research Center, Inc
+ * This software distribution does not grant any rights to patents owned by Palo
+ * Alto Research Center, Inc (PARC). Rights to these patents are available via
+ * various mechanisms. As of January 2016 PARC has committed to FRAND licensing any
+ * intellectual property used by its contributions to this software. You may
+ * contact PARC at cipo@parc.com for more information or visit http://www.ccnx.org
+ */
+/**
+ * @copyright (c) 2016, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC).  All rights reserved.
+ */
+#include "../ccnx_PortalRetransmitter.c"
+
+#include <LongBow/unit-test.h>
+#include <LongBow/debugging.h>
+
+#include <inttypes.h>
+#include <stdio.h>
+
+#include <parc/algol/parc_Memory.h>
+#include <parc/algol/parc_SafeMemory.h>
+#include <parc/testing/parc_ObjectTesting.h>
+
+#include <ccnx/api/ccnx_Portal/ccnx_PortalInterestTemplate.h>
+
+#include <ccnx/common/ccnx_Interest.h>
+
+LONGBOW_TEST_RUNNER(test_ccnx_PortalRetransmitter)
+{
+    LONGBOW_RUN_TEST_FIXTURE(Global);
+}
+
+LONGBOW_TEST_RUNNER_SETUP(test_ccnx_PortalRetransmitter)
+{
+    parcMemory_SetInterface(&PARCSafeMemoryAsPARCMemory);
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_RUNNER_TEARDOWN(test_ccnx_PortalRetransmitter)
+{
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_FIXTURE(Global)
+{
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortalRetransmitter_CreateAcquireRelease);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortalRetransmitter_Create_Invalid);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortalRetransmitter_Match_Sample);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortalRetransmitter_Match_Unknown);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortalRetransmitter_Cancel);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortalRetransmitter_Track_Full);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortalRetransmitter_Track_Again);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortalRetransmitter_Track_WireFormat);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortalRetransmitter_Expire);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortalRetransmitter_Expire_Lost);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortalRetransmitter_Expire_Capacity);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortalRetransmitter_Remove_Many);
+}
+
+static size_t InitialMemoryOutstanding = 0;
+
+LONGBOW_TEST_FIXTURE_SETUP(Global)
+{
+    InitialMemoryOutstanding = parcMemory_Outstanding();
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_FIXTURE_TEARDOWN(Global)
+{
+    if (parcMemory_Outstanding() != InitialMemoryOutstanding) {
+        parcSafeMemory_ReportAllocation(STDOUT_FILENO);
+        printf("('%s' leaks memory by %zd\n",
+               longBowTestCase_GetName(testCase), parcMemory_Outstanding() - InitialMemoryOutstanding);
+        return LONGBOW_STATUS_MEMORYLEAK;
+    }
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+static CCNxMetaMessage *
+_createInterestMessage(const char *uri)
+{
+    CCNxName *name = ccnxName_CreateFromCString(uri);
+    CCNxInterest *interest = ccnxInterest_CreateSimple(name);
+    CCNxMetaMessage *result = ccnxMetaMessage_CreateFromInterest(interest);
+    ccnxInterest_Release(&interest);
+    ccnxName_Release(&name);
+    return result;
+}
+
+// A retransmitter whose RTO starts at 1000 microseconds and doubles up to 8000.
+static CCNxPortalRetransmitter *
+_createRetransmitter(unsigned int maxRetransmissions, size_t capacity)
+{
+    CCNxPortalRttEstimator *estimator = ccnxPortalRttEstimator_Create(0);
+    ccnxPortalRttEstimator_SetBounds(estimator, 1000, 1000, 8000);
+    CCNxPortalRetransmitter *result = ccnxPortalRetransmitter_Create(estimator, maxRetransmissions, capacity);
+    ccnxPortalRttEstimator_Release(&estimator);
+    return result;
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortalRetransmitter_CreateAcquireRelease)
+{
+    CCNxPortalRetransmitter *retransmitter = _createRetransmitter(3, 16);
+    assertNotNull(retransmitter, "Expected a non-null retransmitter");
+    assertTrue(ccnxPortalRetransmitter_GetPending(retransmitter) == 0, "Expected no pending Interests");
+    assertTrue(ccnxPortalRetransmitter_GetNextDeadline(retransmitter) == UINT64_MAX, "Expected no deadline");
+    assertNotNull(ccnxPortalRetransmitter_GetRttEstimator(retransmitter), "Expected an estimator");
+
+    parcObjectTesting_AssertAcquireReleaseContract(ccnxPortalRetransmitter_Acquire, retransmitter);
+
+    ccnxPortalRetransmitter_Release(&retransmitter);
+    assertNull(retransmitter, "Expected ccnxPortalRetransmitter_Release to null the pointer");
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortalRetransmitter_Create_Invalid)
+{
+    CCNxPortalRttEstimator *estimator = ccnxPortalRttEstimator_Create(0);
+
+    errno = 0;
+    assertNull(ccnxPortalRetransmitter_Create(estimator, 3, 0), "Expected NULL for no capacity");
+    assertTrue(errno == EINVAL, "Expected EINVAL, actual %d", errno);
+
+    ccnxPortalRttEstimator_Release(&estimator);
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortalRetransmitter_Match_Sample)
+{
+    CCNxPortalRetransmitter *retransmitter = _createRetransmitter(3, 16);
+    CCNxMetaMessage *message = _createInterestMessage("lci:/Hello/World/1");
+    const CCNxName *name = ccnxInterest_GetName(ccnxMetaMessage_GetInterest(message));
+
+    assertTrue(ccnxPortalRetransmitter_Track(retransmitter, message, 10000), "Expected the Interest to be tracked");
+    assertTrue(ccnxPortalRetransmitter_GetPending(retransmitter) == 1, "Expected 1 pending Interest");
+    assertTrue(ccnxPortalRetransmitter_GetNextDeadline(retransmitter) == 11000,
+               "Expected a deadline of the send time plus the initial RTO, actual %" PRIu64, ccnxPortalRetransmitter_GetNextDeadline(retransmitter));
+
+    assertTrue(ccnxPortalRetransmitter_Match(retransmitter, name, 10500), "Expected the Content Object to match");
+    assertTrue(ccnxPortalRetransmitter_GetPending(retransmitter) == 0, "Expected no pending Interests");
+
+    CCNxPortalRttEstimate estimate;
+    assertTrue(ccnxPortalRttEstimator_GetEstimate(ccnxPortalRetransmitter_GetRttEstimator(retransmitter), name, &estimate),
+               "Expected the round trip to be measured");
+    assertTrue(estimate.smoothedRtt == 500, "Expected SRTT 500, actual %" PRIu64, estimate.smoothedRtt);
+
+    ccnxMetaMessage_Release(&message);
+    ccnxPortalRetransmitter_Release(&retransmitter);
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortalRetransmitter_Match_Unknown)
+{
+    CCNxPortalRetransmitter *retransmitter = _createRetransmitter(3, 16);
+    CCNxName *name = ccnxName_CreateFromCString("lci:/Hello/World/1");
+
+    assertFalse(ccnxPortalRetransmitter_Match(retransmitter, name, 0), "Expected an untracked name not to match");
+
+    ccnxName_Release(&name);
+    ccnxPortalRetransmitter_Release(&retransmitter);
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortalRetransmitter_Cancel)
+{
+    CCNxPortalRetransmitter *retransmitter = _createRetransmitter(3, 16);
+    CCNxMetaMessage *message = _createInterestMessage("lci:/Hello/World/1");
+    const CCNxName *name = ccnxInterest_GetName(ccnxMetaMessage_GetInterest(message));
+
+    ccnxPortalRetransmitter_Track(retransmitter, message, 0);
+    assertTrue(ccnxPortalRetransmitter_Cancel(retransmitter, name), "Expected the Interest to be cancelled");
+    assertTrue(ccnxPortalRetransmitter_GetPending(retransmitter) == 0, "Expected no pending Interests");
+
+    CCNxPortalRttEstimate estimate;
+    assertFalse(ccnxPortalRttEstimator_GetEstimate(ccnxPortalRetransmitter_GetRttEstimator(retransmitter), name, &estimate),
+                "Expected a cancelled Interest not to be measured");
+
+    ccnxMetaMessage_Release(&message);
+    ccnxPortalRetransmitter_Release(&retransmitter);
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortalRetransmitter_Track_Full)
+{
+    CCNxPortalRetransmitter *retransmitter = _createRetransmitter(3, 2);
+    CCNxMetaMessage *messages[3] = {
+        _createInterestMessage("lci:/Hello/World/1"),
+        _createInterestMessage("lci:/Hello/World/2"),
+        _createInterestMessage("lci:/Hello/World/3"),
+    };
+
+    assertTrue(ccnxPortalRetransmitter_Track(retransmitter, messages[0], 0), "Expected the first Interest to be tracked");
+    assertTrue(ccnxPortalRetransmitter_Track(retransmitter, messages[1], 0), "Expected the second Interest to be tracked");
+    assertFalse(ccnxPortalRetransmitter_Track(retransmitter, messages[2], 0), "Expected a full retransmitter to refuse an Interest");
+    assertTrue(ccnxPortalRetransmitter_GetUntracked(retransmitter) == 1,
+               "Expected 1 untracked Interest, actual %" PRIu64, ccnxPortalRetransmitter_GetUntracked(retransmitter));
+
+    for (int i = 0; i < 3; i++) {
+        ccnxMetaMessage_Release(&messages[i]);
+    }
+    ccnxPortalRetransmitter_Release(&retransmitter);
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortalRetransmitter_Track_Again)
+{
+    CCNxPortalRetransmitter *retransmitter = _createRetransmitter(3, 16);
+    CCNxMetaMessage *message = _createInterestMessage("lci:/Hello/World/1");
+    const CCNxName *name = ccnxInterest_GetName(ccnxMetaMessage_GetInterest(message));
+
+    ccnxPortalRetransmitter_Track(retransmitter, message, 0);
+    ccnxPortalRetransmitter_Track(retransmitter, message, 100);
+    assertTrue(ccnxPortalRetransmitter_GetPending(retransmitter) == 1, "Expected an Interest sent twice to be tracked once");
+
+    ccnxPortalRetransmitter_Match(retransmitter, name, 200);
+
+    CCNxPortalRttEstimate estimate;
+    assertFalse(ccnxPortalRttEstimator_GetEstimate(ccnxPortalRetransmitter_GetRttEstimator(retransmitter), name, &estimate),
+                "Expected an ambiguous round trip not to be measured");
+
+    ccnxMetaMessage_Release(&message);
+    ccnxPortalRetransmitter_Release(&retransmitter);
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortalRetransmitter_Track_WireFormat)
+{
+    CCNxPortalRetransmitter *retransmitter = _createRetransmitter(3, 16);
+    CCNxName *name = ccnxName_CreateFromCString("lci:/Hello/World/chunk=0");
+    CCNxInterest *interest = ccnxInterest_CreateSimple(name);
+    CCNxPortalInterestTemplate *template = ccnxPortalInterestTemplate_Create(interest);
+    CCNxMetaMessage *message = ccnxPortalInterestTemplate_CreateMessageWithNumber(template, 1);
+
+    assertFalse(ccnxPortalRetransmitter_Track(retransmitter, message, 0), "Expected an Interest without a decoded name not to be tracked");
+    assertTrue(ccnxPortalRetransmitter_GetPending(retransmitter) == 0, "Expected no pending Interests");
+    assertTrue(ccnxPortalRetransmitter_GetUntracked(retransmitter) == 1,
+               "Expected 1 untracked Interest, actual %" PRIu64, ccnxPortalRetransmitter_GetUntracked(retransmitter));
+
+    ccnxMetaMessage_Release(&message);
+    ccnxPortalInterestTemplate_Release(&template);
+    ccnxInterest_Release(&interest);
+    ccnxName_Release(&name);
+    ccnxPortalRetransmitter_Release(&retransmitter);
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortalRetransmitter_Expire)
+{
+    CCNxPortalRetransmitter *retransmitter = _createRetransmitter(3, 16);
+    CCNxMetaMessage *message = _createInterestMessage("lci:/Hello/World/1");
+    const CCNxName *name = ccnxInterest_GetName(ccnxMetaMessage_GetInterest(message));
+    CCNxMetaMessage *resend[4];
+
+    ccnxPortalRetransmitter_Track(retransmitter, message, 0);
+
+    size_t count = ccnxPortalRetransmitter_Expire(retransmitter, 999, resend, 4);
+    assertTrue(count == 0, "Expected nothing to expire before the deadline, actual %zu", count);
+
+    count = ccnxPortalRetransmitter_Expire(retransmitter, 1000, resend, 4);
+    assertTrue(count == 1, "Expected the Interest to expire at the deadline, actual %zu", count);
+    assertTrue(resend[0] == message, "Expected the tracked Interest to be returned");
+    ccnxMetaMessage_Release(&resend[0]);
+
+    assertTrue(ccnxPortalRetransmitter_GetRetransmissions(retransmitter) == 1, "Expected 1 retransmission");
+    assertTrue(ccnxPortalRetransmitter_GetNextDeadline(retransmitter) == 3000,
+               "Expected the backed off RTO to set the next deadline, actual %" PRIu64, ccnxPortalRetransmitter_GetNextDeadline(retransmitter));
+
+    ccnxPortalRetransmitter_Match(retransmitter, name, 1500);
+
+    CCNxPortalRttEstimate estimate;
+    ccnxPortalRttEstimator_GetEstimate(ccnxPortalRetransmitter_GetRttEstimator(retransmitter), name, &estimate);
+    assertTrue(estimate.samples == 0, "Expected a retransmitted Interest not to be measured, actual %" PRIu64, estimate.samples);
+    assertTrue(estimate.timeouts == 1, "Expected 1 timeout, actual %" PRIu64, estimate.timeouts);
+
+    ccnxMetaMessage_Release(&message);
+    ccnxPortalRetransmitter_Release(&retransmitter);
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortalRetransmitter_Expire_Lost)
+{
+    CCNxPortalRetransmitter *retransmitter = _createRetransmitter(1, 16);
+    CCNxMetaMessage *message = _createInterestMessage("lci:/Hello/World/1");
+    CCNxMetaMessage *resend[4];
+
+    ccnxPortalRetransmitter_Track(retransmitter, message, 0);
+
+    size_t count = ccnxPortalRetransmitter_Expire(retransmitter, 1000, resend, 4);
+    assertTrue(count == 1, "Expected 1 retransmission, actual %zu", count);
+    ccnxMetaMessage_Release(&resend[0]);
+
+    count = ccnxPortalRetransmitter_Expire(retransmitter, 3000, resend, 4);
+    assertTrue(count == 0, "Expected no more retransmissions, actual %zu", count);
+    assertTrue(ccnxPortalRetransmitter_GetLost(retransmitter) == 1, "Expected the Interest to be given up");
+    assertTrue(ccnxPortalRetransmitter_GetPending(retransmitter) == 0, "Expected no pending Interests");
+    assertTrue(ccnxPortalRetransmitter_GetNextDeadline(retransmitter) == UINT64_MAX, "Expected no deadline");
+
+    ccnxMetaMessage_Release(&message);
+    ccnxPortalRetransmitter_Release(&retransmitter);
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortalRetransmitter_Expire_Capacity)
+{
+    CCNxPortalRetransmitter *retransmitter = _createRetransmitter(3, 16);
+    CCNxMetaMessage *messages[5];
+    CCNxMetaMessage *resend[2];
+
+    for (int i = 0; i < 5; i++) {
+        char uri[64];
+        snprintf(uri, sizeof(uri), "lci:/Hello/World/%d", i);
+        messages[i] = _createInterestMessage(uri);
+        ccnxPortalRetransmitter_Track(retransmitter, messages[i], 0);
+    }
+
+    size_t total = 0;
+    size_t count;
+    while ((count = ccnxPortalRetransmitter_Expire(retransmitter, 1000, resend, 2)) > 0) {
+        assertTrue(count <= 2, "Expected no more than the capacity, actual %zu", count);
+        for (size_t i = 0; i < count; i++) {
+            ccnxMetaMessage_Release(&resend[i]);
+        }
+        total += count;
+    }
+    assertTrue(total == 5, "Expected every expired Interest once, actual %zu", total);
+    assertTrue(ccnxPortalRetransmitter_GetNextDeadline(retransmitter) > 1000, "Expected every deadline to move on");
+
+    for (int i = 0; i < 5; i++) {
+        ccnxMetaMessage_Release(&messages[i]);
+    }
+    ccnxPortalRetransmitter_Release(&retransmitter);
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortalRetransmitter_Remove_Many)
+{
+    CCNxPortalRetransmitter *retransmitter = _createRetransmitter(3, 64);
+    CCNxMetaMessage *messages[64];
+
+    for (int i = 0; i < 64; i++) {
+        char uri[64];
+        snprintf(uri, sizeof(uri), "lci:/Hello/World/%d", i);
+        messages[i] = _createInterestMessage(uri);
+        assertTrue(ccnxPortalRetransmitter_Track(retransmitter, messages[i], 0), "Expected Interest %d to be tracked", i);
+    }
+
+    for (int i = 1; i < 64; i += 2) {
+        const CCNxName *name = ccnxInterest_GetName(ccnxMetaMessage_GetInterest(messages[i]));
+        assertTrue(ccnxPortalRetransmitter_Cancel(retransmitter, name), "Expected Interest %d to be cancelled", i);
+    }
+    assertTrue(ccnxPortalRetransmitter_GetPending(retransmitter) == 32,
+               "Expected 32 pending Interests, actual %zu", ccnxPortalRetransmitter_GetPending(retransmitter));
+
+    for (int i = 0; i < 64; i++) {
+        const CCNxName *name = ccnxInterest_GetName(ccnxMetaMessage_GetInterest(messages[i]));
+        bool matched = ccnxPortalRetransmitter_Match(retransmitter, name, 10);
+        assertTrue(matched == (i % 2 == 0), "Expected Interest %d %s", i, (i % 2 == 0) ? "to match" : "not to match");
+    }
+    assertTrue(ccnxPortalRetransmitter_GetPending(retransmitter) == 0, "Expected no pending Interests");
+
+    for (int i = 0; i < 64; i++) {
+        ccnxMetaMessage_Release(&messages[i]);
+    }
+    ccnxPortalRetransmitter_Release(&retransmitter);
+}
+
+int
+main(int argc, char *argv[argc])
+{
+    LongBowRunner *testRunner = LONGBOW_TEST_RUNNER_CREATE(test_ccnx_PortalRetransmitter);
+    int exitStatus = longBowMain(argc, argv, testRunner, NULL);
+    longBowTestRunner_Destroy(&testRunner);
+    exit(exitStatus);
+}
@@ -0,0 +1,394 @@
+/*
+ * Copyright (c) 2016, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX OR PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ################################################################################
+ * #
+ * # PATENT NOTICE
+ * #
+ * # This software is distributed under the BSD 2-clause License (see LICENSE
+ * # file).  This BSD License does not make any patent claims and as such, does
+ * # not act as a patent grant.  The purpose of this section is for each contributor
+ * # to define their intentions with respect to intellectual property.
+ * #
+ * # Each contributor to this source code is encouraged to state their patent
+ * # claims and licensing mechanisms for any contributions made. At the end of
+ * # this section contributors may each make their own statements.  Contributor's
+ * # claims and grants only apply to the pieces (source code, programs, text,
+ * # media, etc) that they have contributed directly to this software.
+ * #
+ * # There is no guarantee that this section is complete, up to date or accurate. It
+ * # is up to the contributors to maintain their portion of this section and up to
+ * # the user of the software to verify any claims herein.
+ * #
+ * # Do not remove this header notification.  The contents of this section must be
+ * # present in all distributions of the software.  You may only modify your own
+ * # intellectual property statements.  Please provide contact information.
+ *
+ * - Palo Alto Research Center, Inc
+ * This software distribution does not grant any rights to patents owned by Palo
+ * Alto Research Center, Inc (PARC). Rights to these patents are available via
+ * various mechanisms. As of January 2016 PARC has committed to FRAND licensing any
+ * intellectual property used by its contributions to this software. You may
+ * contact PARC at cipo@parc.com for more information or visit http://www.ccnx.org
+ */
+/**
+ * @copyright (c) 2016, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC).  All rights reserved.
+ */
+#include "../ccnx_PortalRttEstimator.c"
+
+#include <LongBow/unit-test.h>
+#include <LongBow/debugging.h>
+
+#include <inttypes.h>
+#include <stdio.h>
+
+#include <parc/algol/parc_Memory.h>
+#include <parc/algol/parc_SafeMemory.h>
+#include <parc/testing/parc_ObjectTesting.h>
+
+LONGBOW_TEST_RUNNER(test_ccnx_PortalRttEstimator)
+{
+    LONGBOW_RUN_TEST_FIXTURE(Global);
+}
+
+LONGBOW_TEST_RUNNER_SETUP(test_ccnx_PortalRttEstimator)
+{
+    parcMemory_SetInterface(&PARCSafeMemoryAsPARCMemory);
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_RUNNER_TEARDOWN(test_ccnx_PortalRttEstimator)
+{
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_FIXTURE(Global)
+{
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortalRttEstimator_CreateAcquireRelease);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortalRttEstimator_SetBounds_Invalid);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortalRttEstimator_GetTimeout_Unknown);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortalRttEstimator_AddSample);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortalRttEstimator_AddSample_Minimum);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortalRttEstimator_Backoff);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortalRttEstimator_Prefixes);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortalRttEstimator_Grow);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortalRttEstimator_MaxPrefixes);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortalRttEstimator_SetMaxPrefixes);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortalRttEstimator_ToJSON);
+}
+
+static size_t InitialMemoryOutstanding = 0;
+
+LONGBOW_TEST_FIXTURE_SETUP(Global)
+{
+    InitialMemoryOutstanding = parcMemory_Outstanding();
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_FIXTURE_TEARDOWN(Global)
+{
+    if (parcMemory_Outstanding() != InitialMemoryOutstanding) {
+        parcSafeMemory_ReportAllocation(STDOUT_FILENO);
+        printf("('%s' leaks memory by %zd\n",
+               longBowTestCase_GetName(testCase), parcMemory_Outstanding() - InitialMemoryOutstanding);
+        return LONGBOW_STATUS_MEMORYLEAK;
+    }
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortalRttEstimator_CreateAcquireRelease)
+{
+    CCNxPortalRttEstimator *estimator = ccnxPortalRttEstimator_Create(0);
+    assertNotNull(estimator, "Expected a non-null estimator");
+    assertTrue(ccnxPortalRttEstimator_GetCount(estimator) == 0, "Expected no prefixes");
+
+    parcObjectTesting_AssertAcquireReleaseContract(ccnxPortalRttEstimator_Acquire, estimator);
+
+    ccnxPortalRttEstimator_Release(&estimator);
+    assertNull(estimator, "Expected ccnxPortalRttEstimator_Release to null the pointer");
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortalRttEstimator_SetBounds_Invalid)
+{
+    CCNxPortalRttEstimator *estimator = ccnxPortalRttEstimator_Create(0);
+
+    errno = 0;
+    assertFalse(ccnxPortalRttEstimator_SetBounds(estimator, 1000, 0, 2000), "Expected a zero minimum to be refused");
+    assertTrue(errno == EINVAL, "Expected EINVAL, actual %d", errno);
+
+    errno = 0;
+    assertFalse(ccnxPortalRttEstimator_SetBounds(estimator, 3000, 1000, 2000), "Expected an initial timeout above the maximum to be refused");
+    assertTrue(errno == EINVAL, "Expected EINVAL, actual %d", errno);
+
+    assertTrue(ccnxPortalRttEstimator_SetBounds(estimator, 1000, 1000, 1000), "Expected equal bounds to be accepted");
+
+    ccnxPortalRttEstimator_Release(&estimator);
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortalRttEstimator_GetTimeout_Unknown)
+{
+    CCNxPortalRttEstimator *estimator = ccnxPortalRttEstimator_Create(0);
+    CCNxName *name = ccnxName_CreateFromCString("lci:/Hello/World/1");
+
+    uint64_t timeout = ccnxPortalRttEstimator_GetTimeout(estimator, name);
+    assertTrue(timeout == CCNxPortalRttEstimator_DefaultInitialTimeout, "Expected the initial timeout, actual %" PRIu64, timeout);
+
+    CCNxPortalRttEstimate estimate;
+    assertFalse(ccnxPortalRttEstimator_GetEstimate(estimator, name, &estimate), "Expected no estimate for an unknown prefix");
+    assertTrue(ccnxPortalRttEstimator_GetCount(estimator) == 0, "Expected looking up a prefix not to add it");
+
+    ccnxName_Release(&name);
+    ccnxPortalRttEstimator_Release(&estimator);
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortalRttEstimator_AddSample)
+{
+    CCNxPortalRttEstimator *estimator = ccnxPortalRttEstimator_Create(0);
+    CCNxName *name = ccnxName_CreateFromCString("lci:/Hello/World/1");
+    CCNxPortalRttEstimate estimate;
+
+    // The first sample sets SRTT to R and RTTVAR to R/2.
+    ccnxPortalRttEstimator_AddSample(estimator, name, 100000);
+    assertTrue(ccnxPortalRttEstimator_GetEstimate(estimator, name, &estimate), "Expected an estimate");
+    assertTrue(estimate.smoothedRtt == 100000, "Expected SRTT 100000, actual %" PRIu64, estimate.smoothedRtt);
+    assertTrue(estimate.rttVariation == 50000, "Expected RTTVAR 50000, actual %" PRIu64, estimate.rttVariation);
+    assertTrue(estimate.retransmissionTimeout == 300000, "Expected RTO 300000, actual %" PRIu64, estimate.retransmissionTimeout);
+
+    // RTTVAR = 3/4 * 50000 + 1/4 * |100000 - 200000|, SRTT = 7/8 * 100000 + 1/8 * 200000.
+    ccnxPortalRttEstimator_AddSample(estimator, name, 200000);
+    assertTrue(ccnxPortalRttEstimator_GetEstimate(estimator, name, &estimate), "Expected an estimate");
+    assertTrue(estimate.smoothedRtt == 112500, "Expected SRTT 112500, actual %" PRIu64, estimate.smoothedRtt);
+    assertTrue(estimate.rttVariation == 62500, "Expected RTTVAR 62500, actual %" PRIu64, estimate.rttVariation);
+    assertTrue(estimate.retransmissionTimeout == 362500, "Expected RTO 362500, actual %" PRIu64, estimate.retransmissionTimeout);
+    assertTrue(estimate.samples == 2, "Expected 2 samples, actual %" PRIu64, estimate.samples);
+
+    uint64_t timeout = ccnxPortalRttEstimator_GetTimeout(estimator, name);
+    assertTrue(timeout == 362500, "Expected the timeout to be the RTO, actual %" PRIu64, timeout);
+
+    ccnxName_Release(&name);
+    ccnxPortalRttEstimator_Release(&estimator);
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortalRttEstimator_AddSample_Minimum)
+{
+    CCNxPortalRttEstimator *estimator = ccnxPortalRttEstimator_Create(0);
+    CCNxName *name = ccnxName_CreateFromCString("lci:/Hello/World/1");
+
+    ccnxPortalRttEstimator_AddSample(estimator, name, 1000);
+    uint64_t timeout = ccnxPortalRttEstimator_GetTimeout(estimator, name);
+    assertTrue(timeout == CCNxPortalRttEstimator_DefaultMinimumTimeout, "Expected the minimum timeout, actual %" PRIu64, timeout);
+
+    ccnxPortalRttEstimator_SetBounds(estimator, 1000, 100, 1000000);
+    ccnxPortalRttEstimator_AddSample(estimator, name, 1000);
+    timeout = ccnxPortalRttEstimator_GetTimeout(estimator, name);
+    assertTrue(timeout < 10000, "Expected a lower minimum to allow a shorter timeout, actual %" PRIu64, timeout);
+
+    ccnxName_Release(&name);
+    ccnxPortalRttEstimator_Release(&estimator);
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortalRttEstimator_Backoff)
+{
+    CCNxPortalRttEstimator *estimator = ccnxPortalRttEstimator_Create(0);
+    ccnxPortalRttEstimator_SetBounds(estimator, 1000000, 200000, 4000000);
+    CCNxName *name = ccnxName_CreateFromCString("lci:/Hello/World/1");
+    CCNxPortalRttEstimate estimate;
+
+    ccnxPortalRttEstimator_Backoff(estimator, name);
+    assertTrue(ccnxPortalRttEstimator_GetTimeout(estimator, name) == 2000000, "Expected a timeout to double the initial RTO");
+    ccnxPortalRttEstimator_Backoff(estimator, name);
+    ccnxPortalRttEstimator_Backoff(estimator, name);
+    assertTrue(ccnxPortalRttEstimator_GetTimeout(estimator, name) == 4000000, "Expected backoff to stop at the maximum");
+
+    assertTrue(ccnxPortalRttEstimator_GetEstimate(estimator, name, &estimate), "Expected an estimate");
+    assertTrue(estimate.timeouts == 3, "Expected 3 timeouts, actual %" PRIu64, estimate.timeouts);
+    assertTrue(estimate.samples == 0, "Expected no samples, actual %" PRIu64, estimate.samples);
+
+    ccnxPortalRttEstimator_AddSample(estimator, name, 100000);
+    assertTrue(ccnxPortalRttEstimator_GetTimeout(estimator, name) == 300000, "Expected a sample to undo the backoff");
+
+    ccnxName_Release(&name);
+    ccnxPortalRttEstimator_Release(&estimator);
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortalRttEstimator_Prefixes)
+{
+    CCNxName *chunk1 = ccnxName_CreateFromCString("lci:/Hello/World/1");
+    CCNxName *chunk2 = ccnxName_CreateFromCString("lci:/Hello/World/2");
+    CCNxName *other = ccnxName_CreateFromCString("lci:/Hello/There/1");
+
+    // By default, every segment but the last names the prefix.
+    CCNxPortalRttEstimator *estimator = ccnxPortalRttEstimator_Create(0);
+    ccnxPortalRttEstimator_AddSample(estimator, chunk1, 100000);
+    assertTrue(ccnxPortalRttEstimator_GetTimeout(estimator, chunk2) == 300000, "Expected the chunks of an object to share an estimate");
+    assertTrue(ccnxPortalRttEstimator_GetTimeout(estimator, other) == CCNxPortalRttEstimator_DefaultInitialTimeout,
+               "Expected another object to have its own estimate");
+    assertTrue(ccnxPortalRttEstimator_GetCount(estimator) == 1, "Expected 1 prefix, actual %zu", ccnxPortalRttEstimator_GetCount(estimator));
+    ccnxPortalRttEstimator_Release(&estimator);
+
+    estimator = ccnxPortalRttEstimator_Create(1);
+    ccnxPortalRttEstimator_AddSample(estimator, chunk1, 100000);
+    assertTrue(ccnxPortalRttEstimator_GetTimeout(estimator, other) == 300000, "Expected names under a one segment prefix to share an estimate");
+    ccnxPortalRttEstimator_Release(&estimator);
+
+    ccnxName_Release(&other);
+    ccnxName_Release(&chunk2);
+    ccnxName_Release(&chunk1);
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortalRttEstimator_Grow)
+{
+    CCNxPortalRttEstimator *estimator = ccnxPortalRttEstimator_Create(0);
+
+    for (int i = 0; i < 100; i++) {
+        char uri[64];
+        snprintf(uri, sizeof(uri), "lci:/Hello/%d/chunk", i);
+        CCNxName *name = ccnxName_CreateFromCString(uri);
+        ccnxPortalRttEstimator_AddSample(estimator, name, 100000 + i);
+        ccnxName_Release(&name);
+    }
+    assertTrue(ccnxPortalRttEstimator_GetCount(estimator) == 100, "Expected 100 prefixes, actual %zu", ccnxPortalRttEstimator_GetCount(estimator));
+
+    for (int i = 0; i < 100; i++) {
+        char uri[64];
+        snprintf(uri, sizeof(uri), "lci:/Hello/%d/chunk", i);
+        CCNxName *name = ccnxName_CreateFromCString(uri);
+        CCNxPortalRttEstimate estimate;
+        assertTrue(ccnxPortalRttEstimator_GetEstimate(estimator, name, &estimate), "Expected an estimate for %s", uri);
+        assertTrue(estimate.smoothedRtt == (uint64_t) (100000 + i), "Expected SRTT %d, actual %" PRIu64, 100000 + i, estimate.smoothedRtt);
+        ccnxName_Release(&name);
+    }
+
+    ccnxPortalRttEstimator_Release(&estimator);
+}
+
+static void
+_addSample(CCNxPortalRttEstimator *estimator, int object, uint64_t rtt)
+{
+    char uri[64];
+    snprintf(uri, sizeof(uri), "lci:/Hello/%d/chunk", object);
+    CCNxName *name = ccnxName_CreateFromCString(uri);
+    ccnxPortalRttEstimator_AddSample(estimator, name, rtt);
+    ccnxName_Release(&name);
+}
+
+static bool
+_hasEstimate(const CCNxPortalRttEstimator *estimator, int object, CCNxPortalRttEstimate *estimate)
+{
+    char uri[64];
+    snprintf(uri, sizeof(uri), "lci:/Hello/%d/chunk", object);
+    CCNxName *name = ccnxName_CreateFromCString(uri);
+    bool result = ccnxPortalRttEstimator_GetEstimate(estimator, name, estimate);
+    ccnxName_Release(&name);
+    return result;
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortalRttEstimator_MaxPrefixes)
+{
+    CCNxPortalRttEstimator *estimator = ccnxPortalRttEstimator_Create(0);
+    assertTrue(ccnxPortalRttEstimator_SetMaxPrefixes(estimator, 64), "Expected the maximum to be set");
+
+    // One prefix per object, as a consumer fetching many objects makes, several times the maximum.
+    for (int i = 0; i < 1000; i++) {
+        _addSample(estimator, i, 100000 + i);
+
+        // Keep object 0 in use, so that it is never the least recently used.
+        _addSample(estimator, 0, 100000);
+    }
+
+    size_t count = ccnxPortalRttEstimator_GetCount(estimator);
+    assertTrue(count == 64, "Expected the table to stay at the maximum of 64 prefixes, actual %zu", count);
+    uint64_t evictions = ccnxPortalRttEstimator_GetEvictions(estimator);
+    assertTrue(evictions == 1000 - 64, "Expected %d evictions, actual %" PRIu64, 1000 - 64, evictions);
+
+    CCNxPortalRttEstimate estimate;
+    assertTrue(_hasEstimate(estimator, 0, &estimate), "Expected the prefix in use to be kept");
+    assertFalse(_hasEstimate(estimator, 1, &estimate), "Expected the least recently used prefix to be forgotten");
+
+    // The most recent prefixes are all still found after the entries moved by the evictions.
+    for (int i = 1000 - 63; i < 1000; i++) {
+        assertTrue(_hasEstimate(estimator, i, &estimate), "Expected a recent prefix %d to be kept", i);
+        assertTrue(estimate.smoothedRtt == (uint64_t) (100000 + i), "Expected SRTT %d, actual %" PRIu64, 100000 + i, estimate.smoothedRtt);
+    }
+
+    ccnxPortalRttEstimator_Release(&estimator);
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortalRttEstimator_SetMaxPrefixes)
+{
+    CCNxPortalRttEstimator *estimator = ccnxPortalRttEstimator_Create(0);
+
+    assertFalse(ccnxPortalRttEstimator_SetMaxPrefixes(estimator, 0), "Expected a maximum of 0 to be rejected");
+    assertTrue(errno == EINVAL, "Expected EINVAL, actual %d", errno);
+
+    for (int i = 0; i < 10; i++) {
+        _addSample(estimator, i, 100000 + i);
+    }
+
+    assertTrue(ccnxPortalRttEstimator_SetMaxPrefixes(estimator, 4), "Expected the maximum to be set");
+    assertTrue(ccnxPortalRttEstimator_GetCount(estimator) == 4, "Expected lowering the maximum to forget prefixes, actual %zu",
+               ccnxPortalRttEstimator_GetCount(estimator));
+
+    CCNxPortalRttEstimate estimate;
+    for (int i = 0; i < 10; i++) {
+        assertTrue(_hasEstimate(estimator, i, &estimate) == (i >= 6), "Expected only the 4 most recent prefixes to be kept, not %d", i);
+    }
+
+    ccnxPortalRttEstimator_Release(&estimator);
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortalRttEstimator_ToJSON)
+{
+    CCNxPortalRttEstimator *estimator = ccnxPortalRttEstimator_Create(0);
+    CCNxName *name = ccnxName_CreateFromCString("lci:/Hello/World/1");
+    CCNxName *prefix = ccnxName_CreateFromCString("lci:/Hello/World");
+
+    ccnxPortalRttEstimator_AddSample(estimator, name, 100000);
+
+    PARCJSON *json = ccnxPortalRttEstimator_ToJSON(estimator);
+    assertNotNull(json, "Expected a non-null JSON object");
+
+    char *uri = ccnxName_ToString(prefix);
+    PARCJSONValue *value = parcJSON_GetValueByName(json, uri);
+    assertNotNull(value, "Expected an entry for %s", uri);
+
+    PARCJSON *entry = parcJSONValue_GetJSON(value);
+    int64_t srtt = parcJSONValue_GetInteger(parcJSON_GetValueByName(entry, "srtt"));
+    assertTrue(srtt == 100000, "Expected srtt 100000, actual %" PRId64, srtt);
+
+    parcMemory_Deallocate(&uri);
+    parcJSON_Release(&json);
+    ccnxName_Release(&prefix);
+    ccnxName_Release(&name);
+    ccnxPortalRttEstimator_Release(&estimator);
+}
+
+int
+main(int argc, char *argv[argc])
+{
+    LongBowRunner *testRunner = LONGBOW_TEST_RUNNER_CREATE(test_ccnx_PortalRttEstimator);
+    int exitStatus = longBowMain(argc, argv, testRunner, NULL);
+    longBowTestRunner_Destroy(&testRunner);
+    exit(exitStatus);
+}
@@ -0,0 +1,620 @@
+/*
+ * Copyright (c) 2016, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX OR PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ################################################################################
+ * #
+ * # PATENT NOTICE
+ * #
+ * # This software is distributed under the BSD 2-clause License (see LICENSE
+ * # file).  This BSD License does not make any patent claims and as such, does
+ * # not act as a patent grant.  The purpose of this section is for each contributor
+ * # to define their intentions with respect to intellectual property.
+ * #
+ * # Each contributor to this source code is encouraged to state their patent
+ * # claims and licensing mechanisms for any contributions made. At the end of
+ * # this section contributors may each make their own statements.  Contributor's
+ * # claims and grants only apply to the pieces (source code, programs, text,
+ * # media, etc) that they have contributed directly to this software.
+ * #
+ * # There is no guarantee that this section is complete, up to date or accurate. It
+ * # is up to the contributors to maintain their portion of this section and up to
+ * # the user of the software to verify any claims herein.
+ * #
+ * # Do not remove this header notification.  The contents of this section must be
+ * # present in all distributions of the software.  You may only modify your own
+ * # intellectual property statements.  Please provide contact information.
+ *
+ * - Palo Alto Research Center, Inc
+ * This software distribution does not grant any rights to patents owned by Palo
+ * Alto Research Center, Inc (PARC). Rights to these patents are available via
+ * various mechanisms. As of January 2016 PARC has committed to FRAND licensing any
+ * intellectual property used by its contributions to this software. You may
+ * contact PARC at cipo@parc.com for more information or visit http://www.ccnx.org
+ */
+/**
+ * @copyright (c) 2016, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC).  All rights reserved.
+ */
+#include "../ccnx_PortalServer.c"
+
+#include <LongBow/unit-test.h>
+#include <LongBow/debugging.h>
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <unistd.h>
+
+#include <ccnx/api/ccnx_Portal/ccnx_PortalAPI.h>
+
+#include <parc/algol/parc_Memory.h>
+#include <parc/algol/parc_SafeMemory.h>
+#include <parc/testing/parc_ObjectTesting.h>
+
+#include <parc/security/parc_IdentityFile.h>
+#include <parc/security/parc_Security.h>
+#include <parc/security/parc_Pkcs12KeyStore.h>
+
+#include <ccnx/common/ccnx_ContentObject.h>
+
+LONGBOW_TEST_RUNNER(test_ccnx_PortalServer)
+{
+    LONGBOW_RUN_TEST_FIXTURE(Global);
+}
+
+LONGBOW_TEST_RUNNER_SETUP(test_ccnx_PortalServer)
+{
+    parcMemory_SetInterface(&PARCSafeMemoryAsPARCMemory);
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_RUNNER_TEARDOWN(test_ccnx_PortalServer)
+{
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_FIXTURE(Global)
+{
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortalServer_CreateAcquireRelease);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortalServer_Register);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortalServer_Register_Replace);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortalServer_Unregister);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortalServer_Unregister_NotRegistered);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortalServer_Release_Ignores);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortalServer_Dispatch_LongestPrefix);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortalServer_Dispatch_Root);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortalServer_Dispatch_NotInterest);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortalServer_Dispatch_Response);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortalServer_Run_Stop);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortalServer_Run_ReceiveTimeout);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortalServer_Run_Idle);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortalServer_Dispatch_Executor);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortalServer_Release_SendsExecutorReplies);
+}
+
+static size_t InitialMemoryOutstanding = 0;
+
+LONGBOW_TEST_FIXTURE_SETUP(Global)
+{
+    InitialMemoryOutstanding = parcMemory_Outstanding();
+
+    parcSecurity_Init();
+
+    bool success = parcPkcs12KeyStore_CreateFile("my_keystore", "my_keystore_password", "test_ccnx_PortalServer", 1024, 30);
+    assertTrue(success, "parcPkcs12KeyStore_CreateFile('my_keystore', 'my_keystore_password') failed.");
+
+    PARCIdentityFile *identityFile = parcIdentityFile_Create("my_keystore", "my_keystore_password");
+    PARCIdentity *identity = parcIdentity_Create(identityFile, PARCIdentityFileAsPARCIdentity);
+
+    CCNxPortalFactory *factory = ccnxPortalFactory_Create(identity);
+    parcIdentityFile_Release(&identityFile);
+    parcIdentity_Release(&identity);
+
+    longBowTestCase_SetClipBoardData(testCase, factory);
+
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_FIXTURE_TEARDOWN(Global)
+{
+    CCNxPortalFactory *factory = longBowTestCase_GetClipBoardData(testCase);
+    ccnxPortalFactory_Release(&factory);
+
+    parcSecurity_Fini();
+
+    if (parcMemory_Outstanding() != InitialMemoryOutstanding) {
+        parcSafeMemory_ReportAllocation(STDOUT_FILENO);
+        printf("('%s' leaks memory by %zd\n",
+               longBowTestCase_GetName(testCase), parcMemory_Outstanding() - InitialMemoryOutstanding);
+        return LONGBOW_STATUS_MEMORYLEAK;
+    }
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+/*
+ * Each handler counts its calls in its context, which also says whether it stops the server and whether it responds.
+ */
+typedef struct {
+    int calls;
+    bool stop;
+    bool respond;
+} _TestHandlerContext;
+
+static CCNxMetaMessage *
+_testHandler(CCNxPortalServer *server, const CCNxName *prefix, const CCNxInterest *interest, void *context)
+{
+    _TestHandlerContext *handler = context;
+    handler->calls++;
+
+    if (handler->stop) {
+        ccnxPortalServer_Stop(server);
+    }
+
+    CCNxMetaMessage *result = NULL;
+    if (handler->respond) {
+        PARCBuffer *payload = parcBuffer_WrapCString("response");
+        CCNxContentObject *contentObject = ccnxContentObject_CreateWithNameAndPayload(ccnxInterest_GetName(interest), payload);
+        result = ccnxMetaMessage_CreateFromContentObject(contentObject);
+        ccnxContentObject_Release(&contentObject);
+        parcBuffer_Release(&payload);
+    }
+    return result;
+}
+
+static bool
+_register(CCNxPortalServer *server, const char *uri, _TestHandlerContext *context)
+{
+    CCNxName *prefix = ccnxName_CreateFromCString(uri);
+    bool result = ccnxPortalServer_Register(server, prefix, _testHandler, context);
+    ccnxName_Release(&prefix);
+    return result;
+}
+
+static bool
+_dispatchInterest(CCNxPortalServer *server, const char *uri)
+{
+    CCNxName *name = ccnxName_CreateFromCString(uri);
+    CCNxInterest *interest = ccnxInterest_CreateSimple(name);
+    CCNxMetaMessage *message = ccnxMetaMessage_CreateFromInterest(interest);
+
+    bool result = ccnxPortalServer_Dispatch(server, message);
+
+    ccnxMetaMessage_Release(&message);
+    ccnxInterest_Release(&interest);
+    ccnxName_Release(&name);
+    return result;
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortalServer_CreateAcquireRelease)
+{
+    CCNxPortalFactory *factory = longBowTestCase_GetClipBoardData(testCase);
+    CCNxPortal *portal = ccnxPortalFactory_CreatePortal(factory, ccnxPortalAPI_LoopBack);
+
+    CCNxPortalServer *server = ccnxPortalServer_Create(portal);
+    assertNotNull(server, "Expected a non-null server");
+    assertTrue(ccnxPortalServer_GetPortal(server) == portal, "Expected the given Portal");
+    assertTrue(ccnxPortalServer_GetCount(server) == 0, "Expected no registered prefixes");
+
+    parcObjectTesting_AssertAcquireReleaseContract(ccnxPortalServer_Acquire, server);
+
+    ccnxPortalServer_Release(&server);
+    assertNull(server, "Expected ccnxPortalServer_Release to null the pointer");
+    ccnxPortal_Release(&portal);
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortalServer_Register)
+{
+    CCNxPortalFactory *factory = longBowTestCase_GetClipBoardData(testCase);
+    CCNxPortal *portal = ccnxPortalFactory_CreatePortal(factory, ccnxPortalAPI_LoopBack);
+    CCNxPortalServer *server = ccnxPortalServer_Create(portal);
+    _TestHandlerContext a = { 0 };
+
+    assertTrue(_register(server, "lci:/server/a", &a), "Expected the registration to succeed");
+    assertTrue(_register(server, "lci:/server/a/b", &a), "Expected the registration to succeed");
+    assertTrue(ccnxPortalServer_GetCount(server) == 2, "Expected 2 prefixes, actual %zu", ccnxPortalServer_GetCount(server));
+
+    assertTrue(ccnxPortalAnchorRegistry_Size(ccnxPortal_GetAnchors(portal)) == 2, "Expected the Portal to listen for both prefixes");
+
+    ccnxPortalServer_Release(&server);
+    ccnxPortal_Release(&portal);
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortalServer_Register_Replace)
+{
+    CCNxPortalFactory *factory = longBowTestCase_GetClipBoardData(testCase);
+    CCNxPortal *portal = ccnxPortalFactory_CreatePortal(factory, ccnxPortalAPI_LoopBack);
+    CCNxPortalServer *server = ccnxPortalServer_Create(portal);
+    _TestHandlerContext a = { 0 };
+    _TestHandlerContext b = { 0 };
+
+    _register(server, "lci:/server/a", &a);
+    _register(server, "lci:/server/a", &b);
+    assertTrue(ccnxPortalServer_GetCount(server) == 1, "Expected 1 prefix, actual %zu", ccnxPortalServer_GetCount(server));
+
+    _dispatchInterest(server, "lci:/server/a/1");
+    assertTrue(a.calls == 0 && b.calls == 1, "Expected the replacement handler to be called, actual %d and %d", a.calls, b.calls);
+
+    ccnxPortalServer_Release(&server);
+    ccnxPortal_Release(&portal);
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortalServer_Unregister)
+{
+    CCNxPortalFactory *factory = longBowTestCase_GetClipBoardData(testCase);
+    CCNxPortal *portal = ccnxPortalFactory_CreatePortal(factory, ccnxPortalAPI_LoopBack);
+    CCNxPortalServer *server = ccnxPortalServer_Create(portal);
+    _TestHandlerContext a = { 0 };
+    _TestHandlerContext b = { 0 };
+
+    _register(server, "lci:/server/a", &a);
+    _register(server, "lci:/server/a/b/c", &b);
+
+    CCNxName *prefix = ccnxName_CreateFromCString("lci:/server/a/b/c");
+    assertTrue(ccnxPortalServer_Unregister(server, prefix), "Expected the prefix to be unregistered");
+    ccnxName_Release(&prefix);
+
+    assertTrue(ccnxPortalServer_GetCount(server) == 1, "Expected 1 prefix, actual %zu", ccnxPortalServer_GetCount(server));
+    assertTrue(ccnxPortalAnchorRegistry_Size(ccnxPortal_GetAnchors(portal)) == 1, "Expected the Portal to ignore the prefix");
+
+    // Interests under the removed prefix fall back to the shorter one.
+    _dispatchInterest(server, "lci:/server/a/b/c/1");
+    assertTrue(a.calls == 1 && b.calls == 0, "Expected the shorter prefix's handler, actual %d and %d", a.calls, b.calls);
+
+    ccnxPortalServer_Release(&server);
+    ccnxPortal_Release(&portal);
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortalServer_Unregister_NotRegistered)
+{
+    CCNxPortalFactory *factory = longBowTestCase_GetClipBoardData(testCase);
+    CCNxPortal *portal = ccnxPortalFactory_CreatePortal(factory, ccnxPortalAPI_LoopBack);
+    CCNxPortalServer *server = ccnxPortalServer_Create(portal);
+    _TestHandlerContext a = { 0 };
+
+    _register(server, "lci:/server/a/b", &a);
+
+    // An interior node of the tree is not a registered prefix.
+    CCNxName *prefix = ccnxName_CreateFromCString("lci:/server/a");
+    assertFalse(ccnxPortalServer_Unregister(server, prefix), "Expected false for a prefix without a handler");
+    ccnxName_Release(&prefix);
+
+    assertTrue(ccnxPortalServer_GetCount(server) == 1, "Expected 1 prefix, actual %zu", ccnxPortalServer_GetCount(server));
+
+    ccnxPortalServer_Release(&server);
+    ccnxPortal_Release(&portal);
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortalServer_Release_Ignores)
+{
+    CCNxPortalFactory *factory = longBowTestCase_GetClipBoardData(testCase);
+    CCNxPortal *portal = ccnxPortalFactory_CreatePortal(factory, ccnxPortalAPI_LoopBack);
+    CCNxPortalServer *server = ccnxPortalServer_Create(portal);
+    _TestHandlerContext a = { 0 };
+
+    _register(server, "lci:/server/a", &a);
+    _register(server, "lci:/server/b", &a);
+    _register(server, "lci:/server/b/c", &a);
+
+    ccnxPortalServer_Release(&server);
+    assertTrue(ccnxPortalAnchorRegistry_Size(ccnxPortal_GetAnchors(portal)) == 0, "Expected every prefix to be ignored");
+
+    ccnxPortal_Release(&portal);
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortalServer_Dispatch_LongestPrefix)
+{
+    CCNxPortalFactory *factory = longBowTestCase_GetClipBoardData(testCase);
+    CCNxPortal *portal = ccnxPortalFactory_CreatePortal(factory, ccnxPortalAPI_LoopBack);
+    CCNxPortalServer *server = ccnxPortalServer_Create(portal);
+    _TestHandlerContext a = { 0 };
+    _TestHandlerContext b = { 0 };
+
+    _register(server, "lci:/server/a", &a);
+    _register(server, "lci:/server/a/b", &b);
+
+    assertTrue(_dispatchInterest(server, "lci:/server/a/b/c"), "Expected the Interest to be dispatched");
+    assertTrue(b.calls == 1 && a.calls == 0, "Expected the longer prefix's handler, actual %d and %d", a.calls, b.calls);
+
+    assertTrue(_dispatchInterest(server, "lci:/server/a/x"), "Expected the Interest to be dispatched");
+    assertTrue(a.calls == 1, "Expected the shorter prefix's handler, actual %d", a.calls);
+
+    assertTrue(_dispatchInterest(server, "lci:/server/a"), "Expected the Interest to be dispatched");
+    assertTrue(a.calls == 2, "Expected an exact match to be dispatched, actual %d", a.calls);
+
+    assertFalse(_dispatchInterest(server, "lci:/server"), "Expected no handler for a name shorter than every prefix");
+    assertFalse(_dispatchInterest(server, "lci:/other/a/b"), "Expected no handler for an unregistered name");
+    assertTrue(a.calls == 2 && b.calls == 1, "Expected no more calls, actual %d and %d", a.calls, b.calls);
+
+    ccnxPortalServer_Release(&server);
+    ccnxPortal_Release(&portal);
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortalServer_Dispatch_Root)
+{
+    CCNxPortalFactory *factory = longBowTestCase_GetClipBoardData(testCase);
+    CCNxPortal *portal = ccnxPortalFactory_CreatePortal(factory, ccnxPortalAPI_LoopBack);
+    CCNxPortalServer *server = ccnxPortalServer_Create(portal);
+    _TestHandlerContext root = { 0 };
+
+    _register(server, "lci:/", &root);
+
+    assertTrue(_dispatchInterest(server, "lci:/anything/at/all"), "Expected the root prefix to match every name");
+    assertTrue(root.calls == 1, "Expected the root handler, actual %d", root.calls);
+
+    ccnxPortalServer_Release(&server);
+    ccnxPortal_Release(&portal);
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortalServer_Dispatch_NotInterest)
+{
+    CCNxPortalFactory *factory = longBowTestCase_GetClipBoardData(testCase);
+    CCNxPortal *portal = ccnxPortalFactory_CreatePortal(factory, ccnxPortalAPI_LoopBack);
+    CCNxPortalServer *server = ccnxPortalServer_Create(portal);
+    _TestHandlerContext a = { 0 };
+
+    _register(server, "lci:/server/a", &a);
+
+    CCNxName *name = ccnxName_CreateFromCString("lci:/server/a/1");
+    PARCBuffer *payload = parcBuffer_WrapCString("payload");
+    CCNxContentObject *contentObject = ccnxContentObject_CreateWithNameAndPayload(name, payload);
+    CCNxMetaMessage *message = ccnxMetaMessage_CreateFromContentObject(contentObject);
+
+    assertFalse(ccnxPortalServer_Dispatch(server, message), "Expected a Content Object not to be dispatched");
+    assertTrue(a.calls == 0, "Expected no handler call, actual %d", a.calls);
+
+    ccnxMetaMessage_Release(&message);
+    ccnxContentObject_Release(&contentObject);
+    parcBuffer_Release(&payload);
+    ccnxName_Release(&name);
+    ccnxPortalServer_Release(&server);
+    ccnxPortal_Release(&portal);
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortalServer_Dispatch_Response)
+{
+    CCNxPortalFactory *factory = longBowTestCase_GetClipBoardData(testCase);
+    CCNxPortal *portal = ccnxPortalFactory_CreatePortal(factory, ccnxPortalAPI_LoopBack);
+    CCNxPortalServer *server = ccnxPortalServer_Create(portal);
+    _TestHandlerContext a = { .respond = true };
+
+    _register(server, "lci:/server/a", &a);
+    _dispatchInterest(server, "lci:/server/a/1");
+
+    // The loopback stack returns the response the server sent.
+    CCNxMetaMessage *response = ccnxPortal_Receive(portal, CCNxStackTimeout_Immediate);
+    assertNotNull(response, "Expected the handler's response to be sent");
+    assertTrue(ccnxMetaMessage_IsContentObject(response), "Expected a Content Object");
+    ccnxMetaMessage_Release(&response);
+
+    ccnxPortalServer_Release(&server);
+    ccnxPortal_Release(&portal);
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortalServer_Run_Stop)
+{
+    CCNxPortalFactory *factory = longBowTestCase_GetClipBoardData(testCase);
+    CCNxPortal *portal = ccnxPortalFactory_CreatePortal(factory, ccnxPortalAPI_LoopBack);
+    CCNxPortalServer *server = ccnxPortalServer_Create(portal);
+    _TestHandlerContext a = { .stop = true };
+
+    _register(server, "lci:/server/a", &a);
+
+    CCNxName *name = ccnxName_CreateFromCString("lci:/server/a/1");
+    CCNxInterest *interest = ccnxInterest_CreateSimple(name);
+    CCNxMetaMessage *message = ccnxMetaMessage_CreateFromInterest(interest);
+    ccnxPortal_Send(portal, message, CCNxStackTimeout_Never);
+
+    assertTrue(ccnxPortalServer_Run(server), "Expected the server to return because it was stopped");
+    assertTrue(a.calls == 1, "Expected the handler to be called once, actual %d", a.calls);
+
+    ccnxMetaMessage_Release(&message);
+    ccnxInterest_Release(&interest);
+    ccnxName_Release(&name);
+    ccnxPortalServer_Release(&server);
+    ccnxPortal_Release(&portal);
+}
+
+/*
+ * A stack that never has a message to receive, and returns from each receive at once with the given error:
+ * ENOMSG, as the RTA stack reports a timeout, or none at all.
+ * Its third receive stops the server.
+ */
+typedef struct {
+    CCNxPortalServer *server;
+    int error;
+    int receives;
+} _TimeoutStackState;
+
+static void
+_timeoutStackStartStop(void *privateData)
+{
+}
+
+static CCNxMetaMessage *
+_timeoutStackReceive(void *privateData, const CCNxStackTimeout *microSeconds)
+{
+    _TimeoutStackState *state = privateData;
+    if (++state->receives == 3 && state->server != NULL) {
+        ccnxPortalServer_Stop(state->server);
+    }
+    errno = state->error;
+    return NULL;
+}
+
+static bool
+_timeoutStackSend(void *privateData, const CCNxMetaMessage *message, const CCNxStackTimeout *microSeconds)
+{
+    return true;
+}
+
+static bool
+_timeoutStackListen(void *privateData, const CCNxName *name, const CCNxStackTimeout *microSeconds)
+{
+    return true;
+}
+
+static int
+_timeoutStackGetFileId(void *privateData)
+{
+    return -1;
+}
+
+static bool
+_timeoutStackSetAttributes(void *privateData, const CCNxPortalAttributes *attributes)
+{
+    return true;
+}
+
+static CCNxPortalAttributes *
+_timeoutStackGetAttributes(void *privateData)
+{
+    return NULL;
+}
+
+static CCNxPortal *
+_createTimeoutPortal(CCNxPortalFactory *factory, _TimeoutStackState *state)
+{
+    CCNxPortalStack *stack = ccnxPortalStack_Create(factory, NULL,
+                                                    _timeoutStackStartStop, _timeoutStackStartStop,
+                                                    _timeoutStackReceive, _timeoutStackSend,
+                                                    _timeoutStackListen, _timeoutStackListen,
+                                                    _timeoutStackGetFileId,
+                                                    _timeoutStackSetAttributes, _timeoutStackGetAttributes,
+                                                    state, parcMemory_DeallocateImpl);
+    return ccnxPortal_Create(NULL, stack);
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortalServer_Run_ReceiveTimeout)
+{
+    CCNxPortalFactory *factory = longBowTestCase_GetClipBoardData(testCase);
+    _TimeoutStackState *state = parcMemory_AllocateAndClear(sizeof(_TimeoutStackState));
+    state->error = ENOMSG;
+    CCNxPortal *portal = _createTimeoutPortal(factory, state);
+    CCNxPortalServer *server = ccnxPortalServer_Create(portal);
+    state->server = server;
+
+    assertTrue(ccnxPortalServer_Run(server), "Expected receives that time out with ENOMSG not to stop the server");
+    assertTrue(state->receives == 3, "Expected the server to poll until stopped, actual %d receives", state->receives);
+    assertTrue(ccnxPortal_IsTimeout(portal), "Expected ENOMSG to be reported as a timeout");
+
+    state->server = NULL;
+    ccnxPortalServer_Release(&server);
+    ccnxPortal_Release(&portal);
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortalServer_Run_Idle)
+{
+    CCNxPortalFactory *factory = longBowTestCase_GetClipBoardData(testCase);
+    _TimeoutStackState *state = parcMemory_AllocateAndClear(sizeof(_TimeoutStackState));
+    CCNxPortal *portal = _createTimeoutPortal(factory, state);
+    CCNxPortalServer *server = ccnxPortalServer_Create(portal);
+    state->server = server;
+
+    // A stop requested while the server is not running does not stop the next run.
+    ccnxPortalServer_Stop(server);
+
+    uint64_t start = ccnxPortalStatistics_Now();
+    assertTrue(ccnxPortalServer_Run(server), "Expected receives that return nothing, and no error, not to stop the server");
+    uint64_t elapsed = (ccnxPortalStatistics_Now() - start) / 1000;
+
+    assertTrue(state->receives == 3, "Expected the server to poll until stopped, actual %d receives", state->receives);
+    assertTrue(elapsed >= 2 * _ccnxPortalServer_ReceiveMicroSeconds,
+               "Expected the server to wait out each receive rather than spin, actual %" PRIu64 " microseconds", elapsed);
+
+    state->server = NULL;
+    ccnxPortalServer_Release(&server);
+    ccnxPortal_Release(&portal);
+}
+
+static size_t
+_receiveContentObjects(CCNxPortal *portal)
+{
+    size_t result = 0;
+    CCNxMetaMessage *message;
+    while ((message = ccnxPortal_Receive(portal, CCNxStackTimeout_Immediate)) != NULL) {
+        if (ccnxMetaMessage_IsContentObject(message)) {
+            result++;
+        }
+        ccnxMetaMessage_Release(&message);
+    }
+    return result;
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortalServer_Dispatch_Executor)
+{
+    CCNxPortalFactory *factory = longBowTestCase_GetClipBoardData(testCase);
+    CCNxPortal *portal = ccnxPortalFactory_CreatePortal(factory, ccnxPortalAPI_LoopBack);
+    CCNxPortalServer *server = ccnxPortalServer_Create(portal);
+
+    // One worker, so the handler's unsynchronised count is safe.
+    CCNxPortalExecutor *executor = ccnxPortalExecutor_Create(1, 16);
+    ccnxPortalServer_SetExecutor(server, executor);
+    _TestHandlerContext a = { .respond = true };
+
+    _register(server, "lci:/server/a", &a);
+    for (int i = 0; i < 3; i++) {
+        assertTrue(_dispatchInterest(server, "lci:/server/a/1"), "Expected the Interest to be queued");
+    }
+    ccnxPortalExecutor_Wait(executor);
+    assertTrue(a.calls == 3, "Expected 3 handler calls, actual %d", a.calls);
+
+    // The responses wait for the server to send them.
+    assertTrue(_receiveContentObjects(portal) == 0, "Expected no response before the replies are sent");
+    size_t sent = ccnxPortalServer_SendReplies(server);
+    assertTrue(sent == 3, "Expected 3 replies sent, actual %zu", sent);
+    assertTrue(_receiveContentObjects(portal) == 3, "Expected the 3 responses");
+    assertTrue(ccnxPortalServer_SendReplies(server) == 0, "Expected no more replies");
+
+    ccnxPortalExecutor_Release(&executor);
+    ccnxPortalServer_Release(&server);
+    ccnxPortal_Release(&portal);
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortalServer_Release_SendsExecutorReplies)
+{
+    CCNxPortalFactory *factory = longBowTestCase_GetClipBoardData(testCase);
+    CCNxPortal *portal = ccnxPortalFactory_CreatePortal(factory, ccnxPortalAPI_LoopBack);
+    CCNxPortalServer *server = ccnxPortalServer_Create(portal);
+
+    CCNxPortalExecutor *executor = ccnxPortalExecutor_Create(1, 16);
+    ccnxPortalServer_SetExecutor(server, executor);
+    ccnxPortalExecutor_Release(&executor);
+    _TestHandlerContext a = { .respond = true };
+
+    _register(server, "lci:/server/a", &a);
+    _dispatchInterest(server, "lci:/server/a/1");
+    _dispatchInterest(server, "lci:/server/a/2");
+
+    ccnxPortalServer_Release(&server);
+    assertTrue(_receiveContentObjects(portal) == 2, "Expected the release to wait for and send both responses");
+
+    ccnxPortal_Release(&portal);
+}
+
+int
+main(int argc, char *argv[argc])
+{
+    LongBowRunner *testRunner = LONGBOW_TEST_RUNNER_CREATE(test_ccnx_PortalServer);
+    int exitStatus = longBowMain(argc, argv, testRunner, NULL);
+    longBowTestRunner_Destroy(&testRunner);
+    exit(exitStatus);
+}
@@ -0,0 +1,330 @@
+/*
+ * Copyright (c) 2016, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX OR PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ################################################################################
+ * #
+ * # PATENT NOTICE
+ * #
+ * # This software is distributed under the BSD 2-clause License (see LICENSE
+ * # file).  This BSD License does not make any patent claims and as such, does
+ * # not act as a patent grant.  The purpose of this section is for each contributor
+ * # to define their intentions with respect to intellectual property.
+ * #
+ * # Each contributor to this source code is encouraged to state their patent
+ * # claims and licensing mechanisms for any contributions made. At the end of
+ * # this section contributors may each make their own statements.  Contributor's
+ * # claims and grants only apply to the pieces (source code, programs, text,
+ * # media, etc) that they have contributed directly to this software.
+ * #
+ * # There is no guarantee that this section is complete, up to date or accurate. It
+ * # is up to the contributors to maintain their portion of this section and up to
+ * # the user of the software to verify any claims herein.
+ * #
+ * # Do not remove this header notification.  The contents of this section must be
+ * # present in all distributions of the software.  You may only modify your own
+ * # intellectual property statements.  Please provide contact information.
+ *
+ * - Palo Alto Research Center, Inc
+ * This software distribution does not grant any rights to patents owned by Palo
+ * Alto Research Center, Inc (PARC). Rights to these patents are available via
+ * various mechanisms. As of January 2016 PARC has committed to FRAND licensing any
+ * intellectual property used by its contributions to this software. You may
+ * contact PARC at cipo@parc.com for more information or visit http://www.ccnx.org
+ */
+/**
+ * @copyright (c) 2016, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC).  All rights reserved.
+ */
+#include "../ccnx_PortalShards.c"
+
+#include <LongBow/unit-test.h>
+#include <LongBow/debugging.h>
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <unistd.h>
+
+#include <ccnx/api/ccnx_Portal/ccnx_PortalAPI.h>
+
+#include <parc/algol/parc_Memory.h>
+#include <parc/algol/parc_SafeMemory.h>
+#include <parc/testing/parc_ObjectTesting.h>
+
+#include <parc/security/parc_IdentityFile.h>
+#include <parc/security/parc_Security.h>
+#include <parc/security/parc_Pkcs12KeyStore.h>
+
+LONGBOW_TEST_RUNNER(test_ccnx_PortalShards)
+{
+    LONGBOW_RUN_TEST_FIXTURE(Global);
+}
+
+LONGBOW_TEST_RUNNER_SETUP(test_ccnx_PortalShards)
+{
+    parcMemory_SetInterface(&PARCSafeMemoryAsPARCMemory);
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_RUNNER_TEARDOWN(test_ccnx_PortalShards)
+{
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_FIXTURE(Global)
+{
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortalShards_CreateAcquireRelease);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortalShards_Create_OnePerCpu);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortalShards_Register);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortalShards_Register_Running);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortalShards_Unregister);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortalShards_StartStop);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortalShards_CreateStatistics);
+}
+
+static size_t InitialMemoryOutstanding = 0;
+
+LONGBOW_TEST_FIXTURE_SETUP(Global)
+{
+    InitialMemoryOutstanding = parcMemory_Outstanding();
+
+    parcSecurity_Init();
+
+    bool success = parcPkcs12KeyStore_CreateFile("my_keystore", "my_keystore_password", "test_ccnx_PortalShards", 1024, 30);
+    assertTrue(success, "parcPkcs12KeyStore_CreateFile('my_keystore', 'my_keystore_password') failed.");
+
+    PARCIdentityFile *identityFile = parcIdentityFile_Create("my_keystore", "my_keystore_password");
+    PARCIdentity *identity = parcIdentity_Create(identityFile, PARCIdentityFileAsPARCIdentity);
+
+    CCNxPortalFactory *factory = ccnxPortalFactory_Create(identity);
+    parcIdentityFile_Release(&identityFile);
+    parcIdentity_Release(&identity);
+
+    longBowTestCase_SetClipBoardData(testCase, factory);
+
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_FIXTURE_TEARDOWN(Global)
+{
+    CCNxPortalFactory *factory = longBowTestCase_GetClipBoardData(testCase);
+    ccnxPortalFactory_Release(&factory);
+
+    parcSecurity_Fini();
+
+    if (parcMemory_Outstanding() != InitialMemoryOutstanding) {
+        parcSafeMemory_ReportAllocation(STDOUT_FILENO);
+        printf("('%s' leaks memory by %zd\n",
+               longBowTestCase_GetName(testCase), parcMemory_Outstanding() - InitialMemoryOutstanding);
+        return LONGBOW_STATUS_MEMORYLEAK;
+    }
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+// The most the test waits for the shards' threads, in milliseconds.
+#define _TestPatienceMilliseconds 5000
+
+/*
+ * Handlers run on every shard's thread at once, so the count is atomic.
+ */
+static CCNxMetaMessage *
+_testHandler(CCNxPortalServer *server, const CCNxName *prefix, const CCNxInterest *interest, void *context)
+{
+    int *calls = context;
+    __atomic_add_fetch(calls, 1, __ATOMIC_ACQ_REL);
+    return NULL;
+}
+
+static bool
+_register(CCNxPortalShards *shards, const char *uri, int *calls)
+{
+    CCNxName *prefix = ccnxName_CreateFromCString(uri);
+    bool result = ccnxPortalShards_Register(shards, prefix, _testHandler, calls);
+    ccnxName_Release(&prefix);
+    return result;
+}
+
+/*
+ * Send an Interest through each shard's loopback Portal, which the shard then receives itself.
+ */
+static void
+_sendToEachShard(CCNxPortalShards *shards, const char *uri)
+{
+    CCNxName *name = ccnxName_CreateFromCString(uri);
+    CCNxInterest *interest = ccnxInterest_CreateSimple(name);
+    CCNxMetaMessage *message = ccnxMetaMessage_CreateFromInterest(interest);
+
+    for (size_t i = 0; i < ccnxPortalShards_GetCount(shards); i++) {
+        ccnxPortal_Send(ccnxPortalShards_GetPortal(shards, i), message, CCNxStackTimeout_Never);
+    }
+
+    ccnxMetaMessage_Release(&message);
+    ccnxInterest_Release(&interest);
+    ccnxName_Release(&name);
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortalShards_CreateAcquireRelease)
+{
+    CCNxPortalFactory *factory = longBowTestCase_GetClipBoardData(testCase);
+
+    CCNxPortalShards *shards = ccnxPortalShards_Create(factory, ccnxPortalAPI_LoopBack, 3);
+    assertNotNull(shards, "Expected a non-null instance");
+    assertTrue(ccnxPortalShards_GetCount(shards) == 3, "Expected 3 shards, actual %zu", ccnxPortalShards_GetCount(shards));
+    assertFalse(ccnxPortalShards_IsRunning(shards), "Expected new shards to be stopped");
+
+    for (size_t i = 0; i < 3; i++) {
+        assertNotNull(ccnxPortalShards_GetPortal(shards, i), "Expected shard %zu to have a Portal", i);
+        assertTrue(ccnxPortalServer_GetPortal(ccnxPortalShards_GetServer(shards, i)) == ccnxPortalShards_GetPortal(shards, i),
+                   "Expected shard %zu's server to serve its Portal", i);
+        assertTrue(ccnxPortalShards_GetCpu(shards, i) == -1, "Expected shard %zu to be unpinned before it starts", i);
+    }
+    assertTrue(ccnxPortalShards_GetPortal(shards, 0) != ccnxPortalShards_GetPortal(shards, 1), "Expected a Portal per shard");
+
+    parcObjectTesting_AssertAcquireReleaseContract(ccnxPortalShards_Acquire, shards);
+
+    ccnxPortalShards_Release(&shards);
+    assertNull(shards, "Expected ccnxPortalShards_Release to null the pointer");
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortalShards_Create_OnePerCpu)
+{
+    CCNxPortalFactory *factory = longBowTestCase_GetClipBoardData(testCase);
+
+    CCNxPortalShards *shards = ccnxPortalShards_Create(factory, ccnxPortalAPI_LoopBack, 0);
+    size_t expected = _ccnxPortalShards_OnlineCpus();
+    assertTrue(ccnxPortalShards_GetCount(shards) == expected,
+               "Expected %zu shards, actual %zu", expected, ccnxPortalShards_GetCount(shards));
+
+    ccnxPortalShards_Release(&shards);
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortalShards_Register)
+{
+    CCNxPortalFactory *factory = longBowTestCase_GetClipBoardData(testCase);
+    CCNxPortalShards *shards = ccnxPortalShards_Create(factory, ccnxPortalAPI_LoopBack, 2);
+    int calls = 0;
+
+    assertTrue(_register(shards, "lci:/shards/a", &calls), "Expected the registration to succeed");
+
+    for (size_t i = 0; i < 2; i++) {
+        assertTrue(ccnxPortalServer_GetCount(ccnxPortalShards_GetServer(shards, i)) == 1, "Expected shard %zu to have the prefix", i);
+        assertTrue(ccnxPortalAnchorRegistry_Size(ccnxPortal_GetAnchors(ccnxPortalShards_GetPortal(shards, i))) == 1,
+                   "Expected shard %zu's Portal to listen for the prefix", i);
+    }
+
+    ccnxPortalShards_Release(&shards);
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortalShards_Register_Running)
+{
+    CCNxPortalFactory *factory = longBowTestCase_GetClipBoardData(testCase);
+    CCNxPortalShards *shards = ccnxPortalShards_Create(factory, ccnxPortalAPI_LoopBack, 2);
+    int calls = 0;
+
+    assertTrue(ccnxPortalShards_Start(shards), "Expected the shards to start");
+
+    errno = 0;
+    assertFalse(_register(shards, "lci:/shards/a", &calls), "Expected no registration while running");
+    assertTrue(errno == EBUSY, "Expected EBUSY, actual %d", errno);
+
+    ccnxPortalShards_Stop(shards);
+    ccnxPortalShards_Release(&shards);
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortalShards_Unregister)
+{
+    CCNxPortalFactory *factory = longBowTestCase_GetClipBoardData(testCase);
+    CCNxPortalShards *shards = ccnxPortalShards_Create(factory, ccnxPortalAPI_LoopBack, 2);
+    int calls = 0;
+
+    _register(shards, "lci:/shards/a", &calls);
+
+    CCNxName *prefix = ccnxName_CreateFromCString("lci:/shards/a");
+    assertTrue(ccnxPortalShards_Unregister(shards, prefix), "Expected the prefix to be unregistered");
+    assertFalse(ccnxPortalShards_Unregister(shards, prefix), "Expected false for a prefix no longer registered");
+    ccnxName_Release(&prefix);
+
+    for (size_t i = 0; i < 2; i++) {
+        assertTrue(ccnxPortalServer_GetCount(ccnxPortalShards_GetServer(shards, i)) == 0, "Expected shard %zu to have no prefix", i);
+    }
+
+    ccnxPortalShards_Release(&shards);
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortalShards_StartStop)
+{
+    CCNxPortalFactory *factory = longBowTestCase_GetClipBoardData(testCase);
+    CCNxPortalShards *shards = ccnxPortalShards_Create(factory, ccnxPortalAPI_LoopBack, 2);
+    int calls = 0;
+
+    _register(shards, "lci:/shards/a", &calls);
+    _sendToEachShard(shards, "lci:/shards/a/1");
+
+    assertTrue(ccnxPortalShards_Start(shards), "Expected the shards to start");
+    assertTrue(ccnxPortalShards_IsRunning(shards), "Expected the shards to be running");
+    assertTrue(ccnxPortalShards_Start(shards), "Expected starting running shards to succeed");
+
+    for (int i = 0; i < _TestPatienceMilliseconds && __atomic_load_n(&calls, __ATOMIC_ACQUIRE) < 2; i++) {
+        usleep(1000);
+    }
+    assertTrue(calls == 2, "Expected each shard to serve its Interest, actual %d", calls);
+
+#ifdef __linux__
+    for (size_t i = 0; i < 2; i++) {
+        int cpu = ccnxPortalShards_GetCpu(shards, i);
+        assertTrue(cpu == (int) (i % _ccnxPortalShards_OnlineCpus()), "Expected shard %zu to be pinned, actual %d", i, cpu);
+    }
+#endif
+
+    ccnxPortalShards_Stop(shards);
+    assertFalse(ccnxPortalShards_IsRunning(shards), "Expected the shards to be stopped");
+    ccnxPortalShards_Stop(shards);
+
+    ccnxPortalShards_Release(&shards);
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortalShards_CreateStatistics)
+{
+    CCNxPortalFactory *factory = longBowTestCase_GetClipBoardData(testCase);
+    CCNxPortalShards *shards = ccnxPortalShards_Create(factory, ccnxPortalAPI_LoopBack, 3);
+
+    _sendToEachShard(shards, "lci:/shards/a/1");
+
+    CCNxPortalStatistics *statistics = ccnxPortalShards_CreateStatistics(shards);
+    assertNotNull(statistics, "Expected a non-null statistics");
+    uint64_t sent = ccnxPortalStatistics_GetCounter(statistics, CCNxPortalStatisticsCounter_InterestsSent);
+    assertTrue(sent == 3, "Expected the Interests sent by all 3 shards, actual %" PRIu64, sent);
+    const CCNxPortalHistogram *send = ccnxPortalStatistics_GetHistogram(statistics, CCNxPortalStatisticsHistogram_Send);
+    assertTrue(ccnxPortalHistogram_GetCount(send) == 3, "Expected 3 send latencies");
+
+    ccnxPortalStatistics_Release(&statistics);
+    ccnxPortalShards_Release(&shards);
+}
+
+int
+main(int argc, char *argv[argc])
+{
+    LongBowRunner *testRunner = LONGBOW_TEST_RUNNER_CREATE(test_ccnx_PortalShards);
+    int exitStatus = longBowMain(argc, argv, testRunner, NULL);
+    longBowTestRunner_Destroy(&testRunner);
+    exit(exitStatus);
+}
@@ -60,6 +60,8 @@
 // This permits internal static functions to be visible to this Test Framework.
 #include "../ccnx_PortalStack.c"
 
+#include <inttypes.h>
+
 #include <LongBow/testing.h>
 #include <LongBow/debugging.h>
 
@@ -74,6 +76,7 @@
 #include <parc/algol/parc_SafeMemory.h>
 #include <parc/algol/parc_Memory.h>
 #include <parc/security/parc_IdentityFile.h>
+#include <parc/developer/parc_Stopwatch.h>
 
 LONGBOW_TEST_RUNNER(test_ccnx_PortalStack)
 {
@@ -82,6 +85,7 @@ LONGBOW_TEST_RUNNER(test_ccnx_PortalStack)
     // Never rely on the execution order of tests or share state between them.
     LONGBOW_RUN_TEST_FIXTURE(CreateRelease);
     LONGBOW_RUN_TEST_FIXTURE(Global);
+    LONGBOW_RUN_TEST_FIXTURE(Performance);
 }
 
 // The Test Runner calls this function once before any Test Fixtures are run.
@@ -233,6 +237,7 @@ LONGBOW_TEST_FIXTURE(Global)
     LONGBOW_RUN_TEST_CASE(Global, ccnxPortalStack_GetFileId);
     LONGBOW_RUN_TEST_CASE(Global, ccnxPortalStack_GetKeyId);
     LONGBOW_RUN_TEST_CASE(Global, ccnxPortalStack_GetAttributes);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortalStack_GetConfiguration);
     LONGBOW_RUN_TEST_CASE(Global, ccnxPortalStack_SetAttributes);
     LONGBOW_RUN_TEST_CASE(Global, ccnxPortalStack_Listen);
     LONGBOW_RUN_TEST_CASE(Global, ccnxPortalStack_Ignore);
@@ -241,13 +246,13 @@ LONGBOW_TEST_FIXTURE(Global)
     LONGBOW_RUN_TEST_CASE(Global, ccnxPortalStack_Start);
     LONGBOW_RUN_TEST_CASE(Global, ccnxPortalStack_Stop);
     LONGBOW_RUN_TEST_CASE(Global, ccnxPortalStack_GetError);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortalStack_AddInterceptor);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortalStack_AddInterceptor_Twice);
 }
 
-LONGBOW_TEST_FIXTURE_SETUP(Global)
+static CCNxPortalStack *
+_createMockStack(void)
 {
-    setupFixtureAllocations = parcMemory_Outstanding();
-    parcSecurity_Init();
-
     const char *keystoreName = "test_ccnx_PortalImplementation_keystore";
 
     bool success = parcPkcs12KeyStore_CreateFile(keystoreName, "keystore_password", "consumer", 1024, 30);
@@ -276,6 +281,15 @@ LONGBOW_TEST_FIXTURE_SETUP(Global)
                                                     parcMemory_Allocate(10),
                                                     parcMemory_DeallocateImpl);
     ccnxPortalFactory_Release(&factory);
+    return stack;
+}
+
+LONGBOW_TEST_FIXTURE_SETUP(Global)
+{
+    setupFixtureAllocations = parcMemory_Outstanding();
+    parcSecurity_Init();
+
+    CCNxPortalStack *stack = _createMockStack();
     longBowTestCase_SetClipBoardData(testCase, stack);
 
     return LONGBOW_STATUS_SUCCEEDED;
@@ -369,16 +383,40 @@ LONGBOW_TEST_CASE(Global, ccnxPortalStack_SetAttributes)
 {
     CCNxPortalStack *stack = (CCNxPortalStack *) longBowTestCase_GetClipBoardData(testCase);
 
-    const CCNxPortalAttributes *attributes = &ccnxPortalAttributes_NonBlocking;
+    CCNxPortalAttributes *attributes = ccnxPortalAttributes_Copy(&ccnxPortalAttributes_Blocking);
+    ccnxPortalAttributes_SetReceiveQueueLimit(attributes, 100);
     bool result = ccnxPortalStack_SetAttributes(stack, attributes);
     assertTrue(result, "Expected ccnxPortalStack_SetAttributes to return true.");
+
+    const CCNxPortalAttributes *actual = ccnxPortalStack_GetAttributes(stack);
+    assertTrue(actual != attributes, "Expected the stack to keep its own copy");
+    assertTrue(ccnxPortalAttributes_Equals(actual, attributes), "Expected the attributes that were set");
+
+    ccnxPortalAttributes_Release(&attributes);
 }
 
 LONGBOW_TEST_CASE(Global, ccnxPortalStack_GetAttributes)
 {
     CCNxPortalStack *stack = (CCNxPortalStack *) longBowTestCase_GetClipBoardData(testCase);
 
-    ccnxPortalStack_GetAttributes(stack);
+    const CCNxPortalAttributes *attributes = ccnxPortalStack_GetAttributes(stack);
+    assertTrue(ccnxPortalAttributes_Equals(attributes, &ccnxPortalAttributes_NonBlocking),
+               "Expected the attributes given at creation");
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortalStack_GetConfiguration)
+{
+    CCNxPortalStack *stack = (CCNxPortalStack *) longBowTestCase_GetClipBoardData(testCase);
+
+    const CCNxPortalConfiguration *configuration = ccnxPortalStack_GetConfiguration(stack);
+    assertTrue(configuration == ccnxPortalFactory_GetConfiguration(stack->factory), "Expected the factory's configuration");
+
+    // Rebuilding the factory's snapshot must leave the stack's own reference valid and unchanged.
+    assertTrue(ccnxPortalFactory_SetProperty(stack->factory, CCNxPortalFactory_LocalRouterTimeout, "2000000"),
+               "Expected the timeout to be set");
+    assertTrue(ccnxPortalStack_GetConfiguration(stack) == configuration, "Expected the stack to keep its configuration");
+    assertTrue(ccnxPortalConfiguration_GetLocalRouterTimeout(configuration) == 1000000,
+               "Expected the timeout the stack was created with, actual %" PRIu64, ccnxPortalConfiguration_GetLocalRouterTimeout(configuration));
 }
 
 LONGBOW_TEST_CASE(Global, ccnxPortalStack_GetFileId)
@@ -397,6 +435,141 @@ LONGBOW_TEST_CASE(Global, ccnxPortalStack_GetKeyId)
     assertNotNull(keyId, "Expected non-NULL result from ccnxPortalStack_GetKeyId");
 }
 
+static bool
+_countingSend(void *state, const CCNxPortalInterceptor *next, const CCNxMetaMessage *message, const CCNxStackTimeout *microSeconds)
+{
+    unsigned int *count = state;
+    (*count)++;
+    return ccnxPortalInterceptor_Send(next, message, microSeconds);
+}
+
+static bool
+_countingListen(void *state, const CCNxPortalInterceptor *next, const CCNxName *name, const CCNxStackTimeout *microSeconds)
+{
+    unsigned int *count = state;
+    (*count)++;
+    return ccnxPortalInterceptor_Listen(next, name, microSeconds);
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortalStack_AddInterceptor)
+{
+    CCNxPortalStack *stack = (CCNxPortalStack *) longBowTestCase_GetClipBoardData(testCase);
+
+    unsigned int count = 0;
+    CCNxPortalInterceptor *inner = ccnxPortalInterceptor_Create(_countingSend, NULL, _countingListen, NULL, &count, NULL);
+    CCNxPortalInterceptor *outer = ccnxPortalInterceptor_Create(_countingSend, NULL, NULL, NULL, &count, NULL);
+
+    assertTrue(ccnxPortalStack_AddInterceptor(stack, inner), "Expected ccnxPortalStack_AddInterceptor to succeed.");
+    assertTrue(ccnxPortalStack_AddInterceptor(stack, outer), "Expected ccnxPortalStack_AddInterceptor to succeed.");
+    ccnxPortalInterceptor_Release(&inner);
+    ccnxPortalInterceptor_Release(&outer);
+
+    CCNxName *name = ccnxName_Create();
+    CCNxInterest *interest = ccnxInterest_CreateSimple(name);
+    CCNxMetaMessage *message = ccnxMetaMessage_CreateFromInterest(interest);
+    ccnxInterest_Release(&interest);
+
+    assertTrue(ccnxPortalStack_Send(stack, message, CCNxStackTimeout_Never), "Expected the send to reach the implementation.");
+    assertTrue(count == 2, "Expected both interceptors to see the send, actual %u", count);
+
+    assertTrue(ccnxPortalStack_Listen(stack, name, CCNxStackTimeout_Never), "Expected the listen to reach the implementation.");
+    assertTrue(count == 3, "Expected only the inner interceptor to see the listen, actual %u", count);
+
+    CCNxMetaMessage *received = ccnxPortalStack_Receive(stack, CCNxStackTimeout_Never);
+    assertNotNull(received, "Expected the receive to pass through to the implementation.");
+    ccnxMetaMessage_Release(&received);
+
+    ccnxMetaMessage_Release(&message);
+    ccnxName_Release(&name);
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortalStack_AddInterceptor_Twice)
+{
+    CCNxPortalStack *stack = (CCNxPortalStack *) longBowTestCase_GetClipBoardData(testCase);
+
+    CCNxPortalInterceptor *interceptor = ccnxPortalInterceptor_Create(NULL, NULL, NULL, NULL, NULL, NULL);
+
+    assertTrue(ccnxPortalStack_AddInterceptor(stack, interceptor), "Expected the first add to succeed.");
+    assertFalse(ccnxPortalStack_AddInterceptor(stack, interceptor), "Expected the second add to fail.");
+
+    ccnxPortalInterceptor_Release(&interceptor);
+}
+
+LONGBOW_TEST_FIXTURE_OPTIONS(Performance, .enabled = false)
+{
+    LONGBOW_RUN_TEST_CASE(Performance, ccnxPortalStack_InterceptorDispatch);
+}
+
+LONGBOW_TEST_FIXTURE_SETUP(Performance)
+{
+    parcSecurity_Init();
+
+    CCNxPortalStack *stack = _createMockStack();
+    longBowTestCase_SetClipBoardData(testCase, stack);
+
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_FIXTURE_TEARDOWN(Performance)
+{
+    CCNxPortalStack *stack = (CCNxPortalStack *) longBowTestCase_GetClipBoardData(testCase);
+
+    ccnxPortalStack_Release(&stack);
+
+    parcSecurity_Fini();
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+static bool
+_forwardSend(void *state, const CCNxPortalInterceptor *next, const CCNxMetaMessage *message, const CCNxStackTimeout *microSeconds)
+{
+    return ccnxPortalInterceptor_Send(next, message, microSeconds);
+}
+
+static uint64_t
+_timeSends(const CCNxPortalStack *stack, const CCNxMetaMessage *message, unsigned int iterations)
+{
+    PARCStopwatch *timer = parcStopwatch_Create();
+    parcStopwatch_Start(timer);
+    for (unsigned int i = 0; i < iterations; i++) {
+        ccnxPortalStack_Send(stack, message, CCNxStackTimeout_Never);
+    }
+    uint64_t result = parcStopwatch_ElapsedTimeNanos(timer);
+    parcStopwatch_Release(&timer);
+    return result;
+}
+
+LONGBOW_TEST_CASE(Performance, ccnxPortalStack_InterceptorDispatch)
+{
+    CCNxPortalStack *stack = (CCNxPortalStack *) longBowTestCase_GetClipBoardData(testCase);
+
+    const unsigned int iterations = 10000000;
+
+    CCNxName *name = ccnxName_Create();
+    CCNxInterest *interest = ccnxInterest_CreateSimple(name);
+    CCNxMetaMessage *message = ccnxMetaMessage_CreateFromInterest(interest);
+    ccnxInterest_Release(&interest);
+    ccnxName_Release(&name);
+
+    _timeSends(stack, message, iterations / 10);   // warm up
+    double baseline = (double) _timeSends(stack, message, iterations) / iterations;
+    printf("%2u layers %8.2f ns/send\n", 0, baseline);
+
+    unsigned int layers = 0;
+    for (unsigned int target = 1; target <= 16; target *= 2) {
+        while (layers < target) {
+            CCNxPortalInterceptor *interceptor = ccnxPortalInterceptor_Create(_forwardSend, NULL, NULL, NULL, NULL, NULL);
+            ccnxPortalStack_AddInterceptor(stack, interceptor);
+            ccnxPortalInterceptor_Release(&interceptor);
+            layers++;
+        }
+        double perSend = (double) _timeSends(stack, message, iterations) / iterations;
+        printf("%2u layers %8.2f ns/send %8.2f ns/layer\n", layers, perSend, (perSend - baseline) / layers);
+    }
+
+    ccnxMetaMessage_Release(&message);
+}
+
 int
 main(int argc, char *argv[argc])
 {
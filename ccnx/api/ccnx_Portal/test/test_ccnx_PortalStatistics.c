@@ -0,0 +1,391 @@
+/*
+ * Copyright (c) 2016, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX OR PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ################################################################################
+ * #
+ * # PATENT NOTICE
+ * #
+ * # This software is distributed under the BSD 2-clause License (see LICENSE
+ * # file).  This BSD License does not make any patent claims and as such, does
+ * # not act as a patent grant.  The purpose of this section is for each contributor
+ * # to define their intentions with respect to intellectual property.
+ * #
+ * # Each contributor to this source code is encouraged to state their patent
+ * # claims and licensing mechanisms for any contributions made. At the end of
+ * # this section contributors may each make their own statements.  Contributor's
+ * # claims and grants only apply to the pieces (source code, programs, text,
+ * # media, etc) that they have contributed directly to this software.
+ * #
+ * # There is no guarantee that this section is complete, up to date or accurate. It
+ * # is up to the contributors to maintain their portion of this section and up to
+ * # the user of the software to verify any claims herein.
+ * #
+ * # Do not remove this header notification.  The contents of this section must be
+ * # present in all distributions of the software.  You may only modify your own
+ * # intellectual property statements.  Please provide contact information.
+ *
+ * - Palo Alto Research Center, Inc
+ * This software distribution does not grant any rights to patents owned by Palo
+ * Alto Research Center, Inc (PARC). Rights to these patents are available via
+ * various mechanisms. As of January 2016 PARC has committed to FRAND licensing any
+ * intellectual property used by its contributions to this software. You may
+ * contact PARC at cipo@parc.com for more information or visit http://www.ccnx.org
+ */
+/**
+ * @copyright (c) 2016, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC).  All rights reserved.
+ */
+#include "../ccnx_PortalStatistics.c"
+
+#include <LongBow/unit-test.h>
+#include <LongBow/debugging.h>
+
+#include <stdio.h>
+#include <unistd.h>
+#include <inttypes.h>
+
+#include <parc/algol/parc_Memory.h>
+#include <parc/algol/parc_SafeMemory.h>
+#include <parc/testing/parc_ObjectTesting.h>
+
+#include <ccnx/common/ccnx_Interest.h>
+#include <ccnx/common/ccnx_InterestReturn.h>
+#include <ccnx/common/ccnx_ContentObject.h>
+
+#include <ccnx/api/control/cpi_ControlFacade.h>
+
+LONGBOW_TEST_RUNNER(test_ccnx_PortalStatistics)
+{
+    LONGBOW_RUN_TEST_FIXTURE(Global);
+}
+
+LONGBOW_TEST_RUNNER_SETUP(test_ccnx_PortalStatistics)
+{
+    parcMemory_SetInterface(&PARCSafeMemoryAsPARCMemory);
+
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_RUNNER_TEARDOWN(test_ccnx_PortalStatistics)
+{
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_FIXTURE(Global)
+{
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortalStatistics_CreateAcquireRelease);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortalStatistics_RecordSend);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortalStatistics_RecordSend_Failure);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortalStatistics_RecordReceive);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortalStatistics_RecordReceive_Timeout);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortalStatistics_RoundTrip);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortalStatistics_RoundTrip_Nack);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortalStatistics_RecordLatency);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortalStatistics_Reset);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortalStatistics_Add);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortalStatistics_ToJSON);
+}
+
+static size_t InitialMemoryOutstanding = 0;
+
+LONGBOW_TEST_FIXTURE_SETUP(Global)
+{
+    InitialMemoryOutstanding = parcMemory_Outstanding();
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_FIXTURE_TEARDOWN(Global)
+{
+    if (parcMemory_Outstanding() != InitialMemoryOutstanding) {
+        parcSafeMemory_ReportAllocation(STDOUT_FILENO);
+        printf("('%s' leaks memory by %zd\n",
+               longBowTestCase_GetName(testCase), parcMemory_Outstanding() - InitialMemoryOutstanding);
+        return LONGBOW_STATUS_MEMORYLEAK;
+    }
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+static CCNxMetaMessage *
+_createInterestMessage(const char *uri)
+{
+    CCNxName *name = ccnxName_CreateFromCString(uri);
+    CCNxInterest *interest = ccnxInterest_CreateSimple(name);
+    CCNxMetaMessage *result = ccnxMetaMessage_CreateFromInterest(interest);
+    ccnxInterest_Release(&interest);
+    ccnxName_Release(&name);
+    return result;
+}
+
+static CCNxMetaMessage *
+_createContentObjectMessage(const char *uri, const char *payload)
+{
+    CCNxName *name = ccnxName_CreateFromCString(uri);
+    PARCBuffer *buffer = parcBuffer_AllocateCString(payload);
+    CCNxContentObject *contentObject = ccnxContentObject_CreateWithNameAndPayload(name, buffer);
+    CCNxMetaMessage *result = ccnxMetaMessage_CreateFromContentObject(contentObject);
+    ccnxContentObject_Release(&contentObject);
+    parcBuffer_Release(&buffer);
+    ccnxName_Release(&name);
+    return result;
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortalStatistics_CreateAcquireRelease)
+{
+    CCNxPortalStatistics *statistics = ccnxPortalStatistics_Create();
+    assertNotNull(statistics, "Expected a non-null CCNxPortalStatistics");
+
+    parcObjectTesting_AssertAcquireReleaseContract(ccnxPortalStatistics_Acquire, statistics);
+
+    for (int i = 0; i < CCNxPortalStatisticsCounter_Count; i++) {
+        assertTrue(ccnxPortalStatistics_GetCounter(statistics, i) == 0, "Expected counter %d to be zero", i);
+    }
+
+    ccnxPortalStatistics_Release(&statistics);
+    assertNull(statistics, "Expected ccnxPortalStatistics_Release to null the pointer");
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortalStatistics_RecordSend)
+{
+    CCNxPortalStatistics *statistics = ccnxPortalStatistics_Create();
+
+    CCNxMetaMessage *interest = _createInterestMessage("lci:/a/b");
+    CCNxMetaMessage *contentObject = _createContentObjectMessage("lci:/a/c", "hello");
+    CCNxControl *control = ccnxControl_CreateFlushRequest();
+    CCNxMetaMessage *controlMessage = ccnxMetaMessage_CreateFromControl(control);
+
+    ccnxPortalStatistics_RecordSend(statistics, interest, true, 0, ccnxPortalStatistics_Now());
+    ccnxPortalStatistics_RecordSend(statistics, contentObject, true, 0, ccnxPortalStatistics_Now());
+    ccnxPortalStatistics_RecordSend(statistics, controlMessage, true, 0, ccnxPortalStatistics_Now());
+
+    assertTrue(ccnxPortalStatistics_GetCounter(statistics, CCNxPortalStatisticsCounter_InterestsSent) == 1, "Expected 1 Interest sent");
+    assertTrue(ccnxPortalStatistics_GetCounter(statistics, CCNxPortalStatisticsCounter_ContentObjectsSent) == 1, "Expected 1 Content Object sent");
+    assertTrue(ccnxPortalStatistics_GetCounter(statistics, CCNxPortalStatisticsCounter_ControlsSent) == 1, "Expected 1 control sent");
+    assertTrue(ccnxPortalStatistics_GetCounter(statistics, CCNxPortalStatisticsCounter_BytesSent) == 5, "Expected 5 bytes sent");
+
+    const CCNxPortalHistogram *send = ccnxPortalStatistics_GetHistogram(statistics, CCNxPortalStatisticsHistogram_Send);
+    assertTrue(ccnxPortalHistogram_GetCount(send) == 3, "Expected 3 send latencies");
+
+    ccnxMetaMessage_Release(&controlMessage);
+    ccnxControl_Release(&control);
+    ccnxMetaMessage_Release(&contentObject);
+    ccnxMetaMessage_Release(&interest);
+    ccnxPortalStatistics_Release(&statistics);
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortalStatistics_RecordSend_Failure)
+{
+    CCNxPortalStatistics *statistics = ccnxPortalStatistics_Create();
+    CCNxMetaMessage *interest = _createInterestMessage("lci:/a/b");
+
+    ccnxPortalStatistics_RecordSend(statistics, interest, false, EWOULDBLOCK, ccnxPortalStatistics_Now());
+    ccnxPortalStatistics_RecordSend(statistics, interest, false, EBADF, ccnxPortalStatistics_Now());
+
+    assertTrue(ccnxPortalStatistics_GetCounter(statistics, CCNxPortalStatisticsCounter_InterestsSent) == 0, "Expected no Interests sent");
+    assertTrue(ccnxPortalStatistics_GetCounter(statistics, CCNxPortalStatisticsCounter_SendTimeouts) == 1, "Expected 1 send timeout");
+    assertTrue(ccnxPortalStatistics_GetCounter(statistics, CCNxPortalStatisticsCounter_SendErrors) == 1, "Expected 1 send error");
+
+    ccnxMetaMessage_Release(&interest);
+    ccnxPortalStatistics_Release(&statistics);
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortalStatistics_RecordReceive)
+{
+    CCNxPortalStatistics *statistics = ccnxPortalStatistics_Create();
+
+    CCNxMetaMessage *interest = _createInterestMessage("lci:/a/b");
+    CCNxMetaMessage *contentObject = _createContentObjectMessage("lci:/a/c", "hello world");
+
+    ccnxPortalStatistics_RecordReceive(statistics, interest, 0, ccnxPortalStatistics_Now());
+    ccnxPortalStatistics_RecordReceive(statistics, contentObject, 0, ccnxPortalStatistics_Now());
+
+    assertTrue(ccnxPortalStatistics_GetCounter(statistics, CCNxPortalStatisticsCounter_InterestsReceived) == 1, "Expected 1 Interest received");
+    assertTrue(ccnxPortalStatistics_GetCounter(statistics, CCNxPortalStatisticsCounter_ContentObjectsReceived) == 1, "Expected 1 Content Object received");
+    assertTrue(ccnxPortalStatistics_GetCounter(statistics, CCNxPortalStatisticsCounter_BytesReceived) == 11, "Expected 11 bytes received");
+
+    const CCNxPortalHistogram *receive = ccnxPortalStatistics_GetHistogram(statistics, CCNxPortalStatisticsHistogram_Receive);
+    assertTrue(ccnxPortalHistogram_GetCount(receive) == 2, "Expected 2 receive latencies");
+
+    ccnxMetaMessage_Release(&contentObject);
+    ccnxMetaMessage_Release(&interest);
+    ccnxPortalStatistics_Release(&statistics);
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortalStatistics_RecordReceive_Timeout)
+{
+    CCNxPortalStatistics *statistics = ccnxPortalStatistics_Create();
+
+    ccnxPortalStatistics_RecordReceive(statistics, NULL, EWOULDBLOCK, ccnxPortalStatistics_Now());
+    ccnxPortalStatistics_RecordReceive(statistics, NULL, ENOMSG, ccnxPortalStatistics_Now());
+
+    // The RTA stack reports a receive timeout with ENOMSG.
+    assertTrue(ccnxPortalStatistics_GetCounter(statistics, CCNxPortalStatisticsCounter_ReceiveTimeouts) == 2, "Expected 2 receive timeouts");
+    assertTrue(ccnxPortalStatistics_GetCounter(statistics, CCNxPortalStatisticsCounter_ReceiveErrors) == 0, "Expected no receive errors");
+
+    ccnxPortalStatistics_RecordReceive(statistics, NULL, ECONNRESET, ccnxPortalStatistics_Now());
+    assertTrue(ccnxPortalStatistics_GetCounter(statistics, CCNxPortalStatisticsCounter_ReceiveErrors) == 1, "Expected 1 receive error");
+
+    const CCNxPortalHistogram *receive = ccnxPortalStatistics_GetHistogram(statistics, CCNxPortalStatisticsHistogram_Receive);
+    assertTrue(ccnxPortalHistogram_GetCount(receive) == 0, "Expected no latency recorded for a failed receive");
+
+    ccnxPortalStatistics_Release(&statistics);
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortalStatistics_RoundTrip)
+{
+    CCNxPortalStatistics *statistics = ccnxPortalStatistics_Create();
+
+    CCNxMetaMessage *interest = _createInterestMessage("lci:/a/b");
+    CCNxMetaMessage *contentObject = _createContentObjectMessage("lci:/a/b", "hello");
+    CCNxMetaMessage *unsolicited = _createContentObjectMessage("lci:/x/y", "hello");
+
+    ccnxPortalStatistics_RecordSend(statistics, interest, true, 0, ccnxPortalStatistics_Now());
+    usleep(1000);
+    ccnxPortalStatistics_RecordReceive(statistics, unsolicited, 0, ccnxPortalStatistics_Now());
+    ccnxPortalStatistics_RecordReceive(statistics, contentObject, 0, ccnxPortalStatistics_Now());
+    // A second response to the same Interest is not matched.
+    ccnxPortalStatistics_RecordReceive(statistics, contentObject, 0, ccnxPortalStatistics_Now());
+
+    const CCNxPortalHistogram *rtt = ccnxPortalStatistics_GetHistogram(statistics, CCNxPortalStatisticsHistogram_RoundTrip);
+    assertTrue(ccnxPortalHistogram_GetCount(rtt) == 1, "Expected 1 round-trip time, actual %" PRIu64, ccnxPortalHistogram_GetCount(rtt));
+    assertTrue(ccnxPortalHistogram_GetMin(rtt) >= 1000000, "Expected a round-trip time of at least 1ms, actual %" PRIu64, ccnxPortalHistogram_GetMin(rtt));
+
+    ccnxMetaMessage_Release(&unsolicited);
+    ccnxMetaMessage_Release(&contentObject);
+    ccnxMetaMessage_Release(&interest);
+    ccnxPortalStatistics_Release(&statistics);
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortalStatistics_RoundTrip_Nack)
+{
+    CCNxPortalStatistics *statistics = ccnxPortalStatistics_Create();
+
+    CCNxName *name = ccnxName_CreateFromCString("lci:/a/b");
+    CCNxInterest *interest = ccnxInterest_CreateSimple(name);
+    CCNxInterestReturn *interestReturn = ccnxInterestReturn_Create(interest, CCNxInterestReturn_ReturnCode_NoRoute);
+    CCNxMetaMessage *sent = ccnxMetaMessage_CreateFromInterest(interest);
+    CCNxMetaMessage *nack = ccnxMetaMessage_CreateFromInterestReturn(interestReturn);
+
+    ccnxPortalStatistics_RecordSend(statistics, sent, true, 0, ccnxPortalStatistics_Now());
+    ccnxPortalStatistics_RecordReceive(statistics, nack, 0, ccnxPortalStatistics_Now());
+
+    assertTrue(ccnxPortalStatistics_GetCounter(statistics, CCNxPortalStatisticsCounter_NacksReceived) == 1, "Expected 1 NACK received");
+    const CCNxPortalHistogram *rtt = ccnxPortalStatistics_GetHistogram(statistics, CCNxPortalStatisticsHistogram_RoundTrip);
+    assertTrue(ccnxPortalHistogram_GetCount(rtt) == 1, "Expected the NACK to complete the round trip");
+
+    ccnxMetaMessage_Release(&nack);
+    ccnxMetaMessage_Release(&sent);
+    ccnxInterestReturn_Release(&interestReturn);
+    ccnxInterest_Release(&interest);
+    ccnxName_Release(&name);
+    ccnxPortalStatistics_Release(&statistics);
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortalStatistics_RecordLatency)
+{
+    CCNxPortalStatistics *statistics = ccnxPortalStatistics_Create();
+
+    uint64_t startTime = ccnxPortalStatistics_Now();
+    ccnxPortalStatistics_RecordLatency(statistics, CCNxPortalStatisticsHistogram_Listen, startTime);
+    ccnxPortalStatistics_RecordLatency(statistics, CCNxPortalStatisticsHistogram_Flush, startTime);
+
+    assertTrue(ccnxPortalHistogram_GetCount(ccnxPortalStatistics_GetHistogram(statistics, CCNxPortalStatisticsHistogram_Listen)) == 1,
+               "Expected 1 listen latency");
+    assertTrue(ccnxPortalHistogram_GetCount(ccnxPortalStatistics_GetHistogram(statistics, CCNxPortalStatisticsHistogram_Flush)) == 1,
+               "Expected 1 flush latency");
+
+    ccnxPortalStatistics_Release(&statistics);
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortalStatistics_Reset)
+{
+    CCNxPortalStatistics *statistics = ccnxPortalStatistics_Create();
+    CCNxMetaMessage *interest = _createInterestMessage("lci:/a/b");
+    CCNxMetaMessage *contentObject = _createContentObjectMessage("lci:/a/b", "hello");
+
+    ccnxPortalStatistics_RecordSend(statistics, interest, true, 0, ccnxPortalStatistics_Now());
+    ccnxPortalStatistics_Reset(statistics);
+    ccnxPortalStatistics_RecordReceive(statistics, contentObject, 0, ccnxPortalStatistics_Now());
+
+    assertTrue(ccnxPortalStatistics_GetCounter(statistics, CCNxPortalStatisticsCounter_InterestsSent) == 0, "Expected the counter to be reset");
+    const CCNxPortalHistogram *rtt = ccnxPortalStatistics_GetHistogram(statistics, CCNxPortalStatisticsHistogram_RoundTrip);
+    assertTrue(ccnxPortalHistogram_GetCount(rtt) == 0, "Expected the outstanding Interest to be forgotten");
+
+    ccnxMetaMessage_Release(&contentObject);
+    ccnxMetaMessage_Release(&interest);
+    ccnxPortalStatistics_Release(&statistics);
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortalStatistics_Add)
+{
+    CCNxPortalStatistics *statistics = ccnxPortalStatistics_Create();
+    CCNxPortalStatistics *other = ccnxPortalStatistics_Create();
+    CCNxMetaMessage *interest = _createInterestMessage("lci:/a/b");
+
+    ccnxPortalStatistics_RecordSend(statistics, interest, true, 0, ccnxPortalStatistics_Now());
+    ccnxPortalStatistics_RecordSend(other, interest, true, 0, ccnxPortalStatistics_Now());
+    ccnxPortalStatistics_RecordReceive(other, interest, 0, ccnxPortalStatistics_Now());
+
+    ccnxPortalStatistics_Add(statistics, other);
+
+    assertTrue(ccnxPortalStatistics_GetCounter(statistics, CCNxPortalStatisticsCounter_InterestsSent) == 2, "Expected 2 Interests sent");
+    assertTrue(ccnxPortalStatistics_GetCounter(statistics, CCNxPortalStatisticsCounter_InterestsReceived) == 1, "Expected 1 Interest received");
+    const CCNxPortalHistogram *send = ccnxPortalStatistics_GetHistogram(statistics, CCNxPortalStatisticsHistogram_Send);
+    assertTrue(ccnxPortalHistogram_GetCount(send) == 2, "Expected 2 send latencies");
+    assertTrue(ccnxPortalStatistics_GetCounter(other, CCNxPortalStatisticsCounter_InterestsSent) == 1, "Expected the other statistics to be unchanged");
+
+    ccnxMetaMessage_Release(&interest);
+    ccnxPortalStatistics_Release(&other);
+    ccnxPortalStatistics_Release(&statistics);
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortalStatistics_ToJSON)
+{
+    CCNxPortalStatistics *statistics = ccnxPortalStatistics_Create();
+    CCNxMetaMessage *interest = _createInterestMessage("lci:/a/b");
+    ccnxPortalStatistics_RecordSend(statistics, interest, true, 0, ccnxPortalStatistics_Now());
+
+    PARCJSON *json = ccnxPortalStatistics_ToJSON(statistics);
+    assertNotNull(json, "Expected a JSON representation");
+
+    const PARCJSONValue *counters = parcJSON_GetValueByName(json, "counters");
+    assertNotNull(counters, "Expected a counters member");
+    const PARCJSONValue *sent = parcJSON_GetValueByName(parcJSONValue_GetJSON(counters), "interestsSent");
+    assertTrue(parcJSONValue_GetInteger(sent) == 1, "Expected interestsSent 1");
+
+    const PARCJSONValue *latencies = parcJSON_GetValueByName(json, "latencies");
+    assertNotNull(latencies, "Expected a latencies member");
+    assertNotNull(parcJSON_GetValueByName(parcJSONValue_GetJSON(latencies), "roundTrip"), "Expected a roundTrip histogram");
+
+    parcJSON_Release(&json);
+    ccnxMetaMessage_Release(&interest);
+    ccnxPortalStatistics_Release(&statistics);
+}
+
+int
+main(int argc, char *argv[argc])
+{
+    LongBowRunner *testRunner = LONGBOW_TEST_RUNNER_CREATE(test_ccnx_PortalStatistics);
+    int exitStatus = longBowMain(argc, argv, testRunner, NULL);
+    longBowTestRunner_Destroy(&testRunner);
+    exit(exitStatus);
+}
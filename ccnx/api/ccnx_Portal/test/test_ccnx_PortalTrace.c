@@ -0,0 +1,371 @@
+/*
+ * Copyright (c) 2016, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX OR PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ################################################################################
+ * #
+ * # PATENT NOTICE
+ * #
+ * # This software is distributed under the BSD 2-clause License (see LICENSE
+ * # file).  This BSD License does not make any patent claims and as such, does
+ * # not act as a patent grant.  The purpose of this section is for each contributor
+ * # to define their intentions with respect to intellectual property.
+ * #
+ * # Each contributor to this source code is encouraged to state their patent
+ * # claims and licensing mechanisms for any contributions made. At the end of
+ * # this section contributors may each make their own statements.  Contributor's
+ * # claims and grants only apply to the pieces (source code, programs, text,
+ * # media, etc) that they have contributed directly to this software.
+ * #
+ * # There is no guarantee that this section is complete, up to date or accurate. It
+ * # is up to the contributors to maintain their portion of this section and up to
+ * # the user of the software to verify any claims herein.
+ * #
+ * # Do not remove this header notification.  The contents of this section must be
+ * # present in all distributions of the software.  You may only modify your own
+ * # intellectual property statements.  Please provide contact information.
+ *
+ * - Palo Alto Research Center, Inc
+ * This software distribution does not grant any rights to patents owned by Palo
+ * Alto Research Center, Inc (PARC). Rights to these patents are available via
+ * various mechanisms. As of January 2016 PARC has committed to FRAND licensing any
+ * intellectual property used by its contributions to this software. You may
+ * contact PARC at cipo@parc.com for more information or visit http://www.ccnx.org
+ */
+/**
+ * @copyright (c) 2016, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC).  All rights reserved.
+ */
+#include "../ccnx_PortalTrace.c"
+
+#include <LongBow/unit-test.h>
+#include <LongBow/debugging.h>
+
+#include <stdio.h>
+#include <unistd.h>
+
+#include <ccnx/api/ccnx_Portal/ccnx_Portal.h>
+#include <ccnx/api/ccnx_Portal/ccnx_PortalAPI.h>
+
+#include <parc/algol/parc_Memory.h>
+#include <parc/algol/parc_SafeMemory.h>
+
+#include <parc/security/parc_IdentityFile.h>
+#include <parc/security/parc_Security.h>
+#include <parc/security/parc_Pkcs12KeyStore.h>
+
+#include <ccnx/common/ccnx_Interest.h>
+#include <ccnx/common/ccnx_ContentObject.h>
+
+#define _testTraceFile "test_ccnx_PortalTrace.trace"
+
+LONGBOW_TEST_RUNNER(test_ccnx_PortalTrace)
+{
+    LONGBOW_RUN_TEST_FIXTURE(Global);
+    LONGBOW_RUN_TEST_FIXTURE(Recording);
+}
+
+LONGBOW_TEST_RUNNER_SETUP(test_ccnx_PortalTrace)
+{
+    parcMemory_SetInterface(&PARCSafeMemoryAsPARCMemory);
+
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_RUNNER_TEARDOWN(test_ccnx_PortalTrace)
+{
+    unlink(_testTraceFile);
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_FIXTURE(Global)
+{
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortalTrace_CreateWriter);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortalTrace_CreateReader_NotATrace);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortalTrace_CreateReader_NoFile);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortalTrace_AppendNext);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortalTrace_Rewind);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxPortalTrace_Grow);
+}
+
+static size_t InitialMemoryOutstanding = 0;
+
+LONGBOW_TEST_FIXTURE_SETUP(Global)
+{
+    InitialMemoryOutstanding = parcMemory_Outstanding();
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_FIXTURE_TEARDOWN(Global)
+{
+    if (parcMemory_Outstanding() != InitialMemoryOutstanding) {
+        parcSafeMemory_ReportAllocation(STDOUT_FILENO);
+        printf("('%s' leaks memory by %zd\n",
+               longBowTestCase_GetName(testCase), parcMemory_Outstanding() - InitialMemoryOutstanding);
+        return LONGBOW_STATUS_MEMORYLEAK;
+    }
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+static CCNxMetaMessage *
+_createInterestMessage(const char *uri)
+{
+    CCNxName *name = ccnxName_CreateFromCString(uri);
+    CCNxInterest *interest = ccnxInterest_CreateSimple(name);
+    CCNxMetaMessage *result = ccnxMetaMessage_CreateFromInterest(interest);
+    ccnxInterest_Release(&interest);
+    ccnxName_Release(&name);
+    return result;
+}
+
+static CCNxMetaMessage *
+_createContentObjectMessage(const char *uri, const char *payload)
+{
+    CCNxName *name = ccnxName_CreateFromCString(uri);
+    PARCBuffer *buffer = parcBuffer_AllocateCString(payload);
+    CCNxContentObject *contentObject = ccnxContentObject_CreateWithNameAndPayload(name, buffer);
+    CCNxMetaMessage *result = ccnxMetaMessage_CreateFromContentObject(contentObject);
+    ccnxContentObject_Release(&contentObject);
+    parcBuffer_Release(&buffer);
+    ccnxName_Release(&name);
+    return result;
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortalTrace_CreateWriter)
+{
+    CCNxPortalTrace *trace = ccnxPortalTrace_CreateWriter(_testTraceFile);
+    assertNotNull(trace, "Expected ccnxPortalTrace_CreateWriter to succeed: %s", strerror(errno));
+    assertTrue(ccnxPortalTrace_GetCount(trace) == 0, "Expected a new trace to be empty.");
+    ccnxPortalTrace_Release(&trace);
+    assertNull(trace, "Expected ccnxPortalTrace_Release to NULL the pointer.");
+
+    struct stat statBuffer;
+    stat(_testTraceFile, &statBuffer);
+    assertTrue(statBuffer.st_size == _ccnxPortalTrace_FileHeaderLength,
+               "Expected an empty trace to be trimmed to its header, actual %lld", (long long) statBuffer.st_size);
+
+    trace = ccnxPortalTrace_CreateReader(_testTraceFile);
+    assertNotNull(trace, "Expected an empty trace to be readable.");
+    CCNxMetaMessage *message = ccnxPortalTrace_Next(trace, NULL, NULL);
+    assertNull(message, "Expected no messages in an empty trace.");
+    ccnxPortalTrace_Release(&trace);
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortalTrace_CreateReader_NotATrace)
+{
+    FILE *file = fopen(_testTraceFile, "w");
+    fputs("This is not a trace file.", file);
+    fclose(file);
+
+    CCNxPortalTrace *trace = ccnxPortalTrace_CreateReader(_testTraceFile);
+    assertNull(trace, "Expected ccnxPortalTrace_CreateReader to reject a file that is not a trace.");
+    assertTrue(errno == EINVAL, "Expected errno EINVAL, actual %d", errno);
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortalTrace_CreateReader_NoFile)
+{
+    CCNxPortalTrace *trace = ccnxPortalTrace_CreateReader("/nonexistent/test_ccnx_PortalTrace.trace");
+    assertNull(trace, "Expected ccnxPortalTrace_CreateReader to fail for a missing file.");
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortalTrace_AppendNext)
+{
+    CCNxMetaMessage *interest = _createInterestMessage("lci:/trace/interest");
+    CCNxMetaMessage *content = _createContentObjectMessage("lci:/trace/interest", "payload");
+
+    CCNxPortalTrace *writer = ccnxPortalTrace_CreateWriter(_testTraceFile);
+    assertTrue(ccnxPortalTrace_Append(writer, CCNxPortalTraceDirection_Receive, 1000, interest), "Expected Append to succeed.");
+    assertTrue(ccnxPortalTrace_Append(writer, CCNxPortalTraceDirection_Send, 2000, content), "Expected Append to succeed.");
+    assertTrue(ccnxPortalTrace_GetCount(writer) == 2, "Expected 2 records, actual %" PRIu64, ccnxPortalTrace_GetCount(writer));
+    ccnxPortalTrace_Release(&writer);
+
+    CCNxPortalTrace *reader = ccnxPortalTrace_CreateReader(_testTraceFile);
+    assertNotNull(reader, "Expected ccnxPortalTrace_CreateReader to succeed.");
+
+    CCNxPortalTraceDirection direction;
+    uint64_t timestamp;
+
+    CCNxMetaMessage *actual = ccnxPortalTrace_Next(reader, &direction, &timestamp);
+    assertNotNull(actual, "Expected the first record.");
+    assertTrue(ccnxMetaMessage_IsInterest(actual), "Expected the first record to be an Interest.");
+    assertTrue(direction == CCNxPortalTraceDirection_Receive, "Expected the Receive direction.");
+    assertTrue(timestamp == 1000, "Expected timestamp 1000, actual %" PRIu64, timestamp);
+    assertTrue(ccnxName_Equals(ccnxInterest_GetName(ccnxMetaMessage_GetInterest(interest)),
+                               ccnxInterest_GetName(ccnxMetaMessage_GetInterest(actual))),
+               "Expected the recorded Interest name.");
+    ccnxMetaMessage_Release(&actual);
+
+    actual = ccnxPortalTrace_Next(reader, &direction, &timestamp);
+    assertNotNull(actual, "Expected the second record.");
+    assertTrue(ccnxMetaMessage_IsContentObject(actual), "Expected the second record to be a Content Object.");
+    assertTrue(direction == CCNxPortalTraceDirection_Send, "Expected the Send direction.");
+    assertTrue(timestamp == 2000, "Expected timestamp 2000, actual %" PRIu64, timestamp);
+    assertTrue(parcBuffer_Equals(ccnxContentObject_GetPayload(ccnxMetaMessage_GetContentObject(content)),
+                                 ccnxContentObject_GetPayload(ccnxMetaMessage_GetContentObject(actual))),
+               "Expected the recorded payload.");
+    ccnxMetaMessage_Release(&actual);
+
+    actual = ccnxPortalTrace_Next(reader, NULL, NULL);
+    assertNull(actual, "Expected the end of the trace.");
+    assertTrue(ccnxPortalTrace_GetCount(reader) == 2, "Expected 2 records read, actual %" PRIu64, ccnxPortalTrace_GetCount(reader));
+
+    ccnxPortalTrace_Release(&reader);
+    ccnxMetaMessage_Release(&content);
+    ccnxMetaMessage_Release(&interest);
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortalTrace_Rewind)
+{
+    CCNxMetaMessage *interest = _createInterestMessage("lci:/trace/rewind");
+
+    CCNxPortalTrace *writer = ccnxPortalTrace_CreateWriter(_testTraceFile);
+    ccnxPortalTrace_Append(writer, CCNxPortalTraceDirection_Receive, ccnxPortalTrace_Now(), interest);
+    ccnxPortalTrace_Release(&writer);
+
+    CCNxPortalTrace *reader = ccnxPortalTrace_CreateReader(_testTraceFile);
+    CCNxMetaMessage *actual = ccnxPortalTrace_Next(reader, NULL, NULL);
+    assertNotNull(actual, "Expected a record.");
+    ccnxMetaMessage_Release(&actual);
+
+    ccnxPortalTrace_Rewind(reader);
+    assertTrue(ccnxPortalTrace_GetCount(reader) == 0, "Expected Rewind to reset the count.");
+
+    actual = ccnxPortalTrace_Next(reader, NULL, NULL);
+    assertNotNull(actual, "Expected the record again after Rewind.");
+    ccnxMetaMessage_Release(&actual);
+
+    ccnxPortalTrace_Release(&reader);
+    ccnxMetaMessage_Release(&interest);
+}
+
+LONGBOW_TEST_CASE(Global, ccnxPortalTrace_Grow)
+{
+    char payload[4096];
+    memset(payload, 'x', sizeof(payload) - 1);
+    payload[sizeof(payload) - 1] = 0;
+    CCNxMetaMessage *content = _createContentObjectMessage("lci:/trace/grow", payload);
+
+    // Enough records to extend the initial mapping more than once.
+    size_t records = 3 * _ccnxPortalTrace_InitialCapacity / sizeof(payload);
+
+    CCNxPortalTrace *writer = ccnxPortalTrace_CreateWriter(_testTraceFile);
+    for (size_t i = 0; i < records; i++) {
+        assertTrue(ccnxPortalTrace_Append(writer, CCNxPortalTraceDirection_Send, i, content), "Expected Append %zu to succeed.", i);
+    }
+    ccnxPortalTrace_Release(&writer);
+
+    CCNxPortalTrace *reader = ccnxPortalTrace_CreateReader(_testTraceFile);
+    CCNxMetaMessage *actual;
+    uint64_t timestamp;
+    size_t count = 0;
+    while ((actual = ccnxPortalTrace_Next(reader, NULL, &timestamp)) != NULL) {
+        assertTrue(timestamp == count, "Expected timestamp %zu, actual %" PRIu64, count, timestamp);
+        ccnxMetaMessage_Release(&actual);
+        count++;
+    }
+    assertTrue(count == records, "Expected %zu records, actual %zu", records, count);
+
+    ccnxPortalTrace_Release(&reader);
+    ccnxMetaMessage_Release(&content);
+}
+
+LONGBOW_TEST_FIXTURE(Recording)
+{
+    LONGBOW_RUN_TEST_CASE(Recording, ccnxPortalTrace_CreateInterceptor);
+}
+
+LONGBOW_TEST_FIXTURE_SETUP(Recording)
+{
+    InitialMemoryOutstanding = parcMemory_Outstanding();
+
+    parcSecurity_Init();
+
+    bool success = parcPkcs12KeyStore_CreateFile("my_keystore", "my_keystore_password", "test_ccnx_PortalTrace", 1024, 30);
+    assertTrue(success, "parcPkcs12KeyStore_CreateFile('my_keystore', 'my_keystore_password') failed.");
+
+    PARCIdentityFile *identityFile = parcIdentityFile_Create("my_keystore", "my_keystore_password");
+    PARCIdentity *identity = parcIdentity_Create(identityFile, PARCIdentityFileAsPARCIdentity);
+
+    CCNxPortalFactory *factory = ccnxPortalFactory_Create(identity);
+    parcIdentityFile_Release(&identityFile);
+    parcIdentity_Release(&identity);
+
+    longBowTestCase_SetClipBoardData(testCase, factory);
+
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_FIXTURE_TEARDOWN(Recording)
+{
+    CCNxPortalFactory *factory = longBowTestCase_GetClipBoardData(testCase);
+    ccnxPortalFactory_Release(&factory);
+
+    parcSecurity_Fini();
+
+    if (parcMemory_Outstanding() != InitialMemoryOutstanding) {
+        parcSafeMemory_ReportAllocation(STDOUT_FILENO);
+        printf("('%s' leaks memory by %zd\n",
+               longBowTestCase_GetName(testCase), parcMemory_Outstanding() - InitialMemoryOutstanding);
+        return LONGBOW_STATUS_MEMORYLEAK;
+    }
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_CASE(Recording, ccnxPortalTrace_CreateInterceptor)
+{
+    CCNxPortalFactory *factory = longBowTestCase_GetClipBoardData(testCase);
+    ccnxPortalFactory_SetProperty(factory, CCNxPortalTrace_RecordFile, _testTraceFile);
+
+    CCNxPortal *portal = ccnxPortalFactory_CreatePortal(factory, ccnxPortalAPI_LoopBack);
+
+    CCNxMetaMessage *interest = _createInterestMessage("lci:/trace/recording");
+    ccnxPortal_Send(portal, interest, CCNxStackTimeout_Never);
+    CCNxMetaMessage *received = ccnxPortal_Receive(portal, CCNxStackTimeout_Never);
+    assertNotNull(received, "Expected the loopback to return the Interest.");
+    ccnxMetaMessage_Release(&received);
+    ccnxMetaMessage_Release(&interest);
+
+    ccnxPortal_Release(&portal);
+
+    CCNxPortalTrace *reader = ccnxPortalTrace_CreateReader(_testTraceFile);
+    assertNotNull(reader, "Expected the Portal to have recorded a trace.");
+
+    CCNxPortalTraceDirection direction;
+    CCNxMetaMessage *actual = ccnxPortalTrace_Next(reader, &direction, NULL);
+    assertTrue(ccnxMetaMessage_IsInterest(actual) && direction == CCNxPortalTraceDirection_Send, "Expected the sent Interest first.");
+    ccnxMetaMessage_Release(&actual);
+
+    actual = ccnxPortalTrace_Next(reader, &direction, NULL);
+    assertTrue(ccnxMetaMessage_IsInterest(actual) && direction == CCNxPortalTraceDirection_Receive, "Expected the received Interest second.");
+    ccnxMetaMessage_Release(&actual);
+
+    ccnxPortalTrace_Release(&reader);
+}
+
+int
+main(int argc, char *argv[argc])
+{
+    LongBowRunner *testRunner = LONGBOW_TEST_RUNNER_CREATE(test_ccnx_PortalTrace);
+    int exitStatus = longBowMain(argc, argv, testRunner, NULL);
+    longBowTestRunner_Destroy(&testRunner);
+    exit(exitStatus);
+}